@@ -44,6 +44,10 @@ LOCAL_SRC_FILES := \
 
 LOCAL_CFLAGS += -DGL_GLEXT_PROTOTYPES
 
+# The prebuilt SDL2_mixer exports libvorbisfile, which MusicStream needs.
+# Other platforms do not link vorbisfile, and so leave this flag off.
+LOCAL_CFLAGS += -DCU_MUSIC_STREAM
+
 LOCAL_LDLIBS := 
 LOCAL_EXPORT_LDLIBS := -Wl,--undefined=Java_org_libsdl_app_SDLActivity_nativeInit -ldl -lGLESv1_CM -lGLESv2 -lGLESv3 -llog -landroid
 
@@ -32,13 +32,261 @@
 #include <Box2D/Collision/b2TimeOfImpact.h>
 #include <Box2D/Common/b2Draw.h>
 #include <Box2D/Common/b2Timer.h>
+#include <algorithm>
+#include <string.h>
+#include <atomic>
 #include <new>
 
+// The islands of a time step, recorded so that they can be solved in parallel.
+// A static body may appear in several islands, so the islands are solved with
+// shared statics (see b2Island). Contact impulses are buffered per contact and
+// reported once all islands are solved.
+class b2IslandList : public b2IslandTask
+{
+public:
+	b2IslandList(b2StackAllocator* allocator);
+	~b2IslandList();
+
+	void Reserve(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity);
+
+	void Add(const b2Island& island);
+
+	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep,
+			   b2IslandExecutor* executor, b2StackAllocator** allocators, b2ContactListener* listener);
+
+	void Run(int32 thread);
+
+private:
+
+	struct Range
+	{
+		int32 bodyStart;
+		int32 bodyCount;
+		int32 contactStart;
+		int32 contactCount;
+		int32 jointStart;
+		int32 jointCount;
+		b2Profile profile;
+	};
+
+	// Solve the largest islands first to balance the threads.
+	struct LargerIsland
+	{
+		const Range* ranges;
+
+		bool operator()(int32 a, int32 b) const
+		{
+			int32 sizeA = ranges[a].bodyCount + ranges[a].contactCount + ranges[a].jointCount;
+			int32 sizeB = ranges[b].bodyCount + ranges[b].contactCount + ranges[b].jointCount;
+			return sizeA > sizeB || (sizeA == sizeB && a < b);
+		}
+	};
+
+	b2StackAllocator* m_allocator;
+
+	b2Body** m_bodies;
+	b2Contact** m_contacts;
+	b2Joint** m_joints;
+	b2ContactImpulse* m_impulses;
+	Range* m_ranges;
+	int32* m_order;
+
+	int32 m_bodyCount;
+	int32 m_contactCount;
+	int32 m_jointCount;
+	int32 m_islandCount;
+
+	int32 m_bodyCapacity;
+	int32 m_contactCapacity;
+	int32 m_jointCapacity;
+	int32 m_islandCapacity;
+
+	// The state of the current Solve.
+	b2StackAllocator** m_threadAllocators;
+	b2TimeStep m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+	bool m_report;
+	std::atomic<int32> m_next;
+};
+
+b2IslandList::b2IslandList(b2StackAllocator* allocator)
+{
+	m_allocator = allocator;
+
+	m_bodies = NULL;
+	m_contacts = NULL;
+	m_joints = NULL;
+	m_impulses = NULL;
+	m_ranges = NULL;
+	m_order = NULL;
+
+	m_bodyCount = 0;
+	m_contactCount = 0;
+	m_jointCount = 0;
+	m_islandCount = 0;
+
+	m_bodyCapacity = 0;
+	m_contactCapacity = 0;
+	m_jointCapacity = 0;
+	m_islandCapacity = 0;
+
+	m_threadAllocators = NULL;
+	m_allowSleep = false;
+	m_report = false;
+}
+
+b2IslandList::~b2IslandList()
+{
+	// Warning: the order should reverse the Reserve order.
+	if (m_ranges)
+	{
+		m_allocator->Free(m_order);
+		m_allocator->Free(m_ranges);
+		m_allocator->Free(m_impulses);
+		m_allocator->Free(m_joints);
+		m_allocator->Free(m_contacts);
+		m_allocator->Free(m_bodies);
+	}
+}
+
+void b2IslandList::Reserve(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity)
+{
+	b2Assert(m_ranges == NULL);
+
+	// Static bodies are added once per island, and each extra island
+	// that contains a static body needs a contact or joint to reach it.
+	m_bodyCapacity = bodyCapacity + contactCapacity + jointCapacity;
+	m_contactCapacity = contactCapacity;
+	m_jointCapacity = jointCapacity;
+	m_islandCapacity = bodyCapacity;
+
+	m_bodies = (b2Body**)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Body*));
+	m_contacts = (b2Contact**)m_allocator->Allocate(m_contactCapacity * sizeof(b2Contact*));
+	m_joints = (b2Joint**)m_allocator->Allocate(m_jointCapacity * sizeof(b2Joint*));
+	m_impulses = (b2ContactImpulse*)m_allocator->Allocate(m_contactCapacity * sizeof(b2ContactImpulse));
+	m_ranges = (Range*)m_allocator->Allocate(m_islandCapacity * sizeof(Range));
+	m_order = (int32*)m_allocator->Allocate(m_islandCapacity * sizeof(int32));
+}
+
+void b2IslandList::Add(const b2Island& island)
+{
+	b2Assert(m_islandCount < m_islandCapacity);
+	b2Assert(m_bodyCount + island.m_bodyCount <= m_bodyCapacity);
+	b2Assert(m_contactCount + island.m_contactCount <= m_contactCapacity);
+	b2Assert(m_jointCount + island.m_jointCount <= m_jointCapacity);
+
+	Range* range = m_ranges + m_islandCount;
+	range->bodyStart = m_bodyCount;
+	range->bodyCount = island.m_bodyCount;
+	range->contactStart = m_contactCount;
+	range->contactCount = island.m_contactCount;
+	range->jointStart = m_jointCount;
+	range->jointCount = island.m_jointCount;
+	m_order[m_islandCount] = m_islandCount;
+	++m_islandCount;
+
+	memcpy(m_bodies + m_bodyCount, island.m_bodies, island.m_bodyCount * sizeof(b2Body*));
+	memcpy(m_contacts + m_contactCount, island.m_contacts, island.m_contactCount * sizeof(b2Contact*));
+	memcpy(m_joints + m_jointCount, island.m_joints, island.m_jointCount * sizeof(b2Joint*));
+	m_bodyCount += island.m_bodyCount;
+	m_contactCount += island.m_contactCount;
+	m_jointCount += island.m_jointCount;
+}
+
+void b2IslandList::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep,
+						 b2IslandExecutor* executor, b2StackAllocator** allocators, b2ContactListener* listener)
+{
+	if (m_islandCount == 0)
+	{
+		return;
+	}
+
+	LargerIsland larger;
+	larger.ranges = m_ranges;
+	std::sort(m_order, m_order + m_islandCount, larger);
+
+	m_threadAllocators = allocators;
+	m_step = step;
+	m_gravity = gravity;
+	m_allowSleep = allowSleep;
+	m_report = listener != NULL;
+	m_next = 0;
+
+	executor->Execute(this);
+
+	// Accumulate the profile and report the impulses in island order,
+	// exactly as the serial solver would.
+	for (int32 i = 0; i < m_islandCount; ++i)
+	{
+		const Range* range = m_ranges + i;
+		profile->solveInit += range->profile.solveInit;
+		profile->solveVelocity += range->profile.solveVelocity;
+		profile->solvePosition += range->profile.solvePosition;
+
+		// The islands do not touch their static bodies. Serially, a static body
+		// ends up asleep if the last island containing it fell asleep. The first
+		// body of an island is its seed, which is never static.
+		bool awake = m_bodies[range->bodyStart]->IsAwake();
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			b2Body* b = m_bodies[range->bodyStart + j];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->SetAwake(awake);
+			}
+		}
+
+		if (m_report)
+		{
+			for (int32 j = 0; j < range->contactCount; ++j)
+			{
+				int32 index = range->contactStart + j;
+				listener->PostSolve(m_contacts[index], m_impulses + index);
+			}
+		}
+	}
+}
+
+void b2IslandList::Run(int32 thread)
+{
+	b2StackAllocator* allocator = m_threadAllocators[thread];
+	for (int32 k = m_next++; k < m_islandCount; k = m_next++)
+	{
+		Range* range = m_ranges + m_order[k];
+
+		b2Island island(range->bodyCount, range->contactCount, range->jointCount, allocator, NULL, true);
+		for (int32 i = 0; i < range->bodyCount; ++i)
+		{
+			island.Add(m_bodies[range->bodyStart + i]);
+		}
+		for (int32 i = 0; i < range->contactCount; ++i)
+		{
+			island.Add(m_contacts[range->contactStart + i]);
+		}
+		for (int32 i = 0; i < range->jointCount; ++i)
+		{
+			island.Add(m_joints[range->jointStart + i]);
+		}
+
+		if (m_report)
+		{
+			island.m_impulses = m_impulses + range->contactStart;
+		}
+
+		island.Solve(&range->profile, m_step, m_gravity, m_allowSleep);
+	}
+}
+
 b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = NULL;
 	g_debugDraw = NULL;
 
+	m_islandExecutor = NULL;
+	m_threadAllocators = NULL;
+	m_threadAllocatorCount = 0;
+
 	m_bodyList = NULL;
 	m_jointList = NULL;
 
@@ -82,6 +330,17 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	// Thread 0 uses the world stack allocator.
+	for (int32 i = 1; i < m_threadAllocatorCount; ++i)
+	{
+		m_threadAllocators[i]->~b2StackAllocator();
+		b2Free(m_threadAllocators[i]);
+	}
+	if (m_threadAllocators)
+	{
+		b2Free(m_threadAllocators);
+	}
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -99,6 +358,42 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetIslandExecutor(b2IslandExecutor* executor)
+{
+	b2Assert(IsLocked() == false);
+	m_islandExecutor = executor;
+}
+
+b2StackAllocator** b2World::GetThreadAllocators(int32 count)
+{
+	if (m_threadAllocatorCount < count)
+	{
+		b2StackAllocator** allocators = (b2StackAllocator**)b2Alloc(count * sizeof(b2StackAllocator*));
+		allocators[0] = &m_stackAllocator;
+		for (int32 i = 1; i < count; ++i)
+		{
+			if (i < m_threadAllocatorCount)
+			{
+				allocators[i] = m_threadAllocators[i];
+			}
+			else
+			{
+				void* mem = b2Alloc(sizeof(b2StackAllocator));
+				allocators[i] = new (mem) b2StackAllocator;
+			}
+		}
+
+		if (m_threadAllocators)
+		{
+			b2Free(m_threadAllocators);
+		}
+		m_threadAllocators = allocators;
+		m_threadAllocatorCount = count;
+	}
+
+	return m_threadAllocators;
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	g_debugDraw = debugDraw;
@@ -396,6 +691,19 @@ void b2World::Solve(const b2TimeStep& step)
 					&m_stackAllocator,
 					m_contactManager.m_contactListener);
 
+	// When solving in parallel, the islands are recorded and solved together.
+	b2IslandExecutor* executor = NULL;
+	if (m_islandExecutor != NULL && m_islandExecutor->GetThreadCount() > 1)
+	{
+		executor = m_islandExecutor;
+	}
+
+	b2IslandList islands(&m_stackAllocator);
+	if (executor)
+	{
+		islands.Reserve(m_bodyCount, m_contactManager.m_contactCount, m_jointCount);
+	}
+
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
@@ -527,11 +835,18 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (executor)
+		{
+			islands.Add(island);
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -545,32 +860,42 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	if (executor)
+	{
+		b2StackAllocator** allocators = GetThreadAllocators(executor->GetThreadCount());
+		islands.Solve(&m_profile, step, m_gravity, m_allowSleep,
+					  executor, allocators, m_contactManager.m_contactListener);
+	}
+
 	m_stackAllocator.Free(stack);
 
+	SynchronizeIslands();
+}
+
+void b2World::SynchronizeIslands()
+{
+	b2Timer timer;
+	// Synchronize fixtures, check for out of range bodies.
+	for (b2Body* b = m_bodyList; b; b = b->GetNext())
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		// If a body was not in an island then it did not move.
+		if ((b->m_flags & b2Body::e_islandFlag) == 0)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
-			{
-				continue;
-			}
-
-			if (b->GetType() == b2_staticBody)
-			{
-				continue;
-			}
+			continue;
+		}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
 		}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+		// Update fixtures (for broad-phase).
+		b->SynchronizeFixtures();
 	}
+
+	// Look for new contacts.
+	m_contactManager.FindNewContacts();
+	m_profile.broadphase = timer.GetMilliseconds();
 }
 
 // Find TOI contacts and solve them.
@@ -61,6 +61,17 @@ public:
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// Register an executor to solve islands in parallel, or NULL to solve them
+	/// serially (the default). Islands are built as usual, and then solved on the
+	/// executor threads, each with its own stack allocator. Contact impulses are
+	/// reported to the contact listener afterwards, on the stepping thread, in
+	/// the same order as serial solving. The executor is owned by you and must
+	/// remain in scope.
+	void SetIslandExecutor(b2IslandExecutor* executor);
+
+	/// Get the island executor, or NULL if islands are solved serially.
+	b2IslandExecutor* GetIslandExecutor() const;
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DrawDebugData method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -226,6 +237,8 @@ private:
 
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
+	void SynchronizeIslands();
+	b2StackAllocator** GetThreadAllocators(int32 count);
 
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
@@ -249,6 +262,12 @@ private:
 	b2DestructionListener* m_destructionListener;
 	b2Draw* g_debugDraw;
 
+	// Islands are solved in parallel if this is not NULL. Thread 0 uses
+	// m_stackAllocator, and every other thread has its own allocator.
+	b2IslandExecutor* m_islandExecutor;
+	b2StackAllocator** m_threadAllocators;
+	int32 m_threadAllocatorCount;
+
 	// This is used to compute the time step ratio to
 	// support a variable time step.
 	float32 m_inv_dt0;
@@ -346,6 +365,11 @@ inline const b2ContactManager& b2World::GetContactManager() const
 	return m_contactManager;
 }
 
+inline b2IslandExecutor* b2World::GetIslandExecutor() const
+{
+	return m_islandExecutor;
+}
+
 inline const b2Profile& b2World::GetProfile() const
 {
 	return m_profile;
@@ -152,4 +152,33 @@ public:
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// A unit of work for a b2IslandExecutor.
+class b2IslandTask
+{
+public:
+	virtual ~b2IslandTask() {}
+
+	/// Solve islands on behalf of the given thread. The thread index is
+	/// in [0, b2IslandExecutor::GetThreadCount()).
+	virtual void Run(int32 thread) = 0;
+};
+
+/// Implement this class to solve islands on several threads.
+/// See b2World::SetIslandExecutor
+class b2IslandExecutor
+{
+public:
+	virtual ~b2IslandExecutor() {}
+
+	/// Get the number of threads used to solve islands, including the
+	/// thread that steps the world.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Call task->Run(i) once for each i in [0, GetThreadCount()), and
+	/// return once all of the calls have finished. Calls with different
+	/// indices should run concurrently. The call for index 0 may be made
+	/// on the calling thread.
+	virtual void Execute(b2IslandTask* task) = 0;
+};
+
 #endif
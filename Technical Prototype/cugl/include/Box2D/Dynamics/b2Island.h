@@ -27,15 +27,28 @@ class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+struct b2ContactImpulse;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
+/// This is an internal structure.
+/// The solver index of a static body in an island that shares static bodies.
+struct b2IslandStatic
+{
+	b2Body* body;
+	int32 index;
+};
+
 /// This is an internal class.
 class b2Island
 {
 public:
+	/// If shareStatics is true, this island may be solved while other islands
+	/// containing the same static bodies are solved on other threads. The island
+	/// then never writes to its static bodies, including their island index.
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener,
+			bool shareStatics = false);
 	~b2Island();
 
 	void Clear()
@@ -43,6 +56,7 @@ public:
 		m_bodyCount = 0;
 		m_contactCount = 0;
 		m_jointCount = 0;
+		m_staticCount = 0;
 	}
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
@@ -52,7 +66,16 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+		if (m_statics != NULL && body->m_type == b2_staticBody)
+		{
+			m_statics[m_staticCount].body = body;
+			m_statics[m_staticCount].index = m_bodyCount;
+			++m_staticCount;
+		}
+		else
+		{
+			body->m_islandIndex = m_bodyCount;
+		}
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -69,14 +92,51 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Get the index of a body in the solver arrays of this island.
+	int32 IndexOf(const b2Body* body) const
+	{
+		if (m_statics == NULL || body->m_type != b2_staticBody)
+		{
+			return body->m_islandIndex;
+		}
+
+		// The statics are sorted by address when the island is solved.
+		int32 low = 0;
+		int32 high = m_staticCount - 1;
+		while (low <= high)
+		{
+			int32 mid = (low + high) >> 1;
+			if (m_statics[mid].body < body)
+			{
+				low = mid + 1;
+			}
+			else if (body < m_statics[mid].body)
+			{
+				high = mid - 1;
+			}
+			else
+			{
+				return m_statics[mid].index;
+			}
+		}
+
+		b2Assert(false);
+		return body->m_islandIndex;
+	}
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
+	// If not NULL, Report stores one impulse per contact here instead of
+	// calling the listener. The caller replays them later.
+	b2ContactImpulse* m_impulses;
+
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
+	b2IslandStatic* m_statics;
 
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
@@ -84,6 +144,7 @@ public:
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
+	int32 m_staticCount;
 
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
@@ -0,0 +1,233 @@
+//
+//  CUAnimationClip.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an immutable animation clip.  A clip is a sequence of
+//  frames in a sprite sheet, each with its own duration, together with the
+//  way the clip repeats.  Clips hold no playback state, so a single clip may
+//  be shared by every sprite that plays it.  Clips are played on animation
+//  nodes by a SpriteAnimator.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_ANIMATION_CLIP_H__
+#define __CU_ANIMATION_CLIP_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/math/CURect.h>
+#include <cugl/math/CUSize.h>
+#include <memory>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is an immutable animation clip.
+ *
+ * A clip is a sequence of frames.  Each frame is a rectangle of a sprite
+ * sheet (in texture pixels, with the origin at the bottom left corner) that
+ * is shown for a fixed duration in seconds.  The loop mode determines what
+ * happens when the last frame has been shown.
+ *
+ * A clip cannot be changed once it is initialized.  All playback state (the
+ * current frame, the elapsed time) lives in the {@link SpriteAnimator}, so
+ * clips should be created once and shared by every node that plays them.
+ */
+class AnimationClip {
+public:
+    /**
+     * This enum specifies what happens at the end of a clip.
+     */
+    enum class Mode : int {
+        /** The clip stops on its last frame */
+        ONCE     = 0,
+        /** The clip restarts at its first frame */
+        LOOP     = 1,
+        /** The clip plays backwards to its first frame, and then forwards again */
+        PINGPONG = 2
+    };
+
+private:
+    /** This macro disables the copy constructor (not allowed on clips) */
+    CU_DISALLOW_COPY_AND_ASSIGN(AnimationClip);
+
+    /** The texture rectangle of each frame */
+    std::vector<Rect>  _frames;
+    /** The duration of each frame in seconds */
+    std::vector<float> _durations;
+    /** The total duration of the clip (for one pass) */
+    float _length;
+    /** What happens at the end of this clip */
+    Mode _mode;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized clip.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    AnimationClip() : _length(0), _mode(Mode::ONCE) {}
+
+    /**
+     * Deletes this clip, releasing all resources.
+     */
+    ~AnimationClip() { dispose(); }
+
+    /**
+     * Releases the frames of this clip.
+     *
+     * A disposed clip can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a clip with the given frames.
+     *
+     * There must be one duration for each frame, and every duration must be
+     * positive.  All frames must be the same size.
+     *
+     * @param frames    The texture rectangle of each frame
+     * @param durations The duration of each frame in seconds
+     * @param mode      What happens at the end of this clip
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::vector<Rect>& frames, const std::vector<float>& durations, Mode mode);
+
+    /**
+     * Initializes a clip from a sequence of frames in a filmstrip.
+     *
+     * The filmstrip is laid out as for {@link AnimationNode}, with frame 0
+     * in the top left corner.  The frames are given by their index in the
+     * filmstrip, and may repeat.  Every frame has the same duration.
+     *
+     * @param size      The size of the filmstrip texture
+     * @param rows      The number of rows in the filmstrip
+     * @param cols      The number of columns in the filmstrip
+     * @param frames    The filmstrip index of each frame
+     * @param duration  The duration of each frame in seconds
+     * @param mode      What happens at the end of this clip
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithFilmstrip(const Size& size, int rows, int cols,
+                           const std::vector<int>& frames, float duration, Mode mode);
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated clip with the given frames.
+     *
+     * There must be one duration for each frame, and every duration must be
+     * positive.  All frames must be the same size.
+     *
+     * @param frames    The texture rectangle of each frame
+     * @param durations The duration of each frame in seconds
+     * @param mode      What happens at the end of this clip
+     *
+     * @return a newly allocated clip with the given frames.
+     */
+    static std::shared_ptr<AnimationClip> alloc(const std::vector<Rect>& frames,
+                                                const std::vector<float>& durations, Mode mode) {
+        std::shared_ptr<AnimationClip> result = std::make_shared<AnimationClip>();
+        return (result->init(frames,durations,mode) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated clip from a sequence of frames in a filmstrip.
+     *
+     * The filmstrip is laid out as for {@link AnimationNode}, with frame 0
+     * in the top left corner.  The frames are given by their index in the
+     * filmstrip, and may repeat.  Every frame has the same duration.
+     *
+     * @param size      The size of the filmstrip texture
+     * @param rows      The number of rows in the filmstrip
+     * @param cols      The number of columns in the filmstrip
+     * @param frames    The filmstrip index of each frame
+     * @param duration  The duration of each frame in seconds
+     * @param mode      What happens at the end of this clip
+     *
+     * @return a newly allocated clip from a sequence of frames in a filmstrip.
+     */
+    static std::shared_ptr<AnimationClip> allocWithFilmstrip(const Size& size, int rows, int cols,
+                                                             const std::vector<int>& frames,
+                                                             float duration, Mode mode) {
+        std::shared_ptr<AnimationClip> result = std::make_shared<AnimationClip>();
+        return (result->initWithFilmstrip(size,rows,cols,frames,duration,mode) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the number of frames in this clip.
+     *
+     * @return the number of frames in this clip.
+     */
+    unsigned int getSize() const { return (unsigned int)_frames.size(); }
+
+    /**
+     * Returns the texture rectangle of the given frame.
+     *
+     * @param frame The frame index
+     *
+     * @return the texture rectangle of the given frame.
+     */
+    const Rect& getFrame(unsigned int frame) const { return _frames[frame]; }
+
+    /**
+     * Returns the duration of the given frame in seconds.
+     *
+     * @param frame The frame index
+     *
+     * @return the duration of the given frame in seconds.
+     */
+    float getDuration(unsigned int frame) const { return _durations[frame]; }
+
+    /**
+     * Returns the total duration of one pass through this clip in seconds.
+     *
+     * @return the total duration of one pass through this clip in seconds.
+     */
+    float getLength() const { return _length; }
+
+    /**
+     * Returns what happens at the end of this clip.
+     *
+     * @return what happens at the end of this clip.
+     */
+    Mode getMode() const { return _mode; }
+};
+
+}
+#endif /* __CU_ANIMATION_CLIP_H__ */
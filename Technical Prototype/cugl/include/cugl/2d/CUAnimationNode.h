@@ -84,6 +84,8 @@ protected:
     int _frame;
     /** The size of a single animation frame (different from active polygon) */
     Rect _bounds;
+    /** The frame origin that the polygon currently corresponds to */
+    Vec2 _shift;
    
 #pragma mark -
 #pragma mark Constructors
@@ -168,7 +170,7 @@ public:
      */
     static std::shared_ptr<AnimationNode> alloc(const std::shared_ptr<Texture>& texture,
                                                 int rows, int cols) {
-        std::shared_ptr<AnimationNode> node = std::make_shared<AnimationNode>();
+        std::shared_ptr<AnimationNode> node = NodeArena::make<AnimationNode>();
         return (node->initWithFilmstrip(texture,rows,cols) ? node : nullptr);
 
     }
@@ -193,7 +195,7 @@ public:
      */
     static std::shared_ptr<AnimationNode> alloc(const std::shared_ptr<Texture>& texture,
                                                 int rows, int cols, int size) {
-        std::shared_ptr<AnimationNode> node = std::make_shared<AnimationNode>();
+        std::shared_ptr<AnimationNode> node = NodeArena::make<AnimationNode>();
         return (node->initWithFilmstrip(texture,rows,cols,size) ? node : nullptr);
     }
     
@@ -222,6 +224,51 @@ public:
      */
     void setFrame(int frame);
 
+    /**
+     * Sets the active frame to the given rectangle of the texture.
+     *
+     * The rectangle is in texture pixels, with the origin at the bottom left
+     * corner of the texture.  It must be the same size as a single frame of
+     * the filmstrip.  This method allows a frame to come from anywhere in the
+     * texture, which is how {@link AnimationClip} frames are displayed.  It
+     * does not change the value of {@link getFrame()}.
+     *
+     * Changing the frame of a rectangular node only swaps the texture
+     * rectangle used at the next draw.  The polygon is only shifted (and its
+     * texture coordinates recomputed) if the node has a custom polygon.
+     *
+     * @param rect  The texture rectangle of the active frame
+     */
+    void setFrameRect(const Rect& rect);
+
+    /**
+     * Returns the texture rectangle of the active frame.
+     *
+     * The rectangle is in texture pixels, with the origin at the bottom left
+     * corner of the texture.
+     *
+     * @return the texture rectangle of the active frame.
+     */
+    const Rect& getFrameRect() const { return _bounds; }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this Node via the given SpriteBatch.
+     *
+     * This method only worries about drawing the current node.  It does not
+     * attempt to render the children.
+     *
+     * A rectangular node is drawn as a quad whose texture coordinates come
+     * from the active frame rectangle.  Otherwise, the polygon is shifted to
+     * the active frame (if necessary) and drawn as in {@link PolygonNode}.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+
     
 };
 
@@ -211,7 +211,7 @@ public:
      * @return a newly allocated button with the given up node.
      */
     static std::shared_ptr<Button> alloc(const std::shared_ptr<Node>& up) {
-        std::shared_ptr<Button> node = std::make_shared<Button>();
+        std::shared_ptr<Button> node = NodeArena::make<Button>();
         return (node->init(up) ? node : nullptr);
     }
 
@@ -227,7 +227,7 @@ public:
      * @return a newly allocated button with the given node and color
      */
     static std::shared_ptr<Button> alloc(const std::shared_ptr<Node>& up, Color4 down) {
-        std::shared_ptr<Button> node = std::make_shared<Button>();
+        std::shared_ptr<Button> node = NodeArena::make<Button>();
         return (node->init(up,down) ? node : nullptr);
     }
 
@@ -244,7 +244,7 @@ public:
      * @return a newly allocated button with the given nodes
      */
     static std::shared_ptr<Button> alloc(const std::shared_ptr<Node>& up, const std::shared_ptr<Node>& down) {
-        std::shared_ptr<Button> node = std::make_shared<Button>();
+        std::shared_ptr<Button> node = NodeArena::make<Button>();
         return (node->init(up,down) ? node : nullptr);
     }
 
@@ -55,6 +55,13 @@
 #include <cugl/renderer/CUVertex.h>
 #include <SDL/SDL_ttf.h>
 
+/** The default number of glyphs in a distance field atlas */
+#define FONT_DISTANCE_CAPACITY  128
+/** The default distance field spread (in pixels) */
+#define FONT_DISTANCE_SPREAD    6
+/** The number of glyphs with metrics in a flat lookup table (ASCII) */
+#define FONT_ASCII_GLYPHS       128
+
 namespace cugl {
     
 /**
@@ -94,6 +101,16 @@ namespace cugl {
  * that you explicitly specify a character set for the atlas.  Indeed, a 
  * character set is the only way to get unicode support; the basic atlas only 
  * includes ASCII characters.
+ *
+ * Alternatively, a font can have a distance field atlas.  This atlas stores
+ * the signed distance to each glyph edge instead of the glyph coverage, and
+ * the default {@link SpriteShader} thresholds it when drawing.  Text drawn
+ * this way stays sharp at any scale, so one font asset can serve labels of
+ * many sizes.  The distance atlas is also a glyph cache.  It has a fixed
+ * number of glyph cells, and any glyph missing from the atlas is added the
+ * first time it is drawn, replacing the least recently used glyph if the
+ * atlas is full.  So a distance atlas supports the full font, but its texture
+ * size depends only on its capacity.
  */
 class Font {
 #pragma mark Inner Classes
@@ -262,8 +279,57 @@ protected:
     std::unordered_map<Uint32, Rect> _glyphmap;
     /** The cached metrics for each font glyph */
     std::unordered_map<Uint32, Metrics> _glyphsize;
-    /** The kerning for each pair of characters */
-    std::unordered_map<Uint32, std::unordered_map<Uint32, Uint32> > _kernmap;
+    /** A flat copy of the cached ASCII metrics (advance is -1 if not cached) */
+    Metrics _asciisize[FONT_ASCII_GLYPHS];
+    
+    /**
+     * The kerning for a pair of glyphs
+     *
+     * The pair is stored as a single key, with the first glyph in the high
+     * bits. As SDL_ttf only supports UCS2, both glyphs fit in 16 bits.
+     */
+    struct Kerning {
+        /** The glyph pair (first << 16 | second) */
+        Uint32 pair;
+        /** The amount to reduce the advance of the first glyph */
+        int amount;
+    };
+    /** The non-zero kerning pairs for the atlas glyphs, sorted by pair */
+    std::vector<Kerning> _kerning;
+
+    // Distance atlas support
+    /**
+     * A cell in a distance field atlas
+     *
+     * Each cell holds at most one glyph.  The stamp is the value of the
+     * atlas clock the last time the glyph was drawn.
+     */
+    struct Slot {
+        /** The glyph in this cell (0 if empty) */
+        Uint32 glyph;
+        /** The last time this glyph was used */
+        Uint32 stamp;
+    };
+    /** Whether the atlas is a distance field */
+    bool _hasDistance;
+    /** The distance field spread (the padding around each glyph) */
+    int _spread;
+    /** The width of a distance atlas cell, including padding */
+    int _cellWidth;
+    /** The height of a distance atlas cell, including padding */
+    int _cellHeight;
+    /** The number of cells in each row of the distance atlas */
+    int _cellColumns;
+    /** The cells of the distance atlas */
+    std::vector<Slot> _slots;
+    /** The cell for each glyph in the distance atlas */
+    std::unordered_map<Uint32, Uint32> _glyphslot;
+    /** The number of cells filled so far */
+    Uint32 _slotsUsed;
+    /** The atlas clock, advanced once per rendered string */
+    Uint32 _clock;
+    /** The number of times a glyph was evicted from the atlas */
+    Uint32 _version;
     /** The OpenGL texture representing this atlas */
     std::shared_ptr<Texture> _texture;
     /** A (temporary) SDL surface for computing the atlas texture */
@@ -960,6 +1026,101 @@ public:
      * @return true if this font has an active atlas.
      */
     bool hasAtlas() const { return _hasAtlas; }
+
+    /**
+     * Creates a distance field atlas for the given character set.
+     *
+     * A distance atlas stores the signed distance to each glyph edge, so text
+     * drawn with it stays sharp at any scale.  The atlas has room for the
+     * given number of glyphs.  It starts with the glyphs in the character set
+     * (or the ASCII characters if the set is empty), and any other glyph is
+     * added the first time it is drawn.  If the atlas is full, the least
+     * recently used glyph is replaced.  If the character set is larger than
+     * the capacity, the capacity is increased to fit it.
+     *
+     * The spread is the distance, in pixels, over which the distance field
+     * falls off.  Larger spreads support effects such as outlines, at the
+     * cost of bigger atlas cells.
+     *
+     * The character atlas texture is generated immediately, so the method
+     * {@link getAtlas()} may be called with no delay.
+     *
+     * WARNING: This initializer is not thread safe.  It generates an OpenGL
+     * texture, which means that it may only be called in the main thread.
+     *
+     * @param charset   The initial characters in the atlas
+     * @param capacity  The number of glyphs in the atlas
+     * @param spread    The distance field spread in pixels
+     *
+     * @return true if the atlas was successfully created.
+     */
+    bool buildDistanceAtlas(const std::string& charset="",
+                            Uint32 capacity=FONT_DISTANCE_CAPACITY,
+                            Uint32 spread=FONT_DISTANCE_SPREAD) {
+        bool result = buildDistanceAtlasAsync(charset,capacity,spread);
+        return result && (getAtlas() != nullptr);
+    }
+
+    /**
+     * Creates a distance field atlas for the given character set.
+     *
+     * A distance atlas stores the signed distance to each glyph edge, so text
+     * drawn with it stays sharp at any scale.  The atlas has room for the
+     * given number of glyphs.  It starts with the glyphs in the character set
+     * (or the ASCII characters if the set is empty), and any other glyph is
+     * added the first time it is drawn.  If the atlas is full, the least
+     * recently used glyph is replaced.  If the character set is larger than
+     * the capacity, the capacity is increased to fit it.
+     *
+     * The spread is the distance, in pixels, over which the distance field
+     * falls off.  Larger spreads support effects such as outlines, at the
+     * cost of bigger atlas cells.
+     *
+     * This method does not generate the OpenGL texture, but does all other
+     * work in creates the atlas.  This creation will happen the first time
+     * that {@link getAtlas()} is called.
+     *
+     * As a result, this method is thread safe. It may be called in any
+     * thread, including threads other than the main one.
+     *
+     * @param charset   The initial characters in the atlas
+     * @param capacity  The number of glyphs in the atlas
+     * @param spread    The distance field spread in pixels
+     *
+     * @return true if the atlas was successfully created.
+     */
+    bool buildDistanceAtlasAsync(const std::string& charset="",
+                                 Uint32 capacity=FONT_DISTANCE_CAPACITY,
+                                 Uint32 spread=FONT_DISTANCE_SPREAD);
+
+    /**
+     * Returns true if this font has a distance field atlas.
+     *
+     * @return true if this font has a distance field atlas.
+     */
+    bool hasDistanceAtlas() const { return _hasDistance; }
+
+    /**
+     * Returns the number of glyphs that fit in the distance atlas.
+     *
+     * This method returns 0 if the font does not have a distance atlas.
+     *
+     * @return the number of glyphs that fit in the distance atlas.
+     */
+    Uint32 getAtlasCapacity() const { return (Uint32)_slots.size(); }
+
+    /**
+     * Returns the current version of the atlas layout.
+     *
+     * The version changes whenever a glyph is removed from the atlas, either
+     * because it was replaced in a distance atlas or because the atlas was
+     * cleared.  Quads generated before the change may refer to the wrong
+     * glyph, so a class that caches quads (such as {@link Label}) should
+     * regenerate them when this value changes.
+     *
+     * @return the current version of the atlas layout.
+     */
+    Uint32 getAtlasVersion() const { return _version; }
     
 #pragma mark -
 #pragma mark Rendering
@@ -1163,6 +1324,43 @@ public:
      */
     std::shared_ptr<Texture> getQuad(Uint32 thechar, Vec2& offset, const Rect& rect,
                                      std::vector<Vertex2>& vertices);
+
+    /**
+     * Reserves the given glyphs in the atlas for a new string.
+     *
+     * This method is for classes that generate the quads of a string one
+     * glyph at a time (such as an incremental {@link Label}).  If this font
+     * has a distance field atlas, the glyphs are added to it if necessary, and
+     * are all marked as used by the same string.  Hence none of them will
+     * evict another.  Any other glyph may be evicted, so the caller should
+     * compare {@link getAtlasVersion()} before and after this call.
+     *
+     * This method will fail if the font does not have an atlas.
+     *
+     * @param glyphs    The (unicode) glyphs of the string
+     *
+     * @return the atlas texture
+     */
+    const std::shared_ptr<Texture>& reserveGlyphs(const std::vector<Uint32>& glyphs);
+
+    /**
+     * Creates a single quad for a glyph reserved by {@link reserveGlyphs}.
+     *
+     * This method is the same as {@link getQuad}, except that it does not
+     * start a new string in a distance field atlas.  It will not generate
+     * anything if the glyph is missing or lies outside of the rectangle.
+     *
+     * This method will fail if the font does not have an atlas.
+     *
+     * @param thechar   The character to convert to render data
+     * @param offset    The (unkerned) starting position of the quad
+     * @param rect      The bounding box for the quad
+     * @param vertices  The list to append the vertices to
+     *
+     * @return true if the right edge of the glyph was generated
+     */
+    bool getGlyphQuad(Uint32 thechar, Vec2& offset, const Rect& rect,
+                      std::vector<Vertex2>& vertices);
     
     
 #pragma mark -
@@ -1384,6 +1582,58 @@ protected:
      */
     Rect getInternalBoundsUTF8(const std::string& text) const;
 
+    /**
+     * Returns the metrics for the given glyph.
+     *
+     * This method uses the cached metrics if they are available, and computes
+     * them otherwise.
+     *
+     * @param thechar   The glyph to measure
+     *
+     * @return the metrics for the given glyph.
+     */
+    Metrics lookupMetrics(Uint32 thechar) const {
+        if (thechar < FONT_ASCII_GLYPHS && _asciisize[thechar].advance >= 0) {
+            return _asciisize[thechar];
+        }
+        auto it = _glyphsize.find(thechar);
+        return (it != _glyphsize.end() ? it->second : computeMetrics(thechar));
+    }
+
+    /**
+     * Returns the kerning adjustment between the two glyphs.
+     *
+     * This method uses the kerning table if both glyphs belong to the atlas,
+     * and computes the kerning otherwise.
+     *
+     * @param a     The first glyph
+     * @param b     The second glyph
+     *
+     * @return the kerning adjustment between the two glyphs.
+     */
+    int lookupKerning(Uint32 a, Uint32 b) const;
+
+    /**
+     * Caches the metrics for the given glyph.
+     *
+     * ASCII metrics are also copied to a flat table, so that they can be
+     * looked up without hashing.
+     *
+     * @param thechar   The glyph to cache
+     * @param metrics   The glyph metrics
+     */
+    void cacheMetrics(Uint32 thechar, const Metrics& metrics) {
+        _glyphsize.emplace(thechar,metrics);
+        if (thechar < FONT_ASCII_GLYPHS) {
+            _asciisize[thechar] = metrics;
+        }
+    }
+
+    /**
+     * Clears all cached glyph metrics.
+     */
+    void clearMetrics();
+
 #pragma mark -
 #pragma mark Atlas Preparation
     /**
@@ -1413,6 +1663,17 @@ protected:
      */
     void prepareAtlasKerning();
 
+    /**
+     * Adds the kerning pairs for a new atlas glyph.
+     *
+     * The glyph is paired with itself and every glyph already in the
+     * glyph set, in both orders.  The glyph must already have cached
+     * metrics, but must not yet be in the glyph set.
+     *
+     * @param thechar   The glyph to add
+     */
+    void addKerning(Uint32 thechar);
+
     /**
      * Returns the metrics for the given character if available.
      * 
@@ -1490,6 +1751,33 @@ protected:
      * @return a blank surface of the given size.
      */
     SDL_Surface* allocSurface(int width, int height);
+
+#pragma mark -
+#pragma mark Distance Atlas Internals
+    /**
+     * Makes sure the given glyph is in the distance atlas.
+     *
+     * If the glyph is already present, this method marks it as used by the
+     * current string.  Otherwise it adds the glyph, replacing the least
+     * recently used glyph if the atlas is full.  A glyph used by the current
+     * string is never replaced.
+     *
+     * @param thechar   The glyph to cache
+     *
+     * @return true if the glyph is in the atlas.
+     */
+    bool cacheGlyph(Uint32 thechar);
+
+    /**
+     * Renders the distance field for a glyph into the given atlas cell.
+     *
+     * If the atlas texture exists, the cell is uploaded to it directly.
+     * Otherwise it is written into the atlas surface.
+     *
+     * @param thechar   The glyph to render
+     * @param slot      The atlas cell
+     */
+    void renderDistanceGlyph(Uint32 thechar, Uint32 slot);
 };
     
 #pragma mark -
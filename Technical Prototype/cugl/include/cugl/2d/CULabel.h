@@ -210,11 +210,34 @@ protected:
     
     /** Whether or not the glyphs have been rendered */
     bool _rendered;
+    /** The font atlas version when the glyphs were rendered */
+    Uint32 _atlasVersion;
     /** The glyph vertices */
     std::vector<Vertex2> _vertices;
     /** THe quad indices for the vertices */
     std::vector<unsigned short> _indices;
     std::shared_ptr<Texture> _texture;
+    
+    /** Whether text changes only rewrite the quads of the changed glyphs */
+    bool _incremental;
+    /** Whether the digits share a common (tabular) advance */
+    bool _tabular;
+    /** The decoded (unicode) glyphs of the text */
+    std::vector<Uint32> _glyphs;
+    /** The position of each glyph relative to the text origin */
+    std::vector<float> _pens;
+    /** The glyph stored in each quad of the vertex buffer */
+    std::vector<Uint32> _quadGlyphs;
+    /** The x-position of each quad in the vertex buffer */
+    std::vector<float> _quadPens;
+    /** The text origin y-position when the quads were generated */
+    float _quadBase;
+    /** The content size when the quads were generated */
+    Size _quadBounds;
+    /** Whether the vertex buffer starts with a background quad */
+    bool _quadBackdrop;
+    /** A scratch buffer for a single glyph quad */
+    std::vector<Vertex2> _scratch;
 
 public:
 #pragma mark -
@@ -311,7 +334,7 @@ public:
      * @return a newly allocated label with the given size and font atlas
      */
     static std::shared_ptr<Label> alloc(const Size& size, const std::shared_ptr<Font>& font) {
-        std::shared_ptr<Label> result = std::make_shared<Label>();
+        std::shared_ptr<Label> result = NodeArena::make<Label>();
         return (result->init(size,font) ? result : nullptr);
     }
 
@@ -333,7 +356,7 @@ public:
      * @return a newly allocated label with the given text and font atlas
      */
     static std::shared_ptr<Label> alloc(const std::string& text, const std::shared_ptr<Font>& font) {
-        std::shared_ptr<Label> result = std::make_shared<Label>();
+        std::shared_ptr<Label> result = NodeArena::make<Label>();
         return (result->initWithText(text,font) ? result : nullptr);
     }
     
@@ -358,7 +381,7 @@ public:
      * @return a newly allocated label with the given text and font atlas
      */
     static std::shared_ptr<Label> alloc(const char* text, const std::shared_ptr<Font>& font) {
-        std::shared_ptr<Label> result = std::make_shared<Label>();
+        std::shared_ptr<Label> result = NodeArena::make<Label>();
         return (result->initWithText(text,font) ? result : nullptr);
     }
 
@@ -399,6 +422,91 @@ public:
      */
     void setText(const std::string& text, bool resize=false);
     
+    /**
+     * Sets the text for this label to the given integer.
+     *
+     * The number is formatted without allocating a string.  If the label
+     * already displays this number (and resize is false), this method does
+     * nothing.  Combined with an incremental label, this makes a counter
+     * that can be updated every frame for free.
+     *
+     * @oaram value     The number to display
+     * @oaram resize    Whether to resize the label to fit the new text.
+     */
+    void setNumber(Sint64 value, bool resize=false);
+    
+    /**
+     * Returns true if this label updates its text incrementally.
+     *
+     * An incremental label keeps one quad per glyph in its vertex buffer.
+     * When the text changes, it only rewrites the quads of glyphs that
+     * changed or moved.  Once the label has enough capacity, setting the text
+     * performs no allocations.  This is ideal for labels that change every
+     * frame, such as counters and timers.
+     *
+     * Incremental updates require a font atlas.  Without one, the label is
+     * regenerated in full, as usual.
+     *
+     * @return true if this label updates its text incrementally.
+     */
+    bool isIncremental() const { return _incremental; }
+    
+    /**
+     * Sets whether this label updates its text incrementally.
+     *
+     * An incremental label keeps one quad per glyph in its vertex buffer.
+     * When the text changes, it only rewrites the quads of glyphs that
+     * changed or moved.  Once the label has enough capacity, setting the text
+     * performs no allocations.  This is ideal for labels that change every
+     * frame, such as counters and timers.
+     *
+     * Incremental updates require a font atlas.  Without one, the label is
+     * regenerated in full, as usual.
+     *
+     * @param value     Whether to update the text incrementally
+     * @param capacity  The number of glyphs to reserve space for
+     */
+    void setIncremental(bool value, size_t capacity=0);
+    
+    /**
+     * Reserves space for text with the given number of glyphs.
+     *
+     * An incremental label will not allocate memory when its text changes,
+     * provided that the text has at most this many glyphs (and bytes).
+     *
+     * @param capacity  The number of glyphs to reserve space for
+     */
+    void reserve(size_t capacity);
+    
+    /**
+     * Returns true if the digits share a common (tabular) advance.
+     *
+     * With tabular digits, every digit takes the width of the widest digit,
+     * and is centered in that space.  Digits are also not kerned.  Hence a
+     * number does not shift as its digits change, and an incremental label
+     * only rewrites the digits that actually changed.
+     *
+     * Tabular digits are only supported by incremental labels.
+     *
+     * @return true if the digits share a common (tabular) advance.
+     */
+    bool usesTabularDigits() const { return _tabular; }
+    
+    /**
+     * Sets whether the digits share a common (tabular) advance.
+     *
+     * With tabular digits, every digit takes the width of the widest digit,
+     * and is centered in that space.  Digits are also not kerned.  Hence a
+     * number does not shift as its digits change, and an incremental label
+     * only rewrites the digits that actually changed.
+     *
+     * Tabular digits are only supported by incremental labels.  This setting
+     * does not resize the label.
+     *
+     * @param value Whether the digits share a common (tabular) advance.
+     */
+    void setTabularDigits(bool value);
+    
     /**
      * Returns the padding of the rendered text.
      *
@@ -733,7 +841,32 @@ public:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
-    
+
+    /**
+     * Returns the number of vertices sent to the SpriteBatch by draw().
+     *
+     * This is the number of indices for the background and glyph quads.
+     * It is 0 until the label is first drawn.
+     *
+     * @return the number of vertices sent to the SpriteBatch by draw().
+     */
+    virtual unsigned int getDrawCount() const override {
+        return (unsigned int)_indices.size();
+    }
+
+    /**
+     * Returns true if draw() may be called on a worker thread.
+     *
+     * Generating the glyphs may add them to the font atlas, which is shared
+     * with every other label and must be uploaded to OpenGL.  So a label is
+     * only concurrent once its glyphs are generated and still current.
+     *
+     * @return true if draw() may be called on a worker thread.
+     */
+    virtual bool isConcurrent() const override {
+        return _rendered && _font != nullptr && _font->getAtlasVersion() == _atlasVersion;
+    }
+
 private:
 #pragma mark -
 #pragma mark Internal Helpers
@@ -749,6 +882,18 @@ private:
      */
     void computeSize();
 
+    /**
+     * Sets the text for this label to the given characters.
+     *
+     * This is the implementation of {@link setText}.  It removes the
+     * unprintable characters, exactly as that method does.
+     *
+     * @param text      The characters of the text
+     * @param length    The number of characters
+     * @param resize    Whether to resize the label to fit the new text.
+     */
+    void assignText(const char* text, size_t length, bool resize);
+
     /**
      * Allocate the render data necessary to render this node.
      */
@@ -759,6 +904,47 @@ private:
      */
     void clearRenderData();
     
+    /**
+     * Decodes the text into the glyph buffer.
+     */
+    void decodeText();
+    
+    /**
+     * Computes the position of each glyph relative to the text origin.
+     *
+     * This method stores the positions in _pens, and requires a font atlas.
+     *
+     * @return the total advance of the text
+     */
+    float layoutGlyphs();
+    
+    /**
+     * Computes the text bounds from the glyph metrics.
+     *
+     * This is the incremental version of {@link computeSize}.  It gives the
+     * same results as the font measurements, but does not allocate memory.
+     */
+    void measureGlyphs();
+    
+    /**
+     * Updates the render data, rewriting only the quads that changed.
+     *
+     * This method requires a font atlas.
+     */
+    void updateRenderData();
+    
+    /**
+     * Writes the quad for a single glyph to the vertex buffer.
+     *
+     * If the glyph generates no quad, the quad is made degenerate.
+     *
+     * @param index     The first vertex of the quad
+     * @param thechar   The glyph to write
+     * @param pen       The x-position of the glyph
+     * @param bounds    The bounding box for the quad
+     */
+    void writeQuad(size_t index, Uint32 thechar, float pen, const Rect& bounds);
+    
     /**
      * Updates the color value for any other data that needs it.
      *
@@ -48,9 +48,16 @@
 #include "../math/CUMat4.h"
 #include "../renderer/CUSpriteBatch.h"
 #include "../util/CUDebug.h"
+#include "CUNodeArena.h"
+#include <unordered_map>
 #include <vector>
 #include <string>
 
+/** The number of children at which a node indexes its children by tag and name */
+#define NODE_INDEX_THRESHOLD    8
+/** The largest render cache (in pixels along each side) a node may allocate */
+#define NODE_CACHE_LIMIT        2048
+
 namespace cugl {
     
 // Forward reference
@@ -197,6 +204,37 @@ protected:
     int  _zOrder;
     /** Indicates whether or not the z-order is currently violated */
     bool _zDirty;
+
+    /** Indicates whether the child lookup indices must be rebuilt */
+    mutable bool _indexDirty;
+    /** The offset of the first child with each tag (built on demand) */
+    mutable std::unordered_map<unsigned int, int> _tagIndex;
+    /** The offset of the first child with each name hash (built on demand) */
+    mutable std::unordered_map<size_t, int> _nameIndex;
+
+    /** The bounds of everything drawn by this subtree, in node space (cached) */
+    Rect _subtreeBounds;
+    /** Whether this subtree draws nothing at all (cached) */
+    bool _subtreeEmpty;
+    /** The number of nodes in this subtree (cached) */
+    unsigned int _subtreeNodes;
+    /** The number of vertices drawn by this subtree (cached) */
+    unsigned int _subtreeVerts;
+    /** Whether the cached subtree values must be recomputed */
+    bool _boundsDirty;
+
+    /** The render target holding this subtree (nullptr if not cached) */
+    std::shared_ptr<RenderTarget> _cache;
+    /** Whether this subtree is drawn from a render target */
+    bool _cacheEnabled;
+    /** Whether the render target must be redrawn */
+    bool _cacheDirty;
+    /** The region of node space held by the render target */
+    Rect _cacheBounds;
+    /** The size in pixels of the region used in the render target */
+    int _cacheWidth;
+    /** The size in pixels of the region used in the render target */
+    int _cacheHeight;
     
 #pragma mark -
 #pragma mark Constructors
@@ -361,7 +399,7 @@ public:
      * @return a newly allocated node at the world origin.
      */
     static std::shared_ptr<Node> alloc() {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->init() ? result : nullptr);
     }
     
@@ -376,7 +414,7 @@ public:
      * @return a newly allocated node at the given position.
      */
     static std::shared_ptr<Node> allocWithPosition(const Vec2& pos) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithPosition(pos) ? result : nullptr);
     }
     
@@ -392,7 +430,7 @@ public:
      * @return a newly allocated node at the given position.
      */
     static std::shared_ptr<Node> allocWithPosition(float x, float y) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithPosition(x,y) ? result : nullptr);
     }
 
@@ -409,7 +447,7 @@ public:
      * @return a newly allocated node with the given size.
      */
     static std::shared_ptr<Node> allocWithBounds(const Size& size) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithBounds(size) ? result : nullptr);
     }
     
@@ -427,7 +465,7 @@ public:
      * @return a newly allocated node with the given size.
      */
     static std::shared_ptr<Node> allocWithBounds(float width, float height) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithBounds(width,height) ? result : nullptr);
     }
     
@@ -447,7 +485,7 @@ public:
      * @return a newly allocated node with the given bounds.
      */
     static std::shared_ptr<Node> allocWithBounds(const Rect& rect) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithBounds(rect) ? result : nullptr);
     }
     
@@ -470,7 +508,7 @@ public:
      * @return a newly allocated node with the given bounds.
      */
     static std::shared_ptr<Node> allocWithBounds(float x, float y, float width, float height) {
-        std::shared_ptr<Node> result = std::make_shared<Node>();
+        std::shared_ptr<Node> result = NodeArena::make<Node>();
         return (result->initWithBounds(x,y,width,height) ? result : nullptr);
     }
     
@@ -496,7 +534,12 @@ public:
      *
      * @param tag   A tag that is used to identify the node easily.
      */
-    void setTag(unsigned int tag) { _tag = tag; }
+    void setTag(unsigned int tag) {
+        _tag = tag;
+        if (_parent != nullptr) {
+            _parent->_indexDirty = true;
+        }
+    }
     
     /**
      * Returns a string that is used to identify the node.
@@ -521,6 +564,9 @@ public:
     void setName(const std::string& name) {
         _name = name;
         _hashOfName = std::hash<std::string>()(_name);
+        if (_parent != nullptr) {
+            _parent->_indexDirty = true;
+        }
     }
 
     /**
@@ -895,7 +941,10 @@ public:
      *
      * @param color the color tinting this node.
      */
-    void setColor(Color4 color) { _tintColor = color; }
+    void setColor(Color4 color) {
+        _tintColor = color;
+        if (_parent != nullptr) { _parent->invalidateCache(); }
+    }
 
     /**
      * Returns the absolute color tinting this node.
@@ -928,7 +977,10 @@ public:
      *
      * @param visible   true if the node is visible.
      */
-    void setVisible(bool visible) { _isVisible = visible; }
+    void setVisible(bool visible) {
+        _isVisible = visible;
+        if (_parent != nullptr) { _parent->invalidateCache(); }
+    }
     
     /**
      * Returns true if this node is tinted by its parent.
@@ -1421,6 +1473,9 @@ public:
      * guaranteed for subclasses of Node. Hence it is very important that
      * tags be unique.
      *
+     * Nodes with many children keep a hash index of their child tags, so
+     * this lookup does not need to search every child.
+     *
      * @param tag   An identifier to find the child node.
      *
      * @return the (first) child with the given tag.
@@ -1459,6 +1514,10 @@ public:
      * guaranteed for subclasses of Node. Hence it is very important that
      * names be unique.
      *
+     * Nodes with many children keep a hash index of their child names, so
+     * a lookup that hits the index does not need to search every child.
+     * A miss still searches the children.
+     *
      * @param name  An identifier to find the child node.
      *
      * @return the (first) child with the given name.
@@ -1763,7 +1822,118 @@ public:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {}
-    
+
+    /**
+     * Returns the bounds of everything drawn by draw(), in node space.
+     *
+     * A {@link Scene} uses these bounds to skip nodes that are off screen.
+     * By default this is the rectangle with origin (0,0) and the content
+     * size.  If you create a custom Node that draws outside of this box,
+     * you must override this method.  An empty rectangle means that the
+     * node draws nothing.
+     *
+     * @return the bounds of everything drawn by draw(), in node space.
+     */
+    virtual Rect getDrawBounds() const { return Rect(Vec2::ZERO, getContentSize()); }
+
+    /**
+     * Returns the number of vertices sent to the SpriteBatch by draw().
+     *
+     * This value is only used for the render statistics of a {@link Scene}.
+     * Like {@link SpriteBatch#getVerticesDrawn()}, it counts indexed
+     * vertices.  It is 0 by default.
+     *
+     * @return the number of vertices sent to the SpriteBatch by draw().
+     */
+    virtual unsigned int getDrawCount() const { return 0; }
+
+    /**
+     * Returns true if draw() may be called on a worker thread.
+     *
+     * A {@link Scene} with several render threads draws its subtrees into
+     * deferred sprite batches on worker threads.  A node whose draw() needs
+     * OpenGL, or changes state shared with other nodes, must return false.
+     * Such a node (and its subtree) is drawn on the main thread when the
+     * batches are replayed, in the same order.  This is true by default.
+     *
+     * @return true if draw() may be called on a worker thread.
+     */
+    virtual bool isConcurrent() const { return true; }
+
+#pragma mark -
+#pragma mark Render Cache
+    /**
+     * Sets whether this subtree is drawn from a render cache.
+     *
+     * A cached subtree is drawn once into an offscreen {@link RenderTarget},
+     * and then drawn as a single textured quad until the cache is invalidated.
+     * This is useful for a complex subtree that rarely changes, but which may
+     * move around the screen.  Moving, scaling or tinting this node does not
+     * invalidate the cache, but changes to the subtree (adding or removing
+     * children, or changing their transform, color or visibility) do.  Any
+     * other change to a descendant must be followed by a call to
+     * {@link invalidateCache()}.
+     *
+     * The cache is sized to the subtree on screen, so it is rebuilt if the
+     * subtree is scaled.  It is tinted as a whole, so every descendant is
+     * drawn as if it inherited the color of this node.
+     *
+     * Disabling the cache releases the render target.
+     *
+     * @param value Whether this subtree is drawn from a render cache
+     */
+    void setCached(bool value);
+
+    /**
+     * Returns true if this subtree is drawn from a render cache.
+     *
+     * @return true if this subtree is drawn from a render cache.
+     */
+    bool isCached() const { return _cacheEnabled; }
+
+    /**
+     * Returns true if the render cache of this subtree is up to date.
+     *
+     * This is always false if caching is disabled.
+     *
+     * @return true if the render cache of this subtree is up to date.
+     */
+    bool isCacheValid() const { return _cacheEnabled && _cache != nullptr && !_cacheDirty; }
+
+    /**
+     * Marks the render cache of this node and its ancestors as out of date.
+     *
+     * Every cached node on the path to the root is redrawn the next time it
+     * is rendered.  Call this method on a descendant of a cached node after
+     * any change that the cache cannot detect, such as a new texture.
+     */
+    void invalidateCache();
+
+protected:
+    /** The nodes and vertices drawn and skipped by a culling render */
+    struct RenderStats {
+        /** The number of nodes drawn */
+        unsigned int nodesDrawn;
+        /** The number of nodes skipped */
+        unsigned int nodesCulled;
+        /** The number of vertices drawn */
+        unsigned int vertsDrawn;
+        /** The number of vertices skipped */
+        unsigned int vertsCulled;
+        
+        /** Creates empty statistics */
+        RenderStats() : nodesDrawn(0), nodesCulled(0), vertsDrawn(0), vertsCulled(0) {}
+    };
+    
+    /**
+     * Marks the cached bounds of this subtree (and its ancestors) as dirty.
+     *
+     * Subclasses must call this method whenever the result of either
+     * {@link getDrawBounds()} or {@link getDrawCount()} changes.  Changes
+     * to the content size and transform are handled automatically.
+     */
+    void invalidateBounds();
+
 private:
 #pragma mark -
 #pragma mark Internal Helpers
@@ -1827,6 +1997,63 @@ private:
      * @return true if sibling a is less than b in sorted z-order.
      */
     static bool compareNodeSibs(const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b);
+
+    /**
+     * Rebuilds the child lookup indices if they are out of date.
+     *
+     * The indices map each tag and name hash to the offset of the first
+     * child with that tag or name.  They are only built for nodes with
+     * at least NODE_INDEX_THRESHOLD children.  Smaller nodes are searched
+     * linearly, which is faster than hashing for so few children.
+     *
+     * @return true if the indices may be used for lookup.
+     */
+    bool buildIndex() const;
+
+    /**
+     * Recomputes the cached subtree bounds and counts if they are dirty.
+     *
+     * The subtree bounds are stored in node space, so moving a node only
+     * dirties its ancestors, and never its descendants.
+     */
+    void updateBounds();
+
+    /**
+     * Draws the visible parts of this subtree with the given SpriteBatch.
+     *
+     * This is the culling version of render, used by {@link Scene}.  Any
+     * subtree whose bounds do not intersect the view is skipped, as is any
+     * node whose absolute tint is fully transparent.  The nodes and vertices
+     * drawn and skipped are added to the given statistics.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     * @param view      The visible region in world coordinates.
+     * @param stats     The render statistics to update.
+     */
+    void renderVisible(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform,
+                       Color4 tint, const Rect& view, RenderStats& stats);
+
+    /**
+     * Adds this subtree to the culled statistics.
+     *
+     * @param stats     The render statistics to update.
+     */
+    void cullSubtree(RenderStats& stats);
+
+    /**
+     * Draws this subtree from its render cache, redrawing the cache if needed.
+     *
+     * The matrix and color are the combined ones for this node, as passed to
+     * {@link draw}.  The cache is redrawn if it is out of date, or if the
+     * subtree now covers a different number of pixels on screen.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param matrix    The transform of this node.
+     * @param color     The tint of this node.
+     */
+    void renderCached(const std::shared_ptr<SpriteBatch>& batch, const Mat4& matrix, Color4 color);
     
     /**
      * Updates the node to parent transform.
@@ -0,0 +1,358 @@
+//
+//  CUNodeArena.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a pooled allocator for scene graph nodes.  Building a
+//  level allocates hundreds of small nodes at once, and releases them all at
+//  once when the level is torn down.  An arena carves those nodes out of a
+//  few large chunks, and recycles freed blocks through size-class free lists,
+//  so that this churn never reaches the general purpose heap.
+//
+//  Nodes are still managed by shared pointers.  The arena is attached to the
+//  control block of every node it allocates (via std::allocate_shared), so
+//  the reference count lives in the same block as the node, and the arena
+//  lives as long as any node allocated from it.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_NODE_ARENA_H__
+#define __CU_NODE_ARENA_H__
+#include <cugl/base/CUBase.h>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+/** The default size of an arena chunk in bytes */
+#define NODE_ARENA_CHUNK    65536
+/** The granularity of the arena size classes in bytes */
+#define NODE_ARENA_QUANTUM  16
+/** The largest block (in bytes) served by the arena; larger ones use the heap */
+#define NODE_ARENA_LIMIT    2048
+
+namespace cugl {
+
+#pragma mark -
+#pragma mark Node Arena
+/**
+ * This class is a pooled allocator for scene graph nodes.
+ *
+ * An arena reserves memory in large chunks, and hands out blocks rounded
+ * up to a multiple of 16 bytes.  Freed blocks go onto a free list for their
+ * size class, and are reused by the next allocation of that size.  Memory is
+ * only returned to the system when the arena is deleted.  Requests larger
+ * than NODE_ARENA_LIMIT bytes are passed through to the heap.
+ *
+ * Arenas are not normally used directly.  Instead, create a {@link Scope}
+ * for the arena of a {@link Scene} while building its scene graph.  Every
+ * node allocated with a static constructor in that scope is placed in the
+ * arena (see {@link make}).  Nodes allocated outside of any scope use the
+ * heap as before.  It is safe for a node in an arena to outlive its scene,
+ * because every such node holds a reference to its arena.
+ *
+ * Allocation and deallocation are thread safe, as the last reference to a
+ * node may be released on any thread.
+ */
+class NodeArena {
+private:
+    /** This macro disables the copy constructor (not allowed on arenas) */
+    CU_DISALLOW_COPY_AND_ASSIGN(NodeArena);
+
+    /** A freed block, linking to the next free block of the same size */
+    struct Block {
+        Block* next;
+    };
+
+    /** The size of each chunk in bytes */
+    size_t _chunksize;
+    /** The chunks reserved by this arena */
+    std::vector<Uint8*> _chunks;
+    /** The next unused byte of the current chunk */
+    Uint8* _cursor;
+    /** The end of the current chunk */
+    Uint8* _limit;
+    /** The free lists, one per size class */
+    Block* _free[NODE_ARENA_LIMIT/NODE_ARENA_QUANTUM];
+
+    /** The number of live allocations */
+    size_t _count;
+    /** The number of bytes in live allocations */
+    size_t _inuse;
+    /** The total number of allocations made by this arena */
+    size_t _total;
+    /** The lock protecting the free lists and chunks */
+    mutable std::mutex _mutex;
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized arena.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    NodeArena();
+
+    /**
+     * Deletes this arena, releasing all chunks.
+     */
+    ~NodeArena() { dispose(); }
+
+    /**
+     * Releases all of the chunks of this arena.
+     *
+     * This method should not be called while there are still live blocks
+     * in the arena.  That never happens for an arena referenced by a node
+     * allocator, as the allocator keeps the arena alive.
+     */
+    void dispose();
+
+    /**
+     * Initializes an arena with the given chunk size.
+     *
+     * No memory is reserved until the first allocation.  The chunk size
+     * must be at least NODE_ARENA_LIMIT bytes.
+     *
+     * @param chunksize The size of each chunk in bytes
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t chunksize=NODE_ARENA_CHUNK);
+
+    /**
+     * Returns a newly allocated arena with the given chunk size.
+     *
+     * No memory is reserved until the first allocation.  The chunk size
+     * must be at least NODE_ARENA_LIMIT bytes.
+     *
+     * @param chunksize The size of each chunk in bytes
+     *
+     * @return a newly allocated arena with the given chunk size.
+     */
+    static std::shared_ptr<NodeArena> alloc(size_t chunksize=NODE_ARENA_CHUNK) {
+        std::shared_ptr<NodeArena> result = std::make_shared<NodeArena>();
+        return (result->init(chunksize) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Allocation
+    /**
+     * Returns a block of at least the given size.
+     *
+     * The block is aligned to NODE_ARENA_QUANTUM bytes.
+     *
+     * @param size  The requested size in bytes
+     *
+     * @return a block of at least the given size.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Returns a block to this arena.
+     *
+     * The size must be the same as the one used to allocate the block.
+     *
+     * @param ptr   The block to release
+     * @param size  The size of the block in bytes
+     */
+    void deallocate(void* ptr, size_t size);
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the number of blocks currently allocated from this arena.
+     *
+     * @return the number of blocks currently allocated from this arena.
+     */
+    size_t getCount() const;
+
+    /**
+     * Returns the number of bytes currently allocated from this arena.
+     *
+     * This includes the rounding to the size classes.
+     *
+     * @return the number of bytes currently allocated from this arena.
+     */
+    size_t getUsage() const;
+
+    /**
+     * Returns the number of bytes reserved by this arena.
+     *
+     * @return the number of bytes reserved by this arena.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * Returns the total number of allocations made by this arena.
+     *
+     * @return the total number of allocations made by this arena.
+     */
+    size_t getTotal() const;
+
+#pragma mark -
+#pragma mark Scopes
+    /**
+     * This class makes an arena the current arena for the calling thread.
+     *
+     * A scope is meant to be a local variable.  While the scope exists, the
+     * node static constructors allocate nodes in its arena.  The previous
+     * arena (if any) is restored when the scope is deleted, so scopes may
+     * be nested.  A scope for a null arena restores heap allocation.
+     */
+    class Scope {
+    private:
+        /** This macro disables the copy constructor (not allowed on scopes) */
+        CU_DISALLOW_COPY_AND_ASSIGN(Scope);
+        /** The arena that was current before this scope */
+        std::shared_ptr<NodeArena> _previous;
+
+    public:
+        /**
+         * Creates a scope making the given arena current.
+         *
+         * @param arena The arena to make current
+         */
+        Scope(const std::shared_ptr<NodeArena>& arena);
+
+        /**
+         * Deletes this scope, restoring the previous arena.
+         */
+        ~Scope();
+    };
+
+    /**
+     * Returns the current arena for the calling thread (or nullptr if none).
+     *
+     * @return the current arena for the calling thread (or nullptr if none).
+     */
+    static const std::shared_ptr<NodeArena>& getCurrent();
+
+    /**
+     * Returns a new default-constructed object in the current arena.
+     *
+     * If there is no current arena, the object is allocated with
+     * std::make_shared.  This is the method that the static constructors
+     * of the node classes use.
+     *
+     * @return a new default-constructed object in the current arena.
+     */
+    template <typename T>
+    static std::shared_ptr<T> make();
+};
+
+#pragma mark -
+#pragma mark Node Allocator
+/**
+ * This class is a standard allocator for a {@link NodeArena}.
+ *
+ * It is used with std::allocate_shared, which places the object and its
+ * reference counts in a single arena block.  The allocator holds a
+ * reference to the arena, keeping it alive as long as the object.
+ */
+template <typename T>
+class NodeAllocator {
+public:
+    /** The allocated type (required by the standard) */
+    typedef T value_type;
+
+    /** The arena to allocate from */
+    std::shared_ptr<NodeArena> arena;
+
+    /**
+     * Creates an allocator for the given arena.
+     *
+     * @param arena The arena to allocate from
+     */
+    NodeAllocator(const std::shared_ptr<NodeArena>& arena) : arena(arena) {}
+
+    /**
+     * Creates a copy of an allocator for another type.
+     *
+     * @param other The allocator to copy
+     */
+    template <typename U>
+    NodeAllocator(const NodeAllocator<U>& other) : arena(other.arena) {}
+
+    /**
+     * Returns storage for n objects of type T.
+     *
+     * @param n The number of objects
+     *
+     * @return storage for n objects of type T.
+     */
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n*sizeof(T)));
+    }
+
+    /**
+     * Releases storage for n objects of type T.
+     *
+     * @param ptr   The storage to release
+     * @param n     The number of objects
+     */
+    void deallocate(T* ptr, size_t n) {
+        arena->deallocate(ptr,n*sizeof(T));
+    }
+};
+
+/** Returns true if the two allocators share an arena */
+template <typename T, typename U>
+bool operator==(const NodeAllocator<T>& a, const NodeAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+/** Returns true if the two allocators do not share an arena */
+template <typename T, typename U>
+bool operator!=(const NodeAllocator<T>& a, const NodeAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+/**
+ * Returns a new default-constructed object in the current arena.
+ *
+ * If there is no current arena, the object is allocated with
+ * std::make_shared.  This is the method that the static constructors
+ * of the node classes use.
+ *
+ * @return a new default-constructed object in the current arena.
+ */
+template <typename T>
+std::shared_ptr<T> NodeArena::make() {
+    const std::shared_ptr<NodeArena>& arena = getCurrent();
+    if (arena == nullptr) {
+        return std::make_shared<T>();
+    }
+    return std::allocate_shared<T>(NodeAllocator<T>(arena));
+}
+
+}
+#endif /* __CU_NODE_ARENA_H__ */
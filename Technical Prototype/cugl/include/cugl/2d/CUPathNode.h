@@ -110,11 +110,6 @@ namespace cugl {
 class PathNode : public TexturedNode {
 #pragma mark Values
 protected:
-    /** An extruder for those incomplete polygons */
-    static PathExtruder _extruder;
-    /** An outliner for those incomplete polygons */
-    static PathOutliner _outliner;
-
     /** The extrusion polygon, when the stroke > 0 */
     Poly2 _extrusion;
     /** The bounds of the extruded shape */
@@ -161,8 +156,8 @@ public:
      * The polygon will be extruded using the given sequence of vertices. 
      * First it will traverse the vertices using either a closed or open
      * traveral.  Then it will extrude that polygon with the given joint
-     * and cap. PathNode objects share a single extruder, so this initializer 
-     * is not thread safe.
+     * and cap. PathNode objects share extrusions through ShapeCache, so this initializer 
+     * is thread safe.
      *
      * @param vertices  The vertices to texture (expressed in image space)
      * @param stroke    The stroke width of the extruded path.
@@ -186,8 +181,8 @@ public:
      * The polygon will be extruded using the given polygon, assuming that it
      * is a (connected) path. It will extrude that polygon with the given joint
      * and cap.  It will assume the polygon is closed if the number of indices
-     * is twice the number of vertices. PathNode objects share a single extruder, 
-     * so this initializer is not thread safe.
+     * is twice the number of vertices. PathNode objects share extrusions through ShapeCache, 
+     * so this initializer is thread safe.
      *
      * @param poly      The polygon to texture (expressed in image space)
      * @param stroke    The stroke width of the extruded path.
@@ -209,7 +204,7 @@ public:
      * @return an empty path node.
      */
     static std::shared_ptr<PathNode> alloc() {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->init() ? node : nullptr);
     }
     
@@ -219,8 +214,8 @@ public:
      * The polygon will be extruded using the given sequence of vertices.
      * First it will traverse the vertices using either a closed or open
      * traveral.  Then it will extrude that polygon with the given joint
-     * and cap. PathNode objects share a single extruder, so this constructor
-     * is not thread safe.
+     * and cap. PathNode objects share extrusions through ShapeCache, so this constructor
+     * is thread safe.
      *
      * @param vertices  The vertices to texture (expressed in image space)
      * @param stroke    The stroke width of the extruded path.
@@ -233,7 +228,7 @@ public:
     static std::shared_ptr<PathNode> allocWithVertices(const std::vector<Vec2>& vertices, float stroke,
                                                        PathJoint joint = PathJoint::NONE,
                                                        PathCap cap = PathCap::NONE, bool closed = true) {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->initWithVertices(vertices,stroke,joint,cap,closed) ? node : nullptr);
     }
     
@@ -243,8 +238,8 @@ public:
      * The polygon will be extruded using the given polygon, assuming that it
      * is a (connected) path. It will extrude that polygon with the given joint
      * and cap.  It will assume the polygon is closed if the number of indices
-     * is twice the number of vertices. PathNode objects share a single extruder, 
-     * so this constructor is not thread safe.
+     * is twice the number of vertices. PathNode objects share extrusions through ShapeCache, 
+     * so this constructor is thread safe.
      *
      * @param poly      The polygon to texture (expressed in image space)
      * @param stroke    The stroke width of the extruded path.
@@ -256,7 +251,7 @@ public:
     static std::shared_ptr<PathNode> allocWithPoly(const Poly2& poly, float stroke,
                                                    PathJoint joint = PathJoint::NONE,
                                                    PathCap cap = PathCap::NONE) {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->initWithPoly(poly,stroke,joint,cap) ? node : nullptr);
     }
     
@@ -266,7 +261,7 @@ public:
      * The rectangle will be converted into a Poly2, using the standard outline.
      * This is the same as passing Poly2(rect,false).  The traversal will be
      * CLOSED. It will then be extruded with the current joint and cap. PathNode
-     * objects share a single extruder, so this constructor is not thread safe.
+     * objects share extrusions through ShapeCache, so this constructor is thread safe.
      *
      * @param rect      The rectangle for to texture.
      * @param stroke    The stroke width of the extruded path.
@@ -278,15 +273,15 @@ public:
     static std::shared_ptr<PathNode> allocWithRect(const Rect& rect, float stroke,
                                                    PathJoint joint = PathJoint::NONE,
                                                    PathCap cap = PathCap::NONE) {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->initWithPoly(Poly2(rect,false),stroke,joint,cap) ? node : nullptr);
     }
     
     /**
      * Returns a path node that is a line from origin to destination.
      *
-     * The path will be OPEN. PathNode objects share a single extruder, so this
-     * constructor is not thread safe.
+     * The path will be OPEN. PathNode objects share extrusions through ShapeCache, so this
+     * constructor is thread safe.
      *
      * @param origin    The line origin
      * @param dest      The line destination
@@ -299,7 +294,7 @@ public:
     static std::shared_ptr<PathNode> allocWithLine(const Vec2 &origin, const Vec2 &dest, float stroke,
                                                    PathJoint joint = PathJoint::NONE,
                                                    PathCap cap = PathCap::NONE) {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->initWithPoly(Poly2::createLine(origin, dest),stroke,joint,cap) ? node : nullptr);
     }
     
@@ -307,8 +302,8 @@ public:
      * Returns a path node that is an ellipse with given the center and dimensions.
      *
      * The path node will draw around the boundary of the ellipse, and will be
-     * CLOSED. PathNode objects share a single extruder, so this constructor is 
-     * not thread safe.
+     * CLOSED. PathNode objects share extrusions through ShapeCache, so this constructor is 
+     * thread safe.
      *
      * @param   center      The ellipse center point
      * @param   size        The size of the ellipse
@@ -323,7 +318,7 @@ public:
                                                       unsigned int segments = PATH_SEGMENTS,
                                                       PathJoint joint = PathJoint::NONE,
                                                       PathCap cap = PathCap::NONE) {
-        std::shared_ptr<PathNode> node = std::make_shared<PathNode>();
+        std::shared_ptr<PathNode> node = NodeArena::make<PathNode>();
         return (node->initWithPoly(Poly2::createEllipse(center,size,segments,false),stroke,joint,cap) ?
                 node : nullptr);
     }
@@ -407,7 +402,7 @@ public:
      * The polygon will be extruded using the given sequence of vertices.
      * First it will traverse the vertices using the current traversal. Then
      * it will extrude that polygon with the current joint and cap. PathNode 
-     * objects share a single extruder, so this method is not thread safe.
+     * objects share extrusions through ShapeCache, so this method is thread safe.
      *
      * @param vertices  The vertices to texture
      */
@@ -418,8 +413,8 @@ public:
      *
      * This method will extrude that polygon with the current joint and cap.
      * The polygon is assumed to be closed if the number of indices is twice
-     * the number of vertices. PathNode objects share a single extruder, so
-     * this method is not thread safe.
+     * the number of vertices. PathNode objects share extrusions through ShapeCache, so
+     * this method is thread safe.
      *
      * @param poly  The polygon to texture
      */
@@ -430,8 +425,8 @@ public:
      *
      * The rectangle will be converted into a Poly2, using the standard outline.
      * This is the same as passing Poly2(rect,false). It will then be extruded 
-     * with the current joint and cap. PathNode objects share a single extruder,
-     * so this method is not thread safe.
+     * with the current joint and cap. PathNode objects share extrusions through ShapeCache,
+     * so this method is thread safe.
      *
      * @param rect  The rectangle to texture
      */
@@ -514,6 +509,31 @@ public:
      * @param tint      The tint to blend with the Node color.
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+
+    /**
+     * Returns the bounds of everything drawn by draw(), in node space.
+     *
+     * If the path has a stroke, these are the extruded content bounds.
+     * Otherwise it is the bounding box of the path, placed at the origin.
+     *
+     * @return the bounds of everything drawn by draw(), in node space.
+     */
+    virtual Rect getDrawBounds() const override {
+        return (_stroke > 0 ? _extrbounds : Rect(Vec2::ZERO, _polygon.getBounds().size));
+    }
+
+    /**
+     * Returns the number of vertices sent to the SpriteBatch by draw().
+     *
+     * This is the number of indices in the extruded polygon if the path
+     * has a stroke, and the number of indices in the path otherwise.
+     *
+     * @return the number of vertices sent to the SpriteBatch by draw().
+     */
+    virtual unsigned int getDrawCount() const override {
+        const Poly2& source = (_stroke > 0 ? _extrusion : _polygon);
+        return (unsigned int)source.getIndices().size();
+    }
     
 
     
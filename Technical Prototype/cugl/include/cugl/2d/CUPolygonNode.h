@@ -44,7 +44,7 @@
 
 #include <string>
 #include "CUTexturedNode.h"
-#include "../math/polygon/CUSimpleTriangulator.h"
+#include "../math/polygon/CUComplexTriangulator.h"
 
 namespace cugl {
     
@@ -77,13 +77,7 @@ namespace cugl {
  * use the top right.
  */
 class PolygonNode : public TexturedNode {
-#pragma mark Values
-protected:
-    /** A triangulator for those incomplete polygons */
-    static SimpleTriangulator _triangulator;
-
 public:
-#pragma mark -
 #pragma mark Constructor
     /**
      * Creates an empty polygon with the degenerate texture.
@@ -95,7 +89,7 @@ public:
      */
     PolygonNode() : TexturedNode() {
         _classname = "PolygonNode";
-        _name = "PolygonNode";
+        setName("PolygonNode");
     }
 
     /**
@@ -119,7 +113,7 @@ public:
      * @return an empty polygon with the degenerate texture.
      */
     static std::shared_ptr<PolygonNode> alloc() {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->init() ? node : nullptr);
     }
     
@@ -130,16 +124,16 @@ public:
      * will simply use the blank texture. Hence the polygon will have a solid
      * color.
      *
-     * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this allocator is
-     * not thread safe.
+     * The polygon will be triangulated using the rules of ComplexTriangulator.
+     * All PolygonNode objects share triangulations through ShapeCache, so this allocator is
+     * thread safe.
      *
      * @param vertices  The vertices to texture (expressed in image space)
      *
      * @return a solid polygon with the given vertices.
      */
     static std::shared_ptr<PolygonNode> alloc(const std::vector<Vec2>& vertices) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->init(vertices) ? node : nullptr);
     }
     
@@ -155,7 +149,7 @@ public:
      * @return a solid polygon given polygon shape.
      */
     static std::shared_ptr<PolygonNode> alloc(const Poly2& poly) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->init(poly) ? node : nullptr);
     }
     
@@ -174,7 +168,7 @@ public:
      * @return a solid polygon with the given rect.
      */
     static std::shared_ptr<PolygonNode> alloc(const Rect& rect) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->init(rect) ? node : nullptr);
     }
     
@@ -189,16 +183,16 @@ public:
      * @return  a textured polygon from the image filename.
      */
     static std::shared_ptr<PolygonNode> allocWithFile(const std::string& filename) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithFile(filename) ? node : nullptr);
     }
     
     /**
      * Returns a textured polygon from the image filename and the given vertices.
      *
-     * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this allocator is
-     * not thread safe.
+     * The polygon will be triangulated using the rules of ComplexTriangulator.
+     * All PolygonNode objects share triangulations through ShapeCache, so this allocator is
+     * thread safe.
      *
      * @param filename  A path to image file, e.g., "scene1/earthtile.png"
      * @param vertices  The vertices to texture (expressed in image space)
@@ -207,7 +201,7 @@ public:
      */
     static std::shared_ptr<PolygonNode> allocWithFile(const std::string& filename,
                                                       const std::vector<Vec2>& vertices) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithFile(filename,vertices) ? node : nullptr);
     }
     
@@ -220,7 +214,7 @@ public:
      * @return a textured polygon from the image filename and the given polygon.
      */
     static std::shared_ptr<PolygonNode> allocWithFile(const std::string& filename, const Poly2& poly) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithFile(filename,poly) ? node : nullptr);
     }
     
@@ -236,7 +230,7 @@ public:
      * @return a textured polygon from the image filename and the given rect.
      */
     static std::shared_ptr<PolygonNode> allocWithFile(const std::string& filename, const Rect& rect) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithFile(filename,rect) ? node : nullptr);
     }
     
@@ -251,16 +245,16 @@ public:
      * @return a textured polygon from a Texture object.
      */
     static std::shared_ptr<PolygonNode> allocWithTexture(const std::shared_ptr<Texture>& texture) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithTexture(texture) ? node : nullptr);
     }
     
     /**
      * Returns a textured polygon from a Texture object and the given vertices.
      *
-     * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this method is
-     * not thread safe.
+     * The polygon will be triangulated using the rules of ComplexTriangulator.
+     * All PolygonNode objects share triangulations through ShapeCache, so this method is
+     * thread safe.
      *
      * @param texture   A shared pointer to a Texture object.
      * @param vertices  The vertices to texture (expressed in image space)
@@ -269,7 +263,7 @@ public:
      */
     static std::shared_ptr<PolygonNode> allocWithTexture(const std::shared_ptr<Texture>& texture,
                                                          const std::vector<Vec2>& vertices) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithTexture(texture,vertices) ? node : nullptr);
     }
     /**
@@ -282,7 +276,7 @@ public:
      */
     static std::shared_ptr<PolygonNode> allocWithTexture(const std::shared_ptr<Texture>& texture,
                                                          const Poly2& poly) {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithTexture(texture,poly) ? node : nullptr);
     }
     
@@ -299,7 +293,7 @@ public:
      */
     static std::shared_ptr<PolygonNode> allocWithTexture(const std::shared_ptr<Texture>& texture,
                                                          const Rect& rect)  {
-        std::shared_ptr<PolygonNode> node = std::make_shared<PolygonNode>();
+        std::shared_ptr<PolygonNode> node = NodeArena::make<PolygonNode>();
         return (node->initWithTexture(texture,rect) ? node : nullptr);
     }
 
@@ -308,9 +302,9 @@ public:
     /**
      * Sets the polgon to the vertices expressed in texture space.
      *
-     * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this method is
-     * not thread safe.
+     * The polygon will be triangulated using the rules of ComplexTriangulator.
+     * All PolygonNode objects share triangulations through ShapeCache, so this method is
+     * thread safe.
      *
      * @param vertices  The vertices to texture
      */
@@ -356,6 +350,9 @@ public:
      * correct.  In addition, this method does not need to check for visibility,
      * as it is guaranteed to only be called when the node is visible.
      *
+     * If the polygon is a rectangle, it is drawn with {@link SpriteBatch#fillQuad},
+     * which sends it to the GPU as a single instanced quad.
+     *
      * @param batch     The SpriteBatch to draw with.
      * @param transform The global transformation matrix.
      * @param tint      The tint to blend with the Node color.
@@ -254,7 +254,7 @@ public:
      * @return a newly allocated texture-less progress bar of the given size.
      */
     static std::shared_ptr<ProgressBar> alloc(const Size& size) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->init(size) ? node : nullptr);
     }
 
@@ -271,7 +271,7 @@ public:
      * @return a newly allocated progress bar with the given texture.
      */
     static std::shared_ptr<ProgressBar> alloc(const std::shared_ptr<Texture>& background) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->init(background) ? node : nullptr);
     }
 
@@ -289,7 +289,7 @@ public:
      * @return a newly allocated progress bar with the given texture and size
      */
     static std::shared_ptr<ProgressBar> alloc(const std::shared_ptr<Texture>& background, const Size& size) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->init(background,size) ? node : nullptr);
     }
 
@@ -307,7 +307,7 @@ public:
      */
     static std::shared_ptr<ProgressBar> alloc(const std::shared_ptr<Texture>& background,
                                               const std::shared_ptr<Texture>& foreground) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->init(background,foreground) ? node : nullptr);
     }
     
@@ -327,7 +327,7 @@ public:
     static std::shared_ptr<ProgressBar> alloc(const std::shared_ptr<Texture>& background,
                                               const std::shared_ptr<Texture>& foreground,
                                               const Size& size) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->init(background,foreground,size) ? node : nullptr);
     }
 
@@ -349,7 +349,7 @@ public:
                                                       const std::shared_ptr<Texture>& foreground,
                                                       const std::shared_ptr<Texture>& beginCap,
                                                       const std::shared_ptr<Texture>& finalCap) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->initWithCaps(background,foreground,beginCap,finalCap) ? node : nullptr);
     }
     
@@ -373,7 +373,7 @@ public:
                                                       const std::shared_ptr<Texture>& beginCap,
                                                       const std::shared_ptr<Texture>& finalCap,
                                                       const Size& size) {
-        std::shared_ptr<ProgressBar> node = std::make_shared<ProgressBar>();
+        std::shared_ptr<ProgressBar> node = NodeArena::make<ProgressBar>();
         return (node->initWithCaps(background,foreground,beginCap,finalCap,size) ? node : nullptr);
     }
     
@@ -45,8 +45,12 @@
 #include "../math/cu_math.h"
 #include "CUNode.h"
 #include "../renderer/CUOrthographicCamera.h"
+#include <vector>
 
 namespace cugl {
+
+// Forward declarations
+class ThreadPool;
     
 /**
  * This class provides the root node of a scene graph.
@@ -70,6 +74,8 @@ protected:
     std::shared_ptr<OrthographicCamera> _camera;
     /** The array of internal nodes */
     std::vector<std::shared_ptr<Node>> _children;
+    /** The arena for the nodes of this scene */
+    std::shared_ptr<NodeArena> _arena;
     /** The default tint for this scene */
     Color4 _color;
     /** Indicates whether the z-order is currently violated */
@@ -84,6 +90,40 @@ protected:
     /** The destination factor for the blend function */
     GLenum _dstFactor;
 
+    /** Whether to skip nodes that are off screen or transparent */
+    bool _culling;
+    /** The number of nodes drawn in the last render */
+    unsigned int _nodesDrawn;
+    /** The number of nodes skipped in the last render */
+    unsigned int _nodesCulled;
+    /** The number of vertices drawn in the last render */
+    unsigned int _vertsDrawn;
+    /** The number of vertices skipped in the last render */
+    unsigned int _vertsCulled;
+
+    /** A subtree (or a single node) drawn into its own deferred batch */
+    struct RenderJob {
+        /** The node to draw */
+        Node* node;
+        /** The parent transform (or the node transform if not a subtree) */
+        Mat4 transform;
+        /** The parent tint (or the node tint if not a subtree) */
+        Color4 tint;
+        /** Whether to draw the children of the node as well */
+        bool subtree;
+        /** The render statistics for this job */
+        Node::RenderStats stats;
+    };
+
+    /** The number of threads drawing this scene, including the calling thread */
+    int _threads;
+    /** The render threads (one less than the thread count) */
+    std::shared_ptr<ThreadPool> _pool;
+    /** The render jobs of the last render, in draw order */
+    std::vector<RenderJob> _jobs;
+    /** The deferred batches, one for each render job */
+    std::vector<std::shared_ptr<SpriteBatch>> _recorders;
+
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -100,7 +140,7 @@ public:
     /**
      * Deletes this scene, disposing all resources
      */
-    ~Scene() { _camera = nullptr; _children.clear(); }
+    ~Scene() { _camera = nullptr; _children.clear(); _arena = nullptr; }
     
     /**
      * Disposes all of the resources used by this scene.
@@ -319,6 +359,18 @@ public:
      * @parm color  The tint color for this scene.
      */
     void setColor(Color4 color) { _color = color; }
+
+    /**
+     * Returns the node arena for this scene.
+     *
+     * Nodes are only allocated in this arena while a {@link NodeArena::Scope}
+     * for it is active.  Building the scene graph inside of such a scope
+     * keeps its nodes together in memory, and takes them off of the heap.
+     * The nodes do not have to be added to this scene.
+     *
+     * @return the node arena for this scene.
+     */
+    const std::shared_ptr<NodeArena>& getArena() const { return _arena; }
     
     /**
      * Returns a string representation of this scene for debugging purposes.
@@ -867,10 +919,112 @@ public:
      * That means that parents are always draw before (and behind children). The
      * children of each sub tree are ordered by z-value (or by the order added).
      *
+     * If culling is enabled, any subtree that lies outside of the camera
+     * viewport is skipped, as is any node whose absolute tint is fully
+     * transparent.  The subtree bounds are cached, and only recomputed
+     * for the parts of the scene graph that have changed.
+     *
      * @param batch     The SpriteBatch to draw with.
      */
     void render(const std::shared_ptr<SpriteBatch>& batch);
-    
+
+    /**
+     * Returns true if this scene skips nodes that cannot be seen.
+     *
+     * A node cannot be seen if its subtree lies outside of the camera
+     * viewport, or if its absolute tint is fully transparent.  Culling
+     * relies on {@link Node#getDrawBounds()}, and so custom nodes that
+     * draw outside of their content size must override that method.
+     * Culling is enabled by default.
+     *
+     * @return true if this scene skips nodes that cannot be seen.
+     */
+    bool isCulling() const { return _culling; }
+
+    /**
+     * Sets whether this scene skips nodes that cannot be seen.
+     *
+     * A node cannot be seen if its subtree lies outside of the camera
+     * viewport, or if its absolute tint is fully transparent.  Culling
+     * relies on {@link Node#getDrawBounds()}, and so custom nodes that
+     * draw outside of their content size must override that method.
+     * Culling is enabled by default.
+     *
+     * @param value Whether this scene skips nodes that cannot be seen.
+     */
+    void setCulling(bool value) { _culling = value; }
+
+    /**
+     * Returns the number of nodes drawn in the latest render.
+     *
+     * This value is only computed when culling is enabled.
+     *
+     * @return the number of nodes drawn in the latest render.
+     */
+    unsigned int getNodesDrawn() const { return _nodesDrawn; }
+
+    /**
+     * Returns the number of nodes skipped in the latest render.
+     *
+     * This value is only computed when culling is enabled.
+     *
+     * @return the number of nodes skipped in the latest render.
+     */
+    unsigned int getNodesCulled() const { return _nodesCulled; }
+
+    /**
+     * Returns the number of vertices drawn in the latest render.
+     *
+     * This value is only computed when culling is enabled.  Vertices are
+     * counted as reported by {@link Node#getDrawCount()}.
+     *
+     * @return the number of vertices drawn in the latest render.
+     */
+    unsigned int getVerticesDrawn() const { return _vertsDrawn; }
+
+    /**
+     * Returns the number of vertices skipped in the latest render.
+     *
+     * This value is only computed when culling is enabled.  Vertices are
+     * counted as reported by {@link Node#getDrawCount()}.
+     *
+     * @return the number of vertices skipped in the latest render.
+     */
+    unsigned int getVerticesCulled() const { return _vertsCulled; }
+
+    /**
+     * Returns the number of threads used to draw this scene.
+     *
+     * If this value is 1 (the default), the scene graph is drawn serially.
+     * Otherwise, the scene graph is split into subtrees that are drawn in
+     * parallel on this many threads, including the thread calling
+     * {@link render}.
+     *
+     * @return the number of threads used to draw this scene.
+     */
+    int getRenderThreads() const { return _threads; }
+
+    /**
+     * Sets the number of threads used to draw this scene.
+     *
+     * If this value is 1 (the default), the scene graph is drawn serially.
+     * Otherwise, the scene graph is split into subtrees that are drawn in
+     * parallel on this many threads, including the thread calling
+     * {@link render}. The extra threads belong to this scene.
+     *
+     * Each subtree is drawn into its own deferred {@link SpriteBatch}.
+     * These batches are then replayed into the render batch in scene graph
+     * order, so the result is exactly the same as a serial render. Nodes
+     * that are not {@link Node#isConcurrent()}, and nodes with a render
+     * cache, are drawn on the calling thread during the replay.
+     *
+     * While a parallel render is in progress, draw() methods must not
+     * modify the scene graph.
+     *
+     * @param threads   The number of threads used to draw this scene.
+     */
+    void setRenderThreads(int threads);
+
 private:
 #pragma mark -
 #pragma mark Internal Helpers
@@ -892,6 +1046,41 @@ private:
      * @param value Whether the children of this node needs resorting.
      */
     void setZDirty(bool value) { _zDirty = value; }
+
+    /**
+     * Splits the scene graph into render jobs for the render threads.
+     *
+     * The largest subtrees are split into their root node and their children
+     * until there are enough jobs to keep every thread busy. When culling,
+     * the subtrees that cannot be seen are skipped here, and added to the
+     * given statistics.
+     *
+     * @param view      The visible region in world coordinates.
+     * @param stats     The render statistics to update.
+     */
+    void planRender(const Rect& view, Node::RenderStats& stats);
+
+    /**
+     * Draws the given render job into its deferred batch.
+     *
+     * This method is safe to call on any render thread.
+     *
+     * @param index     The render job index.
+     * @param view      The visible region in world coordinates.
+     */
+    void recordJob(size_t index, const Rect& view);
+
+    /**
+     * Draws the scene graph in parallel with the given SpriteBatch.
+     *
+     * The batch must be actively drawing.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param view      The visible region in world coordinates.
+     * @param stats     The render statistics to update.
+     */
+    void renderParallel(const std::shared_ptr<SpriteBatch>& batch, const Rect& view,
+                        Node::RenderStats& stats);
     
     // Tightly couple with Node
     friend class Node;
@@ -0,0 +1,256 @@
+//
+//  CUSpriteAnimator.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a component that plays animation clips on animation
+//  nodes.  Every node that is playing a clip has a track in the animator, and
+//  a single call to update advances all of the tracks at once.  Changing the
+//  frame of a node only swaps the texture rectangle that it draws, so the
+//  cost of animation is a few arithmetic operations per sprite.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_SPRITE_ANIMATOR_H__
+#define __CU_SPRITE_ANIMATOR_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/2d/CUAnimationClip.h>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+
+namespace cugl {
+
+/** Forward references */
+class AnimationNode;
+
+/**
+ * This class plays animation clips on animation nodes.
+ *
+ * Each node playing a clip has a track, which records the current frame of
+ * the clip, the time spent on that frame, and the playback speed.  The
+ * tracks are stored contiguously and all advanced by a single call to
+ * {@link update}.  When a track changes frame, the node is updated with
+ * {@link AnimationNode#setFrameRect}, which does not rebuild the polygon.
+ *
+ * A node has at most one track, so playing a new clip on a node replaces
+ * the old one.  A clip that plays ONCE keeps its track when it finishes
+ * (showing the last frame), so that {@link isComplete} can be queried.
+ * The animator holds a reference to each node until its track is removed
+ * with {@link stop} or {@link clear}.
+ *
+ * The animator also measures itself.  The time spent in the last call to
+ * update, and the number of frame changes that it made, are available for
+ * profiling.
+ */
+class SpriteAnimator {
+private:
+    /** This macro disables the copy constructor (not allowed on animators) */
+    CU_DISALLOW_COPY_AND_ASSIGN(SpriteAnimator);
+
+    /** The playback state of a single node */
+    class Track {
+    public:
+        /** The animated node */
+        std::shared_ptr<AnimationNode> node;
+        /** The clip being played */
+        std::shared_ptr<AnimationClip> clip;
+        /** The current frame of the clip */
+        unsigned int frame;
+        /** The time spent on the current frame */
+        float elapsed;
+        /** The playback speed (1 is normal speed) */
+        float speed;
+        /** The direction of play (-1 when a PINGPONG clip is reversing) */
+        int step;
+        /** Whether a clip that plays ONCE has finished */
+        bool done;
+    };
+
+    /** The active tracks */
+    std::vector<Track> _tracks;
+    /** The position of the track for each node */
+    std::unordered_map<AnimationNode*, size_t> _index;
+    /** The time spent in the last update in microseconds */
+    Uint64 _updateTime;
+    /** The number of frame changes in the last update */
+    unsigned int _changes;
+    /** Whether this animator has been initialized */
+    bool _initialized;
+
+    /**
+     * Moves the track to the next frame of its clip.
+     *
+     * @param track The track to advance
+     *
+     * @return true if the frame changed.
+     */
+    static bool advance(Track& track);
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized animator.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    SpriteAnimator();
+
+    /**
+     * Deletes this animator, releasing all tracks.
+     */
+    ~SpriteAnimator() { dispose(); }
+
+    /**
+     * Releases all tracks of this animator.
+     *
+     * A disposed animator can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes an animator with no tracks.
+     *
+     * @param capacity  The expected number of animated nodes
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(size_t capacity=16);
+
+    /**
+     * Returns a newly allocated animator with no tracks.
+     *
+     * @param capacity  The expected number of animated nodes
+     *
+     * @return a newly allocated animator with no tracks.
+     */
+    static std::shared_ptr<SpriteAnimator> alloc(size_t capacity=16) {
+        std::shared_ptr<SpriteAnimator> result = std::make_shared<SpriteAnimator>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Playback
+    /**
+     * Plays the given clip on the given node from its first frame.
+     *
+     * If the node is already playing a clip, that clip is replaced.  The
+     * first frame is shown immediately.
+     *
+     * @param node  The node to animate
+     * @param clip  The clip to play
+     * @param speed The playback speed (1 is normal speed)
+     */
+    void play(const std::shared_ptr<AnimationNode>& node,
+              const std::shared_ptr<AnimationClip>& clip, float speed=1.0f);
+
+    /**
+     * Stops the animation of the given node, removing its track.
+     *
+     * The node keeps its current frame.
+     *
+     * @param node  The node to stop
+     */
+    void stop(const std::shared_ptr<AnimationNode>& node);
+
+    /**
+     * Removes every track from this animator.
+     */
+    void clear();
+
+    /**
+     * Advances every track by the given amount of time.
+     *
+     * @param dt    The elapsed time in seconds
+     */
+    void update(float dt);
+
+#pragma mark -
+#pragma mark Track Queries
+    /**
+     * Returns the clip played by the given node (nullptr if none).
+     *
+     * @param node  The animated node
+     *
+     * @return the clip played by the given node (nullptr if none).
+     */
+    std::shared_ptr<AnimationClip> getClip(const std::shared_ptr<AnimationNode>& node) const;
+
+    /**
+     * Returns the current frame of the clip played by the given node.
+     *
+     * This is the index in the clip, not in the filmstrip.  It is -1 if the
+     * node has no track.
+     *
+     * @param node  The animated node
+     *
+     * @return the current frame of the clip played by the given node.
+     */
+    int getFrame(const std::shared_ptr<AnimationNode>& node) const;
+
+    /**
+     * Returns true if the given node has finished a clip that plays ONCE.
+     *
+     * @param node  The animated node
+     *
+     * @return true if the given node has finished a clip that plays ONCE.
+     */
+    bool isComplete(const std::shared_ptr<AnimationNode>& node) const;
+
+    /**
+     * Returns the number of tracks in this animator.
+     *
+     * @return the number of tracks in this animator.
+     */
+    size_t getTrackCount() const { return _tracks.size(); }
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the time spent in the last call to update in microseconds.
+     *
+     * @return the time spent in the last call to update in microseconds.
+     */
+    Uint64 getUpdateTime() const { return _updateTime; }
+
+    /**
+     * Returns the number of frame changes made by the last call to update.
+     *
+     * @return the number of frame changes made by the last call to update.
+     */
+    unsigned int getFrameChanges() const { return _changes; }
+};
+
+}
+#endif /* __CU_SPRITE_ANIMATOR_H__ */
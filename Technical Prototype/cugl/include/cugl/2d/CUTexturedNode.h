@@ -99,6 +99,10 @@ protected:
     bool _rendered;
     /** The render data for this node */
     std::vector<Vertex2> _vertices;
+    /** Whether the render data is a rectangle (which may be drawn as a quad) */
+    bool _quad;
+    /** The render vertices at the bottom left and top right of the rectangle */
+    unsigned int _quadCorners[2];
     
     /** The blending equation for this texture */
     GLenum _blendEquation;
@@ -565,6 +569,7 @@ public:
     void setAbsolute(bool flag) {
         _absolute = flag;
         _anchor = Vec2::ANCHOR_BOTTOM_LEFT;
+        invalidateBounds();
     }
     
     /**
@@ -622,6 +627,31 @@ public:
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
                       const Mat4& transform, Color4 tint) override = 0;
+
+    /**
+     * Returns the bounds of everything drawn by draw(), in node space.
+     *
+     * This is the bounding box of the polygon.  Unless the node uses
+     * absolute positioning, the polygon is drawn with its bounding box
+     * at the origin.
+     *
+     * @return the bounds of everything drawn by draw(), in node space.
+     */
+    virtual Rect getDrawBounds() const override {
+        const Rect& bounds = _polygon.getBounds();
+        return (_absolute ? bounds : Rect(Vec2::ZERO, bounds.size));
+    }
+
+    /**
+     * Returns the number of vertices sent to the SpriteBatch by draw().
+     *
+     * This is the number of indices in the polygon.
+     *
+     * @return the number of vertices sent to the SpriteBatch by draw().
+     */
+    virtual unsigned int getDrawCount() const override {
+        return (unsigned int)_polygon.getIndices().size();
+    }
     
     void refresh() { clearRenderData(); generateRenderData(); }
     
@@ -107,9 +107,6 @@ namespace cugl {
 class WireNode : public TexturedNode {
 #pragma mark Values
 protected:
-    /** An outliner for those incomplete polygons */
-    static PathOutliner _outliner;
-    
     /** The current (known) traversal of this wireframe */
     PathTraversal _traversal;
 
@@ -126,7 +123,7 @@ public:
      */
     WireNode() : TexturedNode(), _traversal(PathTraversal::CLOSED) {
         _classname = "WireNode";
-        _name = "WireNode";
+        setName("WireNode");
     }
     
     /**
@@ -146,8 +143,8 @@ public:
      * color.
      *
      * The polygon will be outlined using the given traversal in PathOutliner.
-     * WireNode objects share a single path outliner, so this initializer is
-     * not thread safe.
+     * WireNode objects share outlines through ShapeCache, so this initializer is
+     * thread safe.
      *
      * @param vertices  The vertices to texture (expressed in image space)
      * @param traversal The path traversal for index generation
@@ -189,7 +186,7 @@ public:
      * @return an empty wireframe node.
      */
     static std::shared_ptr<WireNode> alloc() {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->init() ? node : nullptr);
     }
     
@@ -198,15 +195,15 @@ public:
      *
      * The polygon will be outlined using a CLOSED traversal in PathOutliner.
      * To create a different traversal, use the alternate allocWithVertices()
-     * constructor. All WireNode objects share a single path outliner, so this
-     * method is not thread safe.
+     * constructor. All WireNode objects share outlines through ShapeCache, so this
+     * method is thread safe.
      *
      * @param vertices  The vertices forming the wireframe path
      *
      * @return a (closed) wireframe with the given vertices.
      */
     static std::shared_ptr<WireNode> allocWithVertices(const std::vector<Vec2>& vertices) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->init(vertices) ? node : nullptr);
     }
     
@@ -214,8 +211,8 @@ public:
      * Returns a (closed) wireframe with the given vertices.
      *
      * The polygon will be outlined using the given traversal in PathOutliner.
-     * WireNode objects share a single path outliner, so this constructor is
-     * not thread safe.
+     * WireNode objects share outlines through ShapeCache, so this constructor is
+     * thread safe.
      *
      * @param vertices  The vertices forming the wireframe path
      * @param traversal The path traversal for index generation
@@ -224,7 +221,7 @@ public:
      */
     static std::shared_ptr<WireNode> allocWithVertices(const std::vector<Vec2>& vertices,
                                                        PathTraversal traversal) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->initWithVertices(vertices,traversal) ? node : nullptr);
     }
     
@@ -240,7 +237,7 @@ public:
      * @return a wireframe with the given polygon.
      */
     static std::shared_ptr<WireNode> allocWithPoly(const Poly2& poly) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->init(poly) ? node : nullptr);
     }
     
@@ -254,7 +251,7 @@ public:
      * @return  An autoreleased wireframe node
      */
     static std::shared_ptr<WireNode> allocWithRect(const Rect& rect) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->init(rect) ? node : nullptr);
     }
     
@@ -267,7 +264,7 @@ public:
      * @return  An autoreleased wireframe node
      */
     static std::shared_ptr<WireNode> allocWithLine(const Vec2 &origin, const Vec2 &dest) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->initWithLine(origin,dest) ? node : nullptr);
     }
     
@@ -284,7 +281,7 @@ public:
      */
     static std::shared_ptr<WireNode> allocWithEllipse(const Vec2& center, const Size& size,
                                                       unsigned int segments = WIRE_SEGMENTS) {
-        std::shared_ptr<WireNode> node = std::make_shared<WireNode>();
+        std::shared_ptr<WireNode> node = NodeArena::make<WireNode>();
         return (node->initWithEllipse(center,size,segments) ? node : nullptr);
     }
     
@@ -295,7 +292,7 @@ public:
      *
      * If the traversal is different from the current known traversal, it will
      * recompute the traveral using the PathOutliner. All WireNode objects share 
-     * a single path outliner, so this method is not thread safe.
+     * outlines through ShapeCache, so this method is thread safe.
      *
      * @param traversal The new wireframe traversal
      */
@@ -316,7 +313,7 @@ public:
      *
      * The polygon will be outlined using a CLOSED traversal in PathOutliner.
      * To create a different traversal, use the alternate setPolygon()  method. 
-     * All WireNode objects share a single path outliner, so this method is not
+     * All WireNode objects share outlines through ShapeCache, so this method is
      * thread safe.
      *
      * @param vertices  The vertices to draw
@@ -327,7 +324,7 @@ public:
      * Sets the wireframe polgon to the vertices expressed in texture space.
      *
      * The polygon will be outlined using the given traversal in PathOutliner.
-     * All WireNode objects share a single path outliner, so this method is not
+     * All WireNode objects share outlines through ShapeCache, so this method is
      * thread safe.
      *
      * @param vertices  The vertices to draw
@@ -29,12 +29,15 @@
 #define __CU_2D_PKG_H__
 
 #include "CUFont.h"
+#include "CUNodeArena.h"
 #include "CUNode.h"
 #include "CUScene.h"
 #include "CUTexturedNode.h"
 #include "CUPolygonNode.h"
 #include "CUWireNode.h"
 #include "CUAnimationNode.h"
+#include "CUAnimationClip.h"
+#include "CUSpriteAnimator.h"
 #include "CULabel.h"
 #include "CUButton.h"
 #include "CUProgressBar.h"
@@ -0,0 +1,380 @@
+//
+//  CUObstacleDebugDraw.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a debug renderer for an ObstacleWorld.  It implements
+//  the Box2D b2Draw interface, and streams the shapes, joints, bounding boxes
+//  and contacts of the world directly into a SpriteBatch.  All the filled
+//  shapes share one triangle pass and all the outlines share one line pass,
+//  so a typical world is drawn in two draw calls.  Unlike the wireframes of
+//  the individual obstacles, it does not add any nodes to the scene graph.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_OBSTACLE_DEBUG_DRAW_H__
+#define __CU_OBSTACLE_DEBUG_DRAW_H__
+
+#include <Box2D/Common/b2Draw.h>
+#include <cugl/base/CUBase.h>
+#include <cugl/math/cu_math.h>
+#include <cugl/renderer/CUVertex.h>
+#include <vector>
+#include <memory>
+
+class b2World;
+
+/** The default number of vertices streamed in a single pass */
+#define DEBUG_DRAW_CAPACITY     4096
+/** The number of segments used to approximate a circle */
+#define DEBUG_CIRCLE_SEGMENTS   16
+/** The default size of a contact point (in physics units) */
+#define DEBUG_POINT_SIZE        0.1f
+/** The default length of a transform axis (in physics units) */
+#define DEBUG_AXIS_LENGTH       0.4f
+
+namespace cugl {
+
+// Forward reference to the SpriteBatch
+class SpriteBatch;
+
+#pragma mark -
+#pragma mark Obstacle Debug Draw
+/**
+ * This class is a batched debug renderer for the Box2D world of an obstacle.
+ *
+ * The renderer implements the Box2D b2Draw interface.  When {@link draw} is
+ * called, it asks the world to draw itself, collecting the filled shapes and
+ * outlines in two vertex buffers.  These are then submitted to a
+ * {@link SpriteBatch} as one triangle pass and one line pass.  If a buffer
+ * fills up before the world is finished, it is submitted early, so the
+ * memory used by the renderer is bounded.
+ *
+ * What is drawn is controlled by a bitmask of flags.  In addition to the
+ * flags supported by Box2D, this class can also draw the points (and normals)
+ * of all touching contacts.
+ *
+ * The renderer does no work unless {@link draw} is called.  You will
+ * generally not use this class directly, but enable it in the
+ * {@link ObstacleWorld} with {@link ObstacleWorld#setDebug}.
+ */
+class ObstacleDebugDraw : public b2Draw {
+public:
+    /**
+     * This enum lists the elements that can be drawn.
+     *
+     * These values are a bitmask, and should be combined with bitwise or.
+     */
+    enum Flags : Uint32 {
+        /** Draw the fixture shapes */
+        SHAPES   = e_shapeBit,
+        /** Draw the joint connections */
+        JOINTS   = e_jointBit,
+        /** Draw the fixture bounding boxes */
+        AABBS    = e_aabbBit,
+        /** Draw the broad-phase pairs */
+        PAIRS    = e_pairBit,
+        /** Draw the center of mass of each body */
+        CENTERS  = e_centerOfMassBit,
+        /** Draw the points and normals of all touching contacts */
+        CONTACTS = 0x0100
+    };
+
+protected:
+    /** The number of vertices in a single pass */
+    unsigned int _capacity;
+    /** The vertices of the filled shapes */
+    std::vector<Vertex2> _fillVerts;
+    /** The triangle indices of the filled shapes */
+    std::vector<unsigned short> _fillIndx;
+    /** The vertices of the outlines */
+    std::vector<Vertex2> _lineVerts;
+    /** The line indices of the outlines */
+    std::vector<unsigned short> _lineIndx;
+
+    /** The sprite batch for the current pass (nullptr outside of draw) */
+    SpriteBatch* _batch;
+    /** The transform from physics coordinates for the current pass */
+    Mat4 _transform;
+
+    /** The color of the contact points */
+    Color4 _contactColor;
+    /** The size of a contact point (in physics units) */
+    float _pointSize;
+    /** The length of a transform axis (in physics units) */
+    float _axisLength;
+
+    /** This macro disables the copy constructor (not allowed on renderers) */
+    CU_DISALLOW_COPY_AND_ASSIGN(ObstacleDebugDraw);
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Appends a polygon outline to the line buffer.
+     *
+     * @param vertices  The polygon vertices
+     * @param count     The number of vertices
+     * @param color     The outline color
+     */
+    void addOutline(const b2Vec2* vertices, int count, Color4 color);
+
+    /**
+     * Appends a convex polygon to the fill buffer.
+     *
+     * @param vertices  The polygon vertices (in order)
+     * @param count     The number of vertices
+     * @param color     The fill color
+     */
+    void addFill(const b2Vec2* vertices, int count, Color4 color);
+
+    /**
+     * Appends a single line segment to the line buffer.
+     *
+     * @param p1        The start of the segment
+     * @param p2        The end of the segment
+     * @param color     The line color
+     */
+    void addSegment(const b2Vec2& p1, const b2Vec2& p2, Color4 color);
+
+    /**
+     * Approximates a circle with a polygon.
+     *
+     * @param center    The circle center
+     * @param radius    The circle radius
+     * @param vertices  The array to store the polygon (of DEBUG_CIRCLE_SEGMENTS)
+     */
+    void makeCircle(const b2Vec2& center, float radius, b2Vec2* vertices) const;
+
+    /**
+     * Draws the touching contacts of the given world.
+     *
+     * @param world     The Box2D world
+     */
+    void drawContacts(b2World* world);
+
+    /**
+     * Submits the fill buffer to the sprite batch and clears it.
+     */
+    void flushFills();
+
+    /**
+     * Submits the line buffer to the sprite batch and clears it.
+     */
+    void flushLines();
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized debug renderer.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    ObstacleDebugDraw();
+
+    /**
+     * Deletes this debug renderer, disposing all resources.
+     */
+    ~ObstacleDebugDraw() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this debug renderer.
+     *
+     * A disposed renderer can be safely reinitialized.
+     */
+    void dispose();
+
+    /**
+     * Initializes a debug renderer that draws the shapes of the world.
+     *
+     * The capacity is the number of vertices submitted to the sprite batch at
+     * a time.  It should not exceed the capacity of the sprite batch.
+     *
+     * @param capacity  The number of vertices in a single pass
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(unsigned int capacity=DEBUG_DRAW_CAPACITY);
+
+    /**
+     * Returns a newly allocated debug renderer that draws the shapes of the world.
+     *
+     * The capacity is the number of vertices submitted to the sprite batch at
+     * a time.  It should not exceed the capacity of the sprite batch.
+     *
+     * @param capacity  The number of vertices in a single pass
+     *
+     * @return a newly allocated debug renderer that draws the shapes of the world.
+     */
+    static std::shared_ptr<ObstacleDebugDraw> alloc(unsigned int capacity=DEBUG_DRAW_CAPACITY) {
+        std::shared_ptr<ObstacleDebugDraw> result = std::make_shared<ObstacleDebugDraw>();
+        return (result->init(capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the bitmask of elements to draw.
+     *
+     * @return the bitmask of elements to draw.
+     */
+    Uint32 getFlags() const { return GetFlags(); }
+
+    /**
+     * Sets the bitmask of elements to draw.
+     *
+     * The value should be a combination of the values in {@link Flags}.
+     *
+     * @param flags The bitmask of elements to draw.
+     */
+    void setFlags(Uint32 flags) { SetFlags(flags); }
+
+    /**
+     * Returns the color of the contact points.
+     *
+     * @return the color of the contact points.
+     */
+    Color4 getContactColor() const { return _contactColor; }
+
+    /**
+     * Sets the color of the contact points.
+     *
+     * @param color The color of the contact points.
+     */
+    void setContactColor(Color4 color) { _contactColor = color; }
+
+    /**
+     * Returns the size of a contact point (in physics units).
+     *
+     * @return the size of a contact point (in physics units).
+     */
+    float getPointSize() const { return _pointSize; }
+
+    /**
+     * Sets the size of a contact point (in physics units).
+     *
+     * @param size  The size of a contact point (in physics units).
+     */
+    void setPointSize(float size) { _pointSize = size; }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws the given world with the sprite batch.
+     *
+     * The sprite batch must be active (e.g. between calls to begin and end).
+     * The transform converts from physics coordinates to the coordinates of
+     * the sprite batch perspective.  The active texture of the batch is
+     * replaced by the blank texture.
+     *
+     * @param world     The Box2D world to draw
+     * @param batch     The sprite batch to draw with
+     * @param transform The transform from physics coordinates
+     */
+    void draw(b2World* world, const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform);
+
+#pragma mark -
+#pragma mark Box2D Interface
+    /**
+     * Draws a closed polygon provided in CCW order.
+     *
+     * @param vertices      The polygon vertices
+     * @param vertexCount   The number of vertices
+     * @param color         The outline color
+     */
+    virtual void DrawPolygon(const b2Vec2* vertices, int32 vertexCount, const b2Color& color) override;
+
+    /**
+     * Draws a solid closed polygon provided in CCW order.
+     *
+     * The polygon is filled with a translucent version of the color.
+     *
+     * @param vertices      The polygon vertices
+     * @param vertexCount   The number of vertices
+     * @param color         The outline color
+     */
+    virtual void DrawSolidPolygon(const b2Vec2* vertices, int32 vertexCount, const b2Color& color) override;
+
+    /**
+     * Draws a circle.
+     *
+     * @param center    The circle center
+     * @param radius    The circle radius
+     * @param color     The outline color
+     */
+    virtual void DrawCircle(const b2Vec2& center, float32 radius, const b2Color& color) override;
+
+    /**
+     * Draws a solid circle.
+     *
+     * The circle is filled with a translucent version of the color, and the
+     * axis is drawn as a radius.
+     *
+     * @param center    The circle center
+     * @param radius    The circle radius
+     * @param axis      The circle orientation
+     * @param color     The outline color
+     */
+    virtual void DrawSolidCircle(const b2Vec2& center, float32 radius, const b2Vec2& axis, const b2Color& color) override;
+
+    /**
+     * Draws a line segment.
+     *
+     * @param p1        The start of the segment
+     * @param p2        The end of the segment
+     * @param color     The line color
+     */
+    virtual void DrawSegment(const b2Vec2& p1, const b2Vec2& p2, const b2Color& color) override;
+
+    /**
+     * Draws a transform as a pair of (red and green) axes.
+     *
+     * @param xf    The transform to draw
+     */
+    virtual void DrawTransform(const b2Transform& xf) override;
+
+    /**
+     * Draws a point as a small filled square.
+     *
+     * Box2D measures the point size in pixels.  This renderer ignores it, and
+     * uses {@link getPointSize} instead.
+     *
+     * @param p         The point to draw
+     * @param size      The point size (ignored)
+     * @param color     The point color
+     */
+    virtual void DrawPoint(const b2Vec2& p, float32 size, const b2Color& color) override;
+};
+
+}
+#endif /* __CU_OBSTACLE_DEBUG_DRAW_H__ */
@@ -46,14 +46,21 @@
 #define __CU_PHYSICS_WORLD_H__
 
 #include <vector>
+#include <functional>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/b2Body.h>
 #include <cugl/math/cu_math.h>
-class b2World;
 
 namespace cugl {
 
 // Forward declaration of the Obstacle class
 class Obstacle;
+// Forward declaration of the debug renderer
+class ObstacleDebugDraw;
+// Forward declaration of the SpriteBatch
+class SpriteBatch;
 
 /** Default amount of time for a physics engine step. */
 #define DEFAULT_WORLD_STEP  1/60.0f
@@ -63,6 +70,110 @@ class Obstacle;
 #define DEFAULT_WORLD_POSIT 2
 
 
+#pragma mark -
+#pragma mark Batched Queries
+/**
+ * A single ray in a batched ray cast.
+ *
+ * A ray only hits fixtures whose category bits overlap the mask.  Sensors
+ * are skipped unless requested.  By default a ray finds the closest fixture
+ * along it, but it may also stop at the first fixture found, which is
+ * cheaper when you only need to know if the path is blocked.
+ */
+struct RayQuery {
+    /** The ray starting point */
+    Vec2 start;
+    /** The ray ending point */
+    Vec2 end;
+    /** The fixture categories this ray can hit */
+    uint16 mask;
+    /** Whether this ray can hit sensors */
+    bool sensors;
+    /** Whether to stop at the first fixture found, rather than the closest */
+    bool any;
+
+    /**
+     * Creates a degenerate ray at the origin
+     */
+    RayQuery() : mask(0xFFFF), sensors(false), any(false) {}
+
+    /**
+     * Creates a ray from start to end
+     *
+     * @param start The ray starting point
+     * @param end   The ray ending point
+     * @param mask  The fixture categories this ray can hit
+     * @param any   Whether to stop at the first fixture found
+     */
+    RayQuery(const Vec2& start, const Vec2& end, uint16 mask = 0xFFFF, bool any = false) :
+        start(start), end(end), mask(mask), sensors(false), any(any) {}
+};
+
+/**
+ * The result of a single ray in a batched ray cast.
+ */
+struct RayHit {
+    /** The fixture hit by the ray, or nullptr if it hit nothing */
+    b2Fixture* fixture;
+    /** The point of intersection */
+    Vec2 point;
+    /** The normal vector at the point of intersection */
+    Vec2 normal;
+    /** The fraction of the ray at the point of intersection */
+    float fraction;
+};
+
+/**
+ * A single shape in a batched overlap query.
+ *
+ * The shape is not copied, and must stay alive until the query returns.
+ * As with rays, only fixtures whose category bits overlap the mask are
+ * tested, and sensors are skipped unless requested.
+ */
+struct ShapeQuery {
+    /** The shape to test, in the coordinates given by the transform */
+    const b2Shape* shape;
+    /** The transform placing the shape in the world */
+    b2Transform transform;
+    /** The fixture categories this shape can overlap */
+    uint16 mask;
+    /** Whether this shape can overlap sensors */
+    bool sensors;
+    /** Whether to stop at the first fixture found, rather than count them all */
+    bool any;
+
+    /**
+     * Creates a query with no shape
+     */
+    ShapeQuery() : shape(nullptr), mask(0xFFFF), sensors(false), any(false) {
+        transform.SetIdentity();
+    }
+
+    /**
+     * Creates a query for the given shape at the given position
+     *
+     * @param shape     The shape to test
+     * @param position  The position of the shape origin
+     * @param angle     The rotation of the shape in radians
+     * @param mask      The fixture categories this shape can overlap
+     */
+    ShapeQuery(const b2Shape* shape, const Vec2& position, float angle = 0, uint16 mask = 0xFFFF) :
+        shape(shape), mask(mask), sensors(false), any(false) {
+        transform.Set(b2Vec2(position.x,position.y), angle);
+    }
+};
+
+/**
+ * The result of a single shape in a batched overlap query.
+ */
+struct ShapeHit {
+    /** The first fixture found overlapping the shape, or nullptr if none */
+    b2Fixture* fixture;
+    /** The number of fixtures overlapping the shape */
+    unsigned int count;
+};
+
+
 #pragma mark -
 #pragma mark World Controller
 /**
@@ -91,6 +202,92 @@ protected:
     int _itposition;
     /** The current gravitational value of the world */
     Vec2 _gravity;
+    /** The number of threads used to solve the physics islands */
+    int _threads;
+    /** The executor solving the physics islands in parallel (nullptr if serial) */
+    b2IslandExecutor* _executor;
+
+    /**
+     * A Box2D ray cast callback for a single ray of a batch.
+     *
+     * The filter is a template so that it can be inlined.
+     */
+    template <typename Filter>
+    class BatchRayCallback : public b2RayCastCallback {
+    public:
+        /** The ray being cast */
+        const RayQuery* query;
+        /** The result of the ray */
+        RayHit* hit;
+        /** The index of the ray in the batch */
+        size_t index;
+        /** The additional filter for the fixtures */
+        Filter* filter;
+
+        /**
+         * Called for each fixture found by the ray.
+         *
+         * @return -1 to filter, 0 to terminate, fraction to clip the ray
+         */
+        float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point,
+                              const b2Vec2& normal, float32 fraction) override {
+            if ((fixture->GetFilterData().categoryBits & query->mask) == 0 ||
+                (fixture->IsSensor() && !query->sensors) || !(*filter)(fixture, index)) {
+                return -1;
+            }
+            hit->fixture = fixture;
+            hit->point.set(point.x,point.y);
+            hit->normal.set(normal.x,normal.y);
+            hit->fraction = fraction;
+            return query->any ? 0 : fraction;
+        }
+    };
+
+    /**
+     * A Box2D query callback for a single shape of a batch.
+     *
+     * The filter is a template so that it can be inlined.
+     */
+    template <typename Filter>
+    class BatchShapeCallback : public b2QueryCallback {
+    public:
+        /** The shape being tested */
+        const ShapeQuery* query;
+        /** The result of the shape */
+        ShapeHit* hit;
+        /** The index of the shape in the batch */
+        size_t index;
+        /** The additional filter for the fixtures */
+        Filter* filter;
+
+        /**
+         * Called for each fixture whose bounding box overlaps the shape.
+         *
+         * @return false to terminate the query
+         */
+        bool ReportFixture(b2Fixture* fixture) override {
+            if ((fixture->GetFilterData().categoryBits & query->mask) == 0 ||
+                (fixture->IsSensor() && !query->sensors)) {
+                return true;
+            }
+            const b2Shape* shape = fixture->GetShape();
+            const b2Transform& xf = fixture->GetBody()->GetTransform();
+            bool overlap = false;
+            for(int32 ii = 0; !overlap && ii < shape->GetChildCount(); ii++) {
+                for(int32 jj = 0; !overlap && jj < query->shape->GetChildCount(); jj++) {
+                    overlap = b2TestOverlap(query->shape, jj, shape, ii, query->transform, xf);
+                }
+            }
+            if (!overlap || !(*filter)(fixture, index)) {
+                return true;
+            }
+            if (hit->count == 0) {
+                hit->fixture = fixture;
+            }
+            hit->count++;
+            return !query->any;
+        }
+    };
     
     
     /** The list of objects in this world */
@@ -106,6 +303,11 @@ protected:
     /** Whether or not to activate the destruction listener */
     bool _destroy;
     
+    /** Whether or not to draw the debug view */
+    bool _debug;
+    /** The debug renderer (allocated the first time debugging is enabled) */
+    std::shared_ptr<ObstacleDebugDraw> _debugDraw;
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -288,6 +490,41 @@ public:
      * @param  position number of position iterations for the constrain solvers
      */
     void setPositionIterations(int position) { _itposition = position; }
+
+    /**
+     * Returns the number of threads used to solve the physics islands.
+     *
+     * An island is a group of bodies connected by contacts or joints. If this
+     * value is 1 (the default), the islands are solved serially. Otherwise,
+     * they are solved in parallel on this many threads, including the thread
+     * calling {@link update}.
+     *
+     * @return the number of threads used to solve the physics islands.
+     */
+    int getSolverThreads() const { return _threads; }
+
+    /**
+     * Sets the number of threads used to solve the physics islands.
+     *
+     * An island is a group of bodies connected by contacts or joints. If this
+     * value is 1 (the default), the islands are solved serially. Otherwise,
+     * they are solved in parallel on this many threads, including the thread
+     * calling {@link update}. The extra threads belong to this world.
+     *
+     * Parallel solving gives exactly the same results as serial solving. The
+     * {@link afterSolve} callbacks are still called on the thread calling
+     * {@link update}, in the same order. However, they are all called after
+     * every island is solved, rather than after each island.
+     *
+     * Parallel solving only helps worlds with many independent islands. A
+     * world with a single large island is no faster.
+     *
+     * These threads also run large batches of {@link rayCast} and
+     * {@link queryShapes} queries.
+     *
+     * @param  threads  the number of threads used to solve the physics islands.
+     */
+    void setSolverThreads(int threads);
     
     /**
      * Returns the global gravity vector.
@@ -480,6 +717,10 @@ public:
      * provided explicitly in a separate data structure.
      * Note: this is only called for contacts that are touching, solid, and awake.
      *
+     * If the world solves islands in parallel (see {@link setSolverThreads}),
+     * this callback is called on the thread calling {@link update}, once all
+     * islands are solved.
+     *
      * This attribute is a dynamically assignable callback and may be changed at
      * any given time.
      *
@@ -693,6 +934,51 @@ public:
     }
 
 
+#pragma mark -
+#pragma mark Debugging
+    /**
+     * Returns true if this world draws its debug view.
+     *
+     * @return true if this world draws its debug view.
+     */
+    bool isDebug() const { return _debug; }
+    
+    /**
+     * Sets whether this world draws its debug view.
+     *
+     * The debug view is drawn by {@link drawDebug}.  It streams the physics
+     * shapes directly into a {@link SpriteBatch}, so it does not need the
+     * per-obstacle wireframes of {@link Obstacle#setDebugScene}.  When the
+     * debug view is disabled, it does no work at all.
+     *
+     * @param flag  Whether this world draws its debug view.
+     */
+    void setDebug(bool flag);
+    
+    /**
+     * Returns the debug renderer for this world.
+     *
+     * The renderer can be used to choose what is drawn (shapes, bounding
+     * boxes, contacts, and so on).  It is nullptr until debugging has been
+     * enabled at least once.
+     *
+     * @return the debug renderer for this world.
+     */
+    const std::shared_ptr<ObstacleDebugDraw>& getDebugDraw() const { return _debugDraw; }
+    
+    /**
+     * Draws the debug view of this world with the sprite batch.
+     *
+     * The sprite batch must be active (e.g. between calls to begin and end).
+     * The transform converts from physics coordinates to the coordinates of
+     * the sprite batch perspective.  This method does nothing if the debug
+     * view is disabled.
+     *
+     * @param batch     The sprite batch to draw with
+     * @param transform The transform from physics coordinates
+     */
+    void drawDebug(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform);
+    
 #pragma mark -
 #pragma mark Query Functions
     /**
@@ -718,6 +1004,148 @@ public:
     void rayCast(std::function<float(b2Fixture* fixture, const Vec2& point,
                                      const Vec2& normal, float fraction)> callback,
                  const Vec2& point1, const Vec2& point2) const;
+
+    /**
+     * Ray-casts the world for a batch of rays, writing a result for each ray.
+     *
+     * Unlike {@link rayCast}, this method allocates nothing and makes no
+     * type-erased call for each ray.  Each result is the closest fixture
+     * (or the first one found, see {@link RayQuery#any}) that passes the
+     * category mask of the ray.  The fixture of the result is nullptr if
+     * the ray hit nothing.
+     *
+     * If there are several solver threads (see {@link setSolverThreads}),
+     * large batches are split across them.  This is safe because the queries
+     * only read the broadphase, but it must not be called while the world is
+     * stepping.
+     *
+     * @param  rays     The rays to cast
+     * @param  hits     The array to store the results (one per ray)
+     * @param  count    The number of rays
+     */
+    void rayCast(const RayQuery* rays, RayHit* hits, size_t count) const {
+        rayCast(rays, hits, count, [](b2Fixture*, size_t) { return true; });
+    }
+
+    /**
+     * Ray-casts the world for a batch of rays, writing a result for each ray.
+     *
+     * Unlike {@link rayCast}, this method allocates nothing and makes no
+     * type-erased call for each ray.  Each result is the closest fixture
+     * (or the first one found, see {@link RayQuery#any}) that passes the
+     * category mask of the ray and the filter.  The fixture of the result
+     * is nullptr if the ray hit nothing.
+     *
+     * The filter is any callable with the signature
+     *
+     *     bool filter(b2Fixture* fixture, size_t index)
+     *
+     * where index is the position of the ray in the batch.  It should return
+     * false to ignore the fixture.  If there are several solver threads (see
+     * {@link setSolverThreads}), large batches are split across them, and the
+     * filter is called on all of them.  This is safe because the queries only
+     * read the broadphase, but it must not be called while the world is
+     * stepping.
+     *
+     * @param  rays     The rays to cast
+     * @param  hits     The array to store the results (one per ray)
+     * @param  count    The number of rays
+     * @param  filter   The additional filter for the fixtures
+     */
+    template <typename Filter>
+    void rayCast(const RayQuery* rays, RayHit* hits, size_t count, Filter filter) const {
+        runQueries(count, [&](size_t begin, size_t end) {
+            BatchRayCallback<Filter> callback;
+            callback.filter = &filter;
+            for(size_t ii = begin; ii < end; ii++) {
+                callback.query = rays+ii;
+                callback.hit = hits+ii;
+                callback.index = ii;
+                hits[ii].fixture = nullptr;
+                hits[ii].fraction = 1;
+                _world->RayCast(&callback, b2Vec2(rays[ii].start.x,rays[ii].start.y),
+                                b2Vec2(rays[ii].end.x,rays[ii].end.y));
+            }
+        });
+    }
+
+    /**
+     * Tests a batch of shapes against the world, writing a result for each shape.
+     *
+     * Each result is the first fixture overlapping the shape and the number
+     * of overlapping fixtures (at most one if {@link ShapeQuery#any} is set).
+     * Only fixtures that pass the category mask of the shape are counted.
+     * Unlike {@link queryAABB}, the overlap is exact, not just the bounding
+     * boxes.
+     *
+     * Large batches are split across the solver threads, as with the batched
+     * {@link rayCast}.
+     *
+     * @param  shapes   The shapes to test
+     * @param  hits     The array to store the results (one per shape)
+     * @param  count    The number of shapes
+     */
+    void queryShapes(const ShapeQuery* shapes, ShapeHit* hits, size_t count) const {
+        queryShapes(shapes, hits, count, [](b2Fixture*, size_t) { return true; });
+    }
+
+    /**
+     * Tests a batch of shapes against the world, writing a result for each shape.
+     *
+     * Each result is the first fixture overlapping the shape and the number
+     * of overlapping fixtures (at most one if {@link ShapeQuery#any} is set).
+     * Only fixtures that pass the category mask of the shape and the filter
+     * are counted.  Unlike {@link queryAABB}, the overlap is exact, not just
+     * the bounding boxes.
+     *
+     * The filter has the same signature as in the batched {@link rayCast},
+     * and large batches are split across the solver threads in the same way.
+     *
+     * @param  shapes   The shapes to test
+     * @param  hits     The array to store the results (one per shape)
+     * @param  count    The number of shapes
+     * @param  filter   The additional filter for the fixtures
+     */
+    template <typename Filter>
+    void queryShapes(const ShapeQuery* shapes, ShapeHit* hits, size_t count, Filter filter) const {
+        runQueries(count, [&](size_t begin, size_t end) {
+            BatchShapeCallback<Filter> callback;
+            callback.filter = &filter;
+            for(size_t ii = begin; ii < end; ii++) {
+                hits[ii].fixture = nullptr;
+                hits[ii].count = 0;
+                const b2Shape* shape = shapes[ii].shape;
+                if (shape == nullptr) {
+                    continue;
+                }
+                
+                b2AABB aabb;
+                shape->ComputeAABB(&aabb, shapes[ii].transform, 0);
+                for(int32 jj = 1; jj < shape->GetChildCount(); jj++) {
+                    b2AABB child;
+                    shape->ComputeAABB(&child, shapes[ii].transform, jj);
+                    aabb.Combine(child);
+                }
+                callback.query = shapes+ii;
+                callback.hit = hits+ii;
+                callback.index = ii;
+                _world->QueryAABB(&callback, aabb);
+            }
+        });
+    }
+
+private:
+    /**
+     * Runs a batch of queries, splitting it across the solver threads.
+     *
+     * The work function is called with ranges [begin,end) that cover the
+     * batch exactly once.  Small batches (and serial worlds) are run on the
+     * calling thread in a single range.
+     *
+     * @param  count    The number of queries
+     * @param  work     The function to run a range of queries
+     */
+    void runQueries(size_t count, const std::function<void(size_t begin, size_t end)>& work) const;
     
 };
 
@@ -90,13 +90,19 @@ protected:
      * Hence this method does the maximum amount of work that can be done in 
      * asynchronous font loading.
      *
+     * If distance is true, the font gets a distance field atlas instead of
+     * a bitmap atlas.  The character set is then only the initial contents
+     * of the atlas, as missing glyphs are added when they are drawn.
+     *
      * @param source    The pathname to the asset
      * @param charset   The atlas character set
      * @param size      The font size
+     * @param distance  Whether to build a distance field atlas
      *
      * @return the font asset with no generated atlas
      */
-    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset, int size);
+    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset, int size,
+                                  bool distance=false);
     
     /**
      * Creates an atlas for the font asset, and assigns it the given key.
@@ -179,6 +185,7 @@ protected:
      *      "file":         The path to the asset
      *      "size":         This font size (int)
      *      "charset":      The set of characters for the font atlas (string)
+     *      "atlas":        The atlas type, "bitmap" (default) or "distance"
      *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
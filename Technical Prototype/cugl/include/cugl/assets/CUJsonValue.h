@@ -4,8 +4,9 @@
 //
 //  This module a modern C++ alternative to the cJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses cJSON as the underlying parsing
-//  engine.
+//  management.  JSON strings are parsed in a single pass, building the nodes
+//  directly from the source buffer, and encoded in a single pass as well.
+//  cJSON is only used to convert to and from cJSON nodes.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -48,6 +49,9 @@
 #include <vector>
 #include <string>
 
+/** The maximum depth of nested arrays and objects in a JSON string */
+#define JSON_NESTING_LIMIT  512
+
 namespace cugl {
 
 /**
@@ -62,9 +66,10 @@ namespace cugl {
  * if the node is an object type.  Hence the main usage of this feature is to
  * "cast" object nodes to arrays.
  *
- * This class uses cJSON as the underlying parsing engine.  However, it manages
- * memory automatically so that the user does not need to worry about deleting
- * or allocating memory beyond the initial node itself.
+ * This class has its own parser, which builds the tree in a single pass over
+ * the source buffer, and its own encoder, which writes numbers without losing
+ * precision.  It manages memory automatically so that the user does not need
+ * to worry about deleting or allocating memory beyond the initial node itself.
  */
 class JsonValue {
 public:
@@ -152,6 +157,60 @@ private:
      */
     static cJSON* toCJSON(const JsonValue* value);
     
+#pragma mark -
+#pragma mark Direct Parsing
+    /**
+     * Parses the JSON value at the given position into the given node.
+     *
+     * This method recursively allocates child nodes as necessary, attaching
+     * them to the node as they are parsed.  String payloads are copied once,
+     * directly from the source buffer into the node.
+     *
+     * On success, the position is advanced just past the value.  On failure,
+     * the position is left at the offending character.
+     *
+     * @param value The node to store the value
+     * @param json  The current position in the source buffer
+     * @param end   The end of the source buffer
+     * @param depth The current nesting depth
+     *
+     * @return true if the value was parsed successfully.
+     */
+    static bool parseValue(JsonValue* value, const char*& json, const char* end, int depth);
+
+    /**
+     * Parses the quoted JSON string at the given position.
+     *
+     * Any escape sequences are decoded as UTF8.  The result is assigned to
+     * the given string, replacing its contents.
+     *
+     * On success, the position is advanced just past the closing quote.  On
+     * failure, the position is left at the offending character.
+     *
+     * @param result    The string to store the result
+     * @param json      The current position in the source buffer
+     * @param end       The end of the source buffer
+     *
+     * @return true if the string was parsed successfully.
+     */
+    static bool parseString(std::string& result, const char*& json, const char* end);
+
+#pragma mark -
+#pragma mark Direct Encoding
+    /**
+     * Appends the given node to the string as JSON.
+     *
+     * This method recursively appends the children of the node.  The layout
+     * (including the tabs of a pretty-printed string) is the same as that of
+     * cJSON_Print and cJSON_PrintUnformatted.
+     *
+     * @param result    The string to append to
+     * @param value     The node to encode
+     * @param depth     The current nesting depth
+     * @param format    Whether to pretty-print the JSON string
+     */
+    static void printValue(std::string& result, const JsonValue* value, int depth, bool format);
+
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -283,7 +342,7 @@ public:
      * @return  true if the JSON node is initialized properly, false otherwise.
      */
     bool initWithJson(const std::string& json) {
-        return initWithJson(json.c_str());
+        return initWithJson(json.data(),json.size());
     }
     
     /**
@@ -304,6 +363,27 @@ public:
      */
     bool initWithJson(const char* json);
 
+    /**
+     * Initializes a new JsonValue from the given JSON buffer.
+     *
+     * This initializer parses the first JSON value in the buffer, building
+     * the tree directly from the buffer in a single pass.  The buffer does
+     * not need to be null-terminated, and any text after the value is
+     * ignored.  If consumed is not nullptr, it is set to the number of bytes
+     * read, including any leading whitespace.
+     *
+     * If there is a parsing error, this method will return false.  Detailed
+     * information about the parsing error will be passed to an assert.  Hence
+     * error messages are suppressed if asserts are turned off.
+     *
+     * @param json      The JSON buffer to parse.
+     * @param length    The length of the buffer in bytes.
+     * @param consumed  Pointer to store the number of bytes read (optional)
+     *
+     * @return  true if the JSON node is initialized properly, false otherwise.
+     */
+    bool initWithJson(const char* json, size_t length, size_t* consumed=nullptr);
+
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -471,6 +551,31 @@ public:
         return (result->initWithJson(json) ? result : nullptr);
     }
 
+    /**
+     * Returns a newly allocated JsonValue from the given JSON buffer.
+     *
+     * This allocator parses the first JSON value in the buffer, building
+     * the tree directly from the buffer in a single pass.  The buffer does
+     * not need to be null-terminated, and any text after the value is
+     * ignored.  If consumed is not nullptr, it is set to the number of bytes
+     * read, including any leading whitespace.
+     *
+     * If there is a parsing error, this method will return nullptr.  Detailed
+     * information about the parsing error will be passed to an assert.  Hence
+     * error messages are suppressed if asserts are turned off.
+     *
+     * @param json      The JSON buffer to parse.
+     * @param length    The length of the buffer in bytes.
+     * @param consumed  Pointer to store the number of bytes read (optional)
+     *
+     * @return a newly allocated JsonValue from the given JSON buffer.
+     */
+    static std::shared_ptr<JsonValue> allocWithJson(const char* json, size_t length,
+                                                    size_t* consumed=nullptr) {
+        std::shared_ptr<JsonValue> result = std::make_shared<JsonValue>();
+        return (result->initWithJson(json,length,consumed) ? result : nullptr);
+    }
+
     
 #pragma mark -
 #pragma mark Type
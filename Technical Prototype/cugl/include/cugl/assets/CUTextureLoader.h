@@ -47,6 +47,7 @@
 #define __CU_TEXTURE_LOADER_H__
 #include <cugl/assets/CULoader.h>
 #include <cugl/renderer/CUTexture.h>
+#include <cugl/renderer/CUKTXImage.h>
 
 namespace cugl {
 
@@ -66,6 +67,11 @@ namespace cugl {
  * remainder of asset loading using {@link Application#schedule}.  This is a
  * good template for asset loaders in general.
  *
+ * Files with a .ktx extension are loaded as KTX images rather than through
+ * SDL_Image.  These may hold ETC2/EAC compressed data with prebuilt mipmaps,
+ * which stays compressed in GPU memory.  If the platform does not support
+ * the compressed format, the image is decompressed in the loader thread.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -101,6 +107,20 @@ protected:
      * @return the SDL_Surface with the texture information
      */
     SDL_Surface* preload(const std::string& source);
+
+    /**
+     * Loads the portion of a KTX asset that is safe to load outside the main thread.
+     *
+     * This method reads the KTX container into memory.  If the image is
+     * compressed in a format not supported by this platform, this method
+     * also decompresses it (with all of its mipmaps) to RGBA data.  Hence
+     * the main thread only has to upload the data to OpenGL.
+     *
+     * @param source    The pathname to the asset
+     *
+     * @return the KTX image ready for upload to OpenGL
+     */
+    std::shared_ptr<KTXImage> preloadKTX(const std::string& source);
     
     /**
      * Creates an OpenGL texture from the SDL_Surface, and assigns it the given key.
@@ -150,6 +170,45 @@ protected:
      * @param callback  An optional callback for asynchronous loading
      */
     void materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback);
+
+    /**
+     * Creates an OpenGL texture from the KTX image, and assigns it the given key.
+     *
+     * This method finishes the asset loading started in {@link preloadKTX}.
+     * This step is not safe to be done in a separate thread.  Instead, it
+     * takes place in the main CUGL thread via {@link Application#schedule}.
+     *
+     * The loaded texture will have default parameters for scaling and wrap.
+     * It will have the mipmaps stored in the image, if any.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param key       The key to access the asset after loading
+     * @param image     The KTX image to upload
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materialize(const std::string& key, const std::shared_ptr<KTXImage>& image, LoaderCallback callback);
+
+    /**
+     * Creates an OpenGL texture from the KTX image accoring to the directory entry.
+     *
+     * This method finishes the asset loading started in {@link preloadKTX}.
+     * This step is not safe to be done in a separate thread.  Instead, it
+     * takes place in the main CUGL thread via {@link Application#schedule}.
+     *
+     * The directory entry is the same as for {@link materialize} with an
+     * SDL_Surface.  However, the "mipmaps" value is ignored for compressed
+     * images, which must have their mipmaps prebuilt.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param json      The asset directory entry
+     * @param image     The KTX image to upload
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materialize(const std::shared_ptr<JsonValue>& json, const std::shared_ptr<KTXImage>& image, LoaderCallback callback);
     
 
     /**
@@ -232,6 +291,40 @@ public:
         _loader = nullptr;
     }
     
+    /**
+     * Initializes a new texture loader.
+     *
+     * This method bootstraps the loader with any initial resources that it
+     * needs to load assets. In particular, the OpenGL context must be active,
+     * as this method queries the supported compressed texture formats.
+     * Attempts to load an asset before this method is called will fail.
+     *
+     * This loader will have no associated threads. That means any asynchronous
+     * loading will fail until a thread is provided via {@link setThreadPool}.
+     *
+     * @return true if the asset loader was initialized successfully
+     */
+    bool init() override {
+        return init(nullptr);
+    }
+
+    /**
+     * Initializes a new texture loader.
+     *
+     * This method bootstraps the loader with any initial resources that it
+     * needs to load assets. In particular, the OpenGL context must be active,
+     * as this method queries the supported compressed texture formats.
+     * Attempts to load an asset before this method is called will fail.
+     *
+     * @param threads   The thread pool for asynchronous loading support
+     *
+     * @return true if the asset loader was initialized successfully
+     */
+    bool init(const std::shared_ptr<ThreadPool>& threads) override {
+        KTXImage::querySupport();
+        return Loader<Texture>::init(threads);
+    }
+
     /**
      * Returns a newly allocated texture loader.
      *
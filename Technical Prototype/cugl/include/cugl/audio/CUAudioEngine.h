@@ -52,6 +52,8 @@
 #define AUDIO_OUTPUT_CHANNELS 2
 /** The default sampling frequency */
 #define AUDIO_FREQUENCY 44100
+/** The default device block size in frames (SMALLER = LESS LAG, BUT MORE CPU LOAD) */
+#define AUDIO_BLOCK_SIZE 1024
 
 /** Comment this out to use SDL sound on Mac/iOS (not recommended) */
 #if defined (__MACOSX__) || defined (__IPHONEOS__)
@@ -172,11 +174,15 @@ private:
      * the mixer graph for the sound effect channels.  The provided parameter
      * indicates the number of simultaneously supported sounds.
      *
+     * The block size is the size of the device buffer on SDL platforms.  It
+     * is ignored by AVFoundation, which manages its own buffers.
+     *
      * @param channels  The maximum number of sound effect channels to support
+     * @param block     The device block size in frames
      *
      * @return true if the audio engine was successfully initialized.
      */
-    bool init(unsigned int channels=AUDIO_INPUT_CHANNELS);
+    bool init(unsigned int channels=AUDIO_INPUT_CHANNELS, unsigned int block=AUDIO_BLOCK_SIZE);
     
     /**
      * Releases all resources for this singleton audio engine.
@@ -226,9 +232,16 @@ public:
      * The provided parameter indicates the number of simultaneously supported 
      * sounds.
      *
+     * The block size is the size of the device buffer on SDL platforms, and
+     * so it bounds the latency of the engine.  It is ignored by AVFoundation.
+     * A {@link SoundMixer} that attaches to this engine (on platforms with only
+     * one audio device) has the same latency, so such games should start the
+     * engine with the block size of the mixer.
+     *
      * @param channels  The maximum number of sound effect channels to support
+     * @param block     The device block size in frames
      */
-    static void start(unsigned int channels=AUDIO_INPUT_CHANNELS);
+    static void start(unsigned int channels=AUDIO_INPUT_CHANNELS, unsigned int block=AUDIO_BLOCK_SIZE);
     
     /**
      * Stops the singleton audio engine, releasing all resources.
@@ -0,0 +1,381 @@
+//
+//  CUMusicStream.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an incremental Ogg Vorbis decoder for SoundMixer.
+//  A music stream decodes a Vorbis file a few pages at a time into a fixed
+//  size ring buffer, resampling to the output rate as it goes.  The memory
+//  used by a stream is therefore bounded, regardless of the length of the
+//  track.
+//
+//  Each stream is shared by three threads.  The decoder thread writes to the
+//  ring buffer, the audio thread reads from it, and the main thread controls
+//  it (seeking and looping).  They communicate only through atomics, so no
+//  thread ever blocks on another.  Because the decoder loops back to the
+//  start of the file without draining the ring buffer, looping is gapless.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_MUSIC_STREAM_H__
+#define __CU_MUSIC_STREAM_H__
+#include <cugl/base/CUBase.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+/** The default ring buffer capacity in frames (must be a power of two) */
+#define MUSIC_BUFFER_FRAMES 32768
+/** The number of frames to decode before a stream starts playing */
+#define MUSIC_PREFILL_FRAMES 4096
+
+/** Opaque reference to the vorbisfile decoder */
+struct OggVorbis_File;
+
+namespace cugl {
+
+/**
+ * This class is an incremental decoder for an Ogg Vorbis music track.
+ *
+ * A stream decodes into a ring buffer of stereo float frames at the output
+ * sample rate of {@link SoundMixer}.  The method {@link decode} is called by
+ * the decoder thread to top up the buffer, while {@link mix} is called by the
+ * audio thread to consume it.  Mono files are expanded to stereo, and files
+ * with more than two channels are reduced to their front pair.
+ *
+ * The stream also carries a gain envelope, which the audio thread uses for
+ * crossfades.  Fades are applied per frame, so two streams that start a fade
+ * in the same block are perfectly aligned.
+ *
+ * You should never need to use this class directly.  Use the music methods
+ * of {@link SoundMixer} instead.
+ */
+class MusicStream {
+public:
+    /** The state of a stream, as seen by the main thread */
+    enum class State : int {
+        /** The stream is still playing */
+        PLAYING = 0,
+        /** The stream reached the end of the track */
+        COMPLETED = 1,
+        /** The stream was stopped or faded out */
+        STOPPED = 2
+    };
+
+private:
+    /** This macro disables the copy constructor (not allowed on streams) */
+    CU_DISALLOW_COPY_AND_ASSIGN(MusicStream);
+
+    /** The source file */
+    std::string _source;
+    /** The vorbisfile decoder */
+    OggVorbis_File* _file;
+    /** The sample rate of the file */
+    Uint32 _srcRate;
+    /** The number of channels in the file */
+    Uint32 _srcChannels;
+    /** The length of the file in source frames */
+    Uint64 _srcFrames;
+    /** The output sample rate */
+    Uint32 _rate;
+    /** The length of the track in output frames */
+    Uint64 _length;
+
+    /** The interleaved stereo ring buffer */
+    std::vector<float> _ring;
+    /** The capacity of the ring buffer in frames */
+    Uint32 _capacity;
+
+    /** The resampler position, relative to the start of the next chunk */
+    double _phase;
+    /** The last source frame of the previous chunk (for interpolation) */
+    float _last[2];
+    /** The number of frames written (decoder thread) */
+    Uint64 _written;
+    /** The number of frames written (published to the audio thread) */
+    std::atomic<Uint64> _write;
+    /** The number of frames read (published to the decoder thread) */
+    std::atomic<Uint64> _readPos;
+    /** Whether the decoder has reached the end of a non-looping track */
+    std::atomic<bool> _eof;
+    /** Whether the track loops */
+    std::atomic<bool> _loop;
+
+    /** A pending seek in source frames (negative for none) */
+    std::atomic<Sint64> _seekRequest;
+    /** The number of seeks completed by the decoder */
+    std::atomic<Uint32> _seekEpoch;
+    /** The write position at the last seek */
+    std::atomic<Uint64> _seekWrite;
+    /** The track position (in output frames) of the last seek */
+    std::atomic<Uint64> _seekBase;
+
+    /** The number of frames read (audio thread) */
+    Uint64 _read;
+    /** The last seek seen by the audio thread */
+    Uint32 _readEpoch;
+    /** The current gain (audio thread) */
+    float _gain;
+    /** The target gain (audio thread) */
+    float _goal;
+    /** The gain change per frame (audio thread) */
+    float _step;
+    /** Whether the stream stops once its gain reaches zero (audio thread) */
+    bool _stopping;
+
+    /** The track position in output frames */
+    std::atomic<Uint64> _elapsed;
+    /** The number of blocks that ran out of data */
+    std::atomic<Uint32> _underruns;
+    /** The stream state */
+    std::atomic<int> _state;
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Writes a chunk of decoded audio to the ring buffer.
+     *
+     * The chunk is resampled to the output rate.  The caller must make sure
+     * there is room for the resampled frames.
+     *
+     * @param pcm       The decoded samples, one array per channel
+     * @param frames    The number of source frames
+     */
+    void write(float** pcm, Uint32 frames);
+
+    /**
+     * Handles any pending seek request in the decoder thread.
+     */
+    void processSeek();
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized music stream.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    MusicStream();
+
+    /**
+     * Deletes this music stream, disposing of all resources.
+     */
+    ~MusicStream() { dispose(); }
+
+    /**
+     * Closes the decoder and releases the ring buffer.
+     *
+     * It is unsafe to call this while the stream is attached to the audio
+     * thread or the decoder thread.
+     */
+    void dispose();
+
+    /**
+     * Initializes a stream for the given Ogg Vorbis file.
+     *
+     * This method reads the file header, but does not decode any audio.  The
+     * file is read through SDL, so on Android this may be a path inside of the
+     * application package.
+     *
+     * @param file      The path to the Ogg Vorbis file
+     * @param rate      The output sample rate
+     * @param capacity  The ring buffer capacity in frames (a power of two)
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::string& file, Uint32 rate, Uint32 capacity=MUSIC_BUFFER_FRAMES);
+
+    /**
+     * Returns a newly allocated stream for the given Ogg Vorbis file.
+     *
+     * This method reads the file header, but does not decode any audio.  The
+     * file is read through SDL, so on Android this may be a path inside of the
+     * application package.
+     *
+     * @param file      The path to the Ogg Vorbis file
+     * @param rate      The output sample rate
+     * @param capacity  The ring buffer capacity in frames (a power of two)
+     *
+     * @return a newly allocated stream for the given Ogg Vorbis file.
+     */
+    static std::shared_ptr<MusicStream> alloc(const std::string& file, Uint32 rate,
+                                              Uint32 capacity=MUSIC_BUFFER_FRAMES) {
+        std::shared_ptr<MusicStream> result = std::make_shared<MusicStream>();
+        return (result->init(file,rate,capacity) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Main Thread
+    /**
+     * Returns the source file for this stream
+     *
+     * @return the source file for this stream
+     */
+    const std::string& getSource() const { return _source; }
+
+    /**
+     * Returns the length of the track in seconds.
+     *
+     * @return the length of the track in seconds.
+     */
+    double getDuration() const {
+        return _srcRate ? (double)_srcFrames/_srcRate : 0.0;
+    }
+
+    /**
+     * Returns the current position in the track in seconds.
+     *
+     * This is the position of the last frame handed to the audio device.
+     *
+     * @return the current position in the track in seconds.
+     */
+    double getElapsed() const {
+        return _rate ? (double)_elapsed.load(std::memory_order_relaxed)/_rate : 0.0;
+    }
+
+    /**
+     * Moves the stream to the given position in seconds.
+     *
+     * The seek is performed by the decoder thread.  The audio thread drops
+     * any buffered audio from before the seek as soon as the new audio is
+     * available.
+     *
+     * @param time  The new position in seconds
+     */
+    void seek(double time);
+
+    /**
+     * Returns true if the track loops.
+     *
+     * @return true if the track loops.
+     */
+    bool isLoop() const { return _loop.load(std::memory_order_relaxed); }
+
+    /**
+     * Sets whether the track loops.
+     *
+     * Looping is gapless, as the decoder continues at the start of the file
+     * without waiting for the ring buffer to drain.
+     *
+     * @param loop  Whether the track loops
+     */
+    void setLoop(bool loop) { _loop.store(loop, std::memory_order_relaxed); }
+
+    /**
+     * Returns the state of this stream.
+     *
+     * @return the state of this stream.
+     */
+    State getState() const { return (State)_state.load(std::memory_order_acquire); }
+
+    /**
+     * Returns the number of times the audio thread ran out of data.
+     *
+     * A non-zero value means that the decoder thread is not keeping up.
+     *
+     * @return the number of times the audio thread ran out of data.
+     */
+    Uint32 getUnderruns() const { return _underruns.load(std::memory_order_relaxed); }
+
+#pragma mark -
+#pragma mark Decoder Thread
+    /**
+     * Decodes audio into the ring buffer.
+     *
+     * This method decodes until the ring buffer is full, the track is done,
+     * or the given number of frames are written.  It should only ever be
+     * called by one thread at a time.
+     *
+     * @param limit The maximum number of frames to write (0 for no limit)
+     *
+     * @return true if any frames were written.
+     */
+    bool decode(Uint32 limit=0);
+
+#pragma mark -
+#pragma mark Audio Thread
+    /**
+     * Starts a fade to the given gain.
+     *
+     * The gain changes linearly over the given number of frames, starting
+     * with the next call to {@link mix}.  If stop is true, the stream
+     * finishes once it fades to zero.
+     *
+     * @param gain      The target gain
+     * @param frames    The length of the fade in frames
+     * @param stop      Whether to stop the stream when it is silent
+     */
+    void fade(float gain, Uint32 frames, bool stop);
+
+    /**
+     * Returns true if this stream will stop once its gain reaches zero.
+     *
+     * @return true if this stream will stop once its gain reaches zero.
+     */
+    bool isStopping() const { return _stopping; }
+
+    /**
+     * Sets the gain immediately.
+     *
+     * @param gain      The new gain
+     */
+    void setGain(float gain) { _gain = _goal = gain; _step = 0; }
+
+    /**
+     * Mixes the next block of this stream into the given buffer.
+     *
+     * The audio is added to the stereo buffer, scaled by the gain envelope.
+     * If the stream finishes during this block (either because the track
+     * ended or because it faded out), this method returns false and updates
+     * the state.
+     *
+     * @param output    The interleaved stereo output buffer
+     * @param frames    The number of frames to mix
+     *
+     * @return false if the stream has finished
+     */
+    bool mix(float* output, Uint32 frames);
+
+    /**
+     * Stops this stream immediately.
+     *
+     * This is called by the audio thread when a stream is dropped.
+     */
+    void halt() { _state.store((int)State::STOPPED, std::memory_order_release); }
+};
+
+}
+
+#endif /* __CU_MUSIC_STREAM_H__ */
@@ -257,6 +257,8 @@ public:
     
     /** Allow a sound channel to access the internal buffers */
     friend class SoundChannel;
+    /** Allow the software mixer to decode the internal buffers */
+    friend class SoundMixer;
 };
 
 }
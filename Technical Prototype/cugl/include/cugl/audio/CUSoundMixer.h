@@ -0,0 +1,852 @@
+//
+//  CUSoundMixer.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a singleton providing a low-latency software mixer for
+//  sound effects.  It is an alternative to the effect channels of AudioEngine.
+//  Instead of handing sounds to a platform mixer, it decodes every sound asset
+//  once into a PCM cache (resampled to the output rate) and mixes the active
+//  voices itself in an SDL audio callback.  That means that the output latency
+//  is determined by our (small) block size, and not the block size of the
+//  platform mixer.
+//
+//  Voices are drawn from a fixed pool, and are identified by integer handles
+//  instead of string keys.  When the pool is exhausted, the mixer steals the
+//  voice with the lowest priority.  The game thread never touches the voices
+//  directly.  It communicates with the audio thread through a lock-free
+//  command queue, so playing a sound never blocks or allocates.
+//
+//  The mixer also streams Ogg Vorbis music in the same callback.  Music is
+//  decoded on a background thread (see MusicStream), and up to two tracks are
+//  mixed at once so that crossfades truly overlap.
+//
+//  Because this is a singleton, there are no publicly accessible constructors
+//  or intializers.  Use the static methods instead.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_SOUND_MIXER_H__
+#define __CU_SOUND_MIXER_H__
+#include <cugl/audio/CUSound.h>
+#include <cugl/audio/CUMusic.h>
+#include <cugl/audio/CUMusicStream.h>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+/** The default number of voices in the mixer pool */
+#define MIXER_VOICES        32
+/** The default mixer block size in frames (SMALLER = LESS LAG, MORE CPU LOAD) */
+#define MIXER_BLOCK_SIZE    256
+/** The capacity of the command queues (must be a power of two) */
+#define MIXER_QUEUE_SIZE    256
+/** How often the music decoder thread checks its streams (in milliseconds) */
+#define MIXER_DECODE_PERIOD 10
+
+namespace cugl {
+
+/**
+ * Class provides a singleton software mixer for sound effects.
+ *
+ * This class is a replacement for the sound effect channels of
+ * {@link AudioEngine}.  It opens its own SDL audio device with a small block
+ * size and mixes the sounds in software.  Sound assets are decoded to PCM
+ * once (see {@link prepare}) and resampled to the output rate, so the audio
+ * callback does nothing more than scale and add samples.
+ *
+ * Sounds are played on voices from a fixed pool.  Each call to {@link play}
+ * returns an integer voice handle, which can be used to stop the sound or to
+ * change its volume.  A handle is never reused (until the counter wraps), so
+ * it is safe to hold on to a handle after the sound has finished.  When all of
+ * the voices are in use, the mixer steals the voice with the lowest priority
+ * (and the oldest voice among equal priorities).  If every voice has a higher
+ * priority than the new sound, the new sound is dropped instead.
+ *
+ * Music is handled by the same callback.  Ogg Vorbis tracks are decoded by a
+ * background thread into bounded ring buffers, and the mixer plays up to two
+ * of them at once.  Starting a new track with a fade crossfades the old track
+ * out while the new one fades in, with both fades starting on the same frame.
+ *
+ * Some platforms (notably Android) only allow one audio device at a time.  If
+ * the mixer cannot open its own device, it attaches itself to the SDL mixer
+ * used by {@link AudioEngine}.  It still works in that case, but the output
+ * latency is that of the SDL mixer.
+ *
+ * The mixer keeps statistics about itself.  In particular, it measures how
+ * long the audio thread spends mixing each block, and how long it takes for a
+ * play request to reach the audio thread.
+ *
+ * IMPORTANT: Like {@link AudioEngine}, this class is only safe to access from
+ * the main application thread.  The audio callback only touches the mixer
+ * through lock-free queues, and the music decoder thread only touches the
+ * music streams.
+ */
+class SoundMixer {
+#pragma mark Internal Types
+private:
+    /** A PCM buffer decoded at the output sample rate */
+    struct Sample {
+        /** The interleaved samples, normalized to [-1,1] */
+        std::vector<float> data;
+        /** The number of audio frames */
+        Uint32 frames;
+        /** The number of channels (1 or 2) */
+        Uint32 channels;
+        /** The asset this buffer was decoded from */
+        std::weak_ptr<Sound> source;
+    };
+
+    /** A command from the main thread to the audio thread */
+    struct Command {
+        /** The command type */
+        Uint32 type;
+        /** The voice handle (or 0 for commands on all voices) */
+        Uint32 handle;
+        /** The sample to play or stop */
+        const Sample* sample;
+        /** The music stream to play */
+        MusicStream* stream;
+        /** The length of a fade in frames */
+        Uint32 fade;
+        /** The new volume */
+        float volume;
+        /** The new pan */
+        float pan;
+        /** The voice priority */
+        Sint32 priority;
+        /** Whether the voice loops */
+        bool loop;
+        /** The performance counter value when the command was issued */
+        Uint64 stamp;
+    };
+
+    /** A notification from the audio thread that a voice has finished */
+    struct Completion {
+        /** The voice handle */
+        Uint32 handle;
+        /** True if the sound completed normally */
+        bool status;
+    };
+
+    /** The state of a voice in the pool (only touched by the audio thread) */
+    struct Voice {
+        /** The sound being played (nullptr if this voice is free) */
+        const Sample* sample;
+        /** The voice handle */
+        Uint32 handle;
+        /** The current frame position */
+        Uint32 position;
+        /** The voice priority */
+        Sint32 priority;
+        /** The order in which the voice was started (for stealing) */
+        Uint64 serial;
+        /** The target volume */
+        float volume;
+        /** The target pan in [-1,1] */
+        float pan;
+        /** The left gain applied at the end of the last block */
+        float gainL;
+        /** The right gain applied at the end of the last block */
+        float gainR;
+        /** Whether the voice loops */
+        bool loop;
+        /** Whether the voice is fading out to stop */
+        bool stopping;
+    };
+
+    /** A music track owned by the main thread */
+    struct Track {
+        /** The decoder for this track */
+        std::shared_ptr<MusicStream> stream;
+        /** The music asset */
+        std::shared_ptr<Music> asset;
+    };
+
+#pragma mark Values
+    /** Reference to the mixer singleton */
+    static SoundMixer* _gMixer;
+
+    /** The SDL audio device (0 if we are attached to the SDL mixer) */
+    Uint32 _device;
+    /** The output sample rate */
+    Uint32 _rate;
+    /** The number of output channels (always 2) */
+    Uint32 _channels;
+    /** The mixer block size in frames */
+    Uint32 _block;
+    /** The SDL audio format of the output */
+    Uint16 _format;
+    /** Whether the mixer is paused */
+    std::atomic<bool> _paused;
+    /** The number of frames in the last audio callback */
+    std::atomic<Uint32> _period;
+
+    /** The decoded sounds, keyed by asset */
+    std::unordered_map<const Sound*, std::shared_ptr<Sample>> _samples;
+    /** Decoded sounds waiting for the audio thread to let go of them */
+    std::vector<std::pair<std::shared_ptr<Sample>,Uint64>> _retired;
+    /** Replaced sounds whose stop command has not been queued yet */
+    std::vector<std::shared_ptr<Sample>> _orphaned;
+    /** The next voice handle to assign */
+    Uint32 _nextHandle;
+
+    /** The voice pool */
+    std::vector<Voice> _voices;
+    /** The handle of each voice, published for the main thread (0 if free) */
+    std::unique_ptr<std::atomic<Uint32>[]> _handles;
+    /** The most recent play handle processed by the audio thread */
+    std::atomic<Uint32> _processed;
+    /** The number of voices started so far (audio thread) */
+    Uint64 _serial;
+    /** The master volume (audio thread) */
+    float _master;
+    /** The scratch buffer when attached to the SDL mixer */
+    std::vector<float> _scratch;
+
+    /** The music decks (audio thread); deck 0 is the current track */
+    MusicStream* _decks[2];
+    /** The music tracks that the audio thread may still reference */
+    std::vector<Track> _tracks;
+    /** Finished music tracks waiting for the audio thread to let go of them */
+    std::vector<std::pair<std::shared_ptr<MusicStream>,Uint64>> _stale;
+    /** The current music track (nullptr if there is none) */
+    std::shared_ptr<MusicStream> _music;
+    /** The streams to be decoded (guarded by _mutex) */
+    std::vector<std::shared_ptr<MusicStream>> _decoding;
+    /** The music decoder thread */
+    std::thread _decoder;
+    /** The mutex for the decoder thread */
+    std::mutex _mutex;
+    /** The condition variable to wake up the decoder thread */
+    std::condition_variable _wakeup;
+    /** Whether the decoder thread is running (guarded by _mutex) */
+    bool _running;
+
+    /** The commands from the main thread to the audio thread */
+    Command _commands[MIXER_QUEUE_SIZE];
+    /** The next command to read (audio thread) */
+    std::atomic<Uint32> _cmdHead;
+    /** The next command to write (main thread) */
+    std::atomic<Uint32> _cmdTail;
+    /** The completions from the audio thread to the main thread */
+    Completion _completions[MIXER_QUEUE_SIZE];
+    /** The next completion to read (main thread) */
+    std::atomic<Uint32> _doneHead;
+    /** The next completion to write (audio thread) */
+    std::atomic<Uint32> _doneTail;
+
+    /** The number of blocks mixed since the mixer started */
+    std::atomic<Uint64> _blocks;
+    /** The number of blocks mixed since the last reset */
+    std::atomic<Uint64> _mixCount;
+    /** The total performance counter ticks spent mixing */
+    std::atomic<Uint64> _mixTicks;
+    /** The most performance counter ticks spent on a single block */
+    std::atomic<Uint64> _peakTicks;
+    /** The total ticks between a play request and the audio thread */
+    std::atomic<Uint64> _delayTicks;
+    /** The number of play requests in _delayTicks */
+    std::atomic<Uint64> _delayCount;
+    /** The number of voices that were stolen */
+    std::atomic<Uint32> _steals;
+    /** The number of play requests that were dropped */
+    std::atomic<Uint32> _drops;
+    /** The number of voices active at the end of the last block */
+    std::atomic<Uint32> _active;
+
+    /**
+     * Callback function for the sound effects
+     *
+     * This function is called whenever a voice completes. It is called
+     * whether or not the sound completed normally or if it was stopped or
+     * stolen.  However, the second parameter can be used to distinguish the
+     * two cases.  It is always called in the main thread, by {@link update}.
+     *
+     * @param handle    The voice handle
+     * @param status    True if the sound terminated normally, false otherwise.
+     */
+    std::function<void(Uint32 handle, bool status)> _listener;
+
+    /**
+     * Callback function for background music
+     *
+     * This function is called whenever a music track completes.  It is called
+     * whether or not the music completed normally or if it was stopped or
+     * replaced.  However, the second parameter can be used to distinguish the
+     * two cases.  It is always called in the main thread, by {@link update}.
+     *
+     * @param asset     The music asset that just completed
+     * @param status    True if the music terminated normally, false otherwise.
+     */
+    std::function<void(Music* asset, bool status)> _musicCB;
+
+#pragma mark -
+#pragma mark Constructors (Private)
+    /**
+     * Creates, but does not initialize the singleton mixer
+     *
+     * The mixer must be initialized before is can be used.
+     */
+    SoundMixer();
+
+    /**
+     * Disposes of the singleton mixer.
+     *
+     * This destructor closes the audio device and releases the PCM cache.
+     */
+    ~SoundMixer() { dispose(); }
+
+    /**
+     * Initializes the mixer.
+     *
+     * This method opens an SDL audio device with the given block size.  If
+     * that fails, it attaches the mixer to the SDL mixer instead.
+     *
+     * @param voices    The number of voices in the pool
+     * @param block     The mixer block size in frames (a power of two)
+     *
+     * @return true if the mixer was successfully initialized.
+     */
+    bool init(Uint32 voices, Uint32 block);
+
+    /**
+     * Releases all resources for this singleton mixer.
+     */
+    void dispose();
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns the decoded sound for the given asset, decoding it if necessary
+     *
+     * @param sound The sound asset
+     *
+     * @return the decoded sound for the given asset
+     */
+    const Sample* acquire(const std::shared_ptr<Sound>& sound);
+
+    /**
+     * Pushes a command onto the command queue.
+     *
+     * @param cmd   The command to push
+     *
+     * @return false if the queue was full
+     */
+    bool push(const Command& cmd);
+
+    /**
+     * Notifies the main thread that the given voice has finished.
+     *
+     * This method is called in the audio thread.
+     *
+     * @param voice     The voice that finished
+     * @param status    True if the sound terminated normally, false otherwise.
+     */
+    void complete(Voice& voice, bool status);
+
+    /**
+     * Processes a single command in the audio thread.
+     *
+     * @param cmd   The command to process
+     * @param now   The performance counter value at the start of this block
+     */
+    void process(const Command& cmd, Uint64 now);
+
+    /**
+     * Mixes the next block of audio into the given buffer.
+     *
+     * The buffer is overwritten with the output.  This method is called in the
+     * audio thread.
+     *
+     * @param output    The interleaved output buffer
+     * @param frames    The number of frames to mix
+     */
+    void mix(float* output, Uint32 frames);
+
+    /**
+     * Runs the music decoder thread.
+     *
+     * The thread tops up the ring buffers of every stream, and then sleeps
+     * until woken up or until {@link MIXER_DECODE_PERIOD} has passed.
+     */
+    void decodeLoop();
+
+    /**
+     * Fills an audio buffer for the audio device.
+     *
+     * This method is called in the audio thread, and processes any pending
+     * commands before mixing.
+     *
+     * @param stream    The output buffer
+     * @param len       The length of stream in bytes
+     */
+    void fill(Uint8* stream, int len);
+
+    /** Allow the SDL callbacks to fill the audio buffers */
+    friend void MixerDeviceCallback(void* userdata, Uint8* stream, int len);
+    /** Allow the SDL callbacks to fill the audio buffers */
+    friend void MixerPostMixCallback(void* userdata, Uint8* stream, int len);
+
+#pragma mark -
+#pragma mark Static Accessors
+public:
+    /**
+     * Returns the singleton instance of the mixer.
+     *
+     * If the mixer has not been started, then this method will return nullptr.
+     *
+     * @return the singleton instance of the mixer.
+     */
+    static SoundMixer* get() { return _gMixer; }
+
+    /**
+     * Starts the singleton mixer.
+     *
+     * Once this method is called, the method get() will no longer return
+     * nullptr.  Calling the method multiple times (without calling stop) will
+     * have no effect.
+     *
+     * If you are also using {@link AudioEngine} for music, you should start
+     * it first.  On platforms that only support one audio device, the mixer
+     * will then attach itself to that engine.  In that case the latency is
+     * that of the engine block size, and not the mixer block size.  Start the
+     * engine with the same block size on those platforms (such as Android).
+     *
+     * @param voices    The number of voices in the pool
+     * @param block     The mixer block size in frames (a power of two)
+     *
+     * @return true if the mixer was successfully started.
+     */
+    static bool start(Uint32 voices=MIXER_VOICES, Uint32 block=MIXER_BLOCK_SIZE);
+
+    /**
+     * Stops the singleton mixer, releasing all resources.
+     *
+     * Once this method is called, the method get() will return nullptr.
+     * Calling the method multiple times (without calling stop) will have
+     * no effect.
+     */
+    static void stop();
+
+#pragma mark -
+#pragma mark Sound Management
+    /**
+     * Decodes the given sound asset into the PCM cache.
+     *
+     * The sound is converted to floating point samples at the output rate, so
+     * this can take some time for long sounds.  Sounds that are not prepared
+     * will be decoded the first time that they are played.  Hence you should
+     * prepare all of your sound effects once they are loaded.
+     *
+     * @param sound The sound asset
+     *
+     * @return true if the sound was successfully decoded.
+     */
+    bool prepare(const std::shared_ptr<Sound>& sound);
+
+    /**
+     * Removes the given sound asset from the PCM cache.
+     *
+     * Any voices playing this sound are stopped.  The memory is released
+     * once the audio thread is guaranteed to no longer reference it.
+     *
+     * @param sound The sound asset
+     */
+    void release(const std::shared_ptr<Sound>& sound);
+
+    /**
+     * Plays the given sound, returning its voice handle.
+     *
+     * This method never blocks on the audio thread.  The sound will start at
+     * the beginning of the next mixer block.  If the sound is not in the PCM
+     * cache, it is decoded first (see {@link prepare}).
+     *
+     * The priority is used when the voice pool is exhausted.  The voice with
+     * the lowest priority is stolen, provided that its priority is no more
+     * than the priority of this sound.  Otherwise this sound is dropped.
+     *
+     * @param sound     The sound asset to play
+     * @param priority  The voice priority
+     * @param loop      Whether to loop the sound continuously
+     * @param volume    The voice volume (< 0 to use asset default volume)
+     * @param pan       The stereo pan in [-1,1] (-1 is full left)
+     *
+     * @return the voice handle (0 if the sound could not be played)
+     */
+    Uint32 play(const std::shared_ptr<Sound>& sound, Sint32 priority=0, bool loop=false,
+                float volume=-1.0f, float pan=0.0f);
+
+    /**
+     * Returns true if the given voice is still playing.
+     *
+     * A voice that was just started, but not yet picked up by the audio
+     * thread, is considered to be playing.
+     *
+     * @param handle    The voice handle
+     *
+     * @return true if the given voice is still playing.
+     */
+    bool isPlaying(Uint32 handle) const;
+
+    /**
+     * Stops the given voice.
+     *
+     * The voice fades out over a single block to prevent clicks.  This
+     * method has no effect if the voice has already finished.
+     *
+     * @param handle    The voice handle
+     */
+    void stopVoice(Uint32 handle);
+
+    /**
+     * Stops every voice playing the given sound.
+     *
+     * @param sound The sound asset
+     */
+    void stopSound(const std::shared_ptr<Sound>& sound);
+
+    /**
+     * Stops every voice in the pool.
+     */
+    void stopAll();
+
+    /**
+     * Sets the volume of the given voice.
+     *
+     * The change is applied smoothly over the next block.
+     *
+     * @param handle    The voice handle
+     * @param volume    The voice volume in [0,1]
+     */
+    void setVolume(Uint32 handle, float volume);
+
+    /**
+     * Sets the stereo pan of the given voice.
+     *
+     * The change is applied smoothly over the next block.
+     *
+     * @param handle    The voice handle
+     * @param pan       The stereo pan in [-1,1] (-1 is full left)
+     */
+    void setPan(Uint32 handle, float pan);
+
+    /**
+     * Sets the master volume of the mixer.
+     *
+     * @param volume    The master volume in [0,1]
+     */
+    void setMasterVolume(float volume);
+
+    /**
+     * Pauses the mixer.
+     *
+     * All voices remain in place, and will continue when the mixer is resumed.
+     * You should call this method when the application is suspended.
+     */
+    void pause();
+
+    /**
+     * Resumes the mixer after a call to {@link pause}.
+     */
+    void resume();
+
+    /**
+     * Processes the notifications from the audio thread.
+     *
+     * This method calls the listener for every voice that has finished since
+     * the last call, as well as the music listener for finished tracks.  It
+     * also frees any PCM data released by {@link release}, and stops any
+     * replaced sounds whose stop command did not fit in the queue.  It should
+     * be called once an animation frame.
+     */
+    void update();
+
+    /**
+     * Sets the callback for finished voices
+     *
+     * This callback function is called whenever a voice completes.  It is
+     * called whether or not the sound completed normally or if it was stopped
+     * or stolen.  However, the second parameter can be used to distinguish
+     * the two cases.  The callback is always called in the main thread.
+     *
+     * @param callback The callback for finished voices
+     */
+    void setListener(std::function<void(Uint32,bool)> callback) {
+        _listener = callback;
+    }
+
+    /**
+     * Returns the callback for finished voices
+     *
+     * @return the callback for finished voices
+     */
+    std::function<void(Uint32,bool)> getListener() const {
+        return _listener;
+    }
+
+#pragma mark -
+#pragma mark Music Management
+    /**
+     * Plays the given music asset, crossfading from the current track.
+     *
+     * The music asset must be an Ogg Vorbis file.  It is decoded incrementally
+     * on a background thread, so memory use does not depend on the length of
+     * the track.  Only the first few thousand frames are decoded before this
+     * method returns.
+     *
+     * If fade is positive, the new track fades in over that many seconds
+     * while the current track (if any) fades out over the same period.  Both
+     * tracks are mixed during the fade.  If a previous crossfade is still in
+     * progress, the oldest track is dropped.
+     *
+     * Music is only supported on builds that define CU_MUSIC_STREAM (see
+     * {@link MusicStream}).  On other builds this method always fails.
+     *
+     * @param music     The music asset to play
+     * @param loop      Whether to loop the music continuously (gapless)
+     * @param volume    The music volume (< 0 to use asset default volume)
+     * @param fade      The number of seconds to crossfade
+     *
+     * @return true if the music started successfully
+     */
+    bool playMusic(const std::shared_ptr<Music>& music, bool loop=false, float volume=-1.0f, float fade=0.0f);
+
+    /**
+     * Returns the music asset currently playing
+     *
+     * If there is no active background music, this method returns nullptr.
+     * A track that is fading out is not considered active.
+     *
+     * @return the music asset currently playing
+     */
+    const Music* currentMusic() const;
+
+    /**
+     * Returns true if there is active background music.
+     *
+     * @return true if there is active background music.
+     */
+    bool isMusicPlaying() const;
+
+    /**
+     * Stops the current background music.
+     *
+     * If the argument is 0, it will halt the music immediately. Otherwise it
+     * will fade out over the given number of seconds.
+     *
+     * @param fade  The number of seconds to fade out
+     */
+    void stopMusic(float fade=0.0f);
+
+    /**
+     * Returns true if the background music is in a continuous loop.
+     *
+     * @return true if the background music is in a continuous loop.
+     */
+    bool isMusicLoop() const;
+
+    /**
+     * Sets whether the background music is on a continuous loop.
+     *
+     * @param loop  Whether the background music is on a continuous loop
+     */
+    void setMusicLoop(bool loop);
+
+    /**
+     * Sets the volume of the background music
+     *
+     * The change is applied smoothly over the next block.
+     *
+     * @param volume    The volume of the background music
+     */
+    void setMusicVolume(float volume);
+
+    /**
+     * Returns the length of background music, in seconds.
+     *
+     * If there is no active background music, this method will return 0.
+     *
+     * @return the length of background music, in seconds.
+     */
+    double getMusicDuration() const;
+
+    /**
+     * Returns the elapsed time of the background music, in seconds
+     *
+     * This is accurate to the last block handed to the audio device.  If there
+     * is no active background music, this method will return 0.
+     *
+     * @return the elapsed time of the background music, in seconds
+     */
+    double getMusicElapsed() const;
+
+    /**
+     * Sets the elapsed time of the background music, in seconds
+     *
+     * The seek is performed by the decoder thread, so it will take effect
+     * within a few milliseconds.
+     *
+     * @param time  The new position of the background music
+     */
+    void setMusicElapsed(double time);
+
+    /**
+     * Sets the callback for background music
+     *
+     * This callback function is called whenever a music track completes.  It
+     * is called whether or not the music completed normally or if it was
+     * stopped or replaced.  However, the second parameter can be used to
+     * distinguish the two cases.  The callback is always called in the main
+     * thread.
+     *
+     * @param callback The callback for background music
+     */
+    void setMusicListener(std::function<void(Music*,bool)> callback) {
+        _musicCB = callback;
+    }
+
+    /**
+     * Returns the callback for background music
+     *
+     * @return the callback for background music
+     */
+    std::function<void(Music*,bool)> getMusicListener() const {
+        return _musicCB;
+    }
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the output sample rate
+     *
+     * @return the output sample rate
+     */
+    Uint32 getSampleRate() const { return _rate; }
+
+    /**
+     * Returns the mixer block size in frames
+     *
+     * @return the mixer block size in frames
+     */
+    Uint32 getBlockSize() const { return _block; }
+
+    /**
+     * Returns true if the mixer is attached to the SDL mixer.
+     *
+     * In that case the mixer does not have its own audio device, and the
+     * latency is determined by the block size of the SDL mixer.
+     *
+     * @return true if the mixer is attached to the SDL mixer.
+     */
+    bool isAttached() const { return _device == 0; }
+
+    /**
+     * Returns the output latency of the mixer in seconds.
+     *
+     * This is the duration of a single mixer block, which is the longest that
+     * a sound can wait before it is mixed.  The audio driver may add latency
+     * on top of this.
+     *
+     * @return the output latency of the mixer in seconds.
+     */
+    double getLatency() const;
+
+    /**
+     * Returns the average time to mix a single block, in seconds.
+     *
+     * This is the CPU cost of the audio callback, including command processing.
+     *
+     * @return the average time to mix a single block, in seconds.
+     */
+    double getMixCost() const;
+
+    /**
+     * Returns the longest time to mix a single block, in seconds.
+     *
+     * @return the longest time to mix a single block, in seconds.
+     */
+    double getPeakMixCost() const;
+
+    /**
+     * Returns the average fraction of the block duration spent mixing.
+     *
+     * A value close to 1 means that the mixer is in danger of underflowing.
+     *
+     * @return the average fraction of the block duration spent mixing.
+     */
+    double getMixLoad() const { return getMixCost()/getLatency(); }
+
+    /**
+     * Returns the average delay between a call to play and the audio thread.
+     *
+     * This is the time that a sound waits in the command queue before it
+     * is mixed.  The time to sound is this delay plus the output latency.
+     *
+     * @return the average delay between a call to play and the audio thread.
+     */
+    double getDispatchDelay() const;
+
+    /**
+     * Returns the number of blocks mixed since the last reset.
+     *
+     * @return the number of blocks mixed since the last reset.
+     */
+    Uint64 getBlocks() const { return _mixCount.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of voices stolen since the last reset.
+     *
+     * @return the number of voices stolen since the last reset.
+     */
+    Uint32 getSteals() const { return _steals.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of play requests dropped since the last reset.
+     *
+     * A request is dropped if every voice has a higher priority, or if the
+     * command queue is full.
+     *
+     * @return the number of play requests dropped since the last reset.
+     */
+    Uint32 getDrops() const { return _drops.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns the number of voices active at the end of the last block.
+     *
+     * @return the number of voices active at the end of the last block.
+     */
+    Uint32 getActiveVoices() const { return _active.load(std::memory_order_relaxed); }
+
+    /**
+     * Resets the mixer statistics.
+     */
+    void resetStats();
+};
+
+}
+
+#endif /* __CU_SOUND_MIXER_H__ */
@@ -31,5 +31,7 @@
 #include "CUSound.h"
 #include "CUMusic.h"
 #include "CUAudioEngine.h"
+#include "CUMusicStream.h"
+#include "CUSoundMixer.h"
 
 #endif /* __CU_AUDIO_PKG_H__ */
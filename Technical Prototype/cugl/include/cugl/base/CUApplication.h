@@ -181,6 +181,15 @@ private:
     /** The SDL timestamp for the end of an animation frame */
     Uint32 _finish;
     
+    /** Whether input is dispatched as it arrives between frames */
+    bool _immediate;
+    /** Whether an input has been marked for a response this frame */
+    bool _marked;
+    /** The earliest input marked for a response this frame */
+    Timestamp _marktime;
+    /** A window of recent input latencies (in milliseconds) */
+    std::deque<float> _latencywindow;
+    
     /** Counter to assign unique keys to callbacks */
     Uint32 _funcid;
     
@@ -199,6 +208,24 @@ private:
      */
     void processCallbacks(Uint32 millis);
     
+    /**
+     * Processes a single SDL event, sending it to the input devices.
+     *
+     * This method also reacts to any change in the application state.
+     *
+     * @param event The event to process
+     *
+     * @return false if the event indicates that the application should quit.
+     */
+    bool dispatchEvent(const SDL_Event& event);
+    
+    /**
+     * Records the latency of the input marked this frame, if any.
+     *
+     * This method is called when the frame has been presented.
+     */
+    void recordLatency();
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -349,6 +376,10 @@ public:
      * is called.  As it sends all of its information to the appropriate
      * handlers, you should never need to override this method.
      *
+     * With {@link setImmediateInput}, any input that arrived while the previous
+     * frame was sleeping has already been dispatched.  This method only gathers
+     * the input that remains.
+     *
      * @return false if the input indicates that the application should quit.
      */
     bool getInput();
@@ -705,6 +736,72 @@ public:
      */
     float getAverageFPS() const;
     
+    /**
+     * Sets whether input is dispatched as soon as it arrives.
+     *
+     * Normally, the application sleeps at the end of each animation frame,
+     * and input that arrives in the meantime waits for the start of the next
+     * frame.  With immediate input, the application instead dispatches that
+     * input to the listeners while it waits.  The input still belongs to the
+     * next frame, but any work done by the listeners (such as classifying
+     * gestures) is finished before that frame starts.
+     *
+     * By default, this value is false.
+     *
+     * @param value Whether input is dispatched as soon as it arrives
+     */
+    void setImmediateInput(bool value) { _immediate = value; }
+    
+    /**
+     * Returns true if input is dispatched as soon as it arrives.
+     *
+     * Normally, the application sleeps at the end of each animation frame,
+     * and input that arrives in the meantime waits for the start of the next
+     * frame.  With immediate input, the application instead dispatches that
+     * input to the listeners while it waits.  The input still belongs to the
+     * next frame, but any work done by the listeners (such as classifying
+     * gestures) is finished before that frame starts.
+     *
+     * By default, this value is false.
+     *
+     * @return true if input is dispatched as soon as it arrives
+     */
+    bool isImmediateInput() const { return _immediate; }
+    
+    /**
+     * Marks an input event whose response is drawn in the current frame.
+     *
+     * When the frame is presented, the time from the event to the present is
+     * recorded as an input latency.  If several events are marked in the same
+     * frame, only the earliest one counts.  Use the event timestamp (such as
+     * {@link TouchEvent#timestamp}) so that the time spent waiting for the
+     * frame is included.
+     *
+     * The measurement ends when the buffer swap returns.  The display may
+     * take up to one more refresh to show the frame.
+     *
+     * @param stamp The timestamp of the input event
+     */
+    void markLatency(const Timestamp& stamp);
+    
+    /**
+     * Returns the average input latency over the last 30 marked inputs.
+     *
+     * The value is in milliseconds.  It is 0 if no inputs were marked.
+     *
+     * @return the average input latency over the last 30 marked inputs.
+     */
+    float getAverageLatency() const;
+    
+    /**
+     * Returns the maximum input latency over the last 30 marked inputs.
+     *
+     * The value is in milliseconds.  It is 0 if no inputs were marked.
+     *
+     * @return the maximum input latency over the last 30 marked inputs.
+     */
+    float getMaximumLatency() const;
+    
     /**
      * Sets the clear color of this application
      *
@@ -9,6 +9,11 @@
 //  All of the functions in this header are idempotent. To decode a previously
 //  encoded piece of data, use the function again.
 //
+//  The array versions of these functions are not inline.  They encode a whole
+//  block of values at once, using vector instructions where the platform has
+//  them.  They are used by BinaryReader and BinaryWriter for bulk I/O.
+//
+//
 //  CUGL zlib License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -37,6 +42,7 @@
 
 namespace cugl {
 
+#pragma mark Value Encoding
 /**
  * Returns the given value encoded in network order
  *
@@ -219,5 +225,176 @@ SDL_FORCE_INLINE double marshall(double value) {
 #endif
 }
 
+
+#pragma mark -
+#pragma mark Array Encoding
+/**
+ * Encodes an array of 16-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Sint16* dst, const Sint16* src, size_t count);
+
+/**
+ * Encodes an array of 16-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Uint16* dst, const Uint16* src, size_t count);
+
+/**
+ * Encodes an array of 32-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Sint32* dst, const Sint32* src, size_t count);
+
+/**
+ * Encodes an array of 32-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Uint32* dst, const Uint32* src, size_t count);
+
+/**
+ * Encodes an array of 64-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Sint64* dst, const Sint64* src, size_t count);
+
+/**
+ * Encodes an array of 64-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(Uint64* dst, const Uint64* src, size_t count);
+
+/**
+ * Encodes an array of floats in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(float* dst, const float* src, size_t count);
+
+/**
+ * Encodes an array of doubles in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void marshall(double* dst, const double* src, size_t count);
+
 }
 #endif /* __CU_ENDIAN_H__ */
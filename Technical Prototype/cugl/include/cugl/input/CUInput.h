@@ -95,7 +95,7 @@ protected:
     /**
      * Creates an uninitialized instance of the Input dispatcher.
      */
-    Input()  {}
+    Input() : _roffset(SDL_GetTicks()) {}
     
     /**
      * Destroys the Input dispatcher, releasing any remaining devices.
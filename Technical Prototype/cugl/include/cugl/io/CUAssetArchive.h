@@ -0,0 +1,388 @@
+//
+//  CUAssetArchive.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides read access to a packed asset archive.  An archive is
+//  a single file that concatenates the files of an asset directory, together
+//  with an index of their paths.  Opening one archive (instead of hundreds of
+//  loose files) is much faster on platforms like Android, where every file is
+//  opened through the APK asset manager.
+//
+//  Where possible, the archive is memory mapped, and entries are returned as
+//  read-only SDL_RWops views into the mapping.  Entries may also be stored
+//  with LZ4 compression, in which case they are decompressed when opened.
+//  Archives are built offline with the assetpack tool.
+//
+//  Archives can be mounted, so that the asset loaders find files in them
+//  first.  The loaders open all of their files with the static method
+//  AssetArchive::openFile, which checks the mounted archives before falling
+//  back to the file system.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_ASSET_ARCHIVE_H__
+#define __CU_ASSET_ARCHIVE_H__
+#include <cugl/base/CUBase.h>
+#include <SDL/SDL.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+/** The four character code at the start of every archive */
+#define ARCHIVE_MAGIC       0x4B505543  // "CUPK" in little endian
+/** The archive format version */
+#define ARCHIVE_VERSION     1
+/** The size of the archive header in bytes */
+#define ARCHIVE_HEADER_SIZE 32
+/** The entry flag for LZ4 compressed data */
+#define ARCHIVE_LZ4         0x0001
+
+namespace cugl {
+
+#pragma mark -
+#pragma mark Asset Archive
+/**
+ * This class provides read access to a packed asset archive.
+ *
+ * An archive is laid out as a 32 byte header, an index of 32 byte entries
+ * (sorted by the hash of their paths), a table of the entry paths, and then
+ * the entry data.  All values are little endian.  Uncompressed entries are
+ * aligned in the file, so that views into a memory mapping are aligned too.
+ *
+ * Paths are relative to the root of the archive (by default, the asset
+ * directory) and always use forward slashes.  When looking up an entry, the
+ * root is stripped from the path and any backslashes are converted, so that
+ * the absolute paths built by the asset loaders can be used as is.
+ *
+ * An archive is memory mapped whenever the platform allows it.  On Android
+ * the archive lives inside the APK, so it is read into memory with a single
+ * read instead.  In either case opening an uncompressed entry does not copy
+ * any data.  The returned SDL_RWops simply points into the archive.  Hence
+ * the archive must outlive any streams opened from it (for example, the
+ * stream of a font).
+ *
+ * This class is safe to use from multiple threads once it is initialized.
+ */
+class AssetArchive {
+private:
+    /** This macro disables the copy constructor (not allowed on archives) */
+    CU_DISALLOW_COPY_AND_ASSIGN(AssetArchive);
+
+    /** An entry in the archive index (exactly as it is stored in the file) */
+    struct Entry {
+        /** The FNV-1a hash of the entry path */
+        Uint64 hash;
+        /** The offset of the entry data in the file */
+        Uint64 offset;
+        /** The size of the stored data in bytes */
+        Uint32 size;
+        /** The size of the original file in bytes */
+        Uint32 length;
+        /** The offset of the entry path in the path table */
+        Uint32 name;
+        /** The length of the entry path in bytes */
+        Uint16 namelen;
+        /** The entry flags (e.g. ARCHIVE_LZ4) */
+        Uint16 flags;
+    };
+    static_assert(sizeof(Entry) == 32, "Archive entries must be 32 bytes");
+
+    /** The path to the archive file */
+    std::string _path;
+    /** The directory prefix stripped from lookup paths */
+    std::string _root;
+    /** The archive contents */
+    const Uint8* _data;
+    /** The size of the archive in bytes */
+    size_t _size;
+    /** Whether the contents are memory mapped (as opposed to allocated) */
+    bool _mapped;
+
+    /** The archive index (a view into the contents) */
+    const Entry* _index;
+    /** The number of entries in the index */
+    Uint32 _count;
+    /** The path table (a view into the contents) */
+    const char* _names;
+
+    /** The mounted archives, in search order */
+    static std::vector<std::shared_ptr<AssetArchive>> _gMounted;
+    /** The lock protecting the mounted archives */
+    static std::mutex _gMountLock;
+
+#pragma mark -
+#pragma mark Internal Helpers
+    /**
+     * Returns true if the contents were memory mapped from the given file.
+     *
+     * This method returns false (without an error) if the platform does not
+     * support memory mapping, or the file is not a regular file.
+     *
+     * @param file  The absolute path to the archive
+     *
+     * @return true if the contents were memory mapped from the given file.
+     */
+    bool map(const std::string& file);
+
+    /**
+     * Returns true if the contents were read from the given file.
+     *
+     * The contents are read into memory with a single read.
+     *
+     * @param file  The absolute path to the archive
+     *
+     * @return true if the contents were read from the given file.
+     */
+    bool load(const std::string& file);
+
+    /**
+     * Returns true if the archive contents have a valid header and index.
+     *
+     * @return true if the archive contents have a valid header and index.
+     */
+    bool validate();
+
+    /**
+     * Returns the index entry for the given path (or nullptr if none)
+     *
+     * @param path  The path to look up
+     *
+     * @return the index entry for the given path (or nullptr if none)
+     */
+    const Entry* find(const std::string& path) const;
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an unopened archive.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    AssetArchive();
+
+    /**
+     * Deletes this archive, releasing all resources.
+     */
+    ~AssetArchive() { dispose(); }
+
+    /**
+     * Releases the contents of this archive.
+     *
+     * Any streams opened from this archive are invalid after this call.
+     */
+    void dispose();
+
+    /**
+     * Initializes an archive from the given file.
+     *
+     * The root is the directory prefix that is removed from paths before
+     * they are looked up in the archive.  It should end in a path separator.
+     *
+     * This method fails (without an error) if the file does not exist.  It
+     * fails with an error if the file is not a valid archive.
+     *
+     * @param file  The path to the archive
+     * @param root  The directory prefix for entry paths
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::string& file, const std::string& root);
+
+    /**
+     * Initializes an archive from the given file in the asset directory.
+     *
+     * The entries of the archive are relative to the asset directory.  This
+     * method fails (without an error) if the file does not exist.  It fails
+     * with an error if the file is not a valid archive.
+     *
+     * @param file  The path to the archive, relative to the asset directory
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithAsset(const std::string& file);
+
+    /**
+     * Returns a newly allocated archive from the given file.
+     *
+     * The root is the directory prefix that is removed from paths before
+     * they are looked up in the archive.  It should end in a path separator.
+     *
+     * This method fails (without an error) if the file does not exist.  It
+     * fails with an error if the file is not a valid archive.
+     *
+     * @param file  The path to the archive
+     * @param root  The directory prefix for entry paths
+     *
+     * @return a newly allocated archive from the given file.
+     */
+    static std::shared_ptr<AssetArchive> alloc(const std::string& file, const std::string& root) {
+        std::shared_ptr<AssetArchive> result = std::make_shared<AssetArchive>();
+        return (result->init(file,root) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated archive from the given file in the asset directory.
+     *
+     * The entries of the archive are relative to the asset directory.  This
+     * method fails (without an error) if the file does not exist.  It fails
+     * with an error if the file is not a valid archive.
+     *
+     * @param file  The path to the archive, relative to the asset directory
+     *
+     * @return a newly allocated archive from the given file in the asset directory.
+     */
+    static std::shared_ptr<AssetArchive> allocWithAsset(const std::string& file) {
+        std::shared_ptr<AssetArchive> result = std::make_shared<AssetArchive>();
+        return (result->initWithAsset(file) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the path to the archive file.
+     *
+     * @return the path to the archive file.
+     */
+    const std::string& getPath() const { return _path; }
+
+    /**
+     * Returns the directory prefix for entry paths.
+     *
+     * @return the directory prefix for entry paths.
+     */
+    const std::string& getRoot() const { return _root; }
+
+    /**
+     * Returns the number of entries in this archive.
+     *
+     * @return the number of entries in this archive.
+     */
+    Uint32 getEntryCount() const { return _count; }
+
+    /**
+     * Returns true if this archive is memory mapped.
+     *
+     * @return true if this archive is memory mapped.
+     */
+    bool isMapped() const { return _mapped; }
+
+    /**
+     * Returns the paths of all of the entries in this archive.
+     *
+     * The paths are relative to the archive root.
+     *
+     * @return the paths of all of the entries in this archive.
+     */
+    std::vector<std::string> getEntries() const;
+
+#pragma mark -
+#pragma mark Entry Access
+    /**
+     * Returns true if this archive has an entry for the given path.
+     *
+     * The path may be absolute, provided that it starts with the archive root.
+     *
+     * @param path  The path to look up
+     *
+     * @return true if this archive has an entry for the given path.
+     */
+    bool contains(const std::string& path) const {
+        return find(path) != nullptr;
+    }
+
+    /**
+     * Returns a read-only stream for the given entry (or nullptr if none).
+     *
+     * The path may be absolute, provided that it starts with the archive root.
+     * If the entry is uncompressed, the stream is a view into the archive
+     * and does not copy any data.  Otherwise, the entry is decompressed into
+     * a buffer that is freed when the stream is closed.
+     *
+     * The caller owns the stream and must close it with SDL_RWclose.
+     *
+     * @param path  The path to look up
+     *
+     * @return a read-only stream for the given entry (or nullptr if none).
+     */
+    SDL_RWops* open(const std::string& path) const;
+
+#pragma mark -
+#pragma mark Mounting
+    /**
+     * Mounts the given archive so that {@link openFile} can find its entries.
+     *
+     * Archives mounted later are searched first.  Mounting an archive that
+     * is already mounted has no effect.
+     *
+     * @param archive   The archive to mount
+     */
+    static void mount(const std::shared_ptr<AssetArchive>& archive);
+
+    /**
+     * Unmounts the given archive.
+     *
+     * Any streams opened from this archive remain valid as long as there are
+     * other references to the archive.
+     *
+     * @param archive   The archive to unmount
+     */
+    static void unmount(const std::shared_ptr<AssetArchive>& archive);
+
+    /**
+     * Unmounts all archives.
+     */
+    static void unmountAll();
+
+    /**
+     * Returns a stream for the given file, using the mounted archives.
+     *
+     * If the mode is a read-only mode ("r" or "rb"), this method first
+     * searches the mounted archives for the file.  If it is not found, or if
+     * the mode allows writing, this method falls back to SDL_RWFromFile.
+     * This is the method that the asset loaders use to open their files.
+     *
+     * The caller owns the stream and must close it with SDL_RWclose.
+     *
+     * @param file  The path to the file
+     * @param mode  The file mode (as in fopen)
+     *
+     * @return a stream for the given file, using the mounted archives.
+     */
+    static SDL_RWops* openFile(const std::string& file, const char* mode);
+};
+
+}
+#endif /* __CU_ASSET_ARCHIVE_H__ */
@@ -76,6 +76,12 @@ namespace cugl {
  * for the file name.  Keep in mind that absolute paths are very dangerous on
  * mobile devices, because they do not have proper file systems.  You should
  * confine all files to either the asset or the save directory.
+ *
+ * The array reads are much faster than a loop of single element reads.  They
+ * decode a whole block of values at once, and they read straight into the
+ * array (bypassing the buffer) when the request is larger than the buffer
+ * capacity.  For data that needs no decoding, {@link readView} gives access
+ * to the buffer without any copy at all.
  */
 class BinaryReader {
 protected:
@@ -109,6 +115,28 @@ protected:
      */
     void fill(unsigned int bytes=1);
     
+    /**
+     * Reads a sequence of elements of the given size from the stream.
+     *
+     * The function will attempt to read up to maximum number of elements.
+     * It will return the actual number of elements read (which may be 0).
+     * Only whole elements are read.
+     *
+     * If swap is true, each element is marshalled from network order.  This
+     * is done one block at a time, as the data is copied out of the buffer.
+     * If the buffer is empty and the request is at least the buffer capacity,
+     * the elements are read directly into the array instead, and marshalled
+     * in place.
+     *
+     * @param buffer    The array to store the data when read
+     * @param maximum   The maximum number of elements to read from the stream
+     * @param size      The size of each element in bytes
+     * @param swap      Whether to marshall the elements from network order
+     *
+     * @return the number of elements read from the stream
+     */
+    size_t readArray(Uint8* buffer, size_t maximum, unsigned int size, bool swap);
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -744,6 +772,27 @@ public:
      * @return the number of doubles read from the stream
      */
     size_t read(double* buffer, size_t maximum, size_t offset=0);
+
+#pragma mark -
+#pragma mark Buffer Views
+    /**
+     * Returns a view of the next bytes in the stream, without copying them.
+     *
+     * The view is a pointer into the internal buffer of this reader, and the
+     * stream advances past the bytes viewed.  The bytes are raw, and so any
+     * multibyte values are still in network order.  Use the array versions
+     * of {@link marshall} to decode them.
+     *
+     * The view is only valid until the next read (or reset) of this stream.
+     * This method returns nullptr, without advancing the stream, if there are
+     * fewer than the given number of bytes remaining, or if the number of
+     * bytes exceeds the buffer capacity.
+     *
+     * @param bytes The number of bytes to view
+     *
+     * @return a view of the next bytes in the stream
+     */
+    const Uint8* readView(size_t bytes);
 };
 
 }
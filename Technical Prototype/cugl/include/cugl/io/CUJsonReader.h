@@ -280,13 +280,20 @@ public:
 
     /**
      * Returns a newly allocated JsonValue for the next available JSON string.
-     * 
-     * This method uses {@link readJsonString()} to extract the next available
-     * JSON string and constructs a JsonValue from that.
+     *
+     * A JSON string is defined to be any string within matching braces {}. This
+     * method will skip over any whitespace to find the first brace.  If the
+     * first non-whitespace character is not a brace, this method will fail.
+     *
+     * The remainder of the file is read into memory with a single read, and
+     * the JsonValue is parsed in place from that buffer.  There is no
+     * intermediate string or cJSON tree.  The read head is left just after
+     * the closing brace.
      *
      * If there is a parsing error, this  method will return nullptr.  Detailed
      * information about the parsing error will be passed to an assert.  Hence
-     * error messages are suppressed if asserts are turned off.
+     * error messages are suppressed if asserts are turned off.  In that case
+     * the remainder of the stream is discarded.
      *
      * @return a newly allocated JsonValue for the next available JSON string.
      */
@@ -101,6 +101,15 @@ protected:
      * to read from the file in predefined chunks.
      */
     void fill();
+
+    /**
+     * Reads the remainder of the stream into the storage buffer
+     *
+     * If the size of the stream is known, the data is read directly into the
+     * storage buffer with a single read.  Afterwards, the stream is exhausted
+     * and all unread data is available in the storage buffer.
+     */
+    void fillAll();
     
 #pragma mark -
 #pragma mark Constructors
@@ -84,6 +84,17 @@ protected:
     /** The current offset in the writer buffer */
     Sint32      _bufoff;
     
+    /**
+     * Writes a number to the file without allocating a string.
+     *
+     * @param n  the number to write
+     */
+    template <typename T>
+    void writeNumber(T n) {
+        char buffer[CU_NUMBER_BUFFER];
+        write(buffer, cugl::to_chars(buffer, buffer+CU_NUMBER_BUFFER, n)-buffer);
+    }
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -379,7 +390,7 @@ public:
      *
      * @param b  the byte value to write
      */
-    void write(Uint8 b)                 { write(cugl::to_string(b)); }
+    void write(Uint8 b)                 { writeNumber(b); }
 
     /**
      * Writes a signed 16 bit integer to the file.
@@ -390,7 +401,7 @@ public:
      *
      * @param n  the signed 16 bit integer to write
      */
-    void write(Sint16 n)                { write(cugl::to_string(n)); }
+    void write(Sint16 n)                { writeNumber(n); }
 
     /**
      * Writes a unsigned 16 bit integer to the file.
@@ -401,7 +412,7 @@ public:
      *
      * @param n  the unsigned 16 bit integer to write
      */
-    void write(Uint16 n)                { write(cugl::to_string(n)); }
+    void write(Uint16 n)                { writeNumber(n); }
     
     /**
      * Writes a signed 32 bit integer to the file.
@@ -412,7 +423,7 @@ public:
      *
      * @param n  the signed 32 bit integer to write
      */
-    void write(Sint32 n)                { write(cugl::to_string(n)); }
+    void write(Sint32 n)                { writeNumber(n); }
     
     /**
      * Writes a unsigned 32 bit integer to the file.
@@ -423,7 +434,7 @@ public:
      *
      * @param n  the unsigned 32 bit integer to write
      */
-    void write(Uint32 n)                { write(cugl::to_string(n)); }
+    void write(Uint32 n)                { writeNumber(n); }
 
     /**
      * Writes a signed 64 bit integer to the file.
@@ -434,7 +445,7 @@ public:
      *
      * @param n  the signed 64 bit integer to write
      */
-    void write(Sint64 n)                { write(cugl::to_string(n)); }
+    void write(Sint64 n)                { writeNumber(n); }
     
     /**
      * Writes a unsigned 64 bit integer to the file.
@@ -445,7 +456,7 @@ public:
      *
      * @param n  the unsigned 64 bit integer to write
      */
-    void write(Uint64 n)                { write(cugl::to_string(n)); }
+    void write(Uint64 n)                { writeNumber(n); }
     
     /**
      * Writes a boolean value to the file.
@@ -465,7 +476,8 @@ public:
     /**
      * Writes a float value to the file.
      *
-     * The value will be written with full precision.
+     * The value will be written with full precision, using (nearly always)
+     * the fewest digits that read back as the same float.
      *
      * The value is written to the internal buffer, but is not necessarily
      * flushed automatically.  It will be written when the buffer reaches
@@ -473,12 +485,13 @@ public:
      *
      * @param n  the float value to write
      */
-    void write(float n)                 { write(cugl::to_string(n)); }
+    void write(float n)                 { writeNumber(n); write('f'); }
 
     /**
      * Writes a double value to the file.
      *
-     * The value will be written with full precision.
+     * The value will be written with full precision, using (nearly always)
+     * the fewest digits that read back as the same double.
      *
      * The value is written to the internal buffer, but is not necessarily
      * flushed automatically.  It will be written when the buffer reaches
@@ -486,7 +499,7 @@ public:
      *
      * @param n  the double value to write
      */
-    void write(double n)                { write(cugl::to_string(n)); }
+    void write(double n)                { writeNumber(n); }
 
     
 #pragma mark -
@@ -513,6 +526,18 @@ public:
      */
     void write(const std::string& s);
     
+    /**
+     * Writes the first length characters of a string (ASCII or UTF8) to the file
+     *
+     * The value is written to the internal buffer, but is not necessarily
+     * flushed automatically.  It will be written when the buffer reaches
+     * capacity or the file is closed.
+     *
+     * @param s         the string to write
+     * @param length    the number of characters to write
+     */
+    void write(const char* s, size_t length);
+    
     /**
      * Writes a string (ASCII or UTF8) to the file, followed by a newline
      *
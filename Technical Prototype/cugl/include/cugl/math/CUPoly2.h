@@ -90,9 +90,9 @@ class Affine2;
  * {@link SimpleTriangulator}: This is a simple earclipping-triangulator for
  * tesselating simple, solid polygons (e.g. no holes or self-intersections).
  *
- * {@link ComplexTriangulator}: This is a wrapper for the advanced Poly2Tri 
- * triangulator.  This triangulator can tesselate complex solid polygons (e.g. 
- * those with holes or self-intersections).
+ * {@link ComplexTriangulator}: This is a sweep-line triangulator for solid
+ * polygons with holes.  It runs in O(n log n) time, and it can optionally
+ * produce a constrained Delaunay triangulation.
  * 
  * {@link PathOutliner}: This is a tool is used to generate indices for a
  * path polygon.  It has several options, that allow it to make useful 
@@ -1250,6 +1250,7 @@ private:
     // Make friends with the factory classes
     friend class CubicSplineApproximator;
     friend class SimpleTriangulator;
+    friend class ComplexTriangulator;
     friend class PathOutliner;
     friend class PathExtruder;
 };
@@ -0,0 +1,468 @@
+//
+//  CUComplexTriangulator.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a factory for a sweep-line triangulator.  Unlike the ear
+//  clipping SimpleTriangulator, it supports polygons with holes, and it runs
+//  in O(n log n) time.  It splits the polygon into y-monotone pieces with a
+//  plane sweep, and then triangulates each piece in linear time.  It can also
+//  refine the result into a constrained Delaunay triangulation, which avoids
+//  long thin triangles.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_COMPLEX_TRIANGULATOR_H__
+#define __CU_COMPLEX_TRIANGULATOR_H__
+
+#include "../CUPoly2.h"
+#include "../CUVec2.h"
+#include "../../util/CUDebug.h"
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a factory for producing solid Poly2 objects from a set of vertices.
+ *
+ * This triangulator accepts a simple outer boundary together with any number
+ * of holes.  The holes must lie inside of the boundary, and no two loops may
+ * intersect.  Neither loop orientation matters.  The vertices of the holes
+ * are appended to the vertices of the boundary, in the order that the holes
+ * were added, and the indices refer to that combined list.
+ *
+ * The triangulation is computed with a plane sweep that partitions the polygon
+ * into y-monotone pieces, each of which is triangulated in linear time.  The
+ * entire calculation is O(n log n), which makes it suitable for polygons with
+ * many thousands of vertices, where ear clipping is quadratic.  Optionally,
+ * the triangulation can be refined by edge flips into a constrained Delaunay
+ * triangulation.  This maximizes the minimum angle without changing the
+ * boundary.
+ *
+ * The calculation supports any number of vertices.  However, Poly2 indices
+ * are unsigned shorts, and so the materialization methods require that there
+ * are at most 65536 vertices.
+ *
+ * As with all factories, the methods are broken up into three phases:
+ * initialization, calculation, and materialization.  To use the factory, you
+ * first set the data (in this case a set of vertices or another Poly2) with the
+ * initialization methods.  You then call the calculation method.  Finally,
+ * you use the materialization methods to access the data in several different
+ * ways.
+ *
+ * This division allows us to support multithreaded calculation if the data
+ * generation takes too long.  However, note that this factory is not thread
+ * safe in that you cannot access data while it is still in mid-calculation.
+ */
+class ComplexTriangulator {
+#pragma mark Values
+private:
+    /**
+     * Enumeration of vertex types (for the plane sweep)
+     *
+     * A vertex is classified by the position of its neighbors relative to the
+     * sweep line, and by the interior angle at the vertex.
+     */
+    enum class VertexType {
+        /** Both neighbors are below, and the interior angle is convex */
+        START,
+        /** Both neighbors are below, and the interior angle is reflex */
+        SPLIT,
+        /** Both neighbors are above, and the interior angle is convex */
+        END,
+        /** Both neighbors are above, and the interior angle is reflex */
+        MERGE,
+        /** One neighbor is above and the other is below */
+        REGULAR
+    };
+
+    /** A diagonal or boundary edge leaving a vertex during face tracing */
+    struct Link {
+        /** The vertex at the other end of the edge */
+        Uint32 vertex;
+        /** Whether the edge has been traced in this direction */
+        bool traced;
+    };
+
+    /** Comparator ordering the sweep status by x-coordinate at the sweep line */
+    struct EdgeOrder {
+        /** The triangulator owning the edges */
+        const ComplexTriangulator* owner;
+        /**
+         * Returns true if edge a is left of edge b at the current sweep line.
+         *
+         * The index -1 represents the current sweep point.
+         *
+         * @param a The first edge
+         * @param b The second edge
+         *
+         * @return true if edge a is left of edge b at the current sweep line.
+         */
+        bool operator()(int a, int b) const;
+    };
+
+    /** The set of vertices to use in the calculation (boundary, then holes) */
+    std::vector<Vec2> _input;
+    /** The number of vertices in each loop (boundary, then holes) */
+    std::vector<Uint32> _loops;
+    /** The next vertex in each loop, with the interior on the left */
+    std::vector<Uint32> _next;
+    /** The previous vertex in each loop, with the interior on the left */
+    std::vector<Uint32> _prev;
+    /** The diagonals (and traced boundary edges) leaving each vertex */
+    std::vector<std::vector<Link>> _links;
+    /** The output results of the triangulation */
+    std::vector<Uint32> _output;
+    /** The current sweep point */
+    Vec2 _sweep;
+    /** Whether to refine the result into a Delaunay triangulation */
+    bool _delaunay;
+    /** Whether or not the calculation has been run */
+    bool _calculated;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a triangulator with no vertex data.
+     */
+    ComplexTriangulator() : _delaunay(false), _calculated(false) {}
+
+    /**
+     * Creates a triangulator with the given boundary.
+     *
+     * The vertex data is copied.  The triangulator does not retain any
+     * references to the original data.
+     *
+     * @param points    The boundary vertices
+     */
+    ComplexTriangulator(const std::vector<Vec2>& points) : _delaunay(false), _calculated(false) {
+        set(points);
+    }
+
+    /**
+     * Creates a triangulator with the given boundary.
+     *
+     * The triangulator only uses the vertex data from the polygon.  It ignores
+     * any existing indices.
+     *
+     * The vertex data is copied.  The triangulator does not retain any
+     * references to the original data.
+     *
+     * @param poly      The boundary vertices
+     */
+    ComplexTriangulator(const Poly2& poly) : _delaunay(false), _calculated(false) {
+        set(poly._vertices);
+    }
+
+    /**
+     * Deletes this triangulator, releasing all resources.
+     */
+    ~ComplexTriangulator() {}
+
+#pragma mark -
+#pragma mark Initialization
+    /**
+     * Sets the boundary for this triangulator.
+     *
+     * The triangulator only uses the vertex data from the polygon.  It ignores
+     * any existing indices.  This method removes any holes.
+     *
+     * The vertex data is copied.  The triangulator does not retain any
+     * references to the original data.
+     *
+     * This method resets all interal data.  You will need to reperform the
+     * calculation before accessing data.
+     *
+     * @param poly      The boundary vertices
+     */
+    void set(const Poly2& poly) {
+        set(poly._vertices);
+    }
+
+    /**
+     * Sets the boundary for this triangulator.
+     *
+     * This method removes any holes.
+     *
+     * The vertex data is copied.  The triangulator does not retain any
+     * references to the original data.
+     *
+     * This method resets all interal data.  You will need to reperform the
+     * calculation before accessing data.
+     *
+     * @param points    The boundary vertices
+     */
+    void set(const std::vector<Vec2>& points) {
+        clear();
+        _input = points;
+        _loops.push_back((Uint32)points.size());
+    }
+
+    /**
+     * Adds a hole to this triangulator.
+     *
+     * The hole vertices are appended to the existing vertices.  The hole must
+     * lie inside of the boundary, and it may not intersect the boundary or
+     * any other hole.
+     *
+     * The vertex data is copied.  The triangulator does not retain any
+     * references to the original data.
+     *
+     * This method resets all interal data.  You will need to reperform the
+     * calculation before accessing data.
+     *
+     * @param points    The hole vertices
+     */
+    void addHole(const std::vector<Vec2>& points) {
+        CUAssertLog(!_loops.empty(), "The boundary must be set before any holes");
+        reset();
+        _input.insert(_input.end(), points.begin(), points.end());
+        _loops.push_back((Uint32)points.size());
+    }
+
+    /**
+     * Sets whether to refine the triangulation into a Delaunay triangulation.
+     *
+     * The refinement flips interior edges until no vertex lies inside of the
+     * circumcircle of an adjacent triangle.  The boundary edges are never
+     * flipped.  This takes more time, but it avoids long thin triangles.
+     *
+     * This method resets all interal data.  You will need to reperform the
+     * calculation before accessing data.
+     *
+     * @param delaunay  Whether to refine the triangulation
+     */
+    void setDelaunay(bool delaunay) {
+        reset();
+        _delaunay = delaunay;
+    }
+
+    /**
+     * Returns true if the triangulation is refined into a Delaunay triangulation.
+     *
+     * @return true if the triangulation is refined into a Delaunay triangulation.
+     */
+    bool isDelaunay() const { return _delaunay; }
+
+    /**
+     * Clears all internal data, but still maintains the initial vertex data.
+     */
+    void reset() {
+        _calculated = false;
+        _output.clear(); _next.clear(); _prev.clear(); _links.clear();
+    }
+
+    /**
+     * Clears all internal data, the initial vertex data.
+     *
+     * When this method is called, you will need to set a new vertices before
+     * calling calculate.
+     */
+    void clear() {
+        reset();
+        _input.clear(); _loops.clear();
+    }
+
+#pragma mark -
+#pragma mark Calculation
+    /**
+     * Performs a triangulation of the current vertex data.
+     */
+    void calculate();
+
+#pragma mark -
+#pragma mark Materialization
+    /**
+     * Returns a list of indices representing the triangulation.
+     *
+     * The indices represent positions in the original vertex list, followed
+     * by the vertices of each hole.  If you have modified that list, these
+     * indices may no longer be valid.
+     *
+     * The triangulator does not retain a reference to the returned list; it
+     * is safe to modify it.
+     *
+     * If the calculation is not yet performed, this method will return the
+     * empty list.
+     *
+     * @return a list of indices representing the triangulation.
+     */
+    std::vector<unsigned short> getTriangulation();
+
+    /**
+     * Stores the triangulation indices in the given buffer.
+     *
+     * The indices represent positions in the original vertex list, followed
+     * by the vertices of each hole.  If you have modified that list, these
+     * indices may no longer be valid.
+     *
+     * The indices will be appended to the provided vector. You should clear
+     * the vector first if you do not want to preserve the original data.
+     *
+     * If the calculation is not yet performed, this method will do nothing.
+     *
+     * @return the number of elements added to the buffer
+     */
+    size_t getTriangulation(std::vector<unsigned short>& buffer);
+
+    /**
+     * Returns a polygon representing the triangulation.
+     *
+     * The polygon contains the original vertices (followed by the vertices
+     * of each hole) together with the new indices defining a solid shape.
+     * The triangulator does not maintain references to this polygon and it
+     * is safe to modify it.
+     *
+     * If the calculation is not yet performed, this method will return the
+     * empty polygon.
+     *
+     * @return a polygon representing the triangulation.
+     */
+    Poly2 getPolygon();
+
+    /**
+     * Stores the triangulation in the given buffer.
+     *
+     * This method will add both the original vertices (followed by the
+     * vertices of each hole), and the corresponding indices to the new
+     * buffer.  If the buffer is not empty, the indices will be adjusted
+     * accordingly. You should clear the buffer first if you do not want to
+     * preserve the original data.
+     *
+     * If the calculation is not yet performed, this method will do nothing.
+     *
+     * @param buffer    The buffer to store the triangulated polygon
+     *
+     * @return a reference to the buffer for chaining.
+     */
+    Poly2* getPolygon(Poly2* buffer);
+
+#pragma mark -
+#pragma mark Internal Data Generation
+private:
+    /**
+     * Returns true if vertex a is processed before vertex b in the sweep.
+     *
+     * The sweep runs from top to bottom.  Vertices at the same height are
+     * processed from left to right.
+     *
+     * @param a The first vertex index
+     * @param b The second vertex index
+     *
+     * @return true if vertex a is processed before vertex b in the sweep.
+     */
+    bool above(Uint32 a, Uint32 b) const {
+        const Vec2& p = _input[a];
+        const Vec2& q = _input[b];
+        return p.y > q.y || (p.y == q.y && p.x < q.x);
+    }
+
+    /**
+     * Returns the x-coordinate of the given edge at the current sweep line.
+     *
+     * The edge is identified by its first vertex.
+     *
+     * @param edge  The edge to intersect with the sweep line
+     *
+     * @return the x-coordinate of the given edge at the current sweep line.
+     */
+    float intercept(int edge) const;
+
+    /**
+     * Links the vertex loops so that the interior is always on the left.
+     *
+     * This method fills the arrays _next and _prev, reversing any loops that
+     * have the wrong orientation.
+     */
+    void computeLoops();
+
+    /**
+     * Returns the classification of the given vertex for the plane sweep.
+     *
+     * @param index The vertex index
+     *
+     * @return the classification of the given vertex for the plane sweep.
+     */
+    VertexType classifyVertex(Uint32 index) const;
+
+    /**
+     * Adds a diagonal between the two given vertices.
+     *
+     * @param a The first vertex index
+     * @param b The second vertex index
+     */
+    void addDiagonal(Uint32 a, Uint32 b);
+
+    /**
+     * Partitions the polygon into y-monotone pieces.
+     *
+     * This is the plane sweep.  It adds diagonals between vertices so that
+     * every face of the result is y-monotone.
+     */
+    void computeMonotone();
+
+    /**
+     * Triangulates every face of the monotone partition.
+     *
+     * This method traces each face with the interior on the left, and sends
+     * it to {@link triangulateMonotone}.
+     */
+    void computeFaces();
+
+    /**
+     * Triangulates a single y-monotone face, adding it to the output.
+     *
+     * @param face  The face vertices, with the interior on the left
+     */
+    void triangulateMonotone(const std::vector<Uint32>& face);
+
+    /**
+     * Adds the given triangle to the output, oriented counter-clockwise.
+     *
+     * @param a The first vertex index
+     * @param b The second vertex index
+     * @param c The third vertex index
+     */
+    void addTriangle(Uint32 a, Uint32 b, Uint32 c);
+
+    /**
+     * Flips interior edges until the triangulation is Delaunay.
+     *
+     * Boundary edges are never flipped, so the result is a constrained
+     * Delaunay triangulation.
+     */
+    void computeDelaunay();
+
+    /**
+     * Removes any degenerate triangles from the output.
+     *
+     * Degenerate triangles can appear when the input has colinear vertices.
+     * They will crash OpenGL, so we remove them.
+     */
+    void trimColinear();
+};
+
+}
+#endif /* __CU_COMPLEX_TRIANGULATOR_H__ */
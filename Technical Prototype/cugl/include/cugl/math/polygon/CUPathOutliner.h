@@ -36,7 +36,7 @@
 
 #include "../CUPoly2.h"
 #include "../CUVec2.h"
-#include "CUSimpleTriangulator.h"
+#include "CUComplexTriangulator.h"
 #include <vector>
 
 namespace cugl {
@@ -86,7 +86,7 @@ private:
     bool _calculated;
     
     /** A triangulator for interior traversals */
-    SimpleTriangulator _triangulator;
+    ComplexTriangulator _triangulator;
     
 #pragma mark -
 #pragma mark Constructors
@@ -0,0 +1,243 @@
+//
+//  CUShapeCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of generated polygon geometry.  The scene
+//  graph nodes PolygonNode, PathNode, and WireNode all run a polygon factory
+//  (a triangulator, an outliner, or an extruder) whenever their shape changes.
+//  Those factories used to be static members of the node classes, which made
+//  node construction unsafe outside of the main thread.  This cache replaces
+//  them.  Each thread gets its own factories, and the results are shared as
+//  immutable polygons, keyed by the exact vertices and settings that made them.
+//
+//  This is a static class.  All of its methods are thread safe.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_SHAPE_CACHE_H__
+#define __CU_SHAPE_CACHE_H__
+
+#include "../CUPoly2.h"
+#include "../CUVec2.h"
+#include "CUPathOutliner.h"
+#include "CUPathExtruder.h"
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** The maximum number of shapes held by the cache before it is emptied */
+#define SHAPE_CACHE_CAPACITY    512
+
+namespace cugl {
+
+/**
+ * This class is a thread safe cache of generated polygons.
+ *
+ * Each method takes a sequence of vertices and the settings for a polygon
+ * factory, and returns the polygon that factory would produce.  If the same
+ * request was made before, the method returns the earlier result instead of
+ * running the factory again.  Requests match only if the vertices and the
+ * settings are exactly equal.
+ *
+ * The polygons are shared between all callers, and so they are immutable.
+ * A caller that needs to modify the result should copy it.
+ *
+ * The factories run outside of the cache lock, using factories that belong
+ * to the calling thread.  Hence two threads may both compute the same shape
+ * at the same time.  In that case, the first result stored wins, and both
+ * callers receive it.
+ *
+ * The cache holds at most SHAPE_CACHE_CAPACITY shapes.  When it is full, it
+ * is emptied before the next shape is added.  Polygons already returned to
+ * callers remain valid, as they are shared pointers.
+ */
+class ShapeCache {
+private:
+    /** The factory used to generate a shape */
+    enum class Kind : int {
+        /** A triangulation with ComplexTriangulator */
+        SOLID = 0,
+        /** A traversal with PathOutliner */
+        PATH  = 1,
+        /** An extrusion with PathExtruder */
+        EXTRUSION = 2
+    };
+
+    /** The key identifying a cached shape */
+    struct Key {
+        /** The factory used to generate the shape */
+        Kind kind;
+        /** The factory settings, packed into a single integer */
+        int settings;
+        /** The stroke width (extrusions only) */
+        float stroke;
+        /** The input vertices */
+        std::vector<Vec2> vertices;
+        /** The hash of all of the values above */
+        size_t hash;
+
+        /**
+         * Returns true if this key is identical to the given one.
+         *
+         * @param other The key to compare
+         *
+         * @return true if this key is identical to the given one.
+         */
+        bool operator==(const Key& other) const;
+    };
+
+    /** The hash function for shape keys */
+    struct KeyHash {
+        /**
+         * Returns the precomputed hash of the given key.
+         *
+         * @param key   The key to hash
+         *
+         * @return the precomputed hash of the given key.
+         */
+        size_t operator()(const Key& key) const { return key.hash; }
+    };
+
+    /** The lock guarding the cache and its statistics */
+    static std::mutex _mutex;
+    /** The cached shapes */
+    static std::unordered_map<Key, std::shared_ptr<const Poly2>, KeyHash> _shapes;
+    /** The number of requests answered from the cache */
+    static Uint32 _hits;
+    /** The number of requests that required a factory */
+    static Uint32 _misses;
+
+    /**
+     * Returns a key for the given request.
+     *
+     * @param kind      The factory used to generate the shape
+     * @param settings  The factory settings, packed into a single integer
+     * @param stroke    The stroke width (extrusions only)
+     * @param vertices  The input vertices
+     *
+     * @return a key for the given request.
+     */
+    static Key makeKey(Kind kind, int settings, float stroke, const std::vector<Vec2>& vertices);
+
+    /**
+     * Returns the shape for the given key, if it is cached.
+     *
+     * This method updates the statistics.
+     *
+     * @param key   The shape key
+     *
+     * @return the shape for the given key, or nullptr if it is not cached.
+     */
+    static std::shared_ptr<const Poly2> lookup(const Key& key);
+
+    /**
+     * Stores the given shape in the cache, returning the cached shape.
+     *
+     * If another thread stored a shape for this key in the meantime, that
+     * shape is returned instead, and the given one is discarded.
+     *
+     * @param key   The shape key
+     * @param shape The newly generated shape
+     *
+     * @return the shape cached for the given key.
+     */
+    static std::shared_ptr<const Poly2> store(Key&& key, const std::shared_ptr<const Poly2>& shape);
+
+public:
+#pragma mark Shapes
+    /**
+     * Returns the triangulation of the given vertices.
+     *
+     * The polygon is the one produced by ComplexTriangulator.  It is a SOLID
+     * polygon with the given vertices.
+     *
+     * @param vertices  The vertices to triangulate
+     *
+     * @return the triangulation of the given vertices.
+     */
+    static std::shared_ptr<const Poly2> getSolid(const std::vector<Vec2>& vertices);
+
+    /**
+     * Returns the traversal of the given vertices.
+     *
+     * The polygon is the one produced by PathOutliner.  It is a PATH polygon
+     * with the given vertices.
+     *
+     * @param vertices  The vertices to traverse
+     * @param traversal The path traversal for index generation
+     *
+     * @return the traversal of the given vertices.
+     */
+    static std::shared_ptr<const Poly2> getPath(const std::vector<Vec2>& vertices,
+                                                PathTraversal traversal);
+
+    /**
+     * Returns the extrusion of the given path.
+     *
+     * The polygon is the one produced by PathExtruder.  It is a SOLID polygon
+     * whose vertices are generated by the extrusion.
+     *
+     * @param vertices  The vertices of the path
+     * @param closed    Whether the path is closed
+     * @param stroke    The stroke width of the extrusion
+     * @param joint     The joint between extrusion line segments
+     * @param cap       The end caps of the extruded paths
+     *
+     * @return the extrusion of the given path.
+     */
+    static std::shared_ptr<const Poly2> getExtrusion(const std::vector<Vec2>& vertices, bool closed,
+                                                     float stroke, PathJoint joint, PathCap cap);
+
+#pragma mark -
+#pragma mark Cache Management
+    /**
+     * Empties the cache and resets the statistics.
+     *
+     * Polygons already returned to callers remain valid.
+     */
+    static void clear();
+
+    /**
+     * Returns the number of shapes in the cache.
+     *
+     * @return the number of shapes in the cache.
+     */
+    static size_t size();
+
+    /**
+     * Returns the number of requests answered from the cache.
+     *
+     * @return the number of requests answered from the cache.
+     */
+    static Uint32 getHits();
+
+    /**
+     * Returns the number of requests that required a polygon factory.
+     *
+     * @return the number of requests that required a polygon factory.
+     */
+    static Uint32 getMisses();
+};
+
+}
+#endif /* __CU_SHAPE_CACHE_H__ */
@@ -0,0 +1,395 @@
+//
+//  CUGLState.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of the OpenGL binding state.  OpenGL state
+//  changes are surprisingly expensive on mobile drivers, even when they do
+//  not actually change anything.  All of the classes in the renderer package
+//  bind programs, textures, buffers and blend state through this module,
+//  which remembers what is bound and drops any call that would not change it.
+//
+//  This module also counts the OpenGL calls made each frame (and the calls
+//  that were avoided), so that we can measure the driver overhead.
+//
+//  This is a static class.  It only supports a single OpenGL context, and it
+//  must only be used on the thread that owns that context.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_GL_STATE_H__
+#define __CU_GL_STATE_H__
+#include <cugl/base/CUBase.h>
+#include <unordered_map>
+
+/** The number of texture units tracked by the state cache */
+#define GLSTATE_TEXTURE_UNITS   8
+
+namespace cugl {
+
+/**
+ * This class is a cache of the OpenGL binding state.
+ *
+ * Every method of this class mirrors an OpenGL call, but only issues that
+ * call if it would change the current state.  The cache covers the bound
+ * program, the textures bound to the first GLSTATE_TEXTURE_UNITS units, the
+ * vertex array and buffer bindings, the framebuffer binding, the blend state,
+ * the capabilities used by the renderer, and the viewport.
+ *
+ * The cache only works if every change to these bindings goes through this
+ * class.  If any other code (such as a third party library) changes the
+ * OpenGL state directly, it must call {@link reset()} afterwards, so that
+ * the cache forgets what it knows.
+ *
+ * Objects deleted through this class are also removed from the cache.  That
+ * is important because OpenGL recycles the names of deleted objects.
+ *
+ * The counters report the calls made in the last completed frame.  A call
+ * is issued if it reached OpenGL, and avoided if the cache dropped it.  The
+ * renderer also reports its draw calls, buffer uploads and uniform updates
+ * with {@link countCalls}, so that the issued count covers the entire draw
+ * path.  The application ends each frame with {@link endFrame()}.
+ */
+class GLState {
+private:
+    /** The currently bound program */
+    static GLuint _program;
+    /** The active texture unit (as an offset from GL_TEXTURE0) */
+    static GLuint _unit;
+    /** The 2D texture bound to each texture unit */
+    static GLuint _textures[GLSTATE_TEXTURE_UNITS];
+    /** The currently bound vertex array */
+    static GLuint _vertexArray;
+    /** The currently bound array buffer */
+    static GLuint _arrayBuffer;
+    /** The currently bound element buffer (part of the vertex array state) */
+    static GLuint _elementBuffer;
+    /** The element buffer recorded for each vertex array */
+    static std::unordered_map<GLuint, GLuint> _elements;
+    /** The currently bound framebuffer */
+    static GLuint _framebuffer;
+
+    /** The source blend factor */
+    static GLenum _srcFactor;
+    /** The destination blend factor */
+    static GLenum _dstFactor;
+    /** The source blend factor for alpha */
+    static GLenum _srcAlpha;
+    /** The destination blend factor for alpha */
+    static GLenum _dstAlpha;
+    /** The blend equation */
+    static GLenum _blendEquation;
+    /** Whether GL_BLEND is enabled (-1 if unknown) */
+    static int _blend;
+    /** Whether GL_CULL_FACE is enabled (-1 if unknown) */
+    static int _cullFace;
+    /** Whether GL_DEPTH_TEST is enabled (-1 if unknown) */
+    static int _depthTest;
+    /** Whether depth writes are enabled (-1 if unknown) */
+    static int _depthMask;
+    /** The current viewport */
+    static GLint _viewport[4];
+
+    /** The calls issued so far this frame */
+    static Uint32 _issued;
+    /** The calls avoided so far this frame */
+    static Uint32 _avoided;
+    /** The calls issued in the last frame */
+    static Uint32 _frameIssued;
+    /** The calls avoided in the last frame */
+    static Uint32 _frameAvoided;
+
+    /**
+     * Returns a reference to the cached value for the given capability.
+     *
+     * @param cap   The OpenGL capability
+     *
+     * @return a reference to the cached value for the given capability.
+     */
+    static int* capability(GLenum cap);
+
+public:
+#pragma mark Cache Management
+    /**
+     * Forgets the cached OpenGL state.
+     *
+     * After this call, the next change to each binding is always issued.
+     * This method must be called whenever a new context is created, or
+     * whenever code outside of this class has changed the OpenGL state.
+     */
+    static void reset();
+
+#pragma mark -
+#pragma mark Programs
+    /**
+     * Makes the given program current (as glUseProgram).
+     *
+     * @param program   The shader program (0 for none)
+     */
+    static void useProgram(GLuint program);
+
+    /**
+     * Returns the currently bound program.
+     *
+     * @return the currently bound program.
+     */
+    static GLuint getProgram() { return _program; }
+
+    /**
+     * Deletes the given program (as glDeleteProgram).
+     *
+     * If the program is current, the cache forgets it.
+     *
+     * @param program   The shader program
+     */
+    static void deleteProgram(GLuint program);
+
+#pragma mark -
+#pragma mark Textures
+    /**
+     * Selects the active texture unit (as glActiveTexture).
+     *
+     * The unit is an offset from GL_TEXTURE0.
+     *
+     * @param unit  The texture unit
+     */
+    static void activeTexture(GLuint unit);
+
+    /**
+     * Binds a 2D texture to the active texture unit (as glBindTexture).
+     *
+     * @param texture   The texture (0 for none)
+     */
+    static void bindTexture(GLuint texture);
+
+    /**
+     * Binds a 2D texture to the given texture unit.
+     *
+     * The unit is an offset from GL_TEXTURE0.  This method changes the
+     * active texture unit only if the binding changes.
+     *
+     * @param unit      The texture unit
+     * @param texture   The texture (0 for none)
+     */
+    static void bindTexture(GLuint unit, GLuint texture);
+
+    /**
+     * Returns the 2D texture bound to the active texture unit.
+     *
+     * @return the 2D texture bound to the active texture unit.
+     */
+    static GLuint getTexture();
+
+    /**
+     * Deletes the given texture (as glDeleteTextures).
+     *
+     * Any texture unit bound to this texture reverts to 0.
+     *
+     * @param texture   The texture
+     */
+    static void deleteTexture(GLuint texture);
+
+#pragma mark -
+#pragma mark Buffers
+    /**
+     * Binds the given vertex array (as glBindVertexArray).
+     *
+     * The element buffer binding is part of the vertex array state, and is
+     * restored in the cache along with the vertex array.
+     *
+     * @param array     The vertex array (0 for none)
+     */
+    static void bindVertexArray(GLuint array);
+
+    /**
+     * Binds the given buffer (as glBindBuffer).
+     *
+     * Only GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached.  Other
+     * targets are always issued.
+     *
+     * @param target    The buffer target
+     * @param buffer    The buffer (0 for none)
+     */
+    static void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * Deletes the given vertex array (as glDeleteVertexArrays).
+     *
+     * If the vertex array is bound, the binding reverts to 0.
+     *
+     * @param array     The vertex array
+     */
+    static void deleteVertexArray(GLuint array);
+
+    /**
+     * Deletes the given buffer (as glDeleteBuffers).
+     *
+     * Any binding to this buffer reverts to 0.
+     *
+     * @param buffer    The buffer
+     */
+    static void deleteBuffer(GLuint buffer);
+
+#pragma mark -
+#pragma mark Framebuffers
+    /**
+     * Binds the given framebuffer (as glBindFramebuffer with GL_FRAMEBUFFER).
+     *
+     * Note that the default framebuffer is not always 0 (it is not on iOS).
+     * Use {@link getFramebuffer()} to find the binding to restore.
+     *
+     * @param buffer    The framebuffer
+     */
+    static void bindFramebuffer(GLuint buffer);
+
+    /**
+     * Returns the currently bound framebuffer.
+     *
+     * If the binding is not known, this method queries OpenGL for it.
+     *
+     * @return the currently bound framebuffer.
+     */
+    static GLuint getFramebuffer();
+
+    /**
+     * Deletes the given framebuffer (as glDeleteFramebuffers).
+     *
+     * If the framebuffer is bound, the cache forgets the binding.
+     *
+     * @param buffer    The framebuffer
+     */
+    static void deleteFramebuffer(GLuint buffer);
+
+#pragma mark -
+#pragma mark Blending and Capabilities
+    /**
+     * Sets the blend function (as glBlendFunc).
+     *
+     * The factors apply to both the color and the alpha channels.
+     *
+     * @param srcFactor The source blend factor
+     * @param dstFactor The destination blend factor
+     */
+    static void setBlendFunc(GLenum srcFactor, GLenum dstFactor);
+
+    /**
+     * Sets separate blend functions for color and alpha (as glBlendFuncSeparate).
+     *
+     * @param srcFactor The source blend factor for color
+     * @param dstFactor The destination blend factor for color
+     * @param srcAlpha  The source blend factor for alpha
+     * @param dstAlpha  The destination blend factor for alpha
+     */
+    static void setBlendFuncSeparate(GLenum srcFactor, GLenum dstFactor,
+                                     GLenum srcAlpha, GLenum dstAlpha);
+
+    /**
+     * Sets the blend equation (as glBlendEquation).
+     *
+     * @param equation  The blend equation
+     */
+    static void setBlendEquation(GLenum equation);
+
+    /**
+     * Enables the given capability (as glEnable).
+     *
+     * Only GL_BLEND, GL_CULL_FACE and GL_DEPTH_TEST are cached.  Other
+     * capabilities are always issued.
+     *
+     * @param cap   The OpenGL capability
+     */
+    static void enable(GLenum cap);
+
+    /**
+     * Disables the given capability (as glDisable).
+     *
+     * Only GL_BLEND, GL_CULL_FACE and GL_DEPTH_TEST are cached.  Other
+     * capabilities are always issued.
+     *
+     * @param cap   The OpenGL capability
+     */
+    static void disable(GLenum cap);
+
+    /**
+     * Sets whether depth writes are enabled (as glDepthMask).
+     *
+     * @param flag  Whether depth writes are enabled
+     */
+    static void setDepthMask(bool flag);
+
+    /**
+     * Sets the viewport (as glViewport).
+     *
+     * @param x         The viewport x offset
+     * @param y         The viewport y offset
+     * @param width     The viewport width
+     * @param height    The viewport height
+     */
+    static void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /**
+     * Stores the current viewport in the given array.
+     *
+     * The array holds the x offset, y offset, width and height, in that
+     * order.  If the viewport is not known, this method queries OpenGL
+     * for it.
+     *
+     * @param viewport  The array to store the viewport
+     */
+    static void getViewport(GLint* viewport);
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Records OpenGL calls that were issued outside of this cache.
+     *
+     * The renderer uses this method for calls that always reach OpenGL,
+     * such as draws, buffer uploads, and uniform updates.
+     *
+     * @param calls The number of calls issued
+     */
+    static void countCalls(Uint32 calls=1) { _issued += calls; }
+
+    /**
+     * Completes the statistics for the current frame.
+     *
+     * The counts so far become the counts reported for the last frame,
+     * and the counts for the next frame start at 0.
+     */
+    static void endFrame();
+
+    /**
+     * Returns the number of OpenGL calls issued in the last frame.
+     *
+     * @return the number of OpenGL calls issued in the last frame.
+     */
+    static Uint32 getCallsIssued() { return _frameIssued; }
+
+    /**
+     * Returns the number of redundant OpenGL calls avoided in the last frame.
+     *
+     * @return the number of redundant OpenGL calls avoided in the last frame.
+     */
+    static Uint32 getCallsAvoided() { return _frameAvoided; }
+};
+
+}
+#endif /* __CU_GL_STATE_H__ */
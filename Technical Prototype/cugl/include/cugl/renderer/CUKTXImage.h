@@ -0,0 +1,376 @@
+//
+//  CUKTXImage.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides CPU-side support for KTX (Khronos texture) containers.
+//  A KTX file stores an image that is ready to hand to OpenGL, including an
+//  optional chain of prebuilt mipmaps.  We use it to ship ETC2/EAC compressed
+//  textures, which stay compressed in GPU memory.
+//
+//  Not every platform can sample ETC2 (in particular, desktop OpenGL on the
+//  Mac cannot).  Hence this module also contains a software decoder that can
+//  expand an ETC2/EAC image (with all of its mipmaps) to RGBA8888 data.  That
+//  way a KTX asset can be used everywhere, even if it is only compressed on
+//  devices that support it.
+//
+//  Loading and decoding a KTX image does not touch OpenGL, so it is safe to do
+//  in a separate thread.  Only the format queries require an OpenGL context.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_KTX_IMAGE_H__
+#define __CU_KTX_IMAGE_H__
+#include <cugl/base/CUBase.h>
+#include <vector>
+#include <string>
+
+namespace cugl {
+
+/**
+ * This class is a KTX image loaded into main memory.
+ *
+ * A KTX image is the contents of a KTX (version 1.1) container file.  It is
+ * a single 2d image together with its (optional) prebuilt mipmaps.  The data
+ * may either be uncompressed RGBA or RGB, or it may be in one of the ETC
+ * compressed formats (ETC1, ETC2 RGB, ETC2 punchthrough alpha, or ETC2 with
+ * an EAC alpha channel).  Cube maps, texture arrays, and 3d textures are not
+ * supported.
+ *
+ * This class does not create an OpenGL texture.  Use the method
+ * {@link Texture#initWithKTX} for that.  As this class never touches OpenGL,
+ * it is safe to load a KTX image in a separate thread.
+ *
+ * If a compressed image is not supported by the current platform (see
+ * {@link isSupported}), you can use {@link decompress} to convert it to an
+ * uncompressed image with the same mipmaps.
+ */
+class KTXImage {
+private:
+    /** This macro disables the copy constructor (not allowed on images) */
+    CU_DISALLOW_COPY_AND_ASSIGN(KTXImage);
+
+protected:
+    /** The OpenGL data type (0 if compressed) */
+    GLenum _glType;
+    /** The OpenGL pixel format (0 if compressed) */
+    GLenum _glFormat;
+    /** The OpenGL internal format */
+    GLenum _glInternal;
+    /** The OpenGL base internal format */
+    GLenum _glBase;
+    /** The width of the base image in pixels */
+    unsigned int _width;
+    /** The height of the base image in pixels */
+    unsigned int _height;
+
+    /** The image data for all of the mipmap levels */
+    std::vector<Uint8> _data;
+    /** The offset of each mipmap level in the image data */
+    std::vector<size_t> _offsets;
+    /** The size in bytes of each mipmap level */
+    std::vector<size_t> _sizes;
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates an empty KTX image.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    KTXImage();
+
+    /**
+     * Deletes this image, disposing all resources
+     */
+    ~KTXImage() { dispose(); }
+
+    /**
+     * Deletes the image data and resets all attributes.
+     *
+     * You must reinitialize the image to use it.
+     */
+    void dispose();
+
+    /**
+     * Initializes an image from the given KTX file.
+     *
+     * The file is read through SDL, so on Android this may be a path inside
+     * of the application package.  This method does not prepend the asset
+     * directory to relative paths.
+     *
+     * @param filename  The path to the KTX file
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const std::string& filename);
+
+    /**
+     * Initializes an image from the contents of a KTX file.
+     *
+     * The data is copied, and so it is safe to delete it when this method
+     * is done.  The file is rejected if any mipmap level has fewer bytes
+     * than its dimensions require (including the 4 byte row padding of
+     * uncompressed levels).
+     *
+     * @param data  The contents of a KTX file
+     * @param size  The number of bytes in data
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithData(const void* data, size_t size);
+
+    /**
+     * Returns a newly allocated image from the given KTX file.
+     *
+     * The file is read through SDL, so on Android this may be a path inside
+     * of the application package.  This method does not prepend the asset
+     * directory to relative paths.
+     *
+     * @param filename  The path to the KTX file
+     *
+     * @return a newly allocated image from the given KTX file.
+     */
+    static std::shared_ptr<KTXImage> alloc(const std::string& filename) {
+        std::shared_ptr<KTXImage> result = std::make_shared<KTXImage>();
+        return (result->init(filename) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated image from the contents of a KTX file.
+     *
+     * The data is copied, and so it is safe to delete it when this method
+     * is done.  The file is rejected if any mipmap level has fewer bytes
+     * than its dimensions require (including the 4 byte row padding of
+     * uncompressed levels).
+     *
+     * @param data  The contents of a KTX file
+     * @param size  The number of bytes in data
+     *
+     * @return a newly allocated image from the contents of a KTX file.
+     */
+    static std::shared_ptr<KTXImage> allocWithData(const void* data, size_t size) {
+        std::shared_ptr<KTXImage> result = std::make_shared<KTXImage>();
+        return (result->initWithData(data,size) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns true if this image is ETC compressed.
+     *
+     * @return true if this image is ETC compressed.
+     */
+    bool isCompressed() const { return _glType == 0; }
+
+    /**
+     * Returns true if this image has an alpha channel.
+     *
+     * @return true if this image has an alpha channel.
+     */
+    bool hasAlpha() const { return _glBase == GL_RGBA; }
+
+    /**
+     * Returns the OpenGL internal format of this image.
+     *
+     * For compressed images, this is the value to pass to
+     * glCompressedTexImage2D.
+     *
+     * @return the OpenGL internal format of this image.
+     */
+    GLenum getInternalFormat() const { return _glInternal; }
+
+    /**
+     * Returns the OpenGL pixel format of this image (0 if compressed).
+     *
+     * @return the OpenGL pixel format of this image (0 if compressed).
+     */
+    GLenum getFormat() const { return _glFormat; }
+
+    /**
+     * Returns the OpenGL data type of this image (0 if compressed).
+     *
+     * @return the OpenGL data type of this image (0 if compressed).
+     */
+    GLenum getType() const { return _glType; }
+
+    /**
+     * Returns the width of the base image in pixels.
+     *
+     * @return the width of the base image in pixels.
+     */
+    unsigned int getWidth() const { return _width; }
+
+    /**
+     * Returns the height of the base image in pixels.
+     *
+     * @return the height of the base image in pixels.
+     */
+    unsigned int getHeight() const { return _height; }
+
+    /**
+     * Returns the number of mipmap levels, including the base image.
+     *
+     * @return the number of mipmap levels, including the base image.
+     */
+    unsigned int getLevels() const { return (unsigned int)_sizes.size(); }
+
+    /**
+     * Returns the width of the given mipmap level in pixels.
+     *
+     * @param level The mipmap level
+     *
+     * @return the width of the given mipmap level in pixels.
+     */
+    unsigned int getWidth(unsigned int level) const {
+        unsigned int w = _width >> level;
+        return w == 0 ? 1 : w;
+    }
+
+    /**
+     * Returns the height of the given mipmap level in pixels.
+     *
+     * @param level The mipmap level
+     *
+     * @return the height of the given mipmap level in pixels.
+     */
+    unsigned int getHeight(unsigned int level) const {
+        unsigned int h = _height >> level;
+        return h == 0 ? 1 : h;
+    }
+
+    /**
+     * Returns the data for the given mipmap level.
+     *
+     * @param level The mipmap level
+     *
+     * @return the data for the given mipmap level.
+     */
+    const Uint8* getData(unsigned int level) const {
+        return _data.data()+_offsets[level];
+    }
+
+    /**
+     * Returns the size in bytes of the given mipmap level.
+     *
+     * @param level The mipmap level
+     *
+     * @return the size in bytes of the given mipmap level.
+     */
+    size_t getDataSize(unsigned int level) const { return _sizes[level]; }
+
+    /**
+     * Returns the size in bytes of all of the mipmap levels.
+     *
+     * This is the amount of texture memory this image will require on the GPU.
+     *
+     * @return the size in bytes of all of the mipmap levels.
+     */
+    size_t getByteSize() const;
+
+#pragma mark -
+#pragma mark Format Support
+    /**
+     * Returns true if the current OpenGL context can sample this image.
+     *
+     * Uncompressed images are always supported.  Compressed images are
+     * supported if their format is listed in GL_COMPRESSED_TEXTURE_FORMATS.
+     *
+     * This method is safe to call from any thread, provided that
+     * {@link querySupport} has been called in the main thread first.
+     *
+     * @return true if the current OpenGL context can sample this image.
+     */
+    bool isSupported() const;
+
+    /**
+     * Caches the compressed formats supported by the current OpenGL context.
+     *
+     * This method must be called from the main thread, as it queries OpenGL.
+     * It only performs the query the first time it is called, so it is cheap
+     * to call it more than once.
+     */
+    static void querySupport();
+
+    /**
+     * Returns true if the current OpenGL context can sample the given format.
+     *
+     * This method is safe to call from any thread, provided that
+     * {@link querySupport} has been called in the main thread first.
+     *
+     * @param format    The OpenGL compressed internal format
+     *
+     * @return true if the current OpenGL context can sample the given format.
+     */
+    static bool isFormatSupported(GLenum format);
+
+#pragma mark -
+#pragma mark Decompression
+    /**
+     * Returns an uncompressed copy of this image.
+     *
+     * The result is an RGBA image (with GL_UNSIGNED_BYTE data) with the same
+     * number of mipmap levels as this image.  If this image is not compressed,
+     * this method will return nullptr.  It will also return nullptr if this
+     * image is in a compressed format that we cannot decode.
+     *
+     * This method does not touch OpenGL, so it is safe to call in a separate
+     * thread.
+     *
+     * @return an uncompressed copy of this image.
+     */
+    std::shared_ptr<KTXImage> decompress() const;
+
+    /**
+     * Decodes a single ETC compressed image to RGBA8888 data.
+     *
+     * The output buffer must have space for width*height*4 bytes.  This method
+     * returns false if the format is not a supported ETC format.
+     *
+     * @param format    The OpenGL compressed internal format
+     * @param data      The compressed data
+     * @param width     The image width in pixels
+     * @param height    The image height in pixels
+     * @param output    The buffer to store the RGBA pixels
+     *
+     * @return true if the image was successfully decoded
+     */
+    static bool decode(GLenum format, const Uint8* data, unsigned int width,
+                       unsigned int height, Uint8* output);
+
+};
+
+}
+
+#endif /* __CU_KTX_IMAGE_H__ */
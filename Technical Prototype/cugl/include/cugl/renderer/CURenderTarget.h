@@ -0,0 +1,223 @@
+//
+//  CURenderTarget.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an offscreen render target.  A render target is an
+//  OpenGL framebuffer whose color attachment is an ordinary Texture.  Anything
+//  drawn while the target is active ends up in that texture, which can then be
+//  drawn like any other texture.  This allows us to draw an expensive part of
+//  the scene graph once, and reuse the result in later frames.
+//
+//  Render targets are normally activated through a SpriteBatch (see the method
+//  SpriteBatch::setTarget), which flushes its pending geometry first.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifndef __CU_RENDER_TARGET_H__
+#define __CU_RENDER_TARGET_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/math/CUColor4.h>
+#include "CUTexture.h"
+
+namespace cugl {
+
+/**
+ * This class is an offscreen render target backed by a texture.
+ *
+ * The target owns a framebuffer and an RGBA texture attached to it.  While
+ * the target is active (between {@link begin()} and {@link end()}), all
+ * drawing goes to the texture, and the viewport covers the entire texture.
+ * The texture is a power of two along each dimension, like every other
+ * texture in CUGL.
+ *
+ * Row 0 of the texture is the bottom of the viewport.  Hence a quad
+ * drawing the target contents should use texture coordinate (0,0) for its
+ * bottom left corner, and not the top left as with an image.
+ *
+ * The target restores the previous framebuffer and viewport when it ends,
+ * so render targets may be used in the middle of a frame.  However, a target
+ * may not be active twice at once.
+ */
+class RenderTarget {
+private:
+    /** This macro disables the copy constructor (not allowed on targets) */
+    CU_DISALLOW_COPY_AND_ASSIGN(RenderTarget);
+
+    /** The framebuffer for this target; 0 is not allocated */
+    GLuint _framebuffer;
+    /** The color attachment of the framebuffer */
+    std::shared_ptr<Texture> _texture;
+    /** The color used to clear the target */
+    Color4f _clearColor;
+
+    /** Whether this target is currently active */
+    bool _active;
+    /** The framebuffer bound before activation */
+    GLuint _prevBuffer;
+    /** The viewport before activation */
+    GLint _prevViewport[4];
+
+public:
+#pragma mark Constructors
+    /**
+     * Creates an uninitialized render target.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    RenderTarget();
+
+    /**
+     * Deletes this render target, releasing all resources.
+     */
+    ~RenderTarget() { dispose(); }
+
+    /**
+     * Deletes the framebuffer and texture of this render target.
+     *
+     * You must reinitialize the render target to use it.
+     */
+    void dispose();
+
+    /**
+     * Initializes a render target of the given size.
+     *
+     * Both dimensions must be a power of two.  This method fails if the
+     * framebuffer is not complete on this device.
+     *
+     * @param width     The target width in pixels
+     * @param height    The target height in pixels
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(int width, int height);
+
+    /**
+     * Returns a newly allocated render target of the given size.
+     *
+     * Both dimensions must be a power of two.  This method fails if the
+     * framebuffer is not complete on this device.
+     *
+     * @param width     The target width in pixels
+     * @param height    The target height in pixels
+     *
+     * @return a newly allocated render target of the given size.
+     */
+    static std::shared_ptr<RenderTarget> alloc(int width, int height) {
+        std::shared_ptr<RenderTarget> result = std::make_shared<RenderTarget>();
+        return (result->init(width, height) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the texture holding the contents of this target.
+     *
+     * The texture should not be drawn while the target is active.
+     *
+     * @return the texture holding the contents of this target.
+     */
+    const std::shared_ptr<Texture>& getTexture() const { return _texture; }
+
+    /**
+     * Returns the width of this target in pixels.
+     *
+     * @return the width of this target in pixels.
+     */
+    int getWidth() const { return _texture == nullptr ? 0 : (int)_texture->getWidth(); }
+
+    /**
+     * Returns the height of this target in pixels.
+     *
+     * @return the height of this target in pixels.
+     */
+    int getHeight() const { return _texture == nullptr ? 0 : (int)_texture->getHeight(); }
+
+    /**
+     * Sets the color used by {@link clear()}.
+     *
+     * By default, this is fully transparent black.
+     *
+     * @param color The clear color
+     */
+    void setClearColor(const Color4f& color) { _clearColor = color; }
+
+    /**
+     * Returns the color used by {@link clear()}.
+     *
+     * By default, this is fully transparent black.
+     *
+     * @return the color used by {@link clear()}.
+     */
+    const Color4f& getClearColor() const { return _clearColor; }
+
+    /**
+     * Returns true if this target is currently active.
+     *
+     * @return true if this target is currently active.
+     */
+    bool isActive() const { return _active; }
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Makes this target the destination of all drawing.
+     *
+     * The viewport is set to the entire texture.  The previous framebuffer
+     * and viewport are saved, to be restored by {@link end()}.  The target
+     * is not cleared, so that a target may be resumed after drawing to
+     * another one.  Use {@link clear()} to start over.
+     *
+     * Any pending drawing must be flushed before this call.  That is why
+     * this method is normally called through a SpriteBatch.
+     */
+    void begin();
+
+    /**
+     * Clears this target to the clear color.
+     *
+     * This method may only be called while the target is active.
+     */
+    void clear();
+
+    /**
+     * Restores the framebuffer and viewport active before {@link begin()}.
+     *
+     * Any pending drawing must be flushed before this call.  That is why
+     * this method is normally called through a SpriteBatch.
+     */
+    void end();
+};
+
+}
+#endif /* __CU_RENDER_TARGET_H__ */
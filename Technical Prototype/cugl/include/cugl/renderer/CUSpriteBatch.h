@@ -47,6 +47,7 @@
 #include "../math/CUMathBase.h"
 #include "../math/CUMat4.h"
 #include "CUVertex.h"
+#include <functional>
 #include <vector>
 
 #define DEFAULT_CAPACITY 8192
@@ -55,6 +56,8 @@ namespace cugl {
 
 /** Forward references */
 class SpriteShader;
+/** Forward reference to an offscreen render target */
+class RenderTarget;
 class Affine2;
 class Texture;
 class Rect;
@@ -74,6 +77,28 @@ class Poly2;
  *
  * In addition, this sprite batch is capable of drawing without an active 
  * texture.  In that case, the shape will be drawn with a solid color.
+ *
+ * With {@link setInstancing}, textured rectangles drawn with {@link fillQuad}
+ * are sent to the GPU as instances of a single quad, using an instanced
+ * {@link SpriteShader}.  Each quad costs one {@link QuadInstance} instead of
+ * four vertices and six indices, and the corners are computed on the GPU.
+ * Quads are batched separately from other shapes, so switching between quads
+ * and other shapes flushes the batch (just as changing the texture does).
+ *
+ * Other shapes are uploaded as a mesh.  The mesh uses 16-bit indices whenever
+ * the vertex capacity is at most 65536.  With {@link setVertexLayout}, its
+ * vertices are repacked into a smaller {@link VertexLayout} when they are
+ * flushed.
+ *
+ * Drawing normally goes to the current framebuffer.  It can be redirected to
+ * an offscreen {@link RenderTarget} with {@link setTarget}, in the middle of
+ * a drawing pass if necessary.
+ *
+ * A deferred sprite batch (see {@link allocDeferred}) has no OpenGL objects.
+ * Each flush is recorded instead of drawn, and the recording is drawn later
+ * by an ordinary sprite batch with {@link replay}.  As a deferred batch never
+ * touches OpenGL, it may be used on any thread.  This is how {@link Scene}
+ * builds its meshes in parallel.
  */
 class SpriteBatch {
 #pragma mark Values
@@ -92,8 +117,12 @@ private:
     
     /** The sprite batch vertex mesh */
     Vertex2* _vertData;
-    /** The indices for the vertex mesh */
+    /** The indices for the vertex mesh (nullptr if the indices are 16-bit) */
     GLuint*  _indxData;
+    /** The 16-bit indices for the vertex mesh (nullptr if the indices are 32-bit) */
+    GLushort* _indxShort;
+    /** The staging buffer for the compact vertex layouts */
+    Uint8*   _packData;
     
     /** The size of the vertex mesh */
     unsigned int _vertMax;
@@ -105,6 +134,30 @@ private:
     /** The number of indices in the current mesh */
     unsigned int _indxSize;
 
+    /** The preferred layout for uploading the vertex mesh */
+    VertexLayout _layout;
+    /** The layout currently attached to the vertex array */
+    VertexLayout _attached;
+
+    /** The instanced quad shader (nullptr if instancing is not available) */
+    std::shared_ptr<SpriteShader> _quadShader;
+    /** The OpenGL vertex array object for quads */
+    GLuint _quadArray;
+    /** The OpenGL buffer object for the corners of the unit square */
+    GLuint _quadCorners;
+    /** The OpenGL buffer object for the quad instances */
+    GLuint _quadBuffer;
+    /** The quad instances */
+    QuadInstance* _quadData;
+    /** The size of the quad instance array */
+    unsigned int _quadMax;
+    /** The number of quads in the current batch */
+    unsigned int _quadSize;
+    /** Whether the current batch is made of quads (instead of a mesh) */
+    bool _quadMode;
+    /** Whether textured rectangles are drawn as instanced quads */
+    bool _instancing;
+
     /** The active texture */
     std::shared_ptr<Texture> _texture;
     /** The active color */
@@ -120,17 +173,60 @@ private:
     GLenum _srcFactor;
     /** The destination factor for the blend function */
     GLenum _dstFactor;
+    /** The active render target (nullptr for the current framebuffer) */
+    std::shared_ptr<RenderTarget> _target;
     
     /** The number of vertices drawn in this pass (so far) */
     unsigned int _vertTotal;
     /** The number of OpenGL calls in this pass (so far) */
     unsigned int _callTotal;
+    /** The number of bytes uploaded in this pass (so far) */
+    size_t _byteTotal;
     
     /** Whether this sprite batch has been initialized yet */
     bool _initialized;
     /** Whether this sprite batch is currently active */
     bool _active;
 
+    /** A flush (or callback) recorded by a deferred sprite batch */
+    struct DeferredCommand {
+        /** The active texture */
+        std::shared_ptr<Texture> texture;
+        /** The drawing command, or 0 if this is a callback */
+        GLenum command;
+        /** Whether the recorded shapes are instanced quads */
+        bool quads;
+        /** The blending equation */
+        GLenum blendEquation;
+        /** The source factor for the blend function */
+        GLenum srcFactor;
+        /** The destination factor for the blend function */
+        GLenum dstFactor;
+        /** The first recorded vertex, quad or callback */
+        unsigned int start;
+        /** The number of recorded vertices or quads */
+        unsigned int count;
+        /** The first recorded index */
+        unsigned int indxStart;
+        /** The number of recorded indices */
+        unsigned int indxCount;
+    };
+
+    /** Whether this sprite batch records its flushes instead of drawing them */
+    bool _deferred;
+    /** The recorded flushes, in order */
+    std::vector<DeferredCommand> _commands;
+    /** The recorded mesh vertices */
+    std::vector<Vertex2> _recordVerts;
+    /** The recorded mesh indices (relative to the start of each command) */
+    std::vector<GLuint> _recordIndx;
+    /** The recorded quad instances */
+    std::vector<QuadInstance> _recordQuads;
+    /** The recorded callbacks */
+    std::vector<std::function<void(const std::shared_ptr<SpriteBatch>&)>> _recordCalls;
+    /** The vertex and index count of each recorded mesh shape, in pairs */
+    std::vector<unsigned int> _recordShapes;
+
     /** The blank (nullptr) texture */
     static std::shared_ptr<Texture> _blank;
 
@@ -227,6 +323,22 @@ public:
      */
     bool init(unsigned int capacity, std::shared_ptr<SpriteShader> shader);
     
+    /**
+     * Initializes a deferred sprite batch with the given vertex capacity.
+     *
+     * A deferred sprite batch has no shader and no OpenGL objects, so this
+     * method may be called on any thread once the blank texture exists.
+     * Each flush is recorded, and the recording is drawn by {@link replay}.
+     * The capacity should not exceed that of the batch that replays it.
+     *
+     * The sprite batch begins with the default blank texture, and color white.
+     *
+     * @param capacity  The vertex capacity of the mesh
+     *
+     * @return true if initialization was successful.
+     */
+    bool initDeferred(unsigned int capacity);
+    
 #pragma mark -
 #pragma mark Static Constructors
     /**
@@ -269,6 +381,22 @@ public:
         return (result->init(capacity) ? result : nullptr);
     }
     
+    /**
+     * Returns a new deferred sprite batch with the given vertex capacity.
+     *
+     * A deferred sprite batch has no shader and no OpenGL objects.  Each
+     * flush is recorded, and the recording is drawn by {@link replay}.
+     * The capacity should not exceed that of the batch that replays it.
+     *
+     * @param capacity  The vertex capacity of the mesh
+     *
+     * @return a new deferred sprite batch with the given vertex capacity.
+     */
+    static std::shared_ptr<SpriteBatch> allocDeferred(unsigned int capacity = DEFAULT_CAPACITY) {
+        std::shared_ptr<SpriteBatch> result = std::make_shared<SpriteBatch>();
+        return (result->initDeferred(capacity) ? result : nullptr);
+    }
+    
 #pragma mark -
 #pragma mark Attributes
     /**
@@ -288,6 +416,20 @@ public:
      */
     bool isDrawing() const { return _active; }
 
+    /**
+     * Returns true if this sprite batch records its flushes instead of drawing them.
+     *
+     * @return true if this sprite batch records its flushes instead of drawing them.
+     */
+    bool isDeferred() const { return _deferred; }
+
+    /**
+     * Returns the vertex capacity of the mesh.
+     *
+     * @return the vertex capacity of the mesh.
+     */
+    unsigned int getCapacity() const { return _capacity; }
+
     /**
      * Returns the number of vertices drawn in the latest pass (so far).
      *
@@ -306,6 +448,65 @@ public:
      */
     unsigned int getCallsMade() const { return _callTotal; }
 
+    /**
+     * Returns the number of bytes uploaded to the GPU in the latest pass (so far).
+     *
+     * This counts the vertex, index and quad instance data sent by flush().
+     *
+     * @return the number of bytes uploaded to the GPU in the latest pass (so far).
+     */
+    size_t getBytesUploaded() const { return _byteTotal; }
+
+    /**
+     * Sets whether textured rectangles are drawn as instanced quads.
+     *
+     * If this is false, {@link fillQuad} adds the rectangle to the mesh like
+     * any other shape.  Instancing is off by default.  It is also turned off
+     * by {@link setShader}, as the quads have their own shader.
+     *
+     * This value may NOT be changed during a drawing pass.
+     *
+     * @param flag  Whether textured rectangles are drawn as instanced quads
+     */
+    void setInstancing(bool flag);
+
+    /**
+     * Returns true if textured rectangles are drawn as instanced quads.
+     *
+     * This is false if the platform does not support the instanced shader.
+     * A deferred batch records quads whenever instancing is on; the batch
+     * that replays them decides how they are drawn.
+     *
+     * @return true if textured rectangles are drawn as instanced quads.
+     */
+    bool isInstancing() const { return _instancing && (_quadShader != nullptr || _deferred); }
+
+    /**
+     * Sets the preferred layout for uploading the vertex mesh.
+     *
+     * The mesh is always built from {@link Vertex2} records.  Any layout other
+     * than FULL repacks them when the mesh is flushed, which costs a pass
+     * over the vertices.  If the mesh cannot be
+     * represented in the preferred layout (e.g. the texture coordinates
+     * repeat), that flush falls back to a larger layout.  See
+     * {@link VertexLayout} for the precision of each layout.
+     *
+     * The layout is FULL by default.  HALF is only appropriate for
+     * scenes with small world coordinates.
+     *
+     * This value may NOT be changed during a drawing pass.
+     *
+     * @param layout    The preferred layout for uploading the vertex mesh
+     */
+    void setVertexLayout(VertexLayout layout);
+
+    /**
+     * Returns the preferred layout for uploading the vertex mesh.
+     *
+     * @return the preferred layout for uploading the vertex mesh.
+     */
+    VertexLayout getVertexLayout() const { return _layout; }
+
     /**
      * Sets the shader for this sprite batch
      *
@@ -404,6 +605,36 @@ public:
      * @return the active perspective matrix of this sprite batch
      */
     const Mat4& getPerspective() const { return _perspective; }
+
+    /**
+     * Sets the render target of this sprite batch
+     *
+     * All drawing after this call goes to the given target.  The target is
+     * not cleared (see {@link RenderTarget#clear()}).  A nullptr target
+     * restores the framebuffer that was current before the previous target.
+     * Changing this value will cause the sprite batch to flush.
+     *
+     * While a target is active, the alpha channel is blended with GL_ONE and
+     * GL_ONE_MINUS_SRC_ALPHA, regardless of the blend function.  With the
+     * default blend function, this means that the target texture holds
+     * premultiplied alpha, and should be drawn with GL_ONE as the source
+     * blend factor.
+     *
+     * The perspective matrix is not changed by this method.
+     *
+     * @param target    The render target for this sprite batch
+     */
+    void setTarget(const std::shared_ptr<RenderTarget>& target);
+
+    /**
+     * Returns the render target of this sprite batch
+     *
+     * If this value is nullptr, the sprite batch draws to the framebuffer
+     * that was current when the batch began.
+     *
+     * @return the render target of this sprite batch
+     */
+    const std::shared_ptr<RenderTarget>& getTarget() const { return _target; }
     
     /**
      * Sets the blending function for this sprite batch
@@ -444,7 +675,7 @@ public:
      *
      * @return the destination blending factor
      */
-    GLenum getDestinationBlendFactor() const { return _srcFactor; }
+    GLenum getDestinationBlendFactor() const { return _dstFactor; }
     
     /**
      * Sets the blending equation for this sprite batch
@@ -516,6 +747,31 @@ public:
      */
     void flush();
 
+    /**
+     * Records a callback to run when this deferred batch is replayed.
+     *
+     * This is for drawing that cannot be recorded, such as drawing that
+     * needs OpenGL.  The callback receives the batch doing the replay (which
+     * is actively drawing), and is run after everything recorded before it.
+     * This method may only be called on a deferred batch.
+     *
+     * @param callback  The drawing to do at replay
+     */
+    void defer(const std::function<void(const std::shared_ptr<SpriteBatch>&)>& callback);
+
+    /**
+     * Draws the recording of this deferred batch with the given sprite batch.
+     *
+     * The given batch must be actively drawing.  The recorded shapes are
+     * added to its mesh as if they were drawn directly, with the recorded
+     * texture and blend state, so consecutive recordings with the same state
+     * are still batched together.  The recording is kept until the next call
+     * to {@link begin()}, so it may be replayed more than once.
+     *
+     * @param batch     The sprite batch to draw the recording with
+     */
+    void replay(const std::shared_ptr<SpriteBatch>& batch) const;
+
 #pragma mark -
 #pragma mark Solid Shapes
     /**
@@ -847,6 +1103,27 @@ public:
               const unsigned short* indices, unsigned int isize, unsigned int ioffset,
               const Affine2& transform, bool tint = true);
 
+    /**
+     * Fills the given rectangle with the current color and texture.
+     *
+     * The texture coordinates are given for the bottom left corner (the
+     * origin of rect) and the top right corner, and are interpolated over
+     * the rectangle.  Hence the texture may be flipped by swapping the
+     * coordinates.  The transform will be applied to the rectangle
+     * directly in world space.
+     *
+     * If instancing is on, the rectangle is drawn as a single quad instance.
+     * Otherwise (or outside of a drawing pass), it is added to the mesh
+     * as two triangles.  The result is the same either way.
+     *
+     * @param rect      The rectangle to fill
+     * @param texcoord0 The texture coordinate at the bottom left corner
+     * @param texcoord1 The texture coordinate at the top right corner
+     * @param transform The coordinate transform
+     */
+    void fillQuad(const Rect& rect, const Vec2& texcoord0, const Vec2& texcoord1,
+                  const Mat4& transform);
+
 #pragma mark -
 #pragma mark Outlines
     /**
@@ -1847,6 +2124,86 @@ private:
      * @return the current drawing command.
      */
     GLenum getCommand() const { return _command; }
+
+    /**
+     * Sets whether the current batch is made of instanced quads.
+     *
+     * Changing this value during a drawing pass will flush the buffer and
+     * switch the shader.
+     *
+     * @param quads Whether the current batch is made of instanced quads
+     */
+    void setQuadMode(bool quads);
+
+    /**
+     * Records the current mesh (or quads) of a deferred batch.
+     *
+     * This is the deferred version of {@link flush()}.
+     */
+    void record();
+
+    /**
+     * Adds the recorded quads to the mesh, as {@link fillQuad} does without instancing.
+     *
+     * @param quads The quads to add
+     * @param count The number of quads
+     */
+    void appendQuads(const QuadInstance* quads, unsigned int count);
+
+    /**
+     * Makes room in the mesh for a shape of the given size.
+     *
+     * The mesh is flushed if the shape does not fit.  A deferred batch also
+     * records the shape size, so that a replay flushes before the same shapes.
+     *
+     * @param vsize The number of vertices in the shape
+     * @param isize The number of indices in the shape
+     */
+    void reserve(unsigned int vsize, unsigned int isize);
+
+    /**
+     * Applies the blend function to the OpenGL state.
+     *
+     * The alpha channel is blended separately while a render target is
+     * active, so that the target holds the correct coverage.
+     */
+    void applyBlendFunc();
+
+    /**
+     * Returns the shader for the current batch.
+     *
+     * @return the shader for the current batch.
+     */
+    const std::shared_ptr<SpriteShader>& getActiveShader() const {
+        return _quadMode ? _quadShader : _shader;
+    }
+
+    /**
+     * Stores an index in the index array at the given position.
+     *
+     * The index array is 16-bit whenever the vertex capacity allows it.
+     *
+     * @param pos   The position in the index array
+     * @param value The vertex index
+     */
+    void setIndex(unsigned int pos, GLuint value) {
+        if (_indxShort) {
+            _indxShort[pos] = (GLushort)value;
+        } else {
+            _indxData[pos] = value;
+        }
+    }
+
+    /**
+     * Returns the layout of the vertex mesh after packing it for upload.
+     *
+     * If the result is not FULL, the packed mesh is in the staging buffer.
+     * The result is the preferred layout, unless the mesh cannot be
+     * represented in that layout.
+     *
+     * @return the layout of the vertex mesh after packing it for upload.
+     */
+    VertexLayout packVertices();
     
     /**
      * Returns true if the vertex buffer was successfully allocated.
@@ -44,6 +44,7 @@
 
 #include "CUShader.h"
 #include "CUTexture.h"
+#include "CUVertex.h"
 #include "../math/CUMat4.h"
 
 namespace cugl {
@@ -68,8 +69,22 @@ namespace cugl {
  *      uPerspective:   The perspective matrix (combined modelview projection)
  *
  *      uTexture:       The shading texture
+ *
+ * The shader may optionally include an int uniform named uDistance.  This
+ * uniform is set to 1 whenever the texture is a signed distance field (such
+ * as the distance atlas of a {@link Font}), and 0 otherwise.  The default
+ * shader uses it to threshold the alpha channel, so that distance field
+ * glyphs remain sharp at any scale.  Shaders without this uniform draw
+ * distance fields as ordinary textures.
  * 
  * Any other attributes or uniforms will be ignored.
+ *
+ * A sprite shader may also be instanced (see {@link initQuads}).  An
+ * instanced shader draws a {@link QuadInstance} per instance, expanding it
+ * from the corners of the unit square.  Instead of aPosition and aTexCoord,
+ * it has the per-vertex attribute aCorner and the per-instance attributes
+ * aAxisX, aAxisY, aOrigin and aTexRect (with aColor per instance as well).
+ * The uniforms are the same.
  */
 class SpriteShader : public Shader {
 #pragma mark Values
@@ -80,16 +95,34 @@ private:
     GLint _aColor;
     /** The shader location for the texure coordinate attribute */
     GLint _aTexCoord;
+    /** The shader location for the quad corner attribute (instanced only) */
+    GLint _aCorner;
+    /** The shader location for the quad x-axis attribute (instanced only) */
+    GLint _aAxisX;
+    /** The shader location for the quad y-axis attribute (instanced only) */
+    GLint _aAxisY;
+    /** The shader location for the quad origin attribute (instanced only) */
+    GLint _aOrigin;
+    /** The shader location for the quad texture rectangle (instanced only) */
+    GLint _aTexRect;
     /** The shader location for the perspective uniform */
     GLint _uPerspective;
     /** The shader location for the texture uniform */
     GLint _uTexture;
+    /** The shader location for the distance field uniform (-1 if absent) */
+    GLint _uDistance;
 
     /** The current perspective matrix */
     Mat4  _mPerspective;
     
     /** The current shader texture */
     std::shared_ptr<Texture> _mTexture;
+
+    /** Whether the current texture is a distance field */
+    bool _mDistance;
+
+    /** Whether this shader draws instanced quads */
+    bool _instanced;
     
 #pragma mark -
 #pragma mark Constructors
@@ -100,7 +133,9 @@ public:
      * You must initialize the shader to add a source and compiled it.
      */
     SpriteShader() : Shader(), _aPosition(-1), _aColor(-1), _aTexCoord(-1),
-                               _uPerspective(-1), _uTexture(-1) { }
+                               _aCorner(-1), _aAxisX(-1), _aAxisY(-1), _aOrigin(-1),
+                               _aTexRect(-1), _uPerspective(-1), _uTexture(-1),
+                               _uDistance(-1), _mDistance(false), _instanced(false) { }
 
     /**
      * Deletes this shader, disposing all resources.
@@ -158,6 +193,21 @@ public:
      */
     bool init(const char* vsource, const char* fsource);
 
+    /**
+     * Initializes this shader as an instanced quad shader.
+     *
+     * The shader uses the default instanced vertex source and the default
+     * fragment source.  It draws one {@link QuadInstance} per instance
+     * (see {@link attachQuads}).
+     *
+     * When compilation is complete, the shader will not be bound.  However,
+     * any shader that was actively bound during compilation also be unbound
+     * as well.
+     *
+     * @return true if initialization was successful.
+     */
+    bool initQuads();
+
 #pragma mark -
 #pragma mark Static Constructors
     /**
@@ -210,9 +260,34 @@ public:
         std::shared_ptr<SpriteShader> result = std::make_shared<SpriteShader>();
         return (result->init(vsource, fsource) ? result : nullptr);
     }
+
+    /**
+     * Returns a new instanced quad shader.
+     *
+     * The shader uses the default instanced vertex source and the default
+     * fragment source.  It draws one {@link QuadInstance} per instance
+     * (see {@link attachQuads}).
+     *
+     * When compilation is complete, the shader will not be bound.  However,
+     * any shader that was actively bound during compilation also be unbound
+     * as well.
+     *
+     * @return a new instanced quad shader.
+     */
+    static std::shared_ptr<SpriteShader> allocQuads() {
+        std::shared_ptr<SpriteShader> result = std::make_shared<SpriteShader>();
+        return (result->initQuads() ? result : nullptr);
+    }
     
 #pragma mark -
 #pragma mark Attributes
+    /**
+     * Returns true if this shader draws instanced quads.
+     *
+     * @return true if this shader draws instanced quads.
+     */
+    bool isInstanced() const { return _instanced; }
+
     /**
      * Returns the GLSL location for the position attribute
      *
@@ -257,6 +332,16 @@ public:
      * @return the GLSL location for the testure uniform
      */
     GLint getTextureUni() const { return _uTexture; }
+
+    /**
+     * Returns the GLSL location for the distance field uniform
+     *
+     * This method will return -1 if the program is not initialized, or if
+     * the shader does not support distance fields.
+     *
+     * @return the GLSL location for the distance field uniform
+     */
+    GLint getDistanceUni() const { return _uDistance; }
     
     /**
      * Sets the perspective matrix to use in the shader.
@@ -275,6 +360,9 @@ public:
     /**
      * Sets the texture in use in the shader
      *
+     * If the texture is a signed distance field, this method also switches
+     * the shader to distance field rendering (and back again otherwise).
+     *
      * @param texture   The shader texture
      */
     void setTexture(const std::shared_ptr<Texture>& texture);
@@ -301,22 +389,47 @@ public:
      * Because of limitations in OpenGL ES, we cannot draw anything without
      * both a vertex buffer object and an vertex array object.
      *
+     * The layout specifies the format of the vertices in the buffer (see
+     * {@link VertexLayout}).  The attribute types are recorded in the vertex
+     * array object, so this method must be called again whenever the layout
+     * of the buffer changes.
+     *
      * @param vArray    The vertex array object
      * @param vBuffer   The vertex buffer object
+     * @param layout    The layout of the vertex buffer
+     */
+    void attach(GLuint vArray, GLuint vBuffer, VertexLayout layout=VertexLayout::FULL);
+
+    /**
+     * Attaches the given quad buffers to this instanced shader.
+     *
+     * The corner buffer holds the four corners of the unit square (as Vec2)
+     * in triangle strip order.  The quad buffer holds one QuadInstance per
+     * instance.  The attribute layout is recorded in the vertex array object,
+     * so this method only needs to be called once per vertex array (and
+     * not on every use).  The vertex array remains bound afterwards.
+     *
+     * @param vArray    The vertex array object
+     * @param cBuffer   The corner buffer object
+     * @param qBuffer   The quad instance buffer object
      */
-    void attach(GLuint vArray, GLuint vBuffer);
+    void attachQuads(GLuint vArray, GLuint cBuffer, GLuint qBuffer);
 
     /**
      * Binds this shader, making it active.
      *
-     * Once bound, any OpenGL calls will then be sent to this shader.
+     * Once bound, any OpenGL calls will then be sent to this shader.  Unless
+     * the shader is instanced, this enables the vertex attributes of the
+     * bound vertex array.
      */
     void bind() override;
     
     /**
      * Unbinds this shader, making it no longer active.
      *
-     * Once unbound, OpenGL calls will no longer be sent to this shader.
+     * Once unbound, OpenGL calls will no longer be sent to this shader.  Unless
+     * the shader is instanced, this disables the vertex attributes of the
+     * bound vertex array.
      */
     void unbind() override;
 
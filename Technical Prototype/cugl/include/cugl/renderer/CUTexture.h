@@ -14,6 +14,9 @@
 
 namespace cugl {
 
+/** Forward reference to a KTX image */
+class KTXImage;
+
 /**
  * This is a class representing an OpenGL texture.
  *
@@ -26,6 +29,10 @@ namespace cugl {
  * (and so does not require a context switch in the rendering pipeline), but
  * has different start and end boundaries, as defined by minS, maxS, minT and
  * maxT. See getSubtexture() for more information.
+ *
+ * Textures may also be initialized from a KTX image.  If the image is ETC
+ * compressed, the texture stays compressed in GPU memory.  Such a texture
+ * cannot be modified with set(), and its mipmaps must come from the image.
  */
 class Texture : public std::enable_shared_from_this<Texture> {
 #pragma mark Values
@@ -81,6 +88,15 @@ private:
     /** Whether or not the texture has mip maps */
     bool _hasMipmaps;
 
+    /** The compressed internal format (0 if the texture is not compressed) */
+    GLenum _compressed;
+
+    /** The number of bytes of GPU memory used by this texture */
+    size_t _byteSize;
+
+    /** Whether the texture stores a signed distance field in its alpha channel */
+    bool _distance;
+
     /// Texture atlas support
     /** Our parent, who owns the OpenGL texture (or nullptr if we own it) */
     std::shared_ptr<Texture> _parent;
@@ -172,12 +188,34 @@ public:
      * The texture will be stored in RGBA format, even if it is a file format
      * that does not support transparency (e.g. JPEG).
      *
+     * If the file has a .ktx extension, it is loaded as a KTX image instead,
+     * as if by {@link initWithKTX}.  If the image is compressed in a format
+     * that this platform does not support, it is decompressed on the CPU.
+     *
      * @param filename  The file supporting the texture file.
      *
      * @return true if initialization was successful.
      */
     bool initWithFile(const std::string& filename);
 
+    /**
+     * Initializes a texture with the data from the given KTX image.
+     *
+     * When initialization is done, the texture is no longer bound.  However,
+     * any other texture that was bound during initialization is also no longer
+     * bound.
+     *
+     * Every mipmap level in the image is uploaded.  If the image is ETC
+     * compressed, it is uploaded with glCompressedTexImage2D and stays
+     * compressed on the GPU.  In that case the format must be supported
+     * by the platform (see {@link KTXImage#isSupported}).
+     *
+     * @param image     The KTX image
+     *
+     * @return true if initialization was successful.
+     */
+    bool initWithKTX(const std::shared_ptr<KTXImage>& image);
+
 #pragma mark -
 #pragma mark Static Constructors
     /**
@@ -238,6 +276,10 @@ public:
      * The texture will be stored in RGBA format, even if it is a file format
      * that does not support transparency (e.g. JPEG).
      *
+     * If the file has a .ktx extension, it is loaded as a KTX image instead,
+     * as if by {@link allocWithKTX}.  If the image is compressed in a format
+     * that this platform does not support, it is decompressed on the CPU.
+     *
      * @param filename  The file supporting the texture file.
      *
      * @return a new texture with the given data
@@ -247,6 +289,27 @@ public:
         return (result->initWithFile(filename) ? result : nullptr);
     }
 
+    /**
+     * Returns a new texture with the data from the given KTX image.
+     *
+     * When initialization is done, the texture is no longer bound.  However,
+     * any other texture that was bound during initialization is also no longer
+     * bound.
+     *
+     * Every mipmap level in the image is uploaded.  If the image is ETC
+     * compressed, it is uploaded with glCompressedTexImage2D and stays
+     * compressed on the GPU.  In that case the format must be supported
+     * by the platform (see {@link KTXImage#isSupported}).
+     *
+     * @param image     The KTX image
+     *
+     * @return a new texture with the data from the given KTX image.
+     */
+    static std::shared_ptr<Texture> allocWithKTX(const std::shared_ptr<KTXImage>& image) {
+        std::shared_ptr<Texture> result = std::make_shared<Texture>();
+        return (result->initWithKTX(image) ? result : nullptr);
+    }
+
 #pragma mark -
 #pragma mark Setters
     /**
@@ -271,7 +334,8 @@ public:
      * The buffer must have the correct data format.  In addition, the buffer
      * must be size width*height*format.
      *
-     * This method binds the texture if it is not currently active.
+     * This method binds the texture if it is not currently active.  It
+     * may not be used on a compressed texture.
      *
      * @param data  The buffer to read into the texture
      *
@@ -279,6 +343,28 @@ public:
      */
     const Texture& set(const void *data);
 
+    /**
+     * Sets a rectangular region of this texture to the contents of the buffer.
+     *
+     * The buffer must have the correct data format, and be size width*height*
+     * format.  The region is measured in pixels, with the origin at the first
+     * row of the texture data.
+     *
+     * Unlike {@link set}, this method preserves the current texture binding.
+     * So it is safe to call during a drawing pass, such as when a font adds
+     * a glyph to its atlas.  It may not be used on a compressed texture or a
+     * subtexture.
+     *
+     * @param data      The buffer to read into the texture
+     * @param x         The left edge of the region
+     * @param y         The top edge of the region
+     * @param width     The region width
+     * @param height    The region height
+     *
+     * @return a reference to this (modified) texture for chaining.
+     */
+    const Texture& setRegion(const void *data, int x, int y, int width, int height);
+
 #pragma mark -
 #pragma mark Attributes
     /**
@@ -321,8 +407,62 @@ public:
      * This method will fail if this texture is a subtexture.  Only the parent
      * texture can have mipmaps.  In addition, mipmaps can only be built if the
      * texture size is a power of two.
+     *
+     * Mipmaps cannot be built for a compressed texture.  They must be
+     * prebuilt in the KTX image instead.
      */
     void buildMipMaps();
+
+    /**
+     * Returns true if this texture is compressed in GPU memory.
+     *
+     * If this texture is a subtexture of a compressed texture, this method
+     * will also return true.
+     *
+     * @return true if this texture is compressed in GPU memory.
+     */
+    bool isCompressed() const {
+        return (_parent != nullptr ? _parent->isCompressed() : _compressed != 0);
+    }
+
+    /**
+     * Returns the number of bytes of GPU memory used by this texture.
+     *
+     * This includes the memory for any mipmaps.  A subtexture reports the
+     * memory of its parent, as they share the same data.
+     *
+     * @return the number of bytes of GPU memory used by this texture.
+     */
+    size_t getByteSize() const {
+        return (_parent != nullptr ? _parent->getByteSize() : _byteSize);
+    }
+
+    /**
+     * Returns true if this texture stores a signed distance field.
+     *
+     * A distance field texture stores the distance to a shape edge in its
+     * alpha channel, with 0.5 on the edge itself.  A {@link SpriteShader}
+     * renders these textures with a smooth threshold, so that they stay sharp
+     * at any scale.  If this texture is a subtexture of a distance field, this
+     * method will also return true.
+     *
+     * @return true if this texture stores a signed distance field.
+     */
+    bool isDistanceField() const {
+        return (_parent != nullptr ? _parent->isDistanceField() : _distance);
+    }
+
+    /**
+     * Sets whether this texture stores a signed distance field.
+     *
+     * A distance field texture stores the distance to a shape edge in its
+     * alpha channel, with 0.5 on the edge itself.  A {@link SpriteShader}
+     * renders these textures with a smooth threshold, so that they stay sharp
+     * at any scale.  This value may not be set on a subtexture.
+     *
+     * @param value Whether this texture stores a signed distance field
+     */
+    void setDistanceField(bool value);
     
     /**
      * Returns the OpenGL buffer for this texture.
@@ -60,6 +60,84 @@ public:
     static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(Vertex2, texcoord);  }
 };
 
+/**
+ * This enum specifies the layout of the vertices uploaded by a SpriteBatch.
+ *
+ * A sprite batch always builds its mesh out of {@link Vertex2} records.  A
+ * compact layout repacks the mesh when it is uploaded, cutting the bytes
+ * sent to the GPU on each flush.  Texture coordinates are only compacted
+ * when they are all in [0,1] (they may be larger for repeating textures);
+ * otherwise the flush uses the full layout.  Half float positions are only
+ * used when every coordinate is at most 2048 in magnitude; otherwise the
+ * flush uses the compact layout.
+ */
+enum class VertexLayout : int {
+    /** Float positions and texture coordinates (20 bytes, see {@link Vertex2}) */
+    FULL    = 0,
+    /** Float positions and normalized 16-bit texture coordinates (16 bytes) */
+    COMPACT = 1,
+    /**
+     * Half float positions and normalized 16-bit texture coordinates (12 bytes)
+     *
+     * Half floats have 11 significant bits, so a position of magnitude 1024
+     * is rounded to the nearest unit.  Only use this layout if the world
+     * coordinates are small enough (or the scene is static enough) that this
+     * rounding is not visible.
+     */
+    HALF    = 2
+};
+
+/**
+ * This class/struct represents a 2d vertex in the COMPACT layout.
+ *
+ * The texture coordinates are normalized unsigned shorts, so 0xFFFF is 1.
+ *
+ * The class is intended to be used as a struct.  The static methods are to
+ * compute the offset for VBO access.
+ */
+class CompactVertex2 {
+public:
+    /** The vertex position */
+    cugl::Vec2    position;
+    /** The vertex color */
+    cugl::Color4  color;
+    /** The vertex texture coordinate (normalized) */
+    GLushort      texcoord[2];
+
+    /** The memory offset of the vertex position */
+    static const GLvoid* positionOffset()   { return (GLvoid*)offsetof(CompactVertex2, position);  }
+    /** The memory offset of the vertex color */
+    static const GLvoid* colorOffset()      { return (GLvoid*)offsetof(CompactVertex2, color);     }
+    /** The memory offset of the vertex texture coordinate */
+    static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(CompactVertex2, texcoord);  }
+};
+
+/**
+ * This class/struct represents a 2d vertex in the HALF layout.
+ *
+ * The position is a pair of half floats (IEEE 754 binary16), and the texture
+ * coordinates are normalized unsigned shorts, so 0xFFFF is 1.
+ *
+ * The class is intended to be used as a struct.  The static methods are to
+ * compute the offset for VBO access.
+ */
+class HalfVertex2 {
+public:
+    /** The vertex position (half floats) */
+    GLushort      position[2];
+    /** The vertex color */
+    cugl::Color4  color;
+    /** The vertex texture coordinate (normalized) */
+    GLushort      texcoord[2];
+
+    /** The memory offset of the vertex position */
+    static const GLvoid* positionOffset()   { return (GLvoid*)offsetof(HalfVertex2, position);  }
+    /** The memory offset of the vertex color */
+    static const GLvoid* colorOffset()      { return (GLvoid*)offsetof(HalfVertex2, color);     }
+    /** The memory offset of the vertex texture coordinate */
+    static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(HalfVertex2, texcoord);  }
+};
+
 /**
  * This class/struct represents the rendering information for a 2d vertex.
  *
@@ -83,6 +161,45 @@ public:
     static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(Vertex3, texcoord);  }
 };
 
+/**
+ * This class/struct represents the rendering information for a textured quad.
+ *
+ * A quad instance is expanded to a rectangle by the vertex shader of an
+ * instanced {@link SpriteShader}.  The corner (u,v) of the unit square is
+ * placed at origin + u*axisX + v*axisY, so the axes carry both the size of
+ * the rectangle and its (affine) transform.  The texture coordinates are
+ * interpolated from texcoord0 at corner (0,0) to texcoord1 at corner (1,1).
+ *
+ * The class is intended to be used as a struct.  The static methods are to
+ * compute the offset for VBO access.
+ */
+class QuadInstance {
+public:
+    /** The image of the x-axis of the unit square */
+    cugl::Vec2    axisX;
+    /** The image of the y-axis of the unit square */
+    cugl::Vec2    axisY;
+    /** The image of the origin of the unit square */
+    cugl::Vec2    origin;
+    /** The texture coordinate at corner (0,0) */
+    cugl::Vec2    texcoord0;
+    /** The texture coordinate at corner (1,1) */
+    cugl::Vec2    texcoord1;
+    /** The quad color */
+    cugl::Color4  color;
+
+    /** The memory offset of the x-axis */
+    static const GLvoid* axisXOffset()      { return (GLvoid*)offsetof(QuadInstance, axisX);     }
+    /** The memory offset of the y-axis */
+    static const GLvoid* axisYOffset()      { return (GLvoid*)offsetof(QuadInstance, axisY);     }
+    /** The memory offset of the origin */
+    static const GLvoid* originOffset()     { return (GLvoid*)offsetof(QuadInstance, origin);    }
+    /** The memory offset of the texture coordinates (both corners) */
+    static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(QuadInstance, texcoord0); }
+    /** The memory offset of the quad color */
+    static const GLvoid* colorOffset()      { return (GLvoid*)offsetof(QuadInstance, color);     }
+};
+
 }
 
 #endif /* __CU_VERTEX2_H__ */
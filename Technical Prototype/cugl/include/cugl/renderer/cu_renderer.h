@@ -29,9 +29,12 @@
 #define __CU_RENDERER_PKG_H__
 
 #include "CUVertex.h"
+#include "CUGLState.h"
 #include "CUTexture.h"
+#include "CUKTXImage.h"
 #include "CUShader.h"
 #include "CUSpriteShader.h"
+#include "CURenderTarget.h"
 #include "CUSpriteBatch.h"
 #include "CUCamera.h"
 #include "CUOrthographicCamera.h"
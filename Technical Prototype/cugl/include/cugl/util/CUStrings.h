@@ -11,6 +11,10 @@
 //  long, etc.  Those types are NOT cross-platform.  For example, a long is
 //  8 bytes on Unix/OS X, but 4 bytes on some Win32 platforms.
 //
+//  The functions to_chars and from_chars work on caller-provided buffers and
+//  never allocate.  They are the ones to use in per-frame code.  The string
+//  functions are built on top of them.
+//
 //  CUGL zlib License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -38,6 +42,9 @@
 #include <SDL/SDL.h>
 #include <string>
 
+/** A buffer size large enough for any number written by to_chars */
+#define CU_NUMBER_BUFFER    32
+
 namespace cugl {
     
 #pragma mark NUMBER TO STRING FUNCTIONS
@@ -109,7 +116,8 @@ namespace cugl {
     /**
      * Returns a string equivalent to the given float value
      *
-     * The precision is the same as std::to_string(float).
+     * The value reads back as the same float, and is nearly always the shortest
+     * decimal that does so.
      *
      * @param  value    the numeric value to convert
      *
@@ -120,7 +128,8 @@ namespace cugl {
     /**
      * Returns a string equivalent to the given double value
      *
-     * The precision is the same as std::to_string(double).
+     * The value reads back as the same double, and is nearly always the shortest
+     * decimal that does so.
      *
      * @param  value    the numeric value to convert
      *
@@ -393,6 +402,316 @@ namespace cugl {
      */
     double stod(const std::string& str, std::size_t* pos = 0);
     
+    
+#pragma mark -
+#pragma mark BUFFER FUNCTIONS
+    /**
+     * Writes the given byte to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Uint8 value);
+    
+    /**
+     * Writes the given signed 16 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Sint16 value);
+    
+    /**
+     * Writes the given unsigned 16 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Uint16 value);
+    
+    /**
+     * Writes the given signed 32 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Sint32 value);
+    
+    /**
+     * Writes the given unsigned 32 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Uint32 value);
+    
+    /**
+     * Writes the given signed 64 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Sint64 value);
+    
+    /**
+     * Writes the given unsigned 64 bit integer to the buffer [first, last)
+     *
+     * The value is written in decimal with no null terminator.  A buffer of
+     * CU_NUMBER_BUFFER characters is always large enough.  This function never
+     * allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, Uint64 value);
+    
+    /**
+     * Writes the given float to the buffer [first, last)
+     *
+     * The value reads back as the same float, and is nearly always the shortest
+     * decimal that does so.
+     * Large and small values use exponent notation (e.g. 1e+20), and all
+     * other values have a decimal point (e.g. 1.0).  Infinities and NaN are
+     * written as inf, -inf, and nan.
+     *
+     * The value has no null terminator.  A buffer of CU_NUMBER_BUFFER characters
+     * is always large enough.  This function never allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, float value);
+    
+    /**
+     * Writes the given double to the buffer [first, last)
+     *
+     * The value reads back as the same double, and is nearly always the shortest
+     * decimal that does so.
+     * Large and small values use exponent notation (e.g. 1e+20), and all
+     * other values have a decimal point (e.g. 1.0).  Infinities and NaN are
+     * written as inf, -inf, and nan.
+     *
+     * The value has no null terminator.  A buffer of CU_NUMBER_BUFFER characters
+     * is always large enough.  This function never allocates memory.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the numeric value to write
+     *
+     * @return one past the last character written, or nullptr if there is no room
+     */
+    char* to_chars(char* first, char* last, double value);
+    
+    /**
+     * Reads a byte from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Uint8& value);
+    
+    /**
+     * Reads a signed 16 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Sint16& value);
+    
+    /**
+     * Reads a unsigned 16 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Uint16& value);
+    
+    /**
+     * Reads a signed 32 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Sint32& value);
+    
+    /**
+     * Reads a unsigned 32 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Uint32& value);
+    
+    /**
+     * Reads a signed 64 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Sint64& value);
+    
+    /**
+     * Reads a unsigned 64 bit integer from the start of the buffer [first, last)
+     *
+     * The buffer must begin with decimal digits.  Unlike stoi and
+     * its relatives, this function does not skip whitespace.  It never
+     * allocates memory.
+     *
+     * If the buffer does not start with a number, or the number does not fit
+     * in the type, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, Uint64& value);
+    
+    /**
+     * Reads a float from the start of the buffer [first, last)
+     *
+     * The buffer must begin with a decimal number, optionally preceded by a
+     * minus sign and followed by an exponent.  Unlike stof and stod, this
+     * function does not skip whitespace, and it does not accept hexadecimal,
+     * inf, or nan.  It never allocates memory.
+     *
+     * If the buffer does not start with a number, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, float& value);
+    
+    /**
+     * Reads a double from the start of the buffer [first, last)
+     *
+     * The buffer must begin with a decimal number, optionally preceded by a
+     * minus sign and followed by an exponent.  Unlike stof and stod, this
+     * function does not skip whitespace, and it does not accept hexadecimal,
+     * inf, or nan.  It never allocates memory.
+     *
+     * If the buffer does not start with a number, then value is not changed.
+     *
+     * @param  first    the start of the buffer
+     * @param  last     the end of the buffer
+     * @param  value    the variable to store the number
+     *
+     * @return one past the last character read, or nullptr on failure
+     */
+    const char* from_chars(const char* first, const char* last, double& value);
+
 }
 
 #endif /* CU_STRINGS_H */
@@ -0,0 +1,135 @@
+//
+//  CUAnimationClip.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an immutable animation clip.  A clip is a sequence of
+//  frames in a sprite sheet, each with its own duration, together with the
+//  way the clip repeats.  Clips hold no playback state, so a single clip may
+//  be shared by every sprite that plays it.  Clips are played on animation
+//  nodes by a SpriteAnimator.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/2d/CUAnimationClip.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+
+#pragma mark Constructors
+/**
+ * Releases the frames of this clip.
+ *
+ * A disposed clip can be safely reinitialized.
+ */
+void AnimationClip::dispose() {
+    _frames.clear();
+    _durations.clear();
+    _length = 0;
+    _mode = Mode::ONCE;
+}
+
+/**
+ * Initializes a clip with the given frames.
+ *
+ * There must be one duration for each frame, and every duration must be
+ * positive.  All frames must be the same size.
+ *
+ * @param frames    The texture rectangle of each frame
+ * @param durations The duration of each frame in seconds
+ * @param mode      What happens at the end of this clip
+ *
+ * @return true if initialization was successful.
+ */
+bool AnimationClip::init(const std::vector<Rect>& frames, const std::vector<float>& durations, Mode mode) {
+    if (!_frames.empty()) {
+        CUAssertLog(false, "AnimationClip is already initialized");
+        return false;
+    } else if (frames.empty() || frames.size() != durations.size()) {
+        CULogError("AnimationClip needs one duration for each of its %d frames", (int)frames.size());
+        return false;
+    }
+    
+    float length = 0;
+    for(size_t ii = 0; ii < frames.size(); ii++) {
+        if (durations[ii] <= 0) {
+            CULogError("AnimationClip frame %d has a non-positive duration", (int)ii);
+            return false;
+        } else if (frames[ii].size != frames[0].size) {
+            CULogError("AnimationClip frame %d is not the same size as frame 0", (int)ii);
+            return false;
+        }
+        length += durations[ii];
+    }
+    
+    _frames = frames;
+    _durations = durations;
+    _length = length;
+    _mode = mode;
+    return true;
+}
+
+/**
+ * Initializes a clip from a sequence of frames in a filmstrip.
+ *
+ * The filmstrip is laid out as for {@link AnimationNode}, with frame 0
+ * in the top left corner.  The frames are given by their index in the
+ * filmstrip, and may repeat.  Every frame has the same duration.
+ *
+ * @param size      The size of the filmstrip texture
+ * @param rows      The number of rows in the filmstrip
+ * @param cols      The number of columns in the filmstrip
+ * @param frames    The filmstrip index of each frame
+ * @param duration  The duration of each frame in seconds
+ * @param mode      What happens at the end of this clip
+ *
+ * @return true if initialization was successful.
+ */
+bool AnimationClip::initWithFilmstrip(const Size& size, int rows, int cols,
+                                      const std::vector<int>& frames, float duration, Mode mode) {
+    CUAssertLog(rows > 0 && cols > 0, "Invalid filmstrip %dx%d", rows, cols);
+    Size frame(size.width/cols, size.height/rows);
+    
+    // Match the layout of AnimationNode::setFrame
+    std::vector<Rect> rects;
+    rects.reserve(frames.size());
+    for(auto it = frames.begin(); it != frames.end(); ++it) {
+        if (*it < 0 || *it >= rows*cols) {
+            CULogError("Invalid filmstrip frame %d for %dx%d", *it, rows, cols);
+            return false;
+        }
+        float x = (*it % cols)*frame.width;
+        float y = size.height - (1+*it/cols)*frame.height;
+        rects.push_back(Rect(Vec2(x,y),frame));
+    }
+    return init(rects, std::vector<float>(frames.size(),duration), mode);
+}
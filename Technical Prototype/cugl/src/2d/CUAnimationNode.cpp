@@ -42,6 +42,7 @@
 //  Version: 12/1/16
 //
 #include <cugl/2d/CUAnimationNode.h>
+#include <cugl/renderer/CUSpriteBatch.h>
 
 
 using namespace cugl;
@@ -62,8 +63,9 @@ AnimationNode::AnimationNode() :
 _cols(0),
 _size(0),
 _frame(0),
-_bounds(Rect::ZERO) {
-    _name = "AnimationNode";
+_bounds(Rect::ZERO),
+_shift(Vec2::ZERO) {
+    setName("AnimationNode");
 }
 
 /**
@@ -91,6 +93,7 @@ bool AnimationNode::initWithFilmstrip(const std::shared_ptr<Texture>& texture,
     _bounds.size = texture->getSize();
     _bounds.size.width /= cols;
     _bounds.size.height /= rows;
+    _shift = _bounds.origin;
     return this->initWithTexture(texture, _bounds);
 }
 
@@ -111,7 +114,86 @@ void AnimationNode::setFrame(int frame) {
     _frame = frame;
     float x = (frame % _cols)*_bounds.size.width;
     float y = _texture->getSize().height - (1+frame/_cols)*_bounds.size.height;
-    shiftPolygon(x-_bounds.origin.x, y-_bounds.origin.y);
     _bounds.origin.set(x,y);
 }
 
+/**
+ * Sets the active frame to the given rectangle of the texture.
+ *
+ * The rectangle is in texture pixels, with the origin at the bottom left
+ * corner of the texture.  It must be the same size as a single frame of
+ * the filmstrip.  This method allows a frame to come from anywhere in the
+ * texture, which is how {@link AnimationClip} frames are displayed.  It
+ * does not change the value of {@link getFrame()}.
+ *
+ * Changing the frame of a rectangular node only swaps the texture
+ * rectangle used at the next draw.  The polygon is only shifted (and its
+ * texture coordinates recomputed) if the node has a custom polygon.
+ *
+ * @param rect  The texture rectangle of the active frame
+ */
+void AnimationNode::setFrameRect(const Rect& rect) {
+    CUAssertLog(rect.size == _bounds.size, "Frame rectangle does not match the filmstrip");
+    _bounds.origin = rect.origin;
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this Node via the given SpriteBatch.
+ *
+ * This method only worries about drawing the current node.  It does not
+ * attempt to render the children.
+ *
+ * A rectangular node is drawn as a quad whose texture coordinates come
+ * from the active frame rectangle.  Otherwise, the polygon is shifted to
+ * the active frame (if necessary) and drawn as in {@link PolygonNode}.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void AnimationNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    if (!_rendered) {
+        generateRenderData();
+    }
+    if (!_quad) {
+        if (_shift != _bounds.origin) {
+            shiftPolygon(_bounds.origin.x-_shift.x, _bounds.origin.y-_shift.y);
+            _shift = _bounds.origin;
+        }
+        PolygonNode::draw(batch, transform, tint);
+        return;
+    }
+    
+    // The polygon is in the coordinates of the frame at _shift
+    Rect region = _polygon.getBounds();
+    region.origin += _bounds.origin-_shift;
+    
+    // Texture coordinates of the bottom left and top right corners (as in generateRenderData)
+    float w = (float)_texture->getWidth();
+    float h = (float)_texture->getHeight();
+    float s0 = region.getMinX()/w;
+    float s1 = region.getMaxX()/w;
+    float t0 = region.getMinY()/h;
+    float t1 = region.getMaxY()/h;
+    if (_flipHorizontal) { s0 = 1-s0; s1 = 1-s1; }
+    if (!_flipVertical)  { t0 = 1-t0; t1 = 1-t1; }
+    
+    Vec2 texcoord0(s0*_texture->getMaxS()+(1-s0)*_texture->getMinS(),
+                   t0*_texture->getMaxT()+(1-t0)*_texture->getMinT());
+    Vec2 texcoord1(s1*_texture->getMaxS()+(1-s1)*_texture->getMinS(),
+                   t1*_texture->getMaxT()+(1-t1)*_texture->getMinT());
+    
+    const Vertex2& bottom = _vertices[_quadCorners[0]];
+    const Vertex2& top = _vertices[_quadCorners[1]];
+    Rect rect(bottom.position.x, bottom.position.y,
+              top.position.x-bottom.position.x, top.position.y-bottom.position.y);
+    
+    batch->setColor(tint);
+    batch->setTexture(_texture);
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    batch->fillQuad(rect, texcoord0, texcoord1, transform);
+}
+
@@ -45,15 +45,74 @@
 
 #include <cugl/renderer/CUTexture.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <cugl/2d/CUFont.h>
 #include <algorithm>
 #include <utf8/utf8.h>
 #include <deque>
+#include <cmath>
+#include <cstring>
+#include <climits>
 
 using namespace cugl;
 
 /** The amount of border to put around a glyph to prevent bleeding. */
 #define GLYPH_BORDER    2
+/** A distance larger than any atlas cell (squared distances must not overflow) */
+#define DISTANCE_INF    1e20f
+
+/**
+ * Returns the key for a kerning pair
+ *
+ * @param a     The first glyph
+ * @param b     The second glyph
+ *
+ * @return the key for a kerning pair
+ */
+static inline Uint32 kerning_key(Uint32 a, Uint32 b) {
+    return (a << 16) | (b & 0xffff);
+}
+
+/**
+ * Computes the 1-dimensional squared distance transform of a grid line.
+ *
+ * This is the algorithm of Felzenszwalb and Huttenlocher, which computes the
+ * lower envelope of the parabolas rooted at each sample.  The line is
+ * transformed in place.  The scratch buffers f and v must hold length values,
+ * while z must hold length+1 values.
+ *
+ * @param grid      The grid of squared distances
+ * @param offset    The index of the first sample in the line
+ * @param stride    The distance between samples in the line
+ * @param length    The number of samples in the line
+ * @param f         Scratch buffer for the line samples
+ * @param v         Scratch buffer for the parabola roots
+ * @param z         Scratch buffer for the parabola boundaries
+ */
+static void distance_transform(float* grid, int offset, int stride, int length,
+                               float* f, int* v, float* z) {
+    v[0] = 0;
+    z[0] = -DISTANCE_INF;
+    z[1] =  DISTANCE_INF;
+    f[0] = grid[offset];
+    for(int q = 1, k = 0; q < length; q++) {
+        f[q] = grid[offset+q*stride];
+        float s = 0;
+        do {
+            int r = v[k];
+            s = (f[q]-f[r]+(float)(q*q-r*r))/(float)(2*(q-r));
+        } while (s <= z[k] && --k > -1);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = DISTANCE_INF;
+    }
+    for(int q = 0, k = 0; q < length; q++) {
+        while (z[k+1] < q) { k++; }
+        int r = v[k];
+        grid[offset+q*stride] = f[r]+(float)((q-r)*(q-r));
+    }
+}
 
 #pragma mark -
 #pragma mark Constructors
@@ -78,7 +137,17 @@ _style(Style::NORMAL),
 _hints(Hinting::NORMAL),
 _render(Resolution::BLENDED),
 _hasAtlas(false),
-_surface(nullptr) { }
+_hasDistance(false),
+_spread(0),
+_cellWidth(0),
+_cellHeight(0),
+_cellColumns(0),
+_slotsUsed(0),
+_clock(0),
+_version(0),
+_surface(nullptr) {
+    clearMetrics();
+}
 
 /**
  * Deletes the font resources and resets all attributes.
@@ -105,9 +174,16 @@ void Font::dispose() {
     _hasAtlas = false;
     _texture = nullptr;
     _glyphset.clear();
-    _glyphsize.clear();
+    clearMetrics();
     _glyphmap.clear();
-    _kernmap.clear();
+    _kerning.clear();
+    _hasDistance = false;
+    _spread = 0;
+    _cellWidth = _cellHeight = _cellColumns = 0;
+    _slots.clear();
+    _glyphslot.clear();
+    _slotsUsed = 0;
+    _clock = 0;
 }
 
 /**
@@ -127,7 +203,7 @@ bool Font::init(const std::string& file, int size) {
         CUAssertLog(false,"Font %s already loaded", _name.c_str());
         return false;
     }
-    _data = TTF_OpenFont(file.c_str(), size);
+    _data = TTF_OpenFontRW(AssetArchive::openFile(file,"rb"), 1, size);
     if (_data == nullptr) {
         CUAssertLog(false, "Font initialization error: %s", TTF_GetError());
         return false;
@@ -168,7 +244,12 @@ bool Font::init(const std::string& file, int size) {
  * @return true if this font has a glyph for the given (UNICODE) character.
  */
 bool Font::hasGlyph(Uint32 a) const {
-    if (_hasAtlas) {
+    // Cached ASCII glyphs can skip the hash lookup
+    if (_hasAtlas && a < FONT_ASCII_GLYPHS && _asciisize[a].advance >= 0) {
+        return true;
+    }
+    // A distance atlas adds missing glyphs on demand
+    if (_hasAtlas && !_hasDistance) {
         return _glyphmap.find(a) != _glyphmap.end();
     }
     
@@ -271,8 +352,8 @@ void Font::setHinting(Hinting hinting) {
  */
 const Font::Metrics Font::getMetrics(Uint32 thechar) const {
     if (_hasAtlas) {
-        CUAssertLog(_glyphmap.find(thechar) != _glyphmap.end(), "Character '%c' is not supported", thechar);
-        return _glyphsize.at(thechar);
+        CUAssertLog(hasGlyph(thechar), "Character '%c' is not supported", thechar);
+        return lookupMetrics(thechar);
     }
     
     CUAssertLog(TTF_GlyphIsProvided(_data, (Uint16)thechar), "Character '%c' is not supported", thechar);
@@ -297,9 +378,9 @@ const Font::Metrics Font::getMetrics(Uint32 thechar) const {
  */
 unsigned int Font::getKerning(Uint32 a, Uint32 b) const {
     if (_hasAtlas) {
-        CUAssertLog(_glyphmap.find(a) != _glyphmap.end(), "Character '%c' is not supported", a);
-        CUAssertLog(_glyphmap.find(b) != _glyphmap.end(), "Character '%c' is not supported", b);
-        return _kernmap.at(a).at(b);
+        CUAssertLog(hasGlyph(a), "Character '%c' is not supported", a);
+        CUAssertLog(hasGlyph(b), "Character '%c' is not supported", b);
+        return lookupKerning(a, b);
     }
     
     CUAssertLog(TTF_GlyphIsProvided(_data, (Uint16)a), "Character '%c' is not supported", a);
@@ -386,12 +467,17 @@ Rect Font::getInternalBounds(const std::string& text, bool utf8) const {
  */
 void Font::clearAtlas() {
     if (_surface != nullptr) { SDL_FreeSurface(_surface); _surface = nullptr;   }
+    if (_hasAtlas) { _version++; }
     _texture = nullptr;
     _glyphmap.clear();
     _glyphset.clear();
-    _glyphsize.clear();
-    _kernmap.clear();
+    clearMetrics();
+    _kerning.clear();
     _hasAtlas = false;
+    _hasDistance = false;
+    _slots.clear();
+    _glyphslot.clear();
+    _slotsUsed = 0;
 }
 
 /**
@@ -448,6 +534,89 @@ bool Font::buildAtlasAsync(const std::string& charset) {
     return _hasAtlas;
 }
 
+/**
+ * Creates a distance field atlas for the given character set.
+ *
+ * A distance atlas stores the signed distance to each glyph edge, so text
+ * drawn with it stays sharp at any scale.  The atlas has room for the
+ * given number of glyphs.  It starts with the glyphs in the character set
+ * (or the ASCII characters if the set is empty), and any other glyph is
+ * added the first time it is drawn.  If the atlas is full, the least
+ * recently used glyph is replaced.  If the character set is larger than
+ * the capacity, the capacity is increased to fit it.
+ *
+ * The spread is the distance, in pixels, over which the distance field
+ * falls off.  Larger spreads support effects such as outlines, at the
+ * cost of bigger atlas cells.
+ *
+ * This method does not generate the OpenGL texture, but does all other
+ * work in creates the atlas.  This creation will happen the first time
+ * that {@link getAtlas()} is called.
+ *
+ * As a result, this method is thread safe. It may be called in any
+ * thread, including threads other than the main one.
+ *
+ * @param charset   The initial characters in the atlas
+ * @param capacity  The number of glyphs in the atlas
+ * @param spread    The distance field spread in pixels
+ *
+ * @return true if the atlas was successfully created.
+ */
+bool Font::buildDistanceAtlasAsync(const std::string& charset, Uint32 capacity, Uint32 spread) {
+    clearAtlas();
+    
+    std::vector<Uint32> utf32;
+    if (charset.empty()) {
+        for(Uint32 ii = 32; ii < 127; ii++) {
+            utf32.push_back(ii);
+        }
+    } else {
+        std::string line = charset;
+        std::string::iterator end_it = utf8::find_invalid(line.begin(), line.end());
+        CUAssertLog(end_it == line.end(), "String '%s' has an invalid UTF-8 encoding",charset.c_str());
+        utf8::utf8to16(line.begin(), line.end(), back_inserter(utf32));
+    }
+    
+    // Cells must hold the initial glyphs, and should hold most square glyphs
+    int maxwidth = _fontHeight;
+    for(auto it = utf32.begin(); it != utf32.end(); ++it) {
+        CUAssertLog(*it <= USHRT_MAX, "SDL_TTF does not currently support UCS4");
+        if (_glyphsize.find(*it) == _glyphsize.end() && TTF_GlyphIsProvided(_data, (Uint16)*it)) {
+            Metrics metrics = computeMetrics(*it);
+            cacheMetrics(*it,metrics);
+            _glyphset.push_back(*it);
+            maxwidth = std::max(maxwidth, metrics.advance);
+        }
+    }
+    
+    _spread = (int)spread;
+    _cellWidth  = maxwidth+2*_spread;
+    _cellHeight = _fontHeight+2*_spread;
+    capacity = std::max(std::max(capacity, (Uint32)_glyphset.size()), (Uint32)1);
+    
+    // Keep the atlas as square as possible
+    _cellColumns = (int)std::ceil(std::sqrt((double)capacity*_cellHeight/_cellWidth));
+    int rows = ((int)capacity+_cellColumns-1)/_cellColumns;
+    _surface = allocSurface(_cellColumns*_cellWidth, rows*_cellHeight);
+    if (_surface == nullptr) {
+        clearAtlas();
+        return false;
+    }
+    
+    Slot empty;
+    empty.glyph = 0;
+    empty.stamp = 0;
+    _slots.assign(_cellColumns*rows, empty);
+    prepareAtlasKerning();
+    for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
+        renderDistanceGlyph(*it, _slotsUsed++);
+    }
+    
+    _hasAtlas = true;
+    _hasDistance = true;
+    return true;
+}
+
 /**
  * Returns the OpenGL texture for the associated atlas.
  *
@@ -462,6 +631,15 @@ const std::shared_ptr<Texture>& Font::getAtlas() {
         _texture = Texture::allocWithData(_surface->pixels, _surface->w, _surface->h);
         SDL_FreeSurface(_surface);
         _surface = nullptr;
+        
+        // Distance fields must be interpolated to find the edge
+        if (_hasDistance && _texture != nullptr) {
+            _texture->bind();
+            _texture->setMinFilter(GL_LINEAR);
+            _texture->setMagFilter(GL_LINEAR);
+            _texture->unbind();
+            _texture->setDistanceField(true);
+        }
     }
     return _texture;
 
@@ -583,6 +761,8 @@ std::shared_ptr<Texture> Font::getQuads(const std::string& text, const Vec2& ori
 std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, std::vector<Vertex2>& vertices) {
     Rect bounds(offset.x,offset.y, (float)getMetrics(thechar).advance, (float)_fontHeight);
     if (_hasAtlas) {
+        getAtlas();
+        _clock++;
         getAtlasQuad(thechar,offset,bounds,vertices);
         return _texture;
     }
@@ -617,6 +797,8 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, std::vector
 std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, const Rect& rect,
                                            std::vector<Vertex2>& vertices) {
     if (_hasAtlas) {
+        getAtlas();
+        _clock++;
         getAtlasQuad(thechar,offset,rect,vertices);
         return _texture;
     }
@@ -625,6 +807,58 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, const Rect&
 
 }
 
+/**
+ * Reserves the given glyphs in the atlas for a new string.
+ *
+ * This method is for classes that generate the quads of a string one
+ * glyph at a time (such as an incremental {@link Label}).  If this font
+ * has a distance field atlas, the glyphs are added to it if necessary, and
+ * are all marked as used by the same string.  Hence none of them will
+ * evict another.  Any other glyph may be evicted, so the caller should
+ * compare {@link getAtlasVersion()} before and after this call.
+ *
+ * This method will fail if the font does not have an atlas.
+ *
+ * @param glyphs    The (unicode) glyphs of the string
+ *
+ * @return the atlas texture
+ */
+const std::shared_ptr<Texture>& Font::reserveGlyphs(const std::vector<Uint32>& glyphs) {
+    CUAssertLog(_hasAtlas, "Font %s does not have an atlas", _name.c_str());
+    getAtlas();
+    _clock++;
+    if (_hasDistance) {
+        for(auto it = glyphs.begin(); it != glyphs.end(); ++it) {
+            if (hasGlyph(*it)) {
+                cacheGlyph(*it);
+            }
+        }
+    }
+    return _texture;
+}
+
+/**
+ * Creates a single quad for a glyph reserved by {@link reserveGlyphs}.
+ *
+ * This method is the same as {@link getQuad}, except that it does not
+ * start a new string in a distance field atlas.  It will not generate
+ * anything if the glyph is missing or lies outside of the rectangle.
+ *
+ * This method will fail if the font does not have an atlas.
+ *
+ * @param thechar   The character to convert to render data
+ * @param offset    The (unkerned) starting position of the quad
+ * @param rect      The bounding box for the quad
+ * @param vertices  The list to append the vertices to
+ *
+ * @return true if the right edge of the glyph was generated
+ */
+bool Font::getGlyphQuad(Uint32 thechar, Vec2& offset, const Rect& rect,
+                        std::vector<Vertex2>& vertices) {
+    CUAssertLog(_hasAtlas, "Font %s does not have an atlas", _name.c_str());
+    return getAtlasQuad(thechar,offset,rect,vertices);
+}
+
 
 #pragma mark -
 #pragma mark Rendering Internals
@@ -664,12 +898,15 @@ void Font::getAtlasQuads(const std::string& text, const Vec2& origin, const Rect
     std::string line = text;
     Vec2 offset = origin;
     
+    // Glyphs in this string may not be evicted while it is processed
+    _clock++;
+    
     if (!utf8) {
-        for(int ii = 0; ii < line.size(); ii++) {
+        for(int ii = 0; ii < line.size();) {
             if (ii > 0) {
-                offset.x -= _kernmap[line[ii-1]][line[ii]];
+                offset.x -= lookupKerning((Uint32)line[ii-1],(Uint32)line[ii]);
             }
-            ii = (getQuad(line[ii],offset,rect,vertices) ? ii+1 : (int)line.size());
+            ii = (getAtlasQuad((Uint32)line[ii],offset,rect,vertices) ? ii+1 : (int)line.size());
         }
         return;
     }
@@ -681,9 +918,9 @@ void Font::getAtlasQuads(const std::string& text, const Vec2& origin, const Rect
     
     for(int ii = 0; ii < utf32.size();) {
         if (ii > 0) {
-            offset.x -= _kernmap[utf32[ii-1]][utf32[ii]];
+            offset.x -= lookupKerning(utf32[ii-1],utf32[ii]);
         }
-        ii = (getQuad(utf32[ii],offset,rect,vertices) ? ii+1 : (int)utf32.size());
+        ii = (getAtlasQuad(utf32[ii],offset,rect,vertices) ? ii+1 : (int)utf32.size());
     }
 }
 
@@ -819,6 +1056,12 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect& rect,
     // Technically, this answer is correct
     if (!hasGlyph(thechar)) { return true; }
     
+    // The atlas is full of glyphs from this string; leave a gap
+    if (_hasDistance && !cacheGlyph(thechar)) {
+        offset.x += lookupMetrics(thechar).advance;
+        return offset.x <= rect.getMaxX();
+    }
+    
     Rect bounds = _glyphmap[thechar];
     Rect quad(offset,bounds.size);
     
@@ -999,9 +1242,9 @@ Size Font::getSizeASCII(const std::string& text) const {
     for(int ii = 0; ii < text.size(); ii++) {
         if (hasGlyph(text[ii])) {
             if (ii > 0) {
-                result.width -= _kernmap.at((Uint32)text[ii-1]).at((Uint32)text[ii]);
+                result.width -= lookupKerning((Uint32)text[ii-1],(Uint32)text[ii]);
             }
-            result.width += _glyphsize.at((Uint32)text[ii]).advance;
+            result.width += lookupMetrics((Uint32)text[ii]).advance;
         }
     }
     return result;
@@ -1044,9 +1287,9 @@ Size Font::getSizeUTF8(const std::string& text) const {
     for(int ii = 0; ii < utf32.size(); ii++) {
         if (hasGlyph(utf32[ii])) {
             if (ii > 0) {
-                result.width -= _kernmap.at(utf32[ii-1]).at(utf32[ii]);
+                result.width -= lookupKerning(utf32[ii-1],utf32[ii]);
             }
-            result.width += _glyphsize.at(utf32[ii]).advance;
+            result.width += lookupMetrics(utf32[ii]).advance;
         }
     }
     return result;
@@ -1099,7 +1342,7 @@ Rect Font::getInternalBoundsASCII(const std::string& text) const {
     for(int ii = 0; first == 0 && ii < text.size(); ii++) {
         Uint32 ch = (Uint32)text[ii];
         if (hasGlyph(ch)) {
-            metrics = (_hasAtlas ? _glyphsize.at(ch) : computeMetrics(ch));
+            metrics = lookupMetrics(ch);
             result.origin.x = (float)metrics.minx;
             result.size.width = (float)metrics.advance-metrics.minx;
             maxy = (metrics.maxy > maxy ? metrics.maxy : maxy);
@@ -1117,8 +1360,8 @@ Rect Font::getInternalBoundsASCII(const std::string& text) const {
     for(int ii = first+1; ii < text.size(); ii++) {
         Uint32 ch = (Uint32)text[ii];
         if (hasGlyph(ch)) {
-            result.size.width -= _kernmap.at(last).at(ch);
-            metrics = (_hasAtlas ? _glyphsize.at(ch) : computeMetrics(ch));
+            result.size.width -= lookupKerning(last, ch);
+            metrics = lookupMetrics(ch);
             result.size.width += metrics.advance;
             maxy = (metrics.maxy > maxy ? metrics.maxy : maxy);
             miny = (metrics.miny < miny ? metrics.miny : miny);
@@ -1186,7 +1429,7 @@ Rect Font::getInternalBoundsUTF8(const std::string& text) const {
     for(int ii = 0; first == -1 && ii < utf32.size(); ii++) {
         Uint32 ch = utf32[ii];
         if (hasGlyph(ch)) {
-            metrics = (_hasAtlas ? _glyphsize.at(ch) : computeMetrics(ch));
+            metrics = lookupMetrics(ch);
             result.origin.x = (float)metrics.minx;
             result.size.width = (float)(metrics.advance-metrics.minx);
             maxy = (metrics.maxy > maxy ? metrics.maxy : maxy);
@@ -1204,8 +1447,8 @@ Rect Font::getInternalBoundsUTF8(const std::string& text) const {
     for(int ii = first+1; ii < utf32.size(); ii++) {
         Uint32 ch = utf32[ii];
         if (hasGlyph(ch)) {
-            result.size.width -= (_hasAtlas ? _kernmap.at(last).at(ch) : computeKerning(last, ch));
-            metrics = (_hasAtlas ? _glyphsize.at(ch) : computeMetrics(ch));
+            result.size.width -= lookupKerning(last, ch);
+            metrics = lookupMetrics(ch);
             result.size.width += metrics.advance;
             maxy = (metrics.maxy > maxy ? metrics.maxy : maxy);
             miny = (metrics.miny < miny ? metrics.miny : miny);
@@ -1238,7 +1481,7 @@ int Font::prepareAtlas() {
     for(unsigned int ii = 32; ii < 127; ii++) {
         if (TTF_GlyphIsProvided(_data, (Uint16)ii)) {
             Metrics metrics = computeMetrics(ii);
-            _glyphsize.emplace(ii,metrics);
+            cacheMetrics(ii,metrics);
             _glyphmap.emplace(ii,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
             _glyphset.push_back(ii);
             if (metrics.advance > maxwidth) {
@@ -1279,7 +1522,7 @@ int Font::prepareAtlas(std::string charset) {
         Uint16 thechar = (Uint16)*it;
         if (_glyphmap.find(thechar) == _glyphmap.end() && TTF_GlyphIsProvided(_data, (Uint16)thechar)) {
             Metrics metrics = computeMetrics(thechar);
-            _glyphsize.emplace(thechar,metrics);
+            cacheMetrics(thechar,metrics);
             _glyphmap.emplace(thechar,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
             _glyphset.push_back(thechar);
             if (metrics.advance > maxwidth) {
@@ -1301,12 +1544,95 @@ int Font::prepareAtlas(std::string charset) {
  * Gathers the kerning information for the atlas.
  */
 void Font::prepareAtlasKerning() {
+    _kerning.clear();
     for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
-        _kernmap.emplace(*it, std::unordered_map<Uint32, Uint32>());
         for(auto jt = _glyphset.begin(); jt != _glyphset.end(); ++jt) {
-            _kernmap[*it].emplace(*jt, computeKerning(*it, *jt));
+            int amount = computeKerning(*it, *jt);
+            if (amount != 0) {
+                Kerning pair;
+                pair.pair = kerning_key(*it, *jt);
+                pair.amount = amount;
+                _kerning.push_back(pair);
+            }
+        }
+    }
+    std::sort(_kerning.begin(), _kerning.end(), [](const Kerning& a, const Kerning& b) {
+        return a.pair < b.pair;
+    });
+}
+
+/**
+ * Adds the kerning pairs for a new atlas glyph.
+ *
+ * The glyph is paired with itself and every glyph already in the
+ * glyph set, in both orders.  The glyph must already have cached
+ * metrics, but must not yet be in the glyph set.
+ *
+ * @param thechar   The glyph to add
+ */
+void Font::addKerning(Uint32 thechar) {
+    Kerning pair;
+    pair.amount = computeKerning(thechar, thechar);
+    if (pair.amount != 0) {
+        pair.pair = kerning_key(thechar, thechar);
+        _kerning.push_back(pair);
+    }
+    for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
+        pair.amount = computeKerning(thechar, *it);
+        if (pair.amount != 0) {
+            pair.pair = kerning_key(thechar, *it);
+            _kerning.push_back(pair);
+        }
+        pair.amount = computeKerning(*it, thechar);
+        if (pair.amount != 0) {
+            pair.pair = kerning_key(*it, thechar);
+            _kerning.push_back(pair);
         }
     }
+    std::sort(_kerning.begin(), _kerning.end(), [](const Kerning& a, const Kerning& b) {
+        return a.pair < b.pair;
+    });
+}
+
+/**
+ * Clears all cached glyph metrics.
+ */
+void Font::clearMetrics() {
+    _glyphsize.clear();
+    for(Uint32 ii = 0; ii < FONT_ASCII_GLYPHS; ii++) {
+        _asciisize[ii].advance = -1;
+    }
+}
+
+/**
+ * Returns the kerning adjustment between the two glyphs.
+ *
+ * This method uses the kerning table if both glyphs belong to the atlas,
+ * and computes the kerning otherwise.
+ *
+ * @param a     The first glyph
+ * @param b     The second glyph
+ *
+ * @return the kerning adjustment between the two glyphs.
+ */
+int Font::lookupKerning(Uint32 a, Uint32 b) const {
+    if (!_hasAtlas) {
+        return computeKerning(a, b);
+    }
+    
+    Uint32 key = kerning_key(a, b);
+    auto it = std::lower_bound(_kerning.begin(), _kerning.end(), key,
+                               [](const Kerning& pair, Uint32 key) { return pair.pair < key; });
+    if (it != _kerning.end() && it->pair == key) {
+        return it->amount;
+    }
+    
+    // A distance atlas only knows the pairs of glyphs it has seen
+    if (_hasDistance && (_glyphsize.find(a) == _glyphsize.end() ||
+                         _glyphsize.find(b) == _glyphsize.end())) {
+        return computeKerning(a, b);
+    }
+    return 0;
 }
 
 /**
@@ -1356,8 +1682,8 @@ int Font::computeKerning(Uint32 a, Uint32 b) const {
 
     int w1, w2;
     TTF_SizeUNICODE(_data, str, &w1, &w2);
-    w2 =  (!_glyphsize.empty() ? _glyphsize.at(a).advance : computeMetrics(a).advance);
-    w2 += (!_glyphsize.empty() ? _glyphsize.at(b).advance : computeMetrics(b).advance);
+    w2 =  lookupMetrics(a).advance;
+    w2 += lookupMetrics(b).advance;
     return w2-w1;
 }
 
@@ -1591,3 +1917,144 @@ SDL_Surface* Font::allocSurface(int width, int height) {
 }
 
 
+#pragma mark -
+#pragma mark Distance Atlas Internals
+/**
+ * Makes sure the given glyph is in the distance atlas.
+ *
+ * If the glyph is already present, this method marks it as used by the
+ * current string.  Otherwise it adds the glyph, replacing the least
+ * recently used glyph if the atlas is full.  A glyph used by the current
+ * string is never replaced.
+ *
+ * @param thechar   The glyph to cache
+ *
+ * @return true if the glyph is in the atlas.
+ */
+bool Font::cacheGlyph(Uint32 thechar) {
+    auto it = _glyphslot.find(thechar);
+    if (it != _glyphslot.end()) {
+        _slots[it->second].stamp = _clock;
+        return true;
+    }
+    
+    Uint32 slot = _slotsUsed;
+    if (_slotsUsed < _slots.size()) {
+        _slotsUsed++;
+    } else {
+        // Replace the least recently used glyph not in the current string
+        Uint32 oldest = 0;
+        for(Uint32 ii = 0; ii < _slots.size(); ii++) {
+            Uint32 age = _clock-_slots[ii].stamp;
+            if (age > oldest) {
+                slot = ii;
+                oldest = age;
+            }
+        }
+        if (oldest == 0) {
+            return false;
+        }
+        
+        Uint32 victim = _slots[slot].glyph;
+        _glyphmap.erase(victim);
+        _glyphslot.erase(victim);
+        _version++;
+    }
+    
+    // Metrics and kerning are kept even if the glyph is evicted
+    if (_glyphsize.find(thechar) == _glyphsize.end()) {
+        cacheMetrics(thechar, computeMetrics(thechar));
+        addKerning(thechar);
+        _glyphset.push_back(thechar);
+    }
+    renderDistanceGlyph(thechar, slot);
+    _slots[slot].stamp = _clock;
+    return true;
+}
+
+/**
+ * Renders the distance field for a glyph into the given atlas cell.
+ *
+ * If the atlas texture exists, the cell is uploaded to it directly.
+ * Otherwise it is written into the atlas surface.
+ *
+ * @param thechar   The glyph to render
+ * @param slot      The atlas cell
+ */
+void Font::renderDistanceGlyph(Uint32 thechar, Uint32 slot) {
+    int x = (int)(slot % _cellColumns)*_cellWidth;
+    int y = (int)(slot / _cellColumns)*_cellHeight;
+    int width  = std::min(lookupMetrics(thechar).advance, _cellWidth-2*_spread);
+    int height = _fontHeight;
+    
+    // Squared distances to the nearest pixel inside and outside of the glyph
+    size_t area = (size_t)_cellWidth*_cellHeight;
+    std::vector<float> outer(area, DISTANCE_INF);
+    std::vector<float> inner(area, 0.0f);
+    
+    SDL_Color color;
+    color.r = color.g = color.b = color.a = 255;
+    SDL_Surface* temp = TTF_RenderGlyph_Blended(_data, (Uint16)thechar, color);
+    if (temp != nullptr) {
+        SDL_LockSurface(temp);
+        int w = std::min(width, temp->w);
+        int h = std::min(height, temp->h);
+        for(int yy = 0; yy < h; yy++) {
+            Uint32* row = (Uint32*)((Uint8*)temp->pixels+yy*temp->pitch);
+            for(int xx = 0; xx < w; xx++) {
+                Uint8 r, g, b, a;
+                SDL_GetRGBA(row[xx], temp->format, &r, &g, &b, &a);
+                size_t pos = (size_t)(yy+_spread)*_cellWidth+(xx+_spread);
+                if (a == 255) {
+                    outer[pos] = 0;
+                    inner[pos] = DISTANCE_INF;
+                } else if (a > 0) {
+                    // Place the edge inside of antialiased pixels
+                    float d = 0.5f-a/255.0f;
+                    outer[pos] = (d > 0 ? d*d : 0);
+                    inner[pos] = (d < 0 ? d*d : 0);
+                }
+            }
+        }
+        SDL_UnlockSurface(temp);
+        SDL_FreeSurface(temp);
+    }
+    
+    int length = std::max(_cellWidth, _cellHeight);
+    std::vector<float> f(length);
+    std::vector<int>   v(length);
+    std::vector<float> z(length+1);
+    for(int xx = 0; xx < _cellWidth; xx++) {
+        distance_transform(outer.data(), xx, _cellWidth, _cellHeight, f.data(), v.data(), z.data());
+        distance_transform(inner.data(), xx, _cellWidth, _cellHeight, f.data(), v.data(), z.data());
+    }
+    for(int yy = 0; yy < _cellHeight; yy++) {
+        distance_transform(outer.data(), yy*_cellWidth, 1, _cellWidth, f.data(), v.data(), z.data());
+        distance_transform(inner.data(), yy*_cellWidth, 1, _cellWidth, f.data(), v.data(), z.data());
+    }
+    
+    // The edge maps to 0.5, and the spread covers the rest of the range
+    std::vector<Uint8> pixels(area*4);
+    for(size_t ii = 0; ii < area; ii++) {
+        float d = std::sqrt(outer[ii])-std::sqrt(inner[ii]);
+        float value = 0.5f-d/(2*_spread);
+        value = (value < 0 ? 0 : (value > 1 ? 1 : value));
+        pixels[4*ii  ] = 255;
+        pixels[4*ii+1] = 255;
+        pixels[4*ii+2] = 255;
+        pixels[4*ii+3] = (Uint8)(value*255+0.5f);
+    }
+    
+    if (_texture != nullptr) {
+        _texture->setRegion(pixels.data(), x, y, _cellWidth, _cellHeight);
+    } else if (_surface != nullptr) {
+        Uint8* dst = (Uint8*)_surface->pixels+y*_surface->pitch+x*4;
+        for(int yy = 0; yy < _cellHeight; yy++) {
+            std::memcpy(dst+yy*_surface->pitch, pixels.data()+yy*_cellWidth*4, _cellWidth*4);
+        }
+    }
+    
+    _slots[slot].glyph = thechar;
+    _glyphslot[thechar] = slot;
+    _glyphmap[thechar] = Rect((float)(x+_spread), (float)(y+_spread), (float)width, (float)height);
+}
@@ -38,8 +38,23 @@
 //  Author: Walker White
 //  Version: 7/6/16
 #include <cugl/2d/CULabel.h>
+#include <cugl/util/CUStrings.h>
+#include <utf8/utf8.h>
+#include <climits>
 
 using namespace cugl;
+
+/**
+ * Returns true if the glyph is an (ASCII) digit
+ *
+ * @param thechar   The glyph to test
+ *
+ * @return true if the glyph is an (ASCII) digit
+ */
+static bool is_digit(Uint32 thechar) {
+    return thechar >= '0' && thechar <= '9';
+}
+
 #pragma mark Constructors
 
 /**
@@ -55,7 +70,12 @@ _foreground(Color4::BLACK),
 _background(Color4::CLEAR),
 _halign(HAlign::LEFT),
 _valign(VAlign::BOTTOM),
-_rendered(false)
+_rendered(false),
+_atlasVersion(0),
+_incremental(false),
+_tabular(false),
+_quadBase(0),
+_quadBackdrop(false)
 {}
 
 /**
@@ -68,7 +88,14 @@ _rendered(false)
  * a scene graph.
  */
 void Label::dispose() {
+    _incremental = false;
+    _tabular = false;
     clearRenderData();
+    _glyphs.clear();
+    _pens.clear();
+    _quadGlyphs.clear();
+    _quadPens.clear();
+    _texture = nullptr;
     _text.clear();
     _font = nullptr;
     _foreground = Color4::BLACK;
@@ -155,22 +182,100 @@ bool Label::initWithText(const std::string& text, const std::shared_ptr<Font>& f
  * @oaram resize    Whether to resize the label to fit the new text.
  */
 void Label::setText(const std::string& text, bool resize) {
-    // Let's strip the non-printable characters first
-    _text.clear();
-    _text.reserve(text.size());
-    for(auto it = text.begin(); it != text.end(); ++it) {
-        if (((Uint32)*it) > 32 && *it != 127) {
-            _text.push_back(*it);
+    assignText(text.c_str(), text.size(), resize);
+}
+
+/**
+ * Sets the text for this label to the given integer.
+ *
+ * The number is formatted without allocating a string.  If the label
+ * already displays this number (and resize is false), this method does
+ * nothing.  Combined with an incremental label, this makes a counter
+ * that can be updated every frame for free.
+ *
+ * @oaram value     The number to display
+ * @oaram resize    Whether to resize the label to fit the new text.
+ */
+void Label::setNumber(Sint64 value, bool resize) {
+    char buffer[CU_NUMBER_BUFFER];
+    size_t length = to_chars(buffer, buffer+CU_NUMBER_BUFFER, value)-buffer;
+    if (!resize && _text.compare(0, std::string::npos, buffer, length) == 0) {
+        return;
+    }
+    assignText(buffer, length, resize);
+}
+
+/**
+ * Sets whether this label updates its text incrementally.
+ *
+ * An incremental label keeps one quad per glyph in its vertex buffer.
+ * When the text changes, it only rewrites the quads of glyphs that
+ * changed or moved.  Once the label has enough capacity, setting the text
+ * performs no allocations.  This is ideal for labels that change every
+ * frame, such as counters and timers.
+ *
+ * Incremental updates require a font atlas.  Without one, the label is
+ * regenerated in full, as usual.
+ *
+ * @param value     Whether to update the text incrementally
+ * @param capacity  The number of glyphs to reserve space for
+ */
+void Label::setIncremental(bool value, size_t capacity) {
+    if (_incremental != value) {
+        _incremental = value;
+        _vertices.clear();
+        _indices.clear();
+        _quadGlyphs.clear();
+        _quadPens.clear();
+        _texture = nullptr;
+        _rendered = false;
+        if (value) {
+            decodeText();
         } else {
-            _text.push_back(' ');
+            _glyphs.clear();
+            _pens.clear();
         }
     }
-    
-    if (resize) {
-        computeSize();
-        setContentSize(_textbounds.size);
+    reserve(std::max(capacity, _glyphs.size()));
+}
+
+/**
+ * Reserves space for text with the given number of glyphs.
+ *
+ * An incremental label will not allocate memory when its text changes,
+ * provided that the text has at most this many glyphs (and bytes).
+ *
+ * @param capacity  The number of glyphs to reserve space for
+ */
+void Label::reserve(size_t capacity) {
+    _text.reserve(capacity);
+    _glyphs.reserve(capacity);
+    _pens.reserve(capacity);
+    _quadGlyphs.reserve(capacity);
+    _quadPens.reserve(capacity);
+    _vertices.reserve(4*capacity+4);
+    _indices.reserve(6*capacity+6);
+    _scratch.reserve(4);
+}
+
+/**
+ * Sets whether the digits share a common (tabular) advance.
+ *
+ * With tabular digits, every digit takes the width of the widest digit,
+ * and is centered in that space.  Digits are also not kerned.  Hence a
+ * number does not shift as its digits change, and an incremental label
+ * only rewrites the digits that actually changed.
+ *
+ * Tabular digits are only supported by incremental labels.  This setting
+ * does not resize the label.
+ *
+ * @param value Whether the digits share a common (tabular) advance.
+ */
+void Label::setTabularDigits(bool value) {
+    if (_tabular != value) {
+        _tabular = value;
+        clearRenderData();
     }
-    clearRenderData();
 }
 
 /**
@@ -379,6 +484,10 @@ void Label::setBackground(Color4 color) {
  * @param tint      The tint to blend with the Node color.
  */
 void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    // A distance atlas may have replaced some of our glyphs
+    if (_rendered && _font->getAtlasVersion() != _atlasVersion) {
+        clearRenderData();
+    }
     if (!_rendered) {
         generateRenderData();
     }
@@ -406,6 +515,38 @@ void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transfor
 
 #pragma mark -
 #pragma mark Internal Helpers
+/**
+ * Sets the text for this label to the given characters.
+ *
+ * This is the implementation of {@link setText}.  It removes the
+ * unprintable characters, exactly as that method does.
+ *
+ * @param text      The characters of the text
+ * @param length    The number of characters
+ * @param resize    Whether to resize the label to fit the new text.
+ */
+void Label::assignText(const char* text, size_t length, bool resize) {
+    // Let's strip the non-printable characters first
+    _text.clear();
+    _text.reserve(length);
+    for(size_t ii = 0; ii < length; ii++) {
+        if (((Uint32)text[ii]) > 32 && text[ii] != 127) {
+            _text.push_back(text[ii]);
+        } else {
+            _text.push_back(' ');
+        }
+    }
+    if (_incremental) {
+        decodeText();
+    }
+    
+    if (resize) {
+        computeSize();
+        setContentSize(_textbounds.size);
+    }
+    clearRenderData();
+}
+
 /**
  * Computes the default size of this label and stores it in _textbounds
  *
@@ -417,8 +558,12 @@ void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transfor
  * done manually.
  */
 void Label::computeSize() {
-    _textbounds.size = _font->getSize(_text);
-    _truebounds = _font->getInternalBounds(_text);
+    if (_incremental && _font->hasAtlas()) {
+        measureGlyphs();
+    } else {
+        _textbounds.size = _font->getSize(_text);
+        _truebounds = _font->getInternalBounds(_text);
+    }
     
     // This will fix the offsets
     setHorizontalAlignment(_halign);
@@ -429,6 +574,18 @@ void Label::computeSize() {
  * Allocate the render data necessary to render this node.
  */
 void Label::generateRenderData() {
+    if (_incremental) {
+        if (_font->hasAtlas()) {
+            updateRenderData();
+            return;
+        }
+        // Without an atlas, the label is regenerated in full
+        _vertices.clear();
+        _indices.clear();
+        _quadGlyphs.clear();
+        _quadPens.clear();
+    }
+    
     // Make the backdrop
     Rect bounds(Vec2::ZERO,getContentSize());
     unsigned int vsize = 0;
@@ -472,18 +629,227 @@ void Label::generateRenderData() {
         _indices.push_back(jj+2); _indices.push_back(jj+3); _indices.push_back(jj  );
     }
 
+    _atlasVersion = _font->getAtlasVersion();
     _rendered = true;
+    invalidateBounds();
 }
 
 /**
  * Clears the render data, releasing all vertices and indices.
  */
 void Label::clearRenderData() {
-    _vertices.clear();
-    _indices.clear();
+    // Incremental labels keep their quads to compare against the new text
+    if (!_incremental) {
+        _vertices.clear();
+        _indices.clear();
+    }
     _rendered = false;
 }
 
+/**
+ * Decodes the text into the glyph buffer.
+ */
+void Label::decodeText() {
+    _glyphs.clear();
+    std::string::iterator end = utf8::find_invalid(_text.begin(), _text.end());
+    CUAssertLog(end == _text.end(), "String '%s' has an invalid UTF-8 encoding",_text.c_str());
+    for(auto it = _text.begin(); it != end; ) {
+        _glyphs.push_back(utf8::unchecked::next(it));
+    }
+}
+
+/**
+ * Computes the position of each glyph relative to the text origin.
+ *
+ * This method stores the positions in _pens, and requires a font atlas.
+ *
+ * @return the total advance of the text
+ */
+float Label::layoutGlyphs() {
+    // Tabular digits all use the advance of the widest digit
+    int digits = 0;
+    if (_tabular) {
+        for(Uint32 ch = '0'; ch <= '9'; ch++) {
+            if (_font->hasGlyph(ch)) {
+                digits = std::max(digits, _font->getMetrics(ch).advance);
+            }
+        }
+    }
+    
+    _pens.clear();
+    float pen = 0;
+    Uint32 last = 0;
+    bool first = true;
+    for(auto it = _glyphs.begin(); it != _glyphs.end(); ++it) {
+        Uint32 ch = *it;
+        if (!_font->hasGlyph(ch)) {
+            _pens.push_back(pen);
+            continue;
+        }
+        
+        bool digit = (digits > 0 && is_digit(ch));
+        if (!first && !(digits > 0 && (digit || is_digit(last)))) {
+            pen -= (float)(int)_font->getKerning(last, ch);
+        }
+        int advance = _font->getMetrics(ch).advance;
+        if (digit) {
+            _pens.push_back(pen+(float)((digits-advance)/2));
+            pen += (float)digits;
+        } else {
+            _pens.push_back(pen);
+            pen += (float)advance;
+        }
+        last = ch;
+        first = false;
+    }
+    return pen;
+}
+
+/**
+ * Computes the text bounds from the glyph metrics.
+ *
+ * This is the incremental version of {@link computeSize}.  It gives the
+ * same results as the font measurements, but does not allocate memory.
+ */
+void Label::measureGlyphs() {
+    float width = layoutGlyphs();
+    _textbounds.size.set(width, (float)_font->getHeight());
+    
+    // The true bounds run from the left edge of the first glyph to the right of the last
+    bool found = false;
+    float right = 0;
+    int maxy = 0;
+    int miny = 0;
+    for(size_t ii = 0; ii < _glyphs.size(); ii++) {
+        Uint32 ch = _glyphs[ii];
+        if (_font->hasGlyph(ch)) {
+            Font::Metrics metrics = _font->getMetrics(ch);
+            if (!found) {
+                _truebounds.origin.x = _pens[ii]+metrics.minx;
+                found = true;
+            }
+            right = _pens[ii]+metrics.maxx;
+            maxy = (metrics.maxy > maxy ? metrics.maxy : maxy);
+            miny = (metrics.miny < miny ? metrics.miny : miny);
+        }
+    }
+    
+    if (!found) {
+        _truebounds = Rect();
+        return;
+    }
+    _truebounds.size.width = right-_truebounds.origin.x;
+    _truebounds.origin.y = (float)(-_font->getDescent()+miny);
+    _truebounds.size.height = (float)(maxy-miny);
+}
+
+/**
+ * Updates the render data, rewriting only the quads that changed.
+ *
+ * This method requires a font atlas.
+ */
+void Label::updateRenderData() {
+    Rect bounds(Vec2::ZERO,getContentSize());
+    bool backdrop = (_background != Color4::CLEAR);
+    const std::shared_ptr<Texture>& atlas = _font->reserveGlyphs(_glyphs);
+    
+    // Anything that moves every glyph (or the atlas) invalidates all quads
+    if (_texture != atlas || _atlasVersion != _font->getAtlasVersion() ||
+        _quadBackdrop != backdrop || _quadBounds != bounds.size ||
+        _quadBase != _textbounds.origin.y) {
+        _vertices.clear();
+        _indices.clear();
+        _quadGlyphs.clear();
+        _quadPens.clear();
+        _texture = atlas;
+        _atlasVersion = _font->getAtlasVersion();
+        _quadBackdrop = backdrop;
+        _quadBounds = bounds.size;
+        _quadBase = _textbounds.origin.y;
+        
+        if (backdrop) {
+            Vertex2 temp;
+            temp.color = _background;
+            _vertices.push_back(temp);
+            temp.position.x = bounds.size.width;
+            _vertices.push_back(temp);
+            temp.position.y = bounds.size.height;
+            _vertices.push_back(temp);
+            temp.position.x = 0;
+            _vertices.push_back(temp);
+            _indices.push_back(0); _indices.push_back(1); _indices.push_back(2);
+            _indices.push_back(2); _indices.push_back(3); _indices.push_back(0);
+        }
+    }
+    
+    layoutGlyphs();
+    size_t offset = (backdrop ? 4 : 0);
+    size_t count  = _glyphs.size();
+    size_t valid  = _quadGlyphs.size();
+    CUAssertLog(offset+4*count <= USHRT_MAX+1, "Label '%s' has too many glyphs", _text.c_str());
+    
+    // Every glyph has a quad, so the indices only depend on the glyph count
+    _vertices.resize(offset+4*count);
+    size_t quads = _indices.size()/6-(backdrop ? 1 : 0);
+    for(size_t ii = quads; ii < count; ii++) {
+        unsigned short jj = (unsigned short)(offset+4*ii);
+        _indices.push_back(jj  ); _indices.push_back(jj+1); _indices.push_back(jj+2);
+        _indices.push_back(jj+2); _indices.push_back(jj+3); _indices.push_back(jj  );
+    }
+    _indices.resize(6*(count+(backdrop ? 1 : 0)));
+    
+    for(size_t ii = 0; ii < count; ii++) {
+        Uint32 ch = _glyphs[ii];
+        float pen = _textbounds.origin.x+_pens[ii];
+        if (ii < valid) {
+            if (_quadGlyphs[ii] == ch && _quadPens[ii] == pen) {
+                continue;
+            }
+            _quadGlyphs[ii] = ch;
+            _quadPens[ii] = pen;
+        } else {
+            _quadGlyphs.push_back(ch);
+            _quadPens.push_back(pen);
+        }
+        writeQuad(offset+4*ii, ch, pen, bounds);
+    }
+    _quadGlyphs.resize(count);
+    _quadPens.resize(count);
+    _rendered = true;
+    invalidateBounds();
+}
+
+/**
+ * Writes the quad for a single glyph to the vertex buffer.
+ *
+ * If the glyph generates no quad, the quad is made degenerate.
+ *
+ * @param index     The first vertex of the quad
+ * @param thechar   The glyph to write
+ * @param pen       The x-position of the glyph
+ * @param bounds    The bounding box for the quad
+ */
+void Label::writeQuad(size_t index, Uint32 thechar, float pen, const Rect& bounds) {
+    _scratch.clear();
+    Vec2 offset(pen,_textbounds.origin.y);
+    _font->getGlyphQuad(thechar, offset, bounds, _scratch);
+    
+    Vertex2* quad = _vertices.data()+index;
+    if (_scratch.size() == 4) {
+        for(int ii = 0; ii < 4; ii++) {
+            quad[ii] = _scratch[ii];
+            quad[ii].color = _foreground;
+        }
+    } else {
+        // Missing or clipped glyphs keep their slot with an empty quad
+        for(int ii = 0; ii < 4; ii++) {
+            quad[ii].position.set(pen,_textbounds.origin.y);
+            quad[ii].texcoord = Vec2::ZERO;
+            quad[ii].color = _foreground;
+        }
+    }
+}
+
 /**
  * Updates the color value for any other data that needs it.
  *
@@ -495,11 +861,14 @@ void Label::updateColor() {
         return;
     }
     
-    for(auto it = _vertices.begin(); it != _vertices.begin()+4; ++it) {
-        it->color = _background;
+    auto glyphs = _vertices.begin();
+    if (_background != Color4::CLEAR) {
+        for(; glyphs != _vertices.begin()+4; ++glyphs) {
+            glyphs->color = _background;
+        }
     }
     
-    for(auto it = _vertices.begin()+4; it != _vertices.end(); ++it) {
+    for(auto it = glyphs; it != _vertices.end(); ++it) {
         it->color = _foreground;
     }
 }
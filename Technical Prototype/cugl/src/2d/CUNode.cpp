@@ -37,9 +37,12 @@
 #include <cugl/2d/CUNode.h>
 #include <cugl/2d/CUScene.h>
 #include <cugl/renderer/CUCamera.h>
+#include <cugl/renderer/CURenderTarget.h>
+#include <cugl/renderer/CUGLState.h>
 #include <cugl/util/CUStrings.h>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 
 using namespace cugl;
 
@@ -55,7 +58,7 @@ using namespace cugl;
 Node::Node() :
 _tag(0),
 _name(""),
-_hashOfName(0),
+_hashOfName(std::hash<std::string>()("")),
 _tintColor(Color4::WHITE),
 _hasParentColor(true),
 _isVisible(true),
@@ -67,6 +70,15 @@ _parent(nullptr),
 _graph(nullptr),
 _zOrder(0),
 _zDirty(false),
+_indexDirty(true),
+_subtreeEmpty(true),
+_subtreeNodes(1),
+_subtreeVerts(0),
+_boundsDirty(true),
+_cacheEnabled(false),
+_cacheDirty(true),
+_cacheWidth(0),
+_cacheHeight(0),
 _childOffset(-2) {}
 
 /**
@@ -166,9 +178,15 @@ void Node::dispose() {
     _childOffset = -2;
     _tag = 0;
     _name = "";
-    _hashOfName = 0;
+    _hashOfName = std::hash<std::string>()(_name);
     _zOrder = 0;
     _zDirty = false;
+    _boundsDirty = true;
+    _cache = nullptr;
+    _cacheEnabled = false;
+    _cacheDirty = true;
+    _cacheWidth  = 0;
+    _cacheHeight = 0;
 }
 
 /**
@@ -197,6 +215,10 @@ Node* Node::copy(Node* dst) {
     dst->_tag = _tag;
     dst->_name = _name;
     dst->_hashOfName = _hashOfName;
+    if (dst->_parent != nullptr) {
+        dst->_parent->_indexDirty = true;
+    }
+    dst->invalidateBounds();
 
     dst->setZOrder(_zOrder);
     return dst;
@@ -220,6 +242,9 @@ void Node::setPosition(float x, float y) {
     _combined.m[12] += (x-_position.x);
     _combined.m[13] += (y-_position.y);
     _position.set(x,y);
+    if (_parent != nullptr) {
+        _parent->invalidateBounds();
+    }
 }
 
 /**
@@ -237,6 +262,7 @@ void Node::setPosition(float x, float y) {
  */
 void Node::setContentSize(const Size& size) {
     _contentSize.set(size);
+    invalidateBounds();
     if (!_useTransform) updateTransform();
 }
 
@@ -371,6 +397,9 @@ void Node::updateTransform() {
     }
     _combined.m[12] += _position.x-offset.x;
     _combined.m[13] += _position.y-offset.y;
+    if (_parent != nullptr) {
+        _parent->invalidateBounds();
+    }
 }
 
 
@@ -417,11 +446,18 @@ const std::shared_ptr<Node>& Node::getChild(unsigned int pos) const {
  * guaranteed for subclasses of Node. Hence it is very important that
  * tags be unique.
  *
+ * Nodes with many children keep a hash index of their child tags, so
+ * this lookup does not need to search every child.
+ *
  * @param tag   An identifier to find the child node.
  *
  * @return the (first) child with the given tag.
  */
 std::shared_ptr<Node> Node::getChildByTag(unsigned int tag) const {
+    if (buildIndex()) {
+        auto it = _tagIndex.find(tag);
+        return (it == _tagIndex.end() ? nullptr : _children[it->second]);
+    }
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getTag() == tag) {
             return *it;
@@ -439,11 +475,22 @@ std::shared_ptr<Node> Node::getChildByTag(unsigned int tag) const {
  * guaranteed for subclasses of Node. Hence it is very important that
  * names be unique.
  *
+ * Nodes with many children keep a hash index of their child names, so
+ * a lookup that hits the index does not need to search every child.
+ * A miss still searches the children.
+ *
  * @param name  An identifier to find the child node.
  *
  * @return the (first) child with the given name.
  */
 std::shared_ptr<Node> Node::getChildByName(const std::string& name) const {
+    if (buildIndex()) {
+        auto it = _nameIndex.find(std::hash<std::string>()(name));
+        if (it != _nameIndex.end() && _children[it->second]->_name == name) {
+            return _children[it->second];
+        }
+        // A miss or a hash collision; fall through to the search
+    }
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         if ((*it)->getName() == name) {
             return *it;
@@ -484,7 +531,11 @@ void Node::addChild(const std::shared_ptr<Node>& child, int zval) {
     _children.push_back(child);
     child->setParent(this);
     child->pushScene(_graph);
-    
+    if (!_indexDirty) {
+        _tagIndex.emplace(child->_tag, child->_childOffset);
+        _nameIndex.emplace(child->_hashOfName, child->_childOffset);
+    }
+    invalidateBounds();
 }
 
 /**
@@ -503,6 +554,8 @@ void Node::addChild(const std::shared_ptr<Node>& child, int zval) {
 void Node::swapChild(const std::shared_ptr<Node>& child1, const std::shared_ptr<Node>& child2, bool inherit) {
     _children[child1->_childOffset] = child2;
     child2->_childOffset = child1->_childOffset;
+    _indexDirty = true;
+    invalidateBounds();
     child2->setParent(this);
     child1->setParent(nullptr);
     child2->pushScene(_graph);
@@ -535,6 +588,8 @@ void Node::removeChild(unsigned int pos) {
     child->setParent(nullptr);
     child->pushScene(nullptr);
     child->_childOffset = -1;
+    _indexDirty = true;
+    invalidateBounds();
     for(int ii = pos; ii < _children.size()-1; ii++) {
         _children[ii] = _children[ii+1];
         _children[ii]->_childOffset = ii;
@@ -604,6 +659,8 @@ void Node::removeAllChildren() {
     }
     _children.clear();
     _zDirty = false;
+    _indexDirty = true;
+    invalidateBounds();
 }
 
 /**
@@ -621,6 +678,39 @@ void Node::pushScene(Scene* scene) {
     }
 }
 
+/**
+ * Rebuilds the child lookup indices if they are out of date.
+ *
+ * The indices map each tag and name hash to the offset of the first
+ * child with that tag or name.  They are only built for nodes with
+ * at least NODE_INDEX_THRESHOLD children.  Smaller nodes are searched
+ * linearly, which is faster than hashing for so few children.
+ *
+ * @return true if the indices may be used for lookup.
+ */
+bool Node::buildIndex() const {
+    if (_children.size() < NODE_INDEX_THRESHOLD) {
+        if (!_indexDirty) {
+            _tagIndex.clear();
+            _nameIndex.clear();
+            _indexDirty = true;
+        }
+        return false;
+    } else if (_indexDirty) {
+        _tagIndex.clear();
+        _nameIndex.clear();
+        _tagIndex.reserve(_children.size());
+        _nameIndex.reserve(_children.size());
+        // Emplace keeps the first child for each key
+        for(int ii = 0; ii < _children.size(); ii++) {
+            _tagIndex.emplace(_children[ii]->_tag, ii);
+            _nameIndex.emplace(_children[ii]->_hashOfName, ii);
+        }
+        _indexDirty = false;
+    }
+    return true;
+}
+
 
 #pragma mark -
 #pragma mark Z-Order
@@ -725,6 +815,7 @@ void Node::sortZOrder() {
             (*it)->_childOffset = ii++;
         }
         _zDirty = false;
+        _indexDirty = true;
         // Invariant guarantees this is the only way they are dirty
         for(auto it = _children.begin(); it != _children.end(); ++it ) {
             (*it)->sortZOrder();
@@ -752,6 +843,15 @@ void Node::sortZOrder() {
 void Node::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
     if (!_isVisible) { return; }
     
+    if (batch->isDeferred() && (_cacheEnabled || !isConcurrent())) {
+        // Draw this subtree on the thread that replays the batch
+        Node* node = this;
+        batch->defer([=](const std::shared_ptr<SpriteBatch>& target) {
+            node->render(target, transform, tint);
+        });
+        return;
+    }
+    
     Mat4 matrix;
     Mat4::multiply(_combined,transform,&matrix);
     Color4 color = _tintColor;
@@ -759,12 +859,231 @@ void Node::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transfo
         color *= tint;
     }
     
+    if (_cacheEnabled) {
+        renderCached(batch, matrix, color);
+        return;
+    }
+    
     draw(batch,matrix,color);
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(batch, matrix, color);
     }
 }
 
+/**
+ * Marks the cached bounds of this subtree (and its ancestors) as dirty.
+ *
+ * Subclasses must call this method whenever the result of either
+ * {@link getDrawBounds()} or {@link getDrawCount()} changes.  Changes
+ * to the content size and transform are handled automatically.
+ */
+void Node::invalidateBounds() {
+    // A dirty node always has dirty ancestors, so we can stop early
+    Node* node = this;
+    while (node != nullptr && !node->_boundsDirty) {
+        node->_boundsDirty = true;
+        node->_cacheDirty  = true;
+        node = node->_parent;
+    }
+}
+
+/**
+ * Recomputes the cached subtree bounds and counts if they are dirty.
+ *
+ * The subtree bounds are stored in node space, so moving a node only
+ * dirties its ancestors, and never its descendants.
+ */
+void Node::updateBounds() {
+    if (!_boundsDirty) {
+        return;
+    }
+    _subtreeBounds = getDrawBounds();
+    _subtreeEmpty  = _subtreeBounds.size.width <= 0 && _subtreeBounds.size.height <= 0;
+    _subtreeNodes  = 1;
+    _subtreeVerts  = getDrawCount();
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        Node* child = it->get();
+        child->updateBounds();
+        _subtreeNodes += child->_subtreeNodes;
+        _subtreeVerts += child->_subtreeVerts;
+        if (!child->_subtreeEmpty) {
+            Rect bounds = child->_combined.transform(child->_subtreeBounds);
+            if (_subtreeEmpty) {
+                _subtreeBounds = bounds;
+                _subtreeEmpty  = false;
+            } else {
+                _subtreeBounds.merge(bounds);
+            }
+        }
+    }
+    _boundsDirty = false;
+}
+
+/**
+ * Draws the visible parts of this subtree with the given SpriteBatch.
+ *
+ * This is the culling version of render, used by {@link Scene}.  Any
+ * subtree whose bounds do not intersect the view is skipped, as is any
+ * node whose absolute tint is fully transparent.  The nodes and vertices
+ * drawn and skipped are added to the given statistics.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ * @param view      The visible region in world coordinates.
+ * @param stats     The render statistics to update.
+ */
+void Node::renderVisible(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform,
+                         Color4 tint, const Rect& view, RenderStats& stats) {
+    if (!_isVisible) { return; }
+    
+    if (batch->isDeferred() && (_cacheEnabled || !isConcurrent())) {
+        // Draw this subtree on the thread that replays the batch
+        Node* node = this;
+        RenderStats* counts = &stats;
+        batch->defer([=](const std::shared_ptr<SpriteBatch>& target) {
+            node->renderVisible(target, transform, tint, view, *counts);
+        });
+        return;
+    }
+    
+    updateBounds();
+    Mat4 matrix;
+    Mat4::multiply(_combined,transform,&matrix);
+    if (_subtreeEmpty || !matrix.transform(_subtreeBounds).doesIntersect(view)) {
+        cullSubtree(stats);
+        return;
+    }
+    
+    Color4 color = _tintColor;
+    if (_hasParentColor) {
+        color *= tint;
+    }
+    
+    if (color.a == 0) {
+        // Only children with their own color can still be seen
+        stats.nodesCulled++;
+        stats.vertsCulled += getDrawCount();
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            if ((*it)->_hasParentColor) {
+                if ((*it)->_isVisible) {
+                    (*it)->cullSubtree(stats);
+                }
+            } else {
+                (*it)->renderVisible(batch, matrix, color, view, stats);
+            }
+        }
+        return;
+    }
+    
+    if (_cacheEnabled) {
+        renderCached(batch, matrix, color);
+        stats.nodesDrawn++;
+        stats.vertsDrawn += 6;
+        return;
+    }
+    
+    draw(batch,matrix,color);
+    stats.nodesDrawn++;
+    stats.vertsDrawn += getDrawCount();
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->renderVisible(batch, matrix, color, view, stats);
+    }
+}
+
+/**
+ * Adds this subtree to the culled statistics.
+ *
+ * @param stats     The render statistics to update.
+ */
+void Node::cullSubtree(RenderStats& stats) {
+    updateBounds();
+    stats.nodesCulled += _subtreeNodes;
+    stats.vertsCulled += _subtreeVerts;
+}
+
+/**
+ * Draws this subtree from its render cache, redrawing the cache if needed.
+ *
+ * The matrix and color are the combined ones for this node, as passed to
+ * {@link draw}.  The cache is redrawn if it is out of date, or if the
+ * subtree now covers a different number of pixels on screen.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param matrix    The transform of this node.
+ * @param color     The tint of this node.
+ */
+void Node::renderCached(const std::shared_ptr<SpriteBatch>& batch, const Mat4& matrix, Color4 color) {
+    updateBounds();
+    if (_subtreeEmpty) {
+        return;
+    }
+    
+    // Measure the subtree on screen (this ignores translation)
+    Mat4 screen;
+    Mat4::multiply(matrix, batch->getPerspective(), &screen);
+    GLint viewport[4];
+    GLState::getViewport(viewport);
+    float sx = sqrtf(screen.m[0]*screen.m[0]+screen.m[1]*screen.m[1])*viewport[2]/2.0f;
+    float sy = sqrtf(screen.m[4]*screen.m[4]+screen.m[5]*screen.m[5])*viewport[3]/2.0f;
+    int width  = std::min((int)ceilf(_subtreeBounds.size.width*sx),  NODE_CACHE_LIMIT);
+    int height = std::min((int)ceilf(_subtreeBounds.size.height*sy), NODE_CACHE_LIMIT);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    
+    if (_cache == nullptr || _cacheDirty || _cacheBounds != _subtreeBounds ||
+        _cacheWidth != width || _cacheHeight != height) {
+        if (_cache == nullptr || _cache->getWidth() != nextPOT(width) ||
+            _cache->getHeight() != nextPOT(height)) {
+            _cache = RenderTarget::alloc(nextPOT(width), nextPOT(height));
+            if (_cache == nullptr) {
+                // Fall back to drawing the subtree directly
+                draw(batch,matrix,color);
+                for(auto it = _children.begin(); it != _children.end(); ++it) {
+                    (*it)->render(batch, matrix, color);
+                }
+                return;
+            }
+        }
+        _cacheBounds = _subtreeBounds;
+        _cacheWidth  = width;
+        _cacheHeight = height;
+        
+        // The subtree fills the lower left of the target, one texel per pixel
+        float right = _cacheBounds.origin.x+_cacheBounds.size.width*_cache->getWidth()/width;
+        float top   = _cacheBounds.origin.y+_cacheBounds.size.height*_cache->getHeight()/height;
+        Mat4 ortho;
+        Mat4::createOrthographicOffCenter(_cacheBounds.origin.x, right,
+                                          _cacheBounds.origin.y, top, -1, 1, &ortho);
+        
+        std::shared_ptr<RenderTarget> previous = batch->getTarget();
+        Mat4 perspective = batch->getPerspective();
+        batch->setTarget(_cache);
+        _cache->clear();
+        batch->setPerspective(ortho);
+        draw(batch,Mat4::IDENTITY,Color4::WHITE);
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, Mat4::IDENTITY, Color4::WHITE);
+        }
+        batch->setTarget(previous);
+        batch->setPerspective(perspective);
+        _cacheDirty = false;
+    }
+    
+    // The target holds premultiplied alpha
+    GLenum srcFactor = batch->getSourceBlendFactor();
+    GLenum dstFactor = batch->getDestinationBlendFactor();
+    color.premultiply();
+    batch->setTexture(_cache->getTexture());
+    batch->setColor(color);
+    batch->setBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    batch->fillQuad(_cacheBounds, Vec2::ZERO,
+                    Vec2((float)width/_cache->getWidth(), (float)height/_cache->getHeight()),
+                    matrix);
+    batch->setBlendFunc(srcFactor, dstFactor);
+}
+
 /**
  * Returns the absolute color tinting this node.
  *
@@ -782,3 +1101,45 @@ Color4 Node::getAbsoluteColor() {
     return result;
 }
 
+#pragma mark -
+#pragma mark Render Cache
+/**
+ * Sets whether this subtree is drawn from a render cache.
+ *
+ * A cached subtree is drawn once into an offscreen {@link RenderTarget},
+ * and then drawn as a single textured quad until the cache is invalidated.
+ * This is useful for a complex subtree that rarely changes, but which may
+ * move around the screen.  Moving, scaling or tinting this node does not
+ * invalidate the cache, but changes to the subtree (adding or removing
+ * children, or changing their transform, color or visibility) do.  Any
+ * other change to a descendant must be followed by a call to
+ * {@link invalidateCache()}.
+ *
+ * The cache is sized to the subtree on screen, so it is rebuilt if the
+ * subtree is scaled.  It is tinted as a whole, so every descendant is
+ * drawn as if it inherited the color of this node.
+ *
+ * Disabling the cache releases the render target.
+ *
+ * @param value Whether this subtree is drawn from a render cache
+ */
+void Node::setCached(bool value) {
+    _cacheEnabled = value;
+    _cacheDirty = true;
+    if (!value) {
+        _cache = nullptr;
+    }
+}
+
+/**
+ * Marks the render cache of this node and its ancestors as out of date.
+ *
+ * Every cached node on the path to the root is redrawn the next time it
+ * is rendered.  Call this method on a descendant of a cached node after
+ * any change that the cache cannot detect, such as a new texture.
+ */
+void Node::invalidateCache() {
+    for(Node* node = this; node != nullptr; node = node->_parent) {
+        node->_cacheDirty = true;
+    }
+}
@@ -0,0 +1,249 @@
+//
+//  CUNodeArena.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a pooled allocator for scene graph nodes.  Building a
+//  level allocates hundreds of small nodes at once, and releases them all at
+//  once when the level is torn down.  An arena carves those nodes out of a
+//  few large chunks, and recycles freed blocks through size-class free lists,
+//  so that this churn never reaches the general purpose heap.
+//
+//  Nodes are still managed by shared pointers.  The arena is attached to the
+//  control block of every node it allocates (via std::allocate_shared), so
+//  the reference count lives in the same block as the node, and the arena
+//  lives as long as any node allocated from it.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/2d/CUNodeArena.h>
+#include <cugl/util/CUDebug.h>
+#include <cstring>
+
+using namespace cugl;
+
+/** The current arena of each thread */
+static thread_local std::shared_ptr<NodeArena> _current;
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized arena.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+NodeArena::NodeArena() :
+_chunksize(0),
+_cursor(nullptr),
+_limit(nullptr),
+_count(0),
+_inuse(0),
+_total(0) {
+    std::memset(_free, 0, sizeof(_free));
+}
+
+/**
+ * Releases all of the chunks of this arena.
+ *
+ * This method should not be called while there are still live blocks
+ * in the arena.  That never happens for an arena referenced by a node
+ * allocator, as the allocator keeps the arena alive.
+ */
+void NodeArena::dispose() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    CUAssertLog(_count == 0, "Disposing an arena with %zu live blocks", _count);
+    for(auto it = _chunks.begin(); it != _chunks.end(); ++it) {
+        ::operator delete(*it);
+    }
+    _chunks.clear();
+    std::memset(_free, 0, sizeof(_free));
+    _cursor = nullptr;
+    _limit  = nullptr;
+    _chunksize = 0;
+    _count = 0;
+    _inuse = 0;
+    _total = 0;
+}
+
+/**
+ * Initializes an arena with the given chunk size.
+ *
+ * No memory is reserved until the first allocation.  The chunk size
+ * must be at least NODE_ARENA_LIMIT bytes.
+ *
+ * @param chunksize The size of each chunk in bytes
+ *
+ * @return true if initialization was successful.
+ */
+bool NodeArena::init(size_t chunksize) {
+    CUAssertLog(_chunksize == 0, "Arena is already initialized");
+    CUAssertLog(chunksize >= NODE_ARENA_LIMIT, "Chunk size %zu is too small", chunksize);
+    _chunksize = chunksize;
+    return true;
+}
+
+#pragma mark -
+#pragma mark Allocation
+/**
+ * Returns a block of at least the given size.
+ *
+ * The block is aligned to NODE_ARENA_QUANTUM bytes.
+ *
+ * @param size  The requested size in bytes
+ *
+ * @return a block of at least the given size.
+ */
+void* NodeArena::allocate(size_t size) {
+    if (size == 0 || size > NODE_ARENA_LIMIT) {
+        return ::operator new(size);
+    }
+    size_t slot  = (size-1)/NODE_ARENA_QUANTUM;
+    size_t bytes = (slot+1)*NODE_ARENA_QUANTUM;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    void* result = nullptr;
+    if (_free[slot] != nullptr) {
+        result = _free[slot];
+        _free[slot] = _free[slot]->next;
+    } else {
+        if (_cursor+bytes > _limit) {
+            // The tail of the old chunk is abandoned (at most NODE_ARENA_LIMIT bytes)
+            Uint8* chunk = static_cast<Uint8*>(::operator new(_chunksize));
+            _chunks.push_back(chunk);
+            _cursor = chunk;
+            _limit  = chunk+_chunksize;
+        }
+        result = _cursor;
+        _cursor += bytes;
+    }
+    _count++;
+    _total++;
+    _inuse += bytes;
+    return result;
+}
+
+/**
+ * Returns a block to this arena.
+ *
+ * The size must be the same as the one used to allocate the block.
+ *
+ * @param ptr   The block to release
+ * @param size  The size of the block in bytes
+ */
+void NodeArena::deallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    } else if (size == 0 || size > NODE_ARENA_LIMIT) {
+        ::operator delete(ptr);
+        return;
+    }
+    size_t slot = (size-1)/NODE_ARENA_QUANTUM;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Block* block = static_cast<Block*>(ptr);
+    block->next = _free[slot];
+    _free[slot] = block;
+    _count--;
+    _inuse -= (slot+1)*NODE_ARENA_QUANTUM;
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Returns the number of blocks currently allocated from this arena.
+ *
+ * @return the number of blocks currently allocated from this arena.
+ */
+size_t NodeArena::getCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count;
+}
+
+/**
+ * Returns the number of bytes currently allocated from this arena.
+ *
+ * This includes the rounding to the size classes.
+ *
+ * @return the number of bytes currently allocated from this arena.
+ */
+size_t NodeArena::getUsage() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _inuse;
+}
+
+/**
+ * Returns the number of bytes reserved by this arena.
+ *
+ * @return the number of bytes reserved by this arena.
+ */
+size_t NodeArena::getCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _chunks.size()*_chunksize;
+}
+
+/**
+ * Returns the total number of allocations made by this arena.
+ *
+ * @return the total number of allocations made by this arena.
+ */
+size_t NodeArena::getTotal() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _total;
+}
+
+#pragma mark -
+#pragma mark Scopes
+/**
+ * Creates a scope making the given arena current.
+ *
+ * @param arena The arena to make current
+ */
+NodeArena::Scope::Scope(const std::shared_ptr<NodeArena>& arena) {
+    _previous = _current;
+    _current = arena;
+}
+
+/**
+ * Deletes this scope, restoring the previous arena.
+ */
+NodeArena::Scope::~Scope() {
+    _current = _previous;
+}
+
+/**
+ * Returns the current arena for the calling thread (or nullptr if none).
+ *
+ * @return the current arena for the calling thread (or nullptr if none).
+ */
+const std::shared_ptr<NodeArena>& NodeArena::getCurrent() {
+    return _current;
+}
@@ -43,6 +43,7 @@
 //  Version: 6/27/16
 #include <cugl/2d/CUPathNode.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/math/polygon/CUShapeCache.h>
 
 using namespace cugl;
 
@@ -73,8 +74,8 @@ _endcap(PathCap::NONE) {
  * The polygon will be extruded using the given sequence of vertices.
  * First it will traverse the vertices using either a closed or open
  * traveral.  Then it will extrude that polygon with the given joint
- * and cap. PathNode objects share a single extruder, so this initializer
- * is not thread safe.
+ * and cap. PathNode objects share extrusions through ShapeCache, so this initializer
+ * is thread safe.
  *
  * @param vertices  The vertices to texture (expressed in image space)
  * @param stroke    The stroke width of the extruded path.
@@ -103,8 +104,8 @@ bool PathNode::initWithVertices(const std::vector<Vec2>& vertices, float stroke,
  * The polygon will be extruded using the given polygon, assuming that it
  * is a (connected) path. It will extrude that polygon with the given joint
  * and cap.  It will assume the polygon is closed if the number of indices
- * is twice the number of vertices. PathNode objects share a single extruder,
- * so this initializer is not thread safe.
+ * is twice the number of vertices. PathNode objects share extrusions through ShapeCache,
+ * so this initializer is thread safe.
  *
  * @param poly      The polygon to texture (expressed in image space)
  * @param stroke    The stroke width of the extruded path.
@@ -128,14 +129,14 @@ bool PathNode::initWithPoly(const Poly2& poly, float stroke, PathJoint joint, Pa
  */
 void PathNode::updateExtrusion() {
     if (_stroke > 0) {
-        _extruder.set(_polygon.getVertices(),_closed);
-        _extruder.calculate(_stroke,_joint,_endcap);
-        _extruder.getPolygon(&_extrusion);
+        _extrusion.set(*ShapeCache::getExtrusion(_polygon.getVertices(),_closed,
+                                                 _stroke,_joint,_endcap));
         _extrbounds = _extrusion.getBounds();
         _extrbounds.origin -= _polygon.getBounds().origin;
     } else {
         _extrbounds.set(Vec2::ZERO,getContentSize());
     }
+    invalidateBounds();
 }
 
 
@@ -175,9 +176,8 @@ void PathNode::setClosed(bool closed) {
         clearRenderData();
         _extrusion.clear();
         
-        _outliner.set(_polygon.getVertices());
-        _outliner.calculate(_closed ? PathTraversal::CLOSED : PathTraversal::OPEN);
-        _outliner.getPath(_polygon.getIndices());
+        PathTraversal traversal = (_closed ? PathTraversal::CLOSED : PathTraversal::OPEN);
+        _polygon.set(*ShapeCache::getPath(_polygon.getVertices(), traversal));
         
         updateExtrusion();
     }
@@ -230,15 +230,13 @@ void PathNode::setCap(PathCap cap) {
  * The polygon will be extruded using the given sequence of vertices.
  * First it will traverse the vertices using the current traversal. Then
  * it will extrude that polygon with the current joint and cap. PathNode
- * objects share a single extruder, so this method is not thread safe.
+ * objects share extrusions through ShapeCache, so this method is thread safe.
  *
  * @param vertices  The vertices to texture
  */
 void PathNode::setPolygon(const std::vector<Vec2>& vertices) {
-    _polygon.set(vertices);
-    _outliner.set(_polygon.getVertices());
-    _outliner.calculate(_closed ? PathTraversal::CLOSED : PathTraversal::OPEN);
-    _outliner.getPath(_polygon.getIndices());
+    PathTraversal traversal = (_closed ? PathTraversal::CLOSED : PathTraversal::OPEN);
+    _polygon.set(*ShapeCache::getPath(vertices, traversal));
     setPolygon(_polygon);
 }
 
@@ -247,8 +245,8 @@ void PathNode::setPolygon(const std::vector<Vec2>& vertices) {
  *
  * This method will extrude that polygon with the current joint and cap.
  * The polygon is assumed to be closed if the number of indices is twice
- * the number of vertices. PathNode objects share a single extruder, so
- * this method is not thread safe.
+ * the number of vertices. PathNode objects share extrusions through ShapeCache, so
+ * this method is thread safe.
  *
  * @param poly  The polygon to texture
  */
@@ -263,8 +261,8 @@ void PathNode::setPolygon(const Poly2& poly) {
  *
  * The rectangle will be converted into a Poly2, using the standard outline.
  * This is the same as passing Poly2(rect,false). It will then be extruded
- * with the current joint and cap. PathNode objects share a single extruder,
- * so this method is not thread safe.
+ * with the current joint and cap. PathNode objects share extrusions through ShapeCache,
+ * so this method is thread safe.
  *
  * @param rect  The rectangle to texture
  */
@@ -352,8 +350,3 @@ void PathNode::generateRenderData() {
     _rendered = true;
 }
 
-/** An extruder for those incomplete polygons */
-PathExtruder PathNode::_extruder;
-/** An outliner for those incomplete polygons */
-PathOutliner PathNode::_outliner;
-
@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <cugl/2d/CUPolygonNode.h>
+#include <cugl/math/polygon/CUShapeCache.h>
 
 using namespace cugl;
 
@@ -48,20 +49,16 @@ using namespace cugl;
 /**
  * Sets the texture polgon to the vertices expressed in image space.
  *
- * The polygon will be triangulated using the rules of SimpleTriangulator.
- * All PolygonNode objects share a single triangulator, so this method is
- * not thread safe.
+ * The polygon will be triangulated using the rules of ComplexTriangulator.
+ * All PolygonNode objects share triangulations through ShapeCache, so this method is
+ * thread safe.
  *
  * @param   vertices The vertices to texture
  * @param   offset   The offset in vertices
  * @param   size     The number of elements in vertices
  */
 void PolygonNode::setPolygon(const std::vector<Vec2>& vertices) {
-    _polygon.set(vertices);
-    _polygon.getIndices().clear();
-    _triangulator.set(vertices);
-    _triangulator.calculate();
-    _triangulator.getTriangulation(_polygon.getIndices());
+    _polygon.set(*ShapeCache::getSolid(vertices));
     TexturedNode::setPolygon(_polygon);
 }
 
@@ -116,6 +113,9 @@ void PolygonNode::setPolygon(const Rect& rect) {
  * correct.  In addition, this method does not need to check for visibility,
  * as it is guaranteed to only be called when the node is visible.
  *
+ * If the polygon is a rectangle, it is drawn with {@link SpriteBatch#fillQuad},
+ * which sends it to the GPU as a single instanced quad.
+ *
  * @param batch     The SpriteBatch to draw with.
  * @param matrix    The global transformation matrix.
  * @param tint      The tint to blend with the Node color.
@@ -129,11 +129,16 @@ void PolygonNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
     batch->setTexture(_texture);
     batch->setBlendEquation(_blendEquation);
     batch->setBlendFunc(_srcFactor, _dstFactor);
-    batch->fill(_vertices.data(),(unsigned int)_vertices.size(),0,
-                _polygon.getIndices().data(),(unsigned int)_polygon.getIndices().size(),0,
-                transform);
+    if (_quad) {
+        const Vertex2& bottom = _vertices[_quadCorners[0]];
+        const Vertex2& top = _vertices[_quadCorners[1]];
+        Rect rect(bottom.position.x, bottom.position.y,
+                  top.position.x-bottom.position.x, top.position.y-bottom.position.y);
+        batch->fillQuad(rect, bottom.texcoord, top.texcoord, transform);
+    } else {
+        batch->fill(_vertices.data(),(unsigned int)_vertices.size(),0,
+                    _polygon.getIndices().data(),(unsigned int)_polygon.getIndices().size(),0,
+                    transform);
+    }
 }
 
-/** A triangulator for those incomplete polygons */
-SimpleTriangulator PolygonNode::_triangulator;
-
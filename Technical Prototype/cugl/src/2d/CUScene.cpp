@@ -41,8 +41,15 @@
 
 #include <cugl/2d/CUScene.h>
 #include <cugl/util/CUStrings.h>
+#include <cugl/util/CUThreadPool.h>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/** The number of render jobs to plan for each render thread */
+#define JOBS_PER_THREAD 4
 
 using namespace cugl;
 
@@ -62,7 +69,13 @@ _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
 _zDirty(false),
-_zSort(false) {}
+_zSort(false),
+_culling(true),
+_nodesDrawn(0),
+_nodesCulled(0),
+_vertsDrawn(0),
+_vertsCulled(0),
+_threads(1) {}
 
 /**
  * Disposes all of the resources used by this scene.
@@ -73,10 +86,16 @@ _zSort(false) {}
 void Scene::dispose() {
     removeAllChildren();
     _camera = nullptr;
+    _arena = nullptr;
     _name = "";
     _color = Color4::WHITE;
     _zDirty = false;
     _zSort = false;
+    _culling = true;
+    _threads = 1;
+    _pool = nullptr;
+    _jobs.clear();
+    _recorders.clear();
 }
 
 /**
@@ -96,7 +115,8 @@ void Scene::dispose() {
  */
 bool Scene::init(float x, float y, float width, float height) {
     _camera = OrthographicCamera::allocOffset(x, y, width, height);
-    return _camera != nullptr;
+    _arena  = NodeArena::alloc();
+    return _camera != nullptr && _arena != nullptr;
 }
 
 
@@ -411,6 +431,11 @@ void Scene::sortZOrder() {
  * That means that parents are always draw before (and behind children). The
  * children of each sub tree are ordered by z-value (or by the order added).
  *
+ * If culling is enabled, any subtree that lies outside of the camera
+ * viewport is skipped, as is any node whose absolute tint is fully
+ * transparent.  The subtree bounds are cached, and only recomputed
+ * for the parts of the scene graph that have changed.
+ *
  * @param batch     The SpriteBatch to draw with.
  */
 void Scene::render(const std::shared_ptr<SpriteBatch>& batch) {
@@ -420,11 +445,239 @@ void Scene::render(const std::shared_ptr<SpriteBatch>& batch) {
     
     batch->begin(_camera->getCombined());
     
-    for(auto it = _children.begin(); it != _children.end(); ++it) {
-        (*it)->render(batch, Mat4::IDENTITY, _color);
+    Node::RenderStats stats;
+    Rect view;
+    if (_culling) {
+        // The clip space square, pulled back into world coordinates
+        view = _camera->getInverseProjectView().transform(Rect(-1,-1,2,2));
+    }
+    if (_pool != nullptr) {
+        renderParallel(batch, view, stats);
+    } else if (_culling) {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->renderVisible(batch, Mat4::IDENTITY, _color, view, stats);
+        }
+    } else {
+        for(auto it = _children.begin(); it != _children.end(); ++it) {
+            (*it)->render(batch, Mat4::IDENTITY, _color);
+        }
     }
+    _nodesDrawn  = stats.nodesDrawn;
+    _nodesCulled = stats.nodesCulled;
+    _vertsDrawn  = stats.vertsDrawn;
+    _vertsCulled = stats.vertsCulled;
 
     batch->end();
     batch->setBlendFunc(_srcFactor, _dstFactor);
     batch->setBlendEquation(_blendEquation);
 }
+
+/**
+ * Sets the number of threads used to draw this scene.
+ *
+ * If this value is 1 (the default), the scene graph is drawn serially.
+ * Otherwise, the scene graph is split into subtrees that are drawn in
+ * parallel on this many threads, including the thread calling
+ * {@link render}. The extra threads belong to this scene.
+ *
+ * Each subtree is drawn into its own deferred {@link SpriteBatch}.
+ * These batches are then replayed into the render batch in scene graph
+ * order, so the result is exactly the same as a serial render. Nodes
+ * that are not {@link Node#isConcurrent()}, and nodes with a render
+ * cache, are drawn on the calling thread during the replay.
+ *
+ * While a parallel render is in progress, draw() methods must not
+ * modify the scene graph.
+ *
+ * @param threads   The number of threads used to draw this scene.
+ */
+void Scene::setRenderThreads(int threads) {
+    CUAssertLog(threads > 0, "The number of threads must be positive");
+    if (_threads == threads) {
+        return;
+    }
+    _threads = threads;
+    _pool = threads > 1 ? ThreadPool::alloc(threads-1) : nullptr;
+    if (_pool == nullptr) {
+        _jobs.clear();
+        _recorders.clear();
+    }
+}
+
+#pragma mark -
+#pragma mark Parallel Rendering
+/**
+ * Splits the scene graph into render jobs for the render threads.
+ *
+ * The largest subtrees are split into their root node and their children
+ * until there are enough jobs to keep every thread busy. When culling,
+ * the subtrees that cannot be seen are skipped here, and added to the
+ * given statistics.
+ *
+ * @param view      The visible region in world coordinates.
+ * @param stats     The render statistics to update.
+ */
+void Scene::planRender(const Rect& view, Node::RenderStats& stats) {
+    _jobs.clear();
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        RenderJob job;
+        job.node = it->get();
+        job.transform = Mat4::IDENTITY;
+        job.tint = _color;
+        job.subtree = true;
+        _jobs.push_back(job);
+    }
+
+    size_t target = (size_t)_threads*JOBS_PER_THREAD;
+    std::vector<RenderJob> split;
+    while (_jobs.size() < target) {
+        // Find the largest subtree that can be split
+        size_t best = _jobs.size();
+        unsigned int most = 1;
+        for(size_t ii = 0; ii < _jobs.size(); ii++) {
+            Node* node = _jobs[ii].node;
+            node->updateBounds();
+            if (_jobs[ii].subtree && node->_isVisible && !node->_children.empty() &&
+                !node->_cacheEnabled && node->isConcurrent() && node->_subtreeNodes > most) {
+                best = ii;
+                most = node->_subtreeNodes;
+            }
+        }
+        if (best == _jobs.size()) {
+            break;
+        }
+
+        // Same as Node::renderVisible, but collecting the children as jobs
+        RenderJob job = _jobs[best];
+        Node* node = job.node;
+        Mat4 matrix;
+        Mat4::multiply(node->_combined,job.transform,&matrix);
+        Color4 color = node->_tintColor;
+        if (node->_hasParentColor) {
+            color *= job.tint;
+        }
+
+        split.clear();
+        bool culled = false;
+        if (_culling) {
+            if (node->_subtreeEmpty || !matrix.transform(node->_subtreeBounds).doesIntersect(view)) {
+                node->cullSubtree(stats);
+                culled = true;
+            } else if (color.a == 0) {
+                stats.nodesCulled++;
+                stats.vertsCulled += node->getDrawCount();
+                culled = true;
+                for(auto it = node->_children.begin(); it != node->_children.end(); ++it) {
+                    if (!(*it)->_hasParentColor) {
+                        split.push_back(job);
+                        split.back().node = it->get();
+                        split.back().transform = matrix;
+                        split.back().tint = color;
+                    } else if ((*it)->_isVisible) {
+                        (*it)->cullSubtree(stats);
+                    }
+                }
+            }
+        }
+        if (!culled) {
+            split.push_back(job);
+            split.back().transform = matrix;
+            split.back().tint = color;
+            split.back().subtree = false;
+            for(auto it = node->_children.begin(); it != node->_children.end(); ++it) {
+                split.push_back(job);
+                split.back().node = it->get();
+                split.back().transform = matrix;
+                split.back().tint = color;
+            }
+        }
+        _jobs.erase(_jobs.begin()+best);
+        _jobs.insert(_jobs.begin()+best, split.begin(), split.end());
+    }
+}
+
+/**
+ * Draws the given render job into its deferred batch.
+ *
+ * This method is safe to call on any render thread.
+ *
+ * @param index     The render job index.
+ * @param view      The visible region in world coordinates.
+ */
+void Scene::recordJob(size_t index, const Rect& view) {
+    RenderJob& job = _jobs[index];
+    const std::shared_ptr<SpriteBatch>& recorder = _recorders[index];
+    recorder->begin();
+    if (!job.subtree) {
+        job.node->draw(recorder, job.transform, job.tint);
+        if (_culling) {
+            job.stats.nodesDrawn++;
+            job.stats.vertsDrawn += job.node->getDrawCount();
+        }
+    } else if (_culling) {
+        job.node->renderVisible(recorder, job.transform, job.tint, view, job.stats);
+    } else {
+        job.node->render(recorder, job.transform, job.tint);
+    }
+    recorder->end();
+}
+
+/**
+ * Draws the scene graph in parallel with the given SpriteBatch.
+ *
+ * The batch must be actively drawing.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param view      The visible region in world coordinates.
+ * @param stats     The render statistics to update.
+ */
+void Scene::renderParallel(const std::shared_ptr<SpriteBatch>& batch, const Rect& view,
+                           Node::RenderStats& stats) {
+    planRender(view, stats);
+    size_t count = _jobs.size();
+    if (_recorders.size() < count) {
+        _recorders.resize(count);
+    }
+    for(size_t ii = 0; ii < count; ii++) {
+        if (_recorders[ii] == nullptr || _recorders[ii]->getCapacity() != batch->getCapacity()) {
+            _recorders[ii] = SpriteBatch::allocDeferred(batch->getCapacity());
+        }
+        // Quads must be recorded the same way the batch would draw them
+        _recorders[ii]->setInstancing(batch->isInstancing());
+    }
+
+    // Every thread claims the next job until there are none left
+    std::atomic<size_t> next(0);
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = _threads-1;
+    auto work = [&](void) {
+        size_t index;
+        while ((index = next.fetch_add(1)) < count) {
+            recordJob(index, view);
+        }
+    };
+    for(int ii = 1; ii < _threads; ii++) {
+        _pool->addTask([&](void) {
+            work();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        });
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return running == 0; });
+    }
+
+    // Replay in scene graph order; deferred nodes update their stats here
+    for(size_t ii = 0; ii < count; ii++) {
+        _recorders[ii]->replay(batch);
+        stats.nodesDrawn  += _jobs[ii].stats.nodesDrawn;
+        stats.nodesCulled += _jobs[ii].stats.nodesCulled;
+        stats.vertsDrawn  += _jobs[ii].stats.vertsDrawn;
+        stats.vertsCulled += _jobs[ii].stats.vertsCulled;
+    }
+}
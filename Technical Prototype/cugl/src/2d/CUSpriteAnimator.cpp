@@ -0,0 +1,259 @@
+//
+//  CUSpriteAnimator.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a component that plays animation clips on animation
+//  nodes.  Every node that is playing a clip has a track in the animator, and
+//  a single call to update advances all of the tracks at once.  Changing the
+//  frame of a node only swaps the texture rectangle that it draws, so the
+//  cost of animation is a few arithmetic operations per sprite.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+#include <cugl/2d/CUSpriteAnimator.h>
+#include <cugl/2d/CUAnimationNode.h>
+#include <cugl/util/CUTimestamp.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized animator.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+SpriteAnimator::SpriteAnimator() :
+_updateTime(0),
+_changes(0),
+_initialized(false) {
+}
+
+/**
+ * Releases all tracks of this animator.
+ *
+ * A disposed animator can be safely reinitialized.
+ */
+void SpriteAnimator::dispose() {
+    _tracks.clear();
+    _index.clear();
+    _updateTime = 0;
+    _changes = 0;
+    _initialized = false;
+}
+
+/**
+ * Initializes an animator with no tracks.
+ *
+ * @param capacity  The expected number of animated nodes
+ *
+ * @return true if initialization was successful.
+ */
+bool SpriteAnimator::init(size_t capacity) {
+    if (_initialized) {
+        CUAssertLog(false, "SpriteAnimator is already initialized");
+        return false;
+    }
+    _tracks.reserve(capacity);
+    _index.reserve(capacity);
+    _initialized = true;
+    return true;
+}
+
+#pragma mark -
+#pragma mark Playback
+/**
+ * Plays the given clip on the given node from its first frame.
+ *
+ * If the node is already playing a clip, that clip is replaced.  The
+ * first frame is shown immediately.
+ *
+ * @param node  The node to animate
+ * @param clip  The clip to play
+ * @param speed The playback speed (1 is normal speed)
+ */
+void SpriteAnimator::play(const std::shared_ptr<AnimationNode>& node,
+                          const std::shared_ptr<AnimationClip>& clip, float speed) {
+    CUAssertLog(node != nullptr && clip != nullptr, "Cannot play a null node or clip");
+    auto it = _index.find(node.get());
+    if (it == _index.end()) {
+        it = _index.emplace(node.get(), _tracks.size()).first;
+        _tracks.push_back(Track());
+        _tracks.back().node = node;
+    }
+    
+    Track& track = _tracks[it->second];
+    track.clip = clip;
+    track.frame = 0;
+    track.elapsed = 0;
+    track.speed = speed;
+    track.step = 1;
+    track.done = false;
+    node->setFrameRect(clip->getFrame(0));
+}
+
+/**
+ * Stops the animation of the given node, removing its track.
+ *
+ * The node keeps its current frame.
+ *
+ * @param node  The node to stop
+ */
+void SpriteAnimator::stop(const std::shared_ptr<AnimationNode>& node) {
+    auto it = _index.find(node.get());
+    if (it == _index.end()) {
+        return;
+    }
+    
+    // Move the last track into the hole
+    size_t pos = it->second;
+    _index.erase(it);
+    if (pos+1 < _tracks.size()) {
+        _tracks[pos] = std::move(_tracks.back());
+        _index[_tracks[pos].node.get()] = pos;
+    }
+    _tracks.pop_back();
+}
+
+/**
+ * Removes every track from this animator.
+ */
+void SpriteAnimator::clear() {
+    _tracks.clear();
+    _index.clear();
+}
+
+/**
+ * Advances every track by the given amount of time.
+ *
+ * @param dt    The elapsed time in seconds
+ */
+void SpriteAnimator::update(float dt) {
+    Timestamp start;
+    _changes = 0;
+    for(auto it = _tracks.begin(); it != _tracks.end(); ++it) {
+        if (it->done) {
+            continue;
+        }
+        
+        bool changed = false;
+        const AnimationClip* clip = it->clip.get();
+        it->elapsed += dt*it->speed;
+        while (!it->done && it->elapsed >= clip->getDuration(it->frame)) {
+            it->elapsed -= clip->getDuration(it->frame);
+            changed = advance(*it) || changed;
+        }
+        if (changed) {
+            it->node->setFrameRect(clip->getFrame(it->frame));
+            _changes++;
+        }
+    }
+    Timestamp end;
+    _updateTime = end.ellapsedMicros(start);
+}
+
+/**
+ * Moves the track to the next frame of its clip.
+ *
+ * @param track The track to advance
+ *
+ * @return true if the frame changed.
+ */
+bool SpriteAnimator::advance(Track& track) {
+    unsigned int size = track.clip->getSize();
+    switch (track.clip->getMode()) {
+        case AnimationClip::Mode::ONCE:
+            if (track.frame+1 < size) {
+                track.frame++;
+                return true;
+            }
+            track.done = true;
+            track.elapsed = 0;
+            return false;
+        case AnimationClip::Mode::LOOP:
+            track.frame = (track.frame+1) % size;
+            return size > 1;
+        case AnimationClip::Mode::PINGPONG:
+            if (size == 1) {
+                return false;
+            }
+            if ((track.step > 0 && track.frame+1 == size) || (track.step < 0 && track.frame == 0)) {
+                track.step = -track.step;
+            }
+            track.frame += track.step;
+            return true;
+    }
+    return false;
+}
+
+#pragma mark -
+#pragma mark Track Queries
+/**
+ * Returns the clip played by the given node (nullptr if none).
+ *
+ * @param node  The animated node
+ *
+ * @return the clip played by the given node (nullptr if none).
+ */
+std::shared_ptr<AnimationClip> SpriteAnimator::getClip(const std::shared_ptr<AnimationNode>& node) const {
+    auto it = _index.find(node.get());
+    return (it == _index.end() ? nullptr : _tracks[it->second].clip);
+}
+
+/**
+ * Returns the current frame of the clip played by the given node.
+ *
+ * This is the index in the clip, not in the filmstrip.  It is -1 if the
+ * node has no track.
+ *
+ * @param node  The animated node
+ *
+ * @return the current frame of the clip played by the given node.
+ */
+int SpriteAnimator::getFrame(const std::shared_ptr<AnimationNode>& node) const {
+    auto it = _index.find(node.get());
+    return (it == _index.end() ? -1 : (int)_tracks[it->second].frame);
+}
+
+/**
+ * Returns true if the given node has finished a clip that plays ONCE.
+ *
+ * @param node  The animated node
+ *
+ * @return true if the given node has finished a clip that plays ONCE.
+ */
+bool SpriteAnimator::isComplete(const std::shared_ptr<AnimationNode>& node) const {
+    auto it = _index.find(node.get());
+    return (it != _index.end() && _tracks[it->second].done);
+}
@@ -58,8 +58,10 @@ _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
 _flipHorizontal(false),
 _flipVertical(false),
-_absolute(false) {
-    _name = "TexturedNode";
+_absolute(false),
+_rendered(false),
+_quad(false) {
+    setName("TexturedNode");
 }
 
 /**
@@ -268,6 +270,7 @@ void TexturedNode::setPolygon(const Poly2& poly) {
     }
     
     clearRenderData();
+    invalidateBounds();
     setContentSize(_polygon.getBounds().size);
 }
 
@@ -351,6 +354,42 @@ void TexturedNode::generateRenderData() {
         _vertices.push_back(temp);
     }
     
+    // Rectangles are drawn as quads.  The two triangles must leave out
+    // opposite corners, so that they meet along a diagonal.
+    _quad = false;
+    const std::vector<unsigned short>& indices = _polygon.getIndices();
+    if (_vertices.size() == 4 && indices.size() == 6) {
+        const Rect& bounds = _polygon.getBounds();
+        int corner[4];
+        int found = 0;
+        for(int ii = 0; ii < 4; ii++) {
+            const Vec2& point = _polygon.getVertices()[ii];
+            bool left  = point.x == bounds.getMinX();
+            bool right = point.x == bounds.getMaxX();
+            bool below = point.y == bounds.getMinY();
+            bool above = point.y == bounds.getMaxY();
+            corner[ii] = -1;
+            if ((left || right) && (below || above)) {
+                corner[ii] = (right ? 1 : 0) | (above ? 2 : 0);
+                found |= 1 << corner[ii];
+            }
+            if (corner[ii] == 0) { _quadCorners[0] = ii; }
+            if (corner[ii] == 3) { _quadCorners[1] = ii; }
+        }
+        if (found == 0xF) {
+            int omit[2];
+            for(int tt = 0; tt < 2; tt++) {
+                omit[tt] = 0xF;
+                for(int jj = 0; jj < 3; jj++) {
+                    omit[tt] &= ~(1 << corner[indices[3*tt+jj]]);
+                }
+            }
+            int both = omit[0] | omit[1];
+            _quad = (omit[0] & (omit[0]-1)) == 0 && (omit[1] & (omit[1]-1)) == 0 &&
+                    (both == 0x9 || both == 0x6);
+        }
+    }
+    
     _rendered = true;
 }
 
@@ -360,6 +399,7 @@ void TexturedNode::generateRenderData() {
 void TexturedNode::clearRenderData() {
     _vertices.clear();
     _rendered = false;
+    _quad = false;
     
 }
 
@@ -41,6 +41,7 @@
 //  Author: Walker White
 //  Version: 6/27/16
 #include <cugl/2d/CUWireNode.h>
+#include <cugl/math/polygon/CUShapeCache.h>
 
 using namespace cugl;
 
@@ -53,8 +54,8 @@ using namespace cugl;
  * color.
  *
  * The polygon will be outlined using the given traversal in PathOutliner.
- * WireNode objects share a single path outliner, so this initializer is
- * not thread safe.
+ * WireNode objects share outlines through ShapeCache, so this initializer is
+ * thread safe.
  *
  * @param vertices  The vertices to texture (expressed in image space)
  * @param traveral  The path traversal for index generation
@@ -62,12 +63,7 @@ using namespace cugl;
  * @return  true if the wireframe is initialized properly, false otherwise.
  */
 bool WireNode::initWithVertices(const std::vector<Vec2>& vertices, PathTraversal traversal) {
-    _polygon.set(vertices);
-    _polygon.getIndices().clear();
-    _outliner.set(vertices);
-    _outliner.calculate(traversal);
-    _outliner.getPath(_polygon.getIndices());
-
+    _polygon.set(*ShapeCache::getPath(vertices, traversal));
     bool result = init(_polygon);
     _traversal = traversal;
     return result;
@@ -113,7 +109,7 @@ bool WireNode::initWithEllipse(const Vec2& center, const Size& size, unsigned in
  *
  * If the traversal is different from the current known traversal, it will
  * recompute the traveral using the PathOutliner. All WireNode objects share
- * a single path outliner, so this method is not thread safe.
+ * outlines through ShapeCache, so this method is thread safe.
  *
  * @param traversal The new wireframe traversal
  */
@@ -121,10 +117,8 @@ void WireNode::setTraversal(PathTraversal traversal) {
     if (_traversal == traversal) {
         return;
     }
-    _polygon.getIndices().clear();
-    _outliner.set(_polygon.getVertices());
-    _outliner.calculate(traversal);
-    _outliner.getPath(_polygon.getIndices());
+    _polygon.set(*ShapeCache::getPath(_polygon.getVertices(), traversal));
+    _traversal = traversal;
     clearRenderData();
 }
 
@@ -134,18 +128,15 @@ void WireNode::setTraversal(PathTraversal traversal) {
  *
  * The polygon will be outlined using a CLOSED traversal in PathOutliner.
  * To create a different traversal, use the alternate setPolygon() method.
- * All WireNode objects share a single path outliner, so this method is not
+ * All WireNode objects share outlines through ShapeCache, so this method is
  * thread safe.
  *
  * @param vertices  The vertices to draw
  */
 void WireNode::setPolygon(const std::vector<Vec2>& vertices) {
-    _polygon.set(vertices);
-    _polygon.getIndices().clear();
-    _outliner.set(vertices);
-    _outliner.calculate(PathTraversal::CLOSED);
-    _outliner.getPath(_polygon.getIndices());
+    _polygon.set(*ShapeCache::getPath(vertices, PathTraversal::CLOSED));
     TexturedNode::setPolygon(_polygon);
+    _traversal = PathTraversal::CLOSED;
 
 }
 
@@ -153,17 +144,13 @@ void WireNode::setPolygon(const std::vector<Vec2>& vertices) {
  * Sets the wireframe polgon to the vertices expressed in texture space.
  *
  * The polygon will be outlined using the given traversal in PathOutliner.
- * All WireNode objects share a single path outliner, so this method is not
+ * All WireNode objects share outlines through ShapeCache, so this method is
  * thread safe.
  *
  * @param vertices  The vertices to draw
  */
 void WireNode::setPolygon(const std::vector<Vec2>& vertices, PathTraversal traversal) {
-    _polygon.set(vertices);
-    _polygon.getIndices().clear();
-    _outliner.set(vertices);
-    _outliner.calculate(traversal);
-    _outliner.getPath(_polygon.getIndices());
+    _polygon.set(*ShapeCache::getPath(vertices, traversal));
     TexturedNode::setPolygon(_polygon);
     _traversal = traversal;
 }
@@ -270,6 +257,3 @@ void WireNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& trans
 
 }
 
-/** An outliner for those incomplete polygons */
-PathOutliner WireNode::_outliner;
-
@@ -0,0 +1,396 @@
+//
+//  CUObstacleDebugDraw.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a debug renderer for an ObstacleWorld.  It implements
+//  the Box2D b2Draw interface, and streams the shapes, joints, bounding boxes
+//  and contacts of the world directly into a SpriteBatch.  All the filled
+//  shapes share one triangle pass and all the outlines share one line pass,
+//  so a typical world is drawn in two draw calls.  Unlike the wireframes of
+//  the individual obstacles, it does not add any nodes to the scene graph.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Collision/b2Collision.h>
+#include <cugl/2d/physics/CUObstacleDebugDraw.h>
+#include <cugl/renderer/CUSpriteBatch.h>
+#include <cugl/util/CUDebug.h>
+#include <cmath>
+
+using namespace cugl;
+
+/** The opacity of filled shapes, relative to their outline */
+#define DEBUG_FILL_ALPHA    0.5f
+
+/**
+ * Returns the CUGL color for a Box2D color.
+ *
+ * @param color The Box2D color
+ * @param alpha The opacity scale
+ *
+ * @return the CUGL color for a Box2D color.
+ */
+static Color4 convert_color(const b2Color& color, float alpha=1.0f) {
+    return Color4(Color4f(color.r,color.g,color.b,color.a*alpha));
+}
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized debug renderer.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+ObstacleDebugDraw::ObstacleDebugDraw() :
+_capacity(0),
+_batch(nullptr),
+_contactColor(Color4::YELLOW),
+_pointSize(DEBUG_POINT_SIZE),
+_axisLength(DEBUG_AXIS_LENGTH) {
+}
+
+/**
+ * Disposes all of the resources used by this debug renderer.
+ *
+ * A disposed renderer can be safely reinitialized.
+ */
+void ObstacleDebugDraw::dispose() {
+    _fillVerts.clear();
+    _fillIndx.clear();
+    _lineVerts.clear();
+    _lineIndx.clear();
+    _capacity = 0;
+    _batch = nullptr;
+}
+
+/**
+ * Initializes a debug renderer that draws the shapes of the world.
+ *
+ * The capacity is the number of vertices submitted to the sprite batch at
+ * a time.  It should not exceed the capacity of the sprite batch.
+ *
+ * @param capacity  The number of vertices in a single pass
+ *
+ * @return true if initialization was successful.
+ */
+bool ObstacleDebugDraw::init(unsigned int capacity) {
+    if (_capacity > 0) {
+        CUAssertLog(false, "Debug renderer is already initialized");
+        return false;
+    } else if (capacity < 3*DEBUG_CIRCLE_SEGMENTS) {
+        CUAssertLog(false, "Debug renderer capacity %d is too small", capacity);
+        return false;
+    }
+    _capacity = capacity;
+    _fillVerts.reserve(capacity);
+    _fillIndx.reserve(3*capacity);
+    _lineVerts.reserve(capacity);
+    _lineIndx.reserve(2*capacity);
+    SetFlags(SHAPES);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws the given world with the sprite batch.
+ *
+ * The sprite batch must be active (e.g. between calls to begin and end).
+ * The transform converts from physics coordinates to the coordinates of
+ * the sprite batch perspective.  The active texture of the batch is
+ * replaced by the blank texture.
+ *
+ * @param world     The Box2D world to draw
+ * @param batch     The sprite batch to draw with
+ * @param transform The transform from physics coordinates
+ */
+void ObstacleDebugDraw::draw(b2World* world, const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) {
+    _batch = batch.get();
+    _transform = transform;
+    _batch->setTexture(SpriteBatch::getBlankTexture());
+
+    // The world only holds on to the renderer while drawing
+    world->SetDebugDraw(this);
+    world->DrawDebugData();
+    world->SetDebugDraw(nullptr);
+    if (GetFlags() & CONTACTS) {
+        drawContacts(world);
+    }
+
+    // Outlines go on top of the fills
+    flushFills();
+    flushLines();
+    _batch = nullptr;
+}
+
+#pragma mark -
+#pragma mark Box2D Interface
+/**
+ * Draws a closed polygon provided in CCW order.
+ *
+ * @param vertices      The polygon vertices
+ * @param vertexCount   The number of vertices
+ * @param color         The outline color
+ */
+void ObstacleDebugDraw::DrawPolygon(const b2Vec2* vertices, int32 vertexCount, const b2Color& color) {
+    addOutline(vertices, vertexCount, convert_color(color));
+}
+
+/**
+ * Draws a solid closed polygon provided in CCW order.
+ *
+ * The polygon is filled with a translucent version of the color.
+ *
+ * @param vertices      The polygon vertices
+ * @param vertexCount   The number of vertices
+ * @param color         The outline color
+ */
+void ObstacleDebugDraw::DrawSolidPolygon(const b2Vec2* vertices, int32 vertexCount, const b2Color& color) {
+    addFill(vertices, vertexCount, convert_color(color,DEBUG_FILL_ALPHA));
+    addOutline(vertices, vertexCount, convert_color(color));
+}
+
+/**
+ * Draws a circle.
+ *
+ * @param center    The circle center
+ * @param radius    The circle radius
+ * @param color     The outline color
+ */
+void ObstacleDebugDraw::DrawCircle(const b2Vec2& center, float32 radius, const b2Color& color) {
+    b2Vec2 circle[DEBUG_CIRCLE_SEGMENTS];
+    makeCircle(center, radius, circle);
+    addOutline(circle, DEBUG_CIRCLE_SEGMENTS, convert_color(color));
+}
+
+/**
+ * Draws a solid circle.
+ *
+ * The circle is filled with a translucent version of the color, and the
+ * axis is drawn as a radius.
+ *
+ * @param center    The circle center
+ * @param radius    The circle radius
+ * @param axis      The circle orientation
+ * @param color     The outline color
+ */
+void ObstacleDebugDraw::DrawSolidCircle(const b2Vec2& center, float32 radius, const b2Vec2& axis, const b2Color& color) {
+    b2Vec2 circle[DEBUG_CIRCLE_SEGMENTS];
+    makeCircle(center, radius, circle);
+    addFill(circle, DEBUG_CIRCLE_SEGMENTS, convert_color(color,DEBUG_FILL_ALPHA));
+    addOutline(circle, DEBUG_CIRCLE_SEGMENTS, convert_color(color));
+    addSegment(center, center+radius*axis, convert_color(color));
+}
+
+/**
+ * Draws a line segment.
+ *
+ * @param p1        The start of the segment
+ * @param p2        The end of the segment
+ * @param color     The line color
+ */
+void ObstacleDebugDraw::DrawSegment(const b2Vec2& p1, const b2Vec2& p2, const b2Color& color) {
+    addSegment(p1, p2, convert_color(color));
+}
+
+/**
+ * Draws a transform as a pair of (red and green) axes.
+ *
+ * @param xf    The transform to draw
+ */
+void ObstacleDebugDraw::DrawTransform(const b2Transform& xf) {
+    addSegment(xf.p, xf.p+_axisLength*xf.q.GetXAxis(), Color4::RED);
+    addSegment(xf.p, xf.p+_axisLength*xf.q.GetYAxis(), Color4::GREEN);
+}
+
+/**
+ * Draws a point as a small filled square.
+ *
+ * Box2D measures the point size in pixels.  This renderer ignores it, and
+ * uses {@link getPointSize} instead.
+ *
+ * @param p         The point to draw
+ * @param size      The point size (ignored)
+ * @param color     The point color
+ */
+void ObstacleDebugDraw::DrawPoint(const b2Vec2& p, float32, const b2Color& color) {
+    float half = _pointSize/2.0f;
+    b2Vec2 square[4];
+    square[0].Set(p.x-half,p.y-half);
+    square[1].Set(p.x+half,p.y-half);
+    square[2].Set(p.x+half,p.y+half);
+    square[3].Set(p.x-half,p.y+half);
+    addFill(square, 4, convert_color(color));
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Appends a polygon outline to the line buffer.
+ *
+ * @param vertices  The polygon vertices
+ * @param count     The number of vertices
+ * @param color     The outline color
+ */
+void ObstacleDebugDraw::addOutline(const b2Vec2* vertices, int count, Color4 color) {
+    if (_lineVerts.size()+count > _capacity) {
+        flushLines();
+    }
+
+    unsigned short start = (unsigned short)_lineVerts.size();
+    Vertex2 temp;
+    temp.color = color;
+    for(int ii = 0; ii < count; ii++) {
+        temp.position.set(vertices[ii].x,vertices[ii].y);
+        _lineVerts.push_back(temp);
+        _lineIndx.push_back(start+ii);
+        _lineIndx.push_back(start+(ii+1)%count);
+    }
+}
+
+/**
+ * Appends a convex polygon to the fill buffer.
+ *
+ * @param vertices  The polygon vertices (in order)
+ * @param count     The number of vertices
+ * @param color     The fill color
+ */
+void ObstacleDebugDraw::addFill(const b2Vec2* vertices, int count, Color4 color) {
+    if (_fillVerts.size()+count > _capacity) {
+        flushFills();
+    }
+
+    // Box2D shapes are convex, so a fan is a valid triangulation
+    unsigned short start = (unsigned short)_fillVerts.size();
+    Vertex2 temp;
+    temp.color = color;
+    for(int ii = 0; ii < count; ii++) {
+        temp.position.set(vertices[ii].x,vertices[ii].y);
+        _fillVerts.push_back(temp);
+        if (ii >= 2) {
+            _fillIndx.push_back(start);
+            _fillIndx.push_back(start+ii-1);
+            _fillIndx.push_back(start+ii);
+        }
+    }
+}
+
+/**
+ * Appends a single line segment to the line buffer.
+ *
+ * @param p1        The start of the segment
+ * @param p2        The end of the segment
+ * @param color     The line color
+ */
+void ObstacleDebugDraw::addSegment(const b2Vec2& p1, const b2Vec2& p2, Color4 color) {
+    if (_lineVerts.size()+2 > _capacity) {
+        flushLines();
+    }
+
+    unsigned short start = (unsigned short)_lineVerts.size();
+    Vertex2 temp;
+    temp.color = color;
+    temp.position.set(p1.x,p1.y);
+    _lineVerts.push_back(temp);
+    temp.position.set(p2.x,p2.y);
+    _lineVerts.push_back(temp);
+    _lineIndx.push_back(start);
+    _lineIndx.push_back(start+1);
+}
+
+/**
+ * Approximates a circle with a polygon.
+ *
+ * @param center    The circle center
+ * @param radius    The circle radius
+ * @param vertices  The array to store the polygon (of DEBUG_CIRCLE_SEGMENTS)
+ */
+void ObstacleDebugDraw::makeCircle(const b2Vec2& center, float radius, b2Vec2* vertices) const {
+    const float step = 2.0f*b2_pi/DEBUG_CIRCLE_SEGMENTS;
+    for(int ii = 0; ii < DEBUG_CIRCLE_SEGMENTS; ii++) {
+        float angle = ii*step;
+        vertices[ii].Set(center.x+radius*cosf(angle),center.y+radius*sinf(angle));
+    }
+}
+
+/**
+ * Draws the touching contacts of the given world.
+ *
+ * @param world     The Box2D world
+ */
+void ObstacleDebugDraw::drawContacts(b2World* world) {
+    b2Color color(_contactColor.r/255.0f,_contactColor.g/255.0f,
+                  _contactColor.b/255.0f,_contactColor.a/255.0f);
+    b2WorldManifold manifold;
+    for(b2Contact* contact = world->GetContactList(); contact; contact = contact->GetNext()) {
+        if (!contact->IsTouching()) {
+            continue;
+        }
+        contact->GetWorldManifold(&manifold);
+        int count = contact->GetManifold()->pointCount;
+        for(int ii = 0; ii < count; ii++) {
+            DrawPoint(manifold.points[ii], 0, color);
+            addSegment(manifold.points[ii], manifold.points[ii]+_axisLength*manifold.normal, _contactColor);
+        }
+    }
+}
+
+/**
+ * Submits the fill buffer to the sprite batch and clears it.
+ */
+void ObstacleDebugDraw::flushFills() {
+    if (_fillVerts.empty()) {
+        return;
+    }
+    _batch->fill(_fillVerts.data(), (unsigned int)_fillVerts.size(), 0,
+                 _fillIndx.data(), (unsigned int)_fillIndx.size(), 0,
+                 _transform, false);
+    _fillVerts.clear();
+    _fillIndx.clear();
+}
+
+/**
+ * Submits the line buffer to the sprite batch and clears it.
+ */
+void ObstacleDebugDraw::flushLines() {
+    if (_lineVerts.empty()) {
+        return;
+    }
+    _batch->outline(_lineVerts.data(), (unsigned int)_lineVerts.size(), 0,
+                    _lineIndx.data(), (unsigned int)_lineIndx.size(), 0,
+                    _transform, false);
+    _lineVerts.clear();
+    _lineIndx.clear();
+}
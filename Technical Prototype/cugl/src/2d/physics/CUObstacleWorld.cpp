@@ -48,6 +48,12 @@
 #include <Box2D/Collision/b2Collision.h>
 #include <cugl/2d/physics/CUObstacleWorld.h>
 #include <cugl/2d/physics/CUObstacle.h>
+#include <cugl/2d/physics/CUObstacleDebugDraw.h>
+#include <cugl/util/CUThreadPool.h>
+#include <condition_variable>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 using namespace cugl;
 
@@ -55,6 +61,8 @@ using namespace cugl;
 
 /** The default value of gravity (going down) */
 #define DEFAULT_GRAVITY -9.8f
+/** The number of batched queries a thread claims at a time */
+#define QUERY_CHUNK 32
 
 #pragma mark -
 #pragma mark Proxy Classes
@@ -151,6 +159,104 @@ public:
     }
 };
 
+/**
+ * A b2IslandTask running a batch of queries.
+ *
+ * This lets the batched queries share the threads of the island executor.
+ * Every thread claims chunks of the batch until none are left.
+ */
+class QueryTask : public b2IslandTask {
+private:
+    /** The function to run a range of queries */
+    const std::function<void(size_t begin, size_t end)>& _work;
+    /** The number of queries */
+    size_t _count;
+    /** The first query not yet claimed */
+    std::atomic<size_t> _next;
+
+public:
+    /**
+     * Creates a task for the given batch of queries
+     *
+     * @param work  The function to run a range of queries
+     * @param count The number of queries
+     */
+    QueryTask(const std::function<void(size_t begin, size_t end)>& work, size_t count) :
+    _work(work), _count(count), _next(0) {}
+
+    /**
+     * Runs chunks of queries until the batch is finished.
+     */
+    void Run(int32) override {
+        size_t begin;
+        while ((begin = _next.fetch_add(QUERY_CHUNK)) < _count) {
+            _work(begin, std::min(begin+QUERY_CHUNK, _count));
+        }
+    }
+};
+
+/**
+ * A b2IslandExecutor backed by a thread pool.
+ *
+ * The calling thread solves islands as thread 0, while the pool threads
+ * solve islands as the other threads.
+ */
+class ThreadPoolExecutor : public b2IslandExecutor {
+private:
+    /** The pool threads (one less than the thread count) */
+    std::shared_ptr<ThreadPool> _pool;
+    /** The total number of threads, including the calling thread */
+    int _threads;
+    /** The number of pool threads still running the current task */
+    int _running;
+    /** A mutex lock for the running count */
+    std::mutex _mutex;
+    /** A condition variable signaled when the pool threads finish */
+    std::condition_variable _finished;
+
+public:
+    /**
+     * Creates an executor with the given number of threads
+     *
+     * @param threads   The total number of threads, including the calling thread
+     */
+    ThreadPoolExecutor(int threads) : _threads(threads), _running(0) {
+        _pool = ThreadPool::alloc(threads-1);
+    }
+
+    /**
+     * Returns the total number of threads, including the calling thread
+     *
+     * @return the total number of threads, including the calling thread
+     */
+    int32 GetThreadCount() const override { return _threads; }
+
+    /**
+     * Runs the task on every thread, returning when all are finished.
+     *
+     * @param task  The task to run
+     */
+    void Execute(b2IslandTask* task) override {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = _threads-1;
+        }
+        for(int ii = 1; ii < _threads; ii++) {
+            _pool->addTask([=](void) {
+                task->Run(ii);
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_running == 0) {
+                    _finished.notify_one();
+                }
+            });
+        }
+        task->Run(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _running == 0; });
+    }
+};
+
 
 #pragma mark -
 #pragma mark Constructors
@@ -162,9 +268,12 @@ public:
  */
 ObstacleWorld::ObstacleWorld() :
 _world(nullptr),
+_threads(1),
+_executor(nullptr),
 _collide(false),
 _filters(false),
-_destroy(false) {
+_destroy(false),
+_debug(false) {
     _lockstep   = false;
     _stepssize  = DEFAULT_WORLD_STEP;
     _itvelocity = DEFAULT_WORLD_VELOC;
@@ -189,6 +298,13 @@ void ObstacleWorld::dispose() {
         delete _world;
         _world  = nullptr;
     }
+    if (_executor != nullptr) {
+        delete _executor;
+        _executor = nullptr;
+    }
+    _threads = 1;
+    _debug = false;
+    _debugDraw = nullptr;
     onBeginContact = nullptr;
     onEndContact   = nullptr;
     beforeSolve    = nullptr;
@@ -233,6 +349,7 @@ bool ObstacleWorld::init(const Rect& bounds, const Vec2& gravity) {
     _bounds = bounds;
     _world = new b2World(b2Vec2(gravity.x,gravity.y));
     if (_world) {
+        _world->SetIslandExecutor(_executor);
         return true;
     }
     return false;
@@ -344,6 +461,50 @@ void ObstacleWorld::setGravity(const Vec2& gravity) {
     }
 }
 
+/**
+ * Sets the number of threads used to solve the physics islands.
+ *
+ * An island is a group of bodies connected by contacts or joints. If this
+ * value is 1 (the default), the islands are solved serially. Otherwise,
+ * they are solved in parallel on this many threads, including the thread
+ * calling {@link update}. The extra threads belong to this world.
+ *
+ * Parallel solving gives exactly the same results as serial solving. The
+ * {@link afterSolve} callbacks are still called on the thread calling
+ * {@link update}, in the same order. However, they are all called after
+ * every island is solved, rather than after each island.
+ *
+ * Parallel solving only helps worlds with many independent islands. A
+ * world with a single large island is no faster.
+ *
+ * These threads also run large batches of {@link rayCast} and
+ * {@link queryShapes} queries.
+ *
+ * @param  threads  the number of threads used to solve the physics islands.
+ */
+void ObstacleWorld::setSolverThreads(int threads) {
+    CUAssertLog(threads > 0, "The number of threads must be positive");
+    if (_threads == threads) {
+        return;
+    }
+
+    if (_world != nullptr) {
+        _world->SetIslandExecutor(nullptr);
+    }
+    if (_executor != nullptr) {
+        delete _executor;
+        _executor = nullptr;
+    }
+
+    _threads = threads;
+    if (threads > 1) {
+        _executor = new ThreadPoolExecutor(threads);
+    }
+    if (_world != nullptr) {
+        _world->SetIslandExecutor(_executor);
+    }
+}
+
 /**
  * Executes a single step of the physics engine.
  *
@@ -442,6 +603,42 @@ void ObstacleWorld::activateDestructionCallbacks(bool flag) {
 }
 
 
+#pragma mark -
+#pragma mark Debugging
+/**
+ * Sets whether this world draws its debug view.
+ *
+ * The debug view is drawn by {@link drawDebug}.  It streams the physics
+ * shapes directly into a {@link SpriteBatch}, so it does not need the
+ * per-obstacle wireframes of {@link Obstacle#setDebugScene}.  When the
+ * debug view is disabled, it does no work at all.
+ *
+ * @param flag  Whether this world draws its debug view.
+ */
+void ObstacleWorld::setDebug(bool flag) {
+    if (flag && _debugDraw == nullptr) {
+        _debugDraw = ObstacleDebugDraw::alloc();
+    }
+    _debug = flag && _debugDraw != nullptr;
+}
+
+/**
+ * Draws the debug view of this world with the sprite batch.
+ *
+ * The sprite batch must be active (e.g. between calls to begin and end).
+ * The transform converts from physics coordinates to the coordinates of
+ * the sprite batch perspective.  This method does nothing if the debug
+ * view is disabled.
+ *
+ * @param batch     The sprite batch to draw with
+ * @param transform The transform from physics coordinates
+ */
+void ObstacleWorld::drawDebug(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) {
+    if (_debug && _world != nullptr) {
+        _debugDraw->draw(_world, batch, transform);
+    }
+}
+
 #pragma mark -
 #pragma mark Query Functions
 
@@ -478,3 +675,22 @@ void ObstacleWorld::rayCast(std::function<float(b2Fixture* fixture, const Vec2&
     proxy.onQuery = callback;
     _world->RayCast(&proxy, b2Vec2(point1.x,point1.y), b2Vec2(point2.x,point2.y));
 }
+
+/**
+ * Runs a batch of queries, splitting it across the solver threads.
+ *
+ * The work function is called with ranges [begin,end) that cover the
+ * batch exactly once.  Small batches (and serial worlds) are run on the
+ * calling thread in a single range.
+ *
+ * @param  count    The number of queries
+ * @param  work     The function to run a range of queries
+ */
+void ObstacleWorld::runQueries(size_t count, const std::function<void(size_t begin, size_t end)>& work) const {
+    if (_executor == nullptr || count <= QUERY_CHUNK) {
+        work(0, count);
+        return;
+    }
+    QueryTask task(work, count);
+    _executor->Execute(&task);
+}
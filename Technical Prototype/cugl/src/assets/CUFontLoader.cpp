@@ -82,13 +82,19 @@ _charset(UNKNOWN_CHARS) {
  * Hence this method does the maximum amount of work that can be done in
  * asynchronous font loading.
  *
+ * If distance is true, the font gets a distance field atlas instead of
+ * a bitmap atlas.  The character set is then only the initial contents
+ * of the atlas, as missing glyphs are added when they are drawn.
+ *
  * @param source    The pathname to the asset
  * @param charset   The atlas character set
  * @param charset   The font size
+ * @param distance  Whether to build a distance field atlas
  *
  * @return the font asset with no generated atlas
  */
-std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset, int size) {
+std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset, int size,
+                                          bool distance) {
     // Make sure we reference the asset directory
 #if defined (__WINDOWS__)
     bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
@@ -104,7 +110,9 @@ std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::
         return result;
     }
     
-    if (charset.empty()) {
+    if (distance) {
+        result->buildDistanceAtlasAsync(charset);
+    } else if (charset.empty()) {
         result->buildAtlasAsync();
     } else {
         result->buildAtlasAsync(charset);
@@ -210,6 +218,7 @@ bool FontLoader::read(const std::string& key, const std::string& source, int siz
  *      "file":         The path to the asset
  *      "size":         This font size (int)
  *      "charset":      The set of characters for the font atlas (string)
+ *      "atlas":        The atlas type, "bitmap" (default) or "distance"
  *
  * @param json      The directory entry for the asset
  * @param callback  An optional callback for asynchronous loading
@@ -227,10 +236,11 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     std::string source  = json->getString("file",UNKNOWN_SOURCE);
     std::string charset = json->getString("charset",UNKNOWN_CHARS);
     int size = json->getInt("size",UNKNOWN_SIZE);
+    bool distance = json->getString("atlas","bitmap") == "distance";
     
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Font> font = preload(source,charset,size);
+        std::shared_ptr<Font> font = preload(source,charset,size,distance);
         if (font != nullptr) {
             success = true;
             materialize(key,font,callback);
@@ -239,7 +249,7 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<Font> font = this->preload(source,charset,size);
+            std::shared_ptr<Font> font = this->preload(source,charset,size,distance);
             Application::get()->schedule([=](void){
                 this->materialize(key,font,callback);
                 return false;
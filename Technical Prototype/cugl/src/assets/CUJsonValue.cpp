@@ -4,8 +4,9 @@
 //
 //  This module a modern C++ alternative to the cJSON interface for reading
 //  JSON files.  In particular, this gives us better type-checking and memory
-//  management.  With that said, it still uses cJSON as the underlying parsing
-//  engine.
+//  management.  JSON strings are parsed in a single pass, building the nodes
+//  directly from the source buffer, and encoded in a single pass as well.
+//  cJSON is only used to convert to and from cJSON nodes.
 //
 //  This class uses our standard shared-pointer architecture.
 //
@@ -44,6 +45,10 @@
 #include <cugl/assets/CUJsonValue.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUStrings.h>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 
 using namespace cugl;
 
@@ -242,6 +247,493 @@ cJSON* JsonValue::toCJSON(const JsonValue* value) {
     return result;
 }
 
+#pragma mark -
+#pragma mark Direct Parsing
+/**
+ * Returns the first non-whitespace position at or after json
+ *
+ * @param json  The current position in the source buffer
+ * @param end   The end of the source buffer
+ *
+ * @return the first non-whitespace position at or after json
+ */
+static const char* skip_space(const char* json, const char* end) {
+    while (json < end && (*json == ' ' || *json == '\n' || *json == '\r' || *json == '\t')) {
+        json++;
+    }
+    return json;
+}
+
+/**
+ * Returns true if the buffer at json starts with the given literal
+ *
+ * @param json      The current position in the source buffer
+ * @param end       The end of the source buffer
+ * @param literal   The literal to match
+ * @param length    The length of the literal
+ *
+ * @return true if the buffer at json starts with the given literal
+ */
+static bool match_literal(const char* json, const char* end, const char* literal, size_t length) {
+    return (size_t)(end-json) >= length && strncmp(json,literal,length) == 0;
+}
+
+/**
+ * Returns the value of four hex digits, or -1 if they are invalid
+ *
+ * @param json  The start of the digits
+ * @param end   The end of the source buffer
+ *
+ * @return the value of four hex digits, or -1 if they are invalid
+ */
+static long parse_hex4(const char* json, const char* end) {
+    if (end-json < 4) {
+        return -1;
+    }
+    long result = 0;
+    for(int ii = 0; ii < 4; ii++) {
+        char c = json[ii];
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= c-'0';
+        } else if (c >= 'a' && c <= 'f') {
+            result |= c-'a'+10;
+        } else if (c >= 'A' && c <= 'F') {
+            result |= c-'A'+10;
+        } else {
+            return -1;
+        }
+    }
+    return result;
+}
+
+/**
+ * Appends the given code point to the string as UTF8
+ *
+ * @param result    The string to append to
+ * @param code      The code point to encode
+ */
+static void append_utf8(std::string& result, unsigned long code) {
+    if (code < 0x80) {
+        result.push_back((char)code);
+    } else if (code < 0x800) {
+        result.push_back((char)(0xC0 | (code >> 6)));
+        result.push_back((char)(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        result.push_back((char)(0xE0 | (code >> 12)));
+        result.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        result.push_back((char)(0x80 | (code & 0x3F)));
+    } else {
+        result.push_back((char)(0xF0 | (code >> 18)));
+        result.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+        result.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+        result.push_back((char)(0x80 | (code & 0x3F)));
+    }
+}
+
+/**
+ * Parses the JSON number at the given position into the given node.
+ *
+ * Integers that fit in a long are converted directly.  All other numbers
+ * are converted with from_chars, so that the source buffer does not need
+ * to be null-terminated.
+ *
+ * @param json      The current position in the source buffer
+ * @param end       The end of the source buffer
+ * @param longval   The long value of the number
+ * @param dblval    The double value of the number
+ *
+ * @return the position after the number, or nullptr if it is invalid
+ */
+static const char* parse_number(const char* json, const char* end, long& longval, double& dblval) {
+    const char* pos = json;
+    bool negative = false;
+    if (pos < end && *pos == '-') {
+        negative = true;
+        pos++;
+    }
+    
+    // Fast path for integers
+    const char* digits = pos;
+    long whole = 0;
+    while (pos < end && *pos >= '0' && *pos <= '9' && pos-digits < 18) {
+        whole = 10*whole+(*pos-'0');
+        pos++;
+    }
+    if (pos == digits) {
+        return nullptr;
+    }
+    if (pos == end || !(*pos == '.' || *pos == 'e' || *pos == 'E' || (*pos >= '0' && *pos <= '9'))) {
+        longval = negative ? -whole : whole;
+        dblval  = (double)longval;
+        return pos;
+    }
+    
+    // Everything else
+    while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '.' ||
+                         *pos == 'e' || *pos == 'E' || *pos == '+' || *pos == '-')) {
+        pos++;
+    }
+    if (cugl::from_chars(json,pos,dblval) != pos) {
+        return nullptr;
+    }
+    longval = (long)dblval;
+    return pos;
+}
+
+/**
+ * Parses the quoted JSON string at the given position.
+ *
+ * Any escape sequences are decoded as UTF8.  The result is assigned to
+ * the given string, replacing its contents.
+ *
+ * On success, the position is advanced just past the closing quote.  On
+ * failure, the position is left at the offending character.
+ *
+ * @param result    The string to store the result
+ * @param json      The current position in the source buffer
+ * @param end       The end of the source buffer
+ *
+ * @return true if the string was parsed successfully.
+ */
+bool JsonValue::parseString(std::string& result, const char*& json, const char* end) {
+    const char* pos = json+1;
+    const char* start = pos;
+    while (pos < end && *pos != '"' && *pos != '\\') {
+        pos++;
+    }
+    if (pos == end) {
+        return false;
+    }
+    result.assign(start,pos);
+    if (*pos == '"') {
+        json = pos+1;
+        return true;
+    }
+    
+    // Slow path for escapes
+    while (pos < end && *pos != '"') {
+        if (*pos != '\\') {
+            start = pos;
+            while (pos < end && *pos != '"' && *pos != '\\') {
+                pos++;
+            }
+            result.append(start,pos);
+            continue;
+        }
+        
+        if (++pos == end) {
+            break;
+        }
+        switch (*pos) {
+            case 'b':
+                result.push_back('\b');
+                break;
+            case 'f':
+                result.push_back('\f');
+                break;
+            case 'n':
+                result.push_back('\n');
+                break;
+            case 'r':
+                result.push_back('\r');
+                break;
+            case 't':
+                result.push_back('\t');
+                break;
+            case '"':
+            case '\\':
+            case '/':
+                result.push_back(*pos);
+                break;
+            case 'u':
+            {
+                long code = parse_hex4(pos+1,end);
+                if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF)) {
+                    json = pos;
+                    return false;
+                }
+                pos += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // Surrogate pair
+                    long low = -1;
+                    if (end-pos > 2 && pos[1] == '\\' && pos[2] == 'u') {
+                        low = parse_hex4(pos+3,end);
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        json = pos;
+                        return false;
+                    }
+                    code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+                    pos += 6;
+                }
+                append_utf8(result,(unsigned long)code);
+            }
+                break;
+            default:
+                json = pos;
+                return false;
+        }
+        pos++;
+    }
+    if (pos == end) {
+        json = pos;
+        return false;
+    }
+    json = pos+1;
+    return true;
+}
+
+/**
+ * Parses the JSON value at the given position into the given node.
+ *
+ * This method recursively allocates child nodes as necessary, attaching
+ * them to the node as they are parsed.  String payloads are copied once,
+ * directly from the source buffer into the node.
+ *
+ * On success, the position is advanced just past the value.  On failure,
+ * the position is left at the offending character.
+ *
+ * @param value The node to store the value
+ * @param json  The current position in the source buffer
+ * @param end   The end of the source buffer
+ * @param depth The current nesting depth
+ *
+ * @return true if the value was parsed successfully.
+ */
+bool JsonValue::parseValue(JsonValue* value, const char*& json, const char* end, int depth) {
+    if (json >= end) {
+        return false;
+    }
+    
+    switch (*json) {
+        case '{':
+        case '[':
+        {
+            if (depth >= JSON_NESTING_LIMIT) {
+                return false;
+            }
+            bool object = *json == '{';
+            char close  = object ? '}' : ']';
+            value->_type = object ? Type::ObjectType : Type::ArrayType;
+            json = skip_space(json+1,end);
+            if (json < end && *json == close) {
+                json++;
+                return true;
+            }
+            while (json < end) {
+                std::shared_ptr<JsonValue> child = std::make_shared<JsonValue>();
+                if (object) {
+                    if (*json != '"' || !parseString(child->_key,json,end)) {
+                        return false;
+                    }
+                    json = skip_space(json,end);
+                    if (json == end || *json != ':') {
+                        return false;
+                    }
+                    json = skip_space(json+1,end);
+                }
+                if (!parseValue(child.get(),json,end,depth+1)) {
+                    return false;
+                }
+                child->_parent = value;
+                value->_children.push_back(child);
+                
+                json = skip_space(json,end);
+                if (json < end && *json == close) {
+                    json++;
+                    return true;
+                } else if (json == end || *json != ',') {
+                    return false;
+                }
+                json = skip_space(json+1,end);
+            }
+            return false;
+        }
+        case '"':
+            value->_type = Type::StringType;
+            return parseString(value->_stringValue,json,end);
+        case 't':
+            if (match_literal(json,end,"true",4)) {
+                value->_type = Type::BoolType;
+                value->_longValue = 1;
+                json += 4;
+                return true;
+            }
+            return false;
+        case 'f':
+            if (match_literal(json,end,"false",5)) {
+                value->_type = Type::BoolType;
+                value->_longValue = 0;
+                json += 5;
+                return true;
+            }
+            return false;
+        case 'n':
+            if (match_literal(json,end,"null",4)) {
+                value->_type = Type::NullType;
+                json += 4;
+                return true;
+            }
+            return false;
+        default:
+        {
+            const char* next = parse_number(json,end,value->_longValue,value->_doubleValue);
+            if (next) {
+                value->_type = Type::NumberType;
+                json = next;
+                return true;
+            }
+            return false;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Direct Encoding
+/**
+ * Appends the given JSON number to the string
+ *
+ * Integral values are written as integers.  All other values are written
+ * with to_chars, which is faster than sprintf and loses no precision.  As
+ * with cJSON, NaN and infinity are written as null.
+ *
+ * @param result    The string to append to
+ * @param number    The number to write
+ */
+static void append_number(std::string& result, double number) {
+    char buffer[CU_NUMBER_BUFFER];
+    char* end;
+    if (number * 0 != 0) {
+        result.append("null",4);
+        return;
+    } else if (number == std::floor(number) && std::fabs(number) < 9.0e18) {
+        end = cugl::to_chars(buffer, buffer+CU_NUMBER_BUFFER, (Sint64)number);
+    } else {
+        end = cugl::to_chars(buffer, buffer+CU_NUMBER_BUFFER, number);
+    }
+    result.append(buffer,end-buffer);
+}
+
+/**
+ * Appends the given string to the result as a quoted JSON string
+ *
+ * Quotes, backslashes, and control characters are escaped exactly as
+ * cJSON escapes them.
+ *
+ * @param result    The string to append to
+ * @param text      The string to quote
+ */
+static void append_string(std::string& result, const std::string& text) {
+    static const char* hex = "0123456789abcdef";
+    result.push_back('"');
+    size_t start = 0;
+    for(size_t ii = 0; ii < text.size(); ii++) {
+        unsigned char token = (unsigned char)text[ii];
+        if (token > 31 && token != '"' && token != '\\') {
+            continue;
+        }
+        result.append(text,start,ii-start);
+        start = ii+1;
+        result.push_back('\\');
+        switch (token) {
+            case '"':
+            case '\\':
+                result.push_back((char)token);
+                break;
+            case '\b':
+                result.push_back('b');
+                break;
+            case '\f':
+                result.push_back('f');
+                break;
+            case '\n':
+                result.push_back('n');
+                break;
+            case '\r':
+                result.push_back('r');
+                break;
+            case '\t':
+                result.push_back('t');
+                break;
+            default:
+                result.append("u00",3);
+                result.push_back(hex[token >> 4]);
+                result.push_back(hex[token & 0xf]);
+                break;
+        }
+    }
+    result.append(text,start,text.size()-start);
+    result.push_back('"');
+}
+
+/**
+ * Appends the given node to the string as JSON.
+ *
+ * This method recursively appends the children of the node.  The layout
+ * (including the tabs of a pretty-printed string) is the same as that of
+ * cJSON_Print and cJSON_PrintUnformatted.
+ *
+ * @param result    The string to append to
+ * @param value     The node to encode
+ * @param depth     The current nesting depth
+ * @param format    Whether to pretty-print the JSON string
+ */
+void JsonValue::printValue(std::string& result, const JsonValue* value, int depth, bool format) {
+    switch (value->_type) {
+        case Type::NullType:
+            result.append("null",4);
+            break;
+        case Type::BoolType:
+            if (value->_longValue) {
+                result.append("true",4);
+            } else {
+                result.append("false",5);
+            }
+            break;
+        case Type::NumberType:
+            append_number(result,value->_doubleValue);
+            break;
+        case Type::StringType:
+            append_string(result,value->_stringValue);
+            break;
+        case Type::ArrayType:
+            result.push_back('[');
+            for(auto it = value->_children.begin(); it != value->_children.end(); ++it) {
+                if (it != value->_children.begin()) {
+                    result.append(", ",format ? 2 : 1);
+                }
+                printValue(result,it->get(),depth+1,format);
+            }
+            result.push_back(']');
+            break;
+        case Type::ObjectType:
+            result.push_back('{');
+            if (format) {
+                result.push_back('\n');
+            }
+            for(auto it = value->_children.begin(); it != value->_children.end(); ++it) {
+                if (format) {
+                    result.append(depth+1,'\t');
+                }
+                append_string(result,(*it)->_key);
+                result.append(":\t",format ? 2 : 1);
+                printValue(result,it->get(),depth+1,format);
+                if (it+1 != value->_children.end()) {
+                    result.push_back(',');
+                }
+                if (format) {
+                    result.push_back('\n');
+                }
+            }
+            if (format) {
+                result.append(depth,'\t');
+            }
+            result.push_back('}');
+            break;
+    }
+}
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -364,18 +856,49 @@ bool JsonValue::init(double value) {
  * @return  true if the JSON node is initialized properly, false otherwise.
  */
 bool JsonValue::initWithJson(const char* json) {
-    const char *error = NULL;
-    cJSON* node = cJSON_ParseWithOpts(json, &error, 0);
-    if (node) {
-        toJsonValue(this,node);
-        cJSON_Delete(node);
+    return initWithJson(json,strlen(json));
+}
+
+/**
+ * Initializes a new JsonValue from the given JSON buffer.
+ *
+ * This initializer parses the first JSON value in the buffer, building
+ * the tree directly from the buffer in a single pass.  The buffer does
+ * not need to be null-terminated, and any text after the value is
+ * ignored.  If consumed is not nullptr, it is set to the number of bytes
+ * read, including any leading whitespace.
+ *
+ * If there is a parsing error, this method will return false.  Detailed
+ * information about the parsing error will be passed to an assert.  Hence
+ * error messages are suppressed if asserts are turned off.
+ *
+ * @param json      The JSON buffer to parse.
+ * @param length    The length of the buffer in bytes.
+ * @param consumed  Pointer to store the number of bytes read (optional)
+ *
+ * @return  true if the JSON node is initialized properly, false otherwise.
+ */
+bool JsonValue::initWithJson(const char* json, size_t length, size_t* consumed) {
+    const char* end = json+length;
+    const char* pos = skip_space(json,end);
+    if (parseValue(this,pos,end,0)) {
+        if (consumed) {
+            *consumed = (size_t)(pos-json);
+        }
         return true;
     }
-    if (error) {
-        CUAssertLog(false, "Invalid token at %s",error);
+    
+    if (pos < end) {
+        int line = 1;
+        for(const char* it = json; it < pos; ++it) {
+            line += (*it == '\n');
+        }
+        CUAssertLog(false, "Invalid token at line %d: %.*s", line, (int)std::min<ptrdiff_t>(end-pos,32), pos);
     } else {
-        CUAssertLog(false, "Invalid JSON");
+        CUAssertLog(false, "Invalid JSON: unexpected end of input");
     }
+    _type = Type::NullType;
+    _children.clear();
     return false; // If asserts turned off
 }
 
@@ -1194,19 +1717,7 @@ void JsonValue::insertChild(unsigned int index, const std::string& key,
  * @return a string representation of this JSON.
  */
 std::string JsonValue::toString(bool format) const {
-    cJSON* ast = toCJSON(this);
-    char* data = nullptr;
-    if (format) {
-        data = cJSON_Print(ast);
-    } else {
-        data = cJSON_PrintUnformatted(ast);
-    }
-    if (data) {
-        std::string result(data);
-        
-        free(data);
-        cJSON_Delete(ast);
-        return result;
-    }
-    return "";
+    std::string result;
+    printValue(result,this,0,format);
+    return result;
 }
@@ -45,6 +45,7 @@
 //
 #include <cugl/assets/CUTextureLoader.h>
 #include <cugl/base/CUApplication.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <SDL/SDL_image.h>
 
 using namespace cugl;
@@ -58,6 +59,21 @@ using namespace cugl;
 #define UNKNOWN_MAGFLT  "linear"
 /** The default wrap rule */
 #define UNKNOWN_WRAP    "clamp"
+/** The file extension for KTX images */
+#define KTX_EXTENSION   ".ktx"
+
+/**
+ * Returns true if the given source is a KTX image
+ *
+ * @param source    The pathname to the asset
+ *
+ * @return true if the given source is a KTX image
+ */
+static bool isKTX(const std::string& source) {
+    size_t len = source.size();
+    size_t ext = strlen(KTX_EXTENSION);
+    return len > ext && source.compare(len-ext,ext,KTX_EXTENSION) == 0;
+}
 
 /**
  * Returns the OpenGL enum for the given min filter name
@@ -167,7 +183,7 @@ SDL_Surface* TextureLoader::preload(const std::string& source) {
     
     std::string path = Application::get()->getAssetDirectory();
     path.append(source);
-    SDL_Surface* surface = IMG_Load(path.c_str());
+    SDL_Surface* surface = IMG_Load_RW(AssetArchive::openFile(path,"rb"),1);
     if (surface == nullptr) {
         return nullptr;
     }
@@ -182,6 +198,36 @@ SDL_Surface* TextureLoader::preload(const std::string& source) {
     return normal;
 }
 
+/**
+ * Loads the portion of a KTX asset that is safe to load outside the main thread.
+ *
+ * This method reads the KTX container into memory.  If the image is
+ * compressed in a format not supported by this platform, this method
+ * also decompresses it (with all of its mipmaps) to RGBA data.  Hence
+ * the main thread only has to upload the data to OpenGL.
+ *
+ * @param source    The pathname to the asset
+ *
+ * @return the KTX image ready for upload to OpenGL
+ */
+std::shared_ptr<KTXImage> TextureLoader::preloadKTX(const std::string& source) {
+    // Make sure we reference the asset directory
+#if defined (__WINDOWS__)
+    bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
+#else
+    bool absolute = source[0] == '/';
+#endif
+    CUAssertLog(!absolute, "This loader does not accept absolute paths for assets");
+
+    std::string path = Application::get()->getAssetDirectory();
+    path.append(source);
+    std::shared_ptr<KTXImage> image = KTXImage::alloc(path);
+    if (image != nullptr && !image->isSupported()) {
+        image = image->decompress();
+    }
+    return image;
+}
+
 /**
  * Creates an OpenGL texture from the SDL_Surface, and assigns it the given key.
  *
@@ -279,6 +325,93 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
     _queue.erase(key);
 }
 
+/**
+ * Creates an OpenGL texture from the KTX image, and assigns it the given key.
+ *
+ * This method finishes the asset loading started in {@link preloadKTX}.
+ * This step is not safe to be done in a separate thread.  Instead, it
+ * takes place in the main CUGL thread via {@link Application#schedule}.
+ *
+ * The loaded texture will have default parameters for scaling and wrap.
+ * It will have the mipmaps stored in the image, if any.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param key       The key to access the asset after loading
+ * @param image     The KTX image to upload
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materialize(const std::string& key, const std::shared_ptr<KTXImage>& image, LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = (image == nullptr ? nullptr : Texture::allocWithKTX(image));
+
+    bool success = false;
+    if (texture != nullptr) {
+        _assets[key] = texture;
+        texture->bind();
+        if (_mipmaps && !texture->hasMipMaps() && !texture->isCompressed()) { texture->buildMipMaps(); }
+        texture->setMinFilter(_minfilter);
+        texture->setMagFilter(_magfilter);
+        texture->setWrapS(_wraps);
+        texture->setWrapT(_wrapt);
+        texture->unbind();
+        success = true;
+    }
+
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    _queue.erase(key);
+}
+
+/**
+ * Creates an OpenGL texture from the KTX image accoring to the directory entry.
+ *
+ * This method finishes the asset loading started in {@link preloadKTX}.
+ * This step is not safe to be done in a separate thread.  Instead, it
+ * takes place in the main CUGL thread via {@link Application#schedule}.
+ *
+ * The directory entry is the same as for {@link materialize} with an
+ * SDL_Surface.  However, the "mipmaps" value is ignored for compressed
+ * images, which must have their mipmaps prebuilt.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param json      The asset directory entry
+ * @param image     The KTX image to upload
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, const std::shared_ptr<KTXImage>& image, LoaderCallback callback) {
+    std::shared_ptr<Texture> texture = (image == nullptr ? nullptr : Texture::allocWithKTX(image));
+    std::string key = json->key();
+
+    bool success = false;
+    if (texture != nullptr) {
+        GLuint minflt = decodeMinFilter(json->getString("minfilter",UNKNOWN_MINFLT));
+        GLuint magflt = decodeMinFilter(json->getString("magfilter",UNKNOWN_MAGFLT));
+        GLuint wrapS = decodeWrap(json->getString("wrapS",UNKNOWN_WRAP));
+        GLuint wrapT = decodeWrap(json->getString("wrapT",UNKNOWN_WRAP));
+        bool mipmaps = json->getBool("mipmaps",false);
+
+        _assets[key] = texture;
+        texture->bind();
+        if (mipmaps && !texture->hasMipMaps() && !texture->isCompressed()) { texture->buildMipMaps(); }
+        texture->setMinFilter(minflt);
+        texture->setMagFilter(magflt);
+        texture->setWrapS(wrapS);
+        texture->setWrapT(wrapT);
+        texture->unbind();
+
+        success = true;
+    }
+
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    _queue.erase(key);
+}
+
 /**
  * Internal method to support asset loading.
  *
@@ -313,6 +446,14 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
         _queue.erase(key);
     } else {
         _loader->addTask([=](void) {
+            if (isKTX(source)) {
+                std::shared_ptr<KTXImage> image = this->preloadKTX(source);
+                Application::get()->schedule([=](void){
+                    this->materialize(key,image,callback);
+                    return false;
+                });
+                return;
+            }
             SDL_Surface* surface = this->preload(source);
             Application::get()->schedule([=](void){
                 this->materialize(key,surface,callback);
@@ -324,7 +465,7 @@ bool TextureLoader::read(const std::string& key, const std::string& source, Load
 	if (success) {
 		std::shared_ptr<Texture> texture = get(key);
 		texture->bind();
-		if (_mipmaps) { texture->buildMipMaps(); }
+		if (_mipmaps && !texture->hasMipMaps() && !texture->isCompressed()) { texture->buildMipMaps(); }
 		texture->setMinFilter(_minfilter);
 		texture->setMagFilter(_magfilter);
 		texture->setWrapS(_wraps);
@@ -382,6 +523,14 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
         _queue.erase(key);
     } else {
         _loader->addTask([=](void) {
+            if (isKTX(source)) {
+                std::shared_ptr<KTXImage> image = this->preloadKTX(source);
+                Application::get()->schedule([=](void){
+                    this->materialize(json,image,callback);
+                    return false;
+                });
+                return;
+            }
             SDL_Surface* surface = this->preload(source);
             Application::get()->schedule([=](void){
                 this->materialize(json,surface,callback);
@@ -400,7 +549,7 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
         
         std::shared_ptr<Texture> texture = get(key);
         texture->bind();
-        if (mipmaps) { texture->buildMipMaps(); }
+        if (mipmaps && !texture->hasMipMaps() && !texture->isCompressed()) { texture->buildMipMaps(); }
         texture->setMinFilter(minflt);
         texture->setMagFilter(magflt);
         texture->setWrapS(wrapS);
@@ -59,14 +59,18 @@ AudioEngine* AudioEngine::_gEngine = nullptr;
  * the mixer graph for the sound effect channels.  The provided parameter
  * indicates the number of simultaneously supported sounds.
  *
+ * The block size is the size of the device buffer on SDL platforms.  It
+ * is ignored by AVFoundation, which manages its own buffers.
+ *
  * @param channels  The maximum number of sound effect channels to support
+ * @param block     The device block size in frames
  *
  * @return true if the audio engine was successfully initialized.
  */
-bool AudioEngine::init(unsigned int channels) {
+bool AudioEngine::init(unsigned int channels, unsigned int block) {
     CUAssertLog(channels, "The number of channels must be non-zero");
     
-    if (!cugl::impl::AudioStart(AUDIO_FREQUENCY, channels, AUDIO_OUTPUT_CHANNELS)) {
+    if (!cugl::impl::AudioStart(AUDIO_FREQUENCY, channels, AUDIO_OUTPUT_CHANNELS, block)) {
         return false;
     }
     
@@ -194,14 +198,21 @@ void AudioEngine::removeKey(std::string key) {
  * The provided parameter indicates the number of simultaneously supported
  * sounds.
  *
+ * The block size is the size of the device buffer on SDL platforms, and
+ * so it bounds the latency of the engine.  It is ignored by AVFoundation.
+ * A {@link SoundMixer} that attaches to this engine (on platforms with only
+ * one audio device) has the same latency, so such games should start the
+ * engine with the block size of the mixer.
+ *
  * @param channels  The maximum number of sound effect channels to support
+ * @param block     The device block size in frames
  */
-void AudioEngine::start(unsigned int channels) {
+void AudioEngine::start(unsigned int channels, unsigned int block) {
     if (_gEngine != nullptr) {
         return;
     }
     _gEngine = new AudioEngine();
-    if (!_gEngine->init(channels)) {
+    if (!_gEngine->init(channels,block)) {
         delete _gEngine;
         _gEngine = nullptr;
         CUAssertLog(false,"Sound engine failed to initialize");
@@ -0,0 +1,497 @@
+//
+//  CUMusicStream.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an incremental Ogg Vorbis decoder for SoundMixer.
+//  A music stream decodes a Vorbis file a few pages at a time into a fixed
+//  size ring buffer, resampling to the output rate as it goes.  The memory
+//  used by a stream is therefore bounded, regardless of the length of the
+//  track.
+//
+//  Each stream is shared by three threads.  The decoder thread writes to the
+//  ring buffer, the audio thread reads from it, and the main thread controls
+//  it (seeking and looping).  They communicate only through atomics, so no
+//  thread ever blocks on another.  Because the decoder loops back to the
+//  start of the file without draining the ring buffer, looping is gapless.
+//
+//  Streams need libvorbisfile, which is only linked on some platforms.  The
+//  decoder is compiled only if the build defines CU_MUSIC_STREAM.  Otherwise
+//  every stream fails to initialize, and SoundMixer cannot play music.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#ifdef CU_MUSIC_STREAM
+#define OV_EXCLUDE_STATIC_CALLBACKS
+#include <vorbis/vorbisfile.h>
+#endif
+#include <cugl/audio/CUMusicStream.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/io/CUAssetArchive.h>
+#include <algorithm>
+#include <cmath>
+
+/** The most source frames to decode at once */
+#define MUSIC_CHUNK 1024
+
+using namespace cugl;
+
+#ifdef CU_MUSIC_STREAM
+#pragma mark -
+#pragma mark SDL Callbacks
+/**
+ * Reads from an SDL_RWops on behalf of vorbisfile.
+ *
+ * @param ptr       The buffer to read into
+ * @param size      The size of each element
+ * @param nmemb     The number of elements to read
+ * @param source    The SDL_RWops
+ *
+ * @return the number of elements read
+ */
+static size_t rwops_read(void* ptr, size_t size, size_t nmemb, void* source) {
+    return SDL_RWread((SDL_RWops*)source, ptr, size, nmemb);
+}
+
+/**
+ * Seeks in an SDL_RWops on behalf of vorbisfile.
+ *
+ * @param source    The SDL_RWops
+ * @param offset    The seek offset
+ * @param whence    The seek origin (SEEK_SET, SEEK_CUR, SEEK_END)
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int rwops_seek(void* source, ogg_int64_t offset, int whence) {
+    return SDL_RWseek((SDL_RWops*)source, offset, whence) < 0 ? -1 : 0;
+}
+
+/**
+ * Closes an SDL_RWops on behalf of vorbisfile.
+ *
+ * @param source    The SDL_RWops
+ *
+ * @return 0 on success
+ */
+static int rwops_close(void* source) {
+    return SDL_RWclose((SDL_RWops*)source);
+}
+
+/**
+ * Returns the position of an SDL_RWops on behalf of vorbisfile.
+ *
+ * @param source    The SDL_RWops
+ *
+ * @return the position of the SDL_RWops
+ */
+static long rwops_tell(void* source) {
+    return (long)SDL_RWtell((SDL_RWops*)source);
+}
+#endif
+
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized music stream.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+MusicStream::MusicStream() :
+_file(nullptr),
+_srcRate(0),
+_srcChannels(0),
+_srcFrames(0),
+_rate(0),
+_length(0),
+_capacity(0),
+_phase(0),
+_written(0),
+_read(0),
+_readEpoch(0),
+_gain(1.0f),
+_goal(1.0f),
+_step(0.0f),
+_stopping(false) {
+    _last[0] = _last[1] = 0;
+    _write = 0;
+    _readPos = 0;
+    _eof  = false;
+    _loop = false;
+    _seekRequest = -1;
+    _seekEpoch = 0;
+    _seekWrite = 0;
+    _seekBase  = 0;
+    _elapsed   = 0;
+    _underruns = 0;
+    _state = (int)State::PLAYING;
+}
+
+/**
+ * Closes the decoder and releases the ring buffer.
+ *
+ * It is unsafe to call this while the stream is attached to the audio
+ * thread or the decoder thread.
+ */
+void MusicStream::dispose() {
+#ifdef CU_MUSIC_STREAM
+    if (_file) {
+        ov_clear(_file);
+        delete _file;
+        _file = nullptr;
+    }
+#endif
+    _source.clear();
+    _ring.clear();
+    _capacity = 0;
+    _srcRate = 0;
+    _srcChannels = 0;
+    _srcFrames = 0;
+    _rate = 0;
+    _length = 0;
+}
+
+/**
+ * Initializes a stream for the given Ogg Vorbis file.
+ *
+ * This method reads the file header, but does not decode any audio.  The
+ * file is read through SDL, so on Android this may be a path inside of the
+ * application package.
+ *
+ * If the build does not define CU_MUSIC_STREAM, this method always fails.
+ *
+ * @param file      The path to the Ogg Vorbis file
+ * @param rate      The output sample rate
+ * @param capacity  The ring buffer capacity in frames (a power of two)
+ *
+ * @return true if initialization was successful.
+ */
+bool MusicStream::init(const std::string& file, Uint32 rate, Uint32 capacity) {
+    CUAssertLog(_file == nullptr, "Stream is already initialized");
+    CUAssertLog(capacity > 0 && (capacity & (capacity-1)) == 0,
+                "The capacity %d is not a power of two", capacity);
+
+#ifndef CU_MUSIC_STREAM
+    CULogError("Cannot stream '%s': music streams require CU_MUSIC_STREAM", file.c_str());
+    (void)rate;
+    return false;
+#else
+    SDL_RWops* source = AssetArchive::openFile(file, "rb");
+    if (source == nullptr) {
+        CULogError("Could not open music file '%s'", file.c_str());
+        return false;
+    }
+
+    ov_callbacks callbacks;
+    callbacks.read_func  = rwops_read;
+    callbacks.seek_func  = rwops_seek;
+    callbacks.close_func = rwops_close;
+    callbacks.tell_func  = rwops_tell;
+
+    _file = new OggVorbis_File();
+    if (ov_open_callbacks(source, _file, NULL, 0, callbacks) < 0) {
+        CULogError("Music file '%s' is not an Ogg Vorbis file", file.c_str());
+        SDL_RWclose(source);
+        delete _file;
+        _file = nullptr;
+        return false;
+    }
+
+    vorbis_info* info = ov_info(_file, -1);
+    ogg_int64_t total = ov_pcm_total(_file, -1);
+    if (!ov_seekable(_file)) {
+        CUWarn("Music file '%s' is not seekable", file.c_str());
+    }
+
+    _source = file;
+    _srcRate = (Uint32)info->rate;
+    _srcChannels = (Uint32)info->channels;
+    _srcFrames = (total < 0 ? 0 : (Uint64)total);
+    _rate = rate;
+    _length = (Uint64)(_srcFrames*((double)_rate/_srcRate));
+    _capacity = capacity;
+    _ring.resize(2*capacity, 0.0f);
+    return true;
+#endif
+}
+
+
+#pragma mark -
+#pragma mark Main Thread
+/**
+ * Moves the stream to the given position in seconds.
+ *
+ * The seek is performed by the decoder thread.  The audio thread drops
+ * any buffered audio from before the seek as soon as the new audio is
+ * available.
+ *
+ * @param time  The new position in seconds
+ */
+void MusicStream::seek(double time) {
+    Sint64 frame = (Sint64)(std::max(0.0,time)*_srcRate);
+    frame = std::min(frame,(Sint64)_srcFrames);
+    _seekRequest.store(frame, std::memory_order_release);
+}
+
+
+#pragma mark -
+#pragma mark Decoder Thread
+/**
+ * Handles any pending seek request in the decoder thread.
+ */
+void MusicStream::processSeek() {
+    Sint64 frame = _seekRequest.exchange(-1, std::memory_order_acq_rel);
+    if (frame < 0) {
+        return;
+    }
+#ifdef CU_MUSIC_STREAM
+    if (ov_pcm_seek(_file, frame) != 0) {
+        CULogError("Could not seek in music file '%s'", _source.c_str());
+        return;
+    }
+#endif
+
+    _phase = 0;
+    _last[0] = _last[1] = 0;
+    _eof.store(false, std::memory_order_relaxed);
+    _seekWrite.store(_written, std::memory_order_relaxed);
+    _seekBase.store((Uint64)(frame*((double)_rate/_srcRate)), std::memory_order_relaxed);
+    _seekEpoch.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Writes a chunk of decoded audio to the ring buffer.
+ *
+ * The chunk is resampled to the output rate.  The caller must make sure
+ * there is room for the resampled frames.
+ *
+ * @param pcm       The decoded samples, one array per channel
+ * @param frames    The number of source frames
+ */
+void MusicStream::write(float** pcm, Uint32 frames) {
+    float* ring = _ring.data();
+    Uint64 mask = _capacity-1;
+    const float* left  = pcm[0];
+    const float* right = pcm[_srcChannels > 1 ? 1 : 0];
+
+    if (_srcRate == _rate) {
+        for(Uint32 ii = 0; ii < frames; ii++) {
+            Uint64 pos = (_written+ii) & mask;
+            ring[2*pos  ] = left[ii];
+            ring[2*pos+1] = right[ii];
+        }
+        _written += frames;
+        return;
+    }
+
+    // Linear interpolation, continuing from the last frame of the previous chunk
+    double step = (double)_srcRate/_rate;
+    double p = _phase;
+    double end = (double)frames-1;
+    for(; p < end; p += step) {
+        double base = std::floor(p);
+        int a = (int)base;
+        float t = (float)(p-base);
+        float l0 = (a < 0 ? _last[0] : left[a]);
+        float r0 = (a < 0 ? _last[1] : right[a]);
+        float l1 = left[a+1];
+        float r1 = right[a+1];
+        Uint64 pos = _written & mask;
+        ring[2*pos  ] = l0+(l1-l0)*t;
+        ring[2*pos+1] = r0+(r1-r0)*t;
+        _written++;
+    }
+    _phase = p-frames;
+    _last[0] = left[frames-1];
+    _last[1] = right[frames-1];
+}
+
+/**
+ * Decodes audio into the ring buffer.
+ *
+ * This method decodes until the ring buffer is full, the track is done,
+ * or the given number of frames are written.  It should only ever be
+ * called by one thread at a time.
+ *
+ * @param limit The maximum number of frames to write (0 for no limit)
+ *
+ * @return true if any frames were written.
+ */
+bool MusicStream::decode(Uint32 limit) {
+#ifndef CU_MUSIC_STREAM
+    (void)limit;
+    return false;
+#else
+    if (_file == nullptr) {
+        return false;
+    }
+
+    double step = (double)_srcRate/_rate;
+    Uint64 start = _written;
+    bool loops = false;
+    while (limit == 0 || _written-start < limit) {
+        processSeek();
+        if (_eof.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        Uint64 space = _capacity-(_written-_readPos.load(std::memory_order_acquire));
+        if (space < 4) {
+            break;
+        }
+        int amount = (int)std::min((double)MUSIC_CHUNK,(space-2)*step);
+        if (amount <= 0) {
+            break;
+        }
+
+        float** pcm = nullptr;
+        int bitstream = 0;
+        long result = ov_read_float(_file, &pcm, amount, &bitstream);
+        if (result == 0) {
+            // Loop without draining the buffer (gapless)
+            if (_loop.load(std::memory_order_relaxed) && !loops && ov_pcm_seek(_file, 0) == 0) {
+                loops = true;
+                continue;
+            }
+            _eof.store(true, std::memory_order_release);
+            break;
+        } else if (result == OV_HOLE) {
+            continue;
+        } else if (result < 0) {
+            CULogError("Error decoding music file '%s'", _source.c_str());
+            _eof.store(true, std::memory_order_release);
+            break;
+        }
+
+        loops = false;
+        write(pcm, (Uint32)result);
+        _write.store(_written, std::memory_order_release);
+    }
+    return _written != start;
+#endif
+}
+
+
+#pragma mark -
+#pragma mark Audio Thread
+/**
+ * Starts a fade to the given gain.
+ *
+ * The gain changes linearly over the given number of frames, starting
+ * with the next call to {@link mix}.  If stop is true, the stream
+ * finishes once it fades to zero.
+ *
+ * @param gain      The target gain
+ * @param frames    The length of the fade in frames
+ * @param stop      Whether to stop the stream when it is silent
+ */
+void MusicStream::fade(float gain, Uint32 frames, bool stop) {
+    _goal = gain;
+    _stopping = stop;
+    if (frames == 0) {
+        _gain = gain;
+        _step = 0;
+    } else {
+        _step = (gain-_gain)/frames;
+    }
+}
+
+/**
+ * Mixes the next block of this stream into the given buffer.
+ *
+ * The audio is added to the stereo buffer, scaled by the gain envelope.
+ * If the stream finishes during this block (either because the track
+ * ended or because it faded out), this method returns false and updates
+ * the state.
+ *
+ * @param output    The interleaved stereo output buffer
+ * @param frames    The number of frames to mix
+ *
+ * @return false if the stream has finished
+ */
+bool MusicStream::mix(float* output, Uint32 frames) {
+    if (_state.load(std::memory_order_relaxed) != (int)State::PLAYING) {
+        return false;
+    }
+
+    // Jump to the decoded audio after a seek
+    Uint32 epoch = _seekEpoch.load(std::memory_order_acquire);
+    if (epoch != _readEpoch) {
+        _readEpoch = epoch;
+        _read = _seekWrite.load(std::memory_order_relaxed);
+        _readPos.store(_read, std::memory_order_release);
+        _elapsed.store(_seekBase.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    Uint64 write = _write.load(std::memory_order_acquire);
+    Uint32 amt = (Uint32)std::min((Uint64)frames,write-_read);
+
+    const float* ring = _ring.data();
+    Uint64 mask = _capacity-1;
+    float gain = _gain;
+    for(Uint32 ii = 0; ii < frames; ii++) {
+        if (ii < amt) {
+            Uint64 pos = (_read+ii) & mask;
+            output[2*ii  ] += ring[2*pos  ]*gain;
+            output[2*ii+1] += ring[2*pos+1]*gain;
+        }
+        if (gain != _goal) {
+            gain += _step;
+            if ((_step > 0 && gain > _goal) || (_step <= 0 && gain < _goal)) {
+                gain = _goal;
+            }
+        }
+    }
+    _gain = gain;
+    _read += amt;
+    _readPos.store(_read, std::memory_order_release);
+
+    Uint64 elapsed = _elapsed.load(std::memory_order_relaxed)+amt;
+    if (_length > 0 && elapsed >= _length) {
+        elapsed = (_loop.load(std::memory_order_relaxed) ? elapsed % _length : _length);
+    }
+    _elapsed.store(elapsed, std::memory_order_relaxed);
+
+    if (amt < frames) {
+        if (_eof.load(std::memory_order_acquire) && _read == _write.load(std::memory_order_acquire)) {
+            _state.store((int)State::COMPLETED, std::memory_order_release);
+            return false;
+        }
+        _underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (_stopping && _gain <= 0) {
+        _state.store((int)State::STOPPED, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
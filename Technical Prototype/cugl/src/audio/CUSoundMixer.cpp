@@ -0,0 +1,1323 @@
+//
+//  CUSoundMixer.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a singleton providing a low-latency software mixer for
+//  sound effects.  It is an alternative to the effect channels of AudioEngine.
+//  Instead of handing sounds to a platform mixer, it decodes every sound asset
+//  once into a PCM cache (resampled to the output rate) and mixes the active
+//  voices itself in an SDL audio callback.  That means that the output latency
+//  is determined by our (small) block size, and not the block size of the
+//  platform mixer.
+//
+//  Voices are drawn from a fixed pool, and are identified by integer handles
+//  instead of string keys.  When the pool is exhausted, the mixer steals the
+//  voice with the lowest priority.  The game thread never touches the voices
+//  directly.  It communicates with the audio thread through a lock-free
+//  command queue, so playing a sound never blocks or allocates.
+//
+//  The mixer also streams Ogg Vorbis music in the same callback.  Music is
+//  decoded on a background thread (see MusicStream), and up to two tracks are
+//  mixed at once so that crossfades truly overlap.
+//
+//  Because this is a singleton, there are no publicly accessible constructors
+//  or intializers.  Use the static methods instead.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <SDL/SDL_mixer.h>
+#include <cugl/audio/CUSoundMixer.h>
+#include <cugl/audio/CUAudioEngine.h>
+#include <cugl/util/CUDebug.h>
+#include "platform/CUAudioEngine-impl.h"
+#include <algorithm>
+#include <cmath>
+
+/** Starts a new voice */
+#define CMD_PLAY        0
+/** Stops a single voice */
+#define CMD_STOP        1
+/** Stops all voices playing a sample */
+#define CMD_STOP_SAMPLE 2
+/** Stops all voices */
+#define CMD_STOP_ALL    3
+/** Changes the volume of a voice */
+#define CMD_VOLUME      4
+/** Changes the pan of a voice */
+#define CMD_PAN         5
+/** Changes the master volume */
+#define CMD_MASTER      6
+/** Starts a music track, fading out the current one */
+#define CMD_MUSIC_PLAY  7
+/** Stops the current music track */
+#define CMD_MUSIC_STOP  8
+/** Changes the volume of the current music track */
+#define CMD_MUSIC_VOLUME 9
+
+/** The mask for the ring buffer positions */
+#define QUEUE_MASK      (MIXER_QUEUE_SIZE-1)
+
+namespace cugl {
+
+/** The singleton mixer */
+SoundMixer* SoundMixer::_gMixer = nullptr;
+
+#pragma mark -
+#pragma mark SDL Callbacks
+/**
+ * The SDL callback for our own audio device.
+ *
+ * We need the SDL callback as a regular C function as SDL does not play
+ * well with C++ closures.
+ *
+ * @param userdata  The mixer
+ * @param stream    The output buffer
+ * @param len       The length of stream in bytes
+ */
+void MixerDeviceCallback(void* userdata, Uint8* stream, int len) {
+    ((SoundMixer*)userdata)->fill(stream,len);
+}
+
+/**
+ * The SDL mixer callback when attached to the SDL mixer.
+ *
+ * We need the SDL callback as a regular C function as SDL does not play
+ * well with C++ closures.
+ *
+ * @param userdata  The mixer
+ * @param stream    The output buffer
+ * @param len       The length of stream in bytes
+ */
+void MixerPostMixCallback(void* userdata, Uint8* stream, int len) {
+    ((SoundMixer*)userdata)->fill(stream,len);
+}
+
+/**
+ * Returns the left and right gain for the given volume and pan
+ *
+ * @param volume    The voice volume
+ * @param pan       The voice pan in [-1,1]
+ * @param left      The left gain
+ * @param right     The right gain
+ */
+static void compute_gain(float volume, float pan, float& left, float& right) {
+    left  = volume*std::min(1.0f,1.0f-pan);
+    right = volume*std::min(1.0f,1.0f+pan);
+}
+
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates, but does not initialize the singleton mixer
+ *
+ * The mixer must be initialized before is can be used.
+ */
+SoundMixer::SoundMixer() :
+_device(0),
+_rate(0),
+_channels(AUDIO_OUTPUT_CHANNELS),
+_block(0),
+_format(0),
+_nextHandle(1),
+_serial(0),
+_master(1.0f),
+_running(false),
+_listener(nullptr),
+_musicCB(nullptr) {
+    _decks[0] = nullptr;
+    _decks[1] = nullptr;
+    _paused = false;
+    _processed = 0;
+    _period = 0;
+    _cmdHead  = 0;
+    _cmdTail  = 0;
+    _doneHead = 0;
+    _doneTail = 0;
+    _blocks = 0;
+    resetStats();
+}
+
+/**
+ * Initializes the mixer.
+ *
+ * This method opens an SDL audio device with the given block size.  If
+ * that fails, it attaches the mixer to the SDL mixer instead.
+ *
+ * @param voices    The number of voices in the pool
+ * @param block     The mixer block size in frames (a power of two)
+ *
+ * @return true if the mixer was successfully initialized.
+ */
+bool SoundMixer::init(Uint32 voices, Uint32 block) {
+    CUAssertLog(voices > 0, "The mixer must have at least one voice");
+    CUAssertLog(block > 0 && (block & (block-1)) == 0, "The block size %d is not a power of two", block);
+
+    Voice empty;
+    SDL_memset(&empty, 0, sizeof(Voice));
+    _voices.resize(voices, empty);
+    _handles.reset(new std::atomic<Uint32>[voices]);
+    for(Uint32 ii = 0; ii < voices; ii++) {
+        _handles[ii] = 0;
+    }
+
+    SDL_AudioSpec want, have;
+    SDL_zero(want);
+    want.freq = AUDIO_FREQUENCY;
+    want.format = AUDIO_F32SYS;
+    want.channels = AUDIO_OUTPUT_CHANNELS;
+    want.samples  = block;
+    want.callback = MixerDeviceCallback;
+    want.userdata = this;
+
+    _device = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (_device > 0) {
+        _rate   = have.freq;
+        _block  = have.samples;
+        _format = AUDIO_F32SYS;
+        SDL_PauseAudioDevice(_device, 0);
+        return true;
+    }
+    _device = 0;
+
+#if !defined(CU_AUDIO_AVFOUNDATION)
+    // Only one device allowed.  Piggyback on SDL mixer.
+    int freq = 0;
+    int chans = 0;
+    Uint16 fmt = 0;
+    if (Mix_QuerySpec(&freq, &fmt, &chans) && chans == AUDIO_OUTPUT_CHANNELS &&
+        (fmt == AUDIO_S16SYS || fmt == AUDIO_F32SYS)) {
+        CUWarn("Could not open mixer device (%s). Attaching to SDL mixer.", SDL_GetError());
+        _rate   = freq;
+        _block  = block;
+        _format = fmt;
+        _scratch.resize(block*_channels);
+        Mix_SetPostMix(MixerPostMixCallback, this);
+        return true;
+    }
+#endif
+    CULogError("Could not open mixer device: %s", SDL_GetError());
+    _voices.clear();
+    _handles = nullptr;
+    return false;
+}
+
+/**
+ * Releases all resources for this singleton mixer.
+ */
+void SoundMixer::dispose() {
+    if (_device) {
+        // This waits for the callback to finish
+        SDL_CloseAudioDevice(_device);
+        _device = 0;
+    } else if (_rate) {
+#if !defined(CU_AUDIO_AVFOUNDATION)
+        Mix_SetPostMix(NULL, NULL);
+#endif
+    }
+
+    if (_decoder.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = false;
+        }
+        _wakeup.notify_all();
+        _decoder.join();
+    }
+    _decks[0] = nullptr;
+    _decks[1] = nullptr;
+    _decoding.clear();
+    _tracks.clear();
+    _stale.clear();
+    _music = nullptr;
+    _musicCB = nullptr;
+
+    _rate = 0;
+    _voices.clear();
+    _handles = nullptr;
+    _samples.clear();
+    _retired.clear();
+    _orphaned.clear();
+    _scratch.clear();
+    _listener = nullptr;
+}
+
+/**
+ * Starts the singleton mixer.
+ *
+ * Once this method is called, the method get() will no longer return
+ * nullptr.  Calling the method multiple times (without calling stop) will
+ * have no effect.
+ *
+ * If you are also using {@link AudioEngine} for music, you should start
+ * it first.  On platforms that only support one audio device, the mixer
+ * will then attach itself to that engine.  In that case the latency is
+ * that of the engine block size, and not the mixer block size.  Start the
+ * engine with the same block size on those platforms (such as Android).
+ *
+ * @param voices    The number of voices in the pool
+ * @param block     The mixer block size in frames (a power of two)
+ *
+ * @return true if the mixer was successfully started.
+ */
+bool SoundMixer::start(Uint32 voices, Uint32 block) {
+    if (_gMixer != nullptr) {
+        return true;
+    }
+    _gMixer = new SoundMixer();
+    if (!_gMixer->init(voices,block)) {
+        delete _gMixer;
+        _gMixer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Stops the singleton mixer, releasing all resources.
+ *
+ * Once this method is called, the method get() will return nullptr.
+ * Calling the method multiple times (without calling stop) will have
+ * no effect.
+ */
+void SoundMixer::stop() {
+    if (_gMixer == nullptr) {
+        return;
+    }
+    delete _gMixer;
+    _gMixer = nullptr;
+}
+
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns the decoded sound for the given asset, decoding it if necessary
+ *
+ * @param sound The sound asset
+ *
+ * @return the decoded sound for the given asset
+ */
+const SoundMixer::Sample* SoundMixer::acquire(const std::shared_ptr<Sound>& sound) {
+    auto it = _samples.find(sound.get());
+    if (it != _samples.end()) {
+        if (it->second->source.lock() == sound) {
+            return it->second.get();
+        }
+        // The address was reused by a new asset
+        Command cmd;
+        SDL_memset(&cmd, 0, sizeof(Command));
+        cmd.type = CMD_STOP_SAMPLE;
+        cmd.sample = it->second.get();
+        if (push(cmd)) {
+            _retired.push_back(std::make_pair(it->second,_blocks.load(std::memory_order_acquire)));
+        } else {
+            // Voices may still play it, so keep it until the stop is queued
+            CUWarn("Mixer command queue is full; a replaced sound is still playing");
+            _orphaned.push_back(it->second);
+        }
+        _samples.erase(it);
+    }
+
+    impl::AudioBuffer* buffer = sound->_buffer;
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    Uint64 frames = impl::AudioGetBufferFrames(buffer);
+    Uint32 chans  = impl::AudioGetBufferChannels(buffer);
+    double rate   = impl::AudioGetBufferSampleRate(buffer);
+    if (frames == 0 || chans == 0 || rate <= 0) {
+        CULogError("Sound '%s' has no audio data",sound->getSource().c_str());
+        return nullptr;
+    }
+
+    std::vector<float> pcm(frames*chans);
+    if (!impl::AudioGetBufferPCM(buffer, pcm.data())) {
+        CULogError("Sound '%s' has an unsupported PCM format",sound->getSource().c_str());
+        return nullptr;
+    }
+
+    std::shared_ptr<Sample> sample = std::make_shared<Sample>();
+    sample->source = sound;
+    sample->channels = (chans == 1 ? 1 : 2);
+
+    if (rate == _rate && chans <= 2) {
+        sample->frames = (Uint32)frames;
+        sample->data.swap(pcm);
+    } else {
+        // Linear interpolation is enough for effects at nearby rates.
+        // Extra channels (e.g. 5.1) are reduced to the front pair.
+        double step = rate/_rate;
+        Uint64 total = (Uint64)((frames-1)/step)+1;
+        sample->frames = (Uint32)total;
+        sample->data.resize(total*sample->channels);
+        for(Uint64 ii = 0; ii < total; ii++) {
+            double pos = ii*step;
+            Uint64 a = std::min((Uint64)pos,frames-1);
+            Uint64 b = std::min(a+1,frames-1);
+            float t = (float)(pos-a);
+            for(Uint32 ch = 0; ch < sample->channels; ch++) {
+                float s0 = pcm[a*chans+ch];
+                float s1 = pcm[b*chans+ch];
+                sample->data[ii*sample->channels+ch] = s0+(s1-s0)*t;
+            }
+        }
+    }
+
+    _samples[sound.get()] = sample;
+    return sample.get();
+}
+
+/**
+ * Pushes a command onto the command queue.
+ *
+ * @param cmd   The command to push
+ *
+ * @return false if the queue was full
+ */
+bool SoundMixer::push(const Command& cmd) {
+    Uint32 tail = _cmdTail.load(std::memory_order_relaxed);
+    Uint32 head = _cmdHead.load(std::memory_order_acquire);
+    if (tail-head >= MIXER_QUEUE_SIZE) {
+        return false;
+    }
+    _commands[tail & QUEUE_MASK] = cmd;
+    _cmdTail.store(tail+1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Notifies the main thread that the given voice has finished.
+ *
+ * This method is called in the audio thread.
+ *
+ * @param voice     The voice that finished
+ * @param status    True if the sound terminated normally, false otherwise.
+ */
+void SoundMixer::complete(Voice& voice, bool status) {
+    _handles[&voice-_voices.data()].store(0, std::memory_order_release);
+    voice.sample = nullptr;
+
+    Uint32 tail = _doneTail.load(std::memory_order_relaxed);
+    Uint32 head = _doneHead.load(std::memory_order_acquire);
+    if (tail-head < MIXER_QUEUE_SIZE) {
+        _completions[tail & QUEUE_MASK].handle = voice.handle;
+        _completions[tail & QUEUE_MASK].status = status;
+        _doneTail.store(tail+1, std::memory_order_release);
+    }
+}
+
+/**
+ * Processes a single command in the audio thread.
+ *
+ * @param cmd   The command to process
+ * @param now   The performance counter value at the start of this block
+ */
+void SoundMixer::process(const Command& cmd, Uint64 now) {
+    switch (cmd.type) {
+        case CMD_PLAY:
+        {
+            _delayTicks.fetch_add(now > cmd.stamp ? now-cmd.stamp : 0, std::memory_order_relaxed);
+            _delayCount.fetch_add(1, std::memory_order_relaxed);
+
+            // Look for a free voice, or the cheapest one to steal
+            Voice* target = nullptr;
+            for(auto it = _voices.begin(); target == nullptr && it != _voices.end(); ++it) {
+                if (it->sample == nullptr) {
+                    target = &(*it);
+                }
+            }
+            if (target == nullptr) {
+                Voice* victim = nullptr;
+                for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                    if (victim == nullptr || (it->stopping && !victim->stopping)) {
+                        victim = &(*it);
+                    } else if (it->stopping == victim->stopping &&
+                               (it->priority < victim->priority ||
+                                (it->priority == victim->priority && it->serial < victim->serial))) {
+                        victim = &(*it);
+                    }
+                }
+                if (!victim->stopping && victim->priority > cmd.priority) {
+                    // Everything is more important
+                    _drops.fetch_add(1, std::memory_order_relaxed);
+                    _processed.store(cmd.handle, std::memory_order_release);
+                    Uint32 tail = _doneTail.load(std::memory_order_relaxed);
+                    Uint32 head = _doneHead.load(std::memory_order_acquire);
+                    if (tail-head < MIXER_QUEUE_SIZE) {
+                        _completions[tail & QUEUE_MASK].handle = cmd.handle;
+                        _completions[tail & QUEUE_MASK].status = false;
+                        _doneTail.store(tail+1, std::memory_order_release);
+                    }
+                    break;
+                }
+                _steals.fetch_add(1, std::memory_order_relaxed);
+                complete(*victim,false);
+                target = victim;
+            }
+
+            target->sample = cmd.sample;
+            target->handle = cmd.handle;
+            target->position = 0;
+            target->priority = cmd.priority;
+            target->serial = _serial++;
+            target->volume = cmd.volume;
+            target->pan  = cmd.pan;
+            target->loop = cmd.loop;
+            target->stopping = false;
+            compute_gain(cmd.volume, cmd.pan, target->gainL, target->gainR);
+            _handles[target-_voices.data()].store(cmd.handle, std::memory_order_release);
+            _processed.store(cmd.handle, std::memory_order_release);
+        }
+            break;
+        case CMD_STOP:
+            for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                if (it->sample != nullptr && it->handle == cmd.handle) {
+                    it->stopping = true;
+                }
+            }
+            break;
+        case CMD_STOP_SAMPLE:
+            for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                if (it->sample == cmd.sample) {
+                    it->stopping = true;
+                }
+            }
+            break;
+        case CMD_STOP_ALL:
+            for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                it->stopping = true;
+            }
+            break;
+        case CMD_VOLUME:
+            for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                if (it->sample != nullptr && it->handle == cmd.handle) {
+                    it->volume = cmd.volume;
+                }
+            }
+            break;
+        case CMD_PAN:
+            for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+                if (it->sample != nullptr && it->handle == cmd.handle) {
+                    it->pan = cmd.pan;
+                }
+            }
+            break;
+        case CMD_MASTER:
+            _master = cmd.volume;
+            break;
+        case CMD_MUSIC_PLAY:
+            // Only two tracks at a time; the oldest one is dropped
+            if (_decks[1]) {
+                _decks[1]->halt();
+            }
+            _decks[1] = _decks[0];
+            if (_decks[1]) {
+                if (cmd.fade == 0) {
+                    _decks[1]->halt();
+                    _decks[1] = nullptr;
+                } else if (!_decks[1]->isStopping()) {
+                    _decks[1]->fade(0, cmd.fade, true);
+                }
+            }
+            _decks[0] = cmd.stream;
+            if (cmd.fade == 0) {
+                _decks[0]->setGain(cmd.volume);
+            } else {
+                _decks[0]->setGain(0);
+                _decks[0]->fade(cmd.volume, cmd.fade, false);
+            }
+            break;
+        case CMD_MUSIC_STOP:
+            if (_decks[0]) {
+                if (cmd.fade == 0) {
+                    _decks[0]->halt();
+                    _decks[0] = nullptr;
+                } else {
+                    _decks[0]->fade(0, cmd.fade, true);
+                }
+            }
+            break;
+        case CMD_MUSIC_VOLUME:
+            if (_decks[0] && !_decks[0]->isStopping()) {
+                _decks[0]->fade(cmd.volume, _block, false);
+            }
+            break;
+    }
+}
+
+/**
+ * Mixes the next block of audio into the given buffer.
+ *
+ * The buffer is overwritten with the output.  This method is called in the
+ * audio thread.
+ *
+ * @param output    The interleaved output buffer
+ * @param frames    The number of frames to mix
+ */
+void SoundMixer::mix(float* output, Uint32 frames) {
+    SDL_memset(output, 0, frames*_channels*sizeof(float));
+
+    Uint32 active = 0;
+    for(auto it = _voices.begin(); it != _voices.end(); ++it) {
+        Voice& voice = *it;
+        const Sample* sample = voice.sample;
+        if (sample == nullptr) {
+            continue;
+        }
+
+        // Ramp the gain across the block to prevent clicks
+        float goalL = 0;
+        float goalR = 0;
+        if (!voice.stopping) {
+            compute_gain(voice.volume, voice.pan, goalL, goalR);
+        }
+        float gainL = voice.gainL;
+        float gainR = voice.gainR;
+        float stepL = (goalL-gainL)/frames;
+        float stepR = (goalR-gainR)/frames;
+
+        const float* src = sample->data.data();
+        float* dst = output;
+        Uint32 pos = voice.position;
+        Uint32 left = frames;
+        bool done = false;
+        while (left > 0) {
+            Uint32 amt = std::min(left,sample->frames-pos);
+            if (sample->channels == 1) {
+                const float* in = src+pos;
+                for(Uint32 ii = 0; ii < amt; ii++) {
+                    dst[2*ii  ] += in[ii]*gainL;
+                    dst[2*ii+1] += in[ii]*gainR;
+                    gainL += stepL;
+                    gainR += stepR;
+                }
+            } else {
+                const float* in = src+2*pos;
+                for(Uint32 ii = 0; ii < amt; ii++) {
+                    dst[2*ii  ] += in[2*ii  ]*gainL;
+                    dst[2*ii+1] += in[2*ii+1]*gainR;
+                    gainL += stepL;
+                    gainR += stepR;
+                }
+            }
+            dst  += 2*amt;
+            left -= amt;
+            pos  += amt;
+            if (pos >= sample->frames) {
+                if (voice.loop && !voice.stopping) {
+                    pos = 0;
+                } else {
+                    done = true;
+                    break;
+                }
+            }
+        }
+
+        voice.position = pos;
+        voice.gainL = goalL;
+        voice.gainR = goalR;
+        if (done || voice.stopping) {
+            complete(voice,!voice.stopping);
+        } else {
+            active++;
+        }
+    }
+
+    for(int ii = 0; ii < 2; ii++) {
+        if (_decks[ii] && !_decks[ii]->mix(output, frames)) {
+            _decks[ii] = nullptr;
+        }
+    }
+
+    float master = _master;
+    Uint32 total = frames*_channels;
+    for(Uint32 ii = 0; ii < total; ii++) {
+        float value = output[ii]*master;
+        output[ii] = (value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value));
+    }
+    _active.store(active, std::memory_order_relaxed);
+}
+
+/**
+ * Fills an audio buffer for the audio device.
+ *
+ * This method is called in the audio thread, and processes any pending
+ * commands before mixing.
+ *
+ * @param stream    The output buffer
+ * @param len       The length of stream in bytes
+ */
+void SoundMixer::fill(Uint8* stream, int len) {
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    Uint32 head = _cmdHead.load(std::memory_order_relaxed);
+    Uint32 tail = _cmdTail.load(std::memory_order_acquire);
+    while (head != tail) {
+        process(_commands[head & QUEUE_MASK], start);
+        head++;
+    }
+    _cmdHead.store(head, std::memory_order_release);
+
+    Uint32 bytes  = (_format == AUDIO_F32SYS ? sizeof(float) : sizeof(Sint16))*_channels;
+    Uint32 frames = (Uint32)len/bytes;
+    _period.store(frames, std::memory_order_relaxed);
+
+    if (_paused.load(std::memory_order_relaxed)) {
+        if (_device) {
+            SDL_memset(stream, 0, len);
+        }
+    } else if (_device) {
+        mix((float*)stream, frames);
+    } else {
+        // Attached to SDL mixer: add to the stream in chunks
+        Uint32 offset = 0;
+        while (offset < frames) {
+            Uint32 amt = std::min(frames-offset,_block);
+            float* buffer = _scratch.data();
+            mix(buffer, amt);
+            Uint32 total = amt*_channels;
+            if (_format == AUDIO_F32SYS) {
+                float* out = ((float*)stream)+offset*_channels;
+                for(Uint32 ii = 0; ii < total; ii++) {
+                    float value = out[ii]+buffer[ii];
+                    out[ii] = (value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value));
+                }
+            } else {
+                Sint16* out = ((Sint16*)stream)+offset*_channels;
+                for(Uint32 ii = 0; ii < total; ii++) {
+                    Sint32 value = out[ii]+(Sint32)(buffer[ii]*32767.0f);
+                    out[ii] = (Sint16)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+                }
+            }
+            offset += amt;
+        }
+    }
+
+    Uint64 ticks = SDL_GetPerformanceCounter()-start;
+    _mixTicks.fetch_add(ticks, std::memory_order_relaxed);
+    Uint64 peak = _peakTicks.load(std::memory_order_relaxed);
+    while (ticks > peak && !_peakTicks.compare_exchange_weak(peak, ticks, std::memory_order_relaxed)) {}
+    _mixCount.fetch_add(1, std::memory_order_relaxed);
+    _blocks.fetch_add(1, std::memory_order_release);
+}
+
+
+#pragma mark -
+#pragma mark Sound Management
+/**
+ * Decodes the given sound asset into the PCM cache.
+ *
+ * The sound is converted to floating point samples at the output rate, so
+ * this can take some time for long sounds.  Sounds that are not prepared
+ * will be decoded the first time that they are played.  Hence you should
+ * prepare all of your sound effects once they are loaded.
+ *
+ * @param sound The sound asset
+ *
+ * @return true if the sound was successfully decoded.
+ */
+bool SoundMixer::prepare(const std::shared_ptr<Sound>& sound) {
+    CUAssertLog(sound, "Attempt to prepare a null sound");
+    return acquire(sound) != nullptr;
+}
+
+/**
+ * Removes the given sound asset from the PCM cache.
+ *
+ * Any voices playing this sound are stopped.  The memory is released
+ * once the audio thread is guaranteed to no longer reference it.
+ *
+ * @param sound The sound asset
+ */
+void SoundMixer::release(const std::shared_ptr<Sound>& sound) {
+    if (sound == nullptr) {
+        return;
+    }
+    auto it = _samples.find(sound.get());
+    if (it == _samples.end()) {
+        return;
+    }
+
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_STOP_SAMPLE;
+    cmd.sample = it->second.get();
+    if (!push(cmd)) {
+        CUWarn("Mixer command queue is full; sound '%s' was not released",sound->getSource().c_str());
+        return;
+    }
+    _retired.push_back(std::make_pair(it->second,_blocks.load(std::memory_order_acquire)));
+    _samples.erase(it);
+}
+
+/**
+ * Plays the given sound, returning its voice handle.
+ *
+ * This method never blocks on the audio thread.  The sound will start at
+ * the beginning of the next mixer block.  If the sound is not in the PCM
+ * cache, it is decoded first (see {@link prepare}).
+ *
+ * The priority is used when the voice pool is exhausted.  The voice with
+ * the lowest priority is stolen, provided that its priority is no more
+ * than the priority of this sound.  Otherwise this sound is dropped.
+ *
+ * @param sound     The sound asset to play
+ * @param priority  The voice priority
+ * @param loop      Whether to loop the sound continuously
+ * @param volume    The voice volume (< 0 to use asset default volume)
+ * @param pan       The stereo pan in [-1,1] (-1 is full left)
+ *
+ * @return the voice handle (0 if the sound could not be played)
+ */
+Uint32 SoundMixer::play(const std::shared_ptr<Sound>& sound, Sint32 priority, bool loop,
+                        float volume, float pan) {
+    CUAssertLog(sound, "Attempt to play a null sound");
+    const Sample* sample = acquire(sound);
+    if (sample == nullptr) {
+        return 0;
+    }
+
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_PLAY;
+    cmd.handle = _nextHandle++;
+    if (_nextHandle == 0) {
+        _nextHandle = 1;
+    }
+    cmd.sample = sample;
+    cmd.volume = (volume >= 0 ? volume : sound->getVolume());
+    cmd.pan = std::max(-1.0f,std::min(1.0f,pan));
+    cmd.priority = priority;
+    cmd.loop  = loop;
+    cmd.stamp = SDL_GetPerformanceCounter();
+    if (!push(cmd)) {
+        CUWarn("Mixer command queue is full");
+        _drops.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    return cmd.handle;
+}
+
+/**
+ * Returns true if the given voice is still playing.
+ *
+ * A voice that was just started, but not yet picked up by the audio
+ * thread, is considered to be playing.
+ *
+ * @param handle    The voice handle
+ *
+ * @return true if the given voice is still playing.
+ */
+bool SoundMixer::isPlaying(Uint32 handle) const {
+    if (handle == 0) {
+        return false;
+    }
+    Uint32 done = _processed.load(std::memory_order_acquire);
+    if ((Sint32)(handle-done) > 0) {
+        return true;
+    }
+    for(size_t ii = 0; ii < _voices.size(); ii++) {
+        if (_handles[ii].load(std::memory_order_acquire) == handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Stops the given voice.
+ *
+ * The voice fades out over a single block to prevent clicks.  This
+ * method has no effect if the voice has already finished.
+ *
+ * @param handle    The voice handle
+ */
+void SoundMixer::stopVoice(Uint32 handle) {
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_STOP;
+    cmd.handle = handle;
+    push(cmd);
+}
+
+/**
+ * Stops every voice playing the given sound.
+ *
+ * @param sound The sound asset
+ */
+void SoundMixer::stopSound(const std::shared_ptr<Sound>& sound) {
+    auto it = _samples.find(sound.get());
+    if (it == _samples.end()) {
+        return;
+    }
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_STOP_SAMPLE;
+    cmd.sample = it->second.get();
+    push(cmd);
+}
+
+/**
+ * Stops every voice in the pool.
+ */
+void SoundMixer::stopAll() {
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_STOP_ALL;
+    push(cmd);
+}
+
+/**
+ * Sets the volume of the given voice.
+ *
+ * The change is applied smoothly over the next block.
+ *
+ * @param handle    The voice handle
+ * @param volume    The voice volume in [0,1]
+ */
+void SoundMixer::setVolume(Uint32 handle, float volume) {
+    CUAssertLog(0 <= volume && volume <= 1, "The volume %.3f is out of range",volume);
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_VOLUME;
+    cmd.handle = handle;
+    cmd.volume = volume;
+    push(cmd);
+}
+
+/**
+ * Sets the stereo pan of the given voice.
+ *
+ * The change is applied smoothly over the next block.
+ *
+ * @param handle    The voice handle
+ * @param pan       The stereo pan in [-1,1] (-1 is full left)
+ */
+void SoundMixer::setPan(Uint32 handle, float pan) {
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_PAN;
+    cmd.handle = handle;
+    cmd.pan = std::max(-1.0f,std::min(1.0f,pan));
+    push(cmd);
+}
+
+/**
+ * Sets the master volume of the mixer.
+ *
+ * @param volume    The master volume in [0,1]
+ */
+void SoundMixer::setMasterVolume(float volume) {
+    CUAssertLog(0 <= volume && volume <= 1, "The volume %.3f is out of range",volume);
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_MASTER;
+    cmd.volume = volume;
+    push(cmd);
+}
+
+/**
+ * Pauses the mixer.
+ *
+ * All voices remain in place, and will continue when the mixer is resumed.
+ * You should call this method when the application is suspended.
+ */
+void SoundMixer::pause() {
+    _paused.store(true);
+    if (_device) {
+        SDL_PauseAudioDevice(_device, 1);
+    }
+}
+
+/**
+ * Resumes the mixer after a call to {@link pause}.
+ */
+void SoundMixer::resume() {
+    _paused.store(false);
+    if (_device) {
+        SDL_PauseAudioDevice(_device, 0);
+    }
+}
+
+/**
+ * Processes the notifications from the audio thread.
+ *
+ * This method calls the listener for every voice that has finished since
+ * the last call, as well as the music listener for finished tracks.  It
+ * also frees any PCM data released by {@link release}, and stops any
+ * replaced sounds whose stop command did not fit in the queue.  It should
+ * be called once an animation frame.
+ */
+void SoundMixer::update() {
+    Uint32 head = _doneHead.load(std::memory_order_relaxed);
+    Uint32 tail = _doneTail.load(std::memory_order_acquire);
+    while (head != tail) {
+        Completion done = _completions[head & QUEUE_MASK];
+        head++;
+        _doneHead.store(head, std::memory_order_release);
+        if (_listener) {
+            _listener(done.handle,done.status);
+        }
+    }
+
+    Uint64 blocks = _blocks.load(std::memory_order_acquire);
+    for(auto it = _tracks.begin(); it != _tracks.end(); ) {
+        MusicStream::State state = it->stream->getState();
+        if (state == MusicStream::State::PLAYING) {
+            ++it;
+            continue;
+        }
+
+        Track track = *it;
+        it = _tracks.erase(it);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _decoding.erase(std::remove(_decoding.begin(), _decoding.end(), track.stream), _decoding.end());
+        }
+        _stale.push_back(std::make_pair(track.stream,blocks));
+        if (_music == track.stream) {
+            _music = nullptr;
+        }
+        if (_musicCB) {
+            _musicCB(track.asset.get(),state == MusicStream::State::COMPLETED);
+        }
+    }
+
+    // Retry the stop commands that did not fit in the queue
+    for(auto it = _orphaned.begin(); it != _orphaned.end(); ) {
+        Command cmd;
+        SDL_memset(&cmd, 0, sizeof(Command));
+        cmd.type = CMD_STOP_SAMPLE;
+        cmd.sample = it->get();
+        if (!push(cmd)) {
+            break;
+        }
+        _retired.push_back(std::make_pair(*it,_blocks.load(std::memory_order_acquire)));
+        it = _orphaned.erase(it);
+    }
+
+    // The audio thread lets go of a sample two blocks after the stop command
+    if (!_retired.empty()) {
+        _retired.erase(std::remove_if(_retired.begin(), _retired.end(),
+                                      [=](const std::pair<std::shared_ptr<Sample>,Uint64>& entry) {
+                                          return blocks > entry.second+2;
+                                      }), _retired.end());
+    }
+    if (!_stale.empty()) {
+        _stale.erase(std::remove_if(_stale.begin(), _stale.end(),
+                                    [=](const std::pair<std::shared_ptr<MusicStream>,Uint64>& entry) {
+                                        return blocks > entry.second+2;
+                                    }), _stale.end());
+    }
+}
+
+
+#pragma mark -
+#pragma mark Music Management
+/**
+ * Runs the music decoder thread.
+ *
+ * The thread tops up the ring buffers of every stream, and then sleeps
+ * until woken up or until {@link MIXER_DECODE_PERIOD} has passed.
+ */
+void SoundMixer::decodeLoop() {
+    std::vector<std::shared_ptr<MusicStream>> streams;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        streams = _decoding;
+        lock.unlock();
+        for(auto it = streams.begin(); it != streams.end(); ++it) {
+            (*it)->decode();
+        }
+        streams.clear();
+        lock.lock();
+        if (_running) {
+            _wakeup.wait_for(lock, std::chrono::milliseconds(MIXER_DECODE_PERIOD));
+        }
+    }
+}
+
+/**
+ * Plays the given music asset, crossfading from the current track.
+ *
+ * The music asset must be an Ogg Vorbis file.  It is decoded incrementally
+ * on a background thread, so memory use does not depend on the length of
+ * the track.  Only the first few thousand frames are decoded before this
+ * method returns.
+ *
+ * If fade is positive, the new track fades in over that many seconds
+ * while the current track (if any) fades out over the same period.  Both
+ * tracks are mixed during the fade.  If a previous crossfade is still in
+ * progress, the oldest track is dropped.
+ *
+ * Music is only supported on builds that define CU_MUSIC_STREAM (see
+ * {@link MusicStream}).  On other builds this method always fails.
+ *
+ * @param music     The music asset to play
+ * @param loop      Whether to loop the music continuously (gapless)
+ * @param volume    The music volume (< 0 to use asset default volume)
+ * @param fade      The number of seconds to crossfade
+ *
+ * @return true if the music started successfully
+ */
+bool SoundMixer::playMusic(const std::shared_ptr<Music>& music, bool loop, float volume, float fade) {
+    CUAssertLog(music, "Attempt to play a null music asset");
+    std::shared_ptr<MusicStream> stream = MusicStream::alloc(music->getSource(), _rate);
+    if (stream == nullptr) {
+        return false;
+    }
+    stream->setLoop(loop);
+    stream->decode(MUSIC_PREFILL_FRAMES);
+
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_MUSIC_PLAY;
+    cmd.stream = stream.get();
+    cmd.volume = (volume >= 0 ? volume : music->getVolume());
+    cmd.fade = (Uint32)(std::max(0.0f,fade)*_rate);
+    if (!push(cmd)) {
+        CUWarn("Mixer command queue is full");
+        return false;
+    }
+
+    Track track;
+    track.stream = stream;
+    track.asset  = music;
+    _tracks.push_back(track);
+    _music = stream;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _decoding.push_back(stream);
+        if (!_running) {
+            if (_decoder.joinable()) {
+                _decoder.join();
+            }
+            _running = true;
+            _decoder = std::thread(&SoundMixer::decodeLoop, this);
+        }
+    }
+    _wakeup.notify_one();
+    return true;
+}
+
+/**
+ * Returns the music asset currently playing
+ *
+ * If there is no active background music, this method returns nullptr.
+ * A track that is fading out is not considered active.
+ *
+ * @return the music asset currently playing
+ */
+const Music* SoundMixer::currentMusic() const {
+    for(auto it = _tracks.begin(); it != _tracks.end(); ++it) {
+        if (it->stream == _music) {
+            return it->asset.get();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns true if there is active background music.
+ *
+ * @return true if there is active background music.
+ */
+bool SoundMixer::isMusicPlaying() const {
+    return _music != nullptr && _music->getState() == MusicStream::State::PLAYING;
+}
+
+/**
+ * Stops the current background music.
+ *
+ * If the argument is 0, it will halt the music immediately. Otherwise it
+ * will fade out over the given number of seconds.
+ *
+ * @param fade  The number of seconds to fade out
+ */
+void SoundMixer::stopMusic(float fade) {
+    if (_music == nullptr) {
+        return;
+    }
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_MUSIC_STOP;
+    cmd.fade = (Uint32)(std::max(0.0f,fade)*_rate);
+    if (push(cmd)) {
+        _music = nullptr;
+    }
+}
+
+/**
+ * Returns true if the background music is in a continuous loop.
+ *
+ * @return true if the background music is in a continuous loop.
+ */
+bool SoundMixer::isMusicLoop() const {
+    return _music != nullptr && _music->isLoop();
+}
+
+/**
+ * Sets whether the background music is on a continuous loop.
+ *
+ * @param loop  Whether the background music is on a continuous loop
+ */
+void SoundMixer::setMusicLoop(bool loop) {
+    if (_music) {
+        _music->setLoop(loop);
+    }
+}
+
+/**
+ * Sets the volume of the background music
+ *
+ * The change is applied smoothly over the next block.
+ *
+ * @param volume    The volume of the background music
+ */
+void SoundMixer::setMusicVolume(float volume) {
+    CUAssertLog(0 <= volume && volume <= 1, "The volume %.3f is out of range",volume);
+    Command cmd;
+    SDL_memset(&cmd, 0, sizeof(Command));
+    cmd.type = CMD_MUSIC_VOLUME;
+    cmd.volume = volume;
+    push(cmd);
+}
+
+/**
+ * Returns the length of background music, in seconds.
+ *
+ * If there is no active background music, this method will return 0.
+ *
+ * @return the length of background music, in seconds.
+ */
+double SoundMixer::getMusicDuration() const {
+    return _music ? _music->getDuration() : 0.0;
+}
+
+/**
+ * Returns the elapsed time of the background music, in seconds
+ *
+ * This is accurate to the last block handed to the audio device.  If there
+ * is no active background music, this method will return 0.
+ *
+ * @return the elapsed time of the background music, in seconds
+ */
+double SoundMixer::getMusicElapsed() const {
+    return _music ? _music->getElapsed() : 0.0;
+}
+
+/**
+ * Sets the elapsed time of the background music, in seconds
+ *
+ * The seek is performed by the decoder thread, so it will take effect
+ * within a few milliseconds.
+ *
+ * @param time  The new position of the background music
+ */
+void SoundMixer::setMusicElapsed(double time) {
+    if (_music) {
+        _music->seek(time);
+        _wakeup.notify_one();
+    }
+}
+
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Returns the output latency of the mixer in seconds.
+ *
+ * This is the duration of a single mixer block, which is the longest that
+ * a sound can wait before it is mixed.  The audio driver may add latency
+ * on top of this.
+ *
+ * @return the output latency of the mixer in seconds.
+ */
+double SoundMixer::getLatency() const {
+    if (_rate == 0) {
+        return 0;
+    }
+    Uint32 period = _period.load(std::memory_order_relaxed);
+    return (double)(period ? period : _block)/_rate;
+}
+
+/**
+ * Returns the average time to mix a single block, in seconds.
+ *
+ * This is the CPU cost of the audio callback, including command processing.
+ *
+ * @return the average time to mix a single block, in seconds.
+ */
+double SoundMixer::getMixCost() const {
+    Uint64 count = _mixCount.load(std::memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+    double ticks = (double)_mixTicks.load(std::memory_order_relaxed);
+    return ticks/(count*(double)SDL_GetPerformanceFrequency());
+}
+
+/**
+ * Returns the longest time to mix a single block, in seconds.
+ *
+ * @return the longest time to mix a single block, in seconds.
+ */
+double SoundMixer::getPeakMixCost() const {
+    double ticks = (double)_peakTicks.load(std::memory_order_relaxed);
+    return ticks/SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Returns the average delay between a call to play and the audio thread.
+ *
+ * This is the time that a sound waits in the command queue before it
+ * is mixed.  The time to sound is this delay plus the output latency.
+ *
+ * @return the average delay between a call to play and the audio thread.
+ */
+double SoundMixer::getDispatchDelay() const {
+    Uint64 count = _delayCount.load(std::memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+    double ticks = (double)_delayTicks.load(std::memory_order_relaxed);
+    return ticks/(count*(double)SDL_GetPerformanceFrequency());
+}
+
+/**
+ * Resets the mixer statistics.
+ */
+void SoundMixer::resetStats() {
+    _mixCount   = 0;
+    _mixTicks   = 0;
+    _peakTicks  = 0;
+    _delayTicks = 0;
+    _delayCount = 0;
+    _steals = 0;
+    _drops  = 0;
+    _active = 0;
+}
+
+}
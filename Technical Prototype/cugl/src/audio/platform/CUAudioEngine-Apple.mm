@@ -278,11 +278,16 @@ void InternalClearBackground() {
  * only cross-platforms options are 1 (Mono) and 2 (Stereo). Cross-platform
  * 5.1 or 7.1 sound is not supported.
  *
+ * The block size is the size of the device buffer.  Smaller blocks have
+ * less lag, but more CPU load.  AVFoundation manages its own buffers,
+ * so this implementation ignores it.
+ *
  * @param frequency The default sampling frequency
  * @param input     The number of sound effect channels
  * @param output    The number of output channels
+ * @param block     The device block size in frames
  */
-bool AudioStart(int frequency, int input, int output) {
+bool AudioStart(int frequency, int input, int output, int block) {
     CUAssertLog(!_engine, "Audio engine has already been started");
     _engine = new AudioMixer();
     _engine->mixer = [[AVAudioEngine alloc] init];
@@ -507,6 +512,49 @@ double AudioGetBufferSampleRate(AudioBuffer* source) {
     return source->pcmb.format.sampleRate;
 }
 
+/**
+ * Copies the PCM data of the given buffer as interleaved floats
+ *
+ * The samples are normalized to the range [-1,1].  The output array must
+ * have room for frames*channels values, as reported by the functions
+ * {@link AudioGetBufferFrames} and {@link AudioGetBufferChannels}.
+ *
+ * @param source    The PCM buffer
+ * @param output    The array to store the samples
+ *
+ * @return the number of audio frames copied (0 if the format is unknown)
+ */
+Uint64 AudioGetBufferPCM(AudioBuffer* source, float* output) {
+    AVAudioPCMBuffer* pcmb = source->pcmb;
+    AVAudioFrameCount frames = pcmb.frameLength;
+    AVAudioChannelCount chans = pcmb.format.channelCount;
+    NSUInteger stride = pcmb.stride;
+    bool interleaved = pcmb.format.interleaved;
+    
+    for(AVAudioChannelCount ch = 0; ch < chans; ch++) {
+        for(AVAudioFrameCount ii = 0; ii < frames; ii++) {
+            NSUInteger pos = interleaved ? ii*stride+ch : ii*stride;
+            NSUInteger buf = interleaved ? 0 : ch;
+            float value;
+            switch (pcmb.format.commonFormat) {
+                case AVAudioPCMFormatFloat32:
+                    value = pcmb.floatChannelData[buf][pos];
+                    break;
+                case AVAudioPCMFormatInt16:
+                    value = pcmb.int16ChannelData[buf][pos]/32768.0f;
+                    break;
+                case AVAudioPCMFormatInt32:
+                    value = pcmb.int32ChannelData[buf][pos]/2147483648.0f;
+                    break;
+                default:
+                    return 0;
+            }
+            output[ii*chans+ch] = value;
+        }
+    }
+    return frames;
+}
+
 #pragma mark -
 #pragma mark Music Assets
 /**
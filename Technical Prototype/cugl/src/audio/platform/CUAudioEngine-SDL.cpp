@@ -35,13 +35,10 @@
 #include <cugl/audio/CUMusic.h>
 #include <cugl/audio/CUAudioEngine.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <SDL/SDL_mixer.h>
 #include <vector>
 
-/** The mixer block size */
-// SMALLER = LESS LAG, BUT MORE CPU LOAD
-#define MIX_BLOCK_SIZE  1024
-
 namespace cugl {
 namespace impl {
     
@@ -183,13 +180,17 @@ void InternalMusicFinished() {
  * only cross-platforms options are 1 (Mono) and 2 (Stereo). Cross-platform
  * 5.1 or 7.1 sound is not supported.
  *
+ * The block size is the size of the device buffer.  Smaller blocks have
+ * less lag, but more CPU load.
+ *
  * @param frequency The default sampling frequency
  * @param input     The number of sound effect channels
  * @param output    The number of output channels
+ * @param block     The device block size in frames
  */
-bool AudioStart(int frequency, int input, int output) {
+bool AudioStart(int frequency, int input, int output, int block) {
     CUAssertLog(!_engine, "Audio engine has already been started");
-    if (Mix_OpenAudio(frequency, MIX_DEFAULT_FORMAT, output, MIX_BLOCK_SIZE) == -1) {
+    if (Mix_OpenAudio(frequency, MIX_DEFAULT_FORMAT, output, block) == -1) {
         return false;
     }
     _engine = new AudioMixer();
@@ -241,7 +242,7 @@ void AudioStop() {
  * @return an in-memory PCM buffer for the given audio asset
  */
 AudioBuffer* AudioLoadBuffer(const char* file) {
-    Mix_Chunk* data = Mix_LoadWAV(file);
+    Mix_Chunk* data = Mix_LoadWAV_RW(AssetArchive::openFile(file,"rb"),1);
     if (!data) {
         return nullptr;
     }
@@ -318,6 +319,51 @@ double AudioGetBufferSampleRate(AudioBuffer* source) {
     return source->bitrate;
 }
 
+/**
+ * Copies the PCM data of the given buffer as interleaved floats
+ *
+ * The samples are normalized to the range [-1,1].  The output array must
+ * have room for frames*channels values, as reported by the functions
+ * {@link AudioGetBufferFrames} and {@link AudioGetBufferChannels}.
+ *
+ * @param source    The PCM buffer
+ * @param output    The array to store the samples
+ *
+ * @return the number of audio frames copied (0 if the format is unknown)
+ */
+Uint64 AudioGetBufferPCM(AudioBuffer* source, float* output) {
+    Uint16 fmt = source->format;
+    Uint32 bytes = SDL_AUDIO_BITSIZE(fmt)/8;
+    if (bytes != 1 && bytes != 2 && bytes != 4) {
+        return 0;
+    }
+    
+    Uint64 total = source->frames*source->channels;
+    const Uint8* data = source->chunk->abuf;
+    for(Uint64 ii = 0; ii < total; ii++) {
+        const Uint8* sample = data+ii*bytes;
+        float value = 0;
+        if (bytes == 1) {
+            value = SDL_AUDIO_ISSIGNED(fmt) ? (Sint8)sample[0]/128.0f : (sample[0]-128)/128.0f;
+        } else if (bytes == 2) {
+            Uint16 bits = SDL_AUDIO_ISBIGENDIAN(fmt) ? (Uint16)((sample[0] << 8) | sample[1]) :
+                                                       (Uint16)((sample[1] << 8) | sample[0]);
+            value = SDL_AUDIO_ISSIGNED(fmt) ? (Sint16)bits/32768.0f : (bits-32768)/32768.0f;
+        } else {
+            Uint32 bits = SDL_AUDIO_ISBIGENDIAN(fmt) ?
+                ((Uint32)sample[0] << 24) | ((Uint32)sample[1] << 16) | ((Uint32)sample[2] << 8) | sample[3] :
+                ((Uint32)sample[3] << 24) | ((Uint32)sample[2] << 16) | ((Uint32)sample[1] << 8) | sample[0];
+            if (SDL_AUDIO_ISFLOAT(fmt)) {
+                SDL_memcpy(&value, &bits, sizeof(float));
+            } else {
+                value = (Sint32)bits/2147483648.0f;
+            }
+        }
+        output[ii] = value;
+    }
+    return source->frames;
+}
+
 #pragma mark -
 #pragma mark Music Assets
 /**
@@ -337,7 +383,7 @@ double AudioGetBufferSampleRate(AudioBuffer* source) {
  * @return an audio stream for the given music asset
  */
 AudioStream* AudioLoadStream(const char* file) {
-    Mix_Music* data = Mix_LoadMUS(file);
+    Mix_Music* data = Mix_LoadMUS_RW(AssetArchive::openFile(file,"rb"),1);
     if (!data) {
         return nullptr;
     }
@@ -98,11 +98,15 @@ namespace impl {
      * only cross-platforms options are 1 (Mono) and 2 (Stereo). Cross-platform
      * 5.1 or 7.1 sound is not supported.
      *
+     * The block size is the size of the device buffer.  Smaller blocks have
+     * less lag, but more CPU load.  AVFoundation ignores it.
+     *
      * @param frequency The default sampling frequency
      * @param input     The number of sound effect channels
      * @param output    The number of output channels
+     * @param block     The device block size in frames
      */
-    bool AudioStart(int frequency, int input, int output);
+    bool AudioStart(int frequency, int input, int output, int block);
     
     /**
      * Stops the audio engine preventing it from further use.
@@ -167,6 +171,20 @@ namespace impl {
      */
     double AudioGetBufferSampleRate(AudioBuffer* source);
 
+    /**
+     * Copies the PCM data of the given buffer as interleaved floats
+     *
+     * The samples are normalized to the range [-1,1].  The output array must
+     * have room for frames*channels values, as reported by the functions
+     * {@link AudioGetBufferFrames} and {@link AudioGetBufferChannels}.
+     *
+     * @param source    The PCM buffer
+     * @param output    The array to store the samples
+     *
+     * @return the number of audio frames copied (0 if the format is unknown)
+     */
+    Uint64 AudioGetBufferPCM(AudioBuffer* source, float* output);
+
     
 #pragma mark -
 #pragma mark Music Assets
@@ -34,6 +34,7 @@
 #include <cugl/base/CUApplication.h>
 #include <cugl/base/CUDisplay.h>
 #include <cugl/input/CUInput.h>
+#include <cugl/renderer/CUGLState.h>
 #include <cugl/util/CUDebug.h>
 #include <SDL/SDL_ttf.h>
 #include <algorithm>
@@ -44,6 +45,8 @@
 #define DEFAULT_HEIGHT  576
 /** The default smoothing window for fps calculation */
 #define FPS_WINDOW      10
+/** The number of marked inputs used for latency statistics */
+#define LATENCY_WINDOW  30
 
 using namespace cugl;
 
@@ -71,6 +74,8 @@ _fullscreen(false),
 _highdpi(true),
 _finish(0),
 _start(0),
+_immediate(false),
+_marked(false),
 _funcid(0),
 _clearColor(Color4f::CORNFLOWER) // Ah, XNA
 {
@@ -106,6 +111,9 @@ void Application::dispose() {
     _fullscreen = false;
     _highdpi = true;
     _fpswindow.clear();
+    _latencywindow.clear();
+    _immediate = false;
+    _marked = false;
     _clearColor = Color4f::CORNFLOWER;
     setFPS(60.0f);
 }
@@ -174,7 +182,7 @@ bool Application::init() {
 
 #if CU_PLATFORM == CU_PLATFORM_IPHONE
     // Apparently the iOS viewport does not get set correctly
-    glViewport(0, 0, (int)_display.size.width, (int)_display.size.height);
+    GLState::setViewport(0, 0, (int)_display.size.width, (int)_display.size.height);
 #endif
     
     _fpswindow.resize(FPS_WINDOW,1.0f/_fps);
@@ -232,51 +240,23 @@ void Application::onShutdown() {
  * is called.  As it sends all of its information to the appropriate
  * handlers, you should never need to override this method.
  *
+ * With {@link setImmediateInput}, any input that arrived while the previous
+ * frame was sleeping has already been dispatched.  This method only gathers
+ * the input that remains.
+ *
  * @return false if the input indicates that the application should quit.
  */
 bool Application::getInput() {
     SDL_Event event;
     
-    // Process input
-    Input::get()->clear();
+    // Immediate input begins the next frame when this one ends (in step)
+    if (!_immediate) {
+        Input::get()->clear();
+    }
     while ( SDL_PollEvent(&event) ) {
-        if (!Input::get()->update(event)) {
+        if (!dispatchEvent(event)) {
             return false;
         }
-        switch (event.type) {
-            // APPLICATION STATE
-            case SDL_APP_TERMINATING:
-                _state = State::SHUTDOWN;
-                return false;
-                break;
-            case SDL_APP_LOWMEMORY:
-                onLowMemory();
-                break;
-            case SDL_APP_WILLENTERBACKGROUND:
-                if (_state == State::FOREGROUND) {
-                    onSuspend();
-                }
-                break;
-            case SDL_APP_DIDENTERBACKGROUND:
-                _state = State::BACKGROUND;
-                return false;
-                break;
-            case SDL_APP_WILLENTERFOREGROUND:
-                if (_state == State::BACKGROUND) {
-                    onResume();
-                }
-                break;
-            case SDL_APP_DIDENTERFOREGROUND:
-                _state = State::FOREGROUND;
-                break;
-            case SDL_QUIT:
-                _state = State::SHUTDOWN;
-                return false;
-                break;
-            default:
-                // Ignore the event.
-                break;
-        }
     }
     
     return true;
@@ -307,10 +287,13 @@ bool Application::step() {
 
         glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
         glClear( GL_COLOR_BUFFER_BIT );
+        GLState::countCalls(2);
 
         draw();
+        GLState::endFrame();
 
         SDL_GL_SwapWindow(_window);
+        recordLatency();
     } else {
         running = _state == State::BACKGROUND;
     }
@@ -318,7 +301,19 @@ bool Application::step() {
 	// Sleep the remainder
 	_finish = SDL_GetTicks();
 	millis = _finish - _start;
-	if (millis < _delay) {
+    if (_immediate) {
+        // Start the next input frame now, and dispatch input while we wait
+        Input::get()->clear();
+        SDL_Event event;
+        while (running && millis < _delay) {
+            // Block until the next event or the end of the frame
+            if (SDL_WaitEventTimeout(&event, (int)(_delay - millis)) && !dispatchEvent(event)) {
+                running = _state == State::BACKGROUND;
+                break;
+            }
+            millis = SDL_GetTicks() - _start;
+        }
+    } else if (millis < _delay) {
 		SDL_Delay(_delay - millis);
 	}
     
@@ -676,6 +671,60 @@ float Application::getAverageFPS() const {
     return total/_fpswindow.size();
 }
 
+/**
+ * Marks an input event whose response is drawn in the current frame.
+ *
+ * When the frame is presented, the time from the event to the present is
+ * recorded as an input latency.  If several events are marked in the same
+ * frame, only the earliest one counts.  Use the event timestamp (such as
+ * {@link TouchEvent#timestamp}) so that the time spent waiting for the
+ * frame is included.
+ *
+ * The measurement ends when the buffer swap returns.  The display may
+ * take up to one more refresh to show the frame.
+ *
+ * @param stamp The timestamp of the input event
+ */
+void Application::markLatency(const Timestamp& stamp) {
+    if (!_marked || stamp.getTime() < _marktime.getTime()) {
+        _marktime = stamp;
+    }
+    _marked = true;
+}
+
+/**
+ * Returns the average input latency over the last 30 marked inputs.
+ *
+ * The value is in milliseconds.  It is 0 if no inputs were marked.
+ *
+ * @return the average input latency over the last 30 marked inputs.
+ */
+float Application::getAverageLatency() const {
+    if (_latencywindow.empty()) {
+        return 0;
+    }
+    float total = 0;
+    for(auto it=_latencywindow.begin(); it != _latencywindow.end(); ++it) {
+        total += *it;
+    }
+    return total/_latencywindow.size();
+}
+
+/**
+ * Returns the maximum input latency over the last 30 marked inputs.
+ *
+ * The value is in milliseconds.  It is 0 if no inputs were marked.
+ *
+ * @return the maximum input latency over the last 30 marked inputs.
+ */
+float Application::getMaximumLatency() const {
+    float result = 0;
+    for(auto it=_latencywindow.begin(); it != _latencywindow.end(); ++it) {
+        result = std::max(result,*it);
+    }
+    return result;
+}
+
 /**
  * Returns the OpenGL description for this application
  *
@@ -757,6 +806,79 @@ std::string Application::getSaveDirectory() {
 
 #pragma mark -
 #pragma mark Internal Helpers
+/**
+ * Processes a single SDL event, sending it to the input devices.
+ *
+ * This method also reacts to any change in the application state.
+ *
+ * @param event The event to process
+ *
+ * @return false if the event indicates that the application should quit.
+ */
+bool Application::dispatchEvent(const SDL_Event& event) {
+    if (!Input::get()->update(event)) {
+        return false;
+    }
+    switch (event.type) {
+        // APPLICATION STATE
+        case SDL_APP_TERMINATING:
+            _state = State::SHUTDOWN;
+            return false;
+            break;
+        case SDL_APP_LOWMEMORY:
+            onLowMemory();
+            break;
+        case SDL_APP_WILLENTERBACKGROUND:
+            if (_state == State::FOREGROUND) {
+                onSuspend();
+            }
+            break;
+        case SDL_APP_DIDENTERBACKGROUND:
+            _state = State::BACKGROUND;
+            return false;
+            break;
+        case SDL_APP_WILLENTERFOREGROUND:
+            if (_state == State::BACKGROUND) {
+                onResume();
+            }
+            break;
+        case SDL_APP_DIDENTERFOREGROUND:
+            _state = State::FOREGROUND;
+            break;
+        case SDL_QUIT:
+            _state = State::SHUTDOWN;
+            return false;
+            break;
+        default:
+            // Ignore the event.
+            break;
+    }
+    return true;
+}
+
+/**
+ * Records the latency of the input marked this frame, if any.
+ *
+ * This method is called when the frame has been presented.
+ */
+void Application::recordLatency() {
+    if (!_marked) {
+        return;
+    }
+    _marked = false;
+    
+    // SDL times are in milliseconds, so an event may appear slightly early
+    Timestamp now;
+    float latency = 0;
+    if (_marktime.getTime() < now.getTime()) {
+        latency = Timestamp::ellapsedMicros(_marktime,now)/1000.0f;
+    }
+    _latencywindow.push_back(latency);
+    if (_latencywindow.size() > LATENCY_WINDOW) {
+        _latencywindow.pop_front();
+    }
+}
+
 /**
  * Assign the default settings for OpenGL
  *
@@ -808,12 +930,14 @@ bool Application::initOpenGL() {
         CULogError("Could not create OpenGL context: %s", SDL_GetError() );
         return false;
     }
+    // The state cache knows nothing about the new context
+    GLState::reset();
 
     // Multisampling support
 #if CU_GL_PLATFORM != CU_GL_OPENGLES
-    glEnable(GL_LINE_SMOOTH);
+    GLState::enable(GL_LINE_SMOOTH);
     if (_multisamp) {
-        glEnable(GL_MULTISAMPLE);
+        GLState::enable(GL_MULTISAMPLE);
     }
 #endif
     
@@ -0,0 +1,361 @@
+//
+//  CUEndian.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module implements the array versions of the functions in CUEndian.h.
+//  These force a whole block of data into "network" (or big-endian) order,
+//  using vector instructions to swap several values at once when the platform
+//  has them.  There is a scalar fallback for all other platforms.
+//
+//  All of these functions are idempotent. To decode a previously encoded
+//  block of data, use the function again.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/base/CUEndian.h>
+#include <cstring>
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>
+        #define CU_ENDIAN_NEON  1
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define CU_ENDIAN_SSE2  1
+    #endif
+#endif
+
+using namespace cugl;
+
+#pragma mark Swap Kernels
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+/**
+ * Copies count 16-bit values from src to dst, swapping the bytes of each
+ *
+ * The arrays may be the same, but should not otherwise overlap.
+ *
+ * @param dst   The destination bytes
+ * @param src   The source bytes
+ * @param count The number of 16-bit values
+ */
+static void swap16(Uint8* dst, const Uint8* src, size_t count) {
+    size_t pos = 0;
+#if defined(CU_ENDIAN_NEON)
+    for(; pos+8 <= count; pos += 8) {
+        vst1q_u8(dst+2*pos, vrev16q_u8(vld1q_u8(src+2*pos)));
+    }
+#elif defined(CU_ENDIAN_SSE2)
+    for(; pos+8 <= count; pos += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src+2*pos));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i*)(dst+2*pos), v);
+    }
+#endif
+    for(; pos < count; pos++) {
+        Uint16 value;
+        std::memcpy(&value, src+2*pos, 2);
+        value = SDL_Swap16(value);
+        std::memcpy(dst+2*pos, &value, 2);
+    }
+}
+
+/**
+ * Copies count 32-bit values from src to dst, swapping the bytes of each
+ *
+ * The arrays may be the same, but should not otherwise overlap.
+ *
+ * @param dst   The destination bytes
+ * @param src   The source bytes
+ * @param count The number of 32-bit values
+ */
+static void swap32(Uint8* dst, const Uint8* src, size_t count) {
+    size_t pos = 0;
+#if defined(CU_ENDIAN_NEON)
+    for(; pos+4 <= count; pos += 4) {
+        vst1q_u8(dst+4*pos, vrev32q_u8(vld1q_u8(src+4*pos)));
+    }
+#elif defined(CU_ENDIAN_SSE2)
+    for(; pos+4 <= count; pos += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src+4*pos));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2,3,0,1));
+        _mm_storeu_si128((__m128i*)(dst+4*pos), v);
+    }
+#endif
+    for(; pos < count; pos++) {
+        Uint32 value;
+        std::memcpy(&value, src+4*pos, 4);
+        value = SDL_Swap32(value);
+        std::memcpy(dst+4*pos, &value, 4);
+    }
+}
+
+/**
+ * Copies count 64-bit values from src to dst, swapping the bytes of each
+ *
+ * The arrays may be the same, but should not otherwise overlap.
+ *
+ * @param dst   The destination bytes
+ * @param src   The source bytes
+ * @param count The number of 64-bit values
+ */
+static void swap64(Uint8* dst, const Uint8* src, size_t count) {
+    size_t pos = 0;
+#if defined(CU_ENDIAN_NEON)
+    for(; pos+2 <= count; pos += 2) {
+        vst1q_u8(dst+8*pos, vrev64q_u8(vld1q_u8(src+8*pos)));
+    }
+#elif defined(CU_ENDIAN_SSE2)
+    for(; pos+2 <= count; pos += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src+8*pos));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0,1,2,3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0,1,2,3));
+        _mm_storeu_si128((__m128i*)(dst+8*pos), v);
+    }
+#endif
+    for(; pos < count; pos++) {
+        Uint64 value;
+        std::memcpy(&value, src+8*pos, 8);
+        value = SDL_Swap64(value);
+        std::memcpy(dst+8*pos, &value, 8);
+    }
+}
+#endif
+
+/**
+ * Copies count values of the given size from src to dst in network order
+ *
+ * On a big-endian system, this is a simple copy (or nothing at all if the
+ * arrays are the same).
+ *
+ * @param dst   The destination bytes
+ * @param src   The source bytes
+ * @param count The number of values
+ * @param size  The size of each value in bytes (2, 4, or 8)
+ */
+static void encode(void* dst, const void* src, size_t count, size_t size) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    switch (size) {
+        case 2:
+            swap16((Uint8*)dst, (const Uint8*)src, count);
+            break;
+        case 4:
+            swap32((Uint8*)dst, (const Uint8*)src, count);
+            break;
+        case 8:
+            swap64((Uint8*)dst, (const Uint8*)src, count);
+            break;
+    }
+#else
+    if (dst != src) {
+        std::memmove(dst, src, count*size);
+    }
+#endif
+}
+
+#pragma mark -
+#pragma mark Array Encoding
+/**
+ * Encodes an array of 16-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Sint16* dst, const Sint16* src, size_t count) {
+    encode(dst, src, count, sizeof(Sint16));
+}
+
+/**
+ * Encodes an array of 16-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Uint16* dst, const Uint16* src, size_t count) {
+    encode(dst, src, count, sizeof(Uint16));
+}
+
+/**
+ * Encodes an array of 32-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Sint32* dst, const Sint32* src, size_t count) {
+    encode(dst, src, count, sizeof(Sint32));
+}
+
+/**
+ * Encodes an array of 32-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Uint32* dst, const Uint32* src, size_t count) {
+    encode(dst, src, count, sizeof(Uint32));
+}
+
+/**
+ * Encodes an array of 64-bit signed integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Sint64* dst, const Sint64* src, size_t count) {
+    encode(dst, src, count, sizeof(Sint64));
+}
+
+/**
+ * Encodes an array of 64-bit unsigned integers in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(Uint64* dst, const Uint64* src, size_t count) {
+    encode(dst, src, count, sizeof(Uint64));
+}
+
+/**
+ * Encodes an array of floats in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(float* dst, const float* src, size_t count) {
+    encode(dst, src, count, sizeof(float));
+}
+
+/**
+ * Encodes an array of doubles in network order
+ *
+ * This function copies count values from src to dst, encoding each value as
+ * {@link marshall} would.  On a big-endian system, this is a simple copy.
+ * On a little-endian system, it swaps the bytes of each value, processing
+ * several values at once with vector instructions (NEON or SSE2) if they
+ * are available.
+ *
+ * The arrays may be the same, in which case the values are encoded in place.
+ * Otherwise they should not overlap.  Neither array needs to be aligned.
+ *
+ * This function is idempotent. To decode encoded values, call this function
+ * on the values again.
+ *
+ * @param dst   The array to store the encoded values
+ * @param src   The array of values to encode
+ * @param count The number of values to encode
+ */
+void cugl::marshall(double* dst, const double* src, size_t count) {
+    encode(dst, src, count, sizeof(double));
+}
@@ -165,7 +165,14 @@ void Input::clear() {
  */
 bool Input::update(SDL_Event event) {
     bool result = true;
-    Timestamp eventtime = _reference-(_roffset-event.common.timestamp);
+    // Events dispatched between frames may be newer than the reference
+    Timestamp eventtime = _reference;
+    Sint32 offset = (Sint32)(event.common.timestamp-_roffset);
+    if (offset < 0) {
+        eventtime -= (Uint32)(-offset);
+    } else {
+        eventtime += (Uint32)offset;
+    }
     auto it = _subscribers.find(event.type);
     if (it != _subscribers.end()) {
         for(auto jt = it->second.begin(); jt != it->second.end(); ++jt) {
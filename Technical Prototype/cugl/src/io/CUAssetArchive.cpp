@@ -0,0 +1,640 @@
+//
+//  CUAssetArchive.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides read access to a packed asset archive.  An archive is
+//  a single file that concatenates the files of an asset directory, together
+//  with an index of their paths.  Opening one archive (instead of hundreds of
+//  loose files) is much faster on platforms like Android, where every file is
+//  opened through the APK asset manager.
+//
+//  Where possible, the archive is memory mapped, and entries are returned as
+//  read-only SDL_RWops views into the mapping.  Entries may also be stored
+//  with LZ4 compression, in which case they are decompressed when opened.
+//  Archives are built offline with the assetpack tool.
+//
+//  Archives can be mounted, so that the asset loaders find files in them
+//  first.  The loaders open all of their files with the static method
+//  AssetArchive::openFile, which checks the mounted archives before falling
+//  back to the file system.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/io/CUAssetArchive.h>
+#include <cugl/base/CUApplication.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined (__WINDOWS__)
+    #include <windows.h>
+#elif !defined (__ANDROID__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace cugl;
+
+/** The FNV-1a offset basis */
+#define FNV_OFFSET  0xcbf29ce484222325ULL
+/** The FNV-1a prime */
+#define FNV_PRIME   0x100000001b3ULL
+
+/** The mounted archives, in search order */
+std::vector<std::shared_ptr<AssetArchive>> AssetArchive::_gMounted;
+/** The lock protecting the mounted archives */
+std::mutex AssetArchive::_gMountLock;
+
+#pragma mark -
+#pragma mark Archive Format
+// The archive header is 32 bytes, laid out as follows (all little endian)
+//
+//      0   magic       Uint32  ARCHIVE_MAGIC
+//      4   version     Uint32  ARCHIVE_VERSION
+//      8   count       Uint32  The number of entries
+//     12   alignment   Uint32  The alignment of uncompressed entries
+//     16   names       Uint32  The size of the path table in bytes
+//     20   reserved    Uint32  Always 0
+//     24   size        Uint64  The size of the archive in bytes
+//
+// It is followed by count index entries (sorted by hash), then the path
+// table, and then the entry data.
+
+/**
+ * Returns the given path character with separators normalized
+ *
+ * @param c     The path character
+ *
+ * @return the given path character with separators normalized
+ */
+static inline char normalize(char c) {
+    return c == '\\' ? '/' : c;
+}
+
+/**
+ * Returns a little endian 32 bit value from the given bytes
+ *
+ * @param data  The bytes to read
+ *
+ * @return a little endian 32 bit value from the given bytes
+ */
+static Uint32 read32(const Uint8* data) {
+    return (Uint32)data[0] | ((Uint32)data[1] << 8) | ((Uint32)data[2] << 16) | ((Uint32)data[3] << 24);
+}
+
+/**
+ * Decompresses an LZ4 block, returning true if successful
+ *
+ * This is a bounds checked decoder for the LZ4 block format (without the
+ * frame header).  It fails if the block is corrupt, or if it does not
+ * decompress to exactly the given size.
+ *
+ * @param src       The compressed block
+ * @param srcSize   The size of the compressed block
+ * @param dst       The buffer to store the decompressed data
+ * @param dstSize   The size of the decompressed data
+ *
+ * @return true if the block was decompressed successfully
+ */
+static bool lz4_decompress(const Uint8* src, size_t srcSize, Uint8* dst, size_t dstSize) {
+    const Uint8* ip   = src;
+    const Uint8* iend = src+srcSize;
+    Uint8* op   = dst;
+    Uint8* oend = dst+dstSize;
+
+    while (ip < iend) {
+        Uint8 token = *ip++;
+
+        // Literals
+        size_t length = token >> 4;
+        if (length == 15) {
+            Uint8 extra;
+            do {
+                if (ip >= iend) {
+                    return false;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255);
+        }
+        if ((size_t)(iend-ip) < length || (size_t)(oend-op) < length) {
+            return false;
+        }
+        memcpy(op,ip,length);
+        ip += length;
+        op += length;
+        if (ip == iend) {
+            break;      // The last sequence has no match
+        }
+
+        // Match
+        if (iend-ip < 2) {
+            return false;
+        }
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op-dst)) {
+            return false;
+        }
+        length = token & 0x0F;
+        if (length == 15) {
+            Uint8 extra;
+            do {
+                if (ip >= iend) {
+                    return false;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255);
+        }
+        length += 4;
+        if ((size_t)(oend-op) < length) {
+            return false;
+        }
+        // Matches may overlap the output, so copy forward byte by byte
+        const Uint8* match = op-offset;
+        if (offset >= length) {
+            memcpy(op,match,length);
+            op += length;
+        } else {
+            for(size_t ii = 0; ii < length; ii++) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return op == oend;
+}
+
+/**
+ * Closes a memory stream that owns its buffer
+ *
+ * This replaces the close function of an SDL memory stream so that the
+ * decompressed data is freed with the stream.
+ *
+ * @param context   The stream to close
+ *
+ * @return 0 (closing always succeeds)
+ */
+static int SDLCALL close_owned(SDL_RWops* context) {
+    if (context) {
+        SDL_free(context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an unopened archive.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+AssetArchive::AssetArchive() :
+_data(nullptr),
+_size(0),
+_mapped(false),
+_index(nullptr),
+_count(0),
+_names(nullptr) {
+}
+
+/**
+ * Releases the contents of this archive.
+ *
+ * Any streams opened from this archive are invalid after this call.
+ */
+void AssetArchive::dispose() {
+    if (_data != nullptr) {
+        if (_mapped) {
+#if defined (__WINDOWS__)
+            UnmapViewOfFile(_data);
+#elif !defined (__ANDROID__)
+            munmap((void*)_data,_size);
+#endif
+        } else {
+            SDL_free((void*)_data);
+        }
+    }
+    _data  = nullptr;
+    _size  = 0;
+    _mapped = false;
+    _index = nullptr;
+    _count = 0;
+    _names = nullptr;
+    _path.clear();
+    _root.clear();
+}
+
+/**
+ * Initializes an archive from the given file.
+ *
+ * The root is the directory prefix that is removed from paths before
+ * they are looked up in the archive.  It should end in a path separator.
+ *
+ * This method fails (without an error) if the file does not exist.  It
+ * fails with an error if the file is not a valid archive.
+ *
+ * @param file  The path to the archive
+ * @param root  The directory prefix for entry paths
+ *
+ * @return true if initialization was successful.
+ */
+bool AssetArchive::init(const std::string& file, const std::string& root) {
+    if (_data != nullptr) {
+        CUAssertLog(false, "Archive %s is already initialized", _path.c_str());
+        return false;
+    }
+    if (!map(file) && !load(file)) {
+        return false;
+    }
+    if (!validate()) {
+        CULogError("'%s' is not a valid asset archive", file.c_str());
+        dispose();
+        return false;
+    }
+    _path = file;
+    _root = root;
+    return true;
+}
+
+/**
+ * Initializes an archive from the given file in the asset directory.
+ *
+ * The entries of the archive are relative to the asset directory.  This
+ * method fails (without an error) if the file does not exist.  It fails
+ * with an error if the file is not a valid archive.
+ *
+ * @param file  The path to the archive, relative to the asset directory
+ *
+ * @return true if initialization was successful.
+ */
+bool AssetArchive::initWithAsset(const std::string& file) {
+    std::string root = Application::get()->getAssetDirectory();
+    std::string path = root+file;
+#if defined (__WINDOWS__)
+    std::replace(path.begin(),path.end(),'/','\\');
+#endif
+    return init(path,root);
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns true if the contents were memory mapped from the given file.
+ *
+ * This method returns false (without an error) if the platform does not
+ * support memory mapping, or the file is not a regular file.
+ *
+ * @param file  The absolute path to the archive
+ *
+ * @return true if the contents were memory mapped from the given file.
+ */
+bool AssetArchive::map(const std::string& file) {
+#if defined (__WINDOWS__)
+    HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle,&size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    // The view keeps the mapping alive, so we can close the handles
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (mapping == NULL) {
+        return false;
+    }
+    void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (addr == NULL) {
+        return false;
+    }
+    _data = (const Uint8*)addr;
+    _size = (size_t)size.QuadPart;
+    _mapped = true;
+    return true;
+#elif !defined (__ANDROID__)
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd,&info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    // The mapping stays valid after the file is closed
+    void* addr = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    _data = (const Uint8*)addr;
+    _size = (size_t)info.st_size;
+    _mapped = true;
+    return true;
+#else
+    // Android assets are inside the APK and cannot be mapped through SDL
+    (void)file;
+    return false;
+#endif
+}
+
+/**
+ * Returns true if the contents were read from the given file.
+ *
+ * The contents are read into memory with a single read.
+ *
+ * @param file  The absolute path to the archive
+ *
+ * @return true if the contents were read from the given file.
+ */
+bool AssetArchive::load(const std::string& file) {
+    SDL_RWops* source = SDL_RWFromFile(file.c_str(), "rb");
+    if (source == nullptr) {
+        return false;
+    }
+    Sint64 size = SDL_RWsize(source);
+    if (size <= 0) {
+        SDL_RWclose(source);
+        return false;
+    }
+
+    Uint8* buffer = (Uint8*)SDL_malloc((size_t)size);
+    size_t amt = 0;
+    size_t read = 0;
+    do {
+        amt = SDL_RWread(source, buffer+read, 1, (size_t)size-read);
+        read += amt;
+    } while (amt > 0 && read < (size_t)size);
+    SDL_RWclose(source);
+    if (read < (size_t)size) {
+        CULogError("Could not read asset archive '%s'", file.c_str());
+        SDL_free(buffer);
+        return false;
+    }
+
+    _data = buffer;
+    _size = (size_t)size;
+    _mapped = false;
+    return true;
+}
+
+/**
+ * Returns true if the archive contents have a valid header and index.
+ *
+ * @return true if the archive contents have a valid header and index.
+ */
+bool AssetArchive::validate() {
+    if (_size < ARCHIVE_HEADER_SIZE) {
+        return false;
+    }
+    if (read32(_data) != ARCHIVE_MAGIC || read32(_data+4) != ARCHIVE_VERSION) {
+        return false;
+    }
+    Uint32 count = read32(_data+8);
+    Uint32 names = read32(_data+16);
+    Uint64 total = (Uint64)read32(_data+24) | ((Uint64)read32(_data+28) << 32);
+    Uint64 start = ARCHIVE_HEADER_SIZE+(Uint64)count*sizeof(Entry);
+    if (total != _size || start+names > _size) {
+        return false;
+    }
+
+    // The index is stored exactly as our entries (all of our targets are little endian)
+    const Entry* index = (const Entry*)(_data+ARCHIVE_HEADER_SIZE);
+    for(Uint32 ii = 0; ii < count; ii++) {
+        const Entry& entry = index[ii];
+        if (entry.offset < start+names || entry.offset+entry.size > _size ||
+            (Uint64)entry.name+entry.namelen > names ||
+            (ii > 0 && index[ii-1].hash > entry.hash)) {
+            return false;
+        }
+        if (!(entry.flags & ARCHIVE_LZ4) && entry.size != entry.length) {
+            return false;
+        }
+    }
+
+    _index = index;
+    _count = count;
+    _names = (const char*)(_data+start);
+    return true;
+}
+
+/**
+ * Returns the index entry for the given path (or nullptr if none)
+ *
+ * @param path  The path to look up
+ *
+ * @return the index entry for the given path (or nullptr if none)
+ */
+const AssetArchive::Entry* AssetArchive::find(const std::string& path) const {
+    if (_index == nullptr) {
+        return nullptr;
+    }
+
+    // Strip the root (ignoring separator differences)
+    size_t start = 0;
+    if (_root.size() <= path.size()) {
+        start = _root.size();
+        for(size_t ii = 0; ii < _root.size() && start; ii++) {
+            if (normalize(_root[ii]) != normalize(path[ii])) {
+                start = 0;
+            }
+        }
+    }
+
+    Uint64 hash = FNV_OFFSET;
+    for(size_t ii = start; ii < path.size(); ii++) {
+        hash ^= (Uint8)normalize(path[ii]);
+        hash *= FNV_PRIME;
+    }
+
+    size_t length = path.size()-start;
+    const Entry* end = _index+_count;
+    const Entry* it  = std::lower_bound(_index, end, hash, [](const Entry& entry, Uint64 value) {
+        return entry.hash < value;
+    });
+    for(; it != end && it->hash == hash; ++it) {
+        if (it->namelen != length) {
+            continue;
+        }
+        const char* name = _names+it->name;
+        bool match = true;
+        for(size_t ii = 0; ii < length && match; ii++) {
+            match = name[ii] == normalize(path[start+ii]);
+        }
+        if (match) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Returns the paths of all of the entries in this archive.
+ *
+ * The paths are relative to the archive root.
+ *
+ * @return the paths of all of the entries in this archive.
+ */
+std::vector<std::string> AssetArchive::getEntries() const {
+    std::vector<std::string> result;
+    result.reserve(_count);
+    for(Uint32 ii = 0; ii < _count; ii++) {
+        result.push_back(std::string(_names+_index[ii].name,_index[ii].namelen));
+    }
+    return result;
+}
+
+#pragma mark -
+#pragma mark Entry Access
+/**
+ * Returns a read-only stream for the given entry (or nullptr if none).
+ *
+ * The path may be absolute, provided that it starts with the archive root.
+ * If the entry is uncompressed, the stream is a view into the archive
+ * and does not copy any data.  Otherwise, the entry is decompressed into
+ * a buffer that is freed when the stream is closed.
+ *
+ * The caller owns the stream and must close it with SDL_RWclose.
+ *
+ * @param path  The path to look up
+ *
+ * @return a read-only stream for the given entry (or nullptr if none).
+ */
+SDL_RWops* AssetArchive::open(const std::string& path) const {
+    const Entry* entry = find(path);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+
+    const Uint8* data = _data+entry->offset;
+    if (!(entry->flags & ARCHIVE_LZ4)) {
+        return SDL_RWFromConstMem(data, (int)entry->size);
+    }
+
+    Uint8* buffer = (Uint8*)SDL_malloc(entry->length);
+    if (!lz4_decompress(data, entry->size, buffer, entry->length)) {
+        CULogError("Archive entry '%s' is corrupt", path.c_str());
+        SDL_free(buffer);
+        return nullptr;
+    }
+    SDL_RWops* result = SDL_RWFromConstMem(buffer, (int)entry->length);
+    if (result == nullptr) {
+        SDL_free(buffer);
+        return nullptr;
+    }
+    result->close = close_owned;
+    return result;
+}
+
+#pragma mark -
+#pragma mark Mounting
+/**
+ * Mounts the given archive so that {@link openFile} can find its entries.
+ *
+ * Archives mounted later are searched first.  Mounting an archive that
+ * is already mounted has no effect.
+ *
+ * @param archive   The archive to mount
+ */
+void AssetArchive::mount(const std::shared_ptr<AssetArchive>& archive) {
+    std::lock_guard<std::mutex> lock(_gMountLock);
+    if (std::find(_gMounted.begin(), _gMounted.end(), archive) == _gMounted.end()) {
+        _gMounted.push_back(archive);
+    }
+}
+
+/**
+ * Unmounts the given archive.
+ *
+ * Any streams opened from this archive remain valid as long as there are
+ * other references to the archive.
+ *
+ * @param archive   The archive to unmount
+ */
+void AssetArchive::unmount(const std::shared_ptr<AssetArchive>& archive) {
+    std::lock_guard<std::mutex> lock(_gMountLock);
+    _gMounted.erase(std::remove(_gMounted.begin(), _gMounted.end(), archive), _gMounted.end());
+}
+
+/**
+ * Unmounts all archives.
+ */
+void AssetArchive::unmountAll() {
+    std::lock_guard<std::mutex> lock(_gMountLock);
+    _gMounted.clear();
+}
+
+/**
+ * Returns a stream for the given file, using the mounted archives.
+ *
+ * If the mode is a read-only mode ("r" or "rb"), this method first
+ * searches the mounted archives for the file.  If it is not found, or if
+ * the mode allows writing, this method falls back to SDL_RWFromFile.
+ * This is the method that the asset loaders use to open their files.
+ *
+ * The caller owns the stream and must close it with SDL_RWclose.
+ *
+ * @param file  The path to the file
+ * @param mode  The file mode (as in fopen)
+ *
+ * @return a stream for the given file, using the mounted archives.
+ */
+SDL_RWops* AssetArchive::openFile(const std::string& file, const char* mode) {
+    if (mode[0] == 'r' && strchr(mode,'+') == nullptr) {
+        std::vector<std::shared_ptr<AssetArchive>> mounted;
+        {
+            std::lock_guard<std::mutex> lock(_gMountLock);
+            if (!_gMounted.empty()) {
+                mounted = _gMounted;
+            }
+        }
+        for(auto it = mounted.rbegin(); it != mounted.rend(); ++it) {
+            SDL_RWops* result = (*it)->open(file);
+            if (result != nullptr) {
+                return result;
+            }
+        }
+    }
+    return SDL_RWFromFile(file.c_str(), mode);
+}
@@ -51,6 +51,7 @@
 //  Version: 11/28/16
 //
 #include <cugl/io/CUBinaryReader.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/base/CUApplication.h>
 #include <cugl/base/CUEndian.h>
@@ -97,7 +98,7 @@ bool BinaryReader::init(const Pathname& file) {
 bool BinaryReader::init(const Pathname& file, unsigned int capacity) {
     CUAssertLog(capacity, "The buffer capacity must be positive");
     _name = file.getAbsoluteName();
-    _stream = SDL_RWFromFile(_name.c_str(), "rb");
+    _stream = AssetArchive::openFile(_name, "rb");
     if (!_stream) {
         return false;
     }
@@ -155,7 +156,7 @@ bool BinaryReader::initWithAsset(const char* file, unsigned int capacity) {
     
     _name = Application::get()->getAssetDirectory();
     _name.append(file);
-    _stream = SDL_RWFromFile(_name.c_str(), "rb");
+    _stream = AssetArchive::openFile(_name, "rb");
     if (!_stream) {
         return false;
     }
@@ -183,12 +184,13 @@ void BinaryReader::reset() {
     if (_stream) {
         close();
     }
-    _stream = SDL_RWFromFile(_name.c_str(), "rb");
+    _stream = AssetArchive::openFile(_name, "rb");
     _ssize  = SDL_RWsize(_stream);
     _buffer = new char[_capacity];
     _bufsize = 0;
-    _bufoff  = 0;
+    _bufoff  = -1;
     _scursor = 0;
+    fill();
 }
 
 /**
@@ -238,13 +240,16 @@ bool BinaryReader::ready(unsigned int bytes) const {
  * @param bytes The minimum number of bytes to ensure in the stream
  */
 void BinaryReader::fill(unsigned int bytes) {
-    if (!_bufoff || !_stream || _scursor == _ssize) {
+    if (!_stream || _scursor == _ssize) {
         return;
     }
     
-    if (_bufoff == -1 || _bufoff+bytes > _bufsize) {
-        if (_bufoff < _bufsize) {
-            memcpy(_buffer, &(_buffer[_bufoff]), _bufsize-_bufoff);
+    if (_bufoff == -1) {
+        _bufsize = 0;
+        _bufoff  = 0;
+    } else if ((Uint32)_bufoff+bytes > _bufsize) {
+        if ((Uint32)_bufoff < _bufsize) {
+            memmove(_buffer, &(_buffer[_bufoff]), _bufsize-_bufoff);
             _bufsize -= _bufoff;
         } else {
             _bufsize = 0;
@@ -257,6 +262,97 @@ void BinaryReader::fill(unsigned int bytes) {
     _scursor += amt;
 }
 
+/**
+ * Copies count elements of the given size from src to dst.
+ *
+ * If swap is true, each element is marshalled from network order as it is
+ * copied.  The arrays may be the same, but should not otherwise overlap.
+ *
+ * @param dst   The destination array
+ * @param src   The source array
+ * @param count The number of elements
+ * @param size  The size of each element in bytes
+ * @param swap  Whether to marshall the elements from network order
+ */
+static void transfer(Uint8* dst, const Uint8* src, size_t count, unsigned int size, bool swap) {
+    if (!swap) {
+        if (dst != src) {
+            memcpy(dst, src, count*size);
+        }
+        return;
+    }
+    switch (size) {
+        case 2:
+            marshall((Uint16*)dst, (const Uint16*)src, count);
+            break;
+        case 4:
+            marshall((Uint32*)dst, (const Uint32*)src, count);
+            break;
+        case 8:
+            marshall((Uint64*)dst, (const Uint64*)src, count);
+            break;
+    }
+}
+
+/**
+ * Reads a sequence of elements of the given size from the stream.
+ *
+ * The function will attempt to read up to maximum number of elements.
+ * It will return the actual number of elements read (which may be 0).
+ * Only whole elements are read.
+ *
+ * If swap is true, each element is marshalled from network order.  This
+ * is done one block at a time, as the data is copied out of the buffer.
+ * If the buffer is empty and the request is at least the buffer capacity,
+ * the elements are read directly into the array instead, and marshalled
+ * in place.
+ *
+ * @param buffer    The array to store the data when read
+ * @param maximum   The maximum number of elements to read from the stream
+ * @param size      The size of each element in bytes
+ * @param swap      Whether to marshall the elements from network order
+ *
+ * @return the number of elements read from the stream
+ */
+size_t BinaryReader::readArray(Uint8* buffer, size_t maximum, unsigned int size, bool swap) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    swap = false;   // Network order is the native order
+#endif
+    size_t amount = 0;
+    while (_stream && amount < maximum) {
+        Uint32 offset = _bufoff < 0 ? _bufsize : (Uint32)_bufoff;
+        size_t wanted = maximum-amount;
+        if (offset == _bufsize && wanted*size >= _capacity) {
+            // Stream large blocks straight into the array
+            size_t whole = (size_t)((_ssize-_scursor)/size);
+            wanted = wanted < whole ? wanted : whole;
+            size_t amt = wanted ? SDL_RWread(_stream, buffer+amount*size, size, wanted) : 0;
+            if (!amt) {
+                break;
+            }
+            _scursor += amt*size;
+            transfer(buffer+amount*size, buffer+amount*size, amt, size, swap);
+            amount += amt;
+            continue;
+        }
+        
+        if (offset+size > _bufsize) {
+            fill(size);
+            offset = _bufoff < 0 ? _bufsize : (Uint32)_bufoff;
+            if (offset+size > _bufsize) {
+                break;
+            }
+        }
+        
+        size_t available = (_bufsize-offset)/size;
+        wanted = wanted < available ? wanted : available;
+        transfer(buffer+amount*size, (const Uint8*)&(_buffer[offset]), wanted, size, swap);
+        _bufoff = (Sint32)(offset+wanted*size);
+        amount += wanted;
+    }
+    return amount;
+}
+
 #pragma mark -
 #pragma mark Single Element Reads
 /**
@@ -458,16 +554,7 @@ double BinaryReader::readDouble()  {
  */
 size_t BinaryReader::read(char* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    while (ready(1) && pos-offset < maximum) {
-        size_t available = _bufsize-_bufoff;
-        size_t wanted = maximum-(pos-offset);
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)wanted;
-    }
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 1, false);
 }
 
 /**
@@ -482,18 +569,9 @@ size_t BinaryReader::read(char* buffer, size_t maximum, size_t offset) {
  *
  * @return the number of bytes read from the stream
  */
-size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset)  {
+size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    while (ready(1) && pos-offset < maximum) {
-        size_t available = _bufsize-_bufoff;
-        size_t wanted = maximum-(pos-offset);
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)wanted;
-    }
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 1, false);
 }
 
 /**
@@ -513,21 +591,7 @@ size_t BinaryReader::read(Uint8* buffer, size_t maximum, size_t offset)  {
  */
 size_t BinaryReader::read(Sint16* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 2;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 2, true);
 }
 
 /**
@@ -545,23 +609,9 @@ size_t BinaryReader::read(Sint16* buffer, size_t maximum, size_t offset) {
  *
  * @return the number of 16 bit unsigned integers read from the stream
  */
-size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset)  {
+size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 2;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 2, true);
 }
 
 
@@ -582,21 +632,7 @@ size_t BinaryReader::read(Uint16* buffer, size_t maximum, size_t offset)  {
  */
 size_t BinaryReader::read(Sint32* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 4, true);
 }
 
 /**
@@ -616,21 +652,7 @@ size_t BinaryReader::read(Sint32* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Uint32* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 4, true);
 }
 
 /**
@@ -650,21 +672,7 @@ size_t BinaryReader::read(Uint32* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Sint64* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 8, true);
 }
 
 /**
@@ -684,21 +692,7 @@ size_t BinaryReader::read(Sint64* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(Uint64* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 8, true);
 }
 
 /**
@@ -718,21 +712,7 @@ size_t BinaryReader::read(Uint64* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(float* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 4;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 4, true);
 }
 
 /**
@@ -752,20 +732,40 @@ size_t BinaryReader::read(float* buffer, size_t maximum, size_t offset) {
  */
 size_t BinaryReader::read(double* buffer, size_t maximum, size_t offset) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    unsigned int pos = (unsigned int)offset;
-    unsigned int bytes = 8;
-    while (ready(bytes) && pos-offset < maximum) {
-        size_t available = bytes*((_bufsize-_bufoff)/bytes);
-        size_t wanted = (maximum-(pos-offset))*bytes;
-        wanted = wanted < available ? wanted : available;
-        memcpy(&(buffer[pos]),&(_buffer[_bufoff]),wanted);
-        _bufoff += (Sint32)wanted;
-        pos += (unsigned int)(wanted/bytes);
-    }
-    for(int ii = (int)offset; ii < pos; ii++) {
-        buffer[ii] = marshall(buffer[ii]);
-    }
-    
-    return pos-offset;
+    return readArray((Uint8*)(buffer+offset), maximum, 8, true);
 }
 
+
+#pragma mark -
+#pragma mark Buffer Views
+/**
+ * Returns a view of the next bytes in the stream, without copying them.
+ *
+ * The view is a pointer into the internal buffer of this reader, and the
+ * stream advances past the bytes viewed.  The bytes are raw, and so any
+ * multibyte values are still in network order.  Use the array versions
+ * of {@link marshall} to decode them.
+ *
+ * The view is only valid until the next read (or reset) of this stream.
+ * This method returns nullptr, without advancing the stream, if there are
+ * fewer than the given number of bytes remaining, or if the number of
+ * bytes exceeds the buffer capacity.
+ *
+ * @param bytes The number of bytes to view
+ *
+ * @return a view of the next bytes in the stream
+ */
+const Uint8* BinaryReader::readView(size_t bytes) {
+    if (!_stream || bytes > _capacity) {
+        return nullptr;
+    }
+    if (_bufoff < 0 || _bufoff+bytes > _bufsize) {
+        fill((unsigned int)bytes);
+        if (_bufoff < 0 || _bufoff+bytes > _bufsize) {
+            return nullptr;
+        }
+    }
+    const Uint8* result = (const Uint8*)&(_buffer[_bufoff]);
+    _bufoff += (Sint32)bytes;
+    return result;
+}
@@ -148,6 +148,78 @@ void BinaryWriter::close() {
 }
 
 
+/**
+ * Copies count elements of the given size from src to dst.
+ *
+ * If swap is true, each element is marshalled to network order as it is
+ * copied.  The arrays should not overlap.
+ *
+ * @param dst   The destination array
+ * @param src   The source array
+ * @param count The number of elements
+ * @param size  The size of each element in bytes
+ * @param swap  Whether to marshall the elements to network order
+ */
+static void transfer(Uint8* dst, const Uint8* src, size_t count, unsigned int size, bool swap) {
+    if (!swap) {
+        memcpy(dst, src, count*size);
+        return;
+    }
+    switch (size) {
+        case 2:
+            marshall((Uint16*)dst, (const Uint16*)src, count);
+            break;
+        case 4:
+            marshall((Uint32*)dst, (const Uint32*)src, count);
+            break;
+        case 8:
+            marshall((Uint64*)dst, (const Uint64*)src, count);
+            break;
+    }
+}
+
+/**
+ * Writes a sequence of elements of the given size to the binary file.
+ *
+ * If swap is true, each element is marshalled to network order.  This is
+ * done one block at a time, as the data is copied into the buffer.  If no
+ * marshalling is needed and the array is at least the buffer capacity, the
+ * buffer is flushed and the array is written directly to the file instead.
+ *
+ * @param array     the array of elements to write
+ * @param length    the number of elements to write
+ * @param size      the size of each element in bytes
+ * @param swap      whether to marshall the elements to network order
+ */
+void BinaryWriter::writeArray(const Uint8* array, size_t length, unsigned int size, bool swap) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    swap = false;   // Network order is the native order
+#endif
+    size_t total = length*size;
+    if (!swap && total >= _capacity) {
+        if (_bufoff) {
+            flush();
+        }
+        size_t amt = SDL_RWwrite(_stream, array, 1, total);
+        CUAssertLog(amt == total, "Unable to fully write the array");
+        return;
+    }
+    
+    size_t pos = 0;
+    while (pos < length) {
+        size_t room = (_capacity-_bufoff)/size;
+        if (!room) {
+            flush();
+            room = _capacity/size;
+        }
+        size_t amt = length-pos < room ? length-pos : room;
+        transfer((Uint8*)&(_cbuffer[_bufoff]), array+pos*size, amt, size, swap);
+        _bufoff += (Sint32)(amt*size);
+        pos += amt;
+    }
+}
+
+
 #pragma mark -
 #pragma mark Single Element Writes
 /**
@@ -387,20 +459,7 @@ void BinaryWriter::writeDouble(double n) {
  */
 void BinaryWriter::write(const char* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    if (_bufoff+length > _capacity) {
-        flush();
-    }
-    while (length-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]),_capacity-_bufoff);
-        pos += _capacity-_bufoff;
-        _bufoff = _capacity;
-        flush();
-    }
-    
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), length-pos);
-    _bufoff += (Sint32)(length-pos);
+    writeArray((const Uint8*)(array+offset), length, 1, false);
 }
 
 /**
@@ -416,20 +475,7 @@ void BinaryWriter::write(const char* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Uint8* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-        
-    if (_bufoff+length > _capacity) {
-        flush();
-    }
-    while (length-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]),_capacity-_bufoff);
-        pos += _capacity-_bufoff;
-        _bufoff = _capacity;
-        flush();
-    }
-        
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), length-pos);
-    _bufoff += (Sint32)(length-pos);
+    writeArray((const Uint8*)(array+offset), length, 1, false);
 }
 
 /**
@@ -448,34 +494,7 @@ void BinaryWriter::write(const Uint8* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Sint16* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 2;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Sint16* ref = (Sint16*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Sint16* ref = (Sint16*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 2, true);
 }
 
 /**
@@ -494,34 +513,7 @@ void BinaryWriter::write(const Sint16* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Uint16* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 2;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Uint16* ref = (Uint16*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Uint16* ref = (Uint16*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 2, true);
 }
 
 /**
@@ -540,34 +532,7 @@ void BinaryWriter::write(const Uint16* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Sint32* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 4;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Sint32* ref = (Sint32*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Sint32* ref = (Sint32*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 4, true);
 }
 
 
@@ -587,34 +552,7 @@ void BinaryWriter::write(const Sint32* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Uint32* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 4;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Uint32* ref = (Uint32*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Uint32* ref = (Uint32*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 4, true);
 }
 
 
@@ -634,34 +572,7 @@ void BinaryWriter::write(const Uint32* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Sint64* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 8;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Sint64* ref = (Sint64*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Sint64* ref = (Sint64*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 8, true);
 }
 
 
@@ -681,34 +592,7 @@ void BinaryWriter::write(const Sint64* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const Uint64* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 8;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            Uint64* ref = (Uint64*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        Uint64* ref = (Uint64*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 8, true);
 }
 
 
@@ -728,34 +612,7 @@ void BinaryWriter::write(const Uint64* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const float* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 4;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            float* ref = (float*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        float* ref = (float*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 4, true);
 }
 
 /**
@@ -774,32 +631,5 @@ void BinaryWriter::write(const float* array, size_t length, size_t offset) {
  */
 void BinaryWriter::write(const double* array, size_t length, size_t offset) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    
-    unsigned int bytes = 8;
-    if (_bufoff+length*bytes > _capacity) {
-        flush();
-    }
-    while ((length-pos)*bytes > _capacity-_bufoff) {
-        unsigned int skip = bytes*((_capacity-_bufoff)/bytes);
-        memcpy(&(_cbuffer[_bufoff]), &(array[pos]),skip);
-        
-        for(int ii = 0; ii < skip; ii += bytes) {
-            double* ref = (double*)(&_cbuffer[_bufoff+ii]);
-            *ref = marshall(*ref);
-        }
-        
-        pos += skip/bytes;
-        _bufoff += skip;
-        flush();
-    }
-    
-    unsigned int skip = (unsigned int)((length-pos)*bytes);
-    memcpy(&(_cbuffer[_bufoff]), &(array[pos+offset]), skip);
-    for(int ii = 0; ii < skip; ii += bytes) {
-        double* ref = (double*)(&_cbuffer[_bufoff+ii]);
-        *ref = marshall(*ref);
-    }
-    
-    _bufoff += skip;
+    writeArray((const Uint8*)(array+offset), length, 8, true);
 }
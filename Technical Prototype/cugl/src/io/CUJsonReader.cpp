@@ -100,19 +100,37 @@ std::string JsonReader::readJsonString() {
 /**
  * Returns a newly allocated JsonValue for the next available JSON string.
  *
- * This method uses {@link readJsonString()} to extract the next available
- * JSON string and constructs a JsonValue from that.
+ * A JSON string is defined to be any string within matching braces {}. This
+ * method will skip over any whitespace to find the first brace.  If the
+ * first non-whitespace character is not a brace, this method will fail.
+ *
+ * The remainder of the file is read into memory with a single read, and
+ * the JsonValue is parsed in place from that buffer.  There is no
+ * intermediate string or cJSON tree.  The read head is left just after
+ * the closing brace.
  *
  * If there is a parsing error, this  method will return nullptr.  Detailed
  * information about the parsing error will be passed to an assert.  Hence
- * error messages are suppressed if asserts are turned off.
+ * error messages are suppressed if asserts are turned off.  In that case
+ * the remainder of the stream is discarded.
  *
  * @return a newly allocated JsonValue for the next available JSON string.
  */
 std::shared_ptr<JsonValue> JsonReader::readJson() {
-    std::string data = readJsonString();
-    if (!data.empty()) {
-        return JsonValue::allocWithJson(data);
+    CUAssertLog(ready(), "Attempt to read a finished stream");
+    fillAll();
+    skip();
+    
+    // Make sure first character a bracket
+    CUAssertLog(_sbuffer[_bufoff] == '{', "JSON is missing initial {");
+    
+    size_t consumed = 0;
+    std::shared_ptr<JsonValue> result;
+    result = JsonValue::allocWithJson(_sbuffer.data()+_bufoff, _sbuffer.size()-_bufoff, &consumed);
+    if (result) {
+        _bufoff += (Sint32)consumed;
+    } else {
+        _bufoff = (Sint32)_sbuffer.size();
     }
-    return nullptr;
+    return result;
 }
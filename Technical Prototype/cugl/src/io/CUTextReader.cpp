@@ -47,6 +47,7 @@
 //  Version: 11/22/16
 //
 #include <cugl/io/CUTextReader.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/base/CUApplication.h>
 #include <utf8/utf8.h>
@@ -94,7 +95,7 @@ bool TextReader::init(const Pathname& file) {
 bool TextReader::init(const Pathname& file, unsigned int capacity) {
     CUAssertLog(capacity, "The buffer capacity must be positive");
     _name = file.getAbsoluteName();
-    _stream = SDL_RWFromFile(_name.c_str(), "r");
+    _stream = AssetArchive::openFile(_name, "r");
     if (!_stream) {
         return false;
     }
@@ -160,7 +161,7 @@ bool TextReader::initWithAsset(const char* file, unsigned int capacity) {
 	}
 #endif
 
-    _stream = SDL_RWFromFile(_name.c_str(), "r");
+    _stream = AssetArchive::openFile(_name, "r");
     if (!_stream) {
         return false;
     }
@@ -188,7 +189,7 @@ void TextReader::reset() {
     if (_stream) {
         close();
     }
-    _stream = SDL_RWFromFile(_name.c_str(), "r");
+    _stream = AssetArchive::openFile(_name, "r");
     _ssize  = SDL_RWsize(_stream);
     _cbuffer = new char[_capacity];
     _sbuffer.clear();
@@ -233,6 +234,42 @@ void TextReader::fill() {
     _scursor += amt;
 }
 
+/**
+ * Reads the remainder of the stream into the storage buffer
+ *
+ * If the size of the stream is known, the data is read directly into the
+ * storage buffer with a single read.  Afterwards, the stream is exhausted
+ * and all unread data is available in the storage buffer.
+ */
+void TextReader::fillAll() {
+    if (!_stream || _scursor == _ssize) {
+        return;
+    } else if (_bufoff > 0) {
+        _sbuffer.erase(_sbuffer.begin(), _sbuffer.begin() + _bufoff);
+    }
+    
+    _bufoff = 0;
+    if (_ssize > _scursor) {
+        size_t start = _sbuffer.size();
+        _sbuffer.resize(start+(size_t)(_ssize-_scursor));
+        size_t amt = SDL_RWread(_stream, &_sbuffer[start], 1, _sbuffer.size()-start);
+        _sbuffer.resize(start+amt);
+        _scursor += amt;
+        if (amt == 0) {
+            _ssize = _scursor;  // Truncated stream
+        }
+    } else {
+        // Size is unknown; read in chunks until the stream is empty
+        size_t amt = 0;
+        do {
+            amt = SDL_RWread(_stream, _cbuffer, 1, _capacity);
+            _sbuffer.append(_cbuffer,amt);
+            _scursor += amt;
+        } while (amt > 0);
+        _ssize = _scursor;
+    }
+}
+
 #pragma mark -
 #pragma mark Read Methods
 /**
@@ -399,15 +436,9 @@ std::string TextReader::readAll() {
  */
 std::string& TextReader::readAll(std::string& data) {
     CUAssertLog(ready(), "Attempt to read a finished stream");
-    if (_bufoff >= _sbuffer.size()) {
-        fill();
-    }
-    
-    while (ready()) {
-        data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
-        _bufoff = (Sint32)_sbuffer.size();
-        fill();
-    }
+    fillAll();
+    data.append(_sbuffer.begin()+_bufoff,_sbuffer.end());
+    _bufoff = (Sint32)_sbuffer.size();
     return data;
 }
 
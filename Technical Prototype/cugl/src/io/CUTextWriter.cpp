@@ -172,22 +172,7 @@ void TextWriter::write(char c) {
  * @param s  the string to write
  */
 void TextWriter::write(const char* s) {
-    CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    size_t len = strlen(s);
-
-    if (_bufoff+len >  _capacity) {
-        flush();
-    }
-    while (len-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(s[pos]),_capacity-_bufoff);
-        pos += _capacity-_bufoff;
-        _bufoff = _capacity;
-        flush();
-    }
-
-    memcpy(&(_cbuffer[_bufoff]), &(s[pos]), len-pos);
-    _bufoff += (Sint32)(len-pos);
+    write(s, strlen(s));
 }
 
 /**
@@ -200,20 +185,34 @@ void TextWriter::write(const char* s) {
  * @param s  the string to write
  */
 void TextWriter::write(const std::string& s) {
+    write(s.c_str(), s.size());
+}
+
+/**
+ * Writes the first length characters of a string (ASCII or UTF8) to the file
+ *
+ * The value is written to the internal buffer, but is not necessarily
+ * flushed automatically.  It will be written when the buffer reaches
+ * capacity or the file is closed.
+ *
+ * @param s         the string to write
+ * @param length    the number of characters to write
+ */
+void TextWriter::write(const char* s, size_t length) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
     size_t pos = 0;
-    if (_bufoff+s.size() > _capacity) {
+    if (_bufoff+length > _capacity) {
         flush();
     }
-    while (s.size()-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(s.c_str()[pos]), _capacity-_bufoff);
+    while (length-pos > _capacity-_bufoff) {
+        memcpy(&(_cbuffer[_bufoff]), &(s[pos]), _capacity-_bufoff);
         pos += _capacity-_bufoff;
         _bufoff = _capacity;
         flush();
     }
 
-    memcpy(&(_cbuffer[_bufoff]), &(s.c_str()[pos]), s.size()-pos);
-    _bufoff += (Sint32)(s.size()-pos);
+    memcpy(&(_cbuffer[_bufoff]), &(s[pos]), length-pos);
+    _bufoff += (Sint32)(length-pos);
 }
 
 /**
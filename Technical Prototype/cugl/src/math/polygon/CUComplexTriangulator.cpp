@@ -0,0 +1,742 @@
+//
+//  CUComplexTriangulator.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a factory for a sweep-line triangulator.  Unlike the ear
+//  clipping SimpleTriangulator, it supports polygons with holes, and it runs
+//  in O(n log n) time.  It splits the polygon into y-monotone pieces with a
+//  plane sweep, and then triangulates each piece in linear time.  It can also
+//  refine the result into a constrained Delaunay triangulation, which avoids
+//  long thin triangles.
+//
+//  Because math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  The monotone partition follows de Berg et al., Computational Geometry:
+//  Algorithms and Applications, Chapter 3.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <set>
+#include <cmath>
+
+/** Packs a directed edge into a single key */
+#define EDGE_KEY(a,b) (((Uint64)(a) << 32) | (Uint64)(b))
+
+using namespace cugl;
+
+/**
+ * Returns twice the signed area of the triangle abc.
+ *
+ * The area is positive if the triangle is counter-clockwise.
+ *
+ * @param a The first vertex
+ * @param b The second vertex
+ * @param c The third vertex
+ *
+ * @return twice the signed area of the triangle abc.
+ */
+static inline double orient(const Vec2& a, const Vec2& b, const Vec2& c) {
+    return ((double)b.x-a.x)*((double)c.y-a.y)-((double)b.y-a.y)*((double)c.x-a.x);
+}
+
+/**
+ * Returns true if d is strictly inside the circumcircle of abc.
+ *
+ * The triangle abc must be counter-clockwise.
+ *
+ * @param a The first triangle vertex
+ * @param b The second triangle vertex
+ * @param c The third triangle vertex
+ * @param d The point to test
+ *
+ * @return true if d is strictly inside the circumcircle of abc.
+ */
+static bool in_circle(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& d) {
+    double adx = (double)a.x-d.x, ady = (double)a.y-d.y;
+    double bdx = (double)b.x-d.x, bdy = (double)b.y-d.y;
+    double cdx = (double)c.x-d.x, cdy = (double)c.y-d.y;
+    double det = (adx*adx+ady*ady)*(bdx*cdy-cdx*bdy)
+               - (bdx*bdx+bdy*bdy)*(adx*cdy-cdx*ady)
+               + (cdx*cdx+cdy*cdy)*(adx*bdy-bdx*ady);
+    return det > 0;
+}
+
+#pragma mark -
+#pragma mark Calculation
+/**
+ * Performs a triangulation of the current vertex data.
+ */
+void ComplexTriangulator::calculate() {
+    reset();
+    if (_loops.empty() || _loops[0] < 3) {
+        _calculated = true;
+        return;
+    }
+
+    computeLoops();
+    _links.resize(_input.size());
+    computeMonotone();
+    computeFaces();
+    if (_delaunay) {
+        computeDelaunay();
+    }
+    trimColinear();
+    _links.clear();
+    _calculated = true;
+}
+
+#pragma mark -
+#pragma mark Materialization
+/**
+ * Returns a list of indices representing the triangulation.
+ *
+ * The indices represent positions in the original vertex list, followed
+ * by the vertices of each hole.  If you have modified that list, these
+ * indices may no longer be valid.
+ *
+ * The triangulator does not retain a reference to the returned list; it
+ * is safe to modify it.
+ *
+ * If the calculation is not yet performed, this method will return the
+ * empty list.
+ *
+ * @return a list of indices representing the triangulation.
+ */
+std::vector<unsigned short> ComplexTriangulator::getTriangulation() {
+    std::vector<unsigned short> result;
+    getTriangulation(result);
+    return result;
+}
+
+/**
+ * Stores the triangulation indices in the given buffer.
+ *
+ * The indices represent positions in the original vertex list, followed
+ * by the vertices of each hole.  If you have modified that list, these
+ * indices may no longer be valid.
+ *
+ * The indices will be appended to the provided vector. You should clear
+ * the vector first if you do not want to preserve the original data.
+ *
+ * If the calculation is not yet performed, this method will do nothing.
+ *
+ * @return the number of elements added to the buffer
+ */
+size_t ComplexTriangulator::getTriangulation(std::vector<unsigned short>& buffer) {
+    if (_calculated) {
+        CUAssertLog(_input.size() <= 65536, "Too many vertices for Poly2 indices");
+        buffer.reserve(buffer.size()+_output.size());
+        for(auto it = _output.begin(); it != _output.end(); ++it) {
+            buffer.push_back((unsigned short)*it);
+        }
+        return _output.size();
+    }
+    return 0;
+}
+
+/**
+ * Returns a polygon representing the triangulation.
+ *
+ * The polygon contains the original vertices (followed by the vertices
+ * of each hole) together with the new indices defining a solid shape.
+ * The triangulator does not maintain references to this polygon and it
+ * is safe to modify it.
+ *
+ * If the calculation is not yet performed, this method will return the
+ * empty polygon.
+ *
+ * @return a polygon representing the triangulation.
+ */
+Poly2 ComplexTriangulator::getPolygon() {
+    Poly2 poly;
+    getPolygon(&poly);
+    return poly;
+}
+
+/**
+ * Stores the triangulation in the given buffer.
+ *
+ * This method will add both the original vertices (followed by the
+ * vertices of each hole), and the corresponding indices to the new
+ * buffer.  If the buffer is not empty, the indices will be adjusted
+ * accordingly. You should clear the buffer first if you do not want to
+ * preserve the original data.
+ *
+ * If the calculation is not yet performed, this method will do nothing.
+ *
+ * @param buffer    The buffer to store the triangulated polygon
+ *
+ * @return a reference to the buffer for chaining.
+ */
+Poly2* ComplexTriangulator::getPolygon(Poly2* buffer) {
+    CUAssertLog(buffer, "Destination buffer is null");
+    if (_calculated) {
+        int offset = (int)buffer->_vertices.size();
+        CUAssertLog(offset+_input.size() <= 65536, "Too many vertices for Poly2 indices");
+        buffer->_vertices.reserve(offset+_input.size());
+        std::copy(_input.begin(),_input.end(),std::back_inserter(buffer->_vertices));
+
+        buffer->_indices.reserve(buffer->_indices.size()+_output.size());
+        for(auto it = _output.begin(); it != _output.end(); ++it) {
+            buffer->_indices.push_back((unsigned short)(offset+*it));
+        }
+        buffer->_type = Poly2::Type::SOLID;
+        buffer->computeBounds();
+    }
+    return buffer;
+}
+
+#pragma mark -
+#pragma mark Internal Data Generation
+/**
+ * Returns true if edge a is left of edge b at the current sweep line.
+ *
+ * The index -1 represents the current sweep point.
+ *
+ * @param a The first edge
+ * @param b The second edge
+ *
+ * @return true if edge a is left of edge b at the current sweep line.
+ */
+bool ComplexTriangulator::EdgeOrder::operator()(int a, int b) const {
+    if (a == b) {
+        return false;
+    }
+    float xa = (a < 0 ? owner->_sweep.x : owner->intercept(a));
+    float xb = (b < 0 ? owner->_sweep.x : owner->intercept(b));
+    if (xa != xb) {
+        return xa < xb;
+    } else if (a < 0 || b < 0) {
+        // The sweep point is left of any edge through it
+        return a < 0;
+    }
+
+    // Edges meeting at the sweep line are ordered by direction
+    const std::vector<Vec2>& input = owner->_input;
+    const Vec2& a1 = input[a];
+    const Vec2& a2 = input[owner->_next[a]];
+    const Vec2& b1 = input[b];
+    const Vec2& b2 = input[owner->_next[b]];
+    double cross = ((double)a2.x-a1.x)*((double)b2.y-b1.y)-((double)a2.y-a1.y)*((double)b2.x-b1.x);
+    if (cross != 0) {
+        return cross > 0;
+    }
+    return a < b;
+}
+
+/**
+ * Returns the x-coordinate of the given edge at the current sweep line.
+ *
+ * The edge is identified by its first vertex.
+ *
+ * @param edge  The edge to intersect with the sweep line
+ *
+ * @return the x-coordinate of the given edge at the current sweep line.
+ */
+float ComplexTriangulator::intercept(int edge) const {
+    const Vec2& p = _input[edge];
+    const Vec2& q = _input[_next[edge]];
+    if (p.y == q.y) {
+        // Horizontal edges are tilted slightly by the sweep order
+        return std::min(std::max(_sweep.x, std::min(p.x, q.x)), std::max(p.x, q.x));
+    }
+    float t = (_sweep.y-p.y)/(q.y-p.y);
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    return p.x+t*(q.x-p.x);
+}
+
+/**
+ * Links the vertex loops so that the interior is always on the left.
+ *
+ * This method fills the arrays _next and _prev, reversing any loops that
+ * have the wrong orientation.
+ */
+void ComplexTriangulator::computeLoops() {
+    _next.resize(_input.size());
+    _prev.resize(_input.size());
+
+    Uint32 start = 0;
+    for(size_t ii = 0; ii < _loops.size(); ii++) {
+        Uint32 count = _loops[ii];
+        if (count < 3) {
+            // Degenerate holes are ignored
+            for(Uint32 jj = 0; jj < count; jj++) {
+                _next[start+jj] = _prev[start+jj] = start+jj;
+            }
+            start += count;
+            continue;
+        }
+
+        double area = 0;
+        for(Uint32 jj = 0; jj < count; jj++) {
+            const Vec2& p = _input[start+jj];
+            const Vec2& q = _input[start+(jj+1)%count];
+            area += (double)p.x*q.y-(double)q.x*p.y;
+        }
+
+        // The boundary is counter-clockwise and the holes are clockwise
+        bool forward = (ii == 0 ? area >= 0 : area <= 0);
+        for(Uint32 jj = 0; jj < count; jj++) {
+            Uint32 succ = start+(jj+1)%count;
+            Uint32 pred = start+(jj+count-1)%count;
+            _next[start+jj] = (forward ? succ : pred);
+            _prev[start+jj] = (forward ? pred : succ);
+        }
+        start += count;
+    }
+}
+
+/**
+ * Returns the classification of the given vertex for the plane sweep.
+ *
+ * @param index The vertex index
+ *
+ * @return the classification of the given vertex for the plane sweep.
+ */
+ComplexTriangulator::VertexType ComplexTriangulator::classifyVertex(Uint32 index) const {
+    Uint32 prev = _prev[index];
+    Uint32 next = _next[index];
+    bool prevAbove = above(prev, index);
+    bool nextAbove = above(next, index);
+    if (prevAbove != nextAbove) {
+        return VertexType::REGULAR;
+    }
+
+    bool convex = orient(_input[prev], _input[index], _input[next]) > 0;
+    if (prevAbove) {
+        return convex ? VertexType::END : VertexType::MERGE;
+    }
+    return convex ? VertexType::START : VertexType::SPLIT;
+}
+
+/**
+ * Adds a diagonal between the two given vertices.
+ *
+ * @param a The first vertex index
+ * @param b The second vertex index
+ */
+void ComplexTriangulator::addDiagonal(Uint32 a, Uint32 b) {
+    if (a == b || _next[a] == b || _prev[a] == b) {
+        return;
+    }
+    for(auto it = _links[a].begin(); it != _links[a].end(); ++it) {
+        if (it->vertex == b) {
+            return;
+        }
+    }
+    _links[a].push_back({b, false});
+    _links[b].push_back({a, false});
+}
+
+/**
+ * Partitions the polygon into y-monotone pieces.
+ *
+ * This is the plane sweep.  It adds diagonals between vertices so that
+ * every face of the result is y-monotone.
+ */
+void ComplexTriangulator::computeMonotone() {
+    size_t size = _input.size();
+    std::vector<Uint32> events;
+    std::vector<VertexType> types(size, VertexType::REGULAR);
+    events.reserve(size);
+    for(Uint32 ii = 0; ii < size; ii++) {
+        if (_next[ii] != ii) {
+            events.push_back(ii);
+            types[ii] = classifyVertex(ii);
+        }
+    }
+    std::sort(events.begin(), events.end(), [this](Uint32 a, Uint32 b) { return above(a, b); });
+
+    // The status holds the edges with the interior on their right
+    EdgeOrder order;
+    order.owner = this;
+    typedef std::set<int, EdgeOrder> Status;
+    Status status(order);
+    std::vector<Status::iterator> position(size, status.end());
+    std::vector<Uint32> helper(size, 0);
+
+    // Returns the edge directly left of the sweep point (or -1 if none)
+    auto left = [&status]() {
+        auto it = status.lower_bound(-1);
+        return (it == status.begin() ? -1 : *(--it));
+    };
+
+    for(auto it = events.begin(); it != events.end(); ++it) {
+        Uint32 v = *it;
+        Uint32 prev = _prev[v];
+        _sweep = _input[v];
+
+        switch (types[v]) {
+            case VertexType::START:
+                position[v] = status.insert(v).first;
+                helper[v] = v;
+                break;
+            case VertexType::END:
+                if (types[helper[prev]] == VertexType::MERGE) {
+                    addDiagonal(v, helper[prev]);
+                }
+                if (position[prev] != status.end()) {
+                    status.erase(position[prev]);
+                    position[prev] = status.end();
+                }
+                break;
+            case VertexType::SPLIT:
+            {
+                int edge = left();
+                if (edge >= 0) {
+                    addDiagonal(v, helper[edge]);
+                    helper[edge] = v;
+                }
+                position[v] = status.insert(v).first;
+                helper[v] = v;
+                break;
+            }
+            case VertexType::MERGE:
+            {
+                if (types[helper[prev]] == VertexType::MERGE) {
+                    addDiagonal(v, helper[prev]);
+                }
+                if (position[prev] != status.end()) {
+                    status.erase(position[prev]);
+                    position[prev] = status.end();
+                }
+                int edge = left();
+                if (edge >= 0) {
+                    if (types[helper[edge]] == VertexType::MERGE) {
+                        addDiagonal(v, helper[edge]);
+                    }
+                    helper[edge] = v;
+                }
+                break;
+            }
+            case VertexType::REGULAR:
+                if (above(prev, v)) {
+                    // The interior is to the right
+                    if (types[helper[prev]] == VertexType::MERGE) {
+                        addDiagonal(v, helper[prev]);
+                    }
+                    if (position[prev] != status.end()) {
+                        status.erase(position[prev]);
+                        position[prev] = status.end();
+                    }
+                    position[v] = status.insert(v).first;
+                    helper[v] = v;
+                } else {
+                    int edge = left();
+                    if (edge >= 0) {
+                        if (types[helper[edge]] == VertexType::MERGE) {
+                            addDiagonal(v, helper[edge]);
+                        }
+                        helper[edge] = v;
+                    }
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * Triangulates every face of the monotone partition.
+ *
+ * This method traces each face with the interior on the left, and sends
+ * it to {@link triangulateMonotone}.
+ */
+void ComplexTriangulator::computeFaces() {
+    size_t size = _input.size();
+    std::vector<bool> traced(size, false);
+    std::vector<Uint32> face;
+
+    // Marks the directed edge a->b as traced
+    auto mark = [&](Uint32 a, Uint32 b) {
+        if (_next[a] == b) {
+            traced[a] = true;
+            return;
+        }
+        for(auto it = _links[a].begin(); it != _links[a].end(); ++it) {
+            if (it->vertex == b) {
+                it->traced = true;
+                return;
+            }
+        }
+    };
+
+    // Returns the sharpest left turn at b, arriving from a
+    auto turn = [&](Uint32 a, Uint32 b) {
+        const Vec2& origin = _input[b];
+        double back = atan2((double)_input[a].y-origin.y, (double)_input[a].x-origin.x);
+        Uint32 best = _next[b];
+        double bestAngle = 2*M_PI;
+        for(int ii = -1; ii < (int)_links[b].size(); ii++) {
+            Uint32 c = (ii < 0 ? _next[b] : _links[b][ii].vertex);
+            if (c == a) {
+                continue;
+            }
+            double angle = back-atan2((double)_input[c].y-origin.y, (double)_input[c].x-origin.x);
+            if (angle <= 0) {
+                angle += 2*M_PI;
+            }
+            if (angle < bestAngle) {
+                bestAngle = angle;
+                best = c;
+            }
+        }
+        return best;
+    };
+
+    // Traces the face to the left of a->b
+    auto trace = [&](Uint32 a, Uint32 b) {
+        face.clear();
+        Uint32 u = a, v = b;
+        do {
+            mark(u, v);
+            face.push_back(u);
+            Uint32 w = turn(u, v);
+            u = v;
+            v = w;
+        } while ((u != a || v != b) && face.size() <= size);
+        triangulateMonotone(face);
+    };
+
+    for(Uint32 ii = 0; ii < size; ii++) {
+        if (_next[ii] == ii) {
+            continue;
+        }
+        if (!traced[ii]) {
+            trace(ii, _next[ii]);
+        }
+        for(size_t jj = 0; jj < _links[ii].size(); jj++) {
+            if (!_links[ii][jj].traced) {
+                trace(ii, _links[ii][jj].vertex);
+            }
+        }
+    }
+}
+
+/**
+ * Triangulates a single y-monotone face, adding it to the output.
+ *
+ * @param face  The face vertices, with the interior on the left
+ */
+void ComplexTriangulator::triangulateMonotone(const std::vector<Uint32>& face) {
+    size_t count = face.size();
+    if (count < 3) {
+        return;
+    } else if (count == 3) {
+        addTriangle(face[0], face[1], face[2]);
+        return;
+    }
+
+    size_t top = 0, bot = 0;
+    for(size_t ii = 1; ii < count; ii++) {
+        if (above(face[ii], face[top])) {
+            top = ii;
+        }
+        if (above(face[bot], face[ii])) {
+            bot = ii;
+        }
+    }
+
+    // Merge the chains.  Going forward from the top is the left chain.
+    std::vector<Uint32> order;
+    std::vector<bool> leftside;
+    order.reserve(count);
+    leftside.reserve(count);
+    order.push_back(face[top]);
+    leftside.push_back(true);
+    size_t lpos = (top+1) % count;
+    size_t rpos = (top+count-1) % count;
+    while (lpos != bot || rpos != bot) {
+        if (lpos != bot && (rpos == bot || above(face[lpos], face[rpos]))) {
+            order.push_back(face[lpos]);
+            leftside.push_back(true);
+            lpos = (lpos+1) % count;
+        } else {
+            order.push_back(face[rpos]);
+            leftside.push_back(false);
+            rpos = (rpos+count-1) % count;
+        }
+    }
+    order.push_back(face[bot]);
+    leftside.push_back(false);
+
+    std::vector<size_t> stack;
+    stack.reserve(count);
+    stack.push_back(0);
+    stack.push_back(1);
+    for(size_t jj = 2; jj+1 < count; jj++) {
+        if (leftside[jj] != leftside[stack.back()]) {
+            for(size_t kk = 0; kk+1 < stack.size(); kk++) {
+                addTriangle(order[jj], order[stack[kk]], order[stack[kk+1]]);
+            }
+            stack.clear();
+            stack.push_back(jj-1);
+            stack.push_back(jj);
+        } else {
+            size_t last = stack.back();
+            stack.pop_back();
+            while (!stack.empty()) {
+                // The diagonal is inside if the chain bends away from it
+                double side = orient(_input[order[stack.back()]], _input[order[jj]], _input[order[last]]);
+                if (leftside[jj] ? side >= 0 : side <= 0) {
+                    break;
+                }
+                addTriangle(order[jj], order[last], order[stack.back()]);
+                last = stack.back();
+                stack.pop_back();
+            }
+            stack.push_back(last);
+            stack.push_back(jj);
+        }
+    }
+
+    for(size_t kk = 0; kk+1 < stack.size(); kk++) {
+        addTriangle(order[count-1], order[stack[kk]], order[stack[kk+1]]);
+    }
+}
+
+/**
+ * Adds the given triangle to the output, oriented counter-clockwise.
+ *
+ * @param a The first vertex index
+ * @param b The second vertex index
+ * @param c The third vertex index
+ */
+void ComplexTriangulator::addTriangle(Uint32 a, Uint32 b, Uint32 c) {
+    _output.push_back(a);
+    if (orient(_input[a], _input[b], _input[c]) < 0) {
+        _output.push_back(c);
+        _output.push_back(b);
+    } else {
+        _output.push_back(b);
+        _output.push_back(c);
+    }
+}
+
+/**
+ * Flips interior edges until the triangulation is Delaunay.
+ *
+ * Boundary edges are never flipped, so the result is a constrained
+ * Delaunay triangulation.
+ */
+void ComplexTriangulator::computeDelaunay() {
+    size_t count = _output.size()/3;
+    std::unordered_map<Uint64, Uint32> edges;
+    edges.reserve(3*count);
+    for(Uint32 tt = 0; tt < count; tt++) {
+        for(int kk = 0; kk < 3; kk++) {
+            edges[EDGE_KEY(_output[3*tt+kk], _output[3*tt+(kk+1)%3])] = tt;
+        }
+    }
+
+    // Only interior edges (those with a triangle on each side) may flip
+    std::vector<Uint64> pending;
+    pending.reserve(edges.size()/2);
+    for(auto it = edges.begin(); it != edges.end(); ++it) {
+        Uint32 a = (Uint32)(it->first >> 32);
+        Uint32 b = (Uint32)(it->first & 0xffffffff);
+        if (a < b && edges.find(EDGE_KEY(b, a)) != edges.end()) {
+            pending.push_back(it->first);
+        }
+    }
+
+    // Returns the vertex of triangle t opposite the edge a-b
+    auto opposite = [this](Uint32 t, Uint32 a, Uint32 b) {
+        for(int kk = 0; kk < 3; kk++) {
+            Uint32 v = _output[3*t+kk];
+            if (v != a && v != b) {
+                return v;
+            }
+        }
+        return a;
+    };
+
+    // Cocircular inputs could flip forever with round-off, so cap the work
+    size_t budget = 16*count+64;
+    while (!pending.empty() && budget > 0) {
+        budget--;
+        Uint64 key = pending.back();
+        pending.pop_back();
+        Uint32 a = (Uint32)(key >> 32);
+        Uint32 b = (Uint32)(key & 0xffffffff);
+        auto first  = edges.find(EDGE_KEY(a, b));
+        auto second = edges.find(EDGE_KEY(b, a));
+        if (first == edges.end() || second == edges.end()) {
+            continue;
+        }
+
+        Uint32 t1 = first->second;
+        Uint32 t2 = second->second;
+        Uint32 c = opposite(t1, a, b);
+        Uint32 d = opposite(t2, b, a);
+        const Vec2& pa = _input[a];
+        const Vec2& pb = _input[b];
+        const Vec2& pc = _input[c];
+        const Vec2& pd = _input[d];
+        if (!in_circle(pa, pb, pc, pd) ||
+            orient(pa, pd, pc) <= 0 || orient(pd, pb, pc) <= 0) {
+            continue;
+        }
+
+        // Replace (a,b,c) and (b,a,d) with (a,d,c) and (d,b,c)
+        _output[3*t1] = a; _output[3*t1+1] = d; _output[3*t1+2] = c;
+        _output[3*t2] = d; _output[3*t2+1] = b; _output[3*t2+2] = c;
+        edges.erase(first);
+        edges.erase(EDGE_KEY(b, a));
+        edges[EDGE_KEY(a, d)] = t1;
+        edges[EDGE_KEY(d, c)] = t1;
+        edges[EDGE_KEY(c, a)] = t1;
+        edges[EDGE_KEY(d, b)] = t2;
+        edges[EDGE_KEY(b, c)] = t2;
+        edges[EDGE_KEY(c, d)] = t2;
+
+        pending.push_back(EDGE_KEY(std::min(a, d), std::max(a, d)));
+        pending.push_back(EDGE_KEY(std::min(d, b), std::max(d, b)));
+        pending.push_back(EDGE_KEY(std::min(b, c), std::max(b, c)));
+        pending.push_back(EDGE_KEY(std::min(c, a), std::max(c, a)));
+    }
+}
+
+/**
+ * Removes any degenerate triangles from the output.
+ *
+ * Degenerate triangles can appear when the input has colinear vertices.
+ * They will crash OpenGL, so we remove them.
+ */
+void ComplexTriangulator::trimColinear() {
+    size_t keep = 0;
+    for(size_t ii = 0; ii+2 < _output.size(); ii += 3) {
+        double area = orient(_input[_output[ii]], _input[_output[ii+1]], _input[_output[ii+2]]);
+        if (fabs(area) >= 0.0000001) {
+            _output[keep  ] = _output[ii  ];
+            _output[keep+1] = _output[ii+1];
+            _output[keep+2] = _output[ii+2];
+            keep += 3;
+        }
+    }
+    _output.resize(keep);
+}
@@ -0,0 +1,298 @@
+//
+//  CUShapeCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of generated polygon geometry.  The scene
+//  graph nodes PolygonNode, PathNode, and WireNode all run a polygon factory
+//  (a triangulator, an outliner, or an extruder) whenever their shape changes.
+//  Those factories used to be static members of the node classes, which made
+//  node construction unsafe outside of the main thread.  This cache replaces
+//  them.  Each thread gets its own factories, and the results are shared as
+//  immutable polygons, keyed by the exact vertices and settings that made them.
+//
+//  This is a static class.  All of its methods are thread safe.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUShapeCache.h>
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <cstring>
+
+using namespace cugl;
+
+/** The triangulator for the current thread */
+static thread_local ComplexTriangulator _triangulator;
+/** The outliner for the current thread */
+static thread_local PathOutliner _outliner;
+/** The extruder for the current thread */
+static thread_local PathExtruder _extruder;
+
+/**
+ * Returns the FNV-1a hash of the given bytes, continuing from seed.
+ *
+ * @param data  The bytes to hash
+ * @param size  The number of bytes
+ * @param seed  The hash so far
+ *
+ * @return the FNV-1a hash of the given bytes, continuing from seed.
+ */
+static size_t hash_bytes(const void* data, size_t size, size_t seed) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t ii = 0; ii < size; ii++) {
+        seed ^= bytes[ii];
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+/** The lock guarding the cache and its statistics */
+std::mutex ShapeCache::_mutex;
+/** The cached shapes */
+std::unordered_map<ShapeCache::Key, std::shared_ptr<const Poly2>, ShapeCache::KeyHash> ShapeCache::_shapes;
+/** The number of requests answered from the cache */
+Uint32 ShapeCache::_hits = 0;
+/** The number of requests that required a factory */
+Uint32 ShapeCache::_misses = 0;
+
+#pragma mark Keys
+/**
+ * Returns true if this key is identical to the given one.
+ *
+ * @param other The key to compare
+ *
+ * @return true if this key is identical to the given one.
+ */
+bool ShapeCache::Key::operator==(const Key& other) const {
+    if (hash != other.hash || kind != other.kind || settings != other.settings ||
+        stroke != other.stroke || vertices.size() != other.vertices.size()) {
+        return false;
+    }
+    for(size_t ii = 0; ii < vertices.size(); ii++) {
+        if (vertices[ii].x != other.vertices[ii].x || vertices[ii].y != other.vertices[ii].y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns a key for the given request.
+ *
+ * @param kind      The factory used to generate the shape
+ * @param settings  The factory settings, packed into a single integer
+ * @param stroke    The stroke width (extrusions only)
+ * @param vertices  The input vertices
+ *
+ * @return a key for the given request.
+ */
+ShapeCache::Key ShapeCache::makeKey(Kind kind, int settings, float stroke,
+                                    const std::vector<Vec2>& vertices) {
+    Key key;
+    key.kind = kind;
+    key.settings = settings;
+    key.stroke = stroke;
+    key.vertices = vertices;
+
+    size_t hash = (size_t)14695981039346656037ULL;
+    hash = hash_bytes(&key.kind, sizeof(Kind), hash);
+    hash = hash_bytes(&key.settings, sizeof(int), hash);
+    hash = hash_bytes(&key.stroke, sizeof(float), hash);
+    for(auto it = vertices.begin(); it != vertices.end(); ++it) {
+        hash = hash_bytes(&(it->x), sizeof(float), hash);
+        hash = hash_bytes(&(it->y), sizeof(float), hash);
+    }
+    key.hash = hash;
+    return key;
+}
+
+/**
+ * Returns the shape for the given key, if it is cached.
+ *
+ * This method updates the statistics.
+ *
+ * @param key   The shape key
+ *
+ * @return the shape for the given key, or nullptr if it is not cached.
+ */
+std::shared_ptr<const Poly2> ShapeCache::lookup(const Key& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _shapes.find(key);
+    if (it == _shapes.end()) {
+        _misses++;
+        return nullptr;
+    }
+    _hits++;
+    return it->second;
+}
+
+/**
+ * Stores the given shape in the cache, returning the cached shape.
+ *
+ * If another thread stored a shape for this key in the meantime, that
+ * shape is returned instead, and the given one is discarded.
+ *
+ * @param key   The shape key
+ * @param shape The newly generated shape
+ *
+ * @return the shape cached for the given key.
+ */
+std::shared_ptr<const Poly2> ShapeCache::store(Key&& key, const std::shared_ptr<const Poly2>& shape) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _shapes.find(key);
+    if (it != _shapes.end()) {
+        return it->second;
+    }
+    if (_shapes.size() >= SHAPE_CACHE_CAPACITY) {
+        _shapes.clear();
+    }
+    _shapes.emplace(std::move(key), shape);
+    return shape;
+}
+
+#pragma mark -
+#pragma mark Shapes
+/**
+ * Returns the triangulation of the given vertices.
+ *
+ * The polygon is the one produced by ComplexTriangulator.  It is a SOLID
+ * polygon with the given vertices.
+ *
+ * @param vertices  The vertices to triangulate
+ *
+ * @return the triangulation of the given vertices.
+ */
+std::shared_ptr<const Poly2> ShapeCache::getSolid(const std::vector<Vec2>& vertices) {
+    Key key = makeKey(Kind::SOLID, 0, 0.0f, vertices);
+    std::shared_ptr<const Poly2> result = lookup(key);
+    if (result != nullptr) {
+        return result;
+    }
+
+    std::shared_ptr<Poly2> poly = std::make_shared<Poly2>();
+    _triangulator.set(vertices);
+    _triangulator.calculate();
+    _triangulator.getPolygon(poly.get());
+    _triangulator.reset();
+    return store(std::move(key), poly);
+}
+
+/**
+ * Returns the traversal of the given vertices.
+ *
+ * The polygon is the one produced by PathOutliner.  It is a PATH polygon
+ * with the given vertices.
+ *
+ * @param vertices  The vertices to traverse
+ * @param traversal The path traversal for index generation
+ *
+ * @return the traversal of the given vertices.
+ */
+std::shared_ptr<const Poly2> ShapeCache::getPath(const std::vector<Vec2>& vertices,
+                                                 PathTraversal traversal) {
+    Key key = makeKey(Kind::PATH, (int)traversal, 0.0f, vertices);
+    std::shared_ptr<const Poly2> result = lookup(key);
+    if (result != nullptr) {
+        return result;
+    }
+
+    std::shared_ptr<Poly2> poly = std::make_shared<Poly2>();
+    _outliner.set(vertices);
+    _outliner.calculate(traversal);
+    _outliner.getPolygon(poly.get());
+    _outliner.reset();
+    return store(std::move(key), poly);
+}
+
+/**
+ * Returns the extrusion of the given path.
+ *
+ * The polygon is the one produced by PathExtruder.  It is a SOLID polygon
+ * whose vertices are generated by the extrusion.
+ *
+ * @param vertices  The vertices of the path
+ * @param closed    Whether the path is closed
+ * @param stroke    The stroke width of the extrusion
+ * @param joint     The joint between extrusion line segments
+ * @param cap       The end caps of the extruded paths
+ *
+ * @return the extrusion of the given path.
+ */
+std::shared_ptr<const Poly2> ShapeCache::getExtrusion(const std::vector<Vec2>& vertices, bool closed,
+                                                      float stroke, PathJoint joint, PathCap cap) {
+    int settings = ((int)joint << 8) | ((int)cap << 1) | (closed ? 1 : 0);
+    Key key = makeKey(Kind::EXTRUSION, settings, stroke, vertices);
+    std::shared_ptr<const Poly2> result = lookup(key);
+    if (result != nullptr) {
+        return result;
+    }
+
+    std::shared_ptr<Poly2> poly = std::make_shared<Poly2>();
+    _extruder.set(vertices, closed);
+    _extruder.calculate(stroke, joint, cap);
+    _extruder.getPolygon(poly.get());
+    _extruder.reset();
+    return store(std::move(key), poly);
+}
+
+#pragma mark -
+#pragma mark Cache Management
+/**
+ * Empties the cache and resets the statistics.
+ *
+ * Polygons already returned to callers remain valid.
+ */
+void ShapeCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _shapes.clear();
+    _hits = 0;
+    _misses = 0;
+}
+
+/**
+ * Returns the number of shapes in the cache.
+ *
+ * @return the number of shapes in the cache.
+ */
+size_t ShapeCache::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _shapes.size();
+}
+
+/**
+ * Returns the number of requests answered from the cache.
+ *
+ * @return the number of requests answered from the cache.
+ */
+Uint32 ShapeCache::getHits() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+/**
+ * Returns the number of requests that required a polygon factory.
+ *
+ * @return the number of requests that required a polygon factory.
+ */
+Uint32 ShapeCache::getMisses() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
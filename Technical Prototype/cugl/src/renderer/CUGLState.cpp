@@ -0,0 +1,573 @@
+//
+//  CUGLState.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a cache of the OpenGL binding state.  OpenGL state
+//  changes are surprisingly expensive on mobile drivers, even when they do
+//  not actually change anything.  All of the classes in the renderer package
+//  bind programs, textures, buffers and blend state through this module,
+//  which remembers what is bound and drops any call that would not change it.
+//
+//  This module also counts the OpenGL calls made each frame (and the calls
+//  that were avoided), so that we can measure the driver overhead.
+//
+//  This is a static class.  It only supports a single OpenGL context, and it
+//  must only be used on the thread that owns that context.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/renderer/CUGLState.h>
+
+using namespace cugl;
+
+/** A binding value that matches no OpenGL object (forcing the next call) */
+#define UNKNOWN_BINDING     0xFFFFFFFF
+
+GLuint GLState::_program = UNKNOWN_BINDING;
+GLuint GLState::_unit = UNKNOWN_BINDING;
+GLuint GLState::_textures[GLSTATE_TEXTURE_UNITS] = {
+    UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING,
+    UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING
+};
+GLuint GLState::_vertexArray = UNKNOWN_BINDING;
+GLuint GLState::_arrayBuffer = UNKNOWN_BINDING;
+GLuint GLState::_elementBuffer = UNKNOWN_BINDING;
+std::unordered_map<GLuint, GLuint> GLState::_elements;
+GLuint GLState::_framebuffer = UNKNOWN_BINDING;
+
+GLenum GLState::_srcFactor = UNKNOWN_BINDING;
+GLenum GLState::_dstFactor = UNKNOWN_BINDING;
+GLenum GLState::_srcAlpha = UNKNOWN_BINDING;
+GLenum GLState::_dstAlpha = UNKNOWN_BINDING;
+GLenum GLState::_blendEquation = UNKNOWN_BINDING;
+int GLState::_blend = -1;
+int GLState::_cullFace = -1;
+int GLState::_depthTest = -1;
+int GLState::_depthMask = -1;
+GLint GLState::_viewport[4] = { -1, -1, -1, -1 };
+
+Uint32 GLState::_issued = 0;
+Uint32 GLState::_avoided = 0;
+Uint32 GLState::_frameIssued = 0;
+Uint32 GLState::_frameAvoided = 0;
+
+#pragma mark Cache Management
+/**
+ * Forgets the cached OpenGL state.
+ *
+ * After this call, the next change to each binding is always issued.
+ * This method must be called whenever a new context is created, or
+ * whenever code outside of this class has changed the OpenGL state.
+ */
+void GLState::reset() {
+    _program = UNKNOWN_BINDING;
+    _unit = UNKNOWN_BINDING;
+    for(int ii = 0; ii < GLSTATE_TEXTURE_UNITS; ii++) {
+        _textures[ii] = UNKNOWN_BINDING;
+    }
+    _vertexArray = UNKNOWN_BINDING;
+    _arrayBuffer = UNKNOWN_BINDING;
+    _elementBuffer = UNKNOWN_BINDING;
+    _elements.clear();
+    _framebuffer = UNKNOWN_BINDING;
+
+    _srcFactor = UNKNOWN_BINDING;
+    _dstFactor = UNKNOWN_BINDING;
+    _srcAlpha = UNKNOWN_BINDING;
+    _dstAlpha = UNKNOWN_BINDING;
+    _blendEquation = UNKNOWN_BINDING;
+    _blend = -1;
+    _cullFace = -1;
+    _depthTest = -1;
+    _depthMask = -1;
+    for(int ii = 0; ii < 4; ii++) {
+        _viewport[ii] = -1;
+    }
+}
+
+/**
+ * Returns a reference to the cached value for the given capability.
+ *
+ * @param cap   The OpenGL capability
+ *
+ * @return a reference to the cached value for the given capability.
+ */
+int* GLState::capability(GLenum cap) {
+    switch (cap) {
+        case GL_BLEND:
+            return &_blend;
+        case GL_CULL_FACE:
+            return &_cullFace;
+        case GL_DEPTH_TEST:
+            return &_depthTest;
+    }
+    return nullptr;
+}
+
+#pragma mark -
+#pragma mark Programs
+/**
+ * Makes the given program current (as glUseProgram).
+ *
+ * @param program   The shader program (0 for none)
+ */
+void GLState::useProgram(GLuint program) {
+    if (_program == program) {
+        _avoided++;
+        return;
+    }
+    glUseProgram(program);
+    _program = program;
+    _issued++;
+}
+
+/**
+ * Deletes the given program (as glDeleteProgram).
+ *
+ * If the program is current, the cache forgets it.
+ *
+ * @param program   The shader program
+ */
+void GLState::deleteProgram(GLuint program) {
+    if (program == 0) {
+        return;
+    }
+    glDeleteProgram(program);
+    if (_program == program) {
+        // A deleted program stays in use until replaced
+        _program = UNKNOWN_BINDING;
+    }
+}
+
+#pragma mark -
+#pragma mark Textures
+/**
+ * Selects the active texture unit (as glActiveTexture).
+ *
+ * The unit is an offset from GL_TEXTURE0.
+ *
+ * @param unit  The texture unit
+ */
+void GLState::activeTexture(GLuint unit) {
+    if (_unit == unit) {
+        _avoided++;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0+unit);
+    _unit = unit;
+    _issued++;
+}
+
+/**
+ * Binds a 2D texture to the active texture unit (as glBindTexture).
+ *
+ * @param texture   The texture (0 for none)
+ */
+void GLState::bindTexture(GLuint texture) {
+    if (_unit < GLSTATE_TEXTURE_UNITS && _textures[_unit] == texture) {
+        _avoided++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (_unit < GLSTATE_TEXTURE_UNITS) {
+        _textures[_unit] = texture;
+    }
+    _issued++;
+}
+
+/**
+ * Binds a 2D texture to the given texture unit.
+ *
+ * The unit is an offset from GL_TEXTURE0.  This method changes the
+ * active texture unit only if the binding changes.
+ *
+ * @param unit      The texture unit
+ * @param texture   The texture (0 for none)
+ */
+void GLState::bindTexture(GLuint unit, GLuint texture) {
+    if (unit < GLSTATE_TEXTURE_UNITS && _textures[unit] == texture) {
+        _avoided++;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture(texture);
+}
+
+/**
+ * Returns the 2D texture bound to the active texture unit.
+ *
+ * @return the 2D texture bound to the active texture unit.
+ */
+GLuint GLState::getTexture() {
+    if (_unit < GLSTATE_TEXTURE_UNITS && _textures[_unit] != UNKNOWN_BINDING) {
+        return _textures[_unit];
+    }
+    GLint bound = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+    _issued++;
+    return (GLuint)bound;
+}
+
+/**
+ * Deletes the given texture (as glDeleteTextures).
+ *
+ * Any texture unit bound to this texture reverts to 0.
+ *
+ * @param texture   The texture
+ */
+void GLState::deleteTexture(GLuint texture) {
+    if (texture == 0) {
+        return;
+    }
+    glDeleteTextures(1, &texture);
+    for(int ii = 0; ii < GLSTATE_TEXTURE_UNITS; ii++) {
+        if (_textures[ii] == texture) {
+            _textures[ii] = 0;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Buffers
+/**
+ * Binds the given vertex array (as glBindVertexArray).
+ *
+ * The element buffer binding is part of the vertex array state, and is
+ * restored in the cache along with the vertex array.
+ *
+ * @param array     The vertex array (0 for none)
+ */
+void GLState::bindVertexArray(GLuint array) {
+    if (_vertexArray == array) {
+        _avoided++;
+        return;
+    }
+    glBindVertexArray(array);
+    _vertexArray = array;
+    auto it = _elements.find(array);
+    _elementBuffer = (it == _elements.end() ? UNKNOWN_BINDING : it->second);
+    _issued++;
+}
+
+/**
+ * Binds the given buffer (as glBindBuffer).
+ *
+ * Only GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached.  Other
+ * targets are always issued.
+ *
+ * @param target    The buffer target
+ * @param buffer    The buffer (0 for none)
+ */
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (_arrayBuffer == buffer) {
+            _avoided++;
+            return;
+        }
+        _arrayBuffer = buffer;
+    } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        if (_elementBuffer == buffer && _vertexArray != UNKNOWN_BINDING) {
+            _avoided++;
+            return;
+        }
+        _elementBuffer = buffer;
+        if (_vertexArray != UNKNOWN_BINDING) {
+            _elements[_vertexArray] = buffer;
+        }
+    }
+    glBindBuffer(target, buffer);
+    _issued++;
+}
+
+/**
+ * Deletes the given vertex array (as glDeleteVertexArrays).
+ *
+ * If the vertex array is bound, the binding reverts to 0.
+ *
+ * @param array     The vertex array
+ */
+void GLState::deleteVertexArray(GLuint array) {
+    if (array == 0) {
+        return;
+    }
+    glDeleteVertexArrays(1, &array);
+    _elements.erase(array);
+    if (_vertexArray == array) {
+        _vertexArray = 0;
+        auto it = _elements.find(0);
+        _elementBuffer = (it == _elements.end() ? UNKNOWN_BINDING : it->second);
+    }
+}
+
+/**
+ * Deletes the given buffer (as glDeleteBuffers).
+ *
+ * Any binding to this buffer reverts to 0.
+ *
+ * @param buffer    The buffer
+ */
+void GLState::deleteBuffer(GLuint buffer) {
+    if (buffer == 0) {
+        return;
+    }
+    glDeleteBuffers(1, &buffer);
+    if (_arrayBuffer == buffer) {
+        _arrayBuffer = 0;
+    }
+    if (_elementBuffer == buffer) {
+        _elementBuffer = 0;
+    }
+    for(auto it = _elements.begin(); it != _elements.end(); ++it) {
+        if (it->second == buffer) {
+            it->second = 0;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Framebuffers
+/**
+ * Binds the given framebuffer (as glBindFramebuffer with GL_FRAMEBUFFER).
+ *
+ * Note that the default framebuffer is not always 0 (it is not on iOS).
+ * Use {@link getFramebuffer()} to find the binding to restore.
+ *
+ * @param buffer    The framebuffer
+ */
+void GLState::bindFramebuffer(GLuint buffer) {
+    if (_framebuffer == buffer) {
+        _avoided++;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, buffer);
+    _framebuffer = buffer;
+    _issued++;
+}
+
+/**
+ * Returns the currently bound framebuffer.
+ *
+ * If the binding is not known, this method queries OpenGL for it.
+ *
+ * @return the currently bound framebuffer.
+ */
+GLuint GLState::getFramebuffer() {
+    if (_framebuffer == UNKNOWN_BINDING) {
+        GLint buffer = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &buffer);
+        _framebuffer = (GLuint)buffer;
+        _issued++;
+    }
+    return _framebuffer;
+}
+
+/**
+ * Deletes the given framebuffer (as glDeleteFramebuffers).
+ *
+ * If the framebuffer is bound, the cache forgets the binding.
+ *
+ * @param buffer    The framebuffer
+ */
+void GLState::deleteFramebuffer(GLuint buffer) {
+    if (buffer == 0) {
+        return;
+    }
+    glDeleteFramebuffers(1, &buffer);
+    if (_framebuffer == buffer) {
+        _framebuffer = UNKNOWN_BINDING;
+    }
+}
+
+#pragma mark -
+#pragma mark Blending and Capabilities
+/**
+ * Sets the blend function (as glBlendFunc).
+ *
+ * The factors apply to both the color and the alpha channels.
+ *
+ * @param srcFactor The source blend factor
+ * @param dstFactor The destination blend factor
+ */
+void GLState::setBlendFunc(GLenum srcFactor, GLenum dstFactor) {
+    if (_srcFactor == srcFactor && _dstFactor == dstFactor &&
+        _srcAlpha  == srcFactor && _dstAlpha  == dstFactor) {
+        _avoided++;
+        return;
+    }
+    glBlendFunc(srcFactor, dstFactor);
+    _srcFactor = srcFactor;
+    _dstFactor = dstFactor;
+    _srcAlpha  = srcFactor;
+    _dstAlpha  = dstFactor;
+    _issued++;
+}
+
+/**
+ * Sets separate blend functions for color and alpha (as glBlendFuncSeparate).
+ *
+ * @param srcFactor The source blend factor for color
+ * @param dstFactor The destination blend factor for color
+ * @param srcAlpha  The source blend factor for alpha
+ * @param dstAlpha  The destination blend factor for alpha
+ */
+void GLState::setBlendFuncSeparate(GLenum srcFactor, GLenum dstFactor,
+                                   GLenum srcAlpha, GLenum dstAlpha) {
+    if (_srcFactor == srcFactor && _dstFactor == dstFactor &&
+        _srcAlpha  == srcAlpha  && _dstAlpha  == dstAlpha) {
+        _avoided++;
+        return;
+    }
+    glBlendFuncSeparate(srcFactor, dstFactor, srcAlpha, dstAlpha);
+    _srcFactor = srcFactor;
+    _dstFactor = dstFactor;
+    _srcAlpha  = srcAlpha;
+    _dstAlpha  = dstAlpha;
+    _issued++;
+}
+
+/**
+ * Sets the blend equation (as glBlendEquation).
+ *
+ * @param equation  The blend equation
+ */
+void GLState::setBlendEquation(GLenum equation) {
+    if (_blendEquation == equation) {
+        _avoided++;
+        return;
+    }
+    glBlendEquation(equation);
+    _blendEquation = equation;
+    _issued++;
+}
+
+/**
+ * Enables the given capability (as glEnable).
+ *
+ * Only GL_BLEND, GL_CULL_FACE and GL_DEPTH_TEST are cached.  Other
+ * capabilities are always issued.
+ *
+ * @param cap   The OpenGL capability
+ */
+void GLState::enable(GLenum cap) {
+    int* value = capability(cap);
+    if (value != nullptr && *value == 1) {
+        _avoided++;
+        return;
+    }
+    glEnable(cap);
+    if (value != nullptr) {
+        *value = 1;
+    }
+    _issued++;
+}
+
+/**
+ * Disables the given capability (as glDisable).
+ *
+ * Only GL_BLEND, GL_CULL_FACE and GL_DEPTH_TEST are cached.  Other
+ * capabilities are always issued.
+ *
+ * @param cap   The OpenGL capability
+ */
+void GLState::disable(GLenum cap) {
+    int* value = capability(cap);
+    if (value != nullptr && *value == 0) {
+        _avoided++;
+        return;
+    }
+    glDisable(cap);
+    if (value != nullptr) {
+        *value = 0;
+    }
+    _issued++;
+}
+
+/**
+ * Sets whether depth writes are enabled (as glDepthMask).
+ *
+ * @param flag  Whether depth writes are enabled
+ */
+void GLState::setDepthMask(bool flag) {
+    if (_depthMask == (flag ? 1 : 0)) {
+        _avoided++;
+        return;
+    }
+    glDepthMask(flag ? GL_TRUE : GL_FALSE);
+    _depthMask = (flag ? 1 : 0);
+    _issued++;
+}
+
+/**
+ * Sets the viewport (as glViewport).
+ *
+ * @param x         The viewport x offset
+ * @param y         The viewport y offset
+ * @param width     The viewport width
+ * @param height    The viewport height
+ */
+void GLState::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (_viewport[0] == x && _viewport[1] == y &&
+        _viewport[2] == width && _viewport[3] == height) {
+        _avoided++;
+        return;
+    }
+    glViewport(x, y, width, height);
+    _viewport[0] = x;
+    _viewport[1] = y;
+    _viewport[2] = width;
+    _viewport[3] = height;
+    _issued++;
+}
+
+/**
+ * Stores the current viewport in the given array.
+ *
+ * The array holds the x offset, y offset, width and height, in that
+ * order.  If the viewport is not known, this method queries OpenGL
+ * for it.
+ *
+ * @param viewport  The array to store the viewport
+ */
+void GLState::getViewport(GLint* viewport) {
+    if (_viewport[2] < 0) {
+        glGetIntegerv(GL_VIEWPORT, _viewport);
+        _issued++;
+    }
+    for(int ii = 0; ii < 4; ii++) {
+        viewport[ii] = _viewport[ii];
+    }
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Completes the statistics for the current frame.
+ *
+ * The counts so far become the counts reported for the last frame,
+ * and the counts for the next frame start at 0.
+ */
+void GLState::endFrame() {
+    _frameIssued = _issued;
+    _frameAvoided = _avoided;
+    _issued = 0;
+    _avoided = 0;
+}
@@ -0,0 +1,733 @@
+//
+//  CUKTXImage.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides CPU-side support for KTX (Khronos texture) containers.
+//  A KTX file stores an image that is ready to hand to OpenGL, including an
+//  optional chain of prebuilt mipmaps.  We use it to ship ETC2/EAC compressed
+//  textures, which stay compressed in GPU memory.
+//
+//  Not every platform can sample ETC2 (in particular, desktop OpenGL on the
+//  Mac cannot).  Hence this module also contains a software decoder that can
+//  expand an ETC2/EAC image (with all of its mipmaps) to RGBA8888 data.  That
+//  way a KTX asset can be used everywhere, even if it is only compressed on
+//  devices that support it.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/renderer/CUKTXImage.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/io/CUAssetArchive.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+using namespace cugl;
+
+// Desktop OpenGL headers (OS X in particular) may not define the ES3 formats
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES                            0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                     0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                0x9278
+#endif
+
+#pragma mark Support Functions
+/** The size of a KTX header (including the identifier) */
+#define KTX_HEADER_SIZE     64
+/** The endianness marker in a KTX file written in our byte order */
+#define KTX_ENDIAN_NATIVE   0x04030201
+/** The endianness marker in a KTX file written in the opposite byte order */
+#define KTX_ENDIAN_SWAPPED  0x01020304
+
+/** The 12 byte identifier at the start of every KTX 1.1 file */
+static const Uint8 KTX_IDENTIFIER[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+/** The ETC1/ETC2 intensity modifiers, indexed by table and pixel index */
+static const int ETC_MODIFIERS[8][4] = {
+    {  2,   8,  -2,   -8 }, {  5,  17,  -5,  -17 },
+    {  9,  29,  -9,  -29 }, { 13,  42, -13,  -42 },
+    { 18,  60, -18,  -60 }, { 24,  80, -24,  -80 },
+    { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+/** The ETC2 distances for the T and H modes */
+static const int ETC_DISTANCES[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+/** The EAC alpha modifiers, indexed by table and pixel index */
+static const int EAC_MODIFIERS[16][8] = {
+    { -3, -6,  -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 }, { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 }, { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 }, { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 }, { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 }, { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 }, { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 }, { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+/** The compressed formats supported by the OpenGL context */
+static std::unordered_set<GLenum> _supported;
+/** Whether we have queried the OpenGL context yet */
+static bool _queried = false;
+/** Guards the format cache against concurrent access */
+static std::mutex _querylock;
+
+/**
+ * Returns the value clamped to the range [0,255]
+ *
+ * @param value The value to clamp
+ *
+ * @return the value clamped to the range [0,255]
+ */
+static inline Uint8 clamp255(int value) {
+    return (Uint8)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/**
+ * Returns the 4-bit value expanded to 8 bits
+ *
+ * @param value The 4-bit value
+ *
+ * @return the 4-bit value expanded to 8 bits
+ */
+static inline int extend4(int value) { return (value << 4) | value; }
+
+/**
+ * Returns the 5-bit value expanded to 8 bits
+ *
+ * @param value The 5-bit value
+ *
+ * @return the 5-bit value expanded to 8 bits
+ */
+static inline int extend5(int value) { return (value << 3) | (value >> 2); }
+
+/**
+ * Returns the 6-bit value expanded to 8 bits
+ *
+ * @param value The 6-bit value
+ *
+ * @return the 6-bit value expanded to 8 bits
+ */
+static inline int extend6(int value) { return (value << 2) | (value >> 4); }
+
+/**
+ * Returns the 7-bit value expanded to 8 bits
+ *
+ * @param value The 7-bit value
+ *
+ * @return the 7-bit value expanded to 8 bits
+ */
+static inline int extend7(int value) { return (value << 1) | (value >> 6); }
+
+/**
+ * Returns the 32-bit integer with its bytes reversed
+ *
+ * @param value The value to swap
+ *
+ * @return the 32-bit integer with its bytes reversed
+ */
+static inline Uint32 swap32(Uint32 value) {
+    return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+           ((value >> 8) & 0xFF00) | (value >> 24);
+}
+
+/**
+ * Returns the number of bytes in a 4x4 block of the given format
+ *
+ * This function returns 0 if the format is not one we can decode.
+ *
+ * @param format    The OpenGL compressed internal format
+ *
+ * @return the number of bytes in a 4x4 block of the given format
+ */
+static size_t block_size(GLenum format) {
+    switch (format) {
+        case GL_ETC1_RGB8_OES:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+            return 8;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            return 16;
+    }
+    return 0;
+}
+
+/**
+ * Decodes an ETC1/ETC2 color block into a 4x4 RGBA block.
+ *
+ * The output is a 16 pixel array in row-major order.  If punchthrough is true,
+ * the block is decoded as GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, and so
+ * the differential bit is instead the opaque bit.  Otherwise, all alpha values
+ * are 255.  If etc1 is true, the T, H, and planar modes are disabled.
+ *
+ * @param src           The 8 byte compressed block
+ * @param dst           The 64 byte decompressed block
+ * @param punchthrough  Whether to support punchthrough alpha
+ * @param etc1          Whether to decode as ETC1
+ */
+static void decode_etc_block(const Uint8* src, Uint8* dst, bool punchthrough, bool etc1) {
+    static const int lookup[8] = { 0, 1, 2, 3, -4, -3, -2, -1 };
+
+    Uint32 bits = ((Uint32)src[4] << 24) | ((Uint32)src[5] << 16) | ((Uint32)src[6] << 8) | src[7];
+    bool flip = (src[3] & 0x1) != 0;
+    bool diff = (src[3] & 0x2) != 0;
+    bool opaque = !punchthrough || diff;
+    if (punchthrough) { diff = true; }
+
+    int r1 = src[0] >> 3, g1 = src[1] >> 3, b1 = src[2] >> 3;
+    int r2 = r1+lookup[src[0] & 0x7];
+    int g2 = g1+lookup[src[1] & 0x7];
+    int b2 = b1+lookup[src[2] & 0x7];
+
+    if (!diff || etc1 || (r2 >= 0 && r2 <= 31 && g2 >= 0 && g2 <= 31 && b2 >= 0 && b2 <= 31)) {
+        // Individual or differential mode (the only modes in ETC1)
+        int base[2][3];
+        if (diff) {
+            base[0][0] = extend5(r1);
+            base[0][1] = extend5(g1);
+            base[0][2] = extend5(b1);
+            base[1][0] = extend5(r2 & 0x1f);
+            base[1][1] = extend5(g2 & 0x1f);
+            base[1][2] = extend5(b2 & 0x1f);
+        } else {
+            for(int ii = 0; ii < 3; ii++) {
+                base[0][ii] = extend4(src[ii] >> 4);
+                base[1][ii] = extend4(src[ii] & 0xf);
+            }
+        }
+        int table[2] = { (src[3] >> 5) & 0x7, (src[3] >> 2) & 0x7 };
+        for(int x = 0; x < 4; x++) {
+            for(int y = 0; y < 4; y++) {
+                int pos = x*4+y;
+                int index = (((bits >> (16+pos)) & 1) << 1) | ((bits >> pos) & 1);
+                int sub = flip ? (y >= 2) : (x >= 2);
+                Uint8* pixel = dst+4*(y*4+x);
+                if (!opaque && index == 2) {
+                    pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                    continue;
+                }
+                int modifier = ETC_MODIFIERS[table[sub]][index];
+                if (!opaque && index == 0) {
+                    modifier = 0;
+                }
+                pixel[0] = clamp255(base[sub][0]+modifier);
+                pixel[1] = clamp255(base[sub][1]+modifier);
+                pixel[2] = clamp255(base[sub][2]+modifier);
+                pixel[3] = 255;
+            }
+        }
+    } else if (r2 < 0 || r2 > 31) {
+        // T mode
+        int c1[3], c2[3];
+        c1[0] = extend4(((src[0] & 0x18) >> 1) | (src[0] & 0x3));
+        c1[1] = extend4(src[1] >> 4);
+        c1[2] = extend4(src[1] & 0xf);
+        c2[0] = extend4(src[2] >> 4);
+        c2[1] = extend4(src[2] & 0xf);
+        c2[2] = extend4(src[3] >> 4);
+        int dist = ETC_DISTANCES[(((src[3] >> 2) & 0x3) << 1) | (src[3] & 0x1)];
+        Uint8 paint[4][3];
+        for(int ii = 0; ii < 3; ii++) {
+            paint[0][ii] = clamp255(c1[ii]);
+            paint[1][ii] = clamp255(c2[ii]+dist);
+            paint[2][ii] = clamp255(c2[ii]);
+            paint[3][ii] = clamp255(c2[ii]-dist);
+        }
+        for(int x = 0; x < 4; x++) {
+            for(int y = 0; y < 4; y++) {
+                int pos = x*4+y;
+                int index = (((bits >> (16+pos)) & 1) << 1) | ((bits >> pos) & 1);
+                Uint8* pixel = dst+4*(y*4+x);
+                if (!opaque && index == 2) {
+                    pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                } else {
+                    pixel[0] = paint[index][0];
+                    pixel[1] = paint[index][1];
+                    pixel[2] = paint[index][2];
+                    pixel[3] = 255;
+                }
+            }
+        }
+    } else if (g2 < 0 || g2 > 31) {
+        // H mode
+        int h1[3], h2[3];
+        h1[0] = (src[0] & 0x78) >> 3;
+        h1[1] = ((src[0] & 0x07) << 1) | ((src[1] & 0x10) >> 4);
+        h1[2] = (src[1] & 0x08) | ((src[1] & 0x03) << 1) | ((src[2] & 0x80) >> 7);
+        h2[0] = (src[2] & 0x78) >> 3;
+        h2[1] = ((src[2] & 0x07) << 1) | ((src[3] & 0x80) >> 7);
+        h2[2] = (src[3] & 0x78) >> 3;
+        int order1 = (h1[0] << 8) | (h1[1] << 4) | h1[2];
+        int order2 = (h2[0] << 8) | (h2[1] << 4) | h2[2];
+        int dist = ETC_DISTANCES[(src[3] & 0x4) | ((src[3] & 0x1) << 1) | (order1 >= order2 ? 1 : 0)];
+        Uint8 paint[4][3];
+        for(int ii = 0; ii < 3; ii++) {
+            paint[0][ii] = clamp255(extend4(h1[ii])+dist);
+            paint[1][ii] = clamp255(extend4(h1[ii])-dist);
+            paint[2][ii] = clamp255(extend4(h2[ii])+dist);
+            paint[3][ii] = clamp255(extend4(h2[ii])-dist);
+        }
+        for(int x = 0; x < 4; x++) {
+            for(int y = 0; y < 4; y++) {
+                int pos = x*4+y;
+                int index = (((bits >> (16+pos)) & 1) << 1) | ((bits >> pos) & 1);
+                Uint8* pixel = dst+4*(y*4+x);
+                if (!opaque && index == 2) {
+                    pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                } else {
+                    pixel[0] = paint[index][0];
+                    pixel[1] = paint[index][1];
+                    pixel[2] = paint[index][2];
+                    pixel[3] = 255;
+                }
+            }
+        }
+    } else {
+        // Planar mode
+        int o[3], h[3], v[3];
+        o[0] = extend6((src[0] & 0x7e) >> 1);
+        o[1] = extend7(((src[0] & 0x1) << 6) | ((src[1] & 0x7e) >> 1));
+        o[2] = extend6(((src[1] & 0x1) << 5) | (src[2] & 0x18) | ((src[2] & 0x3) << 1) | ((src[3] & 0x80) >> 7));
+        h[0] = extend6(((src[3] & 0x7c) >> 1) | (src[3] & 0x1));
+        h[1] = extend7((src[4] & 0xfe) >> 1);
+        h[2] = extend6(((src[4] & 0x1) << 5) | ((src[5] & 0xf8) >> 3));
+        v[0] = extend6(((src[5] & 0x7) << 3) | ((src[6] & 0xe0) >> 5));
+        v[1] = extend7(((src[6] & 0x1f) << 2) | ((src[7] & 0xc0) >> 6));
+        v[2] = extend6(src[7] & 0x3f);
+        for(int y = 0; y < 4; y++) {
+            for(int x = 0; x < 4; x++) {
+                Uint8* pixel = dst+4*(y*4+x);
+                for(int ii = 0; ii < 3; ii++) {
+                    pixel[ii] = clamp255((x*(h[ii]-o[ii])+y*(v[ii]-o[ii])+4*o[ii]+2) >> 2);
+                }
+                pixel[3] = 255;
+            }
+        }
+    }
+}
+
+/**
+ * Decodes an EAC alpha block into the alpha channel of a 4x4 RGBA block.
+ *
+ * The output is a 16 pixel array in row-major order. Only the alpha values
+ * of the output are modified.
+ *
+ * @param src   The 8 byte compressed block
+ * @param dst   The 64 byte decompressed block
+ */
+static void decode_eac_block(const Uint8* src, Uint8* dst) {
+    int base = src[0];
+    int mult = src[1] >> 4;
+    const int* modifiers = EAC_MODIFIERS[src[1] & 0xf];
+    Uint64 bits = 0;
+    for(int ii = 2; ii < 8; ii++) {
+        bits = (bits << 8) | src[ii];
+    }
+    for(int x = 0; x < 4; x++) {
+        for(int y = 0; y < 4; y++) {
+            int index = (int)((bits >> (45-3*(x*4+y))) & 0x7);
+            dst[4*(y*4+x)+3] = clamp255(base+modifiers[index]*mult);
+        }
+    }
+}
+
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty KTX image.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+KTXImage::KTXImage() :
+_glType(0),
+_glFormat(0),
+_glInternal(0),
+_glBase(0),
+_width(0),
+_height(0) {}
+
+/**
+ * Deletes the image data and resets all attributes.
+ *
+ * You must reinitialize the image to use it.
+ */
+void KTXImage::dispose() {
+    _glType = _glFormat = _glInternal = _glBase = 0;
+    _width = _height = 0;
+    _data.clear();
+    _offsets.clear();
+    _sizes.clear();
+}
+
+/**
+ * Initializes an image from the given KTX file.
+ *
+ * The file is read through SDL, so on Android this may be a path inside
+ * of the application package.  This method does not prepend the asset
+ * directory to relative paths.
+ *
+ * @param filename  The path to the KTX file
+ *
+ * @return true if initialization was successful.
+ */
+bool KTXImage::init(const std::string& filename) {
+    SDL_RWops* source = AssetArchive::openFile(filename, "rb");
+    if (source == nullptr) {
+        CULogError("Unable to open KTX file '%s'", filename.c_str());
+        return false;
+    }
+
+    Sint64 size = SDL_RWsize(source);
+    if (size <= KTX_HEADER_SIZE) {
+        SDL_RWclose(source);
+        CULogError("File '%s' is not a KTX file", filename.c_str());
+        return false;
+    }
+
+    std::vector<Uint8> contents((size_t)size);
+    size_t amount = SDL_RWread(source, contents.data(), 1, (size_t)size);
+    SDL_RWclose(source);
+    if (amount != (size_t)size) {
+        CULogError("Unable to read KTX file '%s'", filename.c_str());
+        return false;
+    }
+
+    bool result = initWithData(contents.data(), contents.size());
+    if (!result) {
+        CULogError("File '%s' is not a supported KTX file", filename.c_str());
+    }
+    return result;
+}
+
+/**
+ * Initializes an image from the contents of a KTX file.
+ *
+ * The data is copied, and so it is safe to delete it when this method
+ * is done.  The file is rejected if any mipmap level has fewer bytes
+ * than its dimensions require (including the 4 byte row padding of
+ * uncompressed levels).
+ *
+ * @param data  The contents of a KTX file
+ * @param size  The number of bytes in data
+ *
+ * @return true if initialization was successful.
+ */
+bool KTXImage::initWithData(const void* data, size_t size) {
+    if (!_sizes.empty()) {
+        CUAssertLog(false, "KTX image is already initialized");
+        return false; // In case asserts are off.
+    }
+
+    const Uint8* bytes = (const Uint8*)data;
+    if (size <= KTX_HEADER_SIZE || memcmp(bytes, KTX_IDENTIFIER, 12) != 0) {
+        return false;
+    }
+
+    Uint32 header[13];
+    memcpy(header, bytes+12, sizeof(header));
+    bool swap = false;
+    if (header[0] == KTX_ENDIAN_SWAPPED) {
+        swap = true;
+        for(int ii = 0; ii < 13; ii++) {
+            header[ii] = swap32(header[ii]);
+        }
+    } else if (header[0] != KTX_ENDIAN_NATIVE) {
+        return false;
+    }
+
+    // Header layout after the endianness marker
+    Uint32 glType   = header[1];
+    Uint32 glFormat = header[3];
+    Uint32 glInternal = header[4];
+    Uint32 glBase   = header[5];
+    Uint32 width    = header[6];
+    Uint32 height   = header[7];
+    Uint32 depth    = header[8];
+    Uint32 elements = header[9];
+    Uint32 faces    = header[10];
+    Uint32 levels   = header[11];
+    Uint32 keysize  = header[12];
+
+    // We only support plain 2d textures
+    if (width == 0 || height == 0 || depth > 1 || elements > 0 || faces != 1) {
+        return false;
+    }
+    if (glType != 0 && (glType != GL_UNSIGNED_BYTE || (glFormat != GL_RGBA && glFormat != GL_RGB))) {
+        return false;
+    }
+    if (glType == 0 && block_size(glInternal) == 0) {
+        return false;
+    }
+
+    levels = (levels == 0 ? 1 : levels);
+    if (levels > 32) {
+        return false;
+    }
+
+    size_t offset = KTX_HEADER_SIZE+keysize;
+    size_t channels = (glFormat == GL_RGBA ? 4 : 3);
+    Uint32 levelWidth  = width;
+    Uint32 levelHeight = height;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    for(Uint32 ii = 0; ii < levels; ii++) {
+        if (offset+4 > size) {
+            return false;
+        }
+        Uint32 amount;
+        memcpy(&amount, bytes+offset, 4);
+        amount = swap ? swap32(amount) : amount;
+        offset += 4;
+        if (offset+amount > size) {
+            return false;
+        }
+
+        // Uncompressed rows are padded to 4 bytes; compressed data is 4x4 blocks
+        size_t expected;
+        if (glType != 0) {
+            expected = ((levelWidth*channels+3) & ~(size_t)3)*levelHeight;
+        } else {
+            expected = ((levelWidth+3)/4)*((levelHeight+3)/4)*block_size(glInternal);
+        }
+        if (amount < expected) {
+            return false;
+        }
+        levelWidth  = (levelWidth  > 1 ? levelWidth/2  : 1);
+        levelHeight = (levelHeight > 1 ? levelHeight/2 : 1);
+        offsets.push_back(offset);
+        sizes.push_back(amount);
+        offset += (amount+3) & ~3;
+    }
+
+    _glType = glType;
+    _glFormat = glFormat;
+    _glInternal = glInternal;
+    _glBase = glBase;
+    _width  = width;
+    _height = height;
+
+    // Compact the levels (this drops the padding and key-value data)
+    size_t total = 0;
+    for(auto it = sizes.begin(); it != sizes.end(); ++it) {
+        total += *it;
+    }
+    _data.resize(total);
+    total = 0;
+    for(size_t ii = 0; ii < sizes.size(); ii++) {
+        memcpy(_data.data()+total, bytes+offsets[ii], sizes[ii]);
+        _offsets.push_back(total);
+        _sizes.push_back(sizes[ii]);
+        total += sizes[ii];
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Returns the size in bytes of all of the mipmap levels.
+ *
+ * This is the amount of texture memory this image will require on the GPU.
+ *
+ * @return the size in bytes of all of the mipmap levels.
+ */
+size_t KTXImage::getByteSize() const {
+    return _data.size();
+}
+
+#pragma mark -
+#pragma mark Format Support
+/**
+ * Returns true if the current OpenGL context can sample this image.
+ *
+ * Uncompressed images are always supported.  Compressed images are
+ * supported if their format is listed in GL_COMPRESSED_TEXTURE_FORMATS.
+ *
+ * This method is safe to call from any thread, provided that
+ * {@link querySupport} has been called in the main thread first.
+ *
+ * @return true if the current OpenGL context can sample this image.
+ */
+bool KTXImage::isSupported() const {
+    return !isCompressed() || isFormatSupported(_glInternal);
+}
+
+/**
+ * Caches the compressed formats supported by the current OpenGL context.
+ *
+ * This method must be called from the main thread, as it queries OpenGL.
+ * It only performs the query the first time it is called, so it is cheap
+ * to call it more than once.
+ */
+void KTXImage::querySupport() {
+    std::lock_guard<std::mutex> lock(_querylock);
+    if (_queried) {
+        return;
+    }
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    if (count > 0) {
+        std::vector<GLint> formats(count);
+        glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+        for(auto it = formats.begin(); it != formats.end(); ++it) {
+            _supported.emplace((GLenum)*it);
+        }
+    }
+    _queried = true;
+}
+
+/**
+ * Returns true if the current OpenGL context can sample the given format.
+ *
+ * This method is safe to call from any thread, provided that
+ * {@link querySupport} has been called in the main thread first.
+ *
+ * @param format    The OpenGL compressed internal format
+ *
+ * @return true if the current OpenGL context can sample the given format.
+ */
+bool KTXImage::isFormatSupported(GLenum format) {
+    std::lock_guard<std::mutex> lock(_querylock);
+    CUAssertLog(_queried, "Compressed formats have not been queried");
+    return _supported.find(format) != _supported.end();
+}
+
+#pragma mark -
+#pragma mark Decompression
+/**
+ * Returns an uncompressed copy of this image.
+ *
+ * The result is an RGBA image (with GL_UNSIGNED_BYTE data) with the same
+ * number of mipmap levels as this image.  If this image is not compressed,
+ * this method will return nullptr.  It will also return nullptr if this
+ * image is in a compressed format that we cannot decode.
+ *
+ * This method does not touch OpenGL, so it is safe to call in a separate
+ * thread.
+ *
+ * @return an uncompressed copy of this image.
+ */
+std::shared_ptr<KTXImage> KTXImage::decompress() const {
+    if (!isCompressed() || block_size(_glInternal) == 0) {
+        return nullptr;
+    }
+
+    std::shared_ptr<KTXImage> result = std::make_shared<KTXImage>();
+    result->_glType = GL_UNSIGNED_BYTE;
+    result->_glFormat = GL_RGBA;
+    result->_glInternal = GL_RGBA;
+    result->_glBase = GL_RGBA;
+    result->_width  = _width;
+    result->_height = _height;
+
+    size_t total = 0;
+    for(unsigned int ii = 0; ii < getLevels(); ii++) {
+        size_t amount = 4*getWidth(ii)*getHeight(ii);
+        result->_offsets.push_back(total);
+        result->_sizes.push_back(amount);
+        total += amount;
+    }
+    result->_data.resize(total);
+
+    for(unsigned int ii = 0; ii < getLevels(); ii++) {
+        unsigned int w = getWidth(ii);
+        unsigned int h = getHeight(ii);
+        size_t expected = ((w+3)/4)*((h+3)/4)*block_size(_glInternal);
+        if (_sizes[ii] < expected ||
+            !decode(_glInternal, getData(ii), w, h, result->_data.data()+result->_offsets[ii])) {
+            return nullptr;
+        }
+    }
+    return result;
+}
+
+/**
+ * Decodes a single ETC compressed image to RGBA8888 data.
+ *
+ * The output buffer must have space for width*height*4 bytes.  This method
+ * returns false if the format is not a supported ETC format.
+ *
+ * @param format    The OpenGL compressed internal format
+ * @param data      The compressed data
+ * @param width     The image width in pixels
+ * @param height    The image height in pixels
+ * @param output    The buffer to store the RGBA pixels
+ *
+ * @return true if the image was successfully decoded
+ */
+bool KTXImage::decode(GLenum format, const Uint8* data, unsigned int width,
+                      unsigned int height, Uint8* output) {
+    size_t bsize = block_size(format);
+    if (bsize == 0) {
+        return false;
+    }
+
+    bool etc1 = format == GL_ETC1_RGB8_OES;
+    bool punch = format == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    bool alpha = format == GL_COMPRESSED_RGBA8_ETC2_EAC;
+
+    Uint8 block[64];
+    const Uint8* src = data;
+    for(unsigned int by = 0; by < height; by += 4) {
+        for(unsigned int bx = 0; bx < width; bx += 4) {
+            if (alpha) {
+                decode_etc_block(src+8, block, false, false);
+                decode_eac_block(src, block);
+            } else {
+                decode_etc_block(src, block, punch, etc1);
+            }
+            src += bsize;
+
+            // Copy the block, clipping at the image edges
+            unsigned int cols = std::min(4u,width-bx);
+            unsigned int rows = std::min(4u,height-by);
+            for(unsigned int y = 0; y < rows; y++) {
+                memcpy(output+4*((by+y)*width+bx), block+16*y, 4*cols);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,179 @@
+//
+//  CURenderTarget.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an offscreen render target.  A render target is an
+//  OpenGL framebuffer whose color attachment is an ordinary Texture.  Anything
+//  drawn while the target is active ends up in that texture, which can then be
+//  drawn like any other texture.  This allows us to draw an expensive part of
+//  the scene graph once, and reuse the result in later frames.
+//
+//  Render targets are normally activated through a SpriteBatch (see the method
+//  SpriteBatch::setTarget), which flushes its pending geometry first.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+//
+#include <cugl/renderer/CURenderTarget.h>
+#include <cugl/renderer/CUGLState.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized render target.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+RenderTarget::RenderTarget() :
+_framebuffer(0),
+_active(false),
+_prevBuffer(0) {
+    for(int ii = 0; ii < 4; ii++) {
+        _prevViewport[ii] = 0;
+    }
+}
+
+/**
+ * Deletes the framebuffer and texture of this render target.
+ *
+ * You must reinitialize the render target to use it.
+ */
+void RenderTarget::dispose() {
+    CUAssertLog(!_active, "Disposing an active render target");
+    if (_framebuffer) {
+        GLState::deleteFramebuffer(_framebuffer);
+        _framebuffer = 0;
+    }
+    _texture = nullptr;
+    _clearColor = Color4f::CLEAR;
+    _active = false;
+}
+
+/**
+ * Initializes a render target of the given size.
+ *
+ * Both dimensions must be a power of two.  This method fails if the
+ * framebuffer is not complete on this device.
+ *
+ * @param width     The target width in pixels
+ * @param height    The target height in pixels
+ *
+ * @return true if initialization was successful.
+ */
+bool RenderTarget::init(int width, int height) {
+    if (_framebuffer) {
+        CUAssertLog(false, "Render target is already initialized");
+        return false; // In case asserts are off.
+    }
+
+    _texture = Texture::alloc(width, height);
+    if (_texture == nullptr) {
+        return false;
+    }
+    _texture->setName("<target>");
+
+    glGenFramebuffers(1, &_framebuffer);
+    if (_framebuffer == 0) {
+        _texture = nullptr;
+        return false;
+    }
+
+    GLuint previous = GLState::getFramebuffer();
+    GLState::bindFramebuffer(_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           _texture->getBuffer(), 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLState::bindFramebuffer(previous);
+    GLState::countCalls(2);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        CULogError("Render target %dx%d is incomplete (status 0x%x)", width, height, status);
+        dispose();
+        return false;
+    }
+    return true;
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Makes this target the destination of all drawing.
+ *
+ * The viewport is set to the entire texture.  The previous framebuffer
+ * and viewport are saved, to be restored by {@link end()}.  The target
+ * is not cleared, so that a target may be resumed after drawing to
+ * another one.  Use {@link clear()} to start over.
+ *
+ * Any pending drawing must be flushed before this call.  That is why
+ * this method is normally called through a SpriteBatch.
+ */
+void RenderTarget::begin() {
+    CUAssertLog(_framebuffer, "Render target is not initialized");
+    CUAssertLog(!_active, "Render target is already active");
+    _prevBuffer = GLState::getFramebuffer();
+    GLState::getViewport(_prevViewport);
+    GLState::bindFramebuffer(_framebuffer);
+    GLState::setViewport(0, 0, getWidth(), getHeight());
+    _active = true;
+}
+
+/**
+ * Clears this target to the clear color.
+ *
+ * This method may only be called while the target is active.
+ */
+void RenderTarget::clear() {
+    CUAssertLog(_active, "Render target is not active");
+    GLfloat previous[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previous);
+    glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(previous[0], previous[1], previous[2], previous[3]);
+    GLState::countCalls(4);
+}
+
+/**
+ * Restores the framebuffer and viewport active before {@link begin()}.
+ *
+ * Any pending drawing must be flushed before this call.  That is why
+ * this method is normally called through a SpriteBatch.
+ */
+void RenderTarget::end() {
+    CUAssertLog(_active, "Render target is not active");
+    GLState::bindFramebuffer(_prevBuffer);
+    GLState::setViewport(_prevViewport[0], _prevViewport[1],
+                         _prevViewport[2], _prevViewport[3]);
+    _active = false;
+}
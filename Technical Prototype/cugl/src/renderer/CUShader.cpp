@@ -32,6 +32,7 @@
 //  Version: 6/23/16
 
 #include <cugl/renderer/CUShader.h>
+#include <cugl/renderer/CUGLState.h>
 #include <cugl/util/CUDebug.h>
 
 using namespace cugl;
@@ -44,7 +45,7 @@ using namespace cugl;
  */
 void Shader::bind() {
     CUAssertLog(_program, "Shader is not ready for use");
-    glUseProgram( _program );
+    GLState::useProgram( _program );
     _active = true;
 }
 
@@ -55,7 +56,7 @@ void Shader::bind() {
  */
 void Shader::unbind() {
     CUAssertLog(_program, "Shader is not ready for use");
-    glUseProgram( NULL );
+    GLState::useProgram( 0 );
     _active = false;
 }
 
@@ -128,7 +129,7 @@ void Shader::dispose() {
     if (_active) { unbind(); }
     if (_fragShader) { glDeleteShader(_fragShader); _fragShader = 0;}
     if (_vertShader) { glDeleteShader(_vertShader); _vertShader = 0;}
-    if (_program) { glDeleteShader(_program); _program = 0;}
+    if (_program) { GLState::deleteProgram(_program); _program = 0;}
     _vertSource = nullptr;
     _fragSource = nullptr;
 }
@@ -9,10 +9,15 @@
 #include <cugl/renderer/CUSpriteBatch.h>
 #include <cugl/renderer/CUSpriteShader.h>
 #include <cugl/renderer/CUTexture.h>
+#include <cugl/renderer/CUGLState.h>
+#include <cugl/renderer/CURenderTarget.h>
 #include <cugl/math/CUAffine2.h>
 #include <cugl/math/CUPoly2.h>
 #include <cugl/util/CUDebug.h>
 #include <SDL/SDL_image.h>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
 
 using namespace cugl;
 
@@ -32,6 +37,68 @@ static unsigned char cu_2x2_white_image[] = {
 /** The blank texture corresponding to cu_2x2_white_image */
 std::shared_ptr<Texture> SpriteBatch::_blank;
 
+/** The corners of the unit square, in triangle strip order */
+static const GLfloat cu_quad_corners[] = { 0, 0,  1, 0,  0, 1,  1, 1 };
+
+/** The triangulation of a quad when it is added to the mesh */
+static const unsigned short cu_quad_indices[] = { 0, 1, 2,  1, 3, 2 };
+
+/** The largest vertex capacity that can use 16-bit indices */
+#define SHORT_INDEX_LIMIT   65536
+/** The largest coordinate magnitude for half float positions (spacing 1) */
+#define HALF_POSITION_LIMIT 2048.0f
+
+/**
+ * Returns the half float (IEEE 754 binary16) closest to the given value.
+ *
+ * The value must be less than 65504 in magnitude, which is always true for
+ * the positions packed by the sprite batch.
+ *
+ * @param value The value to convert
+ *
+ * @return the half float closest to the given value.
+ */
+static GLushort cu_float_to_half(float value) {
+    Uint32 bits;
+    std::memcpy(&bits, &value, sizeof(Uint32));
+    Uint32 sign = (bits >> 16) & 0x8000;
+    int exp = (int)((bits >> 23) & 0xff)-127+15;
+    Uint32 mant = bits & 0x7fffff;
+    if (exp <= 0) {
+        // Subnormal (or zero) half
+        if (exp < -10) {
+            return (GLushort)sign;
+        }
+        mant |= 0x800000;
+        Uint32 shift = 14-exp;
+        Uint32 half = mant >> shift;
+        Uint32 rest = mant & ((1u << shift)-1);
+        Uint32 tie  = 1u << (shift-1);
+        if (rest > tie || (rest == tie && (half & 1))) {
+            half++;
+        }
+        return (GLushort)(sign | half);
+    }
+    // Round to nearest even (a carry into the exponent is still correct)
+    Uint32 half = sign | (exp << 10) | (mant >> 13);
+    Uint32 rest = mant & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return (GLushort)half;
+}
+
+/**
+ * Returns the given texture coordinate as a normalized unsigned short.
+ *
+ * @param value The texture coordinate in [0,1]
+ *
+ * @return the given texture coordinate as a normalized unsigned short.
+ */
+static inline GLushort cu_normalize_texcoord(float value) {
+    return (GLushort)(value*65535.0f+0.5f);
+}
+
 #pragma mark Constructors
 /**
  * Creates a degenerate sprite batch with no buffers.
@@ -42,6 +109,8 @@ SpriteBatch::SpriteBatch() :
 _capacity(0),
 _vertData(nullptr),
 _indxData(nullptr),
+_indxShort(nullptr),
+_packData(nullptr),
 _vertArray(0),
 _vertBuffer(0),
 _indxBuffer(0),
@@ -49,6 +118,16 @@ _vertMax(0),
 _vertSize(0),
 _indxMax(0),
 _indxSize(0),
+_layout(VertexLayout::FULL),
+_attached(VertexLayout::FULL),
+_quadArray(0),
+_quadCorners(0),
+_quadBuffer(0),
+_quadData(nullptr),
+_quadMax(0),
+_quadSize(0),
+_quadMode(false),
+_instancing(false),
 _color(Color4::WHITE),
 _perspective(Mat4::IDENTITY),
 _command(GL_TRIANGLES),
@@ -58,8 +137,10 @@ _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
 _texture(nullptr),
 _vertTotal(0),
 _callTotal(0),
+_byteTotal(0),
 _initialized(false),
-_active(false) {
+_active(false),
+_deferred(false) {
 }
 
 /**
@@ -70,17 +151,31 @@ _active(false) {
 void SpriteBatch::dispose() {
     if (_vertData) { delete[] _vertData; _vertData = nullptr; }
     if (_indxData) { delete[] _indxData; _indxData = nullptr; }
-    if (_vertArray) { glDeleteVertexArrays(1,&_vertArray); _vertArray = 0; }
-    if (_indxBuffer) { glDeleteBuffers(1,&_indxBuffer); _indxBuffer = 0; }
-    if (_vertBuffer) { glDeleteBuffers(1,&_vertBuffer); _vertBuffer = 0; }
+    if (_indxShort) { delete[] _indxShort; _indxShort = nullptr; }
+    if (_packData) { delete[] _packData; _packData = nullptr; }
+    if (_vertArray) { GLState::deleteVertexArray(_vertArray); _vertArray = 0; }
+    if (_indxBuffer) { GLState::deleteBuffer(_indxBuffer); _indxBuffer = 0; }
+    if (_vertBuffer) { GLState::deleteBuffer(_vertBuffer); _vertBuffer = 0; }
+    if (_quadData) { delete[] _quadData; _quadData = nullptr; }
+    if (_quadArray) { GLState::deleteVertexArray(_quadArray); _quadArray = 0; }
+    if (_quadCorners) { GLState::deleteBuffer(_quadCorners); _quadCorners = 0; }
+    if (_quadBuffer) { GLState::deleteBuffer(_quadBuffer); _quadBuffer = 0; }
+    if (_quadShader != nullptr) { _quadShader = nullptr; }
     if (_shader != nullptr) { _shader = nullptr; }
     if (_texture != nullptr) { _texture = nullptr; }
+    if (_target != nullptr) { _target->end(); _target = nullptr; }
     
     _capacity = 0;
     _vertMax  = 0;
     _vertSize = 0;
     _indxMax  = 0;
     _indxSize = 0;
+    _layout   = VertexLayout::FULL;
+    _attached = VertexLayout::FULL;
+    _quadMax  = 0;
+    _quadSize = 0;
+    _quadMode = false;
+    _instancing = false;
     _color = Color4::WHITE;
     _perspective = Mat4::IDENTITY;
     _command = GL_TRIANGLES;
@@ -90,9 +185,18 @@ void SpriteBatch::dispose() {
     
     _vertTotal = 0;
     _callTotal = 0;
+    _byteTotal = 0;
+
+    _commands.clear();
+    _recordVerts.clear();
+    _recordIndx.clear();
+    _recordQuads.clear();
+    _recordCalls.clear();
+    _recordShapes.clear();
 
     _initialized = false;
     _active = false;
+    _deferred = false;
 }
 
 /**
@@ -168,7 +272,11 @@ bool SpriteBatch::init(unsigned int capacity, std::shared_ptr<SpriteShader> shad
     _vertMax = _capacity;
     _vertData = new Vertex2[_vertMax];
     _indxMax = _capacity*3;
-    _indxData = new GLuint[_indxMax];
+    if (_vertMax <= SHORT_INDEX_LIMIT) {
+        _indxShort = new GLushort[_indxMax];
+    } else {
+        _indxData = new GLuint[_indxMax];
+    }
     
     // Generate the buffers
     glGenBuffers(1, &_vertBuffer);
@@ -190,12 +298,72 @@ bool SpriteBatch::init(unsigned int capacity, std::shared_ptr<SpriteShader> shad
     }
     
     // Bind and link the buffers
-    glBindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
-    glBindVertexArray(_vertArray);
+    GLState::bindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
+    GLState::bindVertexArray(_vertArray);
     glBufferData( GL_ARRAY_BUFFER, _vertSize * sizeof(Vertex2), _vertData, GL_DYNAMIC_DRAW );
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, _indxSize * sizeof(GLuint), _indxData, GL_DYNAMIC_DRAW );
+    GLState::bindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, 0, NULL, GL_DYNAMIC_DRAW );
+
+    // Set up the instanced quads (a quad takes four vertices in the mesh)
+    _quadShader = SpriteShader::allocQuads();
+    if (_quadShader != nullptr) {
+        _quadMax = _capacity/4;
+        _quadData = new QuadInstance[_quadMax];
+
+        glGenVertexArrays(1, &_quadArray);
+        glGenBuffers(1, &_quadCorners);
+        glGenBuffers(1, &_quadBuffer);
+        if (!validateBuffer(_quadArray, "Unable to generate Quad Array Object") ||
+            !validateBuffer(_quadCorners, "Unable to generate Quad Corner Buffer Object") ||
+            !validateBuffer(_quadBuffer, "Unable to generate Quad Instance Buffer Object")) {
+            dispose();
+            return false;
+        }
+
+        GLState::bindVertexArray(_quadArray);
+        GLState::bindBuffer( GL_ARRAY_BUFFER, _quadCorners );
+        glBufferData( GL_ARRAY_BUFFER, sizeof(cu_quad_corners), cu_quad_corners, GL_STATIC_DRAW );
+        _quadShader->attachQuads(_quadArray, _quadCorners, _quadBuffer);
+    } else {
+        CULogError("Instanced quads are not available; drawing rectangles as meshes");
+    }
+    _texture = SpriteBatch::getBlankTexture();
+    return true;
+}
+
+/**
+ * Initializes a deferred sprite batch with the given vertex capacity.
+ *
+ * A deferred sprite batch has no shader and no OpenGL objects, so this
+ * method may be called on any thread once the blank texture exists.
+ * Each flush is recorded, and the recording is drawn by {@link replay}.
+ * The capacity should not exceed that of the batch that replays it.
+ *
+ * The sprite batch begins with the default blank texture, and color white.
+ *
+ * @param capacity  The vertex capacity of the mesh
+ *
+ * @return true if initialization was successful.
+ */
+bool SpriteBatch::initDeferred(unsigned int capacity) {
+    if (_initialized || _vertData != nullptr) {
+        CUAssertLog(false, "SpriteBatch is already initialized");
+        return false; // If asserts are turned off.
+    }
+    
+    _capacity = capacity;
+    _deferred = true;
+    _vertMax = _capacity;
+    _vertData = new Vertex2[_vertMax];
+    _indxMax = _capacity*3;
+    if (_vertMax <= SHORT_INDEX_LIMIT) {
+        _indxShort = new GLushort[_indxMax];
+    } else {
+        _indxData = new GLuint[_indxMax];
+    }
+    _quadMax = _capacity/4;
+    _quadData = new QuadInstance[_quadMax];
     _texture = SpriteBatch::getBlankTexture();
     return true;
 }
@@ -213,6 +381,45 @@ bool SpriteBatch::init(unsigned int capacity, std::shared_ptr<SpriteShader> shad
 void SpriteBatch::setShader(const std::shared_ptr<SpriteShader>& shader) {
     CUAssertLog(_active, "Attempt to reassign shader while drawing is active");
     _shader = shader;
+    _instancing = false;
+}
+
+/**
+ * Sets whether textured rectangles are drawn as instanced quads.
+ *
+ * If this is false, {@link fillQuad} adds the rectangle to the mesh like
+ * any other shape.  Instancing is off by default.  It is also turned off
+ * by {@link setShader}, as the quads have their own shader.
+ *
+ * This value may NOT be changed during a drawing pass.
+ *
+ * @param flag  Whether textured rectangles are drawn as instanced quads
+ */
+void SpriteBatch::setInstancing(bool flag) {
+    CUAssertLog(!_active, "Attempt to change instancing while drawing is active");
+    _instancing = flag;
+}
+
+/**
+ * Sets the preferred layout for uploading the vertex mesh.
+ *
+ * The mesh is always built from {@link Vertex2} records.  Any layout other
+ * than FULL repacks them when the mesh is flushed, which costs a pass
+ * over the vertices.  If the mesh cannot be
+ * represented in the preferred layout (e.g. the texture coordinates
+ * repeat), that flush falls back to a larger layout.  See
+ * {@link VertexLayout} for the precision of each layout.
+ *
+ * The layout is FULL by default.  HALF is only appropriate for
+ * scenes with small world coordinates.
+ *
+ * This value may NOT be changed during a drawing pass.
+ *
+ * @param layout    The preferred layout for uploading the vertex mesh
+ */
+void SpriteBatch::setVertexLayout(VertexLayout layout) {
+    CUAssertLog(!_active, "Attempt to change vertex layout while drawing is active");
+    _layout = layout;
 }
 
 /**
@@ -232,12 +439,12 @@ void SpriteBatch::setTexture(const std::shared_ptr<Texture>& texture) {
     if (texture == nullptr) {
         if (_texture != nullptr && _texture->getBuffer() != getBlankTexture()->getBuffer()) {
             if (_active) { flush(); }
-            _shader->setTexture(getBlankTexture());
+            if (!_deferred) { getActiveShader()->setTexture(getBlankTexture()); }
             _texture = getBlankTexture();
         }
     } else if (_texture->getBuffer() != texture->getBuffer()) {  // Both must be not nullptr
         if (_active) { flush(); }
-        _shader->setTexture(texture);
+        if (!_deferred) { getActiveShader()->setTexture(texture); }
         _texture = texture;
     }
 }
@@ -272,13 +479,51 @@ const std::shared_ptr<Texture>& SpriteBatch::getBlankTexture() {
  * @param perspective   The active perspective matrix for this sprite batch
  */
 void SpriteBatch::setPerspective(const Mat4& perspective) {
-    if (_active && _perspective != perspective) {
+    if (_active && !_deferred && _perspective != perspective) {
         flush();
-        _shader->setPerspective(perspective);
+        getActiveShader()->setPerspective(perspective);
     }
     _perspective = perspective;
 }
 
+/**
+ * Sets the render target of this sprite batch
+ *
+ * All drawing after this call goes to the given target.  The target is
+ * not cleared (see {@link RenderTarget#clear()}).  A nullptr target
+ * restores the framebuffer that was current before the previous target.
+ * Changing this value will cause the sprite batch to flush.
+ *
+ * While a target is active, the alpha channel is blended with GL_ONE and
+ * GL_ONE_MINUS_SRC_ALPHA, regardless of the blend function.  With the
+ * default blend function, this means that the target texture holds
+ * premultiplied alpha, and should be drawn with GL_ONE as the source
+ * blend factor.
+ *
+ * The perspective matrix is not changed by this method.
+ *
+ * @param target    The render target for this sprite batch
+ */
+void SpriteBatch::setTarget(const std::shared_ptr<RenderTarget>& target) {
+    CUAssertLog(!_deferred, "A deferred sprite batch cannot change its render target");
+    if (_target == target || _deferred) {
+        return;
+    }
+    if (_active) {
+        flush();
+    }
+    if (_target != nullptr) {
+        _target->end();
+    }
+    _target = target;
+    if (_target != nullptr) {
+        _target->begin();
+    }
+    if (_active) {
+        applyBlendFunc();
+    }
+}
+
 /**
  * Sets the blending function for this sprite batch
  *
@@ -299,7 +544,9 @@ void SpriteBatch::setPerspective(const Mat4& perspective) {
 void SpriteBatch::setBlendFunc(GLenum srcFactor, GLenum dstFactor) {
     if (_active && (_srcFactor != srcFactor || _dstFactor != dstFactor)) {
         flush();
-        glBlendFunc(srcFactor, dstFactor);
+        _srcFactor = srcFactor;
+        _dstFactor = dstFactor;
+        if (!_deferred) { applyBlendFunc(); }
     }
     
     _srcFactor = srcFactor;
@@ -323,7 +570,7 @@ void SpriteBatch::setBlendFunc(GLenum srcFactor, GLenum dstFactor) {
 void SpriteBatch::setBlendEquation(GLenum equation) {
     if (_active && _blendEquation != equation) {
         flush();
-        glBlendEquation(equation);
+        if (!_deferred) { GLState::setBlendEquation(equation); }
     }
     
     _blendEquation = equation;
@@ -356,20 +603,37 @@ void SpriteBatch::setCommand(GLenum command) {
  * texturing. You must call end() to complete drawing.
  * 
  * Calling this method will reset the vertex and OpenGL call counters to 0.
+ * For a deferred batch, it discards the previous recording instead.
  */
 void SpriteBatch::begin() {
-    glDisable(GL_CULL_FACE);
-    glDepthMask(false);
-    glEnable(GL_BLEND);
-    glBlendEquation(_blendEquation);
-    glBlendFunc(_srcFactor, _dstFactor);
+    if (_deferred) {
+        _commands.clear();
+        _recordVerts.clear();
+        _recordIndx.clear();
+        _recordQuads.clear();
+        _recordCalls.clear();
+        _recordShapes.clear();
+        _vertSize = _indxSize = _quadSize = 0;
+        _quadMode = false;
+        _active = true;
+        return;
+    }
+    
+    GLState::disable(GL_CULL_FACE);
+    GLState::setDepthMask(false);
+    GLState::enable(GL_BLEND);
+    GLState::setBlendEquation(_blendEquation);
+    applyBlendFunc();
     
     // DO NOT CLEAR.  This responsibility lies elsewhere
     
+    // The mesh attributes are enabled in the bound vertex array
+    _quadMode = false;
+    GLState::bindVertexArray(_vertArray);
     _shader->bind();
     _shader->setPerspective(_perspective);
     _shader->setTexture(_texture);
-    _shader->attach(_vertArray, _vertBuffer);
+    _shader->attach(_vertArray, _vertBuffer, _attached);
     _active = true;
 }
 
@@ -381,7 +645,10 @@ void SpriteBatch::begin() {
  */
 void SpriteBatch::end() {
     flush();
-    _shader->unbind();
+    if (!_deferred) {
+        getActiveShader()->unbind();
+    }
+    _quadMode = false;
     _active = false;
 
 }
@@ -395,27 +662,184 @@ void SpriteBatch::end() {
  * previuosly drawn shapes.
  */
 void SpriteBatch::flush() {
+    if (_deferred) {
+        record();
+        return;
+    }
+    
+    if (_quadMode) {
+        if (_quadSize == 0) {
+            return;
+        }
+        
+        GLState::bindVertexArray(_quadArray);
+        GLState::bindBuffer( GL_ARRAY_BUFFER, _quadBuffer );
+        glBufferData( GL_ARRAY_BUFFER, _quadSize * sizeof(QuadInstance), _quadData, GL_DYNAMIC_DRAW );
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _quadSize);
+        GLState::countCalls(2);
+        
+        // Count the quads as the triangles they replace
+        _vertTotal += 6*_quadSize;
+        _byteTotal += _quadSize * sizeof(QuadInstance);
+        _callTotal++;
+        
+        _quadSize = 0;
+        return;
+    }
+    
     if (_indxSize == 0 || _vertSize == 0) {
         _vertSize = _indxSize = 0;
         return;
     }
     
-    glBindVertexArray (_vertArray);
-    glBindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
-    glBufferData( GL_ARRAY_BUFFER, _vertSize * sizeof(Vertex2), _vertData, GL_DYNAMIC_DRAW );
+    // Repack the vertices, changing the attribute types if necessary
+    VertexLayout layout = packVertices();
+    if (layout != _attached) {
+        _shader->attach(_vertArray, _vertBuffer, layout);
+        _attached = layout;
+    }
+
+    size_t vbytes = 0;
+    const void* vdata = nullptr;
+    switch (layout) {
+        case VertexLayout::FULL:
+            vbytes = _vertSize * sizeof(Vertex2);
+            vdata  = _vertData;
+            break;
+        case VertexLayout::COMPACT:
+            vbytes = _vertSize * sizeof(CompactVertex2);
+            vdata  = _packData;
+            break;
+        case VertexLayout::HALF:
+            vbytes = _vertSize * sizeof(HalfVertex2);
+            vdata  = _packData;
+            break;
+    }
+    
+    GLState::bindVertexArray(_vertArray);
+    GLState::bindBuffer( GL_ARRAY_BUFFER, _vertBuffer );
+    glBufferData( GL_ARRAY_BUFFER, vbytes, vdata, GL_DYNAMIC_DRAW );
     
     // Set index data and render
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, _indxSize * sizeof(GLuint), _indxData, GL_DYNAMIC_DRAW );
-    glDrawElements(_command, _indxSize, GL_UNSIGNED_INT, NULL );
+    size_t ibytes = _indxSize * (_indxShort ? sizeof(GLushort) : sizeof(GLuint));
+    const void* idata = (_indxShort ? (const void*)_indxShort : (const void*)_indxData);
+    GLState::bindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indxBuffer );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, ibytes, idata, GL_DYNAMIC_DRAW );
+    glDrawElements(_command, _indxSize, _indxShort ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, NULL );
+    GLState::countCalls(3);
     
     // Increment the counters
     _vertTotal += _indxSize;
+    _byteTotal += vbytes + ibytes;
     _callTotal++;
     
     _vertSize = _indxSize = 0;
 }
 
+/**
+ * Records a callback to run when this deferred batch is replayed.
+ *
+ * This is for drawing that cannot be recorded, such as drawing that
+ * needs OpenGL.  The callback receives the batch doing the replay (which
+ * is actively drawing), and is run after everything recorded before it.
+ * This method may only be called on a deferred batch.
+ *
+ * @param callback  The drawing to do at replay
+ */
+void SpriteBatch::defer(const std::function<void(const std::shared_ptr<SpriteBatch>&)>& callback) {
+    CUAssertLog(_deferred, "Only a deferred sprite batch can defer drawing");
+    flush();
+    DeferredCommand command;
+    command.command = 0;
+    command.quads = false;
+    command.blendEquation = _blendEquation;
+    command.srcFactor = _srcFactor;
+    command.dstFactor = _dstFactor;
+    command.start = (unsigned int)_recordCalls.size();
+    command.count = command.indxStart = command.indxCount = 0;
+    _recordCalls.push_back(callback);
+    _commands.push_back(command);
+}
+
+/**
+ * Draws the recording of this deferred batch with the given sprite batch.
+ *
+ * The given batch must be actively drawing.  The recorded shapes are
+ * added to its mesh as if they were drawn directly, with the recorded
+ * texture and blend state, so consecutive recordings with the same state
+ * are still batched together.  The recording is kept until the next call
+ * to {@link begin()}, so it may be replayed more than once.
+ *
+ * @param batch     The sprite batch to draw the recording with
+ */
+void SpriteBatch::replay(const std::shared_ptr<SpriteBatch>& batch) const {
+    CUAssertLog(batch->_active && !batch->_deferred, "Recordings must be replayed by an active batch");
+    size_t shape = 0;
+    for(auto it = _commands.begin(); it != _commands.end(); ++it) {
+        if (it->command == 0) {
+            _recordCalls[it->start](batch);
+            continue;
+        }
+        
+        batch->setTexture(it->texture);
+        batch->setBlendEquation(it->blendEquation);
+        batch->setBlendFunc(it->srcFactor, it->dstFactor);
+        if (it->quads) {
+            const QuadInstance* quads = _recordQuads.data()+it->start;
+            if (!batch->isInstancing()) {
+                batch->appendQuads(quads, it->count);
+                continue;
+            }
+            
+            batch->setQuadMode(true);
+            unsigned int done = 0;
+            while (done < it->count) {
+                if (batch->_quadSize == batch->_quadMax) {
+                    batch->flush();
+                }
+                unsigned int amount = std::min(it->count-done, batch->_quadMax-batch->_quadSize);
+                std::memcpy(batch->_quadData+batch->_quadSize, quads+done, amount*sizeof(QuadInstance));
+                batch->_quadSize += amount;
+                done += amount;
+            }
+            continue;
+        }
+        
+        batch->setQuadMode(false);
+        batch->setCommand(it->command);
+        
+        // Add the shapes in runs, flushing before the same shapes as a serial batch
+        const Vertex2* vertices = _recordVerts.data()+it->start;
+        const GLuint* indices = _recordIndx.data()+it->indxStart;
+        unsigned int vfrom = 0, ifrom = 0;
+        unsigned int vto = 0, ito = 0;
+        while (vfrom < it->count) {
+            while (vto < it->count &&
+                   batch->_vertSize+(vto-vfrom)+_recordShapes[shape]   <= batch->_vertMax &&
+                   batch->_indxSize+(ito-ifrom)+_recordShapes[shape+1] <= batch->_indxMax) {
+                vto += _recordShapes[shape];
+                ito += _recordShapes[shape+1];
+                shape += 2;
+            }
+            if (vto == vfrom) {
+                CUAssertLog(batch->_vertSize > 0, "Recording exceeds the capacity of the sprite batch");
+                batch->flush();
+                continue;
+            }
+            
+            unsigned int vstart = batch->_vertSize;
+            std::memcpy(batch->_vertData+vstart, vertices+vfrom, (vto-vfrom)*sizeof(Vertex2));
+            for(unsigned int jj = ifrom; jj < ito; jj++) {
+                batch->setIndex(batch->_indxSize+jj-ifrom, vstart+indices[jj]-vfrom);
+            }
+            batch->_vertSize += vto-vfrom;
+            batch->_indxSize += ito-ifrom;
+            vfrom = vto;
+            ifrom = ito;
+        }
+    }
+}
+
 #pragma mark -
 #pragma mark Solid Shapes
 
@@ -799,6 +1223,59 @@ void SpriteBatch::fill(const Vertex2* vertices, unsigned int vsize, unsigned int
     }
 }
 
+/**
+ * Fills the given rectangle with the current color and texture.
+ *
+ * The texture coordinates are given for the bottom left corner (the
+ * origin of rect) and the top right corner, and are interpolated over
+ * the rectangle.  Hence the texture may be flipped by swapping the
+ * coordinates.  The transform will be applied to the rectangle
+ * directly in world space.
+ *
+ * If instancing is on, the rectangle is drawn as a single quad instance.
+ * Otherwise (or outside of a drawing pass), it is added to the mesh
+ * as two triangles.  The result is the same either way.
+ *
+ * @param rect      The rectangle to fill
+ * @param texcoord0 The texture coordinate at the bottom left corner
+ * @param texcoord1 The texture coordinate at the top right corner
+ * @param transform The coordinate transform
+ */
+void SpriteBatch::fillQuad(const Rect& rect, const Vec2& texcoord0, const Vec2& texcoord1,
+                           const Mat4& transform) {
+    if (!isInstancing() || !_active) {
+        Vertex2 vertices[4];
+        for(int ii = 0; ii < 4; ii++) {
+            float u = cu_quad_corners[2*ii];
+            float v = cu_quad_corners[2*ii+1];
+            vertices[ii].position.set(rect.origin.x+u*rect.size.width,
+                                      rect.origin.y+v*rect.size.height);
+            vertices[ii].texcoord.set(u ? texcoord1.x : texcoord0.x,
+                                      v ? texcoord1.y : texcoord0.y);
+            vertices[ii].color = Color4::WHITE;
+        }
+        fill(vertices,4,0,cu_quad_indices,6,0,transform);
+        return;
+    }
+    
+    setQuadMode(true);
+    if (_quadSize == _quadMax) {
+        flush();
+    }
+    
+    // Only the 2d part of the transform applies, as with the mesh
+    const float* m = transform.m;
+    QuadInstance* quad = _quadData+_quadSize;
+    quad->axisX.set(m[0]*rect.size.width,  m[1]*rect.size.width);
+    quad->axisY.set(m[4]*rect.size.height, m[5]*rect.size.height);
+    quad->origin.set(m[0]*rect.origin.x+m[4]*rect.origin.y+m[12],
+                     m[1]*rect.origin.x+m[5]*rect.origin.y+m[13]);
+    quad->texcoord0 = texcoord0;
+    quad->texcoord1 = texcoord1;
+    quad->color = _color;
+    _quadSize++;
+}
+
 #pragma mark -
 #pragma mark Outlines
 /**
@@ -1384,6 +1861,202 @@ bool SpriteBatch::validateBuffer(GLuint buffer, const char* message) {
     return true;
 }
 
+/**
+ * Sets whether the current batch is made of instanced quads.
+ *
+ * Changing this value during a drawing pass will flush the buffer and
+ * switch the shader.
+ *
+ * @param quads Whether the current batch is made of instanced quads
+ */
+void SpriteBatch::setQuadMode(bool quads) {
+    if (_quadMode == quads) {
+        return;
+    }
+    flush();
+    if (!_active || _deferred) {
+        _quadMode = quads;
+        return;
+    }
+    
+    // The mesh attributes are enabled and disabled in the bound vertex array
+    getActiveShader()->unbind();
+    _quadMode = quads;
+    GLState::bindVertexArray(quads ? _quadArray : _vertArray);
+    getActiveShader()->bind();
+    getActiveShader()->setPerspective(_perspective);
+    getActiveShader()->setTexture(_texture);
+    if (!quads) {
+        _shader->attach(_vertArray, _vertBuffer, _attached);
+    }
+}
+
+/**
+ * Records the current mesh (or quads) of a deferred batch.
+ *
+ * This is the deferred version of {@link flush()}.
+ */
+void SpriteBatch::record() {
+    DeferredCommand command;
+    command.texture = _texture;
+    command.command = _command;
+    command.quads = _quadMode;
+    command.blendEquation = _blendEquation;
+    command.srcFactor = _srcFactor;
+    command.dstFactor = _dstFactor;
+    command.indxStart = command.indxCount = 0;
+    
+    if (_quadMode) {
+        if (_quadSize == 0) {
+            return;
+        }
+        command.start = (unsigned int)_recordQuads.size();
+        command.count = _quadSize;
+        _recordQuads.insert(_recordQuads.end(), _quadData, _quadData+_quadSize);
+        _quadSize = 0;
+    } else {
+        if (_indxSize == 0 || _vertSize == 0) {
+            _vertSize = _indxSize = 0;
+            return;
+        }
+        command.start = (unsigned int)_recordVerts.size();
+        command.count = _vertSize;
+        command.indxStart = (unsigned int)_recordIndx.size();
+        command.indxCount = _indxSize;
+        _recordVerts.insert(_recordVerts.end(), _vertData, _vertData+_vertSize);
+        if (_indxShort) {
+            _recordIndx.insert(_recordIndx.end(), _indxShort, _indxShort+_indxSize);
+        } else {
+            _recordIndx.insert(_recordIndx.end(), _indxData, _indxData+_indxSize);
+        }
+        _vertSize = _indxSize = 0;
+    }
+    _commands.push_back(command);
+}
+
+/**
+ * Adds the recorded quads to the mesh, as {@link fillQuad} does without instancing.
+ *
+ * @param quads The quads to add
+ * @param count The number of quads
+ */
+void SpriteBatch::appendQuads(const QuadInstance* quads, unsigned int count) {
+    setQuadMode(false);
+    setCommand(GL_TRIANGLES);
+    for(unsigned int ii = 0; ii < count; ii++) {
+        reserve(4, 6);
+        const QuadInstance& quad = quads[ii];
+        unsigned int vstart = _vertSize;
+        for(int jj = 0; jj < 4; jj++) {
+            float u = cu_quad_corners[2*jj];
+            float v = cu_quad_corners[2*jj+1];
+            Vertex2& vert = _vertData[vstart+jj];
+            vert.position = quad.origin+quad.axisX*u+quad.axisY*v;
+            vert.texcoord.set(u ? quad.texcoord1.x : quad.texcoord0.x,
+                              v ? quad.texcoord1.y : quad.texcoord0.y);
+            vert.color = quad.color;
+        }
+        for(int jj = 0; jj < 6; jj++) {
+            setIndex(_indxSize+jj, vstart+cu_quad_indices[jj]);
+        }
+        _vertSize += 4;
+        _indxSize += 6;
+    }
+}
+
+/**
+ * Makes room in the mesh for a shape of the given size.
+ *
+ * The mesh is flushed if the shape does not fit.  A deferred batch also
+ * records the shape size, so that a replay flushes before the same shapes.
+ *
+ * @param vsize The number of vertices in the shape
+ * @param isize The number of indices in the shape
+ */
+void SpriteBatch::reserve(unsigned int vsize, unsigned int isize) {
+    if (_vertSize+vsize > _vertMax || _indxSize+isize > _indxMax) {
+        flush();
+    }
+    if (_deferred) {
+        _recordShapes.push_back(vsize);
+        _recordShapes.push_back(isize);
+    }
+}
+
+/**
+ * Applies the blend function to the OpenGL state.
+ *
+ * The alpha channel is blended separately while a render target is
+ * active, so that the target holds the correct coverage.
+ */
+void SpriteBatch::applyBlendFunc() {
+    if (_target != nullptr) {
+        GLState::setBlendFuncSeparate(_srcFactor, _dstFactor, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        GLState::setBlendFunc(_srcFactor, _dstFactor);
+    }
+}
+
+/**
+ * Returns the layout of the vertex mesh after packing it for upload.
+ *
+ * If the result is not FULL, the packed mesh is in the staging buffer.
+ * The result is the preferred layout, unless the mesh cannot be
+ * represented in that layout.
+ *
+ * @return the layout of the vertex mesh after packing it for upload.
+ */
+VertexLayout SpriteBatch::packVertices() {
+    if (_layout == VertexLayout::FULL) {
+        return VertexLayout::FULL;
+    }
+    
+    // Normalized texture coordinates cannot repeat
+    for(unsigned int ii = 0; ii < _vertSize; ii++) {
+        const Vec2& tex = _vertData[ii].texcoord;
+        if (tex.x < 0 || tex.x > 1 || tex.y < 0 || tex.y > 1) {
+            return VertexLayout::FULL;
+        }
+    }
+    
+    VertexLayout layout = _layout;
+    if (layout == VertexLayout::HALF) {
+        for(unsigned int ii = 0; ii < _vertSize; ii++) {
+            const Vec2& pos = _vertData[ii].position;
+            if (std::fabs(pos.x) > HALF_POSITION_LIMIT || std::fabs(pos.y) > HALF_POSITION_LIMIT) {
+                layout = VertexLayout::COMPACT;
+                break;
+            }
+        }
+    }
+    
+    if (_packData == nullptr) {
+        _packData = new Uint8[_vertMax*sizeof(CompactVertex2)];
+    }
+    
+    if (layout == VertexLayout::HALF) {
+        HalfVertex2* dst = reinterpret_cast<HalfVertex2*>(_packData);
+        for(unsigned int ii = 0; ii < _vertSize; ii++) {
+            const Vertex2& src = _vertData[ii];
+            dst[ii].position[0] = cu_float_to_half(src.position.x);
+            dst[ii].position[1] = cu_float_to_half(src.position.y);
+            dst[ii].color = src.color;
+            dst[ii].texcoord[0] = cu_normalize_texcoord(src.texcoord.x);
+            dst[ii].texcoord[1] = cu_normalize_texcoord(src.texcoord.y);
+        }
+    } else {
+        CompactVertex2* dst = reinterpret_cast<CompactVertex2*>(_packData);
+        for(unsigned int ii = 0; ii < _vertSize; ii++) {
+            const Vertex2& src = _vertData[ii];
+            dst[ii].position = src.position;
+            dst[ii].color = src.color;
+            dst[ii].texcoord[0] = cu_normalize_texcoord(src.texcoord.x);
+            dst[ii].texcoord[1] = cu_normalize_texcoord(src.texcoord.y);
+        }
+    }
+    return layout;
+}
+
 /**
  * Returns the number of vertices added to the drawing buffer.
  *
@@ -1396,11 +2069,10 @@ bool SpriteBatch::validateBuffer(GLuint buffer, const char* message) {
  * @return the number of vertices added to the drawing buffer.
  */
 unsigned int SpriteBatch::prepare(const Rect& rect, bool solid) {
-    if (_vertSize+4 > _vertMax ||  _indxSize+8 > _indxMax) {
-        flush();
-    }
-    
+    setQuadMode(false);
     Poly2 poly(rect, solid);
+    reserve((unsigned int)poly.getVertices().size(), (unsigned int)poly.getIndices().size());
+    
     unsigned int vstart = _vertSize;
     int ii = 0;
     for(auto it = poly.getVertices().begin(); it != poly.getVertices().end(); ++it) {
@@ -1418,7 +2090,7 @@ unsigned int SpriteBatch::prepare(const Rect& rect, bool solid) {
     int jj = 0;
     unsigned int istart = _indxSize;
     for(auto it = poly.getIndices().begin(); it != poly.getIndices().end(); ++it) {
-        _indxData[istart+jj] = vstart+(*it);
+        setIndex(istart+jj, vstart+(*it));
         jj++;
     }
     
@@ -1441,10 +2113,8 @@ unsigned int SpriteBatch::prepare(const Rect& rect, bool solid) {
 unsigned int SpriteBatch::prepare(const Poly2& poly, bool solid) {
     CUAssertLog((solid ? poly.getIndices().size() % 3 : poly.getIndices().size() % 2) == 0,
                 "Polynomial has the wrong number of indices: %d", (int)poly.getIndices().size());
-    if (_vertSize+poly.getVertices().size() > _vertMax ||
-        _indxSize+poly.getIndices().size()  > _indxMax) {
-        flush();
-    }
+    setQuadMode(false);
+    reserve((unsigned int)poly.getVertices().size(), (unsigned int)poly.getIndices().size());
     
     unsigned int vstart = _vertSize;
     int ii = 0;
@@ -1463,7 +2133,7 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, bool solid) {
     int jj = 0;
     unsigned int istart = _indxSize;
     for(auto it = poly.getIndices().begin(); it != poly.getIndices().end(); ++it) {
-        _indxData[istart+jj] = vstart+(*it);
+        setIndex(istart+jj, vstart+(*it));
         jj++;
     }
     
@@ -1494,9 +2164,8 @@ unsigned int SpriteBatch::prepare(const Vertex2* vertices, unsigned int vsize, u
                                   bool solid, bool tint) {
     CUAssertLog((solid ? isize % 3 : isize % 2) == 0,
                 "Vertex mesh has the wrong number of indices: %d", isize);
-    if (_vertSize+vsize > _vertMax || _indxSize+isize  > _indxMax) {
-        flush();
-    }
+    setQuadMode(false);
+    reserve(vsize, isize);
     
     int ii = 0;
     unsigned int vstart = _vertSize;
@@ -1511,7 +2180,7 @@ unsigned int SpriteBatch::prepare(const Vertex2* vertices, unsigned int vsize, u
     int jj = 0;
     unsigned int istart = _indxSize;
     for(int kk = ioffset; jj < isize; jj++) {
-        _indxData[istart+jj] = vstart+indices[kk+jj];
+        setIndex(istart+jj, vstart+indices[kk+jj]);
     }
     
     _vertSize += ii;
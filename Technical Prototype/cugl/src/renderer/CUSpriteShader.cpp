@@ -42,18 +42,26 @@
 
 #include <cugl/renderer/CUSpriteShader.h>
 #include <cugl/renderer/CUVertex.h>
+#include <cugl/renderer/CUGLState.h>
 #include <cugl/util/CUDebug.h>
 
 // The shaders
 #include "ColorTextureOpenGL.vert"
 #include "ColorTextureOpenGL.frag"
+#include "QuadTextureOpenGL.vert"
 
 // The names of the shader attributes and uniforms
 #define POSITION_ATTRIBUTE  "aPosition"
 #define COLOR_ATTRIBUTE     "aColor"
 #define TEXCOORD_ATTRIBUTE  "aTexCoord"
+#define CORNER_ATTRIBUTE    "aCorner"
+#define AXISX_ATTRIBUTE     "aAxisX"
+#define AXISY_ATTRIBUTE     "aAxisY"
+#define ORIGIN_ATTRIBUTE    "aOrigin"
+#define TEXRECT_ATTRIBUTE   "aTexRect"
 #define PERSPECTIVE_UNIFORM "uPerspective"
 #define TEXTURE_UNIFORM     "uTexture"
+#define DISTANCE_UNIFORM    "uDistance"
 #define TEXTURE_POSITION    0
 
 using namespace cugl;
@@ -95,6 +103,26 @@ bool SpriteShader::init(const char* vsource, const char* fsource) {
     return compile();
 }
 
+/**
+ * Initializes this shader as an instanced quad shader.
+ *
+ * The shader uses the default instanced vertex source and the default
+ * fragment source.  It draws one {@link QuadInstance} per instance
+ * (see {@link attachQuads}).
+ *
+ * When compilation is complete, the shader will not be bound.  However,
+ * any shader that was actively bound during compilation also be unbound
+ * as well.
+ *
+ * @return true if initialization was successful.
+ */
+bool SpriteShader::initQuads() {
+    _vertSource = oglQuadTextureVert;
+    _fragSource = oglColorTextureFrag;
+    _instanced = true;
+    return compile();
+}
+
 #pragma mark -
 #pragma mark Attributes
 /**
@@ -106,20 +134,29 @@ void SpriteShader::setPerspective(const Mat4& matrix) {
     _mPerspective = matrix;
     if (_active) {
         glUniformMatrix4fv(_uPerspective,1,false,_mPerspective.m);
+        GLState::countCalls();
     }
 }
 
 /**
  * Sets the texture in use in the shader
  *
+ * If the texture is a signed distance field, this method also switches
+ * the shader to distance field rendering (and back again otherwise).
+ *
  * @param testure   The shader texture
  */
 void SpriteShader::setTexture(const std::shared_ptr<Texture>& texture) {
     _mTexture = texture;
+    bool distance = _mTexture != nullptr && _mTexture->isDistanceField();
     if (_active) {
-        glActiveTexture(GL_TEXTURE0 + TEXTURE_POSITION);
-        glBindTexture(GL_TEXTURE_2D, _mTexture->getBuffer());
+        GLState::bindTexture(TEXTURE_POSITION, _mTexture->getBuffer());
+        if (_uDistance != -1 && distance != _mDistance) {
+            glUniform1i(_uDistance, distance);
+            GLState::countCalls();
+        }
     }
+    _mDistance = distance;
 }
 
 #pragma mark -
@@ -131,49 +168,132 @@ void SpriteShader::setTexture(const std::shared_ptr<Texture>& texture) {
  * Because of limitations in OpenGL ES, we cannot draw anything without
  * both a vertex buffer object and an vertex array object.
  *
+ * The layout specifies the format of the vertices in the buffer (see
+ * {@link VertexLayout}).  The attribute types are recorded in the vertex
+ * array object, so this method must be called again whenever the layout
+ * of the buffer changes.
+ *
  * @param vArray    The vertex array object
  * @param vBuffer   The vertex buffer object
+ * @param layout    The layout of the vertex buffer
  */
-void SpriteShader::attach(GLuint vArray, GLuint vBuffer) {
+void SpriteShader::attach(GLuint vArray, GLuint vBuffer, VertexLayout layout) {
     CUAssertLog(_active, "This shader is not currently active");
 
-    glBindVertexArray(vArray);
-    glBindBuffer(GL_ARRAY_BUFFER, vBuffer);
+    GLState::bindVertexArray(vArray);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, vBuffer);
     
-    glVertexAttribPointer( _aPosition, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2),
-                          Vertex2::positionOffset());
-    glVertexAttribPointer( _aColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex2),
-                          Vertex2::colorOffset());
-    glVertexAttribPointer( _aTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2),
-                          Vertex2::texcoordOffset());
+    switch (layout) {
+        case VertexLayout::FULL:
+            glVertexAttribPointer( _aPosition, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2),
+                                  Vertex2::positionOffset());
+            glVertexAttribPointer( _aColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex2),
+                                  Vertex2::colorOffset());
+            glVertexAttribPointer( _aTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2),
+                                  Vertex2::texcoordOffset());
+            break;
+        case VertexLayout::COMPACT:
+            glVertexAttribPointer( _aPosition, 2, GL_FLOAT, GL_FALSE, sizeof(CompactVertex2),
+                                  CompactVertex2::positionOffset());
+            glVertexAttribPointer( _aColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CompactVertex2),
+                                  CompactVertex2::colorOffset());
+            glVertexAttribPointer( _aTexCoord, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex2),
+                                  CompactVertex2::texcoordOffset());
+            break;
+        case VertexLayout::HALF:
+            glVertexAttribPointer( _aPosition, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(HalfVertex2),
+                                  HalfVertex2::positionOffset());
+            glVertexAttribPointer( _aColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HalfVertex2),
+                                  HalfVertex2::colorOffset());
+            glVertexAttribPointer( _aTexCoord, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(HalfVertex2),
+                                  HalfVertex2::texcoordOffset());
+            break;
+    }
+    GLState::countCalls(3);
+}
+
+/**
+ * Attaches the given quad buffers to this instanced shader.
+ *
+ * The corner buffer holds the four corners of the unit square (as Vec2)
+ * in triangle strip order.  The quad buffer holds one QuadInstance per
+ * instance.  The attribute layout is recorded in the vertex array object,
+ * so this method only needs to be called once per vertex array (and
+ * not on every use).  The vertex array remains bound afterwards.
+ *
+ * @param vArray    The vertex array object
+ * @param cBuffer   The corner buffer object
+ * @param qBuffer   The quad instance buffer object
+ */
+void SpriteShader::attachQuads(GLuint vArray, GLuint cBuffer, GLuint qBuffer) {
+    CUAssertLog(_instanced, "This shader is not instanced");
+
+    GLState::bindVertexArray(vArray);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, cBuffer);
+    glEnableVertexAttribArray(_aCorner);
+    glVertexAttribPointer(_aCorner, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), 0);
+    glVertexAttribDivisor(_aCorner, 0);
+
+    GLint attribs[] = { _aAxisX, _aAxisY, _aOrigin, _aTexRect, _aColor };
+    const GLvoid* offsets[] = {
+        QuadInstance::axisXOffset(), QuadInstance::axisYOffset(), QuadInstance::originOffset(),
+        QuadInstance::texcoordOffset(), QuadInstance::colorOffset()
+    };
+    GLState::bindBuffer(GL_ARRAY_BUFFER, qBuffer);
+    for(int ii = 0; ii < 5; ii++) {
+        glEnableVertexAttribArray(attribs[ii]);
+        if (attribs[ii] == _aColor) {
+            glVertexAttribPointer(attribs[ii], 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                                  sizeof(QuadInstance), offsets[ii]);
+        } else {
+            GLint size = (attribs[ii] == _aTexRect ? 4 : 2);
+            glVertexAttribPointer(attribs[ii], size, GL_FLOAT, GL_FALSE,
+                                  sizeof(QuadInstance), offsets[ii]);
+        }
+        glVertexAttribDivisor(attribs[ii], 1);
+    }
+    GLState::countCalls(18);
 }
 
 /**
  * Binds this shader, making it active.
  *
- * Once bound, any OpenGL calls will then be sent to this shader.
+ * Once bound, any OpenGL calls will then be sent to this shader.  Unless
+ * the shader is instanced, this enables the vertex attributes of the
+ * bound vertex array.
  */
 void SpriteShader::bind() {
     Shader::bind();
-    glEnableVertexAttribArray(_aPosition);
-    glEnableVertexAttribArray(_aColor);
-    glEnableVertexAttribArray(_aTexCoord);
+    if (!_instanced) {
+        glEnableVertexAttribArray(_aPosition);
+        glEnableVertexAttribArray(_aColor);
+        glEnableVertexAttribArray(_aTexCoord);
+        GLState::countCalls(3);
+    }
     if (_mTexture != nullptr) {
-        glActiveTexture(GL_TEXTURE0 + TEXTURE_POSITION);
-        glBindTexture(GL_TEXTURE_2D, _mTexture->getBuffer());
+        GLState::bindTexture(TEXTURE_POSITION, _mTexture->getBuffer());
+    }
+    if (_uDistance != -1) {
+        glUniform1i(_uDistance, _mDistance);
+        GLState::countCalls();
     }
 }
 
 /**
  * Unbinds this shader, making it no longer active.
  *
- * Once unbound, OpenGL calls will no longer be sent to this shader.
+ * Once unbound, OpenGL calls will no longer be sent to this shader.  Unless
+ * the shader is instanced, this disables the vertex attributes of the
+ * bound vertex array.
  */
 void SpriteShader::unbind() {
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisableVertexAttribArray(_aPosition);
-    glDisableVertexAttribArray(_aColor);
-    glDisableVertexAttribArray(_aTexCoord);
+    GLState::bindTexture(TEXTURE_POSITION, 0);
+    if (!_instanced) {
+        glDisableVertexAttribArray(_aPosition);
+        glDisableVertexAttribArray(_aColor);
+        glDisableVertexAttribArray(_aTexCoord);
+        GLState::countCalls(3);
+    }
     Shader::unbind();
 }
 
@@ -196,22 +316,38 @@ bool SpriteShader::compile() {
     if (!Shader::compile()) return false;
     
     // Find each of the attributes
-    _aPosition = glGetAttribLocation( _program, POSITION_ATTRIBUTE );
-    if( !validateVariable(_aPosition, POSITION_ATTRIBUTE)) {
-        dispose();
-        return false;
-    }
-    
     _aColor = glGetAttribLocation( _program, COLOR_ATTRIBUTE );
     if( !validateVariable(_aColor, COLOR_ATTRIBUTE)) {
         dispose();
         return false;
     }
     
-    _aTexCoord = glGetAttribLocation( _program, TEXCOORD_ATTRIBUTE );
-    if( !validateVariable(_aTexCoord, TEXCOORD_ATTRIBUTE)) {
-        dispose();
-        return false;
+    if (_instanced) {
+        _aCorner  = glGetAttribLocation( _program, CORNER_ATTRIBUTE );
+        _aAxisX   = glGetAttribLocation( _program, AXISX_ATTRIBUTE );
+        _aAxisY   = glGetAttribLocation( _program, AXISY_ATTRIBUTE );
+        _aOrigin  = glGetAttribLocation( _program, ORIGIN_ATTRIBUTE );
+        _aTexRect = glGetAttribLocation( _program, TEXRECT_ATTRIBUTE );
+        if( !validateVariable(_aCorner, CORNER_ATTRIBUTE) ||
+            !validateVariable(_aAxisX, AXISX_ATTRIBUTE)   ||
+            !validateVariable(_aAxisY, AXISY_ATTRIBUTE)   ||
+            !validateVariable(_aOrigin, ORIGIN_ATTRIBUTE) ||
+            !validateVariable(_aTexRect, TEXRECT_ATTRIBUTE)) {
+            dispose();
+            return false;
+        }
+    } else {
+        _aPosition = glGetAttribLocation( _program, POSITION_ATTRIBUTE );
+        if( !validateVariable(_aPosition, POSITION_ATTRIBUTE)) {
+            dispose();
+            return false;
+        }
+        
+        _aTexCoord = glGetAttribLocation( _program, TEXCOORD_ATTRIBUTE );
+        if( !validateVariable(_aTexCoord, TEXCOORD_ATTRIBUTE)) {
+            dispose();
+            return false;
+        }
     }
     
     _uPerspective = glGetUniformLocation( _program, PERSPECTIVE_UNIFORM );
@@ -226,6 +362,9 @@ bool SpriteShader::compile() {
         return false;
     }
     
+    // The distance field uniform is optional
+    _uDistance = glGetUniformLocation( _program, DISTANCE_UNIFORM );
+    
     // Set the texture location and matrix
     bind();
     glUniformMatrix4fv(_uPerspective,1,false,_mPerspective.m);
@@ -261,6 +400,9 @@ bool SpriteShader::validateVariable(GLint variable, const char* name) {
  */
 void SpriteShader::dispose() {
     if (_mTexture != nullptr) { _mTexture.reset(); }
+    _uDistance = -1;
+    _mDistance = false;
+    _instanced = false;
     Shader::dispose();
 }
 
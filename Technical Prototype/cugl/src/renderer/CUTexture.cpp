@@ -9,6 +9,9 @@
 #include <SDL/SDL.h>
 #include <SDL/SDL_image.h>
 #include <cugl/renderer/CUTexture.h>
+#include <cugl/renderer/CUKTXImage.h>
+#include <cugl/renderer/CUGLState.h>
+#include <cugl/io/CUAssetArchive.h>
 #include <cugl/util/CUDebug.h>
 #include <sstream>
 
@@ -33,6 +36,9 @@ _magFilter(GL_LINEAR),
 _wrapS(GL_CLAMP_TO_EDGE),
 _wrapT(GL_CLAMP_TO_EDGE),
 _hasMipmaps(false),
+_compressed(0),
+_byteSize(0),
+_distance(false),
 _parent(nullptr),
 _minS(0),
 _maxS(1),
@@ -49,7 +55,7 @@ void Texture::dispose() {
     if (_buffer != 0) {
         // Do we own the texture?
         if (_parent == nullptr) {
-            glDeleteTextures(1, &_buffer);
+            GLState::deleteTexture(_buffer);
         }
         _buffer = 0;
         _width = 0; _height = 0;
@@ -61,6 +67,9 @@ void Texture::dispose() {
         _minS = _minT = 0;
         _maxS = _maxT = 1;
         _hasMipmaps = false;
+        _compressed = 0;
+        _byteSize = 0;
+        _distance = false;
         _active = false;
     }
 }
@@ -82,7 +91,7 @@ void Texture::dispose() {
  */
 bool Texture::init(int width, int height, Texture::PixelFormat format) {
     CUAssertLog(nextPOT(width)  == width, "Width  %d is not a power of two", width);
-    CUAssertLog(nextPOT(height) == width, "Height %d is not a power of two", height);
+    CUAssertLog(nextPOT(height) == height, "Height %d is not a power of two", height);
     if (_buffer) {
         CUAssertLog(false, "Texture is already initialized");
         return false; // In case asserts are off.
@@ -96,13 +105,14 @@ bool Texture::init(int width, int height, Texture::PixelFormat format) {
     _width  = width;
     _height = height;
     _pixelFormat = format;
-    glBindTexture(GL_TEXTURE_2D, _buffer);
+    GLState::bindTexture(_buffer);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
     glTexImage2D(GL_TEXTURE_2D, 0, (GLenum)format, width, height, 0, (GLenum)format, GL_UNSIGNED_BYTE, nullptr);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(0);
+    _byteSize = (size_t)width*height*(format == PixelFormat::RGBA ? 4 : 1);
     setName("<empty>");
     return true;
 }
@@ -137,13 +147,14 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
     _width  = width;
     _height = height;
     _pixelFormat = format;
-    glBindTexture(GL_TEXTURE_2D, _buffer);
+    GLState::bindTexture(_buffer);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
     glTexImage2D(GL_TEXTURE_2D, 0, (GLenum)format, width, height, 0, (GLenum)format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(0);
+    _byteSize = (size_t)width*height*(format == PixelFormat::RGBA ? 4 : 1);
     std::stringstream ss;
     ss << "@" << data;
     setName(ss.str());
@@ -163,6 +174,10 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
  * The texture will be stored in RGBA format, even if it is a file format
  * that does not support transparency (e.g. JPEG).
  *
+ * If the file has a .ktx extension, it is loaded as a KTX image instead,
+ * as if by {@link initWithKTX}.  If the image is compressed in a format
+ * that this platform does not support, it is decompressed on the CPU.
+ *
  * @param filename  The file supporting the texture file.
  * @param height    The texture height in pixels
  * @param format    The texture data format
@@ -170,7 +185,22 @@ bool Texture::initWithData(const void *data, int width, int height, Texture::Pix
  * @return true if initialization was successful.
  */
 bool Texture::initWithFile(const std::string& filename) {
-    SDL_Surface* surface = IMG_Load(filename.c_str());
+    size_t len = filename.size();
+    if (len > 4 && filename.compare(len-4,4,".ktx") == 0) {
+        std::shared_ptr<KTXImage> image = KTXImage::alloc(filename);
+        if (image == nullptr) {
+            return false;
+        }
+        KTXImage::querySupport();
+        if (!image->isSupported()) {
+            image = image->decompress();
+        }
+        bool result = image != nullptr && initWithKTX(image);
+        if (result) setName(filename);
+        return result;
+    }
+
+    SDL_Surface* surface = IMG_Load_RW(AssetArchive::openFile(filename,"rb"),1);
     if (surface == nullptr) {
         return false;
     }
@@ -192,6 +222,76 @@ bool Texture::initWithFile(const std::string& filename) {
     return result;
 }
 
+/**
+ * Initializes a texture with the data from the given KTX image.
+ *
+ * When initialization is done, the texture is no longer bound.  However,
+ * any other texture that was bound during initialization is also no longer
+ * bound.
+ *
+ * Every mipmap level in the image is uploaded.  If the image is ETC
+ * compressed, it is uploaded with glCompressedTexImage2D and stays
+ * compressed on the GPU.  In that case the format must be supported
+ * by the platform (see {@link KTXImage#isSupported}).
+ *
+ * @param image     The KTX image
+ *
+ * @return true if initialization was successful.
+ */
+bool Texture::initWithKTX(const std::shared_ptr<KTXImage>& image) {
+    if (_buffer) {
+        CUAssertLog(false, "Texture is already initialized");
+        return false; // In case asserts are off.
+    }
+    CUAssertLog(image->isSupported(), "Compressed format 0x%04X is not supported", image->getInternalFormat());
+
+    glGenTextures(1, &_buffer);
+    if (_buffer == 0) {
+        return false;
+    }
+
+    _width  = image->getWidth();
+    _height = image->getHeight();
+    _pixelFormat = (image->hasAlpha() ? PixelFormat::RGBA : PixelFormat::RGB);
+    _compressed  = (image->isCompressed() ? image->getInternalFormat() : 0);
+    _hasMipmaps  = image->getLevels() > 1;
+    _byteSize = image->getByteSize();
+    GLState::bindTexture(_buffer);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
+    // KTX pads every uncompressed row to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for(unsigned int ii = 0; ii < image->getLevels(); ii++) {
+        if (_compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, ii, _compressed,
+                                   image->getWidth(ii), image->getHeight(ii), 0,
+                                   (GLsizei)image->getDataSize(ii), image->getData(ii));
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, ii, image->getFormat(),
+                         image->getWidth(ii), image->getHeight(ii), 0,
+                         image->getFormat(), image->getType(), image->getData(ii));
+        }
+    }
+    if (_hasMipmaps) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->getLevels()-1);
+    }
+    GLState::bindTexture(0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        CULogError("Unable to upload KTX image (GL error 0x%04X)", error);
+        GLState::deleteTexture(_buffer);
+        _buffer = 0;
+        return false;
+    }
+    std::stringstream ss;
+    ss << "@" << image.get();
+    setName(ss.str());
+    return true;
+}
+
 #pragma mark -
 #pragma mark Setters
 
@@ -208,12 +308,46 @@ bool Texture::initWithFile(const std::string& filename) {
  * @return a reference to this (modified) texture for chaining.
  */
 const Texture& Texture::set(const void *data) {
+    CUAssertLog(!_compressed, "Cannot set the data of a compressed texture");
     if (!_active) { bind(); }
     glTexImage2D(GL_TEXTURE_2D, 0, (GLenum)_pixelFormat, _width, _height, 0,
                  (GLenum)_pixelFormat, GL_UNSIGNED_BYTE, data);
     return *this;
 }
 
+/**
+ * Sets a rectangular region of this texture to the contents of the buffer.
+ *
+ * The buffer must have the correct data format, and be size width*height*
+ * format.  The region is measured in pixels, with the origin at the first
+ * row of the texture data.
+ *
+ * Unlike {@link set}, this method preserves the current texture binding.
+ * So it is safe to call during a drawing pass, such as when a font adds
+ * a glyph to its atlas.  It may not be used on a compressed texture or a
+ * subtexture.
+ *
+ * @param data      The buffer to read into the texture
+ * @param x         The left edge of the region
+ * @param y         The top edge of the region
+ * @param width     The region width
+ * @param height    The region height
+ *
+ * @return a reference to this (modified) texture for chaining.
+ */
+const Texture& Texture::setRegion(const void *data, int x, int y, int width, int height) {
+    CUAssertLog(!_compressed, "Cannot set the data of a compressed texture");
+    CUAssertLog(_parent == nullptr, "Cannot set the data of a subtexture");
+    CUAssertLog(x >= 0 && y >= 0 && x+width <= (int)_width && y+height <= (int)_height,
+                "Region [%d,%d]x[%d,%d] is out of bounds", x, x+width, y, y+height);
+    GLuint bound = GLState::getTexture();
+    GLState::bindTexture(_buffer);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+                    (GLenum)_pixelFormat, GL_UNSIGNED_BYTE, data);
+    GLState::bindTexture(bound);
+    return *this;
+}
+
 
 #pragma mark -
 #pragma mark Attributes
@@ -230,10 +364,32 @@ void Texture::buildMipMaps() {
     CUAssertLog(nextPOT(_height) == _height, "Height %d is not a power of two", _height);
     CUAssertLog(_parent == nullptr, "Cannot build mipmaps for a subtexture");
     CUAssertLog(_active, "Texture is not active");
+    if (_compressed) {
+        CUWarn("Cannot build mipmaps for compressed texture %s", _name.c_str());
+        return;
+    }
     glGenerateMipmap(GL_TEXTURE_2D);
+    if (!_hasMipmaps) {
+        _byteSize += _byteSize/3;
+    }
     _hasMipmaps = true;
 }
 
+/**
+ * Sets whether this texture stores a signed distance field.
+ *
+ * A distance field texture stores the distance to a shape edge in its
+ * alpha channel, with 0.5 on the edge itself.  A {@link SpriteShader}
+ * renders these textures with a smooth threshold, so that they stay sharp
+ * at any scale.  This value may not be set on a subtexture.
+ *
+ * @param value Whether this texture stores a signed distance field
+ */
+void Texture::setDistanceField(bool value) {
+    CUAssertLog(_parent == nullptr, "Cannot change a subtexture to a distance field");
+    _distance = value;
+}
+
 /**
  * Sets the min filter of this texture.
  *
@@ -392,7 +548,7 @@ void Texture::bind() {
     
     CUAssertLog(_buffer, "Texture is not defined");
     CUAssertLog(!_active, "Texture is already active");
-    glBindTexture(GL_TEXTURE_2D, _buffer);
+    GLState::bindTexture(_buffer);
     _active = true;
 }
 
@@ -408,7 +564,7 @@ void Texture::unbind() {
     }
     
     CUAssertLog(_active, "Texture is not active");
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::bindTexture(0);
     _active = false;
 }
 
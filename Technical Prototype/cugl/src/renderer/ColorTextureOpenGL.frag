@@ -50,8 +50,17 @@ in vec2 outTexCoord;
 // Texture map
 uniform sampler2D uTexture;
 
+// Whether the texture is a signed distance field
+uniform int uDistance;
+
 void main(void) {
-    frag_color = texture(uTexture, outTexCoord)*outColor;
+    vec4 texel = texture(uTexture, outTexCoord);
+    if (uDistance != 0) {
+        // The edge is at 0.5; smooth it over about one screen pixel
+        float width = max(fwidth(texel.a)*0.7, 0.001);
+        texel.a = smoothstep(0.5-width, 0.5+width, texel.a);
+    }
+    frag_color = texel*outColor;
 }
 
 /////////// SHADER END //////////
@@ -80,8 +89,17 @@ in vec2 outTexCoord;
 // Texture map
 uniform sampler2D uTexture;
 
+// Whether the texture is a signed distance field
+uniform int uDistance;
+
 void main(void) {
-    frag_color = texture(uTexture, outTexCoord)*outColor;
+    vec4 texel = texture(uTexture, outTexCoord);
+    if (uDistance != 0) {
+        // The edge is at 0.5; smooth it over about one screen pixel
+        float width = max(fwidth(texel.a)*0.7, 0.001);
+        texel.a = smoothstep(0.5-width, 0.5+width, texel.a);
+    }
+    frag_color = texel*outColor;
 }
 
 /////////// SHADER END //////////
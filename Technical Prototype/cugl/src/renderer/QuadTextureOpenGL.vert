@@ -0,0 +1,69 @@
+//
+//  QuadTextureOpenGL.vert
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides the instanced SpriteBatch vertex shader in both OpenGL
+//  and OpenGL ES.  Each instance is a textured quad (see QuadInstance), and the
+//  shader expands it to the four corners of a triangle strip.  It is paired
+//  with the standard SpriteBatch fragment shader.
+//
+//  CUGL zlib License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Version: 10/19/26
+
+#include <cugl/renderer/CUShader.h>
+
+/**
+ * Instanced quad shader for OpenGL and OpenGL ES
+ */
+const char* oglQuadTextureVert = SHADER(
+////////// SHADER BEGIN /////////
+
+// The corner of the unit square (per vertex)
+in vec2 aCorner;
+
+// The quad transform (per instance)
+in vec2 aAxisX;
+in vec2 aAxisY;
+in vec2 aOrigin;
+
+// The texture coordinates at corners (0,0) and (1,1) (per instance)
+in vec4 aTexRect;
+
+// Colors (per instance)
+in  vec4 aColor;
+out vec4 outColor;
+
+// Texture coordinates
+out vec2 outTexCoord;
+
+// Matrices
+uniform mat4 uPerspective;
+
+// Expand the corner and pass through
+void main(void) {
+    vec2 position = aOrigin+aCorner.x*aAxisX+aCorner.y*aAxisY;
+    gl_Position = uPerspective*vec4(position,0.0,1.0);
+    outColor = aColor;
+    outTexCoord = mix(aTexRect.xy,aTexRect.zw,aCorner);
+}
+
+/////////// SHADER END //////////
+);
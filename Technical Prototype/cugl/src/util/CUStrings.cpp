@@ -11,6 +11,10 @@
 //  long, etc.  Those types are NOT cross-platform.  For example, a long is
 //  8 bytes on Unix/OS X, but 4 bytes on some Win32 platforms.
 //
+//  The functions to_chars and from_chars work on caller-provided buffers and
+//  never allocate.  They are the ones to use in per-frame code.  The string
+//  functions are built on top of them.
+//
 //  CUGL zlib License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -37,10 +41,10 @@
 #include <string>
 #include <iostream>
 #include <sstream>
-
-#if defined (__ANDROID__)
+#include <cstring>
 #include <cstdlib>
-#endif
+#include <limits>
+#include <cctype>
 
 namespace cugl {
 
@@ -55,13 +59,8 @@ namespace cugl {
  * @return a string equivalent to the given byte
  */
 std::string to_string(Uint8 value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << (Uint32)value;
-    return ss.str();
-#else
-    return std::to_string((Uint32)value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -72,13 +71,8 @@ std::string to_string(Uint8 value) {
  * @return a string equivalent to the given signed 16 bit integer
  */
 std::string to_string(Sint16 value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << (Sint32)value;
-    return ss.str();
-#else
-    return std::to_string((Sint32)value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -89,13 +83,8 @@ std::string to_string(Sint16 value) {
  * @return a string equivalent to the given unsigned 16 bit integer
  */
 std::string to_string(Uint16 value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << (Uint32)value;
-    return ss.str();
-#else
-    return std::to_string((Uint32)value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -106,13 +95,8 @@ std::string to_string(Uint16 value) {
  * @return a string equivalent to the given signed 32 bit integer
  */
 std::string to_string(Sint32 value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
-#else
-    return std::to_string(value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -123,13 +107,8 @@ std::string to_string(Sint32 value) {
  * @return a string equivalent to the given unsigned 32 bit integer
  */
 std::string to_string(Uint32 value ) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
-#else
-    return std::to_string(value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -140,13 +119,8 @@ std::string to_string(Uint32 value ) {
  * @return a string equivalent to the given signed 64 bit integer
  */
 std::string to_string(Sint64 value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
-#else
-    return std::to_string(value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
@@ -157,51 +131,40 @@ std::string to_string(Sint64 value) {
  * @return a string equivalent to the given unsigned 64 bit integer
  */
 std::string to_string(Uint64 value ) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
-#else
-    return std::to_string(value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 /**
  * Returns a string equivalent to the given float value
  *
- * The precision is the same as std::to_string(float).
+ * The value reads back as the same float, and is nearly always the shortest
+ * decimal that does so.
  *
  * @param  value    the numeric value to convert
  *
  * @return a string equivalent to the given float value
  */
 std::string to_string(float value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value << 'f';
-    return ss.str();
-#else
-    return std::to_string(value)+"f";
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    char* end = to_chars(buffer, buffer+CU_NUMBER_BUFFER-1, value);
+    *end++ = 'f';
+    return std::string(buffer, end);
 }
 
 /**
  * Returns a string equivalent to the given double value
  *
- * The precision is the same as std::to_string(double).
+ * The value reads back as the same double, and is nearly always the shortest
+ * decimal that does so.
  *
  * @param  value    the numeric value to convert
  *
  * @return a string equivalent to the given double value
  */
 std::string to_string(double value) {
-#if defined (__ANDROID__)
-    std::stringstream ss;
-    ss << value;
-    return ss.str();
-#else
-    return std::to_string(value);
-#endif
+    char buffer[CU_NUMBER_BUFFER];
+    return std::string(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, value));
 }
 
 
@@ -219,16 +182,16 @@ std::string to_string(double value) {
  * @return a string equivalent to the given byte array
  */
 std::string to_string(Uint8* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << (Uint32)array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 /**
@@ -243,16 +206,16 @@ std::string to_string(Uint8* array, size_t length, size_t offset) {
  * @return a string equivalent to the signed 16 bit integer array
  */
 std::string to_string(Sint16* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 /**
@@ -267,16 +230,16 @@ std::string to_string(Sint16* array, size_t length, size_t offset) {
  * @return a string equivalent to the unsigned 16 bit integer array
  */
 std::string to_string(Uint16* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 
@@ -292,16 +255,16 @@ std::string to_string(Uint16* array, size_t length, size_t offset) {
  * @return a string equivalent to the signed 32 bit integer array
  */
 std::string to_string(Sint32* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 
@@ -317,16 +280,16 @@ std::string to_string(Sint32* array, size_t length, size_t offset) {
  * @return a string equivalent to the unsigned 32 bit integer array
  */
 std::string to_string(Uint32* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 /**
@@ -341,16 +304,16 @@ std::string to_string(Uint32* array, size_t length, size_t offset) {
  * @return a string equivalent to the signed 64 bit integer array
  */
 std::string to_string(Sint64* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 
@@ -366,16 +329,16 @@ std::string to_string(Sint64* array, size_t length, size_t offset) {
  * @return a string equivalent to the unsigned 64 bit integer array
  */
 std::string to_string(Uint64* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 
@@ -391,16 +354,17 @@ std::string to_string(Uint64* array, size_t length, size_t offset) {
  * @return a string equivalent to the given float array
  */
 std::string to_string(float* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset] << 'f';
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
+        result.push_back('f');
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 /**
@@ -415,16 +379,16 @@ std::string to_string(float* array, size_t length, size_t offset) {
  * @return a string equivalent to the given double array
  */
 std::string to_string(double* array, size_t length, size_t offset) {
-    std::stringstream ss;
-    ss << "[";
+    char buffer[CU_NUMBER_BUFFER];
+    std::string result("[");
     for(int ii = 0; ii < length; ii++) {
-        ss << array[ii+offset];
+        result.append(buffer, to_chars(buffer, buffer+CU_NUMBER_BUFFER, array[ii+offset]));
         if (ii != length-1) {
-            ss << ", ";
+            result.append(", ");
         }
     }
-    ss << "]";
-    return ss.str();
+    result.push_back(']');
+    return result;
 }
 
 
@@ -606,7 +570,7 @@ Uint64 stou64(const std::string& str, std::size_t* pos, int base) {
 #if defined (__ANDROID__)
     const char* start = str.c_str();
     char* end;
-    int result = (Uint64)std::strtoull(start, &end, base);
+    Uint64 result = (Uint64)std::strtoull(start, &end, base);
     *pos = (std::size_t)(end-start); // Bad but no alternative on android
     return result;
 #else
@@ -628,11 +592,28 @@ Uint64 stou64(const std::string& str, std::size_t* pos, int base) {
  * @return the float equivalent to the given string
  */
 float  stof(const std::string& str, std::size_t* pos) {
-#if defined (__ANDROID__)
+    // Try the fast parser first, as the C++ conversions consult the locale
     const char* start = str.c_str();
-    char* end;
-    float result = (float)std::strtod(start, &end);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
+    const char* first = start;
+    while (std::isspace((unsigned char)*first)) {
+        first++;
+    }
+    float result;
+    const char* last = start+str.size();
+    const char* end = from_chars(first, last, result);
+    if (end && (end == last || (*end != 'x' && *end != 'X'))) {
+        if (pos) {
+            *pos = (std::size_t)(end-start);
+        }
+        return result;
+    }
+
+#if defined (__ANDROID__)
+    char* stop;
+    result = (float)std::strtod(start, &stop);
+    if (pos) {
+        *pos = (std::size_t)(stop-start); // Bad but no alternative on android
+    }
     return result;
 #else
     return std::stof(str,pos);
@@ -653,15 +634,1091 @@ float  stof(const std::string& str, std::size_t* pos) {
  * @return the double equivalent to the given string
  */
 double stod(const std::string& str, std::size_t* pos) {
-#if defined (__ANDROID__)
+    // Try the fast parser first, as the C++ conversions consult the locale
     const char* start = str.c_str();
-    char* end;
-    double result = std::strtod(start, &end);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
+    const char* first = start;
+    while (std::isspace((unsigned char)*first)) {
+        first++;
+    }
+    double result;
+    const char* last = start+str.size();
+    const char* end = from_chars(first, last, result);
+    if (end && (end == last || (*end != 'x' && *end != 'X'))) {
+        if (pos) {
+            *pos = (std::size_t)(end-start);
+        }
+        return result;
+    }
+
+#if defined (__ANDROID__)
+    char* stop;
+    result = std::strtod(start, &stop);
+    if (pos) {
+        *pos = (std::size_t)(stop-start); // Bad but no alternative on android
+    }
     return result;
 #else
     return std::stod(str,pos);
 #endif
 }
+
+#pragma mark -
+#pragma mark BUFFER FUNCTIONS
+
+/** The strings "00" to "99", so that integers are written two digits at a time */
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * Writes the given unsigned integer to the buffer [first, last)
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+static char* write_unsigned(char* first, char* last, Uint64 value) {
+    int digits = 1;
+    for(Uint64 bound = 10; digits < 20 && value >= bound; bound *= 10) {
+        digits++;
+    }
+    if (last-first < digits) {
+        return nullptr;
+    }
+
+    // Fill in from the right
+    char* result = first+digits;
+    char* pos = result;
+    while (value >= 100) {
+        size_t pair = (size_t)(value % 100)*2;
+        value /= 100;
+        *--pos = DIGIT_PAIRS[pair+1];
+        *--pos = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        size_t pair = (size_t)value*2;
+        *--pos = DIGIT_PAIRS[pair+1];
+        *--pos = DIGIT_PAIRS[pair];
+    } else {
+        *--pos = (char)('0'+value);
+    }
+    return result;
+}
+
+/**
+ * Writes the given signed integer to the buffer [first, last)
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+static char* write_signed(char* first, char* last, Sint64 value) {
+    if (value >= 0) {
+        return write_unsigned(first, last, (Uint64)value);
+    } else if (first == last) {
+        return nullptr;
+    }
+    *first = '-';
+    return write_unsigned(first+1, last, 0-(Uint64)value);
+}
+
+/**
+ * A floating point value f * 2^e with a 64 bit significand
+ *
+ * This is the "do-it-yourself" float of the Grisu algorithm (Loitsch, "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers", 2010).
+ */
+typedef struct {
+    /** The significand */
+    Uint64 f;
+    /** The binary exponent */
+    int e;
+} DiyFp;
+
+/**
+ * Returns the product x * y, rounded to 64 bits of significand
+ *
+ * @param  x    the first factor
+ * @param  y    the second factor
+ *
+ * @return the product x * y, rounded to 64 bits of significand
+ */
+static DiyFp diy_multiply(DiyFp x, DiyFp y) {
+    Uint64 xlo = x.f & 0xFFFFFFFF;
+    Uint64 xhi = x.f >> 32;
+    Uint64 ylo = y.f & 0xFFFFFFFF;
+    Uint64 yhi = y.f >> 32;
+
+    Uint64 p0 = xlo*ylo;
+    Uint64 p1 = xlo*yhi;
+    Uint64 p2 = xhi*ylo;
+    Uint64 p3 = xhi*yhi;
+
+    // The middle word, plus half a unit to round the low word away
+    Uint64 mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF) + ((Uint64)1 << 31);
+    DiyFp result;
+    result.f = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    result.e = x.e+y.e+64;
+    return result;
+}
+
+/**
+ * Returns x shifted so that the top bit of its significand is set
+ *
+ * @param  x    the value to normalize (must be nonzero)
+ *
+ * @return x shifted so that the top bit of its significand is set
+ */
+static DiyFp diy_normalize(DiyFp x) {
+    while ((x.f >> 63) == 0) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+/**
+ * The normalized powers of ten 10^k for k = -300, -292, ..., 324
+ *
+ * Each entry is the significand, the binary exponent, and the decimal exponent.
+ * Consecutive entries are 8 decades apart, which is enough to scale any double
+ * (or float) into the window required by the digit generation.
+ */
+static const struct {
+    Uint64 f;
+    int e;
+    int k;
+} CACHED_POWERS[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 }};
+
+/**
+ * Returns the number of decimal digits in value, storing the largest power of ten
+ *
+ * @param  value    the value to measure
+ * @param  power    the variable to store the largest power of ten <= value
+ *
+ * @return the number of decimal digits in value
+ */
+static int largest_power10(Uint32 value, Uint32& power) {
+    int digits = 10;
+    power = 1000000000;
+    while (digits > 1 && value < power) {
+        power /= 10;
+        digits--;
+    }
+    return digits;
+}
+
+/**
+ * Rounds the last digit of the buffer towards the exact value
+ *
+ * This is the "weed" step of Grisu2.  It moves the generated digits closer to
+ * the exact value while they stay within the rounding interval.
+ *
+ * @param  buffer   the generated digits
+ * @param  length   the number of generated digits
+ * @param  distance the distance from the exact value to the upper boundary
+ * @param  delta    the width of the rounding interval
+ * @param  rest     the distance from the digits to the upper boundary
+ * @param  tenk     the value of one unit in the last digit
+ */
+static void grisu_round(char* buffer, int length, Uint64 distance, Uint64 delta,
+                        Uint64 rest, Uint64 tenk) {
+    while (rest < distance && delta-rest >= tenk &&
+           (rest+tenk < distance || distance-rest > rest+tenk-distance)) {
+        buffer[length-1]--;
+        rest += tenk;
+    }
+}
+
+/**
+ * Generates the shortest digits in the interval (low, high) closest to value
+ *
+ * All three values must share the same exponent, which must lie in [-60, -32].
+ *
+ * @param  buffer   the buffer to store the digits
+ * @param  exponent the decimal exponent, which is adjusted for the digits
+ * @param  low      the lower boundary of the interval
+ * @param  value    the scaled value
+ * @param  high     the upper boundary of the interval
+ *
+ * @return the number of generated digits
+ */
+static int grisu_digits(char* buffer, int& exponent, DiyFp low, DiyFp value, DiyFp high) {
+    Uint64 delta = high.f-low.f;
+    Uint64 distance = high.f-value.f;
+
+    // Split the upper boundary into an integral and a fractional part
+    int shift = -high.e;
+    Uint64 one = (Uint64)1 << shift;
+    Uint32 integral = (Uint32)(high.f >> shift);
+    Uint64 fraction = high.f & (one-1);
+
+    int length = 0;
+    Uint32 power;
+    int digits = largest_power10(integral, power);
+    while (digits > 0) {
+        buffer[length++] = (char)('0'+integral/power);
+        integral %= power;
+        digits--;
+
+        Uint64 rest = ((Uint64)integral << shift)+fraction;
+        if (rest <= delta) {
+            exponent += digits;
+            grisu_round(buffer, length, distance, delta, rest, (Uint64)power << shift);
+            return length;
+        }
+        power /= 10;
+    }
+
+    // The integral part was not enough, so continue with the fraction
+    int places = 0;
+    do {
+        fraction *= 10;
+        delta *= 10;
+        distance *= 10;
+        buffer[length++] = (char)('0'+(fraction >> shift));
+        fraction &= one-1;
+        places++;
+    } while (fraction > delta);
+    exponent -= places;
+    grisu_round(buffer, length, distance, delta, fraction, one);
+    return length;
+}
+
+/**
+ * Generates the shortest digits that read back as the given finite value
+ *
+ * The value is given by its IEEE fields, so that the same code handles both
+ * float and double.  The value must be positive.
+ *
+ * @param  buffer       the buffer to store the digits (at least 17 characters)
+ * @param  exponent     the variable to store the decimal exponent
+ * @param  fraction     the stored fraction bits
+ * @param  biased       the stored (biased) exponent
+ * @param  precision    the significand bits, including the hidden bit
+ * @param  bias         the exponent bias, including the fraction bits
+ *
+ * @return the number of generated digits
+ */
+static int grisu_shortest(char* buffer, int& exponent, Uint64 fraction, int biased,
+                          int precision, int bias) {
+    // Compute the value and the boundaries of its rounding interval
+    DiyFp value;
+    if (biased == 0) {
+        value.f = fraction;
+        value.e = 1-bias;
+    } else {
+        value.f = fraction | ((Uint64)1 << (precision-1));
+        value.e = biased-bias;
+    }
+    bool closer = (fraction == 0 && biased > 1);
+
+    DiyFp high = { 2*value.f+1, value.e-1 };
+    DiyFp low  = closer ? DiyFp{ 4*value.f-1, value.e-2 } : DiyFp{ 2*value.f-1, value.e-1 };
+    high  = diy_normalize(high);
+    low.f = low.f << (low.e-high.e);
+    low.e = high.e;
+    value = diy_normalize(value);
+
+    // Scale by a cached power of ten so the exponent lands in [-60, -32]
+    int target = -61-high.e;
+    int k = (target*78913)/(1 << 18)+(target > 0);
+    int index = (300+k+7)/8;
+    DiyFp cached = { CACHED_POWERS[index].f, CACHED_POWERS[index].e };
+    exponent = -CACHED_POWERS[index].k;
+
+    DiyFp scaled = diy_multiply(value, cached);
+    low  = diy_multiply(low,  cached);
+    high = diy_multiply(high, cached);
+
+    // Shrink the interval to account for the rounding in the multiplication
+    low.f++;
+    high.f--;
+    return grisu_digits(buffer, exponent, low, scaled, high);
+}
+
+/**
+ * Lays out the digits d1...dn * 10^exponent in place, returning the new end
+ *
+ * Values with a decimal point position in (minexp, maxexp] are written in
+ * fixed notation.  All others use exponent notation.
+ *
+ * @param  buffer   the generated digits, with room for the decimal layout
+ * @param  length   the number of generated digits
+ * @param  exponent the decimal exponent of the last digit
+ * @param  minexp   the smallest decimal point position for fixed notation
+ * @param  maxexp   the largest decimal point position for fixed notation
+ *
+ * @return one past the last character written
+ */
+static char* format_digits(char* buffer, int length, int exponent, int minexp, int maxexp) {
+    int point = length+exponent;
+    if (length <= point && point <= maxexp) {
+        // digits000.0
+        std::memset(buffer+length, '0', point-length);
+        buffer[point  ] = '.';
+        buffer[point+1] = '0';
+        return buffer+point+2;
+    } else if (0 < point && point <= maxexp) {
+        // dig.its
+        std::memmove(buffer+point+1, buffer+point, length-point);
+        buffer[point] = '.';
+        return buffer+length+1;
+    } else if (minexp < point && point <= 0) {
+        // 0.000digits
+        std::memmove(buffer+2-point, buffer, length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        std::memset(buffer+2, '0', -point);
+        return buffer+2-point+length;
+    }
+
+    // d.igitse+XX
+    char* pos = buffer+1;
+    if (length > 1) {
+        std::memmove(buffer+2, buffer+1, length-1);
+        buffer[1] = '.';
+        pos = buffer+length+1;
+    }
+    int power = point-1;
+    *pos++ = 'e';
+    *pos++ = power < 0 ? '-' : '+';
+    power = power < 0 ? -power : power;
+    if (power >= 100) {
+        *pos++ = (char)('0'+power/100);
+        power %= 100;
+    }
+    *pos++ = DIGIT_PAIRS[power*2];
+    *pos++ = DIGIT_PAIRS[power*2+1];
+    return pos;
+}
+
+/**
+ * Writes the given IEEE value to the buffer [first, last)
+ *
+ * The value is given by its IEEE fields, so that the same code handles both
+ * float and double.
+ *
+ * @param  first        the start of the buffer
+ * @param  last         the end of the buffer
+ * @param  negative     whether the sign bit is set
+ * @param  fraction     the stored fraction bits
+ * @param  biased       the stored (biased) exponent
+ * @param  precision    the significand bits, including the hidden bit
+ * @param  bias         the exponent bias, including the fraction bits
+ * @param  maxexp       the largest decimal point position for fixed notation
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+static char* write_real(char* first, char* last, bool negative, Uint64 fraction, int biased,
+                        int precision, int bias, int maxexp) {
+    char temp[CU_NUMBER_BUFFER];
+    char* pos = temp;
+    int special = (precision > 24) ? 0x7FF : 0xFF;
+    if (biased == special) {
+        const char* text = fraction ? "nan" : (negative ? "-inf" : "inf");
+        size_t size = std::strlen(text);
+        std::memcpy(temp, text, size);
+        pos = temp+size;
+    } else {
+        if (negative) {
+            *pos++ = '-';
+        }
+        if (biased == 0 && fraction == 0) {
+            *pos++ = '0';
+            *pos++ = '.';
+            *pos++ = '0';
+        } else {
+            int exponent;
+            int length = grisu_shortest(pos, exponent, fraction, biased, precision, bias);
+            pos = format_digits(pos, length, exponent, -4, maxexp);
+        }
+    }
+
+    size_t size = pos-temp;
+    if ((size_t)(last-first) < size) {
+        return nullptr;
+    }
+    std::memcpy(first, temp, size);
+    return first+size;
+}
+
+/**
+ * Reads an unsigned integer no larger than limit from the buffer [first, last)
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  limit    the largest allowed value
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+static const char* read_unsigned(const char* first, const char* last, Uint64 limit, Uint64& value) {
+    Uint64 result = 0;
+    const char* pos = first;
+    while (pos < last && *pos >= '0' && *pos <= '9') {
+        Uint64 digit = (Uint64)(*pos-'0');
+        if (result > (limit-digit)/10) {
+            return nullptr;
+        }
+        result = result*10+digit;
+        pos++;
+    }
+    if (pos == first) {
+        return nullptr;
+    }
+    value = result;
+    return pos;
+}
+
+/**
+ * Reads a signed integer in [-limit-1, limit] from the buffer [first, last)
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  limit    the largest allowed value
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+static const char* read_signed(const char* first, const char* last, Uint64 limit, Sint64& value) {
+    bool negative = (first < last && *first == '-');
+    Uint64 magnitude;
+    const char* pos = read_unsigned(first+negative, last, limit+negative, magnitude);
+    if (pos) {
+        value = negative ? (Sint64)(0-magnitude) : (Sint64)magnitude;
+    }
+    return pos;
+}
+
+/** The longest number passed to the C library when the fast path fails */
+#define PARSE_LIMIT 127
+
+/** The powers of ten that are exact as a double */
+static const double EXACT_POWERS[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** The powers of ten that are exact as a float */
+static const float EXACT_POWERS_F[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+/**
+ * Scans a decimal number at the start of the buffer [first, last)
+ *
+ * The number is decomposed as mantissa * 10^exponent.  The mantissa keeps the
+ * first 19 significant digits.  If any later digit is nonzero, the mantissa is
+ * not exact, and the caller must use a slower conversion.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  negative the variable to store the sign
+ * @param  mantissa the variable to store the significant digits
+ * @param  exponent the variable to store the decimal exponent
+ * @param  exact    the variable to store whether the mantissa is exact
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+static const char* scan_real(const char* first, const char* last, bool& negative,
+                             Uint64& mantissa, int& exponent, bool& exact) {
+    const char* pos = first;
+    negative = (pos < last && *pos == '-');
+    pos += negative;
+
+    mantissa = 0;
+    exponent = 0;
+    exact = true;
+    int digits = 0;
+    bool found = false;
+    bool point = false;
+    for(; pos < last; pos++) {
+        if (*pos == '.' && !point) {
+            point = true;
+            continue;
+        } else if (*pos < '0' || *pos > '9') {
+            break;
+        }
+        found = true;
+        int digit = *pos-'0';
+        if (digits < 19 && (digit || mantissa)) {
+            mantissa = mantissa*10+digit;
+            exponent -= point;
+            digits++;
+        } else if (digits < 19) {
+            exponent -= point; // A leading zero
+        } else {
+            exponent += !point;
+            exact = exact && !digit;
+        }
+    }
+    if (!found) {
+        return nullptr;
+    }
+
+    // The exponent is optional, and ignored if it has no digits
+    if (pos < last && (*pos == 'e' || *pos == 'E')) {
+        const char* mark = pos++;
+        bool minus = (pos < last && *pos == '-');
+        pos += (pos < last && (*pos == '-' || *pos == '+'));
+        int power = 0;
+        const char* start = pos;
+        for(; pos < last && *pos >= '0' && *pos <= '9'; pos++) {
+            power = power < 100000 ? power*10+(*pos-'0') : power;
+        }
+        if (pos == start) {
+            pos = mark;
+        } else {
+            exponent += minus ? -power : power;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Copies [first, last) into the buffer as a null terminated string
+ *
+ * @param  first    the start of the number
+ * @param  last     the end of the number
+ * @param  buffer   a buffer with room for PARSE_LIMIT+1 characters
+ *
+ * @return true if the number fit in the buffer
+ */
+static bool copy_number(const char* first, const char* last, char* buffer) {
+    size_t size = last-first;
+    if (size > PARSE_LIMIT) {
+        return false;
+    }
+    std::memcpy(buffer, first, size);
+    buffer[size] = 0;
+    return true;
+}
+
+/**
+ * Writes the given byte to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Uint8 value) {
+    return write_unsigned(first, last, value);
+}
+
+/**
+ * Writes the given signed 16 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Sint16 value) {
+    return write_signed(first, last, value);
+}
+
+/**
+ * Writes the given unsigned 16 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Uint16 value) {
+    return write_unsigned(first, last, value);
+}
+
+/**
+ * Writes the given signed 32 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Sint32 value) {
+    return write_signed(first, last, value);
+}
+
+/**
+ * Writes the given unsigned 32 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Uint32 value) {
+    return write_unsigned(first, last, value);
+}
+
+/**
+ * Writes the given signed 64 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Sint64 value) {
+    return write_signed(first, last, value);
+}
+
+/**
+ * Writes the given unsigned 64 bit integer to the buffer [first, last)
+ *
+ * The value is written in decimal with no null terminator.  A buffer of
+ * CU_NUMBER_BUFFER characters is always large enough.  This function never
+ * allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, Uint64 value) {
+    return write_unsigned(first, last, value);
+}
+
+/**
+ * Writes the given float to the buffer [first, last)
+ *
+ * The value reads back as the same float, and is nearly always the shortest
+ * decimal that does so.
+ * Large and small values use exponent notation (e.g. 1e+20), and all
+ * other values have a decimal point (e.g. 1.0).  Infinities and NaN are
+ * written as inf, -inf, and nan.
+ *
+ * The value has no null terminator.  A buffer of CU_NUMBER_BUFFER characters
+ * is always large enough.  This function never allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, float value) {
+    Uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return write_real(first, last, (bits >> 31) != 0, bits & 0x7FFFFF,
+                      (int)((bits >> 23) & 0xFF), 24, 150, 7);
+}
+
+/**
+ * Writes the given double to the buffer [first, last)
+ *
+ * The value reads back as the same double, and is nearly always the shortest
+ * decimal that does so.
+ * Large and small values use exponent notation (e.g. 1e+20), and all
+ * other values have a decimal point (e.g. 1.0).  Infinities and NaN are
+ * written as inf, -inf, and nan.
+ *
+ * The value has no null terminator.  A buffer of CU_NUMBER_BUFFER characters
+ * is always large enough.  This function never allocates memory.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the numeric value to write
+ *
+ * @return one past the last character written, or nullptr if there is no room
+ */
+char* to_chars(char* first, char* last, double value) {
+    Uint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return write_real(first, last, (bits >> 63) != 0, bits & 0xFFFFFFFFFFFFFULL,
+                      (int)((bits >> 52) & 0x7FF), 53, 1075, 15);
+}
+
+/**
+ * Reads a byte from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Uint8& value) {
+    Uint64 result;
+    const char* pos = read_unsigned(first, last, std::numeric_limits<Uint8>::max(), result);
+    if (pos) {
+        value = (Uint8)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a signed 16 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Sint16& value) {
+    Sint64 result;
+    const char* pos = read_signed(first, last, std::numeric_limits<Sint16>::max(), result);
+    if (pos) {
+        value = (Sint16)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a unsigned 16 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Uint16& value) {
+    Uint64 result;
+    const char* pos = read_unsigned(first, last, std::numeric_limits<Uint16>::max(), result);
+    if (pos) {
+        value = (Uint16)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a signed 32 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Sint32& value) {
+    Sint64 result;
+    const char* pos = read_signed(first, last, std::numeric_limits<Sint32>::max(), result);
+    if (pos) {
+        value = (Sint32)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a unsigned 32 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Uint32& value) {
+    Uint64 result;
+    const char* pos = read_unsigned(first, last, std::numeric_limits<Uint32>::max(), result);
+    if (pos) {
+        value = (Uint32)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a signed 64 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits, optionally preceded by a minus sign.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Sint64& value) {
+    Sint64 result;
+    const char* pos = read_signed(first, last, std::numeric_limits<Sint64>::max(), result);
+    if (pos) {
+        value = (Sint64)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a unsigned 64 bit integer from the start of the buffer [first, last)
+ *
+ * The buffer must begin with decimal digits.  Unlike stoi and
+ * its relatives, this function does not skip whitespace.  It never
+ * allocates memory.
+ *
+ * If the buffer does not start with a number, or the number does not fit
+ * in the type, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, Uint64& value) {
+    Uint64 result;
+    const char* pos = read_unsigned(first, last, std::numeric_limits<Uint64>::max(), result);
+    if (pos) {
+        value = (Uint64)result;
+    }
+    return pos;
+}
+
+/**
+ * Reads a float from the start of the buffer [first, last)
+ *
+ * The buffer must begin with a decimal number, optionally preceded by a
+ * minus sign and followed by an exponent.  Unlike stof and stod, this
+ * function does not skip whitespace, and it does not accept hexadecimal,
+ * inf, or nan.  It never allocates memory.
+ *
+ * If the buffer does not start with a number, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, float& value) {
+    bool negative;
+    bool exact;
+    Uint64 mantissa;
+    int exponent;
+    const char* pos = scan_real(first, last, negative, mantissa, exponent, exact);
+    if (!pos) {
+        return nullptr;
+    }
+
+    // An exact mantissa and power of ten need only one rounding (Clinger)
+    if (mantissa == 0) {
+        value = negative ? -0.0f : 0.0f;
+        return pos;
+    } else if (exact && mantissa <= (1 << 24) && exponent >= -10 && exponent <= 10) {
+        float result = (float)mantissa;
+        if (exponent < 0) {
+            result /= EXACT_POWERS_F[-exponent];
+        } else {
+            result *= EXACT_POWERS_F[exponent];
+        }
+        value = negative ? -result : result;
+        return pos;
+    }
+
+    char buffer[PARSE_LIMIT+1];
+    if (!copy_number(first, pos, buffer)) {
+        return nullptr;
+    }
+    value = std::strtof(buffer, nullptr);
+    return pos;
+}
+
+/**
+ * Reads a double from the start of the buffer [first, last)
+ *
+ * The buffer must begin with a decimal number, optionally preceded by a
+ * minus sign and followed by an exponent.  Unlike stof and stod, this
+ * function does not skip whitespace, and it does not accept hexadecimal,
+ * inf, or nan.  It never allocates memory.
+ *
+ * If the buffer does not start with a number, then value is not changed.
+ *
+ * @param  first    the start of the buffer
+ * @param  last     the end of the buffer
+ * @param  value    the variable to store the number
+ *
+ * @return one past the last character read, or nullptr on failure
+ */
+const char* from_chars(const char* first, const char* last, double& value) {
+    bool negative;
+    bool exact;
+    Uint64 mantissa;
+    int exponent;
+    const char* pos = scan_real(first, last, negative, mantissa, exponent, exact);
+    if (!pos) {
+        return nullptr;
+    }
+
+    // An exact mantissa and power of ten need only one rounding (Clinger)
+    if (mantissa == 0) {
+        value = negative ? -0.0 : 0.0;
+        return pos;
+    } else if (exact && mantissa <= ((Uint64)1 << 53) && exponent >= -22 && exponent <= 22) {
+        double result = (double)mantissa;
+        if (exponent < 0) {
+            result /= EXACT_POWERS[-exponent];
+        } else {
+            result *= EXACT_POWERS[exponent];
+        }
+        value = negative ? -result : result;
+        return pos;
+    }
+
+    char buffer[PARSE_LIMIT+1];
+    if (!copy_number(first, pos, buffer)) {
+        return nullptr;
+    }
+    value = std::strtod(buffer, nullptr);
+    return pos;
+}
     
 }
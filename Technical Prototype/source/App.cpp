@@ -9,7 +9,9 @@ using namespace cugl;
 std::shared_ptr<cugl::AssetManager> App::AssetManager = nullptr;
 InputController App::InputController;
 AnimationController App::AnimationController;
+std::shared_ptr<cugl::SpriteAnimator> App::SpriteAnimator = nullptr;
 AudioController App:: AudioController;
+SaveStore App::SaveStore;
 
 /**
  * The method called after OpenGL is initialized, but before running the application.
@@ -22,10 +24,19 @@ AudioController App:: AudioController;
  * causing the application to run.
  */
 void App::onStartup() {
+  // Read assets from the packed archive when the build provides one
+  std::shared_ptr<AssetArchive> archive = AssetArchive::allocWithAsset("assets.pack");
+  if (archive != nullptr) {
+    AssetArchive::mount(archive);
+  }
+
   // Initialize the asset manager static object.
   AssetManager = AssetManager::alloc();
   
   _batch  = SpriteBatch::alloc();
+  // Opt in to instanced rectangles and the compact vertex layout
+  _batch->setInstancing(true);
+  _batch->setVertexLayout(VertexLayout::COMPACT);
   
   // Start-up basic input
   #ifdef CU_TOUCH_SCREEN
@@ -50,10 +61,23 @@ void App::onStartup() {
   Application::get()->setClearColor(Color4f::BLACK);
     
   // Queue up the other assets
+#if CU_PLATFORM == CU_PLATFORM_ANDROID
+  // The mixer shares the engine device on Android, so match its block size
+  AudioEngine::start(AUDIO_INPUT_CHANNELS, MIXER_BLOCK_SIZE);
+#else
   AudioEngine::start();
+#endif
+  SoundMixer::start();
   AssetManager->loadDirectoryAsync("json/assets.json",nullptr);
     
   AnimationController.init();
+  SpriteAnimator = cugl::SpriteAnimator::alloc();
+  
+  // Load the game progress (it is saved in the background from now on)
+  SaveStore.init(getSaveDirectory());
+  
+  // Handle input as it arrives instead of once per frame
+  setImmediateInput(true);
     
   
   Application::onStartup(); // YOU MUST END with call to parent
@@ -75,6 +99,7 @@ void App::onShutdown() {
   _gameMode.dispose();
   _titleMode.dispose();
   AssetManager = nullptr;
+  SpriteAnimator = nullptr;
   _batch = nullptr;
   
   // Shutdown input
@@ -84,7 +109,10 @@ void App::onShutdown() {
     Input::deactivate<Mouse>();
   #endif
   
+  SoundMixer::stop();
   AudioEngine::stop();
+  AssetArchive::unmountAll();
+  SaveStore.dispose();
   Application::onShutdown();  // YOU MUST END with call to parent
 }
 
@@ -104,6 +132,11 @@ void App::onSuspend() {
   // to pause it and continue where the player left off. However I doubt players
   // are going to remember the audio when they suspended the app...
   AudioEngine::get()->pauseAll();
+  if (SoundMixer::get()) {
+    SoundMixer::get()->pause();
+  }
+  // We may never come back, so leave a complete snapshot behind
+  SaveStore.checkpoint();
 }
 
 /**
@@ -118,6 +151,9 @@ void App::onSuspend() {
  */
 void App::onResume() {
   AudioEngine::get()->resumeAll();
+  if (SoundMixer::get()) {
+    SoundMixer::get()->resume();
+  }
 }
 
 
@@ -142,6 +178,8 @@ void App::update(float timestep) {
   // below will suffice for now.
     
     AnimationController.update(timestep);
+    SpriteAnimator->update(timestep);
+    AudioController.update();
   
   if (!_loaded && !_loadingMode.isComplete()) {
       _loadingMode.update(timestep);
@@ -149,6 +187,9 @@ void App::update(float timestep) {
       _loadingMode.dispose(); // Disables the input listeners in this mode
     
       InputController.init();
+      AudioController.prepareSoundEffect(AssetManager->get<Sound>(DOOR_OPEN));
+      AudioController.prepareSoundEffect(AssetManager->get<Sound>(SWITCH_TILE));
+      AudioController.prepareSoundEffect(AssetManager->get<Sound>(GRAB_COLLECTABLE));
       auto bg_music = AssetManager->get<Music>(BG_MUSIC2);
       AudioController.playBackgroundMusic(bg_music);
       
@@ -159,7 +200,7 @@ void App::update(float timestep) {
       _titleMode.update(timestep);
   } else if (!_gameStarted) {
       auto sound = AssetManager->get<Sound>(DOOR_OPEN);
-      AudioController.playSoundEffect(DOOR_OPEN,sound);
+      AudioController.playSoundEffect(DOOR_OPEN,sound,1);
       AudioController.stopBackgroundMusic();
       auto bg_music = AssetManager->get<Music>(BG_MUSIC1);
       AudioController.playBackgroundMusic(bg_music);
@@ -201,52 +242,13 @@ void App::draw() {
 
 // The function to save to the game progress file
 void App::saveGame(int level){
-    // save file
-    int current_level = 1;
-    
-    App a;
-    string save_file = a.getSaveDirectory() + "/save.txt";
-    a.dispose();
-
-    
-    // get the current level in save file
-    std::string line;
-    std::ifstream myfile(save_file.c_str());
-    if (myfile.is_open()) {
-        while ( getline(myfile, line) ) {
-            current_level = std::atoi(line.c_str());
-        }
-        myfile.close();
-    }
-    
-    // write to save file if the level is greater
-    if (level+1>current_level && level+1<=MAX_LEVELS){
-        FILE *f = fopen(save_file.c_str(),"w");
-        fprintf(f, "%i", level+1);
-        fclose(f);
+    // unlock the next level if it is greater
+    if (level+1>readSaveFile() && level+1<=MAX_LEVELS){
+        SaveStore.setValue(SAVE_LEVEL, level+1);
     }
 }
 
 // The function to retreive the current level from the game progress file
 int App::readSaveFile(){
-    int current_level=1;
-    
-    App a;
-    string save_file = a.getSaveDirectory() + "/save.txt";
-    a.dispose();
-    
-    std::string line;
-    std::ifstream myfile(save_file.c_str());
-    if (myfile.is_open()) {
-        while ( getline(myfile, line) ) {
-            current_level = std::atoi(line.c_str());
-        }
-        myfile.close();
-    } else { // file has not yet been created, start at level 1
-        FILE *f = fopen(save_file.c_str(),"w");
-        fprintf(f, "%i", current_level);
-        fclose(f);
-    }
-    return current_level;
+    return SaveStore.getValue(SAVE_LEVEL, 1);
 }
-
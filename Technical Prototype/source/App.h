@@ -8,12 +8,16 @@
 #include "AnimationController.hpp"
 #include "TitleMode.hpp"
 #include "AudioController.hpp"
+#include "SaveStore.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 #define MAX_LEVELS 30
 
+/** The save key for the highest unlocked level */
+#define SAVE_LEVEL "level"
+
 using namespace std;
 
 /**
@@ -63,6 +67,11 @@ class App : public cugl::Application {
   
     // The global animation controller
     static AnimationController AnimationController;
+    // The global sprite animator (advances every sprite animation at once)
+    static std::shared_ptr<cugl::SpriteAnimator> SpriteAnimator;
+  
+    // The global save store (game progress, written in the background)
+    static SaveStore SaveStore;
     
     // The function to save to the game progress file
     static void saveGame(int level);
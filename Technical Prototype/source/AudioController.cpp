@@ -7,26 +7,60 @@
 //
 
 #include "AudioController.hpp"
+#include "App.h"
 
 
 AudioController::AudioController(){
 }
 
+// Ogg tracks are streamed by the software mixer, which crossfades them.  Our
+// music is currently MP3, which always goes through the audio engine, as
+// does any track on a build without music streams (CU_MUSIC_STREAM).
 void AudioController::playBackgroundMusic(std::shared_ptr<Music> bg_music){
-        AudioEngine::get()->queueMusic(bg_music,true, 1, 2.2);
+    if (SoundMixer::get() && bg_music->getSuffix() == ".ogg" &&
+        SoundMixer::get()->playMusic(bg_music, true, 1, 2.2)) {
+        return;
+    }
+    AudioEngine::get()->queueMusic(bg_music,true, 1, 2.2);
 }
 
 
 
 void AudioController::stopBackgroundMusic(){
-    AudioEngine::get()->stopMusic(2.2);
+    if (SoundMixer::get() && SoundMixer::get()->isMusicPlaying()) {
+        SoundMixer::get()->stopMusic(2.2);
+    } else {
+        AudioEngine::get()->stopMusic(2.2);
+    }
     
 }
 
-void AudioController::playSoundEffect(std::string key, std::shared_ptr<Sound> sound){
-    AudioEngine::get()->playEffect(key, sound);
+// Decode the effect into the mixer cache so the first play does not stall
+void AudioController::prepareSoundEffect(std::shared_ptr<Sound> sound){
+    if (SoundMixer::get()) {
+        SoundMixer::get()->prepare(sound);
+    }
+}
+
+// The key is only needed if the software mixer failed to start
+void AudioController::playSoundEffect(std::string key, std::shared_ptr<Sound> sound, int priority){
+    if (SoundMixer::get()) {
+        SoundMixer::get()->play(sound, priority);
+    } else {
+        AudioEngine::get()->playEffect(key, sound);
+    }
 }
 
 void AudioController::stopSoundEffect(std::string key){
-    AudioEngine::get()->stopEffect(key);
+    if (SoundMixer::get()) {
+        SoundMixer::get()->stopSound(App::AssetManager->get<Sound>(key));
+    } else {
+        AudioEngine::get()->stopEffect(key);
+    }
+}
+
+void AudioController::update(){
+    if (SoundMixer::get()) {
+        SoundMixer::get()->update();
+    }
 }
@@ -36,8 +36,12 @@ public:
     
     void stopBackgroundMusic();
     
-    void playSoundEffect(std::string key, std::shared_ptr<Sound> sound);
+    void prepareSoundEffect(std::shared_ptr<Sound> sound);
+    
+    void playSoundEffect(std::string key, std::shared_ptr<Sound> sound, int priority = 0);
     
     void stopSoundEffect(std::string key);
+    
+    void update();
 };
 #endif /* AudioController_hpp */
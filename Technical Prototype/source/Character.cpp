@@ -17,6 +17,23 @@
 
 using namespace cugl;
 
+std::shared_ptr<AnimationClip> Character::walkingClip;
+std::shared_ptr<AnimationClip> Character::climbingClip;
+std::shared_ptr<AnimationClip> Character::pickupClip;
+std::shared_ptr<AnimationClip> Character::fallBeginClip;
+std::shared_ptr<AnimationClip> Character::fallingClip;
+std::shared_ptr<AnimationClip> Character::landingClip;
+
+/**
+ Destroys this Character, releasing all resources. The animator must let go
+ of the animation node.
+ */
+Character::~Character() {
+    if (App::SpriteAnimator != nullptr && current_node != nullptr) {
+        App::SpriteAnimator->stop(current_node);
+    }
+}
+
 bool Character::init(Vec2 pos, bool facingRight) {
     // The size of the character should be a constant.
     if (CapsuleObstacle::init(pos, charSize)) {
@@ -45,18 +62,15 @@ bool Character::init(Vec2 pos, bool facingRight) {
         initAnimation();
         current_node = walking_node;
         node->addChild(current_node);
+        state = CharacterState::WALKING;
+        App::SpriteAnimator->play(walking_node, walkingClip);
         
         node->setScale(CHAR_SIZE_FACTOR*container.size.width / texture->getWidth(),
                          CHAR_SIZE_FACTOR*container.size.height / texture->getHeight());
         node->setPosition(center);
-        beginFallingStart = false;
-        beginFallingEnd = false;
-        endFallingStart = false;
-        endFallingEnd = false;
         climbingStairs = false;
         notClimbingFrames = 0;
         pickingUpObject = false;
-        fallAnimation = false;
         
         return true;
     }
@@ -75,7 +89,6 @@ void Character::initAnimation(){
                                   node->getContentSize().height/2.0f);
         //node->addChildWithName(walking_node, "walking");
     }
-    walkingFrames = 0;
     
     // Falling
     std::shared_ptr<Texture>falling_texture = App::AssetManager->get<Texture>(FALLING_TEXTURE);
@@ -86,7 +99,6 @@ void Character::initAnimation(){
                                   node->getContentSize().height/2.0f);
         //node->addChildWithName(falling_node, "falling");
     }
-    fallingFrames = 0;
     
     // Pick up object
     std::shared_ptr<Texture>pickup_texture = App::AssetManager->get<Texture>(PICKUP_TEXTURE);
@@ -98,7 +110,6 @@ void Character::initAnimation(){
                                   node->getContentSize().height/2.0f);
         //node->addChildWithName(pickup_node, "pickup");
     }
-    pickupFrames = 0;
     
     // Climb stairs
     std::shared_ptr<Texture>climbing_texture = App::AssetManager->get<Texture>(CLIMBING_TEXTURE);
@@ -111,7 +122,6 @@ void Character::initAnimation(){
                                  node->getContentSize().height/2.0f);
         //node->addChildWithName(climbing_node, "climbing");
     }
-    climbingFrames = 0;
     
     // Exclamation mark
     std::shared_ptr<Texture> exclamation_texture = App::AssetManager->get<Texture>(EXCLAMATION_TEXTURE);
@@ -120,17 +130,41 @@ void Character::initAnimation(){
     exclamation_node->setFrame(0);
     
     // Shared
-    if (facingRight){
-        walking_node->flipHorizontal(0);
-        falling_node->flipHorizontal(0);
-        pickup_node->flipHorizontal(0);
-        climbing_node->flipHorizontal(0);
-    } else {
-        walking_node->flipHorizontal(1);
-        falling_node->flipHorizontal(1);
-        pickup_node->flipHorizontal(1);
-        climbing_node->flipHorizontal(1);
+    initClips();
+    nodesFaceRight = !facingRight;
+    updateFacing();
+}
+
+/**
+ Creates the animation clips shared by every character. The durations are
+ the frame FACTORs (in ticks) from Character.hpp.
+ */
+void Character::initClips() {
+    if (walkingClip != nullptr) {
+        return;
     }
+    
+    typedef AnimationClip::Mode Mode;
+    Size size = App::AssetManager->get<Texture>(WALKING_TEXTURE)->getSize();
+    walkingClip = AnimationClip::allocWithFilmstrip(size, 1, WALKING_FRAMES, {0, 1, 2, 3, 4, 5, 6, 7},
+                                                    WALKING_FACTOR*ANIMATION_TICK, Mode::LOOP);
+    
+    size = App::AssetManager->get<Texture>(CLIMBING_TEXTURE)->getSize();
+    climbingClip = AnimationClip::allocWithFilmstrip(size, 1, CLIMBING_FRAMES, {0, 1, 2, 3, 4, 5, 6, 7},
+                                                     CLIMBING_FACTOR*ANIMATION_TICK, Mode::LOOP);
+    
+    size = App::AssetManager->get<Texture>(PICKUP_TEXTURE)->getSize();
+    pickupClip = AnimationClip::allocWithFilmstrip(size, 1, PICKUP_FRAMES, {0, 1, 2, 3},
+                                                   PICKUP_FACTOR*ANIMATION_TICK, Mode::ONCE);
+    
+    // The falling strip is split into three clips: begin, mid-fall and landing
+    size = App::AssetManager->get<Texture>(FALLING_TEXTURE)->getSize();
+    fallBeginClip = AnimationClip::allocWithFilmstrip(size, 1, FALLING_FRAMES, {0, 1},
+                                                      FALLING_FACTOR*ANIMATION_TICK, Mode::ONCE);
+    fallingClip = AnimationClip::allocWithFilmstrip(size, 1, FALLING_FRAMES, {2, 3},
+                                                    FALLING_FACTOR*ANIMATION_TICK, Mode::LOOP);
+    landingClip = AnimationClip::allocWithFilmstrip(size, 1, FALLING_FRAMES, {4, 5},
+                                                    END_FALLING_FACTOR*ANIMATION_TICK, Mode::ONCE);
 }
 
 void Character::update(std::shared_ptr<ObstacleWorld> world, float dt) {
@@ -171,29 +205,8 @@ void Character::update(std::shared_ptr<ObstacleWorld> world, float dt) {
     node->setPosition(getPosition().x+NODE_X_OFFSET,getPosition().y);
     node->setAngle(getAngle());
     
-    // Animation
-    if (pickingUpObject){
-        if (current_node==walking_node){
-            switchAnimation(pickup_node);
-            endFalling(0);
-            animateWalking(0);
-            animateClimbing(0);
-        } else if (current_node==pickup_node){
-            animatePickup(1);
-        } else {
-            pickingUpObject = false;
-        }
-    } else if (climbingStairs) { //climbing stairs
-        if (current_node!=climbing_node){
-            switchAnimation(climbing_node);
-            if (node->getChildByTag(EXCLAMATION_TAG)!=nullptr){
-                node->removeChildByTag(EXCLAMATION_TAG);
-            }
-            endFalling(0);
-            animateWalking(0);
-            animatePickup(0);
-        }
-        animateClimbing(1);
+    // Climbing is movement state; it ends once we are off the stairs
+    if (climbingStairs) {
         if (!facingStairs && getLinearVelocity().y<=0){
             notClimbingFrames++;
         } else {
@@ -203,95 +216,25 @@ void Character::update(std::shared_ptr<ObstacleWorld> world, float dt) {
             climbingStairs = false;
             notClimbingFrames = 0;
         }
-    } else if (getLinearVelocity().y < -0.15){
-        if (current_node!=falling_node){
-            switchAnimation(falling_node);
-            animateWalking(0);
-            animateClimbing(0);
-            animatePickup(0);
-            beginFallingStart = true;
-            fallAnimation = true;
-        }
-        if (beginFallingStart && !beginFallingEnd){ //begin falling
-            if (node->getChildByTag(EXCLAMATION_TAG)==nullptr){
-                node->addChildWithTag(exclamation_node, EXCLAMATION_TAG,0);
-                if (facingRight){
-                    exclamation_node->flipHorizontal(0);
-                    exclamation_node->cugl::Node::setAnchor(5.0f, -8.0f);
-                } else {
-                    exclamation_node->flipHorizontal(1);
-                    exclamation_node->cugl::Node::setAnchor(-5.0f, -8.0f);
-                }
-                exclamation_node->setVisible(true);
-            }
-            beginFalling(1);
-        } else if (beginFallingEnd) {
-            if (falling_node->getFrame()<2){
-                falling_node->setFrame(2);
-                fallingFrames = (FALLING_FACTOR*2)-1;
-            }
-            beginFallingStart = false;
-            beginFallingEnd = false;
-            animateFalling(1); //mid-fall
-            endFallingStart = true;
-        } else {
-            animateFalling(1); //mid-fall
-        }
-    } else if (endFallingStart && getLinearVelocity().y>=0){ //begin to end fall
-
-        if (falling_node->getFrame()<4){
-            falling_node->setFrame(4);
-            fallingFrames = FALLING_FACTOR*4;
-        }
-        endFallingStart = false;
-    } else if (!endFallingEnd && fallAnimation) { //animate end fall
-        if (node->getChildByTag(EXCLAMATION_TAG)!=nullptr){
-            node->removeChildByTag(EXCLAMATION_TAG);
-        }
-        endFalling(1);
-        if (endFallingEnd){ //finish falling sequence
-            endFallingStart = false;
-            endFallingEnd = false;
-            fallAnimation = false;
-        }
-    } else {
-        if (current_node!=walking_node){
-            switchAnimation(walking_node);
-            endFalling(0);
-            animateClimbing(0);
-            animatePickup(0);
-            beginFallingStart = false;
-            beginFallingEnd = false;
-            endFallingStart = false;
-            endFallingEnd = false;
-        }
-        animateWalking(1);
     }
-
-    // Since they are callbacks they must be placed at the very end.
-    world->rayCast([=](b2Fixture *fixture, const Vec2 &point, const Vec2 &normal, float fraction) mutable -> float {
-        // In future, we should check whether this is part of the wall or not.
-        // Aka if the fixture's tag says its part of level geometry.
-        if (fixture->IsSensor()) {
-            return -1;
-        }
-        
-        topHit = true;
-        
-        return 0;
-    }, start, start + dir);
     
+    // Animation
+    updateFacing();
+    updateAnimation();
+
+    // Probe for walls and stairs in one batch. Any solid fixture counts,
+    // so each ray stops at the first one it finds.
+    // In future, we should check whether this is part of the wall or not.
+    // Aka if the fixture's tag says its part of level geometry.
+    RayQuery probes[2];
+    probes[0] = RayQuery(start, start + dir, 0xFFFF, true);
     start = Vec2(getPosition().x + sign * botRayOffset.x, getPosition().y + botRayOffset.y);
+    probes[1] = RayQuery(start, start + dir, 0xFFFF, true);
     
-    world->rayCast([=](b2Fixture *fixture, const Vec2 &point, const Vec2 &normal, float fraction) mutable -> float {
-        if (fixture->IsSensor()) {
-            return -1;
-        }
-        
-        botHit = true;
-        
-        return 0;
-    }, start, start + dir);
+    RayHit hits[2];
+    world->rayCast(probes, hits, 2);
+    topHit = hits[0].fixture != nullptr;
+    botHit = hits[1].fixture != nullptr;
 }
 
 
@@ -299,169 +242,146 @@ void Character::update(std::shared_ptr<ObstacleWorld> world, float dt) {
  * to switch animation nodes
  */
 void Character::switchAnimation(std::shared_ptr<cugl::AnimationNode> next_node){
+    if (current_node == next_node) {
+        return;
+    }
+    App::SpriteAnimator->stop(current_node);
     node->removeChild(current_node);
     current_node = next_node;
     node->addChild(current_node);
     
     if (current_node==falling_node){
-        if (facingRight){
-            current_node->cugl::Node::setAnchor(0.75f, 0.7f);
-        } else {
-            current_node->cugl::Node::setAnchor(0.25f, 0.7f);
-        }
         current_node->setPosition(0.0f, 0.0f);
     }
 }
 
 /**
- * Walking animation
+ * Chooses the animation state from the movement of the character.
+ *
+ * The one-shot clips (pickup, begin falling, landing) run to the end unless
+ * the movement demands another state.
  */
-void Character::animateWalking(bool on) {
-    if (on) {
-        //printf("walking\n");
-        walkingFrames++;
-        if (walkingFrames % WALKING_FACTOR == 0) {
-            walkingFrames = 0;
-            int nextFrame = (walking_node->getFrame() + 1) % WALKING_FRAMES;
-            walking_node->setFrame(nextFrame);
-        }
-    } else {
-        walking_node->setFrame(0);
-        walkingFrames = 0;
-    }
-    if (facingRight) {
-        walking_node->flipHorizontal(0);
-    } else {
-        walking_node->flipHorizontal(1);
+void Character::updateAnimation() {
+    bool falling = getLinearVelocity().y < -0.15;
+    bool complete = App::SpriteAnimator->isComplete(current_node);
+    
+    switch (state) {
+        case CharacterState::PICKUP:
+            if (complete) {
+                pickingUpObject = false;
+                setState(CharacterState::WALKING);
+            }
+            return;
+        case CharacterState::FALL_BEGIN:
+        case CharacterState::FALLING:
+            if (climbingStairs) {
+                setState(CharacterState::CLIMBING);
+            } else if (!falling) {
+                setState(CharacterState::LANDING);
+            } else if (state == CharacterState::FALL_BEGIN && complete) {
+                setState(CharacterState::FALLING);
+            }
+            return;
+        case CharacterState::LANDING:
+            if (climbingStairs) {
+                setState(CharacterState::CLIMBING);
+            } else if (falling) {
+                setState(CharacterState::FALL_BEGIN);
+            } else if (complete) {
+                setState(CharacterState::WALKING);
+            }
+            return;
+        case CharacterState::WALKING:
+        case CharacterState::CLIMBING:
+            if (pickingUpObject && state == CharacterState::WALKING) {
+                setState(CharacterState::PICKUP);
+            } else if (climbingStairs) {
+                setState(CharacterState::CLIMBING);
+            } else if (falling) {
+                setState(CharacterState::FALL_BEGIN);
+            } else {
+                setState(CharacterState::WALKING);
+            }
+            // A pickup can only start from walking
+            pickingUpObject = (state == CharacterState::PICKUP);
+            return;
     }
 }
 
 /**
- * Falling animation
+ * Enters the given animation state, switching nodes and starting its clip.
+ *
+ * Entering the current state does nothing, so looping clips keep playing.
  */
-void Character::beginFalling(bool on) {
-    if (on) {
-        //printf("begin falling\n");
-        // begin
-        fallingFrames++;
-        if (fallingFrames%FALLING_FACTOR==0){
-            falling_node->setFrame(1);
-        }
-        if (fallingFrames>=FALLING_FACTOR*2 && falling_node->getFrame()>=1){
-            beginFallingEnd = true; // end falling
-        }
-    }
-    else {
-        falling_node->setFrame(2);
-        fallingFrames = (FALLING_FACTOR*2)-1;
-    }
-    if (facingRight) {
-        falling_node->flipHorizontal(0);
-        falling_node->cugl::Node::setAnchor(0.75f, 0.7f);
-    } else {
-        falling_node->flipHorizontal(1);
-        falling_node->cugl::Node::setAnchor(0.25f, 0.7f);
-    }
-    current_node->setPosition(0.0f, 0.0f);
-}
-
-void Character::animateFalling(bool on) {
-    if (on) {
-        //printf("falling\n");
-        // Increment
-        fallingFrames++;
-        if (fallingFrames%FALLING_FACTOR==0 && falling_node->getFrame()==2){
-            falling_node->setFrame(3);
-        }
-        else if (fallingFrames%FALLING_FACTOR==0 && falling_node->getFrame()==3){
-            falling_node->setFrame(2);
-        }
-    }
-    if (facingRight) {
-        falling_node->flipHorizontal(0);
-        falling_node->cugl::Node::setAnchor(0.75f, 0.7f);
-    } else {
-        falling_node->flipHorizontal(1);
-        falling_node->cugl::Node::setAnchor(0.25f, 0.7f);
-    }
-    current_node->setPosition(0.0f, 0.0f);
-}
-
-void Character::endFalling(bool on){
-    if (on) {
-        //printf("end falling %i\n", falling_node->getFrame());
-        // begin
-        fallingFrames++;
-        if (fallingFrames%END_FALLING_FACTOR==0 && fallingFrames>=FALLING_FACTOR*5 && falling_node->getFrame()==5){
-            //printf("end falling end = true\n");
-            endFallingEnd = true; // end falling
-            fallAnimation = false;
-        } else if (fallingFrames%END_FALLING_FACTOR==0 && fallingFrames>=FALLING_FACTOR*4){
-            falling_node->setFrame(5);
-        }
-    }
-    else {
-        falling_node->setFrame(0);
-        fallingFrames = 0;
+void Character::setState(CharacterState next) {
+    if (next == state) {
+        return;
     }
-    if (facingRight) {
-        falling_node->flipHorizontal(0);
-        falling_node->cugl::Node::setAnchor(0.75f, 0.7f);
-    } else {
-        falling_node->flipHorizontal(1);
-        falling_node->cugl::Node::setAnchor(0.25f, 0.7f);
-    }
-    current_node->setPosition(0.0f, 0.0f);
-}
-
-/**
- * Climbing animation
- */
-void Character::animateClimbing(bool on) {
-    if (on) {
-        //printf("climbing\n");
-        climbingFrames++;
-        if (climbingFrames % CLIMBING_FACTOR == 0) {
-            climbingFrames = 0;
-            int nextFrame = (climbing_node->getFrame() + 1) % CLIMBING_FRAMES;
-            climbing_node->setFrame(nextFrame);
-        }
-    } else {
-        climbing_node->setFrame(0);
-        climbingFrames = 0;
+    
+    // The exclamation mark is shown while falling
+    bool wasFalling = (state == CharacterState::FALL_BEGIN || state == CharacterState::FALLING);
+    bool isFalling  = (next == CharacterState::FALL_BEGIN || next == CharacterState::FALLING);
+    if (isFalling && !wasFalling && node->getChildByTag(EXCLAMATION_TAG) == nullptr) {
+        node->addChildWithTag(exclamation_node, EXCLAMATION_TAG, 0);
+        exclamation_node->setVisible(true);
+    } else if (wasFalling && !isFalling && node->getChildByTag(EXCLAMATION_TAG) != nullptr) {
+        node->removeChildByTag(EXCLAMATION_TAG);
     }
-    if (facingRight) {
-        climbing_node->flipHorizontal(0);
-    } else {
-        climbing_node->flipHorizontal(1);
+    
+    state = next;
+    switch (next) {
+        case CharacterState::WALKING:
+            switchAnimation(walking_node);
+            App::SpriteAnimator->play(walking_node, walkingClip);
+            break;
+        case CharacterState::CLIMBING:
+            switchAnimation(climbing_node);
+            App::SpriteAnimator->play(climbing_node, climbingClip);
+            break;
+        case CharacterState::PICKUP:
+            switchAnimation(pickup_node);
+            App::SpriteAnimator->play(pickup_node, pickupClip);
+            break;
+        case CharacterState::FALL_BEGIN:
+            switchAnimation(falling_node);
+            App::SpriteAnimator->play(falling_node, fallBeginClip);
+            break;
+        case CharacterState::FALLING:
+            switchAnimation(falling_node);
+            App::SpriteAnimator->play(falling_node, fallingClip);
+            break;
+        case CharacterState::LANDING:
+            switchAnimation(falling_node);
+            App::SpriteAnimator->play(falling_node, landingClip);
+            break;
     }
 }
 
 /**
- * Pickup animation
+ * Flips the animation nodes if the facing of the character has changed.
+ *
+ * Flipping recomputes the texture coordinates, so it is not done every frame.
  */
-void Character::animatePickup(bool on) {
-    if (on) {
-        //printf("picking up\n");
-        pickupFrames++;
-        if (pickupFrames % PICKUP_FACTOR == 0 && pickup_node->getFrame()==PICKUP_FRAMES-1){
-            // end pickup
-            pickingUpObject = false;
-        }
-        if (pickingUpObject && pickupFrames % PICKUP_FACTOR == 0) {
-            pickupFrames = 0;
-            int nextFrame = (pickup_node->getFrame() + 1) % PICKUP_FRAMES;
-            pickup_node->setFrame(nextFrame);
-        }
-    } else {
-        pickup_node->setFrame(0);
-        pickupFrames = 0;
+void Character::updateFacing() {
+    if (nodesFaceRight == facingRight) {
+        return;
     }
+    nodesFaceRight = facingRight;
+    
+    bool flip = !facingRight;
+    walking_node->flipHorizontal(flip);
+    falling_node->flipHorizontal(flip);
+    pickup_node->flipHorizontal(flip);
+    climbing_node->flipHorizontal(flip);
+    exclamation_node->flipHorizontal(flip);
     if (facingRight) {
-        pickup_node->flipHorizontal(0);
+        falling_node->cugl::Node::setAnchor(0.75f, 0.7f);
+        exclamation_node->cugl::Node::setAnchor(5.0f, -8.0f);
     } else {
-        pickup_node->flipHorizontal(1);
+        falling_node->cugl::Node::setAnchor(0.25f, 0.7f);
+        exclamation_node->cugl::Node::setAnchor(-5.0f, -8.0f);
     }
+    falling_node->setPosition(0.0f, 0.0f);
 }
 
 /**
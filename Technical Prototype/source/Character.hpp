@@ -32,7 +32,29 @@
 
 #define EXCLAMATION_FRAMES 1
 
+/** The length of an animation tick (the FACTOR values above are in ticks) */
+#define ANIMATION_TICK  (1.0f/60.0f)
+
 using namespace cugl;
+
+/**
+ The animation states of the character. Each state plays one clip, and the
+ transitions between them are made in Character::updateAnimation.
+ */
+enum class CharacterState {
+    /** Walking along the floor (looping) */
+    WALKING,
+    /** Climbing stairs (looping) */
+    CLIMBING,
+    /** Picking up a collectible (once, then walking) */
+    PICKUP,
+    /** Starting to fall (once, then falling) */
+    FALL_BEGIN,
+    /** Falling (looping) */
+    FALLING,
+    /** Landing from a fall (once, then walking) */
+    LANDING
+};
 /**
  This is our character in the game. We extend it from a box2d physics object so
  that physics event listeners can grab this object straight away, as opposed to,
@@ -82,14 +104,41 @@ private:
     
     float climbSpeed = 1.0;
     
-    /** To slow down the animations */
-    int walkingFrames;
-    int fallingFrames;
-    int climbingFrames;
-    int pickupFrames;
+    /** The current animation state */
+    CharacterState state;
+    
+    /** The facing of the animation nodes (they are only flipped on a change) */
+    bool nodesFaceRight;
+    
+    /** The animation clips, shared by every character */
+    static std::shared_ptr<cugl::AnimationClip> walkingClip;
+    static std::shared_ptr<cugl::AnimationClip> climbingClip;
+    static std::shared_ptr<cugl::AnimationClip> pickupClip;
+    static std::shared_ptr<cugl::AnimationClip> fallBeginClip;
+    static std::shared_ptr<cugl::AnimationClip> fallingClip;
+    static std::shared_ptr<cugl::AnimationClip> landingClip;
     
     /** To initialize animation nodes */
     void initAnimation();
+    
+    /** To create the shared animation clips (if they do not exist yet) */
+    static void initClips();
+    
+    /**
+     Chooses the animation state from the movement of the character, making
+     any transition. This is called once per update.
+     */
+    void updateAnimation();
+    
+    /**
+     Enters the given animation state, switching nodes and starting its clip.
+     */
+    void setState(CharacterState next);
+    
+    /**
+     Flips the animation nodes if the facing of the character has changed.
+     */
+    void updateFacing();
 
     
 public:
@@ -137,8 +186,7 @@ public:
     /**
      Destroys this Character, releasing all resources.
      */
-    ~Character() {
-    }
+    ~Character();
     
     /**
      Initializes a character at the given position in world coordinates. The
@@ -164,34 +212,20 @@ public:
     void switchAnimation(std::shared_ptr<cugl::AnimationNode> next_node);
     
     /**
-     * Walking animation
-     */
-    void animateWalking(bool on);
-    
-    /**
-     * Falling animation
+     * Returns the current animation state
      */
-    bool beginFallingStart; // Can start the begin falling animation
-    bool beginFallingEnd;   // Can end the begin falling animation
-    bool endFallingStart;   // Can start the end falling animation
-    bool endFallingEnd;     // Can end the end falling animation
-    bool fallAnimation;     // True when the fall animation is running
-    void beginFalling(bool on);
-    void animateFalling(bool on);
-    void endFalling(bool on);
+    CharacterState getState() const { return state; }
     
     /**
-     * climbing animation
+     * climbing
      */
-    void animateClimbing(bool on);
     bool climbingStairs; // whether or not the character is currently climbing stairs
     int notClimbingFrames; // to make sure character is actually off of the stairs
     
     /**
      * Pickup animation
      */
-    void animatePickup(bool on);
-    bool pickingUpObject; //whether or not the character is currently picking up object to ensure animation runs once
+    bool pickingUpObject; //set to play the pickup animation once (cleared when it ends)
     
     /**
      *make character stop moving while layer switches
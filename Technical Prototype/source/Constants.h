@@ -56,6 +56,8 @@ const static std::string LEVEL_FILE_PREFIX = "level";
 #define LEVEL_WINDOW_SIDE               206
 #define LEVEL_TEXT_TOP_MARGIN           36
 #define LEVEL_TEXT_BOTTOM_MARGIN        100
+#define LEVEL_GRID_COLUMNS              5
+#define LEVEL_GRID_ROWS                 2
 
 #define PAUSE_BUTTON_TAG        111
 #define RESUME_BUTTON_TAG       222
@@ -69,8 +71,10 @@ const static std::string LEVEL_FILE_PREFIX = "level";
 #define NEXT_LEVEL_TAG          999
 
 
-#define FIRST_SCREEN            101
-#define SECOND_SCREEN           202
-#define THIRD_SCREEN            303
+#define PREVIOUS_SCREEN         101
+#define NEXT_SCREEN             202
+
+/** Level windows are tagged with this plus the level number */
+#define LEVEL_WINDOW_TAG        1000
 
 #endif /* Constants_h */
@@ -108,19 +108,31 @@ void GameController::nextLevel() {
 
 void GameController::gameWon() {
     App::saveGame(level);
+    App::SaveStore.addValue("wins/" + std::to_string(level));
     gameModel->gameState = GameModel::GameState::LEVEL_COMPLETE;
     uiController.activateWinScreen();
     // Tell UI to display won screen.
+    reportLatency();
 }
 
 void GameController::gameLost() {
+    App::SaveStore.addValue("deaths/" + std::to_string(level));
     gameModel->gameState = GameModel::GameState::DEATH;
     uiController.activateLoseScreen();
+    reportLatency();
     // Tell UI to display lost screen.
     multSpeed = 1;
     //reset to initial speed when starting level over (in case speed button was being pressed
 }
 
+void GameController::reportLatency() {
+    Application* app = Application::get();
+    if (app->getMaximumLatency() > 0) {
+        CULog("Input latency: %.1f ms average, %.1f ms worst",
+              app->getAverageLatency(), app->getMaximumLatency());
+    }
+}
+
 float GameController::approach(float g, float c, float delta){
     float diff = g - c;
     
@@ -105,6 +105,11 @@ public:
      */
     void gameWon();
     
+    /**
+     Logs how long the recent taps and swipes took to reach the screen.
+     */
+    void reportLatency();
+    
     bool returnToLevelSelect() {
         return returnLevelSelect;
     }
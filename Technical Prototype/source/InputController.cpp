@@ -78,6 +78,7 @@ void InputController::clear() {
     finalTouchLocation = Vec2::ZERO;
     panDelta = Vec2::ZERO;
     timestamp.mark();
+    predictor.clear();
     heldTaps.clear();
     releasedTaps.clear();
     heldSwipes.clear();
@@ -133,16 +134,16 @@ std::shared_ptr<Swipe> InputController::peekHeldSwipe() {
 
 std::shared_ptr<Tap> InputController::popHeldTap() {
     auto back = heldTaps.back();
-    consumedTaps.push_back(Tap::alloc(back->id, Vec2(back->position)));
-    auto result = Tap::alloc(back->id, Vec2(back->position));
+    consumedTaps.push_back(Tap::alloc(back->id, Vec2(back->position), back->timestamp));
+    auto result = Tap::alloc(back->id, Vec2(back->position), back->timestamp);
     heldTaps.pop_back();
     return result;
 }
 
 std::shared_ptr<Swipe> InputController::popHeldSwipe() {
     auto back = heldSwipes.back();
-    consumedSwipes.push_back(Swipe::alloc(back->id, Vec2(back->initialPosition), Vec2(back->finalPosition)));
-    auto result = Swipe::alloc(back->id, Vec2(back->initialPosition), Vec2(back->finalPosition));
+    consumedSwipes.push_back(Swipe::alloc(back->id, Vec2(back->initialPosition), Vec2(back->finalPosition), back->timestamp));
+    auto result = Swipe::alloc(back->id, Vec2(back->initialPosition), Vec2(back->finalPosition), back->timestamp);
     heldSwipes.pop_back();
     return result;
 }
@@ -154,7 +155,7 @@ std::shared_ptr<Tap> InputController::consumeReleasedTap(long id) {
             break;
         }
     }
-    auto result = Tap::alloc(releasedTaps[i]->id, Vec2(releasedTaps[i]->position));
+    auto result = Tap::alloc(releasedTaps[i]->id, Vec2(releasedTaps[i]->position), releasedTaps[i]->timestamp);
     releasedTaps.erase(releasedTaps.begin() + i);
     return result;
 }
@@ -166,7 +167,7 @@ std::shared_ptr<Swipe> InputController::consumeReleasedSwipe(long id) {
             break;
         }
     }
-    auto result = Swipe::alloc(releasedSwipes[i]->id, Vec2(releasedSwipes[i]->initialPosition), Vec2(releasedSwipes[i]->finalPosition));
+    auto result = Swipe::alloc(releasedSwipes[i]->id, Vec2(releasedSwipes[i]->initialPosition), Vec2(releasedSwipes[i]->finalPosition), releasedSwipes[i]->timestamp);
     releasedSwipes.erase(releasedSwipes.begin() + i);
     return result;
 }
@@ -198,7 +199,8 @@ void InputController::touchDragCB(const cugl::TouchEvent& event, bool focus) {
 }
 
 void InputController::touchBegan(const Timestamp timestamp, long id, const Vec2& pos) {
-    heldTaps.push_back(Tap::alloc(id, Vec2(pos)));
+    predictor.begin(id, pos, timestamp);
+    heldTaps.push_back(Tap::alloc(id, Vec2(pos), timestamp));
 }
 
 bool InputController::removeHeldTap(long id) {
@@ -244,6 +246,7 @@ bool InputController::removeConsumedTap(long id) {
 }
 
 void InputController::touchEnded(const Timestamp timestamp, long id, const Vec2& pos) {
+    predictor.end(id);
 
     if (removeHeldTap(id)) {
         return;
@@ -268,23 +271,26 @@ void InputController::touchEnded(const Timestamp timestamp, long id, const Vec2&
     }
     
     if (isSwipe) {
-        releasedSwipes.push_back(Swipe::alloc(id, initialPos, Vec2(pos)));
+        releasedSwipes.push_back(Swipe::alloc(id, initialPos, Vec2(pos), timestamp));
     } else {
         removeConsumedTap(id);
-        releasedTaps.push_back(Tap::alloc(id, Vec2(pos)));
+        releasedTaps.push_back(Tap::alloc(id, Vec2(pos), timestamp));
     }
 }
 
 void InputController::touchDrag(const Timestamp timestamp, long id, const Vec2& pos) {
+    predictor.move(id, pos, timestamp);
     for (auto swipe : heldSwipes) {
         if (swipe->id == id) {
             swipe->finalPosition.set(pos);
+            swipe->timestamp = timestamp;
             return;
         }
     }
     for (auto swipe : consumedSwipes) {
         if (swipe->id == id) {
             swipe->finalPosition.set(pos);
+            swipe->timestamp = timestamp;
             return;
         }
     }
@@ -307,10 +313,12 @@ void InputController::touchDrag(const Timestamp timestamp, long id, const Vec2&
     
     panDelta = pos - initialPos;
     
-    if (panDelta.length() > EVENT_SWIPE_LENGTH) {
+    // Classify the drag as it arrives, looking ahead if prediction is on
+    Vec2 predicted = predictor.predict(id, pos) - initialPos;
+    if (panDelta.length() > EVENT_SWIPE_LENGTH || predicted.length() > EVENT_SWIPE_LENGTH) {
         removeHeldTap(id);
         removeConsumedTap(id);
-        heldSwipes.push_back(Swipe::alloc(id, initialPos, pos));
+        heldSwipes.push_back(Swipe::alloc(id, initialPos, pos, timestamp));
     }
 }
 
@@ -17,6 +17,7 @@
 #include "GameModel.hpp"
 #include "Tap.hpp"
 #include "Swipe.hpp"
+#include "MotionPredictor.hpp"
 
 using namespace cugl;
 
@@ -44,6 +45,9 @@ private:
     
     Vec2 panDelta;
     
+    /** The velocity tracker for recognizing swipes early */
+    MotionPredictor predictor;
+    
     /** Handles touchBegan and mousePress events using shared logic. */
     void touchBegan(const Timestamp timestamp, long id, const Vec2& pos);
     
@@ -99,6 +103,21 @@ public:
      */
     const Vec2& getFinalTouchLocation() const { return finalTouchLocation; }
     
+    /**
+     *  Sets how far ahead (in milliseconds) to predict touch motion.
+     *
+     *  With prediction, a drag becomes a swipe once its predicted position
+     *  is far enough from the start, rather than its actual position.  The
+     *  swipe positions themselves are never predicted.  A value of 0 (the
+     *  default) turns prediction off.
+     */
+    void setPrediction(float millis) { predictor.setHorizon(millis); }
+    
+    /**
+     *  Returns how far ahead (in milliseconds) to predict touch motion.
+     */
+    float getPrediction() const { return predictor.getHorizon(); }
+    
     // tap
     bool heldTapReady();
     bool releasedTapReady(long id);
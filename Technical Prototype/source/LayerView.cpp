@@ -42,23 +42,45 @@ int LayerView::getTileY(std::shared_ptr<TileView> t) {
 }
 
 void LayerView::toggleLayerVisibility(bool shouldMinimize, bool isAnimated) {
+    // A minimized layer is already a thin line, and only moves as a whole.
+    if (shouldMinimize && isMinimized)
+        return;
+    
+    // The tiles animate individually, so stop caching until they are done.
+    isMinimized = shouldMinimize;
+    int transition = ++transitions;
+    setCached(false);
+    
     // We want all top tiles to shrink to some position, then all bottom tiles
     // immediately below.
     float endBottomY = rect4Tile(0, 0, shouldMinimize).getMidY();
     float endTopY = rect4Tile(0, 1, shouldMinimize).getMidY();
     
+    // Flatten the strips into a single texture once they stop animating.
+    std::function<void (void)> callback = nullptr;
+    if (shouldMinimize) {
+        callback = [this, transition] {
+            if (transition == transitions && isMinimized)
+                setCached(true);
+        };
+    }
+    
     for (int i = 0; i < tileViews.size(); i++) {
         std::shared_ptr<TileView> t = tileViews[i];
         TileView::TileDisplayMode mode;
         
+        // All of the animations end together, so one callback is enough
+        std::function<void (void)> done = i == tileViews.size() - 1? callback : nullptr;
         if (getTileY(t) == 0) {
             App::AnimationController.animate<float>([this, t] (float y) {
                 t->setPositionY(y);
-            }, t->getPositionY(), endBottomY, isAnimated? ANIM_DURATION : 0);
+            }, t->getPositionY(), endBottomY, isAnimated? ANIM_DURATION : 0,
+               AbstractAnimation::EaseInOut, done);
         } else {
             App::AnimationController.animate<float>([this, t] (float y) {
                 t->setPositionY(y);
-            }, t->getPositionY(), endTopY, isAnimated? ANIM_DURATION : 0);
+            }, t->getPositionY(), endTopY, isAnimated? ANIM_DURATION : 0,
+               AbstractAnimation::EaseInOut, done);
         }
         
         if (!shouldMinimize) {
@@ -38,6 +38,14 @@ private:
     /** The duration of layer switching animation. */
     const float ANIM_DURATION = 0.15;
     
+    /** Whether this layer is (or is becoming) a thin line. */
+    bool isMinimized = false;
+    
+    /**
+     The number of visibility changes so far. An animation callback only
+     applies if no other change has started since.
+     */
+    int transitions = 0;
     
 public:
     LayerView() {}
@@ -49,7 +57,7 @@ public:
      easiest to have the origin at the center of the screen.
      */
     static std::shared_ptr<LayerView> allocWithBounds(Vec2 size) {
-        std::shared_ptr<LayerView> obj = std::make_shared<LayerView>();
+        std::shared_ptr<LayerView> obj = cugl::NodeArena::make<LayerView>();
         return obj->initWithBounds(size)? obj : nullptr;
     }
     
@@ -60,7 +68,10 @@ public:
     void addTiles(std::vector<std::vector<std::shared_ptr<Tile>>> tiles);
     
     /** 
-     Shrink or expand this layer to or from a thin line.
+     Shrink or expand this layer to or from a thin line. Once a layer has
+     finished shrinking, it is drawn from a render cache (a single quad) until
+     it is expanded again. Minimizing a layer that is already minimized does
+     nothing, so that its cache survives layer switches.
      */
     void toggleLayerVisibility(bool shouldMinimize, bool isAnimated);
 };
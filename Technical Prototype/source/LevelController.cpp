@@ -30,6 +30,20 @@ void LevelController::init(int level, std::shared_ptr<GameModel> gameModel) {
         endContact(contact);
     };
     
+    tileSize = 420;
+    margins.x = 120;
+    margins.y = 120;
+    
+    float scale = tileSize/METERS_PER_TILE;
+    
+    Size dimen = Application::get()->getDisplaySize();
+    dimen *= (MOCKUP_WIDTH/dimen.width);
+    levelScene = Scene::alloc(dimen / scale);
+    
+    // Every node built for this level (including by the level loader) is
+    // allocated in the arena of the level scene.
+    NodeArena::Scope scope(levelScene->getArena());
+    
     // Initialize the root node for drawing.
     auto tileRootNode = Node::alloc();
 
@@ -43,10 +57,6 @@ void LevelController::init(int level, std::shared_ptr<GameModel> gameModel) {
     levelRootNode = LevelView::allocWithBounds(Vec2(20, 10));
     tileRootNode->addChildWithName(levelRootNode, "Level Root");
     
-    // This is the physics debug layer.
-    auto debugNode = Node::alloc();
-    tileRootNode->addChildWithName(debugNode, "Debug");
-    
     // This is where the character node should go under.
     auto characterNode = Node::alloc();
     tileRootNode->addChildWithName(characterNode, CHARACTER);
@@ -70,16 +80,6 @@ void LevelController::init(int level, std::shared_ptr<GameModel> gameModel) {
     
     characterLayer = 0;
     
-    tileSize = 420;
-    margins.x = 120;
-    margins.y = 120;
-    
-    float scale = tileSize/METERS_PER_TILE;
-    
-    Size dimen = Application::get()->getDisplaySize();
-    dimen *= (MOCKUP_WIDTH/dimen.width);
-    levelScene = Scene::alloc(dimen / scale);
-    
     Vec2 referenceSize = Vec2(MOCKUP_WIDTH, MOCKUP_HEIGHT);
     tileRootNode->setAnchor(Vec2::ANCHOR_MIDDLE);
     tileRootNode->setPosition(Vec2(dimen.width, dimen.height) / scale / 2);
@@ -92,6 +92,13 @@ void LevelController::init(int level, std::shared_ptr<GameModel> gameModel) {
 }
 
 void LevelController::update(float dt) {
+#ifndef CU_TOUCH_SCREEN
+    // Toggle the physics debug view
+    Keyboard* keys = Input::get<Keyboard>();
+    if (keys != nullptr && keys->keyPressed(KeyCode::D)) {
+        levelWorld->setDebug(!levelWorld->isDebug());
+    }
+#endif
     processTap();
     processSwipe();
     levelWorld->garbageCollect();
@@ -117,6 +124,13 @@ void LevelController::update(float dt) {
 
 void LevelController::draw(const std::shared_ptr<cugl::SpriteBatch> &batch) {
     levelScene->render(batch);
+    
+    // The physics debug view is drawn over the level, in the tile coordinates
+    if (levelWorld->isDebug()) {
+        batch->begin(levelScene->getCamera()->getCombined());
+        levelWorld->drawDebug(batch, levelScene->getChildByName("Tile Root")->getNodeToWorldTransform());
+        batch->end();
+    }
 }
 
 void LevelController::selectTile(Vec2 pos) {
@@ -254,6 +268,7 @@ void LevelController::processTap() {
     }
     
     Vec2 pos;
+    Timestamp stamp;
     bool isSwipe = false;
     int i;
     for (i = 0; i < heldTaps.size(); i++) {
@@ -264,6 +279,7 @@ void LevelController::processTap() {
         } else if (App::InputController.releasedTapReady(id)) {
             auto tap = App::InputController.consumeReleasedTap(id);
             pos = Vec2(tap->position);
+            stamp = tap->timestamp;
             break;
         }
     }
@@ -277,6 +293,7 @@ void LevelController::processTap() {
     }
     
     selectTile(pos);
+    Application::get()->markLatency(stamp);
 }
 
 void LevelController::processSwipe() {
@@ -296,6 +313,7 @@ void LevelController::processSwipe() {
                     gameModel->character->node->setVisible(false);
                     animatingLayerSwitch = true;
                     switchLayer(layer - 1, nullptr);
+                    Application::get()->markLatency(swipe->timestamp);
                 }
                 heldSwipes.push_back(swipe);
             } else if (y1 - y2 < -50) {
@@ -305,6 +323,7 @@ void LevelController::processSwipe() {
                     gameModel->character->node->setVisible(false);
                     animatingLayerSwitch = true;
                     switchLayer(layer + 1, nullptr);
+                    Application::get()->markLatency(swipe->timestamp);
                 }
                 heldSwipes.push_back(swipe);
             } else {
@@ -377,7 +396,7 @@ void LevelController::beginContact(b2Contact* contact) {
         }
         
         auto sound = App::AssetManager->get<Sound>(DOOR_OPEN);
-        App::AudioController.playSoundEffect(DOOR_OPEN,sound);
+        App::AudioController.playSoundEffect(DOOR_OPEN,sound,1);
     } else if (((name1 == "goal") && name2 == CHARACTER)
         || (name1 == CHARACTER && name2 == "goal")) {
         delegate->gameWon();
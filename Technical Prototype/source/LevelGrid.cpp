@@ -0,0 +1,147 @@
+//
+//  LevelGrid.cpp
+//  RocketDemo
+//
+//  This class is the grid of level windows on the level select screen.  It
+//  only builds the windows for one page, and reuses them for every page.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#include "LevelGrid.hpp"
+#include "Constants.h"
+#include <algorithm>
+
+bool LevelGrid::init(int levels, const Vec2& topLeft,
+                     const std::shared_ptr<Texture>& locked,
+                     const std::shared_ptr<Texture>& unlocked,
+                     const std::shared_ptr<Font>& font) {
+    if (!_cells.empty() || locked == nullptr || unlocked == nullptr || font == nullptr) {
+        return false;
+    }
+    _levels = std::max(levels, 0);
+    _lockedTexture = locked;
+    _unlockedTexture = unlocked;
+    _page = 0;
+    _reached = 0;
+
+    _cells.resize(LEVEL_GRID_COLUMNS*LEVEL_GRID_ROWS);
+    for (int j = 0; j < LEVEL_GRID_ROWS; j++) {
+        for (int i = 0; i < LEVEL_GRID_COLUMNS; i++) {
+            Cell& cell = _cells[j*LEVEL_GRID_COLUMNS+i];
+            cell.window = PolygonNode::allocWithTexture(_lockedTexture);
+            cell.window->setAnchor(Vec2::ANCHOR_TOP_LEFT);
+
+            int xOffset = i*(LEVEL_WINDOW_SIDE + LEVEL_WINDOW_HORIZONTAL_GAP);
+            int yOffset = j*(LEVEL_WINDOW_SIDE + LEVEL_WINDOW_HORIZONTAL_GAP);
+            Vec2 loc = topLeft + Vec2(xOffset, yOffset);
+            loc.y = MOCKUP_HEIGHT - loc.y;
+            cell.window->setPosition(loc);
+
+            // The number sits in the window, so it moves and hides with it
+            cell.label = Label::alloc("0", font);
+            cell.label->setForeground(Color4::WHITE);
+            cell.label->setHorizontalAlignment(Label::HAlign::CENTER);
+            cell.label->setPosition(unlocked->getWidth()/2, unlocked->getHeight()*6/11);
+            cell.label->setVisible(false);
+            cell.window->addChild(cell.label);
+
+            cell.level = -1;
+            cell.unlocked = false;
+        }
+    }
+    for (int ii = 0; ii < _cells.size(); ii++) {
+        refresh(ii);
+    }
+    return true;
+}
+
+void LevelGrid::dispose() {
+    for (auto it = _cells.begin(); it != _cells.end(); ++it) {
+        it->window->removeFromParent();
+    }
+    _cells.clear();
+    _parent = nullptr;
+    _lockedTexture = nullptr;
+    _unlockedTexture = nullptr;
+    _levels = 0;
+    _page = 0;
+    _reached = 0;
+}
+
+void LevelGrid::attach(const std::shared_ptr<Node>& parent) {
+    if (_parent == parent) {
+        return;
+    }
+    for (auto it = _cells.begin(); it != _cells.end(); ++it) {
+        it->window->removeFromParent();
+        if (parent != nullptr) {
+            parent->addChild(it->window);
+        }
+    }
+    _parent = parent;
+}
+
+int LevelGrid::getPageCount() const {
+    int size = getPageSize();
+    return size == 0 ? 0 : std::max((_levels+size-1)/size, 1);
+}
+
+int LevelGrid::getPageOf(int level) const {
+    int size = getPageSize();
+    if (size == 0) {
+        return 0;
+    }
+    int page = (std::max(level, 1)-1)/size;
+    return std::min(page, getPageCount()-1);
+}
+
+void LevelGrid::setPage(int page) {
+    page = std::max(0, std::min(page, getPageCount()-1));
+    if (page == _page) {
+        return;
+    }
+    _page = page;
+    for (int ii = 0; ii < _cells.size(); ii++) {
+        refresh(ii);
+    }
+}
+
+void LevelGrid::setReached(int level) {
+    if (level == _reached) {
+        return;
+    }
+    _reached = level;
+    for (int ii = 0; ii < _cells.size(); ii++) {
+        refresh(ii);
+    }
+}
+
+int LevelGrid::getLevel(int tag) {
+    return tag > LEVEL_WINDOW_TAG ? tag-LEVEL_WINDOW_TAG : 0;
+}
+
+void LevelGrid::refresh(int index) {
+    Cell& cell = _cells[index];
+    int level = _page*getPageSize()+index+1;
+    if (level > _levels) {
+        level = 0;
+    }
+    bool unlocked = level > 0 && level <= _reached;
+
+    if (level != cell.level) {
+        cell.window->setVisible(level > 0);
+        cell.window->setTag(level > 0 ? LEVEL_WINDOW_TAG+level : 0);
+        if (level > 0) {
+            cell.label->setNumber(level, true);
+        }
+        cell.level = level;
+    }
+    if (unlocked != cell.unlocked) {
+        const std::shared_ptr<Texture>& texture = unlocked ? _unlockedTexture : _lockedTexture;
+        cell.window->setTexture(texture);
+        cell.window->setPolygon(Rect(Vec2::ZERO, texture->getSize()));
+        cell.label->setVisible(unlocked);
+        cell.unlocked = unlocked;
+    }
+}
@@ -0,0 +1,112 @@
+//
+//  LevelGrid.hpp
+//  RocketDemo
+//
+//  This class is the grid of level windows on the level select screen.  It
+//  only builds the windows for one page, and reuses them for every page.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#ifndef LevelGrid_hpp
+#define LevelGrid_hpp
+
+#include <cugl/cugl.h>
+#include <vector>
+
+using namespace cugl;
+
+/**
+ This class is a retained, paged grid of level windows.
+
+ The grid owns exactly one page of cells.  Each cell is a window with a level
+ number label inside it.  Showing a different page, or unlocking more levels,
+ only touches the cells whose level or lock state actually changed.  Nothing
+ is allocated after init, so the grid costs the same for any number of levels.
+
+ The cells are added directly to the parent node so that the UI hit test sees
+ them.  The tag of an unlocked or locked cell is LEVEL_WINDOW_TAG plus its
+ level.  Cells past the last level are hidden and have tag 0.
+ */
+class LevelGrid {
+protected:
+    /** A single window in the grid */
+    struct Cell {
+        /** The level window */
+        std::shared_ptr<PolygonNode> window;
+        /** The level number (a child of the window) */
+        std::shared_ptr<Label> label;
+        /** The level currently shown, or 0 if the cell is hidden */
+        int level;
+        /** Whether the window currently shows the unlocked texture */
+        bool unlocked;
+    };
+
+    /** The cells of the visible page, in row major order */
+    std::vector<Cell> _cells;
+    /** The node the cells are attached to */
+    std::shared_ptr<Node> _parent;
+    /** The texture for levels not yet reached */
+    std::shared_ptr<Texture> _lockedTexture;
+    /** The texture for levels that may be played */
+    std::shared_ptr<Texture> _unlockedTexture;
+    /** The total number of levels */
+    int _levels;
+    /** The visible page */
+    int _page;
+    /** The highest level that may be played */
+    int _reached;
+
+    /** Brings the given cell up to date with the page and the reached level */
+    void refresh(int index);
+
+public:
+    /** Creates an empty grid.  You must call init before using it. */
+    LevelGrid() : _levels(0), _page(0), _reached(0) {}
+
+    /** Disposes the grid, removing the cells from their parent */
+    ~LevelGrid() { dispose(); }
+
+    /**
+     Initializes a grid for the given number of levels.
+
+     The cells are laid out in parent coordinates, starting at the given top
+     left corner.  They are not shown until the grid is attached to a node.
+     */
+    bool init(int levels, const Vec2& topLeft,
+              const std::shared_ptr<Texture>& locked,
+              const std::shared_ptr<Texture>& unlocked,
+              const std::shared_ptr<Font>& font);
+
+    /** Disposes the grid, removing the cells from their parent */
+    void dispose();
+
+    /** Adds the cells to the given node, removing them from the old one */
+    void attach(const std::shared_ptr<Node>& parent);
+
+    /** Returns the number of levels on each page */
+    int getPageSize() const { return (int)_cells.size(); }
+
+    /** Returns the number of pages */
+    int getPageCount() const;
+
+    /** Returns the page containing the given level */
+    int getPageOf(int level) const;
+
+    /** Returns the visible page */
+    int getPage() const { return _page; }
+
+    /** Shows the given page (clamped to the valid pages) */
+    void setPage(int page);
+
+    /** Returns the highest level that may be played */
+    int getReached() const { return _reached; }
+
+    /** Sets the highest level that may be played, unlocking its window */
+    void setReached(int level);
+
+    /** Returns the level for the given cell tag, or 0 if it is not a cell */
+    static int getLevel(int tag);
+};
+
+#endif /* LevelGrid_hpp */
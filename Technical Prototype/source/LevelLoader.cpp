@@ -31,9 +31,6 @@ Vec2 LevelLoader::loadLevel(int level, shared_ptr<GameModel> gameModel,
     
     // For initializing views, we have the scene graph nodes as follows:
     
-    // This node is where all physics debug views should go to
-    std::shared_ptr<Node> debugNode = tileRootNode->getChildByName("Debug");
-    
     // This node is where the character's views should go to.
     std::shared_ptr<Node> characterNode = tileRootNode->getChildByName(CHARACTER);
     
@@ -196,7 +193,6 @@ Vec2 LevelLoader::loadLevel(int level, shared_ptr<GameModel> gameModel,
     Vec2 pos = Vec2(json->get(CHARACTER)->getFloat("x"), json->get(CHARACTER)->getFloat("y"));
     bool facingRight = json->get(CHARACTER)->getInt("facingRight") == 1;
     std::shared_ptr<Character> character = Character::alloc(pos, facingRight);
-    character->setDebugScene(debugNode);
     levelWorld->addObstacle(character);
     gameModel->character = character;
     characterNode->addChildWithName(character->node, "char");
@@ -227,7 +223,6 @@ Vec2 LevelLoader::loadLevel(int level, shared_ptr<GameModel> gameModel,
                 if (t) {
                     for (auto collider : t->colliders) {
                         levelWorld->addObstacle(collider);
-                        collider->setDebugScene(debugNode);
                         collider->setActive(l == 0);
                     }
                 }
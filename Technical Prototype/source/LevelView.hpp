@@ -42,7 +42,7 @@ public:
      easiest to have the origin at the center of the screen.
      */
     static std::shared_ptr<LevelView> allocWithBounds(Vec2 size) {
-        std::shared_ptr<LevelView> obj = std::make_shared<LevelView>();
+        std::shared_ptr<LevelView> obj = cugl::NodeArena::make<LevelView>();
         return obj->initWithBounds(size)? obj : nullptr;
     }
     
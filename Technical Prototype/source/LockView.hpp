@@ -34,7 +34,7 @@ public:
      Default allocator. Configures a new lock with given position.
      */
     static std::shared_ptr<LockView> allocWithPosition(cugl::Vec2 pos) {
-        std::shared_ptr<LockView> obj = std::make_shared<LockView>();
+        std::shared_ptr<LockView> obj = cugl::NodeArena::make<LockView>();
         
         return obj->initWithPosition(pos)? obj : nullptr;
     }
@@ -0,0 +1,69 @@
+//
+//  MotionPredictor.cpp
+//  RocketDemo
+//
+//  This class estimates the velocity of each touch from its event timestamps,
+//  and extrapolates where the touch will be a short time in the future.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#include "MotionPredictor.hpp"
+#include <algorithm>
+
+void MotionPredictor::setHorizon(float millis) {
+    _horizon = std::max(0.0f, std::min(millis, PREDICTION_LIMIT));
+}
+
+void MotionPredictor::begin(long id, const Vec2& position, const Timestamp& time) {
+    Track& track = _tracks[id];
+    track.position = position;
+    track.time = time;
+    track.velocity = Vec2::ZERO;
+    track.moving = false;
+}
+
+void MotionPredictor::move(long id, const Vec2& position, const Timestamp& time) {
+    auto it = _tracks.find(id);
+    if (it == _tracks.end()) {
+        begin(id, position, time);
+        return;
+    }
+
+    // Events share a millisecond clock, so wait until time has passed
+    Track& track = it->second;
+    if (time.getTime() <= track.time.getTime()) {
+        return;
+    }
+    float millis = Timestamp::ellapsedMicros(track.time, time)/1000.0f;
+    if (millis < 1.0f) {
+        return;
+    }
+
+    Vec2 sample = (position-track.position)/millis;
+    if (track.moving) {
+        float alpha = millis/(millis+PREDICTION_SMOOTHING);
+        track.velocity += (sample-track.velocity)*alpha;
+    } else {
+        track.velocity = sample;
+        track.moving = true;
+    }
+    track.position = position;
+    track.time = time;
+}
+
+void MotionPredictor::end(long id) {
+    _tracks.erase(id);
+}
+
+Vec2 MotionPredictor::getVelocity(long id) const {
+    auto it = _tracks.find(id);
+    return it == _tracks.end() ? Vec2::ZERO : it->second.velocity;
+}
+
+Vec2 MotionPredictor::predict(long id, const Vec2& position) const {
+    if (_horizon <= 0) {
+        return position;
+    }
+    return position+getVelocity(id)*_horizon;
+}
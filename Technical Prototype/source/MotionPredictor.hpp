@@ -0,0 +1,95 @@
+//
+//  MotionPredictor.hpp
+//  RocketDemo
+//
+//  This class estimates the velocity of each touch from its event timestamps,
+//  and extrapolates where the touch will be a short time in the future.  The
+//  input controller uses it to recognize swipes before the finger has
+//  actually travelled the full swipe distance.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#ifndef MotionPredictor_hpp
+#define MotionPredictor_hpp
+
+#include <cugl/cugl.h>
+#include <unordered_map>
+
+/** The time constant (in milliseconds) for smoothing the touch velocity */
+#define PREDICTION_SMOOTHING    24.0f
+/** The longest prediction (in milliseconds) allowed */
+#define PREDICTION_LIMIT        50.0f
+
+using namespace cugl;
+
+/**
+ This class predicts the positions of moving touches.
+
+ Each touch is tracked from begin to end.  The velocity is computed from the
+ event timestamps rather than the frame times, so it is not affected by how
+ the events are batched into frames.  It is smoothed over roughly
+ PREDICTION_SMOOTHING milliseconds to hide the jitter of the touch sensor.
+
+ A prediction is the latest position plus the velocity times the horizon.
+ A horizon of 0 turns prediction off.
+ */
+class MotionPredictor {
+protected:
+    /** The motion of a single touch */
+    struct Track {
+        /** The position at the last velocity sample */
+        Vec2 position;
+        /** The time of the last velocity sample */
+        Timestamp time;
+        /** The smoothed velocity (in points per millisecond) */
+        Vec2 velocity;
+        /** Whether the velocity has been sampled yet */
+        bool moving;
+    };
+
+    /** The touches being tracked */
+    std::unordered_map<long, Track> _tracks;
+    /** How far ahead (in milliseconds) to predict */
+    float _horizon;
+
+public:
+    /** Creates a predictor with prediction turned off */
+    MotionPredictor() : _horizon(0) {}
+
+    /**
+     Sets how far ahead (in milliseconds) to predict.
+
+     The value is clamped to [0, PREDICTION_LIMIT].  A value of 0 turns
+     prediction off.
+     */
+    void setHorizon(float millis);
+
+    /** Returns how far ahead (in milliseconds) to predict */
+    float getHorizon() const { return _horizon; }
+
+    /** Starts tracking the touch with the given id */
+    void begin(long id, const Vec2& position, const Timestamp& time);
+
+    /** Updates the touch with the given id, sampling its velocity */
+    void move(long id, const Vec2& position, const Timestamp& time);
+
+    /** Stops tracking the touch with the given id */
+    void end(long id);
+
+    /** Stops tracking all touches */
+    void clear() { _tracks.clear(); }
+
+    /** Returns the velocity (in points per millisecond) of the given touch */
+    Vec2 getVelocity(long id) const;
+
+    /**
+     Returns the predicted position of the given touch.
+
+     The position is the latest position of the touch.  If prediction is off
+     or the touch is not moving, this method returns it unchanged.
+     */
+    Vec2 predict(long id, const Vec2& position) const;
+};
+
+#endif /* MotionPredictor_hpp */
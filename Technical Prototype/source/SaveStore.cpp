@@ -0,0 +1,297 @@
+//
+//  SaveStore.cpp
+//  RocketDemo
+//
+//  This class keeps the game progress in memory and writes it to the save
+//  directory on a background thread.  The game never waits on the disk.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#include "SaveStore.hpp"
+#include <fstream>
+#include <sstream>
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+/** The snapshot of every value */
+#define SNAPSHOT_FILE   "save.txt"
+/** The snapshot being written */
+#define TEMPORARY_FILE  "save.tmp"
+/** The changes since the last snapshot */
+#define JOURNAL_FILE    "save.journal"
+/** The header line of the snapshot and the journal */
+#define HEADER_TAG      "#save"
+/** The line that completes a batch of journal entries */
+#define COMMIT_TAG      "#end"
+/** The key given to a bare number (the original save format) */
+#define LEGACY_KEY      "level"
+
+/** Forces the contents of the given file to the disk */
+static bool syncFile(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/** Renames source to dest, replacing dest if it exists */
+static bool replaceFile(const std::string& source, const std::string& dest,
+                        const std::string& directory) {
+#if defined(_WIN32)
+    return MoveFileExA(source.c_str(), dest.c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(source.c_str(), dest.c_str()) != 0) {
+        return false;
+    }
+    // Make the rename itself durable
+    int dir = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+    return true;
+#endif
+}
+
+
+#pragma mark -
+#pragma mark Constructors
+
+bool SaveStore::init(const std::string& directory) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_running) {
+        return false;
+    }
+    _directory = directory;
+    if (!_directory.empty() && _directory.back() != '/' && _directory.back() != '\\') {
+        _directory.push_back('/');
+    }
+    load();
+    _running = true;
+    _worker = std::thread(&SaveStore::writeLoop, this);
+    return true;
+}
+
+void SaveStore::dispose() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    _checkpoint = true;
+    _condition.notify_all();
+    lock.unlock();
+
+    _worker.join();
+    if (_journal) {
+        fclose(_journal);
+        _journal = nullptr;
+    }
+}
+
+std::string SaveStore::getPath(const char* name) const {
+    return _directory+name;
+}
+
+void SaveStore::load() {
+    _values.clear();
+    _pending.clear();
+    _generation = 0;
+    _journaled = 0;
+
+    // The snapshot is complete whenever it exists
+    bool current = false;
+    std::ifstream snapshot(getPath(SNAPSHOT_FILE).c_str());
+    std::string line;
+    while (std::getline(snapshot, line)) {
+        std::istringstream parser(line);
+        std::string key;
+        int value;
+        if (!(parser >> key)) {
+            continue;
+        } else if (key == HEADER_TAG) {
+            current = (bool)(parser >> _generation);
+        } else if (parser >> value) {
+            _values[key] = value;
+        } else {
+            std::istringstream legacy(line);
+            if (legacy >> value) {
+                _values[LEGACY_KEY] = value;
+            }
+        }
+    }
+
+    // The journal only counts if it matches the snapshot generation
+    bool valid = false;
+    bool torn = false;
+    std::map<std::string,int> batch;
+    std::ifstream journal(getPath(JOURNAL_FILE).c_str());
+    while (current && std::getline(journal, line)) {
+        if (journal.eof()) {
+            torn = true; // A line with no newline
+            break;
+        }
+        std::istringstream parser(line);
+        std::string key;
+        long generation;
+        int value;
+        if (!valid) {
+            valid = (parser >> key) && key == HEADER_TAG &&
+                    (parser >> generation) && generation == _generation;
+            if (!valid) {
+                break;
+            }
+        } else if (line == COMMIT_TAG) {
+            // Batches are all or nothing
+            for(auto it = batch.begin(); it != batch.end(); ++it) {
+                _values[it->first] = it->second;
+            }
+            _journaled += (int)batch.size();
+            batch.clear();
+        } else if ((parser >> key) && (parser >> value)) {
+            batch[key] = value;
+        }
+    }
+
+    // Start over with a fresh snapshot if the files are old, missing, or torn
+    torn = torn || !batch.empty();
+    _stale = !current || !valid || torn;
+    _checkpoint = _stale;
+}
+
+
+#pragma mark -
+#pragma mark Values
+
+int SaveStore::getValue(const std::string& key, int fallback) const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _values.find(key);
+    return it == _values.end() ? fallback : it->second;
+}
+
+void SaveStore::setValue(const std::string& key, int value) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _values.find(key);
+    if (it != _values.end() && it->second == value) {
+        return;
+    }
+    _values[key] = value;
+    _pending[key] = value;
+    _condition.notify_all();
+}
+
+void SaveStore::addValue(const std::string& key, int delta) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    int value = (_values[key] += delta);
+    _pending[key] = value;
+    _condition.notify_all();
+}
+
+
+#pragma mark -
+#pragma mark Saving
+
+void SaveStore::checkpoint() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _checkpoint = true;
+    _condition.notify_all();
+}
+
+void SaveStore::synchronize() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] {
+        return !_running || (_pending.empty() && !_checkpoint && !_busy);
+    });
+}
+
+void SaveStore::writeLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this] {
+            return !_running || _checkpoint || !_pending.empty();
+        });
+        if (_pending.empty() && !_checkpoint) {
+            break;
+        }
+
+        // Everything set while we were busy is written in one go
+        std::map<std::string,int> entries;
+        entries.swap(_pending);
+        bool snapshot = _checkpoint || _stale || _journaled+(int)entries.size() > SAVE_JOURNAL_LIMIT;
+        std::map<std::string,int> values;
+        if (snapshot) {
+            values = _values;
+        }
+        _checkpoint = false;
+        _busy = true;
+        lock.unlock();
+
+        if (snapshot && writeSnapshot(values, _generation+1)) {
+            _generation++;
+            _journaled = 0;
+            _stale = (_journal == nullptr);
+        } else if (!entries.empty() && !_stale) {
+            writeJournal(entries);
+        }
+
+        lock.lock();
+        _busy = false;
+        _condition.notify_all();
+    }
+}
+
+bool SaveStore::writeSnapshot(const std::map<std::string,int>& values, long generation) {
+    std::string temp = getPath(TEMPORARY_FILE);
+    FILE* file = fopen(temp.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    bool success = fprintf(file, "%s %ld\n", HEADER_TAG, generation) > 0;
+    for(auto it = values.begin(); success && it != values.end(); ++it) {
+        success = fprintf(file, "%s %d\n", it->first.c_str(), it->second) > 0;
+    }
+    success = syncFile(file) && success;
+    success = (fclose(file) == 0) && success;
+    if (!success || !replaceFile(temp, getPath(SNAPSHOT_FILE), _directory)) {
+        remove(temp.c_str());
+        return false;
+    }
+
+    // The old journal no longer matches, so start a new one
+    if (_journal) {
+        fclose(_journal);
+    }
+    _journal = fopen(getPath(JOURNAL_FILE).c_str(), "w");
+    if (_journal) {
+        fprintf(_journal, "%s %ld\n", HEADER_TAG, generation);
+        syncFile(_journal);
+    }
+    return true;
+}
+
+void SaveStore::writeJournal(const std::map<std::string,int>& values) {
+    if (!_journal) {
+        _journal = fopen(getPath(JOURNAL_FILE).c_str(), "a");
+        if (!_journal) {
+            return;
+        }
+    }
+    for(auto it = values.begin(); it != values.end(); ++it) {
+        fprintf(_journal, "%s %d\n", it->first.c_str(), it->second);
+    }
+    fprintf(_journal, "%s\n", COMMIT_TAG);
+    syncFile(_journal);
+    _journaled += (int)values.size();
+}
@@ -0,0 +1,149 @@
+//
+//  SaveStore.hpp
+//  RocketDemo
+//
+//  This class keeps the game progress in memory and writes it to the save
+//  directory on a background thread.  The game never waits on the disk.
+//
+//  The store is a map from keys to integers.  It is saved as two files.  The
+//  snapshot (save.txt) holds every value, and is only ever replaced with a
+//  rename, so it is never half written.  The journal (save.journal) holds the
+//  changes since the last snapshot, one line at a time.  Frequent updates
+//  are appended to the journal, and the snapshot is rewritten when the
+//  journal grows too long or when the game asks for a checkpoint.
+//
+//  Copyright © 2026 Game Design Initiative at Cornell. All rights reserved.
+//
+
+#ifndef SaveStore_hpp
+#define SaveStore_hpp
+
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+#include <string>
+#include <map>
+#include <stdio.h>
+
+/** The number of journal entries allowed before the snapshot is rewritten */
+#define SAVE_JOURNAL_LIMIT  64
+
+/**
+ This class is an asynchronous, crash-safe store for the game progress.
+
+ All reads are answered from memory.  All writes update memory immediately,
+ and are saved by a background thread.  Writes made while the thread is busy
+ are coalesced, so only the latest value of each key is saved.
+
+ If the game is killed at any point, the store reloads to the state of some
+ earlier save.  The snapshot is written to a temporary file, synced, and then
+ renamed over the old one.  Each batch of journal entries ends with a commit
+ line, and batches that were not completely written are ignored.  Each
+ snapshot has a generation number, and the journal is only replayed if it
+ belongs to the same generation.
+
+ Keys may not contain whitespace.
+ */
+class SaveStore {
+protected:
+    /** The directory holding the save files */
+    std::string _directory;
+    /** The authoritative copy of every value */
+    std::map<std::string,int> _values;
+    /** The values changed since the background thread last ran */
+    std::map<std::string,int> _pending;
+    /** The generation of the current snapshot */
+    long _generation;
+    /** The number of entries in the journal since the last snapshot */
+    int _journaled;
+    /** The open journal file (background thread only) */
+    FILE* _journal;
+    /** Whether the journal on disk does not match the snapshot */
+    bool _stale;
+
+    /** Whether a snapshot has been requested */
+    bool _checkpoint;
+    /** Whether the background thread is writing */
+    bool _busy;
+    /** Whether the background thread should keep running */
+    bool _running;
+
+    /** The lock guarding the values and the requests */
+    mutable std::mutex _mutex;
+    /** The condition for waking the background thread and its waiters */
+    std::condition_variable _condition;
+    /** The background thread */
+    std::thread _worker;
+
+    /** Returns the path of the save file with the given name */
+    std::string getPath(const char* name) const;
+
+    /** Loads the snapshot and replays the journal (called by init) */
+    void load();
+
+    /** The body of the background thread */
+    void writeLoop();
+
+    /**
+     Writes the given values as a new snapshot, and starts a new journal.
+
+     Returns false if the snapshot could not be written.  In that case, the
+     old snapshot and journal are left in place.
+     */
+    bool writeSnapshot(const std::map<std::string,int>& values, long generation);
+
+    /** Appends the given values to the journal */
+    void writeJournal(const std::map<std::string,int>& values);
+
+public:
+#pragma mark -
+#pragma mark Constructors
+    /** Creates a store with no files.  You must call init before using it. */
+    SaveStore() : _generation(0), _journaled(0), _journal(nullptr), _stale(false),
+    _checkpoint(false), _busy(false), _running(false) {}
+
+    /** Disposes the store, saving any unwritten values */
+    ~SaveStore() { dispose(); }
+
+    /**
+     Initializes the store with the files in the given directory.
+
+     This loads the saved values (which is the only blocking read) and starts
+     the background thread.  It returns false if the store is already running.
+     */
+    bool init(const std::string& directory);
+
+    /**
+     Disposes the store, saving any unwritten values.
+
+     This blocks until a final snapshot is written.  It should only be called
+     when the game shuts down.
+     */
+    void dispose();
+
+#pragma mark -
+#pragma mark Values
+    /** Returns the value for the given key, or fallback if there is none */
+    int getValue(const std::string& key, int fallback=0) const;
+
+    /** Sets the value for the given key.  This does not block. */
+    void setValue(const std::string& key, int value);
+
+    /** Adds delta to the value for the given key.  This does not block. */
+    void addValue(const std::string& key, int delta=1);
+
+#pragma mark -
+#pragma mark Saving
+    /**
+     Requests a new snapshot of all of the values.  This does not block.
+
+     This is useful when the game is suspended, as it leaves the journal
+     empty for the next launch.
+     */
+    void checkpoint();
+
+    /** Blocks until every value set so far has been written */
+    void synchronize();
+};
+
+#endif /* SaveStore_hpp */
@@ -10,10 +10,11 @@
 
 using namespace cugl;
 
-void Swipe::init(long id, Vec2 initialPosition, Vec2 finalPosition) {
+void Swipe::init(long id, Vec2 initialPosition, Vec2 finalPosition, const Timestamp& timestamp) {
     this->id = id;
     this->initialPosition = initialPosition;
     this->finalPosition = finalPosition;
+    this->timestamp = timestamp;
 }
 
 void Swipe::dispose() {
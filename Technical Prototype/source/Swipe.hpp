@@ -30,6 +30,9 @@ public:
     
     long id;
     
+    /** The time of the latest touch event in this swipe. */
+    Timestamp timestamp;
+    
     /** Default constructor. */
     Swipe() {};
     
@@ -44,11 +47,12 @@ public:
      Initializes an empty tile with the given position and is locked status. The
      position is the bottom left corner.
      */
-    void init(long id, Vec2 initialPosition, Vec2 finalPosition);
+    void init(long id, Vec2 initialPosition, Vec2 finalPosition, const Timestamp& timestamp);
     
-    static std::shared_ptr<Swipe> alloc(long id, Vec2 initialPosition, Vec2 finalPosition) {
+    static std::shared_ptr<Swipe> alloc(long id, Vec2 initialPosition, Vec2 finalPosition,
+                                        const Timestamp& timestamp) {
         std::shared_ptr<Swipe> result = std::make_shared<Swipe>();
-        result->init(id, initialPosition, finalPosition);
+        result->init(id, initialPosition, finalPosition, timestamp);
         return result;
     }
 };
@@ -10,9 +10,10 @@
 
 using namespace cugl;
 
-void Tap::init(long id, Vec2 position) {
+void Tap::init(long id, Vec2 position, const Timestamp& timestamp) {
     this->id = id;
     this->position = position;
+    this->timestamp = timestamp;
 }
 
 void Tap::dispose() {
@@ -26,6 +26,9 @@ public:
     Vec2 position;
     
     long id;
+    
+    /** The time of the touch event: when it began (held) or ended (released). */
+    Timestamp timestamp;
 
     /** Default constructor. */
     Tap() {};
@@ -41,11 +44,11 @@ public:
      Initializes an empty tile with the given position and is locked status. The
      position is the bottom left corner.
      */
-    void init(long id, Vec2 position);
+    void init(long id, Vec2 position, const Timestamp& timestamp);
     
-    static std::shared_ptr<Tap> alloc(long id, Vec2 position) {
+    static std::shared_ptr<Tap> alloc(long id, Vec2 position, const Timestamp& timestamp) {
         std::shared_ptr<Tap> result = std::make_shared<Tap>();
-        result->init(id, position);
+        result->init(id, position, timestamp);
         return result;
     }
 };
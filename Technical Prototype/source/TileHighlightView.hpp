@@ -36,7 +36,7 @@ public:
      view is hidden.
      */
     static std::shared_ptr<TileHighlightView> allocWithTexture(std::shared_ptr<cugl::Texture> texture) {
-        auto node = std::make_shared<TileHighlightView>();
+        auto node = cugl::NodeArena::make<TileHighlightView>();
         
         return node->initWithTexture(texture) ? node : nullptr;
     }
@@ -77,7 +77,7 @@ public:
      Returns a new copy of TileView with the given position.
      */
     static std::shared_ptr<TileView> allocWithPosition(cugl::Vec2 pos) {
-        std::shared_ptr<TileView> t = std::make_shared<TileView>();
+        std::shared_ptr<TileView> t = cugl::NodeArena::make<TileView>();
         
         return t->initWithPosition(pos) ? t : nullptr;
     }
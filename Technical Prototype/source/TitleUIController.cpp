@@ -10,17 +10,18 @@
 #include "App.h"
 #include "InputController.hpp"
 #include "Constants.h"
+#include <algorithm>
 
 using namespace cugl;
 
-void TitleUIController::initLevelSelect(int index) {
+void TitleUIController::initLevelSelect() {
     Size dimen = Application::get()->getDisplaySize();
     dimen *= (GAME_WIDTH/dimen.width);
     Size mockupSize(MOCKUP_WIDTH, MOCKUP_HEIGHT);
     Vec2 center(dimen.width/2.0f, dimen.height/2.0f);
     float scale = GAME_WIDTH/mockupSize.width;
     
-    std::shared_ptr<Node> levelSelectNode = Node::alloc();
+    levelSelectNode = Node::alloc();
     levelSelectNode->setContentSize(mockupSize);
     levelSelectNode->setAnchor(Vec2::ANCHOR_MIDDLE);
     levelSelectNode->setPosition(center);
@@ -31,24 +32,14 @@ void TitleUIController::initLevelSelect(int index) {
     center.set(MOCKUP_WIDTH/2.0f, MOCKUP_HEIGHT/2.0f);
     
     /** Level Select */
-    std::shared_ptr<Texture> levelSelectTexture;
-    if (index == 0) {
-        levelSelectTexture = App::AssetManager->get<Texture>("level-select-background-1");
-    } else if (index == 1) {
-        levelSelectTexture = App::AssetManager->get<Texture>("level-select-background-2");
-    } else {
-        levelSelectTexture = App::AssetManager->get<Texture>("level-select-background-3");
-    }
-    auto levelSelectBackground = PolygonNode::allocWithTexture(levelSelectTexture);
+    levelSelectTextures.push_back(App::AssetManager->get<Texture>("level-select-background-1"));
+    levelSelectTextures.push_back(App::AssetManager->get<Texture>("level-select-background-2"));
+    levelSelectTextures.push_back(App::AssetManager->get<Texture>("level-select-background-3"));
+    levelSelectBackground = PolygonNode::allocWithTexture(levelSelectTextures[0]);
     levelSelectBackground->setAnchor(Vec2::ANCHOR_MIDDLE);
     levelSelectBackground->setPosition(center);
     levelSelectNode->addChild(levelSelectBackground, 0);
     
-    std::shared_ptr<Texture> levelWindowTexture = App::AssetManager->get<Texture>("level-select-window");
-    std::shared_ptr<Texture> unlockedLevelTexture = App::AssetManager->get<Texture>("level complete");
-    
-    current_level = App::readSaveFile();
-    
     auto levelSelectBackImage = PolygonNode::allocWithTexture(App::AssetManager->get<Texture>("level-select-back"));
     Size backSize(300, 150);
     auto levelSelectBack = Node::alloc();
@@ -63,43 +54,38 @@ void TitleUIController::initLevelSelect(int index) {
     levelSelectBack->addChild(levelSelectBackImage);
     
     Size arrowSize(130, 400);
-    if (index > 0) {
-        auto leftArrow = Node::alloc();
-        leftArrow->setAnchor(Vec2::ANCHOR_MIDDLE_LEFT);
-        leftArrow->setPosition(0, MOCKUP_HEIGHT/2);
-        leftArrow->setContentSize(arrowSize);
-        if (index == 1) {
-            leftArrow->setTag(FIRST_SCREEN);
-        } else if (index == 2) {
-            leftArrow->setTag(SECOND_SCREEN);
-        }
-        levelSelectNode->addChild(leftArrow);
-        
-        auto leftArrowImage = PolygonNode::allocWithTexture(App::AssetManager->get<Texture>("level-arrow-left"));
-        leftArrowImage->setAnchor(Vec2::ANCHOR_MIDDLE_LEFT);
-        leftArrowImage->setPosition(30, arrowSize.height/2);
-        leftArrow->addChild(leftArrowImage);
-    }
-    
-    if (index < 2) {
-        auto rightArrow = Node::alloc();
-        rightArrow->setAnchor(Vec2::ANCHOR_MIDDLE_RIGHT);
-        rightArrow->setPosition(MOCKUP_WIDTH, MOCKUP_HEIGHT/2);
-        rightArrow->setContentSize(arrowSize);
-        if (index == 1) {
-            rightArrow->setTag(THIRD_SCREEN);
-        } else if (index == 0) {
-            rightArrow->setTag(SECOND_SCREEN);
-        }
-        levelSelectNode->addChild(rightArrow);
-        
-        auto rightArrowImage = PolygonNode::allocWithTexture(App::AssetManager->get<Texture>("level-arrow-right"));
-        rightArrowImage->setAnchor(Vec2::ANCHOR_MIDDLE_RIGHT);
-        rightArrowImage->setPosition(arrowSize.width - 30, arrowSize.height/2);
-        rightArrow->addChild(rightArrowImage);
-    }
-    
-    levelSelectNodes.push_back(levelSelectNode);
+    leftArrow = Node::alloc();
+    leftArrow->setAnchor(Vec2::ANCHOR_MIDDLE_LEFT);
+    leftArrow->setPosition(0, MOCKUP_HEIGHT/2);
+    leftArrow->setContentSize(arrowSize);
+    levelSelectNode->addChild(leftArrow);
+    
+    auto leftArrowImage = PolygonNode::allocWithTexture(App::AssetManager->get<Texture>("level-arrow-left"));
+    leftArrowImage->setAnchor(Vec2::ANCHOR_MIDDLE_LEFT);
+    leftArrowImage->setPosition(30, arrowSize.height/2);
+    leftArrow->addChild(leftArrowImage);
+    
+    rightArrow = Node::alloc();
+    rightArrow->setAnchor(Vec2::ANCHOR_MIDDLE_RIGHT);
+    rightArrow->setPosition(MOCKUP_WIDTH, MOCKUP_HEIGHT/2);
+    rightArrow->setContentSize(arrowSize);
+    levelSelectNode->addChild(rightArrow);
+    
+    auto rightArrowImage = PolygonNode::allocWithTexture(App::AssetManager->get<Texture>("level-arrow-right"));
+    rightArrowImage->setAnchor(Vec2::ANCHOR_MIDDLE_RIGHT);
+    rightArrowImage->setPosition(arrowSize.width - 30, arrowSize.height/2);
+    rightArrow->addChild(rightArrowImage);
+    
+    // The windows are built once here, and only updated afterwards
+    levelGrid.init(MAX_LEVELS, Vec2(LEVEL_LEFT_MARGIN, LEVEL_TOP_MARGIN),
+                   App::AssetManager->get<Texture>("level-select-window"),
+                   App::AssetManager->get<Texture>("level complete"),
+                   App::AssetManager->get<Font>(LEVEL_SELECT_FONT));
+    levelGrid.attach(levelSelectNode);
+    current_level = App::readSaveFile();
+    levelGrid.setReached(current_level);
+    switchLevelSelect(0);
+    levelSelectNode->setVisible(false);
 }
 
 bool TitleUIController::init() {
@@ -174,9 +160,7 @@ bool TitleUIController::init() {
     credits->setTag(RETURN_MENU_TAG);
     creditsNode->addChild(credits);
 
-    initLevelSelect(0);
-    initLevelSelect(1);
-    initLevelSelect(2);
+    initLevelSelect();
     
     return true;
 }
@@ -197,114 +181,70 @@ bool TitleUIController::handleUIEvent(int tag) {
         case PLAY_TAG:
             this->delegate->playButtonPressed();
             break;
-        case FIRST_SCREEN:
-            switchLevelSelect(0);
-            break;
-        case SECOND_SCREEN:
-            switchLevelSelect(1);
+        case PREVIOUS_SCREEN:
+            switchLevelSelect(levelGrid.getPage()-1);
             break;
-        case THIRD_SCREEN:
-            switchLevelSelect(2);
+        case NEXT_SCREEN:
+            switchLevelSelect(levelGrid.getPage()+1);
             break;
-        default:
-            if (current_level>=tag){
+        default: {
+            int level = LevelGrid::getLevel(tag);
+            if (level > 0 && current_level>=level){
                 // make sure level is reached before selecting
-                this->delegate->selectLevel(tag);
+                this->delegate->selectLevel(level);
             }
             break;
+        }
     }
     return true;
 }
 
 void TitleUIController::activateLevelSelectUI() {
     updateWindows();
-    
-    if (current_level <= 10) {
-        levelSelectNodes[0]->setVisible(true);
-    } else if (current_level > 10 && current_level <= 20) {
-        levelSelectNodes[1]->setVisible(true);
-    } else {
-        levelSelectNodes[2]->setVisible(true);
-    }
+    switchLevelSelect(levelGrid.getPageOf(current_level));
     mainMenuNode->setVisible(false);
 }
 
 void TitleUIController::updateWindows() {
-    int n = 1;
+    // Only the windows whose lock state changed are touched
     current_level = App::readSaveFile();
-    std::shared_ptr<Texture> levelWindowTexture = App::AssetManager->get<Texture>("level-select-window");
-    std::shared_ptr<Texture> unlockedLevelTexture = App::AssetManager->get<Texture>("level complete");
-    Vec2 topLeft = Vec2(LEVEL_LEFT_MARGIN, LEVEL_TOP_MARGIN);
-    for (int a = 0; a < levelSelectNodes.size(); a++) {
-        auto node = levelSelectNodes[a];
-        for (int j = 0; j < 2; j++) {
-            for (int i = 0; i < 5; i++) {
-                if (n > MAX_LEVELS) {
-                    break;
-                }
-                node->removeChildByTag(n);
-                string name = "label"+std::to_string(n);
-                node->removeChildByName(name);
-                
-                std::shared_ptr<PolygonNode> levelWindow;
-                if (n>current_level){ // not yet reached level
-                    levelWindow = PolygonNode::allocWithTexture(levelWindowTexture);
-                } else {
-                    levelWindow = PolygonNode::allocWithTexture(unlockedLevelTexture);
-                }
-                levelWindow->setAnchor(Vec2::ANCHOR_TOP_LEFT);
-                
-                int xOffset = i*(LEVEL_WINDOW_SIDE + LEVEL_WINDOW_HORIZONTAL_GAP);
-                int yOffset = j*(LEVEL_WINDOW_SIDE + LEVEL_WINDOW_HORIZONTAL_GAP);
-                Vec2 loc = topLeft + Vec2(xOffset, yOffset);
-                loc.y = MOCKUP_HEIGHT - loc.y;
-                
-                levelWindow->setPosition(loc);
-                levelWindow->setTag(n);
-                node->addChild(levelWindow);
-                if (levelWindow->getTexture() == unlockedLevelTexture) {
-                    // Put the level number in the window
-                    std::shared_ptr<Font> font = App::AssetManager->get<Font>(LEVEL_SELECT_FONT);
-                    auto label = Label::alloc(std::to_string(n), font);
-                    label->setForeground(Color4::WHITE);
-                    label->setPosition(loc.x+unlockedLevelTexture->getWidth()/2, loc.y-(unlockedLevelTexture->getHeight()*5/11));
-                    label->setHorizontalAlignment(Label::HAlign::CENTER);
-                    string name = "label"+std::to_string(n);
-                    node->addChildWithName(label, name);
-                }
-                n++;
-            }
-        }
-    }
+    levelGrid.setReached(current_level);
 }
 
 void TitleUIController::switchLevelSelect(int index) {
-    for (auto node : levelSelectNodes) {
-        node->setVisible(false);
+    levelGrid.setPage(index);
+    int page = levelGrid.getPage();
+    
+    const std::shared_ptr<Texture>& texture = levelSelectTextures[std::min(page, (int)levelSelectTextures.size()-1)];
+    if (levelSelectBackground->getTexture() != texture) {
+        levelSelectBackground->setTexture(texture);
+        levelSelectBackground->setPolygon(Rect(Vec2::ZERO, texture->getSize()));
     }
-    levelSelectNodes[index]->setVisible(true);
+    
+    // Hidden arrows are untagged so that they cannot be pressed
+    bool previous = page > 0;
+    bool next = page < levelGrid.getPageCount()-1;
+    leftArrow->setVisible(previous);
+    leftArrow->setTag(previous ? PREVIOUS_SCREEN : 0);
+    rightArrow->setVisible(next);
+    rightArrow->setTag(next ? NEXT_SCREEN : 0);
+    levelSelectNode->setVisible(true);
 }
 
 void TitleUIController::activateMainMenuUI() {
-    for (auto node : levelSelectNodes) {
-        node->setVisible(false);
-    }
+    levelSelectNode->setVisible(false);
     mainMenuNode->setVisible(true);
     creditsNode->setVisible(false);
 }
 
 void TitleUIController::activateCreditsUI() {
-    for (auto node : levelSelectNodes) {
-        node->setVisible(false);
-    }
+    levelSelectNode->setVisible(false);
     mainMenuNode->setVisible(false);
     creditsNode->setVisible(true);
 }
 
 void TitleUIController::deactivate() {
-    for (auto node : levelSelectNodes) {
-        node->setVisible(false);
-    }
+    levelSelectNode->setVisible(false);
     mainMenuNode->setVisible(false);
     creditsNode->setVisible(false);
 }
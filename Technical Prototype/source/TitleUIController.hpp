@@ -11,6 +11,7 @@
 
 #include "AbstractUIController.hpp"
 #include "TitleUIControllerDelegate.hpp"
+#include "LevelGrid.hpp"
 
 /**
  This controller handles the display and player interaction with the UI.
@@ -20,10 +21,21 @@ class TitleUIController : public AbstractUIController {
 private:
     void initLevelSelect();
     
-    void initLevelSelect(int index);
-    
 protected:
-    std::vector<std::shared_ptr<cugl::Node>> levelSelectNodes;
+    /** The level select screen, which is reused for every page */
+    std::shared_ptr<cugl::Node> levelSelectNode;
+    
+    std::shared_ptr<cugl::PolygonNode> levelSelectBackground;
+    
+    /** The page backgrounds; the last one is repeated for any extra pages */
+    std::vector<std::shared_ptr<cugl::Texture>> levelSelectTextures;
+    
+    std::shared_ptr<cugl::Node> leftArrow;
+    
+    std::shared_ptr<cugl::Node> rightArrow;
+    
+    /** The level windows of the visible page */
+    LevelGrid levelGrid;
     
     std::shared_ptr<cugl::Node> mainMenuNode;
     
@@ -0,0 +1,723 @@
+//
+//  assetpack.cpp
+//  Magic Moving Mansion Mania asset pipeline
+//
+//  This is an offline tool for packing our asset directory into a single
+//  archive, which the engine reads with cugl::AssetArchive.  The archive is a
+//  32 byte header, an index of 32 byte entries sorted by the FNV-1a hash of
+//  their paths, a table of the entry paths, and then the entry data.  All
+//  values are little endian.
+//
+//  Uncompressed entries are aligned in the file, so that the views the engine
+//  hands out into its memory mapping are aligned too.  Entries can optionally
+//  be compressed with LZ4 (block format).  An entry is only stored compressed
+//  if that saves at least an eighth of its size, so already compressed files
+//  (PNG, OGG) are stored as is.
+//
+//  The tool can also report the time to load every asset from the archive,
+//  compared to loading them as loose files.  Each measurement first evicts
+//  the files from the page cache, so that it approximates a cold start.
+//
+//  This tool has no dependencies.  To build it
+//
+//      c++ -std=c++11 -O2 assetpack.cpp -o assetpack
+//
+//  Usage:
+//
+//      assetpack [options] <asset-dir> <archive>
+//
+//      -a, --align <bytes>          Alignment of uncompressed entries (default 16)
+//      -c, --compress               Compress entries with LZ4 when it helps
+//      -x, --exclude <ext>          Do not pack files with this extension
+//      -r, --report                 Compare load time against loose files
+//      -q, --quiet                  Do not list packed files
+//
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#pragma mark Constants
+/** The four character code at the start of every archive ("CUPK") */
+#define ARCHIVE_MAGIC       0x4B505543
+/** The archive format version */
+#define ARCHIVE_VERSION     1
+/** The size of the archive header in bytes */
+#define ARCHIVE_HEADER_SIZE 32
+/** The size of an index entry in bytes */
+#define ARCHIVE_ENTRY_SIZE  32
+/** The entry flag for LZ4 compressed data */
+#define ARCHIVE_LZ4         0x0001
+
+/** The FNV-1a offset basis */
+#define FNV_OFFSET  0xcbf29ce484222325ULL
+/** The FNV-1a prime */
+#define FNV_PRIME   0x100000001b3ULL
+
+/** The minimum LZ4 match length */
+#define LZ4_MINMATCH    4
+/** The number of literals that must end an LZ4 block */
+#define LZ4_LASTLITERALS 5
+/** The last LZ4 match must start this many bytes before the end of the block */
+#define LZ4_MFLIMIT     12
+/** The maximum LZ4 match offset */
+#define LZ4_MAXOFFSET   65535
+/** The number of bits in the LZ4 match finder hash */
+#define LZ4_HASHBITS    16
+
+/** A file to pack */
+struct Entry {
+    /** The path relative to the asset directory (with forward slashes) */
+    std::string name;
+    /** The FNV-1a hash of the path */
+    uint64_t hash;
+    /** The stored data (compressed or not) */
+    std::vector<uint8_t> data;
+    /** The size of the original file */
+    uint32_t length;
+    /** The entry flags */
+    uint16_t flags;
+    /** The offset of the data in the archive */
+    uint64_t offset;
+};
+
+#pragma mark -
+#pragma mark LZ4 Blocks
+/**
+ * Returns a 32 bit value from unaligned memory
+ *
+ * @param data  The memory to read
+ *
+ * @return a 32 bit value from unaligned memory
+ */
+static inline uint32_t read32(const uint8_t* data) {
+    uint32_t result;
+    memcpy(&result, data, 4);
+    return result;
+}
+
+/**
+ * Appends an LZ4 length extension to the output
+ *
+ * @param out       The output buffer
+ * @param length    The length beyond the 4 bit token value
+ */
+static void write_length(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back((uint8_t)length);
+}
+
+/**
+ * Appends an LZ4 sequence to the output
+ *
+ * A match length of 0 indicates the last sequence, which has no match.
+ *
+ * @param out       The output buffer
+ * @param literals  The start of the literals
+ * @param litlen    The number of literals
+ * @param offset    The match offset
+ * @param matchlen  The match length (0 for the last sequence)
+ */
+static void write_sequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t litlen,
+                           size_t offset, size_t matchlen) {
+    size_t code = matchlen ? matchlen-LZ4_MINMATCH : 0;
+    out.push_back((uint8_t)((std::min<size_t>(litlen,15) << 4) | std::min<size_t>(code,15)));
+    if (litlen >= 15) {
+        write_length(out, litlen-15);
+    }
+    out.insert(out.end(), literals, literals+litlen);
+    if (matchlen) {
+        out.push_back((uint8_t)(offset & 0xFF));
+        out.push_back((uint8_t)(offset >> 8));
+        if (code >= 15) {
+            write_length(out, code-15);
+        }
+    }
+}
+
+/**
+ * Returns the data compressed as an LZ4 block
+ *
+ * This is a greedy compressor with a single hash table, similar to the
+ * fast mode of the reference implementation.
+ *
+ * @param src   The data to compress
+ * @param size  The size of the data
+ *
+ * @return the data compressed as an LZ4 block
+ */
+static std::vector<uint8_t> lz4_compress(const uint8_t* src, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size+size/255+16);
+
+    std::vector<int64_t> table((size_t)1 << LZ4_HASHBITS, -1);
+    size_t anchor = 0;
+    size_t pos = 0;
+    if (size > LZ4_MFLIMIT) {
+        size_t limit = size-LZ4_MFLIMIT;
+        while (pos < limit) {
+            uint32_t sequence = read32(src+pos);
+            uint32_t hash = (sequence*2654435761u) >> (32-LZ4_HASHBITS);
+            int64_t ref = table[hash];
+            table[hash] = (int64_t)pos;
+            if (ref < 0 || pos-(size_t)ref > LZ4_MAXOFFSET || read32(src+ref) != sequence) {
+                pos++;
+                continue;
+            }
+
+            size_t length = LZ4_MINMATCH;
+            size_t maximum = size-LZ4_LASTLITERALS-pos;
+            while (length < maximum && src[ref+length] == src[pos+length]) {
+                length++;
+            }
+            write_sequence(out, src+anchor, pos-anchor, pos-(size_t)ref, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    write_sequence(out, src+anchor, size-anchor, 0, 0);
+    return out;
+}
+
+/**
+ * Decompresses an LZ4 block, returning true if successful
+ *
+ * @param src       The compressed block
+ * @param srcSize   The size of the compressed block
+ * @param dst       The buffer to store the decompressed data
+ * @param dstSize   The size of the decompressed data
+ *
+ * @return true if the block was decompressed successfully
+ */
+static bool lz4_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src+srcSize;
+    uint8_t* op   = dst;
+    uint8_t* oend = dst+dstSize;
+    while (ip < iend) {
+        uint8_t token = *ip++;
+        size_t length = token >> 4;
+        if (length == 15) {
+            uint8_t extra;
+            do {
+                if (ip >= iend) {
+                    return false;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255);
+        }
+        if ((size_t)(iend-ip) < length || (size_t)(oend-op) < length) {
+            return false;
+        }
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+        if (ip == iend) {
+            break;
+        }
+        if (iend-ip < 2) {
+            return false;
+        }
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op-dst)) {
+            return false;
+        }
+        length = token & 0x0F;
+        if (length == 15) {
+            uint8_t extra;
+            do {
+                if (ip >= iend) {
+                    return false;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255);
+        }
+        length += LZ4_MINMATCH;
+        if ((size_t)(oend-op) < length) {
+            return false;
+        }
+        const uint8_t* match = op-offset;
+        for(size_t ii = 0; ii < length; ii++) {
+            *op++ = *match++;
+        }
+    }
+    return op == oend;
+}
+
+#pragma mark -
+#pragma mark Asset Directories
+/**
+ * Returns the contents of the given file
+ *
+ * @param path  The file path
+ *
+ * @return the contents of the given file
+ */
+static std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Returns the FNV-1a hash of the given path
+ *
+ * @param path  The path relative to the asset directory
+ *
+ * @return the FNV-1a hash of the given path
+ */
+static uint64_t hash_path(const std::string& path) {
+    uint64_t hash = FNV_OFFSET;
+    for(auto it = path.begin(); it != path.end(); ++it) {
+        hash ^= (uint8_t)*it;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * Appends the files below the given directory to the list
+ *
+ * Hidden files (beginning with a period) are skipped.
+ *
+ * @param root      The asset directory
+ * @param prefix    The subdirectory to search (empty or ending in a slash)
+ * @param result    The list of relative paths
+ */
+static void list_all(const std::string& root, const std::string& prefix, std::vector<std::string>& result) {
+    DIR* handle = opendir((root+"/"+prefix).c_str());
+    if (handle == nullptr) {
+        return;
+    }
+    while (struct dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.') {
+            continue;
+        }
+        struct stat info;
+        std::string path = prefix+name;
+        if (stat((root+"/"+path).c_str(), &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            list_all(root, path+"/", result);
+        } else if (S_ISREG(info.st_mode)) {
+            result.push_back(path);
+        }
+    }
+    closedir(handle);
+}
+
+/**
+ * Returns true if the path has one of the given extensions
+ *
+ * @param path      The file path
+ * @param excluded  The excluded extensions (including the period)
+ *
+ * @return true if the path has one of the given extensions
+ */
+static bool has_extension(const std::string& path, const std::set<std::string>& excluded) {
+    size_t dot = path.rfind('.');
+    return dot != std::string::npos && excluded.count(path.substr(dot));
+}
+
+#pragma mark -
+#pragma mark Archive Output
+/**
+ * Appends a little endian value to the buffer
+ *
+ * @param out   The output buffer
+ * @param value The value to write
+ * @param bytes The number of bytes to write
+ */
+static void write_le(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for(int ii = 0; ii < bytes; ii++) {
+        out.push_back((uint8_t)(value >> (8*ii)));
+    }
+}
+
+/**
+ * Writes the archive, returning its size in bytes (0 on failure)
+ *
+ * @param path      The archive path
+ * @param entries   The entries to write (sorted by hash)
+ * @param align     The alignment of uncompressed entries
+ *
+ * @return the size of the archive in bytes
+ */
+static size_t write_archive(const std::string& path, std::vector<Entry>& entries, uint32_t align) {
+    std::vector<uint8_t> names;
+    std::vector<uint32_t> nameoff;
+    for(auto it = entries.begin(); it != entries.end(); ++it) {
+        nameoff.push_back((uint32_t)names.size());
+        names.insert(names.end(), it->name.begin(), it->name.end());
+    }
+
+    // Lay out the data
+    uint64_t offset = ARCHIVE_HEADER_SIZE+ARCHIVE_ENTRY_SIZE*(uint64_t)entries.size()+names.size();
+    for(auto it = entries.begin(); it != entries.end(); ++it) {
+        if (!(it->flags & ARCHIVE_LZ4)) {
+            offset = (offset+align-1)/align*align;
+        }
+        it->offset = offset;
+        offset += it->data.size();
+    }
+
+    std::vector<uint8_t> head;
+    write_le(head, ARCHIVE_MAGIC, 4);
+    write_le(head, ARCHIVE_VERSION, 4);
+    write_le(head, entries.size(), 4);
+    write_le(head, align, 4);
+    write_le(head, names.size(), 4);
+    write_le(head, 0, 4);
+    write_le(head, offset, 8);
+    for(size_t ii = 0; ii < entries.size(); ii++) {
+        const Entry& entry = entries[ii];
+        write_le(head, entry.hash, 8);
+        write_le(head, entry.offset, 8);
+        write_le(head, entry.data.size(), 4);
+        write_le(head, entry.length, 4);
+        write_le(head, nameoff[ii], 4);
+        write_le(head, entry.name.size(), 2);
+        write_le(head, entry.flags, 2);
+    }
+    head.insert(head.end(), names.begin(), names.end());
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return 0;
+    }
+    out.write((const char*)head.data(), head.size());
+    uint64_t pos = head.size();
+    static const char zeros[256] = { 0 };
+    for(auto it = entries.begin(); it != entries.end(); ++it) {
+        while (pos < it->offset) {
+            size_t amt = (size_t)std::min<uint64_t>(it->offset-pos, sizeof(zeros));
+            out.write(zeros, amt);
+            pos += amt;
+        }
+        out.write((const char*)it->data.data(), it->data.size());
+        pos += it->data.size();
+    }
+    return out ? (size_t)pos : 0;
+}
+
+#pragma mark -
+#pragma mark Load Time Report
+/**
+ * Evicts the given file from the page cache
+ *
+ * @param path  The file path
+ */
+static void evict(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+#if defined(POSIX_FADV_DONTNEED)
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+        close(fd);
+    }
+}
+
+/**
+ * Returns the time in milliseconds to read every file as a loose file
+ *
+ * @param root      The asset directory
+ * @param files     The relative file paths
+ * @param bytes     The total number of bytes read
+ *
+ * @return the time in milliseconds to read every file as a loose file
+ */
+static double time_loose(const std::string& root, const std::vector<std::string>& files, size_t& bytes) {
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        evict(root+"/"+*it);
+    }
+    bytes = 0;
+    std::vector<uint8_t> buffer;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        FILE* file = fopen((root+"/"+*it).c_str(), "rb");
+        if (file == nullptr) {
+            continue;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        buffer.resize((size_t)size);
+        bytes += fread(buffer.data(), 1, (size_t)size, file);
+        fclose(file);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+/**
+ * Returns the time in milliseconds to read every file from the archive
+ *
+ * This maps the archive and looks up every entry by hash, exactly as the
+ * engine does.  Uncompressed entries are touched in place (the engine hands
+ * out views into the mapping), while compressed entries are decompressed.
+ * Afterwards, it verifies every entry against the loose file.
+ *
+ * @param root      The asset directory
+ * @param archive   The archive path
+ * @param files     The relative file paths
+ * @param bytes     The total number of bytes read
+ * @param valid     Set to false if any entry does not match its file
+ *
+ * @return the time in milliseconds to read every file from the archive
+ */
+static double time_archive(const std::string& root, const std::string& archive,
+                           const std::vector<std::string>& files, size_t& bytes, bool& valid) {
+    evict(archive);
+    bytes = 0;
+    valid = true;
+    std::vector<const uint8_t*> views;
+    std::vector<size_t> sizes;
+    std::vector<std::vector<uint8_t>> decoded;
+    volatile uint32_t checksum = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    int fd = open(archive.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        valid = false;
+        return 0;
+    }
+    const uint8_t* data = (const uint8_t*)mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        valid = false;
+        return 0;
+    }
+    uint32_t count, namesize;
+    memcpy(&count, data+8, 4);
+    memcpy(&namesize, data+16, 4);
+    const uint8_t* index = data+ARCHIVE_HEADER_SIZE;
+    const char* names = (const char*)(index+ARCHIVE_ENTRY_SIZE*(size_t)count);
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        uint64_t hash = hash_path(*it);
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = (lo+hi)/2;
+            uint64_t value;
+            memcpy(&value, index+ARCHIVE_ENTRY_SIZE*mid, 8);
+            if (value < hash) {
+                lo = mid+1;
+            } else {
+                hi = mid;
+            }
+        }
+        const uint8_t* found = nullptr;
+        for(; lo < count; lo++) {
+            const uint8_t* entry = index+ARCHIVE_ENTRY_SIZE*lo;
+            uint64_t value;
+            uint32_t nameoff;
+            uint16_t namelen;
+            memcpy(&value, entry, 8);
+            memcpy(&nameoff, entry+24, 4);
+            memcpy(&namelen, entry+28, 2);
+            if (value != hash) {
+                break;
+            }
+            if (namelen == it->size() && memcmp(names+nameoff, it->data(), namelen) == 0) {
+                found = entry;
+                break;
+            }
+        }
+        if (found == nullptr) {
+            valid = false;
+            views.push_back(nullptr);
+            sizes.push_back(0);
+            continue;
+        }
+        uint64_t offset;
+        uint32_t size, length;
+        uint16_t flags;
+        memcpy(&offset, found+8, 8);
+        memcpy(&size, found+16, 4);
+        memcpy(&length, found+20, 4);
+        memcpy(&flags, found+30, 2);
+        const uint8_t* view = data+offset;
+        if (flags & ARCHIVE_LZ4) {
+            decoded.emplace_back(length);
+            if (!lz4_decompress(view, size, decoded.back().data(), length)) {
+                valid = false;
+            }
+            view = decoded.back().data();
+        }
+        // Touch every page, as a loader would
+        uint32_t sum = 0;
+        for(size_t ii = 0; ii < length; ii += 4096) {
+            sum += view[ii];
+        }
+        checksum += sum;
+        bytes += length;
+        views.push_back(view);
+        sizes.push_back(length);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // Verify the entries against the loose files
+    for(size_t ii = 0; ii < views.size() && ii < files.size(); ii++) {
+        if (views[ii] != nullptr) {
+            std::vector<uint8_t> original = read_file(root+"/"+files[ii]);
+            if (original.size() != sizes[ii] || memcmp(original.data(), views[ii], sizes[ii]) != 0) {
+                valid = false;
+            }
+        }
+    }
+    munmap((void*)data, (size_t)info.st_size);
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+/**
+ * Prints the load time of the archive compared to the loose files
+ *
+ * @param root      The asset directory
+ * @param archive   The archive path
+ * @param files     The relative file paths
+ */
+static void report(const std::string& root, const std::string& archive, const std::vector<std::string>& files) {
+    const int trials = 5;
+    double loose = 0, packed = 0;
+    size_t looseBytes = 0, packedBytes = 0;
+    bool valid = true;
+    for(int ii = 0; ii < trials; ii++) {
+        loose += time_loose(root, files, looseBytes);
+        bool result;
+        packed += time_archive(root, archive, files, packedBytes, result);
+        valid = valid && result;
+    }
+    printf("\n%-24s %10s %10s %10s\n", "load", "files", "bytes", "ms");
+    printf("%-24s %10zu %10zu %10.2f\n", "loose files", files.size(), looseBytes, loose/trials);
+    printf("%-24s %10zu %10zu %10.2f\n", "archive", files.size(), packedBytes, packed/trials);
+    printf("archive entries %s\n", valid ? "verified" : "DO NOT MATCH the loose files");
+}
+
+#pragma mark -
+#pragma mark Main
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: assetpack [options] <asset-dir> <archive>\n"
+            "  -a, --align <bytes>        alignment of uncompressed entries (default 16)\n"
+            "  -c, --compress             compress entries with LZ4 when it helps\n"
+            "  -x, --exclude <ext>        do not pack files with this extension\n"
+            "  -r, --report               compare load time against loose files\n"
+            "  -q, --quiet                do not list packed files\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    uint32_t align = 16;
+    bool compress = false;
+    bool print = false;
+    bool quiet = false;
+    std::set<std::string> excluded;
+    std::string root, archive;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if ((arg == "-a" || arg == "--align") && ii+1 < argc) {
+            align = (uint32_t)atoi(argv[++ii]);
+            if (align == 0 || (align & (align-1))) {
+                usage();
+            }
+        } else if (arg == "-c" || arg == "--compress") {
+            compress = true;
+        } else if ((arg == "-x" || arg == "--exclude") && ii+1 < argc) {
+            std::string ext = argv[++ii];
+            excluded.insert(ext[0] == '.' ? ext : "."+ext);
+        } else if (arg == "-r" || arg == "--report") {
+            print = true;
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg[0] != '-' && root.empty()) {
+            root = arg;
+        } else if (arg[0] != '-' && archive.empty()) {
+            archive = arg;
+        } else {
+            usage();
+        }
+    }
+    if (root.empty() || archive.empty()) {
+        usage();
+    }
+
+    std::vector<std::string> files;
+    list_all(root, "", files);
+    std::sort(files.begin(), files.end());
+
+    // Never pack the archive itself
+    std::string archiveName = archive.substr(archive.rfind('/') == std::string::npos ? 0 : archive.rfind('/')+1);
+    std::vector<Entry> entries;
+    std::vector<std::string> packed;
+    size_t before = 0, after = 0;
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        if (has_extension(*it, excluded) || *it == archiveName) {
+            continue;
+        }
+        Entry entry;
+        entry.name = *it;
+        entry.hash = hash_path(*it);
+        entry.data = read_file(root+"/"+*it);
+        entry.length = (uint32_t)entry.data.size();
+        entry.flags = 0;
+        entry.offset = 0;
+        if (entry.data.empty()) {
+            fprintf(stderr, "skipping empty file %s\n", it->c_str());
+            continue;
+        }
+        if (compress) {
+            std::vector<uint8_t> block = lz4_compress(entry.data.data(), entry.data.size());
+            if (block.size() <= entry.data.size()-entry.data.size()/8) {
+                entry.data.swap(block);
+                entry.flags |= ARCHIVE_LZ4;
+            }
+        }
+        before += entry.length;
+        after  += entry.data.size();
+        if (!quiet) {
+            printf("%-48s %10u -> %10zu%s\n", it->c_str(), entry.length, entry.data.size(),
+                   (entry.flags & ARCHIVE_LZ4) ? " (lz4)" : "");
+        }
+        packed.push_back(*it);
+        entries.push_back(std::move(entry));
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.hash < b.hash || (a.hash == b.hash && a.name < b.name);
+    });
+    size_t total = write_archive(archive, entries, align);
+    if (total == 0) {
+        fprintf(stderr, "could not write %s\n", archive.c_str());
+        return 1;
+    }
+    printf("packed %zu files: %zu bytes -> %zu bytes of data, %zu bytes total\n",
+           entries.size(), before, after, total);
+
+    if (print) {
+        report(root, archive, packed);
+    }
+    return 0;
+}
@@ -0,0 +1,800 @@
+//
+//  ktxconvert.cpp
+//  Magic Moving Mansion Mania asset pipeline
+//
+//  This is an offline tool for converting the PNG textures in our asset
+//  directory into KTX containers.  By default each texture is compressed to
+//  ETC2 (RGB8 if it is fully opaque, RGBA8 with an EAC alpha channel if not)
+//  together with a full chain of prebuilt mipmaps.  The engine loads these
+//  with glCompressedTexImage2D, and so they stay compressed in GPU memory.
+//  Platforms without ETC2 support decode them on the CPU instead (see
+//  cugl::KTXImage).
+//
+//  The tool can also rewrite an asset directory JSON so that its texture
+//  entries refer to the converted files, and it can report the texture memory
+//  and load cost of every level in the game, before and after conversion.
+//
+//  Rows are stored top to bottom, exactly as they appear in the PNG file.
+//  This matches how cugl::Texture uploads SDL surfaces, so texture coordinates
+//  do not change when an asset is switched from PNG to KTX.
+//
+//  This tool only depends on libpng.  To build it
+//
+//      c++ -std=c++11 -O2 ktxconvert.cpp -o ktxconvert -lpng
+//
+//  Usage:
+//
+//      ktxconvert [options] <asset-dir>
+//
+//      -f, --format <etc2|rgba>     Output format (default etc2)
+//      -n, --no-mipmaps             Do not store prebuilt mipmaps
+//      -w, --rewrite <in> <out>     Rewrite asset directory <in> (relative to
+//                                   the asset directory) to <out>, replacing
+//                                   converted PNG entries with KTX ones
+//      -r, --report                 Print per-level texture memory and load time
+//      -q, --quiet                  Do not list converted files
+//
+#include <png.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#pragma mark Constants
+/** The OpenGL enum for RGB8 ETC2 compression */
+#define GL_COMPRESSED_RGB8_ETC2         0x9274
+/** The OpenGL enum for RGBA8 ETC2 compression with EAC alpha */
+#define GL_COMPRESSED_RGBA8_ETC2_EAC    0x9278
+/** The OpenGL enum for unsigned bytes */
+#define GL_UNSIGNED_BYTE                0x1401
+/** The OpenGL enum for RGB images */
+#define GL_RGB                          0x1907
+/** The OpenGL enum for RGBA images */
+#define GL_RGBA                         0x1908
+/** The OpenGL enum for sized RGBA images */
+#define GL_RGBA8                        0x8058
+
+/** The 12 byte identifier at the start of every KTX 1.1 file */
+static const uint8_t KTX_IDENTIFIER[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+/** The ETC1/ETC2 intensity modifiers, indexed by table and pixel index */
+static const int ETC_MODIFIERS[8][4] = {
+    {  2,   8,  -2,   -8 }, {  5,  17,  -5,  -17 },
+    {  9,  29,  -9,  -29 }, { 13,  42, -13,  -42 },
+    { 18,  60, -18,  -60 }, { 24,  80, -24,  -80 },
+    { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+/** The EAC alpha modifiers, indexed by table and pixel index */
+static const int EAC_MODIFIERS[16][8] = {
+    { -3, -6,  -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 }, { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 }, { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 }, { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 }, { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 }, { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 }, { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 }, { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+/** The EAC table whose modifier 4 is zero (for constant alpha blocks) */
+#define EAC_ZERO_TABLE  13
+
+#pragma mark -
+#pragma mark Images
+/**
+ * An RGBA8888 image in row-major order (top row first)
+ */
+struct Image {
+    /** The image width in pixels */
+    int width;
+    /** The image height in pixels */
+    int height;
+    /** The pixel data */
+    std::vector<uint8_t> pixels;
+
+    /** Returns a pointer to the pixel at (x,y), clamped to the image */
+    const uint8_t* at(int x, int y) const {
+        x = std::min(std::max(x,0),width-1);
+        y = std::min(std::max(y,0),height-1);
+        return pixels.data()+4*(y*width+x);
+    }
+
+    /** Returns true if every pixel is fully opaque */
+    bool opaque() const {
+        for(size_t ii = 3; ii < pixels.size(); ii += 4) {
+            if (pixels[ii] != 255) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Returns the PNG file decoded to RGBA8888
+ *
+ * @param path  The path to the PNG file
+ * @param image The image to store the result
+ *
+ * @return true if the file was decoded successfully
+ */
+static bool read_png(const std::string& path, Image& image) {
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&png, path.c_str())) {
+        fprintf(stderr, "%s: %s\n", path.c_str(), png.message);
+        return false;
+    }
+    png.format = PNG_FORMAT_RGBA;
+    image.width  = png.width;
+    image.height = png.height;
+    image.pixels.resize(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, image.pixels.data(), 0, nullptr)) {
+        fprintf(stderr, "%s: %s\n", path.c_str(), png.message);
+        png_image_free(&png);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Returns the next mipmap level of the given image
+ *
+ * Color channels are averaged weighted by alpha, so that the color of fully
+ * transparent pixels does not bleed into the visible ones.
+ *
+ * @param src   The source image
+ *
+ * @return the next mipmap level of the given image
+ */
+static Image downsample(const Image& src) {
+    Image dst;
+    dst.width  = std::max(1,src.width/2);
+    dst.height = std::max(1,src.height/2);
+    dst.pixels.resize(4*dst.width*dst.height);
+    for(int y = 0; y < dst.height; y++) {
+        for(int x = 0; x < dst.width; x++) {
+            const uint8_t* p[4] = {
+                src.at(2*x,2*y), src.at(2*x+1,2*y), src.at(2*x,2*y+1), src.at(2*x+1,2*y+1)
+            };
+            int alpha = p[0][3]+p[1][3]+p[2][3]+p[3][3];
+            uint8_t* out = dst.pixels.data()+4*(y*dst.width+x);
+            for(int c = 0; c < 3; c++) {
+                int sum = 0;
+                if (alpha > 0) {
+                    for(int ii = 0; ii < 4; ii++) { sum += p[ii][c]*p[ii][3]; }
+                    out[c] = (uint8_t)((sum+alpha/2)/alpha);
+                } else {
+                    for(int ii = 0; ii < 4; ii++) { sum += p[ii][c]; }
+                    out[c] = (uint8_t)((sum+2)/4);
+                }
+            }
+            out[3] = (uint8_t)((alpha+2)/4);
+        }
+    }
+    return dst;
+}
+
+#pragma mark -
+#pragma mark ETC2 Encoding
+/** Returns the value clamped to the range [0,255] */
+static inline int clamp255(int value) {
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+/**
+ * Returns the error and pixel indices of the best table for a subblock
+ *
+ * @param pixels    The 8 subblock pixels (RGBA)
+ * @param weights   The weight of each pixel
+ * @param base      The (expanded) base color
+ * @param table     The chosen modifier table
+ * @param indices   The chosen modifier of each pixel
+ *
+ * @return the squared error of the best table
+ */
+static long fit_table(const uint8_t* const* pixels, const int* weights, const int* base,
+                      int& table, int* indices) {
+    long best = -1;
+    for(int t = 0; t < 8; t++) {
+        long error = 0;
+        int choice[8];
+        for(int ii = 0; ii < 8; ii++) {
+            long pbest = -1;
+            for(int m = 0; m < 4; m++) {
+                long perr = 0;
+                for(int c = 0; c < 3; c++) {
+                    int d = clamp255(base[c]+ETC_MODIFIERS[t][m])-pixels[ii][c];
+                    perr += d*d;
+                }
+                if (pbest < 0 || perr < pbest) {
+                    pbest = perr;
+                    choice[ii] = m;
+                }
+            }
+            error += pbest*weights[ii];
+        }
+        if (best < 0 || error < best) {
+            best = error;
+            table = t;
+            memcpy(indices, choice, sizeof(choice));
+        }
+    }
+    return best;
+}
+
+/**
+ * Encodes a 4x4 block in the ETC1-compatible modes of ETC2 RGB
+ *
+ * This searches both flip orientations in both the individual and the
+ * differential modes.  It does not use the T, H and planar modes, but the
+ * result is still a valid ETC2 block.
+ *
+ * @param block The 16 block pixels (RGBA, row-major)
+ * @param out   The 8 byte compressed block
+ */
+static void encode_color(const uint8_t block[64], uint8_t out[8]) {
+    long best = -1;
+    for(int flip = 0; flip < 2; flip++) {
+        // Gather the subblocks
+        const uint8_t* pixels[2][8];
+        int positions[2][8];
+        int weights[2][8];
+        int count[2] = { 0, 0 };
+        for(int x = 0; x < 4; x++) {
+            for(int y = 0; y < 4; y++) {
+                int sub = flip ? (y >= 2) : (x >= 2);
+                const uint8_t* p = block+4*(y*4+x);
+                pixels[sub][count[sub]] = p;
+                positions[sub][count[sub]] = x*4+y;
+                weights[sub][count[sub]] = (p[3] > 0 ? 1 : 0);
+                count[sub]++;
+            }
+        }
+
+        // Average the visible pixels of each subblock
+        float avg[2][3];
+        for(int sub = 0; sub < 2; sub++) {
+            int visible = 0;
+            for(int ii = 0; ii < 8; ii++) { visible += weights[sub][ii]; }
+            if (visible == 0) {
+                for(int ii = 0; ii < 8; ii++) { weights[sub][ii] = 1; }
+                visible = 8;
+            }
+            for(int c = 0; c < 3; c++) {
+                int sum = 0;
+                for(int ii = 0; ii < 8; ii++) { sum += pixels[sub][ii][c]*weights[sub][ii]; }
+                avg[sub][c] = (float)sum/visible;
+            }
+        }
+
+        for(int diff = 0; diff < 2; diff++) {
+            int quant[2][3];
+            int base[2][3];
+            bool valid = true;
+            for(int sub = 0; sub < 2; sub++) {
+                for(int c = 0; c < 3; c++) {
+                    if (diff) {
+                        quant[sub][c] = (int)(avg[sub][c]*31.0f/255.0f+0.5f);
+                        base[sub][c]  = (quant[sub][c] << 3) | (quant[sub][c] >> 2);
+                    } else {
+                        quant[sub][c] = (int)(avg[sub][c]*15.0f/255.0f+0.5f);
+                        base[sub][c]  = (quant[sub][c] << 4) | quant[sub][c];
+                    }
+                }
+            }
+            if (diff) {
+                for(int c = 0; c < 3; c++) {
+                    int delta = quant[1][c]-quant[0][c];
+                    valid = valid && delta >= -4 && delta <= 3;
+                }
+            }
+            if (!valid) {
+                continue;
+            }
+
+            int tables[2];
+            int indices[2][8];
+            long error = fit_table(pixels[0], weights[0], base[0], tables[0], indices[0]);
+            error += fit_table(pixels[1], weights[1], base[1], tables[1], indices[1]);
+            if (best >= 0 && error >= best) {
+                continue;
+            }
+            best = error;
+
+            for(int c = 0; c < 3; c++) {
+                if (diff) {
+                    out[c] = (uint8_t)((quant[0][c] << 3) | ((quant[1][c]-quant[0][c]) & 0x7));
+                } else {
+                    out[c] = (uint8_t)((quant[0][c] << 4) | quant[1][c]);
+                }
+            }
+            out[3] = (uint8_t)((tables[0] << 5) | (tables[1] << 2) | (diff << 1) | flip);
+            uint32_t bits = 0;
+            for(int sub = 0; sub < 2; sub++) {
+                for(int ii = 0; ii < 8; ii++) {
+                    int index = indices[sub][ii];
+                    int pos = positions[sub][ii];
+                    bits |= (uint32_t)(index >> 1) << (16+pos);
+                    bits |= (uint32_t)(index & 1) << pos;
+                }
+            }
+            out[4] = (uint8_t)(bits >> 24);
+            out[5] = (uint8_t)(bits >> 16);
+            out[6] = (uint8_t)(bits >> 8);
+            out[7] = (uint8_t)bits;
+        }
+    }
+}
+
+/**
+ * Encodes the alpha channel of a 4x4 block as EAC
+ *
+ * @param block The 16 block pixels (RGBA, row-major)
+ * @param out   The 8 byte compressed block
+ */
+static void encode_alpha(const uint8_t block[64], uint8_t out[8]) {
+    int alpha[16];
+    int amin = 255, amax = 0;
+    for(int x = 0; x < 4; x++) {
+        for(int y = 0; y < 4; y++) {
+            int a = block[4*(y*4+x)+3];
+            alpha[x*4+y] = a;
+            amin = std::min(amin,a);
+            amax = std::max(amax,a);
+        }
+    }
+
+    int bestBase = amin, bestMult = 1, bestTable = EAC_ZERO_TABLE;
+    int bestIndex[16];
+    std::fill(bestIndex, bestIndex+16, 4);
+    if (amin != amax) {
+        long best = -1;
+        for(int t = 0; t < 16; t++) {
+            int tmin = EAC_MODIFIERS[t][3];
+            int tmax = EAC_MODIFIERS[t][7];
+            for(int mult = 1; mult < 16; mult++) {
+                int base = clamp255((amin-tmin*mult+amax-tmax*mult+1)/2);
+                long error = 0;
+                int index[16];
+                for(int ii = 0; ii < 16 && (best < 0 || error < best); ii++) {
+                    long pbest = -1;
+                    for(int m = 0; m < 8; m++) {
+                        int d = clamp255(base+EAC_MODIFIERS[t][m]*mult)-alpha[ii];
+                        if (pbest < 0 || d*d < pbest) {
+                            pbest = d*d;
+                            index[ii] = m;
+                        }
+                    }
+                    error += pbest;
+                }
+                if (best < 0 || error < best) {
+                    best = error;
+                    bestBase = base;
+                    bestMult = mult;
+                    bestTable = t;
+                    memcpy(bestIndex, index, sizeof(index));
+                }
+            }
+        }
+    }
+
+    out[0] = (uint8_t)bestBase;
+    out[1] = (uint8_t)((bestMult << 4) | bestTable);
+    uint64_t bits = 0;
+    for(int ii = 0; ii < 16; ii++) {
+        bits = (bits << 3) | (uint64_t)bestIndex[ii];
+    }
+    for(int ii = 0; ii < 6; ii++) {
+        out[2+ii] = (uint8_t)(bits >> (40-8*ii));
+    }
+}
+
+/**
+ * Returns the image compressed as ETC2
+ *
+ * Partial blocks at the right and bottom edges are padded by clamping.
+ *
+ * @param image The image to compress
+ * @param alpha Whether to include an EAC alpha channel
+ *
+ * @return the image compressed as ETC2
+ */
+static std::vector<uint8_t> encode_etc2(const Image& image, bool alpha) {
+    std::vector<uint8_t> result;
+    uint8_t block[64];
+    uint8_t out[16];
+    for(int by = 0; by < image.height; by += 4) {
+        for(int bx = 0; bx < image.width; bx += 4) {
+            for(int y = 0; y < 4; y++) {
+                for(int x = 0; x < 4; x++) {
+                    memcpy(block+4*(y*4+x), image.at(bx+x,by+y), 4);
+                }
+            }
+            if (alpha) {
+                encode_alpha(block, out);
+                encode_color(block, out+8);
+                result.insert(result.end(), out, out+16);
+            } else {
+                encode_color(block, out);
+                result.insert(result.end(), out, out+8);
+            }
+        }
+    }
+    return result;
+}
+
+#pragma mark -
+#pragma mark KTX Output
+/**
+ * Writes a 32-bit integer in native byte order
+ *
+ * @param out   The output stream
+ * @param value The value to write
+ */
+static void write32(std::ofstream& out, uint32_t value) {
+    out.write((const char*)&value, 4);
+}
+
+/**
+ * Converts the PNG file to a KTX file, returning the GPU size of the result
+ *
+ * @param source    The path to the PNG file
+ * @param dest      The path to the KTX file
+ * @param etc2      Whether to compress to ETC2
+ * @param mipmaps   Whether to store prebuilt mipmaps
+ *
+ * @return the GPU size of the result (0 on failure)
+ */
+static size_t convert(const std::string& source, const std::string& dest, bool etc2, bool mipmaps) {
+    Image image;
+    if (!read_png(source, image)) {
+        return 0;
+    }
+
+    bool alpha = !image.opaque();
+    std::vector<std::vector<uint8_t>> levels;
+    Image level = image;
+    while (true) {
+        if (etc2) {
+            levels.push_back(encode_etc2(level, alpha));
+        } else {
+            levels.push_back(level.pixels);
+        }
+        if (!mipmaps || (level.width == 1 && level.height == 1)) {
+            break;
+        }
+        level = downsample(level);
+    }
+
+    std::ofstream out(dest, std::ios::binary);
+    if (!out) {
+        fprintf(stderr, "%s: unable to write\n", dest.c_str());
+        return 0;
+    }
+    out.write((const char*)KTX_IDENTIFIER, 12);
+    write32(out, 0x04030201);
+    write32(out, etc2 ? 0 : GL_UNSIGNED_BYTE);                     // glType
+    write32(out, 1);                                               // glTypeSize
+    write32(out, etc2 ? 0 : GL_RGBA);                              // glFormat
+    write32(out, etc2 ? (alpha ? GL_COMPRESSED_RGBA8_ETC2_EAC : GL_COMPRESSED_RGB8_ETC2) : GL_RGBA8);
+    write32(out, alpha || !etc2 ? GL_RGBA : GL_RGB);               // glBaseInternalFormat
+    write32(out, image.width);
+    write32(out, image.height);
+    write32(out, 0);                                               // pixelDepth
+    write32(out, 0);                                               // numberOfArrayElements
+    write32(out, 1);                                               // numberOfFaces
+    write32(out, (uint32_t)levels.size());
+    write32(out, 0);                                               // bytesOfKeyValueData
+
+    size_t total = 0;
+    static const char padding[4] = { 0, 0, 0, 0 };
+    for(auto it = levels.begin(); it != levels.end(); ++it) {
+        write32(out, (uint32_t)it->size());
+        out.write((const char*)it->data(), it->size());
+        out.write(padding, (4-(it->size() % 4)) % 4);
+        total += it->size();
+    }
+    return total;
+}
+
+#pragma mark -
+#pragma mark Asset Directories
+/**
+ * Returns the contents of the given file as a string
+ *
+ * @param path  The file path
+ *
+ * @return the contents of the given file as a string
+ */
+static std::string read_text(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+/**
+ * Returns the size of the given file in bytes (0 if it does not exist)
+ *
+ * @param path  The file path
+ *
+ * @return the size of the given file in bytes
+ */
+static size_t file_size(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+/**
+ * Returns the files in the given directory with the given extension
+ *
+ * @param dir   The directory
+ * @param ext   The file extension (including the period)
+ *
+ * @return the files in the given directory with the given extension
+ */
+static std::vector<std::string> list_files(const std::string& dir, const std::string& ext) {
+    std::vector<std::string> result;
+    DIR* handle = opendir(dir.c_str());
+    if (handle == nullptr) {
+        return result;
+    }
+    while (struct dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.size() > ext.size() && name.compare(name.size()-ext.size(),ext.size(),ext) == 0) {
+            result.push_back(name);
+        }
+    }
+    closedir(handle);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * Returns the texture keys and files in the given asset directory JSON
+ *
+ * @param json  The contents of the asset directory
+ *
+ * @return the texture keys and files in the given asset directory JSON
+ */
+static std::map<std::string,std::string> texture_files(const std::string& json) {
+    std::map<std::string,std::string> result;
+    std::regex entry("\"([^\"]+)\"\\s*:\\s*\\{\\s*\"file\"\\s*:\\s*\"(textures/[^\"]+)\"");
+    for(auto it = std::sregex_iterator(json.begin(), json.end(), entry); it != std::sregex_iterator(); ++it) {
+        result[(*it)[1]] = (*it)[2];
+    }
+    return result;
+}
+
+/**
+ * Returns the milliseconds spent decoding the given PNG file
+ *
+ * @param path  The path to the PNG file
+ *
+ * @return the milliseconds spent decoding the given PNG file
+ */
+static double time_png(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Image image;
+    read_png(path, image);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double,std::milli>(end-start).count();
+}
+
+/**
+ * Returns the milliseconds spent reading the given KTX file
+ *
+ * @param path  The path to the KTX file
+ *
+ * @return the milliseconds spent reading the given KTX file
+ */
+static double time_ktx(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string data = read_text(path);
+    auto end = std::chrono::high_resolution_clock::now();
+    return data.empty() ? 0 : std::chrono::duration<double,std::milli>(end-start).count();
+}
+
+/**
+ * Returns the GPU size of the KTX file (the sum of its level sizes)
+ *
+ * @param path  The path to the KTX file
+ *
+ * @return the GPU size of the KTX file
+ */
+static size_t ktx_gpu_size(const std::string& path) {
+    std::string data = read_text(path);
+    if (data.size() < 64) {
+        return 0;
+    }
+    uint32_t levels, keysize;
+    memcpy(&levels, data.data()+56, 4);
+    memcpy(&keysize, data.data()+60, 4);
+    size_t offset = 64+keysize;
+    size_t total = 0;
+    for(uint32_t ii = 0; ii < std::max(levels,1u) && offset+4 <= data.size(); ii++) {
+        uint32_t amount;
+        memcpy(&amount, data.data()+offset, 4);
+        total += amount;
+        offset += 4+((amount+3) & ~3u);
+    }
+    return total;
+}
+
+/**
+ * Prints the texture memory and load cost of every level
+ *
+ * The PNG columns are the current cost: RGBA8888 in GPU memory with no
+ * mipmaps, and the time to decode every PNG.  The KTX columns are the
+ * cost after conversion: the GPU size of every level (mipmaps included),
+ * and the time to read the files.
+ *
+ * @param root  The asset directory
+ */
+static void report(const std::string& root) {
+    std::map<std::string,std::string> files = texture_files(read_text(root+"/json/assets.json"));
+    std::vector<std::string> levels = list_files(root+"/json", ".json");
+    std::regex texture("\"texture\"\\s*:\\s*\"([^\"]+)\"");
+
+    std::vector<std::pair<int,std::string>> ordered;
+    for(auto it = levels.begin(); it != levels.end(); ++it) {
+        if (it->compare(0,5,"level") == 0) {
+            ordered.push_back(std::make_pair(atoi(it->c_str()+5),*it));
+        }
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    printf("%-12s %5s %10s %12s %12s %10s %10s\n",
+           "level", "tex", "png disk", "png gpu", "ktx gpu", "png ms", "ktx ms");
+    size_t sumPNG = 0, sumKTX = 0;
+    for(auto it = ordered.begin(); it != ordered.end(); ++it) {
+        std::string json = read_text(root+"/json/"+it->second);
+        std::set<std::string> used;
+        for(auto jt = std::sregex_iterator(json.begin(), json.end(), texture); jt != std::sregex_iterator(); ++jt) {
+            auto kt = files.find((*jt)[1]);
+            if (kt != files.end()) {
+                used.insert(kt->second);
+            }
+        }
+
+        size_t disk = 0, pngGPU = 0, ktxGPU = 0;
+        double pngMS = 0, ktxMS = 0;
+        for(auto jt = used.begin(); jt != used.end(); ++jt) {
+            std::string png = root+"/"+*jt;
+            std::string ktx = png.substr(0,png.size()-4)+".ktx";
+            Image image;
+            if (read_png(png, image)) {
+                pngGPU += 4*(size_t)image.width*image.height;
+            }
+            disk  += file_size(png);
+            ktxGPU += ktx_gpu_size(ktx);
+            pngMS += time_png(png);
+            ktxMS += time_ktx(ktx);
+        }
+        sumPNG += pngGPU;
+        sumKTX += ktxGPU;
+        printf("%-12s %5zu %10zu %12zu %12zu %10.2f %10.2f\n", it->second.c_str(), used.size(),
+               disk, pngGPU, ktxGPU, pngMS, ktxMS);
+    }
+    printf("%-12s %5s %10s %12zu %12zu\n", "all levels", "", "", sumPNG, sumKTX);
+}
+
+/**
+ * Rewrites the asset directory so that converted textures use KTX files
+ *
+ * @param root      The asset directory
+ * @param input     The asset directory JSON (relative to root)
+ * @param output    The output JSON (relative to root)
+ * @param converted The converted files (relative to root)
+ */
+static void rewrite(const std::string& root, const std::string& input, const std::string& output,
+                    const std::set<std::string>& converted) {
+    std::string json = read_text(root+"/"+input);
+    for(auto it = converted.begin(); it != converted.end(); ++it) {
+        std::string from = "\""+*it+"\"";
+        std::string to = "\""+it->substr(0,it->size()-4)+".ktx\"";
+        size_t pos = 0;
+        while ((pos = json.find(from,pos)) != std::string::npos) {
+            json.replace(pos, from.size(), to);
+            pos += to.size();
+        }
+    }
+    std::ofstream out(root+"/"+output, std::ios::binary);
+    out << json;
+}
+
+#pragma mark -
+#pragma mark Main
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: ktxconvert [options] <asset-dir>\n"
+            "  -f, --format <etc2|rgba>   output format (default etc2)\n"
+            "  -n, --no-mipmaps           do not store prebuilt mipmaps\n"
+            "  -w, --rewrite <in> <out>   rewrite an asset directory to use KTX files\n"
+            "  -r, --report               print per-level texture memory and load time\n"
+            "  -q, --quiet                do not list converted files\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    bool etc2 = true;
+    bool mipmaps = true;
+    bool print = false;
+    bool quiet = false;
+    std::string rewriteIn, rewriteOut, root;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if ((arg == "-f" || arg == "--format") && ii+1 < argc) {
+            std::string format = argv[++ii];
+            if (format != "etc2" && format != "rgba") {
+                usage();
+            }
+            etc2 = format == "etc2";
+        } else if (arg == "-n" || arg == "--no-mipmaps") {
+            mipmaps = false;
+        } else if ((arg == "-w" || arg == "--rewrite") && ii+2 < argc) {
+            rewriteIn  = argv[++ii];
+            rewriteOut = argv[++ii];
+        } else if (arg == "-r" || arg == "--report") {
+            print = true;
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg[0] != '-' && root.empty()) {
+            root = arg;
+        } else {
+            usage();
+        }
+    }
+    if (root.empty()) {
+        usage();
+    }
+
+    std::set<std::string> converted;
+    std::vector<std::string> pngs = list_files(root+"/textures", ".png");
+    size_t before = 0, after = 0;
+    for(auto it = pngs.begin(); it != pngs.end(); ++it) {
+        std::string source = root+"/textures/"+*it;
+        std::string dest = source.substr(0,source.size()-4)+".ktx";
+        size_t size = convert(source, dest, etc2, mipmaps);
+        if (size == 0) {
+            continue;
+        }
+        Image image;
+        read_png(source, image);
+        before += 4*(size_t)image.width*image.height;
+        after  += size;
+        converted.insert("textures/"+*it);
+        if (!quiet) {
+            printf("%-40s %10zu -> %10zu\n", it->c_str(), 4*(size_t)image.width*image.height, size);
+        }
+    }
+    printf("converted %zu textures: %zu bytes RGBA8888 -> %zu bytes %s%s\n",
+           converted.size(), before, after, etc2 ? "ETC2" : "RGBA8888", mipmaps ? " (with mipmaps)" : "");
+
+    if (!rewriteIn.empty()) {
+        rewrite(root, rewriteIn, rewriteOut, converted);
+    }
+    if (print) {
+        report(root);
+    }
+    return 0;
+}
@@ -0,0 +1,308 @@
+//
+//  renderbench.cpp
+//  Magic Moving Mansion Mania test tools
+//
+//  This is an offline tool for measuring how cugl::Scene rendering scales
+//  with Scene::setRenderThreads.  It builds scenes of polygon nodes (from the
+//  size of a level, about 52 nodes, up to several thousand) and times a frame
+//  for every thread count from 1 up to the number of cores.  A frame includes
+//  glFinish, so it measures the GPU work as well as the scene graph traversal.
+//
+//  The scenes mix in the cases that the parallel path treats specially:
+//  transparent nodes, nodes with absolute color, and nodes that must be drawn
+//  on the main thread.  Every frame is drawn into a render target, and the
+//  pixels of every parallel frame are compared against the serial frame.
+//
+//  The game draws its scenes serially.  Parallel rendering should only be
+//  turned on for a scene once this tool shows that it is faster on the
+//  target devices.
+//
+//  This tool needs an OpenGL context, and so it links the engine and SDL.
+//  See the README for the build command.
+//
+//  Usage:
+//
+//      renderbench [options]
+//
+//      -n, --max <nodes>            The largest scene (default 4096)
+//      -t, --threads <count>        The largest thread count (default the core count)
+//      -f, --frames <count>         The frames timed for each case (default 200)
+//
+#include <cugl/2d/CUScene.h>
+#include <cugl/2d/CUPolygonNode.h>
+#include <cugl/renderer/CURenderTarget.h>
+#include <cugl/renderer/CUSpriteBatch.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// SDL redefines main on some platforms
+#undef main
+
+using namespace cugl;
+
+/** The width of the scene and render target */
+#define SCENE_WIDTH     1024
+/** The height of the scene and render target */
+#define SCENE_HEIGHT    576
+/** The number of nodes in a typical level */
+#define LEVEL_NODES     52
+/** The number of subtrees in each scene */
+#define GROUP_COUNT     8
+
+/**
+ * A polygon node that must be drawn on the main thread
+ */
+class SerialNode : public PolygonNode {
+public:
+    /**
+     * Returns a newly allocated serial node for the given rectangle
+     *
+     * @param rect  The node rectangle
+     *
+     * @return a newly allocated serial node for the given rectangle
+     */
+    static std::shared_ptr<SerialNode> alloc(const Rect& rect) {
+        std::shared_ptr<SerialNode> result = std::make_shared<SerialNode>();
+        return (result->initWithTexture(SpriteBatch::getBlankTexture(), rect) ? result : nullptr);
+    }
+
+    /**
+     * Returns false, as this node is never drawn on a worker
+     *
+     * @return false, as this node is never drawn on a worker
+     */
+    virtual bool isConcurrent() const override { return false; }
+};
+
+#pragma mark -
+#pragma mark Scenes
+/**
+ * Returns a scene with the given number of nodes
+ *
+ * The nodes are split among several groups, so that the scene has several
+ * subtrees to draw in parallel.
+ *
+ * @param count     The number of nodes
+ *
+ * @return a scene with the given number of nodes
+ */
+static std::shared_ptr<Scene> make_scene(int count) {
+    std::shared_ptr<Scene> scene = Scene::alloc(SCENE_WIDTH, SCENE_HEIGHT);
+    std::shared_ptr<Texture> blank = SpriteBatch::getBlankTexture();
+    for(int gg = 0; gg < GROUP_COUNT; gg++) {
+        std::shared_ptr<Node> group = Node::alloc();
+        group->setPosition(gg*140.0f-100, 20);
+        scene->addChild(group);
+
+        int size = count/GROUP_COUNT+(gg < count % GROUP_COUNT ? 1 : 0);
+        for(int ii = 0; ii < size; ii++) {
+            Rect rect(0, 0, 10.0f+(ii % 5), 10.0f+(ii % 7));
+            std::shared_ptr<Node> node;
+            if (ii % 97 == 5) {
+                node = SerialNode::alloc(rect);
+            } else {
+                node = PolygonNode::allocWithTexture(blank, rect);
+            }
+            node->setPosition((ii % 16)*9.0f, (float)((ii/16)*7 % 600));
+            node->setColor(Color4((ii*37) % 255, (ii*11) % 255, 200, (ii % 50 == 3) ? 0 : 255));
+            if (ii % 13 == 0) {
+                node->setAngle(0.1f*ii);
+            }
+            if (ii % 31 == 0) {
+                std::shared_ptr<Node> child = PolygonNode::allocWithTexture(blank, Rect(0, 0, 3, 3));
+                child->setRelativeColor(false);
+                node->addChild(child);
+            }
+            group->addChild(node);
+        }
+    }
+    return scene;
+}
+
+/**
+ * Draws the scene into the target and returns the pixels
+ *
+ * @param scene     The scene to draw
+ * @param batch     The sprite batch
+ * @param target    The render target
+ *
+ * @return the pixels of the rendered frame
+ */
+static std::vector<GLubyte> read_frame(const std::shared_ptr<Scene>& scene,
+                                       const std::shared_ptr<SpriteBatch>& batch,
+                                       const std::shared_ptr<RenderTarget>& target) {
+    std::vector<GLubyte> pixels(4*SCENE_WIDTH*SCENE_HEIGHT);
+    target->begin();
+    target->clear();
+    scene->render(batch);
+    glReadPixels(0, 0, SCENE_WIDTH, SCENE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    target->end();
+    return pixels;
+}
+
+/**
+ * Returns the average time to draw a frame of the scene in microseconds
+ *
+ * @param scene     The scene to draw
+ * @param batch     The sprite batch
+ * @param target    The render target
+ * @param frames    The number of frames to time
+ *
+ * @return the average time to draw a frame of the scene in microseconds
+ */
+static double time_frames(const std::shared_ptr<Scene>& scene,
+                          const std::shared_ptr<SpriteBatch>& batch,
+                          const std::shared_ptr<RenderTarget>& target, int frames) {
+    target->begin();
+    for(int ii = 0; ii < 5; ii++) {
+        scene->render(batch);
+    }
+    glFinish();
+    auto start = std::chrono::steady_clock::now();
+    for(int ii = 0; ii < frames; ii++) {
+        scene->render(batch);
+        glFinish();
+    }
+    auto end = std::chrono::steady_clock::now();
+    target->end();
+    return std::chrono::duration<double,std::micro>(end-start).count()/frames;
+}
+
+#pragma mark -
+#pragma mark Application
+/**
+ * Returns true if an OpenGL context was created
+ *
+ * The context settings match those of cugl::Application.
+ *
+ * @param window    Pointer to store the window
+ * @param context   Pointer to store the context
+ *
+ * @return true if an OpenGL context was created
+ */
+static bool make_context(SDL_Window** window, SDL_GLContext* context) {
+    SDL_SetMainReady();
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        fprintf(stderr, "could not initialize SDL: %s\n", SDL_GetError());
+        return false;
+    }
+
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+#else
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+#endif
+    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+    *window = SDL_CreateWindow("renderbench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                               SCENE_WIDTH, SCENE_HEIGHT, SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
+    if (*window == nullptr) {
+        fprintf(stderr, "could not create window: %s\n", SDL_GetError());
+        return false;
+    }
+    *context = SDL_GL_CreateContext(*window);
+    if (*context == nullptr) {
+        fprintf(stderr, "could not create OpenGL context: %s\n", SDL_GetError());
+        return false;
+    }
+#if CU_PLATFORM == CU_PLATFORM_WINDOWS
+    glewExperimental = GL_TRUE;
+    glewInit();
+#endif
+    return true;
+}
+
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: renderbench [options]\n"
+            "  -n, --max <nodes>          the largest scene (default 4096)\n"
+            "  -t, --threads <count>      the largest thread count (default the core count)\n"
+            "  -f, --frames <count>       the frames timed for each case (default 200)\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    int maximum = 4096;
+    int threads = 0;
+    int frames = 200;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if ((arg == "-n" || arg == "--max") && ii+1 < argc) {
+            maximum = atoi(argv[++ii]);
+            if (maximum < LEVEL_NODES) {
+                usage();
+            }
+        } else if ((arg == "-t" || arg == "--threads") && ii+1 < argc) {
+            threads = atoi(argv[++ii]);
+            if (threads <= 0) {
+                usage();
+            }
+        } else if ((arg == "-f" || arg == "--frames") && ii+1 < argc) {
+            frames = atoi(argv[++ii]);
+            if (frames <= 0) {
+                usage();
+            }
+        } else {
+            usage();
+        }
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+    if (!make_context(&window, &context)) {
+        return 1;
+    }
+    int cores = SDL_GetCPUCount();
+    if (threads == 0) {
+        threads = std::max(cores, 1);
+    }
+
+    int failures = 0;
+    {
+        std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+        std::shared_ptr<RenderTarget> target = RenderTarget::alloc(SCENE_WIDTH, SCENE_HEIGHT);
+
+        std::vector<int> sizes;
+        sizes.push_back(LEVEL_NODES);
+        for(int count = 256; count <= maximum; count *= 4) {
+            sizes.push_back(count);
+        }
+
+        printf("%d cores, us per frame\n%8s", cores, "nodes");
+        for(int tt = 1; tt <= threads; tt++) {
+            std::string label = std::to_string(tt)+(tt == 1 ? " thread" : " threads");
+            printf(" %12s", label.c_str());
+        }
+        printf("\n");
+
+        for(auto it = sizes.begin(); it != sizes.end(); ++it) {
+            std::shared_ptr<Scene> scene = make_scene(*it);
+            std::vector<GLubyte> serial = read_frame(scene, batch, target);
+            printf("%8d", *it);
+            for(int tt = 1; tt <= threads; tt++) {
+                scene->setRenderThreads(tt);
+                bool same = read_frame(scene, batch, target) == serial;
+                failures += same ? 0 : 1;
+                printf(" %11.1f%c", time_frames(scene, batch, target, frames), same ? ' ' : '*');
+            }
+            printf("\n");
+        }
+        if (failures > 0) {
+            printf("* the frame differs from the serial render\n");
+        }
+    }
+
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return failures == 0 ? 0 : 1;
+}
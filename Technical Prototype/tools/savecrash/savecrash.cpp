@@ -0,0 +1,279 @@
+//
+//  savecrash.cpp
+//  Magic Moving Mansion Mania test tools
+//
+//  This is an offline tool for checking that SaveStore survives the game being
+//  killed at any moment.  It repeatedly forks a child process that hammers the
+//  store with writes and checkpoints, kills the child with SIGKILL after a
+//  random delay, and then reloads the store to check what survived.
+//
+//  The child writes the keys n, m and count in that order, each set to the
+//  same increasing value.  Whatever prefix of those writes reached the disk,
+//  a reload must satisfy count <= m <= n <= count+1.  The value n may never go
+//  backwards between kills, and a value loaded from a legacy save file (the
+//  old single integer format) must never be lost.  Any violation means that a
+//  half written snapshot or journal batch was loaded.
+//
+//  The tool also reports how often a kill left a temporary snapshot or an
+//  unfinished journal batch behind (these are expected, and must be ignored
+//  on reload), and the cost of a burst of writes on the calling thread.
+//
+//  This tool requires a POSIX system (for fork).  To build it
+//
+//      c++ -std=c++11 -O2 -pthread -I../../source savecrash.cpp ../../source/SaveStore.cpp -o savecrash
+//
+//  Usage:
+//
+//      savecrash [options] <save-dir>
+//
+//      -k, --kills <count>          The number of times to kill the writer (default 300)
+//      -s, --seed <value>           The random seed (default 0)
+//      -q, --quiet                  Only print the summary
+//
+//  The save directory is created if it does not exist.  Any save files in it
+//  are deleted first.
+//
+#include "SaveStore.hpp"
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+/** The value stored in the legacy save file */
+#define LEGACY_LEVEL    7
+/** The number of writes in the burst measurement */
+#define BURST_WRITES    100000
+
+#pragma mark -
+#pragma mark Save Files
+/**
+ * Returns the path of the given file in the save directory
+ *
+ * @param dir   The save directory
+ * @param name  The file name
+ *
+ * @return the path of the given file in the save directory
+ */
+static std::string save_path(const std::string& dir, const char* name) {
+    return dir+"/"+name;
+}
+
+/**
+ * Returns true if the given file exists
+ *
+ * @param path  The file path
+ *
+ * @return true if the given file exists
+ */
+static bool has_file(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+/**
+ * Returns true if the journal ends in the middle of a batch
+ *
+ * A journal starts with a header line, and every batch of entries ends with
+ * a commit line.  Both begin with '#'.  A journal whose last line is anything
+ * else was being written when the process was killed.
+ *
+ * @param path  The journal path
+ *
+ * @return true if the journal ends in the middle of a batch
+ */
+static bool has_torn_journal(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (contents.empty()) {
+        return false;
+    } else if (contents.back() != '\n') {
+        return true;
+    }
+    size_t pos = contents.rfind('\n', contents.size()-2);
+    pos = (pos == std::string::npos ? 0 : pos+1);
+    return contents[pos] != '#';
+}
+
+/**
+ * Resets the save directory to a legacy save file
+ *
+ * The legacy format is a single integer, the current level.
+ *
+ * @param dir   The save directory
+ *
+ * @return true if the directory was reset
+ */
+static bool reset_dir(const std::string& dir) {
+    mkdir(dir.c_str(), 0755);
+    remove(save_path(dir, "save.journal").c_str());
+    remove(save_path(dir, "save.tmp").c_str());
+
+    FILE* file = fopen(save_path(dir, "save.txt").c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "%i", LEGACY_LEVEL);
+    fclose(file);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Crash Test
+/**
+ * Writes to the store until the process is killed
+ *
+ * @param dir   The save directory
+ * @param seed  The random seed for this child
+ */
+static void write_forever(const std::string& dir, unsigned seed) {
+    SaveStore store;
+    store.init(dir);
+    srand(seed);
+    for(int ii = store.getValue("n")+1; ; ii++) {
+        store.setValue("n", ii);
+        store.setValue("m", ii);
+        store.addValue("count");
+        if (rand() % 40 == 0) {
+            store.checkpoint();
+        }
+        if (rand() % 4 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(rand() % 200));
+        }
+    }
+}
+
+/**
+ * Prints the time to make a burst of writes
+ *
+ * The writes are measured twice: the time they take on the calling thread,
+ * and the time until the background thread has saved them.
+ *
+ * @param dir   The save directory
+ */
+static void report_burst(const std::string& dir) {
+    SaveStore store;
+    store.init(dir);
+    auto start = std::chrono::steady_clock::now();
+    for(int ii = 0; ii < BURST_WRITES; ii++) {
+        store.setValue("n", ii);
+    }
+    auto queued = std::chrono::steady_clock::now();
+    store.synchronize();
+    auto saved = std::chrono::steady_clock::now();
+    printf("%d writes: %.2f ms on the caller, %.2f ms until saved\n", BURST_WRITES,
+           std::chrono::duration<double,std::milli>(queued-start).count(),
+           std::chrono::duration<double,std::milli>(saved-start).count());
+}
+
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: savecrash [options] <save-dir>\n"
+            "  -k, --kills <count>        the number of times to kill the writer (default 300)\n"
+            "  -s, --seed <value>         the random seed (default 0)\n"
+            "  -q, --quiet                only print the summary\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    int kills = 300;
+    unsigned seed = 0;
+    bool quiet = false;
+    std::string dir;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if ((arg == "-k" || arg == "--kills") && ii+1 < argc) {
+            kills = atoi(argv[++ii]);
+            if (kills <= 0) {
+                usage();
+            }
+        } else if ((arg == "-s" || arg == "--seed") && ii+1 < argc) {
+            seed = (unsigned)strtoul(argv[++ii], nullptr, 10);
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg[0] != '-' && dir.empty()) {
+            dir = arg;
+        } else {
+            usage();
+        }
+    }
+    if (dir.empty()) {
+        usage();
+    }
+
+    if (!reset_dir(dir)) {
+        fprintf(stderr, "could not write to %s\n", dir.c_str());
+        return 1;
+    }
+
+    // The first load must convert the legacy file
+    {
+        SaveStore store;
+        store.init(dir);
+        if (store.getValue("level") != LEGACY_LEVEL) {
+            fprintf(stderr, "legacy save file was not loaded\n");
+            return 1;
+        }
+        store.setValue("n", 0);
+        store.setValue("m", 0);
+        store.setValue("count", 0);
+    }
+
+    srand(seed);
+    int failures = 0;
+    int leftover = 0;
+    int torn = 0;
+    int last = 0;
+    for(int run = 0; run < kills; run++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        } else if (pid == 0) {
+            write_forever(dir, seed+run);
+            _exit(0);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(2000+rand() % 30000));
+        kill(pid, SIGKILL);
+        int status;
+        waitpid(pid, &status, 0);
+
+        leftover += has_file(save_path(dir, "save.tmp")) ? 1 : 0;
+        torn += has_torn_journal(save_path(dir, "save.journal")) ? 1 : 0;
+
+        SaveStore store;
+        store.init(dir);
+        int n = store.getValue("n", -1);
+        int m = store.getValue("m", -1);
+        int count = store.getValue("count", -1);
+        int level = store.getValue("level", -1);
+
+        // The writes are in order n, m, count, so any saved prefix obeys this
+        bool valid = n >= last && count <= m && m <= n && n <= count+1 && level == LEGACY_LEVEL;
+        if (!valid) {
+            printf("kill %d: inconsistent n=%d m=%d count=%d level=%d (previous n=%d)\n",
+                   run, n, m, count, level, last);
+            failures++;
+        } else if (!quiet) {
+            printf("kill %d: n=%d\n", run, n);
+        }
+        last = n;
+
+        // Repair a partial prefix so the next writer starts consistent
+        store.setValue("m", n);
+        store.setValue("count", n);
+    }
+
+    printf("kills %d, inconsistent %d, final n %d\n", kills, failures, last);
+    printf("left a temporary snapshot %d times, an unfinished journal batch %d times\n", leftover, torn);
+    report_burst(dir);
+    return failures == 0 ? 0 : 1;
+}
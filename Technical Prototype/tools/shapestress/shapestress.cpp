@@ -0,0 +1,171 @@
+//
+//  shapestress.cpp
+//  Magic Moving Mansion Mania test tools
+//
+//  This is an offline tool for checking that cugl::ShapeCache is safe to use
+//  from several threads at once.  PolygonNode, WireNode, and PathNode build
+//  their geometry through this cache, so it is what makes node construction
+//  safe off the main thread.
+//
+//  The tool first computes reference geometry for a set of star polygons on
+//  one thread, using the polygon factories directly.  It then starts several
+//  threads (8 by default) that request the same shapes from the cache, making
+//  the same calls as the node constructors, in interleaved orders.  Every
+//  polygon returned must match its reference exactly.  At the end, the cache
+//  must hold exactly one polygon for each distinct request.
+//
+//  The nodes themselves need an OpenGL context (for their textures), so this
+//  tool calls the cache directly rather than allocating nodes.
+//
+//  This tool depends on the engine math sources.  See the README for the
+//  build command.
+//
+//  Usage:
+//
+//      shapestress [options]
+//
+//      -t, --threads <count>        The number of threads (default 8)
+//      -i, --iterations <count>     The requests per thread (default 2000)
+//      -c, --clear                  Clear the cache while the threads run
+//
+#include <cugl/math/polygon/CUShapeCache.h>
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <cugl/math/polygon/CUPathOutliner.h>
+#include <cugl/math/polygon/CUPathExtruder.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// SDL redefines main on some platforms
+#undef main
+
+using namespace cugl;
+
+/** The number of distinct star polygons */
+#define SHAPE_COUNT     40
+/** The stroke width of the path extrusions */
+#define STROKE_WIDTH    2.0f
+
+/**
+ * Returns the star polygon with the given index
+ *
+ * Each index gives a different number of points and a different radius.
+ *
+ * @param index     The star index
+ *
+ * @return the star polygon with the given index
+ */
+static std::vector<Vec2> make_star(int index) {
+    std::vector<Vec2> result;
+    int points = 5+(index % 7);
+    for(int ii = 0; ii < 2*points; ii++) {
+        float radius = (ii % 2 ? 10.0f : 25.0f)+index;
+        float angle  = (float)M_PI*ii/points;
+        result.push_back(Vec2(radius*cosf(angle), radius*sinf(angle)));
+    }
+    return result;
+}
+
+/**
+ * Returns true if the two polygons have the same vertices and indices
+ *
+ * @param a     The first polygon
+ * @param b     The second polygon
+ *
+ * @return true if the two polygons have the same vertices and indices
+ */
+static bool same_polygon(const Poly2& a, const Poly2& b) {
+    return a.getVertices() == b.getVertices() && a.getIndices() == b.getIndices();
+}
+
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: shapestress [options]\n"
+            "  -t, --threads <count>      the number of threads (default 8)\n"
+            "  -i, --iterations <count>   the requests per thread (default 2000)\n"
+            "  -c, --clear                clear the cache while the threads run\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    int threads = 8;
+    int iterations = 2000;
+    bool clear = false;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if ((arg == "-t" || arg == "--threads") && ii+1 < argc) {
+            threads = atoi(argv[++ii]);
+            if (threads <= 0) {
+                usage();
+            }
+        } else if ((arg == "-i" || arg == "--iterations") && ii+1 < argc) {
+            iterations = atoi(argv[++ii]);
+            if (iterations <= 0) {
+                usage();
+            }
+        } else if (arg == "-c" || arg == "--clear") {
+            clear = true;
+        } else {
+            usage();
+        }
+    }
+
+    // Reference geometry from the factories, on this thread only
+    std::vector<std::vector<Vec2>> stars;
+    std::vector<Poly2> solids, paths, extrusions;
+    for(int ii = 0; ii < SHAPE_COUNT; ii++) {
+        stars.push_back(make_star(ii));
+
+        ComplexTriangulator triangulator(stars.back());
+        triangulator.calculate();
+        solids.push_back(triangulator.getPolygon());
+
+        PathOutliner outliner(stars.back());
+        outliner.calculate(PathTraversal::INTERIOR);
+        paths.push_back(outliner.getPolygon());
+
+        PathExtruder extruder(stars.back(), true);
+        extruder.calculate(STROKE_WIDTH, PathJoint::ROUND, PathCap::NONE);
+        extrusions.push_back(extruder.getPolygon());
+    }
+
+    // The same requests that PolygonNode, WireNode, and PathNode make
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> pool;
+    for(int tt = 0; tt < threads; tt++) {
+        pool.emplace_back([&, tt] {
+            for(int ii = 0; ii < iterations; ii++) {
+                int kk = (ii*7+tt) % SHAPE_COUNT;
+                std::vector<Vec2> star = make_star(kk);
+                auto solid = ShapeCache::getSolid(star);
+                auto path  = ShapeCache::getPath(star, PathTraversal::INTERIOR);
+                auto extrusion = ShapeCache::getExtrusion(star, true, STROKE_WIDTH,
+                                                          PathJoint::ROUND, PathCap::NONE);
+                mismatches += same_polygon(*solid, solids[kk]) ? 0 : 1;
+                mismatches += same_polygon(*path, paths[kk]) ? 0 : 1;
+                mismatches += same_polygon(*extrusion, extrusions[kk]) ? 0 : 1;
+                if (clear && tt == 0 && ii % 100 == 99) {
+                    ShapeCache::clear();
+                }
+            }
+        });
+    }
+    for(auto it = pool.begin(); it != pool.end(); ++it) {
+        it->join();
+    }
+
+    // Without clearing, every distinct request is cached exactly once
+    size_t expected = 3*SHAPE_COUNT;
+    bool counted = clear || ShapeCache::size() == expected;
+    printf("%d threads, %d requests: %d mismatches, %zu cached (%zu distinct), %u hits, %u misses\n",
+           threads, 3*threads*iterations, mismatches.load(), ShapeCache::size(), expected,
+           ShapeCache::getHits(), ShapeCache::getMisses());
+    return mismatches.load() == 0 && counted ? 0 : 1;
+}
@@ -0,0 +1,408 @@
+//
+//  tribench.cpp
+//  Magic Moving Mansion Mania test tools
+//
+//  This is an offline tool for checking and timing cugl::ComplexTriangulator.
+//  It first triangulates a large set of generated polygons (random star shapes
+//  in both orientations, combs with many equal y values, rectangles, and
+//  polygons with holes), with and without the Delaunay refinement.  Every
+//  triangulation is checked for
+//
+//    - area: the triangles sum to the area of the polygon minus its holes
+//    - orientation: every triangle is counterclockwise and not degenerate
+//    - count: there are n-2+2h triangles for n vertices and h holes
+//
+//  It then times the triangulator on star polygons from 10 to 100000 vertices,
+//  against the ear clipping cugl::SimpleTriangulator (which is quadratic, and
+//  so is skipped on the largest polygons).  It also reports the mean minimum
+//  angle of a triangulation with and without the Delaunay refinement.
+//
+//  Poly2 indices are unsigned shorts, so polygons over 65536 vertices are
+//  timed but not checked.
+//
+//  This tool depends on the engine math sources.  See the README for the
+//  build command.
+//
+//  Usage:
+//
+//      tribench [options]
+//
+//      -c, --check                  Only run the correctness checks
+//      -b, --bench                  Only run the benchmark
+//      -n, --max <verts>            The largest benchmark polygon (default 100000)
+//      -s, --seed <value>           The random seed (default 7)
+//
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <cugl/math/polygon/CUSimpleTriangulator.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// SDL redefines main on some platforms
+#undef main
+
+using namespace cugl;
+
+/** The relative error allowed in the triangulation area */
+#define AREA_TOLERANCE  1e-3
+
+/** The random generator for the test polygons */
+static std::mt19937 generator;
+
+#pragma mark -
+#pragma mark Polygons
+/**
+ * Returns a random star shaped polygon
+ *
+ * The vertices are evenly spaced in angle around the center, each at a
+ * random distance between (1-jitter)*radius and radius.
+ *
+ * @param count     The number of vertices
+ * @param radius    The maximum distance from the center
+ * @param jitter    The fraction of the radius to vary
+ * @param center    The polygon center
+ * @param clockwise Whether to list the vertices clockwise
+ *
+ * @return a random star shaped polygon
+ */
+static std::vector<Vec2> make_star(int count, float radius, float jitter,
+                                   const Vec2& center = Vec2::ZERO, bool clockwise = false) {
+    std::uniform_real_distribution<float> scale(1-jitter, 1);
+    std::vector<Vec2> result;
+    result.reserve(count);
+    for(int ii = 0; ii < count; ii++) {
+        float angle = 2*(float)M_PI*ii/count;
+        float dist  = radius*scale(generator);
+        result.push_back(center+Vec2(dist*cosf(angle), dist*sinf(angle)));
+    }
+    if (clockwise) {
+        std::reverse(result.begin(), result.end());
+    }
+    return result;
+}
+
+/**
+ * Returns a comb shaped polygon
+ *
+ * The comb has a flat base and the given number of sawtooth teeth.  All of
+ * the tooth tips share one y value and all of the gaps share another, which
+ * stresses the sweep ordering of equal y values.
+ *
+ * @param teeth     The number of teeth
+ *
+ * @return a comb shaped polygon
+ */
+static std::vector<Vec2> make_comb(int teeth) {
+    std::vector<Vec2> result;
+    result.push_back(Vec2(0,0));
+    result.push_back(Vec2(2.0f*teeth,0));
+    for(int ii = teeth-1; ii >= 0; ii--) {
+        result.push_back(Vec2(2.0f*ii+2,10));
+        result.push_back(Vec2(2.0f*ii+1,2));
+    }
+    result.push_back(Vec2(0,10));
+    return result;
+}
+
+/**
+ * Returns the unsigned area of the given polygon
+ *
+ * @param points    The polygon vertices
+ *
+ * @return the unsigned area of the given polygon
+ */
+static double polygon_area(const std::vector<Vec2>& points) {
+    double area = 0;
+    for(size_t ii = 0; ii < points.size(); ii++) {
+        const Vec2& p = points[ii];
+        const Vec2& q = points[(ii+1) % points.size()];
+        area += (double)p.x*q.y-(double)q.x*p.y;
+    }
+    return fabs(area)/2;
+}
+
+/**
+ * Returns twice the signed area of the given triangle
+ *
+ * @param a     The first vertex
+ * @param b     The second vertex
+ * @param c     The third vertex
+ *
+ * @return twice the signed area of the given triangle
+ */
+static double triangle_cross(const Vec2& a, const Vec2& b, const Vec2& c) {
+    return ((double)b.x-a.x)*((double)c.y-a.y)-((double)b.y-a.y)*((double)c.x-a.x);
+}
+
+#pragma mark -
+#pragma mark Correctness
+/**
+ * Returns true if the triangulation is correct
+ *
+ * The triangulation must cover the expected area, have only counterclockwise
+ * triangles, and have the expected number of triangles.  Failures are printed.
+ *
+ * @param name      The name of the test case
+ * @param points    The polygon vertices, followed by the hole vertices
+ * @param indices   The triangulation indices
+ * @param area      The expected area
+ * @param count     The expected number of triangles
+ *
+ * @return true if the triangulation is correct
+ */
+static bool check_triangulation(const char* name, const std::vector<Vec2>& points,
+                                const std::vector<unsigned short>& indices,
+                                double area, size_t count) {
+    double total = 0;
+    int inverted = 0;
+    for(size_t ii = 0; ii+2 < indices.size(); ii += 3) {
+        double cross = triangle_cross(points[indices[ii]], points[indices[ii+1]], points[indices[ii+2]]);
+        if (cross <= 0) {
+            inverted++;
+        }
+        total += cross/2;
+    }
+
+    bool valid = fabs(total-area) < AREA_TOLERANCE*area && inverted == 0 && indices.size()/3 == count;
+    if (!valid) {
+        printf("FAIL %s (%zu vertices): area %f vs %f, %d inverted, %zu triangles vs %zu\n",
+               name, points.size(), total, area, inverted, indices.size()/3, count);
+    }
+    return valid;
+}
+
+/**
+ * Returns true if the given simple polygon triangulates correctly
+ *
+ * The polygon is triangulated both with and without Delaunay refinement.
+ *
+ * @param name      The name of the test case
+ * @param points    The polygon vertices
+ *
+ * @return true if the given simple polygon triangulates correctly
+ */
+static bool check_simple(const char* name, const std::vector<Vec2>& points) {
+    bool valid = true;
+    for(int delaunay = 0; delaunay < 2; delaunay++) {
+        ComplexTriangulator triangulator(points);
+        triangulator.setDelaunay(delaunay == 1);
+        triangulator.calculate();
+        valid = check_triangulation(name, points, triangulator.getTriangulation(),
+                                    polygon_area(points), points.size()-2) && valid;
+    }
+    return valid;
+}
+
+/**
+ * Returns the number of failed correctness checks
+ *
+ * @return the number of failed correctness checks
+ */
+static int run_checks() {
+    int failures = 0;
+    int total = 0;
+
+    // Random stars in both orientations
+    for(int trial = 0; trial < 500; trial++) {
+        std::vector<Vec2> star = make_star(3+trial % 97, 100, 0.8f, Vec2::ZERO, trial % 2 == 1);
+        failures += check_simple("star", star) ? 0 : 1;
+        total++;
+    }
+
+    // Combs, also upside down and sideways
+    for(int teeth = 1; teeth < 30; teeth++) {
+        std::vector<Vec2> comb = make_comb(teeth);
+        std::vector<Vec2> flipped = comb;
+        std::vector<Vec2> sideways = comb;
+        for(auto it = flipped.begin(); it != flipped.end(); ++it) {
+            it->y = -it->y;
+        }
+        for(auto it = sideways.begin(); it != sideways.end(); ++it) {
+            std::swap(it->x, it->y);
+        }
+        failures += check_simple("comb", comb) ? 0 : 1;
+        failures += check_simple("flipped comb", flipped) ? 0 : 1;
+        failures += check_simple("sideways comb", sideways) ? 0 : 1;
+        total += 3;
+    }
+
+    // Axis aligned shapes
+    std::vector<Vec2> rect = { Vec2(0,0), Vec2(4,0), Vec2(4,3), Vec2(0,3) };
+    std::vector<Vec2> ell  = { Vec2(0,0), Vec2(4,0), Vec2(4,1), Vec2(1,1), Vec2(1,3), Vec2(0,3) };
+    failures += check_simple("rectangle", rect) ? 0 : 1;
+    failures += check_simple("L", ell) ? 0 : 1;
+    total += 2;
+
+    // Holes, including square holes that share y values
+    for(int trial = 0; trial < 200; trial++) {
+        std::vector<Vec2> outer = make_star(40+trial, 100, 0.1f, Vec2::ZERO, trial % 2 == 1);
+        ComplexTriangulator triangulator(outer);
+        std::vector<Vec2> points = outer;
+        double area = polygon_area(outer);
+        int holes = 1+trial % 4;
+        for(int ii = 0; ii < holes; ii++) {
+            float angle = 2*(float)M_PI*ii/holes;
+            Vec2 center(45*cosf(angle), 45*sinf(angle));
+            std::vector<Vec2> hole = make_star(5+(trial+ii) % 20, 15, 0.5f, center, (trial+ii) % 2 == 1);
+            triangulator.addHole(hole);
+            points.insert(points.end(), hole.begin(), hole.end());
+            area -= polygon_area(hole);
+        }
+        if (trial % 3 == 0) {
+            std::vector<Vec2> square = { Vec2(-5,-5), Vec2(5,-5), Vec2(5,5), Vec2(-5,5) };
+            triangulator.addHole(square);
+            points.insert(points.end(), square.begin(), square.end());
+            area -= 100;
+            holes++;
+        }
+        triangulator.setDelaunay(trial % 2 == 1);
+        triangulator.calculate();
+        failures += check_triangulation("holes", points, triangulator.getTriangulation(),
+                                        area, points.size()-2+2*holes) ? 0 : 1;
+        total++;
+    }
+
+    printf("%d of %d polygons failed\n", failures, total);
+    return failures;
+}
+
+#pragma mark -
+#pragma mark Benchmark
+/**
+ * Returns the mean of the smallest angle of each triangle, in degrees
+ *
+ * @param points    The polygon vertices
+ * @param indices   The triangulation indices
+ *
+ * @return the mean of the smallest angle of each triangle, in degrees
+ */
+static double mean_min_angle(const std::vector<Vec2>& points, const std::vector<unsigned short>& indices) {
+    double total = 0;
+    for(size_t ii = 0; ii+2 < indices.size(); ii += 3) {
+        double smallest = 180;
+        for(int kk = 0; kk < 3; kk++) {
+            const Vec2& p = points[indices[ii+kk]];
+            Vec2 u = points[indices[ii+(kk+1) % 3]]-p;
+            Vec2 v = points[indices[ii+(kk+2) % 3]]-p;
+            double cosine = (double)u.dot(v)/((double)u.length()*v.length());
+            double angle  = acos(std::max(-1.0, std::min(1.0, cosine)))*180/M_PI;
+            smallest = std::min(smallest, angle);
+        }
+        total += smallest;
+    }
+    return indices.empty() ? 0 : total/(indices.size()/3);
+}
+
+/**
+ * Returns the average time of the given function in microseconds
+ *
+ * @param reps      The number of repetitions
+ * @param func      The function to time
+ *
+ * @return the average time of the given function in microseconds
+ */
+template <typename F>
+static double time_average(int reps, F func) {
+    auto start = std::chrono::steady_clock::now();
+    for(int ii = 0; ii < reps; ii++) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double,std::micro>(end-start).count()/reps;
+}
+
+/**
+ * Prints the triangulation times for polygons up to the given size
+ *
+ * @param maximum   The largest number of vertices
+ */
+static void run_bench(int maximum) {
+    std::vector<Vec2> sample = make_star(2000, 100, 0.3f);
+    ComplexTriangulator monotone(sample);
+    ComplexTriangulator delaunay(sample);
+    delaunay.setDelaunay(true);
+    monotone.calculate();
+    delaunay.calculate();
+    printf("2000 vertices, mean min angle: %.2f monotone, %.2f delaunay\n",
+           mean_min_angle(sample, monotone.getTriangulation()),
+           mean_min_angle(sample, delaunay.getTriangulation()));
+
+    printf("%8s %14s %14s %14s\n", "vertices", "ear clip (us)", "sweep (us)", "delaunay (us)");
+    for(int count = 10; count <= maximum; count *= 10) {
+        std::vector<Vec2> star = make_star(count, 1000, 0.5f);
+        int reps = count <= 100 ? 2000 : (count <= 1000 ? 50 : (count <= 10000 ? 3 : 1));
+        double clip = -1;
+        if (count <= 10000) {
+            clip = time_average(reps, [&] {
+                SimpleTriangulator triangulator(star);
+                triangulator.calculate();
+            });
+        }
+        double sweep = time_average(reps, [&] {
+            ComplexTriangulator triangulator(star);
+            triangulator.calculate();
+        });
+        double refined = time_average(reps, [&] {
+            ComplexTriangulator triangulator(star);
+            triangulator.setDelaunay(true);
+            triangulator.calculate();
+        });
+        if (clip < 0) {
+            printf("%8d %14s %14.1f %14.1f\n", count, "-", sweep, refined);
+        } else {
+            printf("%8d %14.1f %14.1f %14.1f\n", count, clip, sweep, refined);
+        }
+    }
+}
+
+/**
+ * Prints the usage message and exits
+ */
+static void usage() {
+    fprintf(stderr,
+            "usage: tribench [options]\n"
+            "  -c, --check                only run the correctness checks\n"
+            "  -b, --bench                only run the benchmark\n"
+            "  -n, --max <verts>          the largest benchmark polygon (default 100000)\n"
+            "  -s, --seed <value>         the random seed (default 7)\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    bool check = true;
+    bool bench = true;
+    int maximum = 100000;
+    unsigned seed = 7;
+    for(int ii = 1; ii < argc; ii++) {
+        std::string arg = argv[ii];
+        if (arg == "-c" || arg == "--check") {
+            bench = false;
+        } else if (arg == "-b" || arg == "--bench") {
+            check = false;
+        } else if ((arg == "-n" || arg == "--max") && ii+1 < argc) {
+            maximum = atoi(argv[++ii]);
+            if (maximum < 10) {
+                usage();
+            }
+        } else if ((arg == "-s" || arg == "--seed") && ii+1 < argc) {
+            seed = (unsigned)strtoul(argv[++ii], nullptr, 10);
+        } else {
+            usage();
+        }
+    }
+
+    generator.seed(seed);
+    int failures = 0;
+    if (check) {
+        failures = run_checks();
+    }
+    if (bench) {
+        run_bench(maximum);
+    }
+    return failures == 0 ? 0 : 1;
+}